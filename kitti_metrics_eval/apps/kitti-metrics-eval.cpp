@@ -24,18 +24,24 @@
 
 #include <mrpt/3rdparty/tclap/CmdLine.h>
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/Clock.h>
 #include <mrpt/core/exceptions.h>
 #include <mrpt/math/CMatrixFixed.h>
+#include <mrpt/math/CQuaternion.h>
 #include <mrpt/poses/CPose3D.h>
 #include <mrpt/poses/CPose3DInterpolator.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/string_utils.h>  // tokenize()
 
 #include <Eigen/Dense>
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <optional>
+#include <sstream>
+#include <thread>
 
 // Declare supported cli switches ===========
 struct Cli
@@ -107,12 +113,29 @@ struct Cli
         "format instead of in TUM format",
         cmd};
 
+    TCLAP::SwitchArg argLive{
+        "", "live",
+        "Streaming mode: read the estimated trajectory in TUM format from "
+        "stdin (one pose per line) and evaluate it incrementally against the "
+        "preloaded ground truth, printing rolling metrics while the run is "
+        "still going. With this flag, --result-tum-path is only used to "
+        "locate the output directory for the final stats/error files, and "
+        "figures are never generated.",
+        cmd};
+
+    TCLAP::ValueArg<int> argLiveReportPeriod{
+        "", "live-report-period",
+        "In --live mode, print the rolling metrics every N input poses "
+        "(0 = only the final summary).",
+        false, 100, "100", cmd};
+
     std::string kitti_basedir;
 };
 
 // points to CPose3D path from odometry/slam
 
 static bool eval(Cli& cli);
+static bool evalLive(Cli& cli);
 
 static void do_kitti_eval_error(Cli& cli)
 {
@@ -139,7 +162,10 @@ static void do_kitti_eval_error(Cli& cli)
         ASSERT_DIRECTORY_EXISTS_(cli.kitti_basedir + "/poses"s);
 
     // Run evaluation
-    eval(cli);
+    if (cli.argLive.isSet())
+        evalLive(cli);
+    else
+        eval(cli);
 }
 
 int main(int argc, char** argv)
@@ -180,6 +206,25 @@ static void parse_calib_line(
         }
     MRPT_TRY_END
 }
+
+// Pose of the cam0 frame wrt the vehicle (Velodyne) frame, from the "Tr"
+// entry of a KITTI calibration file:
+static mrpt::poses::CPose3D camPoseFromCalibFile(const std::string& calib_file)
+{
+    auto calib = mrpt::containers::yaml::FromFile(calib_file);
+    ASSERT_(calib.has("Tr"));
+
+    Eigen::Matrix<double, 3, 4> Tr;
+    parse_calib_line(calib["Tr"].as<std::string>(), Tr);
+
+    // "Tr" is the pose of velo wrt cam_0; we need its inverse:
+    auto Trh              = mrpt::math::CMatrixDouble44::Identity();
+    Trh.block<3, 4>(0, 0) = Tr;
+    Trh                   = Trh.inverse();
+
+    return mrpt::poses::CPose3D(Trh);
+}
+
 std::vector<Matrix> loadPoses_tum_format(
     Cli& cli, const std::string& file_name, const std::string& calib_file,
     bool isGT)
@@ -204,25 +249,7 @@ std::vector<Matrix> loadPoses_tum_format(
 
     auto cam_pose0 = mrpt::poses::CPose3D::Identity();
 
-    if (!calib_file.empty())
-    {
-        auto calib = mrpt::containers::yaml::FromFile(calib_file);
-        ASSERT_(calib.has("Tr"));
-
-        Eigen::Matrix<double, 3, 4> Tr;
-        parse_calib_line(calib["Tr"].as<std::string>(), Tr);
-
-        auto Trh              = mrpt::math::CMatrixDouble44::Identity();
-        Trh.block<3, 4>(0, 0) = Tr;
-
-        // std::cout << "Original Trh= (velo wrt cam_0) \n" << Trh << "\n";
-        // Inverse:
-        Trh = Trh.inverse();
-        // std::cout << "Inverted Trh= (cam_0 wrt velo) \n" << Trh << "\n";
-
-        // Camera 0:
-        cam_pose0 = mrpt::poses::CPose3D(Trh);
-    }
+    if (!calib_file.empty()) cam_pose0 = camPoseFromCalibFile(calib_file);
 
     std::vector<Matrix> poses;
     const auto          n = trajectory.size();
@@ -315,7 +342,7 @@ std::vector<Matrix> loadPoses(string file_name)
     return poses;
 }
 
-vector<float> trajectoryDistances(vector<Matrix>& poses)
+vector<float> trajectoryDistances(const vector<Matrix>& poses)
 {
     vector<float> dist;
     dist.push_back(0);
@@ -332,14 +359,32 @@ vector<float> trajectoryDistances(vector<Matrix>& poses)
 }
 
 int32_t lastFrameFromSegmentLength(
-    vector<float>& dist, int32_t first_frame, float len)
+    const vector<float>& dist, int32_t first_frame, float len)
 {
-    for (int32_t i = first_frame; i < dist.size(); i++)
-        if (dist[i] > dist[first_frame] + len) return i;
-    return -1;
+    // dist[] holds the (non-decreasing) cumulative trajectory arc length, so
+    // the first frame beyond the target length can be found with a binary
+    // search instead of the former linear scan, which was O(n) per query and
+    // O(n^2) overall on long trajectories:
+    const auto it = std::upper_bound(
+        dist.begin() + first_frame, dist.end(), dist[first_frame] + len);
+    if (it == dist.end()) return -1;
+    return static_cast<int32_t>(it - dist.begin());
 }
 
-inline float rotationError(Matrix& pose_error)
+// SE(3) inverse: transpose the rotation block instead of running a general
+// 4x4 inversion; cheaper, and leaves Eigen free to vectorize the products:
+inline Matrix se3Inverse(const Matrix& P)
+{
+    const Eigen::Matrix3d R = P.asEigen().block<3, 3>(0, 0);
+    const Eigen::Vector3d t = P.asEigen().block<3, 1>(0, 3);
+
+    Matrix inv                      = Matrix::Identity();
+    inv.asEigen().block<3, 3>(0, 0) = R.transpose();
+    inv.asEigen().block<3, 1>(0, 3) = -R.transpose() * t;
+    return inv;
+}
+
+inline float rotationError(const Matrix& pose_error)
 {
     float a = pose_error(0, 0);
     float b = pose_error(1, 1);
@@ -348,7 +393,7 @@ inline float rotationError(Matrix& pose_error)
     return acos(max(min(d, 1.0f), -1.0f));
 }
 
-inline float translationError(Matrix& pose_error)
+inline float translationError(const Matrix& pose_error)
 {
     float dx = pose_error(0, 3);
     float dy = pose_error(1, 3);
@@ -357,51 +402,80 @@ inline float translationError(Matrix& pose_error)
 }
 
 vector<errors> calcSequenceErrors(
-    vector<Matrix>& poses_gt, vector<Matrix>& poses_result)
+    const vector<Matrix>& poses_gt, const vector<Matrix>& poses_result,
+    size_t num_threads = std::thread::hardware_concurrency())
 {
-    // error vector
-    vector<errors> err;
-
     // parameters
-    int32_t step_size = 10;  // every second
+    const int32_t step_size = 10;  // every second
 
     // pre-compute distances (from ground truth as reference)
-    vector<float> dist = trajectoryDistances(poses_gt);
+    const vector<float> dist = trajectoryDistances(poses_gt);
+
+    // all segment start positions:
+    vector<int32_t> start_frames;
+    for (int32_t f = 0; f < (int32_t)poses_gt.size(); f += step_size)
+        start_frames.push_back(f);
 
-    // for all start positions do
-    for (int32_t first_frame = 0; first_frame < poses_gt.size();
-         first_frame += step_size)
+    // evaluates all segment lengths for the start frames [idx0,idx1):
+    const auto evalStartFrames = [&](size_t idx0, size_t idx1)
     {
-        // for all segment lengths do
-        for (int32_t i = 0; i < num_lengths; i++)
+        vector<errors> err;
+        for (size_t k = idx0; k < idx1; k++)
         {
-            // current length
-            float len = lengths[i];
-
-            // compute last frame
-            int32_t last_frame =
-                lastFrameFromSegmentLength(dist, first_frame, len);
-
-            // continue, if sequence not long enough
-            if (last_frame == -1) continue;
-
-            // compute rotational and translational errors
-            Matrix pose_delta_gt =
-                (poses_gt[first_frame]).inverse() * poses_gt[last_frame];
-            Matrix pose_delta_result = (poses_result[first_frame]).inverse() *
-                                       poses_result[last_frame];
-            Matrix pose_error = (pose_delta_result).inverse() * pose_delta_gt;
-            float  r_err      = rotationError(pose_error);
-            float  t_err      = translationError(pose_error);
-
-            // compute speed
-            float num_frames = (float)(last_frame - first_frame + 1);
-            float speed      = len / (0.1 * num_frames);
-
-            // write to file
-            err.push_back(
-                errors(first_frame, r_err / len, t_err / len, len, speed));
+            const int32_t first_frame = start_frames[k];
+
+            // one SE(3) inversion per start frame, shared by all lengths:
+            const Matrix inv_gt     = se3Inverse(poses_gt[first_frame]);
+            const Matrix inv_result = se3Inverse(poses_result[first_frame]);
+
+            // for all segment lengths do
+            for (int32_t i = 0; i < num_lengths; i++)
+            {
+                // current length
+                float len = lengths[i];
+
+                // compute last frame
+                int32_t last_frame =
+                    lastFrameFromSegmentLength(dist, first_frame, len);
+
+                // continue, if sequence not long enough
+                if (last_frame == -1) continue;
+
+                // compute rotational and translational errors
+                Matrix pose_delta_gt     = inv_gt * poses_gt[last_frame];
+                Matrix pose_delta_result = inv_result * poses_result[last_frame];
+                Matrix pose_error = se3Inverse(pose_delta_result) * pose_delta_gt;
+                float  r_err      = rotationError(pose_error);
+                float  t_err      = translationError(pose_error);
+
+                // compute speed
+                float num_frames = (float)(last_frame - first_frame + 1);
+                float speed      = len / (0.1 * num_frames);
+
+                // write to file
+                err.push_back(
+                    errors(first_frame, r_err / len, t_err / len, len, speed));
+            }
         }
+        return err;
+    };
+
+    // evaluate chunks of start frames in parallel:
+    const size_t nThreads = std::max<size_t>(1, num_threads);
+    const size_t chunk    = (start_frames.size() + nThreads - 1) / nThreads;
+
+    std::vector<std::future<vector<errors>>> parts;
+    for (size_t i0 = 0; i0 < start_frames.size(); i0 += chunk)
+        parts.emplace_back(std::async(
+            std::launch::async, evalStartFrames, i0,
+            std::min(i0 + chunk, start_frames.size())));
+
+    // concatenate partial results, preserving the original ordering:
+    vector<errors> err;
+    for (auto& p : parts)
+    {
+        const auto part = p.get();
+        err.insert(err.end(), part.begin(), part.end());
     }
 
     // return error vector
@@ -792,6 +866,209 @@ void saveStats(vector<errors> err, string dir)
     fclose(fp);
 }
 
+// -------------------------------------------------------
+// Streaming ("live") evaluation mode: see the --live flag
+// -------------------------------------------------------
+
+/** Incremental error statistics for one streamed sequence.
+ *
+ * The ground truth is known in advance, so its cumulative arc length and the
+ * end frame of every (start frame, segment length) pair are precomputed once
+ * in the constructor; completions_ then maps each frame index to the segments
+ * that become evaluable when that frame arrives. addPose() is thus O(1)
+ * amortized: every segment is evaluated exactly once, the moment the streamed
+ * trajectory reaches its end frame, and the overall metrics are always
+ * up-to-date with the last pose received.
+ */
+class IncrementalSeqEval
+{
+   public:
+    IncrementalSeqEval(vector<Matrix> poses_gt) : poses_gt_(std::move(poses_gt))
+    {
+        const vector<float> dist = trajectoryDistances(poses_gt_);
+        completions_.resize(poses_gt_.size());
+
+        const int32_t step_size = 10;  // every second
+        for (int32_t f = 0; f < (int32_t)poses_gt_.size(); f += step_size)
+            for (int32_t i = 0; i < num_lengths; i++)
+            {
+                const int32_t last =
+                    lastFrameFromSegmentLength(dist, f, lengths[i]);
+                if (last == -1) continue;
+                completions_[last].push_back({f, lengths[i]});
+            }
+    }
+
+    /// Processes the i-th streamed pose, paired with poses_gt[i]. Returns
+    /// false (and ignores the pose) if the ground truth is exhausted.
+    bool addPose(const Matrix& P)
+    {
+        if (poses_result_.size() >= poses_gt_.size()) return false;
+        poses_result_.push_back(P);
+
+        const auto i = static_cast<int32_t>(poses_result_.size() - 1);
+        for (const auto& [first_frame, len] : completions_[i])
+        {
+            // Same math as in calcSequenceErrors():
+            const Matrix pose_delta_gt =
+                se3Inverse(poses_gt_[first_frame]) * poses_gt_[i];
+            const Matrix pose_delta_result =
+                se3Inverse(poses_result_[first_frame]) * poses_result_[i];
+            const Matrix pose_error =
+                se3Inverse(pose_delta_result) * pose_delta_gt;
+
+            const float r_err      = rotationError(pose_error);
+            const float t_err      = translationError(pose_error);
+            const float num_frames = (float)(i - first_frame + 1);
+            const float speed      = len / (0.1 * num_frames);
+
+            err_.push_back(
+                errors(first_frame, r_err / len, t_err / len, len, speed));
+            t_err_sum_ += t_err / len;
+            r_err_sum_ += r_err / len;
+        }
+        return true;
+    }
+
+    size_t numPoses() const { return poses_result_.size(); }
+    size_t numGtPoses() const { return poses_gt_.size(); }
+
+    vector<errors>& allErrors() { return err_; }
+
+    /// Current overall translational error [%], as in saveStats():
+    float avgTransError() const
+    {
+        return err_.empty() ? .0f : 100 * t_err_sum_ / err_.size();
+    }
+    /// Current overall rotational error [deg/100m]:
+    float avgRotError() const
+    {
+        return err_.empty() ? .0f
+                            : (180.0 / M_PI) * 100 * r_err_sum_ / err_.size();
+    }
+
+   private:
+    struct PendingSegment
+    {
+        int32_t first_frame;
+        float   len;
+    };
+
+    const vector<Matrix>           poses_gt_;
+    vector<Matrix>                 poses_result_;
+    vector<vector<PendingSegment>> completions_;
+    vector<errors>                 err_;
+    float                          t_err_sum_ = 0, r_err_sum_ = 0;
+};
+
+bool evalLive(Cli& cli)
+{
+    // Preload the ground truth of the (single) sequence being streamed:
+    vector<Matrix>       poses_gt;
+    mrpt::poses::CPose3D cam_pose0;  // cam0 wrt vehicle; Identity if no calib
+    string               seq_name;
+
+    if (cli.arg_override_gt_file.isSet())
+    {
+        const auto& gtFile = cli.arg_override_gt_file.getValue();
+
+        poses_gt = loadPoses_tum_format(cli, gtFile, {}, true);
+        seq_name = mrpt::system::extractFileName(gtFile);
+    }
+    else
+    {
+        ASSERTMSG_(
+            cli.arg_seq.getValue().size() == 1,
+            "--live evaluates a single sequence: pass exactly one --sequence "
+            "(or use --gt-tum-path)");
+        const int32_t i = cli.arg_seq.getValue().front();
+
+        poses_gt  = loadPoses(mrpt::format(
+            "%s/poses/%02d.txt", cli.kitti_basedir.c_str(), i));
+        cam_pose0 = camPoseFromCalibFile(mrpt::format(
+            "%s/sequences/%02i/calib.txt", cli.kitti_basedir.c_str(), i));
+        seq_name  = mrpt::format("%02d.txt", i);
+    }
+    ASSERTMSG_(!poses_gt.empty(), "Could not load any ground truth pose");
+
+    const int report_period = cli.argLiveReportPeriod.getValue();
+
+    std::cout << "Live mode: " << poses_gt.size()
+              << " ground truth poses preloaded; reading TUM poses from "
+                 "stdin...\n";
+
+    IncrementalSeqEval ev(std::move(poses_gt));
+
+    // Parse "t x y z qx qy qz qw" lines as they arrive. Like in
+    // loadPoses_tum_format(), poses are mapped to the cam0 frame and rebased
+    // so that the first one is the origin:
+    std::optional<mrpt::poses::CPose3D> pose0;
+
+    std::string line;
+    while (std::getline(std::cin, line))
+    {
+        if (line.empty() || line[0] == '#' || line[0] == '%') continue;
+
+        double             t, x, y, z, qx, qy, qz, qw;
+        std::istringstream ss(line);
+        if (!(ss >> t >> x >> y >> z >> qx >> qy >> qz >> qw))
+        {
+            std::cerr << "[live] Ignoring malformed input line: `" << line
+                      << "`\n";
+            continue;
+        }
+
+        auto pose = mrpt::poses::CPose3D(
+            mrpt::math::CQuaternionDouble(qw, qx, qy, qz), x, y, z);
+        pose = pose + cam_pose0;
+        if (!pose0) pose0 = pose;
+        pose = pose - *pose0;
+
+        mrpt::math::CMatrixDouble44 HM;
+        pose.getHomogeneousMatrix(HM);
+
+        if (!ev.addPose(HM))
+        {
+            std::cerr << "[live] Warning: more input poses than the "
+                      << ev.numGtPoses()
+                      << " ground truth entries; ignoring the rest.\n";
+            break;
+        }
+
+        if (report_period > 0 && (ev.numPoses() % report_period) == 0)
+            printf(
+                "[live] poses: %6zu/%zu  segments: %7zu  trans_err: %.4f %%  "
+                "rot_err: %.5f deg/100m\n",
+                ev.numPoses(), ev.numGtPoses(), ev.allErrors().size(),
+                ev.avgTransError(), ev.avgRotError());
+    }
+
+    if (ev.numPoses() < ev.numGtPoses())
+        printf(
+            "[live] Input ended at pose %zu of %zu ground truth entries.\n",
+            ev.numPoses(), ev.numGtPoses());
+
+    if (ev.allErrors().empty())
+    {
+        printf("[live] Not enough trajectory for any error segment.\n");
+        return false;
+    }
+
+    // Final stats, in the same output layout as the post-mortem mode:
+    string result_dir =
+        mrpt::system::extractFileDirectory(cli.arg_result_path.getValue());
+    if (result_dir.empty()) result_dir = ".";
+
+    const string error_dir = result_dir + "/errors";
+    if (!mrpt::system::directoryExists(error_dir))
+        mrpt::system::createDirectory(error_dir);
+
+    saveSequenceErrors(ev.allErrors(), error_dir + "/" + seq_name);
+    saveStats(ev.allErrors(), result_dir);
+
+    return true;
+}
+
 bool eval(Cli& cli)  // string result_sha,Mail* mail)
 {
     // ground truth and result directories
@@ -873,47 +1150,96 @@ bool eval(Cli& cli)  // string result_sha,Mail* mail)
         }
     }
 
-    // for all sequences do
-    for (const auto& seq : seqs)
+    // Per-sequence load + error evaluation results:
+    struct SeqEvalResult
     {
-        vector<Matrix> poses_result;
         vector<Matrix> poses_gt;
+        vector<Matrix> poses_result;
+        vector<errors> seq_err;
+        double         load_time = 0, eval_time = 0;  // [s]
+    };
+
+    const auto processSeq = [&cli](const InfoPerSeq& seq, size_t calc_threads)
+    {
+        SeqEvalResult r;
+        const double  t0 = mrpt::Clock::nowDouble();
 
         if (cli.argResultInKittiFormat.isSet())
         {
             // for use with real KITTI GT only:
             ASSERT_(!cli.arg_override_gt_file.isSet());
-            poses_gt     = loadPoses(seq.kitti_gt_poses_file);
-            poses_result = loadPoses(seq.result_file);
+            r.poses_gt     = loadPoses(seq.kitti_gt_poses_file);
+            r.poses_result = loadPoses(seq.result_file);
         }
         else
         {
             if (seq.is_kitti)
             {
                 // read ground truth and result poses
-                poses_gt     = loadPoses(seq.kitti_gt_poses_file);
-                poses_result = loadPoses_tum_format(
+                r.poses_gt     = loadPoses(seq.kitti_gt_poses_file);
+                r.poses_result = loadPoses_tum_format(
                     cli, seq.result_file, seq.kitti_calib_file, false);
             }
             else
             {
-                poses_gt = loadPoses_tum_format(
+                r.poses_gt = loadPoses_tum_format(
                     cli, seq.custom_gt_tum_file, {}, false);
-                poses_result =
+                r.poses_result =
                     loadPoses_tum_format(cli, seq.result_file, {}, false);
             }
         }
+        const double t1 = mrpt::Clock::nowDouble();
+        r.load_time     = t1 - t0;
+
+        // compute sequence errors (mismatching sizes are detected below):
+        if (!r.poses_gt.empty() && r.poses_result.size() == r.poses_gt.size())
+            r.seq_err =
+                calcSequenceErrors(r.poses_gt, r.poses_result, calc_threads);
+        r.eval_time = mrpt::Clock::nowDouble() - t1;
+        return r;
+    };
+
+    // Evaluate all sequences: the CPU-heavy part runs first, in parallel;
+    // plotting and file output below stay sequential, since they share the
+    // output directories and spawn gnuplot via system().
+    // Exception: --save-as-kitti appends to one shared output file while
+    // loading, so that mode keeps the former sequential behavior.
+    std::vector<SeqEvalResult> results(seqs.size());
+    if (seqs.size() == 1 || cli.argSavePathKittiFormat.isSet())
+    {
+        for (size_t i = 0; i < seqs.size(); i++)
+            results[i] = processSeq(seqs[i], std::thread::hardware_concurrency());
+    }
+    else
+    {
+        std::vector<std::future<SeqEvalResult>> futs;
+        for (const auto& seq : seqs)
+            futs.emplace_back(std::async(
+                std::launch::async, processSeq, std::cref(seq),
+                1 /*calc_threads: already parallel across sequences*/));
+        for (size_t i = 0; i < futs.size(); i++) results[i] = futs[i].get();
+    }
+
+    // for all sequences do
+    for (size_t seqIdx = 0; seqIdx < seqs.size(); seqIdx++)
+    {
+        const auto& seq = seqs[seqIdx];
+        auto&       r   = results[seqIdx];
 
         // plot status
         printf(
             "Processing: %s, poses: %ld/%ld\n", seq.file_name.c_str(),
-            poses_result.size(), poses_gt.size());
+            r.poses_result.size(), r.poses_gt.size());
 
-        printf("-- poses_gt: %lu entries\n", poses_gt.size());
-        printf("-- poses_result: %lu entries\n", poses_result.size());
+        printf("-- poses_gt: %lu entries\n", r.poses_gt.size());
+        printf("-- poses_result: %lu entries\n", r.poses_result.size());
+        printf(
+            "-- timing: load: %.3f s, evaluate: %.3f s (%lu segment errors)\n",
+            r.load_time, r.eval_time, r.seq_err.size());
 
         // check for errors
-        if (poses_gt.size() == 0 || poses_result.size() != poses_gt.size())
+        if (r.poses_gt.size() == 0 ||
+            r.poses_result.size() != r.poses_gt.size())
         {
             printf(
                 "ERROR: Couldn't read (all) poses of: %s\n",
@@ -921,24 +1247,23 @@ bool eval(Cli& cli)  // string result_sha,Mail* mail)
             return false;
         }
 
-        // compute sequence errors
-        vector<errors> seq_err = calcSequenceErrors(poses_gt, poses_result);
-        saveSequenceErrors(seq_err, error_dir + "/" + seq.file_name);
+        saveSequenceErrors(r.seq_err, error_dir + "/" + seq.file_name);
 
         // add to total errors
-        total_err.insert(total_err.end(), seq_err.begin(), seq_err.end());
+        total_err.insert(total_err.end(), r.seq_err.begin(), r.seq_err.end());
 
         // for first half => plot trajectory and compute individual stats
         if (/*seq.kitti_seq_no <= 15 && */ !cli.argSkipFigures.isSet())
         {
             // save + plot bird's eye view trajectories
             savePathPlot(
-                poses_gt, poses_result, plot_path_dir + "/" + seq.file_name);
-            vector<int32_t> roi = computeRoi(poses_gt, poses_result);
+                r.poses_gt, r.poses_result,
+                plot_path_dir + "/" + seq.file_name);
+            vector<int32_t> roi = computeRoi(r.poses_gt, r.poses_result);
             plotPathPlot(cli, plot_path_dir, roi, seq.kitti_seq_no);
 
             // save + plot individual errors
-            saveErrorPlots(seq_err, plot_error_dir, seq.file_name.c_str());
+            saveErrorPlots(r.seq_err, plot_error_dir, seq.file_name.c_str());
             plotErrorPlots(cli, plot_error_dir, seq.file_name.c_str());
         }
     }
@@ -12,6 +12,7 @@
 #pragma once
 
 // MOLA virtual interfaces:
+#include <mola_kernel/Yaml.h>
 #include <mola_kernel/interfaces/ExecutableBase.h>
 #include <mola_kernel/interfaces/LocalizationSourceBase.h>
 #include <mola_kernel/interfaces/MapSourceBase.h>
@@ -29,6 +30,12 @@
 #include <tf2_ros/transform_broadcaster.h>
 #include <tf2_ros/transform_listener.h>
 
+#include <algorithm>
+#include <functional>
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <nav_msgs/msg/odometry.hpp>
 #include <optional>
 #include <sensor_msgs/msg/image.hpp>
@@ -36,6 +43,9 @@
 #include <sensor_msgs/msg/laser_scan.hpp>
 #include <sensor_msgs/msg/nav_sat_fix.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace mola
 {
@@ -133,13 +143,82 @@ class BridgeROS2 : public RawDataSourceBase, public mola::RawDataConsumer
         double period_publish_new_map          = 5.0;  // [s]
         double period_publish_static_tfs       = 1.0;  // [s]
 
+        /// Dynamic /tf transforms are coalesced and broadcast as one batched
+        /// TFMessage at this period [s], instead of one message per sensor or
+        /// localization callback:
+        double period_publish_tf = 0.05;  // [s]
+
+        /// Deadbands to skip re-broadcasting a /tf transform whose change
+        /// w.r.t. the last one sent is imperceptible: translation [m] and
+        /// rotation [deg]. A value of 0 disables that dimension; with both
+        /// at 0 every update is sent.
+        double tf_deadband_translation  = 0.0;  // [m]
+        double tf_deadband_rotation_deg = 0.0;  // [deg]
+
+        /// Even within the deadbands, each transform is refreshed at least
+        /// at this period [s], so TF listeners never see it expire:
+        double tf_deadband_refresh_period = 1.0;  // [s]
+
         double period_check_new_mola_subs = 1.0;  // [s]
 
         int wait_for_tf_timeout_milliseconds = 100;
+
+        /// Number of threads of the ROS 2 MultiThreadedExecutor servicing
+        /// subscriptions (0 = hardware concurrency). Each subscribed topic
+        /// gets its own reentrant callback group, with IMU/odometry in a
+        /// dedicated group, so high-rate small messages are never queued
+        /// behind point-cloud conversions.
+        unsigned int ros_executor_threads = 0;
+
+        /// If true, point clouds are built directly inside RMW-loaned
+        /// messages (zero-copy middlewares, e.g. iceoryx shared memory),
+        /// falling back to regular allocation whenever the RMW does not
+        /// support loans for the publisher.
+        bool use_loaned_messages = true;
     };
 
     Params params_;
 
+    /// Declarative parameter table (see mola::param_table()), bulk-parsed
+    /// once in initialize_rds(); spin paths only read plain Params members.
+    /// `base_footprint_to_base_link_tf` is parsed apart (string pose
+    /// syntax).
+    static constexpr auto PARAMS_TABLE = mola::param_table(
+        // ROS2 -> MOLA:
+        mola::param("base_link_frame", &Params::base_link_frame),
+        mola::param("odom_frame", &Params::odom_frame),
+        mola::param("base_footprint_frame", &Params::base_footprint_frame),
+        mola::param(
+            "forward_ros_tf_as_mola_odometry_observations",
+            &Params::forward_ros_tf_as_mola_odometry_observations),
+        mola::param(
+            "wait_for_tf_timeout_milliseconds",
+            &Params::wait_for_tf_timeout_milliseconds),
+        mola::param("ros_executor_threads", &Params::ros_executor_threads),
+        // MOLA -> ROS2:
+        mola::param("reference_frame", &Params::reference_frame),
+        mola::param(
+            "publish_odometry_msgs_from_slam",
+            &Params::publish_odometry_msgs_from_slam),
+        mola::param("publish_in_sim_time", &Params::publish_in_sim_time),
+        mola::param(
+            "period_publish_new_localization",
+            &Params::period_publish_new_localization),
+        mola::param(
+            "period_publish_new_map", &Params::period_publish_new_map),
+        mola::param(
+            "publish_tf_from_robot_pose_observations",
+            &Params::publish_tf_from_robot_pose_observations),
+        mola::param("use_loaned_messages", &Params::use_loaned_messages),
+        mola::param("period_publish_tf", &Params::period_publish_tf),
+        mola::param(
+            "tf_deadband_translation", &Params::tf_deadband_translation),
+        mola::param(
+            "tf_deadband_rotation_deg", &Params::tf_deadband_rotation_deg),
+        mola::param(
+            "tf_deadband_refresh_period",
+            &Params::tf_deadband_refresh_period));
+
     // Yaml is NOT a reference on purpose.
     void ros_node_thread_main(Yaml cfg);
 
@@ -163,6 +242,11 @@ class BridgeROS2 : public RawDataSourceBase, public mola::RawDataConsumer
         auto lck = mrpt::lockHelper(rosNodeMtx_);
         return rosNode_;
     }
+    /// One reentrant callback group per subscribed sensor topic, plus a
+    /// dedicated one shared by all IMU/odometry subscriptions:
+    std::vector<rclcpp::CallbackGroup::SharedPtr> cbGroupsSensors_;
+    rclcpp::CallbackGroup::SharedPtr              cbGroupImuOdo_;
+
     std::vector<rclcpp::Subscription<sensor_msgs::msg::PointCloud2>::SharedPtr>
         subsPointCloud_;
 
@@ -183,6 +267,36 @@ class BridgeROS2 : public RawDataSourceBase, public mola::RawDataConsumer
         const std::string&                         outSensorLabel,
         const std::optional<mrpt::poses::CPose3D>& fixedSensorPose);
 
+    /** Detected wire layout of one PointCloud2 topic, for the fast
+     * conversion path of callbackOnPointCloud2(): detection runs once per
+     * topic and is re-validated only against the (cheap) field count and
+     * stride afterwards. */
+    struct Pc2FastLayout
+    {
+        enum class Kind : uint8_t
+        {
+            Generic = 0,  //!< anything else: per-field generic converter
+            XYZ,          //!< packed float32 x,y,z at offsets 0/4/8
+            XYZI          //!< idem, plus one float32 intensity field
+        };
+
+        Kind          kind            = Kind::Generic;
+        uint32_t      pointStep       = 0;
+        uint32_t      intensityOffset = 0;
+        std::size_t   numFields       = 0;
+    };
+
+    std::map<std::string, Pc2FastLayout> pc2LayoutCache_;
+    std::mutex                           pc2LayoutCacheMtx_;
+
+    /** Fast path for callbackOnPointCloud2(): when the cloud matches one of
+     * the common packed XYZ(I) layouts, points are bulk de-interleaved
+     * straight from the CDR buffer into a pre-sized mrpt cloud, skipping
+     * the per-point, per-field offset walk of the generic converter.
+     * Returns an empty Ptr for layouts it does not handle. */
+    mrpt::maps::CPointsMap::Ptr tryFastPointCloud2Conversion(
+        const sensor_msgs::msg::PointCloud2& o, const std::string& topicKey);
+
     void callbackOnLaserScan(
         const sensor_msgs::msg::LaserScan& o, const std::string& outSensorLabel,
         const std::optional<mrpt::poses::CPose3D>& fixedSensorPose);
@@ -225,6 +339,80 @@ class BridgeROS2 : public RawDataSourceBase, public mola::RawDataConsumer
     RosPubs    rosPubs_;
     std::mutex rosPubsMtx_;
 
+    /** Pool of reusable ROS message objects for one publisher family.
+     * rclcpp serializes from a const reference on publish(), so a message
+     * acquired here, filled in, published, and released keeps its internal
+     * buffers (most notably PointCloud2::data) allocated across cycles:
+     * steady-state high-rate publishing then performs no heap allocations.
+     * Leases are RAII, so a message returns to the pool also on exception
+     * paths. An optional capacity probe tracks the high-water payload size
+     * seen on release (see spinOnce() pool telemetry). */
+    template <class MsgT>
+    class MsgPool
+    {
+       public:
+        MsgPool() = default;
+        explicit MsgPool(std::function<std::size_t(const MsgT&)> capacityOf)
+            : capacityOf_(std::move(capacityOf))
+        {
+        }
+
+        using Lease = std::unique_ptr<MsgT, std::function<void(MsgT*)>>;
+
+        Lease acquire()
+        {
+            auto lck = mrpt::lockHelper(mtx_);
+            if (++inFlight_ > inFlightHighWater_) inFlightHighWater_ = inFlight_;
+            MsgT* m = nullptr;
+            if (free_.empty()) { m = new MsgT(); }
+            else
+            {
+                m = free_.back().release();
+                free_.pop_back();
+            }
+            return Lease(m, [this](MsgT* p) { release(p); });
+        }
+
+        /// Largest number of messages simultaneously checked out so far
+        std::size_t in_flight_high_water() const
+        {
+            auto lck = mrpt::lockHelper(mtx_);
+            return inFlightHighWater_;
+        }
+        /// Largest payload capacity [bytes] seen on release (0 if no probe)
+        std::size_t payload_capacity_high_water() const
+        {
+            auto lck = mrpt::lockHelper(mtx_);
+            return capacityHighWater_;
+        }
+
+       private:
+        void release(MsgT* m)
+        {
+            auto lck = mrpt::lockHelper(mtx_);
+            inFlight_--;
+            if (capacityOf_)
+                capacityHighWater_ =
+                    std::max(capacityHighWater_, capacityOf_(*m));
+            free_.emplace_back(m);
+        }
+
+        mutable std::mutex                      mtx_;
+        std::vector<std::unique_ptr<MsgT>>      free_;
+        std::function<std::size_t(const MsgT&)> capacityOf_;
+
+        std::size_t inFlight_ = 0, inFlightHighWater_ = 0;
+        std::size_t capacityHighWater_ = 0;
+    };
+
+    MsgPool<sensor_msgs::msg::PointCloud2> poolPointCloud2_{
+        [](const sensor_msgs::msg::PointCloud2& m)
+        { return m.data.capacity(); }};
+    MsgPool<nav_msgs::msg::Odometry>     poolOdometry_;
+    MsgPool<sensor_msgs::msg::LaserScan> poolLaserScan_{
+        [](const sensor_msgs::msg::LaserScan& m)
+        { return m.ranges.capacity() * sizeof(float); }};
+
     struct MolaSubs
     {
         std::set<mola::RawDataSourceBase::Ptr>                  dataSources;
@@ -242,12 +430,38 @@ class BridgeROS2 : public RawDataSourceBase, public mola::RawDataConsumer
 
     std::mutex lastLocMapMtx_;
     std::optional<mola::LocalizationSourceBase::LocalizationUpdate> lastLoc_;
-    std::map<std::string /*map_name*/, mola::MapSourceBase::MapUpdate>
-        lastMaps_;
+
+    /** Pending map updates, in arrival order. Full-map updates supersede any
+     * queued update of the same layer; incremental patches (dirty_region
+     * set) are all kept so no changed region is dropped. */
+    std::vector<mola::MapSourceBase::MapUpdate> lastMaps_;
 
     void timerPubLocalization();
     void timerPubMap();
 
+    /** Enqueues one dynamic transform for the next batched /tf broadcast,
+     * applying the configured deadbands (see Params::tf_deadband_*). Within
+     * one batch window, transforms coalesce per (parent,child) pair. */
+    void queueTf(const geometry_msgs::msg::TransformStamped& tf);
+    void timerPubTf();
+
+    using tf_frame_pair_t = std::pair<std::string, std::string>;
+
+    struct LastSentTf
+    {
+        geometry_msgs::msg::TransformStamped tf;
+        double                               wallTime = 0;
+    };
+
+    std::mutex tfQueueMtx_;
+    std::map<tf_frame_pair_t, geometry_msgs::msg::TransformStamped>
+                                           pendingTfs_;
+    std::map<tf_frame_pair_t, LastSentTf> lastSentTfs_;
+
+    /// The static broadcaster is latched (transient-local), so the static
+    /// tree only needs to be sent once:
+    bool staticTfsSent_ = false;
+
     double lastTimeCheckMolaSubs_ = 0;
     void   doLookForNewMolaSubs();
 
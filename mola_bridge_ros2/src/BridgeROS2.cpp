@@ -22,6 +22,7 @@
 #include <mola_kernel/pretty_print_exception.h>
 #include <mola_yaml/yaml_helpers.h>
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/core/initializer.h>
 #include <mrpt/maps/CPointsMapXYZI.h>
 #include <mrpt/maps/CPointsMapXYZIRT.h>
@@ -41,8 +42,13 @@
 #include <mrpt/ros2bridge/time.h>
 #include <mrpt/system/filesystem.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 // ROS 2:
 #include <nav_msgs/msg/odometry.hpp>
+#include <rclcpp/executors/multi_threaded_executor.hpp>
 #include <rclcpp/node.hpp>
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 
@@ -134,8 +140,23 @@ void BridgeROS2::ros_node_thread_main(Yaml cfg)
                 1e6 * params_.period_publish_static_tfs)),
             [this]() { publishStaticTFs(); });
 
-        // Spin:
-        rclcpp::spin(rosNode_);
+        // Batched /tf flush (see queueTf()):
+        auto timerTf = rosNode_->create_wall_timer(
+            std::chrono::microseconds(static_cast<unsigned int>(
+                1e6 * params_.period_publish_tf)),
+            [this]() { timerPubTf(); });
+
+        // Spin with a multi-threaded executor, so per-topic callback groups
+        // run concurrently and e.g. IMU messages are not queued behind
+        // point-cloud conversions:
+        size_t nThreads = params_.ros_executor_threads;
+        if (nThreads == 0)
+            nThreads = std::max(2u, std::thread::hardware_concurrency());
+
+        rclcpp::executors::MultiThreadedExecutor executor(
+            rclcpp::ExecutorOptions(), nThreads);
+        executor.add_node(rosNode_);
+        executor.spin();
 
         rclcpp::shutdown();
     }
@@ -162,13 +183,8 @@ void BridgeROS2::initialize_rds(const Yaml& c)
 
     MRPT_LOG_DEBUG_STREAM("Initializing with these params:\n" << cfgCopy);
 
-    // params of the ROS2->MOLA part:
-    YAML_LOAD_OPT(params_, base_link_frame, std::string);
-    YAML_LOAD_OPT(params_, odom_frame, std::string);
-    YAML_LOAD_OPT(params_, base_footprint_frame, std::string);
-
-    YAML_LOAD_OPT(params_, forward_ros_tf_as_mola_odometry_observations, bool);
-    YAML_LOAD_OPT(params_, wait_for_tf_timeout_milliseconds, int);
+    // Bulk-parse the declarative parameter table (see PARAMS_TABLE):
+    mola::load_params(params_, PARAMS_TABLE, cfg);
 
     if (cfg.has("base_footprint_to_base_link_tf"))
     {
@@ -179,15 +195,6 @@ void BridgeROS2::initialize_rds(const Yaml& c)
             mrpt::math::TPose3D::FromString(s);
     }
 
-    // params of the MOLA-ROS2 part:
-    YAML_LOAD_OPT(params_, base_link_frame, std::string);
-    YAML_LOAD_OPT(params_, reference_frame, std::string);
-    YAML_LOAD_OPT(params_, publish_odometry_msgs_from_slam, bool);
-    YAML_LOAD_OPT(params_, publish_in_sim_time, bool);
-    YAML_LOAD_OPT(params_, period_publish_new_localization, double);
-    YAML_LOAD_OPT(params_, period_publish_new_map, double);
-    YAML_LOAD_OPT(params_, publish_tf_from_robot_pose_observations, bool);
-
     // Launch ROS node:
     rosNodeThread_ =
         std::thread(&BridgeROS2::ros_node_thread_main, this, cfgCopy);
@@ -211,6 +218,15 @@ void BridgeROS2::spinOnce()
     {
         lastTimeCheckMolaSubs_ = mrpt::Clock::nowDouble();
         doLookForNewMolaSubs();
+
+        // Message-pool telemetry (ends up in the profiler summary): the
+        // high-water marks tell whether pools converged to a steady size:
+        profiler_.registerUserMeasure(
+            "msg_pool.pointcloud2_bytes_highwater",
+            static_cast<double>(poolPointCloud2_.payload_capacity_high_water()));
+        profiler_.registerUserMeasure(
+            "msg_pool.pointcloud2_inflight_highwater",
+            static_cast<double>(poolPointCloud2_.in_flight_high_water()));
     }
 
     MRPT_END
@@ -223,12 +239,20 @@ void BridgeROS2::callbackOnPointCloud2(
     MRPT_START
     ProfilerEntry tle(profiler_, "callbackOnPointCloud2");
 
-    const std::set<std::string> fields = mrpt::ros2bridge::extractFields(o);
-
     mrpt::maps::CPointsMap::Ptr mapPtr;
 
-    if (fields.count("time") || fields.count("timestamp") ||
-        fields.count("ring"))
+    // Layout-specialized fast path first; anything it does not handle
+    // (ring/timestamp fields, exotic strides, big-endian) falls back to the
+    // generic per-field converter below:
+    if (auto fastMap = tryFastPointCloud2Conversion(o, outSensorLabel);
+        fastMap)
+    {
+        mapPtr = fastMap;
+    }
+    else if (const std::set<std::string> fields =
+                 mrpt::ros2bridge::extractFields(o);
+             fields.count("time") || fields.count("timestamp") ||
+             fields.count("ring"))
     {
         auto p = mrpt::maps::CPointsMapXYZIRT::Create();
         if (!mrpt::ros2bridge::fromROS(o, *p))
@@ -288,6 +312,123 @@ void BridgeROS2::callbackOnPointCloud2(
     MRPT_END
 }
 
+mrpt::maps::CPointsMap::Ptr BridgeROS2::tryFastPointCloud2Conversion(
+    const sensor_msgs::msg::PointCloud2& o, const std::string& topicKey)
+{
+    using sensor_msgs::msg::PointField;
+
+    // 1) Layout detection, once per topic. Afterwards, only the field count
+    // and stride are re-checked per message, in case a topic ever changes
+    // its layout mid-run:
+    Pc2FastLayout lay;
+    {
+        auto lck = mrpt::lockHelper(pc2LayoutCacheMtx_);
+
+        if (const auto it = pc2LayoutCache_.find(topicKey);
+            it != pc2LayoutCache_.end() &&
+            it->second.pointStep == o.point_step &&
+            it->second.numFields == o.fields.size())
+        {
+            lay = it->second;
+        }
+        else
+        {
+            lay.pointStep = o.point_step;
+            lay.numFields = o.fields.size();
+            lay.kind      = Pc2FastLayout::Kind::Generic;
+
+            // The fast path only covers the common packed layouts: float32
+            // x,y,z at offsets 0/4/8, plus (optionally) one float32
+            // intensity. Any extra field (ring, time, rgb, ...) must go
+            // through the generic converter, which knows how to keep it:
+            uint32_t seenXYZ     = 0;  // bitmask: x=1, y=2, z=4
+            bool     otherFields = false, hasI = false;
+            uint32_t iOff = 0;
+
+            for (const auto& f : o.fields)
+            {
+                if (f.datatype == PointField::FLOAT32 && f.count == 1)
+                {
+                    // clang-format off
+                    if (f.name == "x" && f.offset == 0) { seenXYZ |= 1; continue; }
+                    if (f.name == "y" && f.offset == 4) { seenXYZ |= 2; continue; }
+                    if (f.name == "z" && f.offset == 8) { seenXYZ |= 4; continue; }
+                    if (f.name == "intensity") { hasI = true; iOff = f.offset; continue; }
+                    // clang-format on
+                }
+                otherFields = true;
+            }
+
+            if (seenXYZ == 7 && !otherFields && !o.is_bigendian &&
+                o.point_step >= (hasI ? std::max(12u, iOff + 4) : 12u))
+            {
+                lay.kind = hasI ? Pc2FastLayout::Kind::XYZI
+                                : Pc2FastLayout::Kind::XYZ;
+                lay.intensityOffset = iOff;
+            }
+
+            pc2LayoutCache_[topicKey] = lay;
+        }
+    }
+
+    if (lay.kind == Pc2FastLayout::Kind::Generic) return {};
+
+    // Rows must be contiguous for the single linear pass:
+    if (o.height > 1 && o.row_step != o.width * o.point_step) return {};
+
+    const size_t N = static_cast<size_t>(o.width) * o.height;
+    if (o.data.size() < N * lay.pointStep) return {};  // malformed msg
+
+    // 2) Bulk de-interleave from the CDR buffer into the pre-sized cloud:
+    // tight fixed-stride loops of unaligned 4-byte loads, instead of the
+    // generic converter's per-point PointField offset walk:
+    const auto*  base = o.data.data();
+    const size_t step = lay.pointStep;
+
+    mrpt::maps::CPointsMap::Ptr outMap;
+
+    if (lay.kind == Pc2FastLayout::Kind::XYZI)
+    {
+        auto p = mrpt::maps::CPointsMapXYZI::Create();
+        p->resize(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            const auto* pt = base + i * step;
+            float       xyz[3], intensity;
+            std::memcpy(xyz, pt, sizeof(xyz));
+            std::memcpy(&intensity, pt + lay.intensityOffset, sizeof(float));
+            p->setPointFast(i, xyz[0], xyz[1], xyz[2]);
+            p->setPointIntensity(i, intensity);
+        }
+        outMap = p;
+    }
+    else
+    {
+        auto p = mrpt::maps::CSimplePointsMap::Create();
+        p->resize(N);
+        for (size_t i = 0; i < N; i++)
+        {
+            const auto* pt = base + i * step;
+            float       xyz[3];
+            std::memcpy(xyz, pt, sizeof(xyz));
+            p->setPointFast(i, xyz[0], xyz[1], xyz[2]);
+        }
+        outMap = p;
+    }
+
+    // setPointFast() skips cache invalidation on purpose; re-set the last
+    // point through the checked API so the KD-tree/bounding-box caches are
+    // marked dirty exactly once:
+    if (N > 0)
+    {
+        float x, y, z;
+        outMap->getPointFast(N - 1, x, y, z);
+        outMap->setPoint(N - 1, x, y, z);
+    }
+
+    return outMap;
+}
+
 bool BridgeROS2::waitForTransform(
     mrpt::poses::CPose3D& des, const std::string& frame,
     const std::string& referenceFrame, bool printErrors)
@@ -579,7 +720,7 @@ void BridgeROS2::internalOn(const mrpt::obs::CObservationImage& obs)
     tfStmp.child_frame_id  = sSensorFrameId;
     tfStmp.header.frame_id = params_.base_link_frame;
     tfStmp.header.stamp    = myNow(obs.timestamp);
-    tf_bc_->sendTransform(tfStmp);
+    queueTf(tfStmp);
 
     // Send observation:
     {
@@ -633,20 +774,21 @@ void BridgeROS2::internalOn(const mrpt::obs::CObservation2DRangeScan& obs)
     tfStmp.child_frame_id  = sSensorFrameId;
     tfStmp.header.frame_id = params_.base_link_frame;
     tfStmp.header.stamp    = myNow(obs.timestamp);
-    tf_bc_->sendTransform(tfStmp);
+    queueTf(tfStmp);
 
     // Send observation:
     {
         obs.load();
 
-        // Convert observation MRPT -> ROS
-        sensor_msgs::msg::LaserScan msg;
-        mrpt::ros2bridge::toROS(obs, msg);
+        // Convert observation MRPT -> ROS, into a pooled message whose
+        // ranges/intensities buffers are reused across publishes:
+        auto msg = poolLaserScan_.acquire();
+        mrpt::ros2bridge::toROS(obs, *msg);
 
-        msg.header.stamp    = myNow(obs.timestamp);
-        msg.header.frame_id = sSensorFrameId;
+        msg->header.stamp    = myNow(obs.timestamp);
+        msg->header.frame_id = sSensorFrameId;
 
-        pubLS->publish(msg);
+        pubLS->publish(*msg);
     }
 }
 
@@ -711,15 +853,30 @@ void BridgeROS2::internalOn(
         tfStmp.child_frame_id  = sSensorFrameId;
         tfStmp.header.frame_id = params_.base_link_frame;
         tfStmp.header.stamp    = myNow(obs.timestamp);
-        tf_bc_->sendTransform(tfStmp);
+        queueTf(tfStmp);
     }
 
     // Send observation:
     if (obs.pointcloud)
     {
+        // Zero-copy path: build the PointCloud2 layout directly inside an
+        // RMW-loaned buffer (e.g. iceoryx shared memory), when supported;
+        // otherwise reuse a pooled message so its `data` vector keeps its
+        // capacity across publishes (no steady-state allocations):
+        std::optional<rclcpp::LoanedMessage<sensor_msgs::msg::PointCloud2>>
+                                                       loaned;
+        MsgPool<sensor_msgs::msg::PointCloud2>::Lease pooled;
+
+        if (params_.use_loaned_messages && pubPoints->can_loan_messages())
+            loaned.emplace(pubPoints->borrow_loaned_message());
+        else
+            pooled = poolPointCloud2_.acquire();
+
+        sensor_msgs::msg::PointCloud2& msg_pts =
+            loaned ? loaned->get() : *pooled;
+
         // Convert observation MRPT -> ROS
-        sensor_msgs::msg::PointCloud2 msg_pts;
-        std_msgs::msg::Header         msg_header;
+        std_msgs::msg::Header msg_header;
         msg_header.stamp    = myNow(obs.timestamp);
         msg_header.frame_id = sSensorFrameId;
 
@@ -751,7 +908,10 @@ void BridgeROS2::internalOn(
                 obs.pointcloud->GetRuntimeClass()->className);
         }
 
-        pubPoints->publish(msg_pts);
+        if (loaned)
+            pubPoints->publish(std::move(*loaned));
+        else
+            pubPoints->publish(msg_pts);
     }
 }
 
@@ -791,21 +951,22 @@ void BridgeROS2::internalOn(const mrpt::obs::CObservationRobotPose& obs)
         tfStmp.child_frame_id  = params_.base_link_frame;
         tfStmp.header.frame_id = params_.reference_frame;
         tfStmp.header.stamp    = myNow(obs.timestamp);
-        tf_bc_->sendTransform(tfStmp);
+        queueTf(tfStmp);
     }
 
     // Send observation:
     {
         obs.load();
 
-        // Convert observation MRPT -> ROS
-        nav_msgs::msg::Odometry msg;
-        msg.header.stamp    = myNow(obs.timestamp);
-        msg.header.frame_id = params_.reference_frame;
+        // Convert observation MRPT -> ROS (pooled: reused at the odometry
+        // rate, 100+ Hz on some setups):
+        auto msg             = poolOdometry_.acquire();
+        msg->header.stamp    = myNow(obs.timestamp);
+        msg->header.frame_id = params_.reference_frame;
 
-        msg.pose = mrpt::ros2bridge::toROS_Pose(obs.pose);
+        msg->pose = mrpt::ros2bridge::toROS_Pose(obs.pose);
 
-        pubOdo->publish(msg);
+        pubOdo->publish(*msg);
     }
 }
 
@@ -845,7 +1006,7 @@ void BridgeROS2::internalOn(const mrpt::obs::CObservationGPS& obs)
     tfStmp.child_frame_id  = sSensorFrameId;
     tfStmp.header.frame_id = params_.base_link_frame;
     tfStmp.header.stamp    = myNow(obs.timestamp);
-    tf_bc_->sendTransform(tfStmp);
+    queueTf(tfStmp);
 
     // Send observation:
     {
@@ -954,7 +1115,16 @@ void BridgeROS2::onNewMap(const mola::MapSourceBase::MapUpdate& m)
 {
     auto lck = mrpt::lockHelper(lastLocMapMtx_);
 
-    lastMaps_[m.map_name] = m;
+    if (!m.dirty_region)
+    {
+        // Full-map update: supersedes anything still queued for this layer.
+        lastMaps_.erase(
+            std::remove_if(
+                lastMaps_.begin(), lastMaps_.end(), [&m](const auto& e)
+                { return e.map_name == m.map_name; }),
+            lastMaps_.end());
+    }
+    lastMaps_.push_back(m);
 }
 
 void BridgeROS2::timerPubLocalization()
@@ -1007,23 +1177,23 @@ void BridgeROS2::timerPubLocalization()
     tfStmp.child_frame_id  = params_.base_link_frame;
     tfStmp.header.frame_id = params_.reference_frame;
     tfStmp.header.stamp    = myNow(l->timestamp);
-    tf_bc_->sendTransform(tfStmp);
+    queueTf(tfStmp);
 
     // 2/2: Publish Odometry msg:
     if (params_.publish_odometry_msgs_from_slam)
     {
         // Convert observation MRPT -> ROS
-        nav_msgs::msg::Odometry msg;
-        msg.header.stamp    = myNow(l->timestamp);
-        msg.header.frame_id = params_.reference_frame;
+        auto msg             = poolOdometry_.acquire();
+        msg->header.stamp    = myNow(l->timestamp);
+        msg->header.frame_id = params_.reference_frame;
 
         mrpt::poses::CPose3DPDFGaussian posePdf;
         posePdf.mean = mrpt::poses::CPose3D(l->pose);
         if (l->cov) posePdf.cov = l->cov.value();
 
-        msg.pose = mrpt::ros2bridge::toROS_Pose(posePdf);
+        msg->pose = mrpt::ros2bridge::toROS_Pose(posePdf);
 
-        pubOdo->publish(msg);
+        pubOdo->publish(*msg);
     }
 }
 
@@ -1032,7 +1202,7 @@ void BridgeROS2::timerPubMap()
     using namespace std::string_literals;
 
     // get a copy of the data minimizing the time owning the mutex:
-    std::map<std::string /*map_name*/, mola::MapSourceBase::MapUpdate> m;
+    std::vector<mola::MapSourceBase::MapUpdate> m;
     {
         auto lck  = mrpt::lockHelper(lastLocMapMtx_);
         m         = std::move(lastMaps_);
@@ -1040,12 +1210,16 @@ void BridgeROS2::timerPubMap()
     }
     if (m.empty()) return;
 
-    MRPT_LOG_DEBUG_STREAM("New map layers (" << m.size() << ") received");
+    MRPT_LOG_DEBUG_STREAM("New map updates (" << m.size() << ") received");
 
-    for (const auto& [layerName, mu] : m)
+    for (const auto& mu : m)
     {
+        // Incremental patches (changed region only) go to a separate
+        // "<topic>_updates" topic; full maps keep the transient-local main
+        // topic, so late-joining subscribers always receive a full keyframe:
         const std::string mapTopic =
-            (mu.method.empty() ? "slam"s : mu.method) + "/"s + layerName;
+            (mu.method.empty() ? "slam"s : mu.method) + "/"s + mu.map_name +
+            (mu.dirty_region ? "_updates"s : ""s);
 
         // Reuse code for point cloud observations: build a "fake" observation:
         mrpt::obs::CObservationPointCloud obs;
@@ -1056,7 +1230,7 @@ void BridgeROS2::timerPubMap()
         {
             MRPT_LOG_WARN_STREAM(
                 "Do not know how to publish map layer '"
-                << layerName << "' of type '"
+                << mu.map_name << "' of type '"
                 << mu.map->GetRuntimeClass()->className << "'");
             continue;
         }
@@ -1076,7 +1250,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
 
     for (const auto& topicItem : ds_subscribe.asSequence())
     {
-        const auto topic = mrpt::containers::yaml(topicItem);
+        // Non-owning view: no need to deep copy each entry to read it:
+        const auto topic = mola::YamlView(topicItem);
 
         ENSURE_YAML_ENTRY_EXISTS(topic, "topic");
         ENSURE_YAML_ENTRY_EXISTS(topic, "msg_type");
@@ -1101,6 +1276,26 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                 "["s + topic["fixed_sensor_pose"].as<std::string>() + "]"s);
         }
 
+        // Callback groups: one reentrant group per topic, except
+        // IMU/odometry, which share a dedicated group so their small
+        // high-rate messages are serviced independently of heavy point-cloud
+        // conversions:
+        if (!cbGroupImuOdo_)
+            cbGroupImuOdo_ = rosNode_->create_callback_group(
+                rclcpp::CallbackGroupType::Reentrant);
+
+        rclcpp::SubscriptionOptions subOpts;
+        if (type == "Imu" || type == "Odometry")
+        {
+            subOpts.callback_group = cbGroupImuOdo_;
+        }
+        else
+        {
+            subOpts.callback_group = cbGroupsSensors_.emplace_back(
+                rosNode_->create_callback_group(
+                    rclcpp::CallbackGroupType::Reentrant));
+        }
+
         if (type == "PointCloud2")
         {
             subsPointCloud_.emplace_back(
@@ -1110,7 +1305,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                      fixedSensorPose](const sensor_msgs::msg::PointCloud2& o) {
                         this->callbackOnPointCloud2(
                             o, output_sensor_label, fixedSensorPose);
-                    }));
+                    },
+                    subOpts));
         }
         else if (type == "LaserScan")
         {
@@ -1121,7 +1317,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                      fixedSensorPose](const sensor_msgs::msg::LaserScan& o) {
                         this->callbackOnLaserScan(
                             o, output_sensor_label, fixedSensorPose);
-                    }));
+                    },
+                    subOpts));
         }
         else if (type == "Imu")
         {
@@ -1132,7 +1329,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                      fixedSensorPose](const sensor_msgs::msg::Imu& o) {
                         this->callbackOnImu(
                             o, output_sensor_label, fixedSensorPose);
-                    }));
+                    },
+                    subOpts));
         }
         else if (type == "NavSatFix")
         {
@@ -1143,7 +1341,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                      fixedSensorPose](const sensor_msgs::msg::NavSatFix& o) {
                         this->callbackOnNavSatFix(
                             o, output_sensor_label, fixedSensorPose);
-                    }));
+                    },
+                    subOpts));
         }
         else if (type == "Odometry")
         {
@@ -1152,7 +1351,8 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
                     topic_name, qos,
                     [this,
                      output_sensor_label](const nav_msgs::msg::Odometry& o)
-                    { this->callbackOnOdometry(o, output_sensor_label); }));
+                    { this->callbackOnOdometry(o, output_sensor_label); },
+                    subOpts));
         }
         else
         {
@@ -1163,8 +1363,80 @@ void BridgeROS2::internalAnalyzeTopicsToSubscribe(
     }
 }
 
+void BridgeROS2::queueTf(const geometry_msgs::msg::TransformStamped& tf)
+{
+    auto lck = mrpt::lockHelper(tfQueueMtx_);
+
+    const auto key = std::make_pair(tf.header.frame_id, tf.child_frame_id);
+
+    // Deadband filter: skip re-broadcasting imperceptible changes, unless
+    // the last sent transform is old enough that listeners could see it
+    // expire. A transform already pending in this batch window is always
+    // overwritten (coalesced), never dropped:
+    if (const auto itLast = lastSentTfs_.find(key);
+        itLast != lastSentTfs_.end() && pendingTfs_.count(key) == 0 &&
+        (params_.tf_deadband_translation > 0 ||
+         params_.tf_deadband_rotation_deg > 0) &&
+        mrpt::Clock::nowDouble() - itLast->second.wallTime <
+            params_.tf_deadband_refresh_period)
+    {
+        const auto& a = itLast->second.tf.transform;
+        const auto& b = tf.transform;
+
+        const double dTrans = std::hypot(
+            a.translation.x - b.translation.x,
+            a.translation.y - b.translation.y,
+            a.translation.z - b.translation.z);
+
+        const double qDot = a.rotation.x * b.rotation.x +
+                            a.rotation.y * b.rotation.y +
+                            a.rotation.z * b.rotation.z +
+                            a.rotation.w * b.rotation.w;
+        const double dRot = 2.0 * std::acos(std::min(1.0, std::abs(qDot)));
+
+        const bool transWithin = params_.tf_deadband_translation <= 0 ||
+                                 dTrans < params_.tf_deadband_translation;
+        const bool rotWithin =
+            params_.tf_deadband_rotation_deg <= 0 ||
+            dRot < mrpt::DEG2RAD(params_.tf_deadband_rotation_deg);
+
+        if (transWithin && rotWithin) return;  // imperceptible: drop it
+    }
+
+    pendingTfs_[key] = tf;
+}
+
+void BridgeROS2::timerPubTf()
+{
+    // All transforms queued within one batch window go out as a single
+    // TFMessage, instead of one message per sensor/localization callback:
+    std::vector<geometry_msgs::msg::TransformStamped> batch;
+    {
+        auto lck = mrpt::lockHelper(tfQueueMtx_);
+        if (pendingTfs_.empty()) return;
+
+        batch.reserve(pendingTfs_.size());
+        const double tNow = mrpt::Clock::nowDouble();
+        for (auto& [key, tf] : pendingTfs_)
+        {
+            auto& last    = lastSentTfs_[key];
+            last.tf       = tf;
+            last.wallTime = tNow;
+            batch.emplace_back(std::move(tf));
+        }
+        pendingTfs_.clear();
+    }
+
+    tf_bc_->sendTransform(batch);
+}
+
 void BridgeROS2::publishStaticTFs()
 {
+    // The static broadcaster is latched (transient-local): one send reaches
+    // any number of late-joining listeners, so do not re-flood /tf_static
+    // on every timer period:
+    if (staticTfsSent_) return;
+
     if (!params_.base_footprint_frame.empty())
     {
         const tf2::Transform transform = mrpt::ros2bridge::toROS_tfTransform(
@@ -1178,6 +1450,6 @@ void BridgeROS2::publishStaticTFs()
         tfStmp.header.stamp    = myNow(mrpt::Clock::now());
 
         tf_static_bc_->sendTransform(tfStmp);
-        // tf_bc_->sendTransform(tfStmp);
+        staticTfsSent_ = true;
     }
 }
@@ -0,0 +1,218 @@
+#!/bin/env python3
+# -----------------------------------------------------------------------------
+#        A Modular Optimization framework for Localization and mApping
+#                               (MOLA)
+#
+# Copyright (C) 2018-2024, Jose Luis Blanco-Claraco, contributors (AUTHORS.md)
+# All rights reserved.
+# Released under GNU GPL v3. See LICENSE file
+# -----------------------------------------------------------------------------
+#
+# Reference performance benchmark runner: executes the curated pipelines in
+# ./pipelines/ over a rawlog mini-dataset at maximum speed via mola-cli,
+# collects the per-module profiler dumps (--profiler-whole) and peak RSS,
+# and emits a normalized timing/memory report (report.txt + report.json),
+# so performance numbers are comparable across sites and releases.
+#
+# See README.md in this directory for how to prepare the mini-dataset.
+
+import argparse
+import csv
+import glob
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+
+PIPELINE_ORDER = [
+    # full-slam first: its output map can feed localization-only.
+    'bench-full-slam',
+    'bench-localization-only',
+    'bench-lidar-odometry',
+]
+
+
+def parse_profiler_csv(path):
+    # mrpt CTimeLogger::saveToCSVFile() format: one quoted-fields row per
+    # profiled entry; columns are located by header name so minor format
+    # changes across MRPT versions do not break the parser.
+    entries = []
+    with open(path, newline='') as f:
+        rows = list(csv.reader(f))
+    if len(rows) < 2:
+        return entries
+
+    header = [c.strip().upper() for c in rows[0]]
+
+    def find_col(substr, default):
+        for i, h in enumerate(header):
+            if substr in h:
+                return i
+        return default
+
+    c_calls = find_col('CALL', 1)
+    c_mean = find_col('MEAN', 3)
+    c_total = find_col('TOTAL', 5)
+
+    for row in rows[1:]:
+        if not row:
+            continue
+        try:
+            entries.append({
+                'name': row[0].strip(),
+                'calls': int(float(row[c_calls])),
+                'mean_s': float(row[c_mean]),
+                'total_s': float(row[c_total]),
+            })
+        except (IndexError, ValueError):
+            continue
+    return entries
+
+
+def run_pipeline(name, yaml_file, run_dir, env):
+    os.makedirs(run_dir, exist_ok=True)
+
+    cmd = ['mola-cli', yaml_file, '--profiler-whole']
+
+    print('[{}] running: {}'.format(name, ' '.join(cmd)))
+    t0 = time.time()
+    with open(os.path.join(run_dir, 'mola-cli.log'), 'wb') as log:
+        proc = subprocess.Popen(
+            cmd, cwd=run_dir, env=env, stdout=log, stderr=subprocess.STDOUT)
+        # wait4() gives this child's own peak RSS, unlike
+        # resource.getrusage(RUSAGE_CHILDREN) which is a running max over
+        # all children of this script:
+        _, status, rusage = os.wait4(proc.pid, 0)
+    wall = time.time() - t0
+
+    if status != 0:
+        print('[{}] FAILED (exit status {}), see {}'.format(
+            name, status, os.path.join(run_dir, 'mola-cli.log')))
+        return None
+
+    # Collect the per-module profiler dumps written into the run directory:
+    modules = {}
+    for f in sorted(glob.glob(os.path.join(run_dir, '*.csv'))):
+        mod_name = os.path.splitext(os.path.basename(f))[0]
+        entries = parse_profiler_csv(f)
+        if entries:
+            modules[mod_name] = entries
+
+    return {
+        'wall_time_s': wall,
+        'peak_rss_mib': rusage.ru_maxrss / 1024.0,
+        'modules': modules,
+    }
+
+
+def write_text_report(f, report):
+    f.write('MOLA benchmark report\n')
+    f.write('=====================\n')
+    f.write('date:     {}\n'.format(report['date']))
+    f.write('host:     {}\n'.format(report['host']))
+    f.write('dataset:  {}\n\n'.format(report['dataset']))
+
+    for name, r in report['pipelines'].items():
+        f.write('{}\n{}\n'.format(name, '-' * len(name)))
+        if r is None:
+            f.write('  FAILED\n\n')
+            continue
+        f.write('  wall time: {:9.2f} s\n'.format(r['wall_time_s']))
+        f.write('  peak RSS:  {:9.1f} MiB\n'.format(r['peak_rss_mib']))
+        for mod, entries in r['modules'].items():
+            f.write('  module `{}`:\n'.format(mod))
+            top = sorted(
+                entries, key=lambda e: e['total_s'], reverse=True)[:10]
+            for e in top:
+                f.write(
+                    '    {:50s} {:8d} calls  mean {:9.3f} ms  '
+                    'total {:8.2f} s ({:5.1f} % wall)\n'.format(
+                        e['name'][:50], e['calls'], 1e3 * e['mean_s'],
+                        e['total_s'],
+                        100.0 * e['total_s'] / r['wall_time_s']))
+        f.write('\n')
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Run the MOLA reference performance benchmarks and emit '
+                    'a normalized timing/memory report.')
+    parser.add_argument(
+        '--rawlog', required=True,
+        help='Path to the benchmark mini-dataset (.rawlog); see README.md')
+    parser.add_argument(
+        '--lo-pipeline', required=True,
+        help='mola_lidar_odometry pipeline file, e.g. "$(ros2 pkg prefix '
+             '--share mola_lidar_odometry)/pipelines/lidar3d-default.yaml"')
+    parser.add_argument(
+        '--out', default='mola-bench-results',
+        help='Output directory for per-run logs and the report '
+             '(default: %(default)s)')
+    parser.add_argument(
+        '--only', default=None,
+        help='Run only the pipeline with this name (e.g. bench-full-slam)')
+    parser.add_argument(
+        '--localization-map', default=None,
+        help='Optional prebuilt metric map (.mm) for the localization-only '
+             'pipeline; without it, that pipeline runs with map updates '
+             'disabled but no prior map')
+    args = parser.parse_args()
+
+    pipelines_dir = os.path.join(os.path.dirname(
+        os.path.abspath(__file__)), 'pipelines')
+
+    names = [n for n in PIPELINE_ORDER
+             if os.path.isfile(os.path.join(pipelines_dir, n + '.yaml'))]
+    if args.only:
+        names = [n for n in names if n == args.only]
+    if not names:
+        print('No matching pipelines found in: ' + pipelines_dir)
+        return 1
+
+    os.makedirs(args.out, exist_ok=True)
+
+    base_env = dict(os.environ)
+    base_env['MOLA_BENCH_RAWLOG'] = os.path.abspath(args.rawlog)
+    base_env['MOLA_LO_PIPELINE'] = os.path.abspath(args.lo_pipeline)
+
+    report = {
+        'date': time.strftime('%Y-%m-%d %H:%M:%S'),
+        'host': platform.node(),
+        'dataset': os.path.abspath(args.rawlog),
+        'pipelines': {},
+    }
+
+    for name in names:
+        run_dir = os.path.join(args.out, name)
+        env = dict(base_env)
+
+        if name == 'bench-full-slam':
+            env['MOLA_MAPPING_ENABLED'] = 'true'
+            env['MOLA_SIMPLEMAP_OUTPUT'] = os.path.join(
+                os.path.abspath(run_dir), 'bench_map.simplemap')
+        elif name == 'bench-localization-only':
+            env['MOLA_MAPPING_ENABLED'] = 'false'
+            if args.localization_map:
+                env['MOLA_LOAD_MM'] = os.path.abspath(args.localization_map)
+
+        report['pipelines'][name] = run_pipeline(
+            name, os.path.join(pipelines_dir, name + '.yaml'),
+            run_dir, env)
+
+    with open(os.path.join(args.out, 'report.json'), 'w') as f:
+        json.dump(report, f, indent=2)
+    with open(os.path.join(args.out, 'report.txt'), 'w') as f:
+        write_text_report(f, report)
+    with open(os.path.join(args.out, 'report.txt')) as f:
+        sys.stdout.write(f.read())
+
+    print('Report written to: ' + os.path.join(args.out, 'report.json'))
+
+    return 0 if all(r is not None
+                    for r in report['pipelines'].values()) else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
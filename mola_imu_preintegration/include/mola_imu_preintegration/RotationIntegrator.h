@@ -29,6 +29,9 @@
 #include <mrpt/containers/yaml.h>
 #include <mrpt/core/optional_ref.h>
 
+#include <cstddef>
+#include <vector>
+
 namespace mola
 {
 /** Integrates gyroscope angular velocity readings.
@@ -70,10 +73,28 @@ class RotationIntegrator
         mrpt::math::CMatrixDouble33 deltaRij_ =
             mrpt::math::CMatrixDouble33::Identity();
 
-        /// Jacobian of preintegrated rotation w.r.t. angular rate bias
-        // (TODO)
-        // mrpt::math::CMatrixDouble33 delRdelBiasOmega_ =
-        // mrpt::math::CMatrixDouble33::Zero();
+        /// Jacobian of preintegrated rotation w.r.t. the angular rate bias
+        mrpt::math::CMatrixDouble33 delRdelBiasOmega_ =
+            mrpt::math::CMatrixDouble33::Zero();
+
+        /// Covariance of the preintegrated rotation, expressed in the local
+        /// frame at "j", propagated from params_.gyroCov. See eq. (42) in
+        /// Forster et al. (2015), "IMU preintegration on manifold".
+        mrpt::math::CMatrixDouble33 rotCovij_ =
+            mrpt::math::CMatrixDouble33::Zero();
+    };
+
+    /** One gyroscope reading, for the batch API integrate_measurements() */
+    struct GyroSample
+    {
+        GyroSample() = default;
+        GyroSample(const mrpt::math::TVector3D& omega, double deltaT)
+            : w(omega), dt(deltaT)
+        {
+        }
+
+        mrpt::math::TVector3D w = {.0, .0, .0};  //!< Angular velocity [rad/s]
+        double                dt = 0;  //!< Integration period [s]
     };
 
     /** \name Main API
@@ -101,6 +122,31 @@ class RotationIntegrator
      */
     void integrate_measurement(const mrpt::math::TVector3D& w, double dt);
 
+    /** Batch version of integrate_measurement() for whole windows of
+     * high-rate (e.g. 200 Hz) gyroscope samples: the bias and sensor-pose
+     * corrections are applied over the entire batch first (which vectorizes
+     * well), and the SO(3) updates use a small-angle fast path, so this is
+     * noticeably cheaper than N calls to the single-sample method.
+     */
+    void integrate_measurements(const GyroSample* samples, std::size_t count);
+
+    /// \overload
+    void integrate_measurements(const std::vector<GyroSample>& samples)
+    {
+        integrate_measurements(samples.data(), samples.size());
+    }
+
+    /** Returns the preintegrated rotation, corrected to first order for a
+     * change `deltaGyroBias` with respect to the bias used while
+     * integrating, using the cached bias Jacobian:
+     *
+     *   ΔR(b+δb) ≈ ΔR(b)·Exp(∂ΔR/∂b · δb)
+     *
+     * so a bias re-linearization does not need to redo the whole window.
+     */
+    mrpt::math::CMatrixDouble33 delta_rotation_with_bias_correction(
+        const mrpt::math::TVector3D& deltaGyroBias) const;
+
     RotationIntegrationParams params_;
 
     /** @} */
@@ -25,10 +25,95 @@
  */
 
 #include <mola_imu_preintegration/RotationIntegrator.h>
+#include <mrpt/math/ops_matrices.h>  // skew_symmetric3()
 #include <mrpt/poses/Lie/SO.h>
 
+#include <cmath>
+
 using namespace mola;
 
+namespace
+{
+/// Angles below this threshold take the Taylor-series fast paths:
+constexpr double SMALL_ANGLE = 1e-4;  // [rad]
+
+/** SO(3) exponential with a small-angle fast path (2nd-order Taylor), since
+ *  high-rate gyro samples integrate tiny angles almost always. */
+mrpt::math::CMatrixDouble33 so3_exp_fast(const mrpt::math::TVector3D& v)
+{
+    const double theta2 = v.sqrNorm();
+
+    if (theta2 < mrpt::square(SMALL_ANGLE))
+    {
+        mrpt::math::CMatrixDouble33 W;
+        mrpt::math::skew_symmetric3(v, W);
+
+        mrpt::math::CMatrixDouble33 R =
+            mrpt::math::CMatrixDouble33::Identity();
+        R.asEigen() += W.asEigen() + 0.5 * W.asEigen() * W.asEigen();
+        return R;
+    }
+
+    return mrpt::poses::Lie::SO<3>::exp(mrpt::math::CVectorFixedDouble<3>(v));
+}
+
+/** Right Jacobian of SO(3): maps additive increments of the rotation vector
+ *  onto multiplicative (local) increments of the rotation. See eq. (8) in
+ *  Forster et al. (2015), "IMU preintegration on manifold". */
+mrpt::math::CMatrixDouble33 so3_right_jacobian(const mrpt::math::TVector3D& v)
+{
+    mrpt::math::CMatrixDouble33 W;
+    mrpt::math::skew_symmetric3(v, W);
+
+    mrpt::math::CMatrixDouble33 J = mrpt::math::CMatrixDouble33::Identity();
+
+    const double theta2 = v.sqrNorm();
+    if (theta2 < mrpt::square(SMALL_ANGLE))
+    {
+        // Jr ≈ I - ½·[v]×
+        J.asEigen() -= 0.5 * W.asEigen();
+        return J;
+    }
+
+    const double theta = std::sqrt(theta2);
+    J.asEigen() += (-(1.0 - std::cos(theta)) / theta2) * W.asEigen() +
+                   ((theta - std::sin(theta)) / (theta2 * theta)) *
+                       (W.asEigen() * W.asEigen());
+    return J;
+}
+
+/** Fused update of the bias Jacobian and the rotation covariance for one
+ *  incremental rotation R = Exp(ω·dt). All operands are fixed-size 3x3
+ *  stack matrices and every product goes through .noalias(), so this hot
+ *  path performs no heap allocation and no hidden Eigen temporaries:
+ *
+ *   ∂ΔR/∂b ← Rᵀ · ∂ΔR/∂b − Jr·dt
+ *   Σ      ← Rᵀ · Σ · R + Jr · Σgyro · Jrᵀ · dt
+ *
+ *  (cf. gtsam::PreintegratedRotation and Forster et al. (2015), eq. (42);
+ *  Σgyro is the continuous-time gyro noise PSD, hence the single dt). */
+void propagate_jacobian_and_covariance(
+    RotationIntegrator::IntegrationState& s, const Eigen::Matrix3d& R,
+    const Eigen::Matrix3d& Jr, const Eigen::Matrix3d& gyroCov, double dt)
+{
+    Eigen::Matrix3d tmp;
+
+    tmp.noalias() = R.transpose() * s.delRdelBiasOmega_.asEigen();
+    tmp.noalias() -= Jr * dt;
+    s.delRdelBiasOmega_.asEigen() = tmp;
+
+    tmp.noalias() = s.rotCovij_.asEigen() * R;
+
+    Eigen::Matrix3d cov;
+    cov.noalias() = R.transpose() * tmp;
+
+    tmp.noalias() = Jr * gyroCov;
+    cov.noalias() += (tmp * Jr.transpose()) * dt;
+
+    s.rotCovij_.asEigen() = cov;
+}
+}  // namespace
+
 void RotationIntegrator::initialize(const mrpt::containers::yaml& cfg)
 {
     reset_integration();
@@ -46,13 +131,70 @@ void RotationIntegrator::reset_integration()
 void RotationIntegrator::integrate_measurement(
     const mrpt::math::TVector3D& w, double dt)
 {
-    const auto incrR = mola::incremental_rotation(w, params_, dt);
+    mrpt::math::CMatrixDouble33 incrJr;
+    const auto incrR = mola::incremental_rotation(w, params_, dt, incrJr);
 
     // Update integration state:
     state_.deltaTij_ += dt;
     state_.deltaRij_ = state_.deltaRij_ * incrR;
 
-    // TODO: Update Jacobian
+    propagate_jacobian_and_covariance(
+        state_, incrR.asEigen(), incrJr.asEigen(), params_.gyroCov.asEigen(),
+        dt);
+}
+
+void RotationIntegrator::integrate_measurements(
+    const GyroSample* samples, std::size_t count)
+{
+    if (count == 0) return;
+
+    // Hoist the per-sample corrections out of the SO(3) loop: bias
+    // subtraction and the (optional) sensor-to-vehicle rotation are plain
+    // linear operations, so applying them over the whole batch first
+    // vectorizes well:
+    thread_local std::vector<mrpt::math::TVector3D> wdt;
+    wdt.resize(count);
+
+    const auto& bias = params_.gyroBias;
+    for (std::size_t i = 0; i < count; i++)
+        wdt[i] = (samples[i].w - bias) * samples[i].dt;
+
+    if (params_.sensorPose.has_value())
+        for (std::size_t i = 0; i < count; i++)
+            wdt[i] = params_.sensorPose->rotateVector(wdt[i]);
+
+    // Accumulate the SO(3) compositions, the bias Jacobian, and the
+    // rotation covariance:
+    auto& deltaR = state_.deltaRij_;
+
+    const Eigen::Matrix3d gyroCov = params_.gyroCov.asEigen();
+
+    Eigen::Matrix3d tmpR;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        const Eigen::Matrix3d incrR  = so3_exp_fast(wdt[i]).asEigen();
+        const Eigen::Matrix3d incrJr = so3_right_jacobian(wdt[i]).asEigen();
+
+        state_.deltaTij_ += samples[i].dt;
+
+        tmpR.noalias()   = deltaR.asEigen() * incrR;
+        deltaR.asEigen() = tmpR;
+
+        propagate_jacobian_and_covariance(
+            state_, incrR, incrJr, gyroCov, samples[i].dt);
+    }
+}
+
+mrpt::math::CMatrixDouble33
+    RotationIntegrator::delta_rotation_with_bias_correction(
+        const mrpt::math::TVector3D& deltaGyroBias) const
+{
+    const Eigen::Vector3d c =
+        state_.delRdelBiasOmega_.asEigen() *
+        Eigen::Vector3d(deltaGyroBias.x, deltaGyroBias.y, deltaGyroBias.z);
+
+    return state_.deltaRij_ * so3_exp_fast({c.x(), c.y(), c.z()});
 }
 
 mrpt::math::CMatrixDouble33 mola::incremental_rotation(
@@ -74,11 +216,7 @@ mrpt::math::CMatrixDouble33 mola::incremental_rotation(
     const TVector3D w_dt = correctedW * dt;
 
     if (D_incrR_integratedOmega.has_value())
-    {
-        // TODO: Jacobian: mrpt::poses::Lie::SO<3>::jacob_dexpe_de()
-        THROW_EXCEPTION("Jacobian not implemented yet");
-    }
+        D_incrR_integratedOmega.value().get() = so3_right_jacobian(w_dt);
 
-    return mrpt::poses::Lie::SO<3>::exp(
-        mrpt::math::CVectorFixedDouble<3>(w_dt));
+    return so3_exp_fast(w_dt);
 }
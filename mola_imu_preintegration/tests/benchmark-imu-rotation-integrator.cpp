@@ -0,0 +1,113 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   benchmark-imu-rotation-integrator.cpp
+ * @brief  Micro-benchmark of RotationIntegrator (CSV output)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ *
+ * Emits one CSV row per benchmark on stdout
+ * (benchmark,samples,ops,total_time_s,ns_per_op), so the integration
+ * throughput can be tracked across releases with plain tooling.
+ * An optional first argument overrides the minimum wall-clock time [s]
+ * spent per benchmark (default: 0.5).
+ */
+
+#include <mola_imu_preintegration/RotationIntegrator.h>
+#include <mrpt/system/CTicTac.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace
+{
+double minTime = 0.5;  // [s]
+
+/** Repeats fn() until minTime elapses, then prints one CSV row. */
+void benchmark(
+    const std::string& name, const size_t opsPerCall,
+    const std::function<void()>& fn)
+{
+    fn();  // warm-up
+
+    mrpt::system::CTicTac tictac;
+    tictac.Tic();
+
+    size_t calls = 0;
+    double t     = 0;
+    do {
+        fn();
+        calls++;
+        t = tictac.Tac();
+    } while (t < minTime);
+
+    const double nsPerOp = 1e9 * t / (calls * opsPerCall);
+    std::printf(
+        "%s,%zu,%zu,%.6f,%.1f\n", name.c_str(), opsPerCall, calls * opsPerCall,
+        t, nsPerOp);
+    std::fflush(stdout);
+}
+
+/** A window of 200 Hz gyro samples with realistic magnitudes */
+std::vector<mola::RotationIntegrator::GyroSample> synthetic_window(
+    const size_t n)
+{
+    std::vector<mola::RotationIntegrator::GyroSample> samples;
+    samples.reserve(n);
+    for (size_t i = 0; i < n; i++)
+        samples.emplace_back(
+            mrpt::math::TVector3D(
+                0.1 * std::sin(i * 1e-2), -0.2 * std::cos(i * 2e-2), 0.5),
+            5e-3 /*dt*/);
+    return samples;
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) minTime = std::atof(argv[1]);
+
+    const auto samples = synthetic_window(1000);
+
+    mola::RotationIntegrator ri;
+    ri.params_.gyroBias = {-1.0e-4, 2.0e-4, -3.0e-4};
+
+    benchmark("rotation_integrator_single", samples.size(), [&]() {
+        ri.reset_integration();
+        for (const auto& s : samples) ri.integrate_measurement(s.w, s.dt);
+    });
+
+    benchmark("rotation_integrator_batch", samples.size(), [&]() {
+        ri.reset_integration();
+        ri.integrate_measurements(samples);
+    });
+
+    benchmark("rotation_integrator_bias_correction", 1000, [&]() {
+        for (int i = 0; i < 1000; i++)
+            (void)ri.delta_rotation_with_bias_correction({1e-4, -2e-4, 3e-4});
+    });
+
+    return 0;
+}
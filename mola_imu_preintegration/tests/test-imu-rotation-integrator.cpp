@@ -28,7 +28,9 @@
 #include <mola_imu_preintegration/RotationIntegrator.h>
 #include <mrpt/poses/Lie/SE.h>
 
+#include <cmath>
 #include <iostream>
+#include <vector>
 
 using namespace std::string_literals;
 
@@ -85,11 +87,92 @@ static void test_rotation_integration()
     lambdaAssertInitialState();
 }
 
+static void test_batch_integration()
+{
+    // The batch API must match sample-by-sample integration:
+    mola::RotationIntegrator riSeq, riBatch;
+    riSeq.initialize(mrpt::containers::yaml::FromText(yamlRotIntParams1));
+    riBatch.initialize(mrpt::containers::yaml::FromText(yamlRotIntParams1));
+
+    std::vector<mola::RotationIntegrator::GyroSample> samples;
+    for (int t = 0; t < 2000; t++)
+    {
+        const double dt = 1e-3;
+        const mrpt::math::TVector3D w = {
+            0.1 * std::sin(t * 1e-2), -0.2 * std::cos(t * 2e-2), 3.0};
+
+        riSeq.integrate_measurement(w, dt);
+        samples.emplace_back(w, dt);
+    }
+    riBatch.integrate_measurements(samples);
+
+    const auto& s1 = riSeq.current_integration_state();
+    const auto& s2 = riBatch.current_integration_state();
+
+    ASSERT_NEAR_(s1.deltaTij_, s2.deltaTij_, 1e-9);
+    ASSERT_LT_((s1.deltaRij_ - s2.deltaRij_).norm(), 1e-9);
+    ASSERT_LT_((s1.delRdelBiasOmega_ - s2.delRdelBiasOmega_).norm(), 1e-9);
+    ASSERT_LT_((s1.rotCovij_ - s2.rotCovij_).norm(), 1e-9);
+}
+
+static void test_covariance_propagation()
+{
+    mola::RotationIntegrator ri;
+    ri.initialize(mrpt::containers::yaml::FromText(yamlRotIntParams1));
+
+    const double sigma2 = 1e-4;  // gyro noise PSD [rad²/s]
+    ri.params_.gyroCov.setIdentity();
+    ri.params_.gyroCov.asEigen() *= sigma2;
+
+    for (int t = 0; t < 2000; t++)
+        ri.integrate_measurement({0.1, -0.2, 3.0}, 1e-3 /*dt*/);
+
+    const auto cov = ri.current_integration_state().rotCovij_.asEigen();
+
+    // Must remain symmetric:
+    ASSERT_LT_((cov - cov.transpose()).norm(), 1e-12);
+
+    // With isotropic gyro noise the rotation conjugations preserve the
+    // isotropy, so Σ ≈ σ²·ΔT·I up to the (tiny) Jr corrections:
+    const Eigen::Matrix3d expected =
+        (sigma2 * 2.0) * Eigen::Matrix3d::Identity();
+    ASSERT_LT_((cov - expected).norm(), 0.02 * expected.norm());
+}
+
+static void test_bias_jacobian()
+{
+    // First-order bias correction vs. re-integrating the whole window:
+    const mrpt::math::TVector3D db = {1e-4, -2e-4, 3e-4};
+
+    mola::RotationIntegrator ri, riNewBias;
+    ri.initialize(mrpt::containers::yaml::FromText(yamlRotIntParams1));
+    riNewBias.initialize(mrpt::containers::yaml::FromText(yamlRotIntParams1));
+    riNewBias.params_.gyroBias = riNewBias.params_.gyroBias + db;
+
+    for (int t = 0; t < 2000; t++)
+    {
+        const double dt = 1e-3;
+        const mrpt::math::TVector3D w = {
+            0.1 * std::sin(t * 1e-2), -0.2 * std::cos(t * 2e-2), 3.0};
+
+        ri.integrate_measurement(w, dt);
+        riNewBias.integrate_measurement(w, dt);
+    }
+
+    const auto corrected = ri.delta_rotation_with_bias_correction(db);
+    const auto& exact    = riNewBias.current_integration_state().deltaRij_;
+
+    ASSERT_LT_((corrected - exact).norm(), 1e-5);
+}
+
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
     try
     {
         test_rotation_integration();
+        test_batch_integration();
+        test_bias_jacobian();
+        test_covariance_propagation();
 
         std::cout << "Test successful." << std::endl;
     }
@@ -14,13 +14,18 @@
 #include <mola_kernel/interfaces/Dataset_UI.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
 #include <mrpt/core/Clock.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/img/TCamera.h>
 #include <mrpt/math/TPose3D.h>
 
 #include <array>
+#include <condition_variable>
 #include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <variant>
+#include <vector>
 
 namespace mola
 {
@@ -115,11 +120,47 @@ class EurocDataset : public RawDataSourceBase, public Dataset_UI
     void build_dataset_entry_obs(SensorCamera& s);
     void build_dataset_entry_obs(SensorIMU& s);
 
+    /** Thread-safe wrapper for the camera version of
+     * build_dataset_entry_obs(): returns with `s.obs` decoded, either
+     * reusing a background-decoded image, waiting for the worker that is
+     * decoding it right now, or decoding it synchronously. */
+    void ensure_camera_decoded(SensorCamera& s);
+
+    /** Number of background threads decompressing upcoming cam0/cam1
+     *  images (option `image_decode_threads`; 0 = synchronous decoding
+     *  on the playback thread, as before). */
+    unsigned int image_decode_threads_ = 2;
+
+    /** Option `imu_batching`: if enabled, the 200 Hz imu0 samples between
+     *  two consecutive camera frames are delivered to the front-ends as
+     *  one burst (see RawDataConsumer::onNewObservationBatch()), each
+     *  sample keeping its own timestamp, so VIO consumers wake up ~20x
+     *  less often. Default: off (one delivery per sample, as before). */
+    bool imu_batching_ = false;
+
+    /** IMU observations accumulated since the last camera frame
+     *  (imu_batching_ only). */
+    std::vector<mrpt::obs::CObservation::Ptr> imu_pending_batch_;
+
+    /** Delivers and clears imu_pending_batch_ */
+    void flush_imu_batch();
+
+    /** Guards decode_inflight_ and the SensorCamera::obs handover; held
+     *  only for bookkeeping, never while decoding an image. */
+    std::mutex                    decode_mtx_;
+    std::condition_variable       decode_cv_;
+    std::set<const SensorCamera*> decode_inflight_;
+
     mutable timestep_t    last_used_tim_index_ = 0;
     bool                  paused_              = false;
     double                time_warp_scale_     = 1.0;
     std::optional<size_t> teleport_here_;
     mutable std::mutex    dataset_ui_mtx_;
+
+    /** Workers decoding left/right images of upcoming timesteps
+     *  concurrently. Declared last so its destructor joins them before
+     *  the dataset_ entries their tasks use are destroyed. */
+    std::unique_ptr<mrpt::WorkerThreadsPool> imgDecodePool_;
 };
 
 }  // namespace mola
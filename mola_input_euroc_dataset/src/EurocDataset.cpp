@@ -65,8 +65,17 @@ void EurocDataset::initialize_rds(const Yaml& c)
 
     // Optional params with default values:
     YAML_LOAD_MEMBER_OPT(time_warp_scale, double);
+    YAML_LOAD_MEMBER_OPT(image_decode_threads, unsigned int);
+    YAML_LOAD_MEMBER_OPT(imu_batching, bool);
     paused_ = cfg.getOrDefault<bool>("start_paused", paused_);
 
+    if (image_decode_threads_ > 0)
+    {
+        imgDecodePool_ = std::make_unique<mrpt::WorkerThreadsPool>(
+            image_decode_threads_, mrpt::WorkerThreadsPool::POLICY_FIFO,
+            "EurocImgDecode");
+    }
+
     // Preload everything we may need later to quickly replay the dataset in
     // realtime:
     MRPT_LOG_INFO_STREAM("Loading EUROC dataset from: " << seq_dir_);
@@ -250,6 +259,10 @@ void EurocDataset::spinOnce()
         dataset_next_      = it;
         dataset_cur_idx_   = *teleport_here;
         last_dataset_time_ = (it->first - t0) * 1e-9;
+
+        // samples accumulated before the jump no longer belong to the
+        // upcoming camera frame:
+        imu_pending_batch_.clear();
     }
     else
     {
@@ -294,7 +307,10 @@ void EurocDataset::spinOnce()
                     THROW_EXCEPTION("Un-initialized entry!");
                 },
                 [&](SensorCamera& cam) {
-                    build_dataset_entry_obs(cam);
+                    // deliver first the IMU burst leading to this frame:
+                    flush_imu_batch();
+
+                    ensure_camera_decoded(cam);
                     cam.obs->timestamp = obs_tim;
                     this->sendObservationsToFrontEnds(cam.obs);
                     cam.obs.reset();  // free mem
@@ -302,7 +318,10 @@ void EurocDataset::spinOnce()
                 [&](SensorIMU& imu) {
                     build_dataset_entry_obs(imu);
                     imu.obs->timestamp = obs_tim;
-                    this->sendObservationsToFrontEnds(imu.obs);
+                    if (imu_batching_)
+                        imu_pending_batch_.push_back(imu.obs);
+                    else
+                        this->sendObservationsToFrontEnds(imu.obs);
                     imu.obs.reset();  // free mem
                 }},
             dataset_next_->second);
@@ -312,6 +331,11 @@ void EurocDataset::spinOnce()
         ++dataset_cur_idx_;
     }
 
+    // If this spin window ended between camera frames, do not sit on the
+    // partial IMU burst: deliver it now so sample latency stays bounded by
+    // the spin period:
+    flush_imu_batch();
+
     {
         auto lck             = mrpt::lockHelper(dataset_ui_mtx_);
         last_used_tim_index_ = std::distance(dataset_.begin(), dataset_next_);
@@ -333,7 +357,38 @@ void EurocDataset::spinOnce()
                     [&](std::monostate&) {
                         THROW_EXCEPTION("Un-initialized entry!");
                     },
-                    [&](SensorCamera& cam) { build_dataset_entry_obs(cam); },
+                    [&](SensorCamera& cam) {
+                        if (!imgDecodePool_)
+                        {
+                            build_dataset_entry_obs(cam);
+                            return;
+                        }
+
+                        // bounded queue: never pile up more decode jobs
+                        // than the look-ahead window itself. Skipped frames
+                        // are not lost: they fall back to the synchronous
+                        // decode in ensure_camera_decoded() at publish time.
+                        if (imgDecodePool_->pendingTasks() >= READ_AHEAD_COUNT)
+                            return;
+                        {
+                            auto lck = mrpt::lockHelper(decode_mtx_);
+                            if (cam.obs || decode_inflight_.count(&cam) != 0)
+                                return;
+                        }
+                        imgDecodePool_->enqueue(
+                            [this, pCam = &cam]()
+                            {
+                                try
+                                {
+                                    ensure_camera_decoded(*pCam);
+                                }
+                                catch (const std::exception& e)
+                                {
+                                    MRPT_LOG_ERROR_STREAM(
+                                        "[image decode] " << e.what());
+                                }
+                            });
+                    },
                     [&](SensorIMU& imu) { build_dataset_entry_obs(imu); }},
                 peeker->second);
         }
@@ -342,6 +397,48 @@ void EurocDataset::spinOnce()
     MRPT_END
 }
 
+void EurocDataset::flush_imu_batch()
+{
+    if (imu_pending_batch_.empty()) return;
+
+    this->sendObservationBatchToFrontEnds(imu_pending_batch_);
+    imu_pending_batch_.clear();
+}
+
+void EurocDataset::ensure_camera_decoded(SensorCamera& s)
+{
+    {
+        std::unique_lock<std::mutex> lck(decode_mtx_);
+
+        // if a worker is decoding this very image, wait for it instead of
+        // decompressing the file twice:
+        decode_cv_.wait(
+            lck, [this, &s]() { return decode_inflight_.count(&s) == 0; });
+
+        if (s.obs) return;  // already decoded
+        decode_inflight_.insert(&s);
+    }
+
+    // clears the in-flight mark and wakes up waiters at scope exit, even
+    // if the decode throws:
+    struct InflightGuard
+    {
+        EurocDataset&       parent;
+        const SensorCamera* entry;
+        ~InflightGuard()
+        {
+            {
+                auto lck = mrpt::lockHelper(parent.decode_mtx_);
+                parent.decode_inflight_.erase(entry);
+            }
+            parent.decode_cv_.notify_all();
+        }
+    };
+    const InflightGuard guard{*this, &s};
+
+    build_dataset_entry_obs(s);  // the heavy part, intentionally unlocked
+}
+
 void EurocDataset::build_dataset_entry_obs(SensorCamera& s)
 {
     if (s.obs) return;  // already done
@@ -20,6 +20,8 @@
 #include <mrpt/obs/obs_frwds.h>
 
 #include <array>
+#include <cstdint>
+#include <fstream>
 
 // fwrd decls:
 namespace mrpt::obs
@@ -209,6 +211,17 @@ class Kitti360Dataset : public RawDataSourceBase,
     bool                publish_lidar_{true};
     bool                generate_lidar_timestamps_{true};
     bool                publish_ground_truth_{true};
+
+    /** If enabled, the first playback writes each converted lidar
+     * observation, serialized and ready to send, into a cache file pair
+     * beside the velodyne data (`mola_obs_cache.bin` + `.idx`, with
+     * per-timestep offsets for O(1) random access); subsequent runs
+     * stream observations directly from it, skipping the .bin parsing,
+     * the vertical-angle correction and the per-point timestamp
+     * generation. The cache takes roughly as much disk as the velodyne
+     * data itself, hence it is off by default; enable it for e.g.
+     * parameter sweeps re-running the same sequence many times. */
+    bool observation_cache_{false};
     std::array<bool, 4> publish_image_{{true, true, true, true}};
     std::array<mrpt::img::TCamera, 4>   cam_intrinsics_;
     std::array<mrpt::poses::CPose3D, 4> cam_poses_;  //!< wrt vehicle origin
@@ -242,6 +255,29 @@ class Kitti360Dataset : public RawDataSourceBase,
     void load_lidar(timestep_t step) const;
 
     void autoUnloadOldEntries() const;
+
+    // On-disk preconverted lidar observation cache (observation_cache_):
+    struct CacheEntry
+    {
+        uint64_t offset = 0;
+        uint64_t length = 0;  //!< ==0: entry not cached yet
+    };
+
+    std::string                     cache_basedir_;
+    mutable std::vector<CacheEntry> cache_entries_;
+    mutable std::fstream            cache_data_f_, cache_idx_f_;
+    mutable bool                    cache_ok_ = false;
+
+    /// Opens (or creates) the cache file pair, validating the index
+    /// header against the dataset length and conversion settings.
+    void cache_open() const;
+
+    /// Returns the cached observation for the given step, or nullptr.
+    mrpt::obs::CObservation::Ptr cache_read(timestep_t step) const;
+
+    /// Appends a freshly-converted observation to the cache.
+    void cache_write(
+        timestep_t step, const mrpt::obs::CObservationPointCloud& obs) const;
 };
 
 }  // namespace mola
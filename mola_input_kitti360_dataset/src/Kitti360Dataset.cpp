@@ -21,6 +21,7 @@
 #include <mrpt/containers/yaml.h>
 #include <mrpt/core/initializer.h>
 #include <mrpt/core/round.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/io/CTextFileLinesParser.h>
 #include <mrpt/io/vector_loadsave.h>
 #include <mrpt/maps/CPointsMapXYZI.h>
@@ -29,10 +30,12 @@
 #include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/CObservationRobotPose.h>
 #include <mrpt/obs/CObservationRotatingScan.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/CDirectoryExplorer.h>
 #include <mrpt/system/filesystem.h>  //ASSERT_DIRECTORY_EXISTS_()
 
 #include <Eigen/Dense>
+#include <cstring>
 #include <regex>
 
 using namespace mola;
@@ -227,6 +230,7 @@ void Kitti360Dataset::initialize_rds(const Yaml& c)
     YAML_LOAD_MEMBER_OPT(publish_lidar, bool);
     YAML_LOAD_MEMBER_OPT(generate_lidar_timestamps, bool);
     YAML_LOAD_MEMBER_OPT(publish_ground_truth, bool);
+    YAML_LOAD_MEMBER_OPT(observation_cache, bool);
 
     for (unsigned int i = 0; i < 4; i++)
         publish_image_[i] = cfg.getOrDefault<bool>(
@@ -255,6 +259,9 @@ void Kitti360Dataset::initialize_rds(const Yaml& c)
                 ? "Found ("s + std::to_string(lst_velodyne_.size()) + ")"s
                 : "Not found"));
 
+    cache_basedir_ = lidar_dir;
+    if (observation_cache_ && !lst_velodyne_.empty()) cache_open();
+
     for (unsigned int i = 0; i < 4; i++)
     {
         lst_image_basedir_[i] =
@@ -600,6 +607,13 @@ void Kitti360Dataset::load_lidar(timestep_t step) const
     // Already loaded?
     if (read_ahead_lidar_obs_[step]) return;
 
+    // Served from the on-disk preconverted cache?
+    if (auto cached = cache_read(step); cached)
+    {
+        read_ahead_lidar_obs_[step] = std::move(cached);
+        return;
+    }
+
     ProfilerEntry tleg(profiler_, "load_lidar");
 
     // Load velodyne pointcloud:
@@ -684,6 +698,9 @@ void Kitti360Dataset::load_lidar(timestep_t step) const
         mrpt::format("kitti_%s_%06zu.txt", sequence_.c_str(), step));
 #endif
 
+    // First conversion of this timestep: add it to the cache, if enabled:
+    cache_write(step, *obs);
+
     mrpt::obs::CObservation::Ptr o;
 
     o = std::dynamic_pointer_cast<mrpt::obs::CObservation>(obs);
@@ -694,6 +711,189 @@ void Kitti360Dataset::load_lidar(timestep_t step) const
     MRPT_END
 }
 
+namespace
+{
+constexpr char   OBS_CACHE_MAGIC[8]  = {'M', 'O', 'L', 'A', 'O', 'C', 'H', '1'};
+constexpr size_t OBS_CACHE_HDR_BYTES = sizeof(OBS_CACHE_MAGIC) +
+                                       2 * sizeof(uint64_t);
+}  // namespace
+
+void Kitti360Dataset::cache_open() const
+{
+    MRPT_START
+
+    const auto filData =
+        mrpt::system::pathJoin({cache_basedir_, "mola_obs_cache.bin"});
+    const auto filIdx =
+        mrpt::system::pathJoin({cache_basedir_, "mola_obs_cache.idx"});
+
+    const uint64_t count = lst_velodyne_.size();
+
+    // config bits that change the converted observations; a mismatch
+    // invalidates the whole cache:
+    const uint64_t flags = (generate_lidar_timestamps_ ? 1 : 0) |
+                           (VERTICAL_ANGLE_OFFSET != 0 ? 2 : 0);
+
+    cache_entries_.assign(count, {});
+
+    bool validIdx = false;
+    if (mrpt::system::fileExists(filIdx))
+    {
+        std::ifstream f(filIdx, std::ios::binary);
+
+        char     magic[8] = {0};
+        uint64_t cnt = 0, flg = 0;
+        f.read(magic, sizeof(magic));
+        f.read(reinterpret_cast<char*>(&cnt), sizeof(cnt));
+        f.read(reinterpret_cast<char*>(&flg), sizeof(flg));
+
+        if (f.good() &&
+            0 == std::memcmp(magic, OBS_CACHE_MAGIC, sizeof(magic)) &&
+            cnt == count && flg == flags)
+        {
+            f.read(
+                reinterpret_cast<char*>(cache_entries_.data()),
+                sizeof(CacheEntry) * count);
+            validIdx = f.good();
+        }
+
+        if (!validIdx)
+        {
+            MRPT_LOG_WARN_STREAM(
+                "Ignoring stale/mismatched observation cache (will be "
+                "rebuilt): "
+                << filIdx);
+            cache_entries_.assign(count, {});
+        }
+    }
+
+    if (!validIdx)
+    {
+        // (re)create both files from scratch, with all entries empty:
+        std::ofstream fIdx(filIdx, std::ios::binary | std::ios::trunc);
+        if (!fIdx.is_open())
+        {
+            MRPT_LOG_WARN_STREAM(
+                "Cannot create observation cache (will run without it): "
+                << filIdx);
+            return;  // cache_ok_ stays false
+        }
+        fIdx.write(OBS_CACHE_MAGIC, sizeof(OBS_CACHE_MAGIC));
+        fIdx.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        fIdx.write(reinterpret_cast<const char*>(&flags), sizeof(flags));
+        fIdx.write(
+            reinterpret_cast<const char*>(cache_entries_.data()),
+            sizeof(CacheEntry) * count);
+        fIdx.close();
+
+        std::ofstream fData(filData, std::ios::binary | std::ios::trunc);
+    }
+
+    cache_idx_f_.open(
+        filIdx, std::ios::binary | std::ios::in | std::ios::out);
+    cache_data_f_.open(
+        filData, std::ios::binary | std::ios::in | std::ios::out);
+
+    cache_ok_ = cache_idx_f_.is_open() && cache_data_f_.is_open();
+
+    if (cache_ok_)
+    {
+        size_t nCached = 0;
+        for (const auto& e : cache_entries_)
+            if (e.length != 0) nCached++;
+
+        MRPT_LOG_INFO_STREAM(
+            "Observation cache enabled (" << nCached << " / " << count
+                                          << " entries): " << filData);
+    }
+
+    MRPT_END
+}
+
+mrpt::obs::CObservation::Ptr Kitti360Dataset::cache_read(
+    timestep_t step) const
+{
+    if (!cache_ok_ || step >= cache_entries_.size()) return {};
+
+    const auto& e = cache_entries_[step];
+    if (e.length == 0) return {};
+
+    ProfilerEntry tleg(profiler_, "cache_read");
+
+    std::vector<uint8_t> buf(e.length);
+    cache_data_f_.seekg(static_cast<std::streamoff>(e.offset));
+    cache_data_f_.read(
+        reinterpret_cast<char*>(buf.data()),
+        static_cast<std::streamsize>(e.length));
+
+    if (!cache_data_f_.good())
+    {
+        cache_data_f_.clear();
+        MRPT_LOG_ONCE_WARN(
+            "Error reading observation cache; falling back to raw files.");
+        return {};
+    }
+
+    mrpt::io::CMemoryStream mem;
+    mem.assignMemoryNotOwn(buf.data(), buf.size());
+
+    auto arch = mrpt::serialization::archiveFrom(mem);
+
+    mrpt::obs::CObservation::Ptr o;
+    arch >> o;
+    return o;
+}
+
+void Kitti360Dataset::cache_write(
+    timestep_t step, const mrpt::obs::CObservationPointCloud& obs) const
+{
+    if (!cache_ok_ || step >= cache_entries_.size()) return;
+
+    auto& e = cache_entries_[step];
+    if (e.length != 0) return;  // already cached
+
+    ProfilerEntry tleg(profiler_, "cache_write");
+
+    // The source observation is flagged as externally-stored (the raw
+    // kitti .bin file), which would serialize as just the file name;
+    // serialize a self-contained shallow copy instead:
+    auto selfContained         = mrpt::obs::CObservationPointCloud::Create();
+    selfContained->sensorLabel = obs.sensorLabel;
+    selfContained->sensorPose  = obs.sensorPose;
+    selfContained->timestamp   = obs.timestamp;
+    selfContained->pointcloud  = obs.pointcloud;
+
+    mrpt::io::CMemoryStream mem;
+    auto arch = mrpt::serialization::archiveFrom(mem);
+    arch << selfContained;
+
+    cache_data_f_.seekp(0, std::ios::end);
+    const auto offset = static_cast<uint64_t>(cache_data_f_.tellp());
+
+    cache_data_f_.write(
+        reinterpret_cast<const char*>(mem.getRawBufferData()),
+        static_cast<std::streamsize>(mem.getTotalBytesCount()));
+    cache_data_f_.flush();
+
+    if (!cache_data_f_.good())
+    {
+        cache_data_f_.clear();
+        MRPT_LOG_ONCE_WARN("Error writing observation cache; disabling it.");
+        cache_ok_ = false;
+        return;
+    }
+
+    e.offset = offset;
+    e.length = mem.getTotalBytesCount();
+
+    // update this entry slot in the index file in place, so that
+    // partially-built caches are reusable by the next run:
+    const auto idxPos = OBS_CACHE_HDR_BYTES + sizeof(CacheEntry) * step;
+    cache_idx_f_.seekp(static_cast<std::streamoff>(idxPos));
+    cache_idx_f_.write(reinterpret_cast<const char*>(&e), sizeof(e));
+    cache_idx_f_.flush();
+}
+
 mrpt::obs::CObservation::Ptr Kitti360Dataset::getPointCloud(
     timestep_t step) const
 {
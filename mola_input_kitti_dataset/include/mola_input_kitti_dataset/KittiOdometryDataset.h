@@ -15,11 +15,14 @@
 #include <mola_kernel/interfaces/OfflineDatasetSource.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
 #include <mrpt/core/Clock.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/img/TCamera.h>
 #include <mrpt/math/TPose3D.h>
 #include <mrpt/obs/obs_frwds.h>
 
 #include <array>
+#include <condition_variable>
+#include <set>
 
 // fwrd decls:
 namespace mrpt::obs
@@ -154,6 +157,11 @@ class KittiOdometryDataset : public RawDataSourceBase,
         auto lck       = mrpt::lockHelper(dataset_ui_mtx_);
         teleport_here_ = timestep;
     }
+    void datasetUI_preview_scrub(bool active) override
+    {
+        auto lck          = mrpt::lockHelper(dataset_ui_mtx_);
+        ui_preview_scrub_ = active;
+    }
 
     /** See:
      *  "IMLS-SLAM: scan-to-model matching based on 3D data", JE Deschaud, 2018.
@@ -198,12 +206,46 @@ class KittiOdometryDataset : public RawDataSourceBase,
     bool                  paused_              = false;
     double                time_warp_scale_     = 1.0;
     std::optional<size_t> teleport_here_;
+    bool                  ui_preview_scrub_ = false;
     mutable std::mutex    dataset_ui_mtx_;
 
     void load_img(const unsigned int cam_idx, const timestep_t step) const;
     void load_lidar(timestep_t step) const;
 
     void autoUnloadOldEntries() const;
+
+    /** How many timesteps ahead of the playback cursor the background
+     *  worker keeps decoded LiDAR scans in read_ahead_lidar_obs_
+     *  (option `lidar_read_ahead`; 0 = synchronous loading as before). */
+    unsigned int lidar_read_ahead_ = 5;
+
+    /** Guards read_ahead_lidar_obs_, read_ahead_image_obs_ and the two
+     *  *_decode_inflight_ sets; held only for map/set accesses, never
+     *  during a scan/image decode. */
+    mutable std::mutex              read_ahead_mtx_;
+    mutable std::condition_variable read_ahead_cv_;
+
+    /** Timesteps currently being decoded by the prefetch worker, so a
+     *  synchronous load_lidar() on the same step waits for it instead of
+     *  decoding the file twice. */
+    mutable std::set<timestep_t> lidar_decode_inflight_;
+
+    /** Idem, for load_img(): keys are `step * 4 + cam_idx`. */
+    mutable std::set<size_t> img_decode_inflight_;
+
+    /** Single worker overlapping velodyne .bin file I/O and point cloud
+     *  construction with downstream processing. Declared last so its dtor
+     *  joins before the members the queued tasks use are destroyed. */
+    mutable mrpt::WorkerThreadsPool lidarPrefetchPool_{
+        1 /*threads*/, mrpt::WorkerThreadsPool::POLICY_FIFO,
+        "KittiLidarPrefetch"};
+
+    /** One worker per camera channel, so the (up to 4) PNG decodes of one
+     *  timestep run concurrently instead of back-to-back on the spin
+     *  thread. Same dtor-ordering note as lidarPrefetchPool_. */
+    mutable mrpt::WorkerThreadsPool imgPrefetchPool_{
+        4 /*threads*/, mrpt::WorkerThreadsPool::POLICY_FIFO,
+        "KittiImgPrefetch"};
 };
 
 }  // namespace mola
@@ -108,6 +108,9 @@ void KittiOdometryDataset::initialize_rds(const Yaml& c)
 
     publish_lidar_ = cfg.getOrDefault<bool>("publish_lidar", publish_lidar_);
 
+    lidar_read_ahead_ =
+        cfg.getOrDefault<unsigned int>("lidar_read_ahead", lidar_read_ahead_);
+
     publish_ground_truth_ =
         cfg.getOrDefault<bool>("publish_ground_truth", publish_ground_truth_);
 
@@ -313,6 +316,7 @@ void KittiOdometryDataset::spinOnce()
     auto         lckUIVars       = mrpt::lockHelper(dataset_ui_mtx_);
     const double time_warp_scale = time_warp_scale_;
     const bool   paused          = paused_;
+    const bool   preview_scrub   = ui_preview_scrub_;
     const auto   teleport_here   = teleport_here_;
     teleport_here_.reset();
     lckUIVars.unlock();
@@ -326,12 +330,48 @@ void KittiOdometryDataset::spinOnce()
     {
         replay_next_tim_index_ = *teleport_here;
         last_dataset_time_     = lst_timestamps_[replay_next_tim_index_];
+
+        // Active slider scrubbing (see Dataset_UI::datasetUI_preview_scrub):
+        // publish only the cheap, already-in-memory ground-truth pose at
+        // the cursor, and defer the lidar/image decode to the final
+        // teleport, which arrives with the preview flag off:
+        if (preview_scrub)
+        {
+            if (publish_ground_truth_ &&
+                replay_next_tim_index_ < groundTruthTrajectory_.size())
+            {
+                auto it = groundTruthTrajectory_.begin();
+                std::advance(it, replay_next_tim_index_);
+
+                auto o         = mrpt::obs::CObservationRobotPose::Create();
+                o->sensorLabel = "ground_truth";
+                o->pose.mean   = mrpt::poses::CPose3D(it->second);
+                o->timestamp   = mrpt::Clock::fromDouble(
+                    lst_timestamps_[replay_next_tim_index_]);
+
+                this->sendObservationsToFrontEnds(o);
+            }
+
+            auto lck             = mrpt::lockHelper(dataset_ui_mtx_);
+            last_used_tim_index_ = replay_next_tim_index_;
+            return;
+        }
     }
     else
     {
         if (paused) return;
-        // move forward replayed dataset time:
-        last_dataset_time_ += dt;
+        if (virtual_time_ && replay_next_tim_index_ < lst_timestamps_.size())
+        {
+            // Deterministic replay: jump the logical clock straight to the
+            // next observation; pacing comes from the consumer drain
+            // barrier in advanceTo() below, not from the wall clock.
+            last_dataset_time_ = lst_timestamps_[replay_next_tim_index_];
+        }
+        else
+        {
+            // move forward replayed dataset time:
+            last_dataset_time_ += dt;
+        }
     }
 
     if (replay_next_tim_index_ >= lst_timestamps_.size())
@@ -369,17 +409,44 @@ void KittiOdometryDataset::spinOnce()
         {
             ProfilerEntry tle(profiler_, "spinOnce.publishLidar");
             load_lidar(replay_next_tim_index_);
-            auto o = read_ahead_lidar_obs_[replay_next_tim_index_];
+            mrpt::obs::CObservation::Ptr o;
+            {
+                auto lck = mrpt::lockHelper(read_ahead_mtx_);
+                o        = read_ahead_lidar_obs_[replay_next_tim_index_];
+            }
             // o->timestamp = obs_tim; // already done in load_lidar()
             this->sendObservationsToFrontEnds(o);
         }
 
+        // Decode all pending camera images of this step concurrently, one
+        // worker per camera, instead of back-to-back on this thread:
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            if (!publish_image_[i]) continue;
+            imgPrefetchPool_.enqueue(
+                [this, i, s = replay_next_tim_index_]()
+                {
+                    try
+                    {
+                        load_img(i, s);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        MRPT_LOG_ERROR_STREAM("[image prefetch] " << e.what());
+                    }
+                });
+        }
         for (unsigned int i = 0; i < 4; i++)
         {
             if (!publish_image_[i]) continue;
             ProfilerEntry tle(profiler_, "spinOnce.publishImage");
+            // no-op if a worker got it; waits if one is still decoding it:
             load_img(i, replay_next_tim_index_);
-            auto o = read_ahead_image_obs_[replay_next_tim_index_][i];
+            mrpt::obs::CObservation::Ptr o;
+            {
+                auto lck = mrpt::lockHelper(read_ahead_mtx_);
+                o        = read_ahead_image_obs_[replay_next_tim_index_][i];
+            }
             // o->timestamp = obs_tim; // already done in load_img()
             this->sendObservationsToFrontEnds(o);
         }
@@ -403,12 +470,19 @@ void KittiOdometryDataset::spinOnce()
         }
 
         // Free memory in read-ahead buffers:
-        read_ahead_lidar_obs_.erase(replay_next_tim_index_);
-        read_ahead_image_obs_.erase(replay_next_tim_index_);
+        {
+            auto lck = mrpt::lockHelper(read_ahead_mtx_);
+            read_ahead_lidar_obs_.erase(replay_next_tim_index_);
+            read_ahead_image_obs_.erase(replay_next_tim_index_);
+        }
 
         replay_next_tim_index_++;
     }
 
+    // Hand the logical clock forward once the observations above drain
+    // (see VirtualTimeService):
+    if (virtual_time_) virtual_time_->advanceTo(last_dataset_time_);
+
     {
         auto lck = mrpt::lockHelper(dataset_ui_mtx_);
         last_used_tim_index_ =
@@ -419,17 +493,83 @@ void KittiOdometryDataset::spinOnce()
     if (replay_next_tim_index_ < lst_timestamps_.size())
     {
         ProfilerEntry tle(profiler_, "spinOnce.read_ahead");
-        if (0 == read_ahead_image_obs_.count(replay_next_tim_index_))
+
+        bool imagesPending;
         {
+            auto lck = mrpt::lockHelper(read_ahead_mtx_);
+            imagesPending =
+                (0 == read_ahead_image_obs_.count(replay_next_tim_index_));
+        }
+        if (imagesPending)
+        {
+            // Enqueue the next step's camera decodes on the image workers,
+            // overlapping them with downstream processing:
             for (unsigned int i = 0; i < 4; i++)
             {
                 if (!publish_image_[i]) continue;
-                load_img(i, replay_next_tim_index_);
+                imgPrefetchPool_.enqueue(
+                    [this, i, s = replay_next_tim_index_]()
+                    {
+                        try
+                        {
+                            load_img(i, s);
+                        }
+                        catch (const std::exception& e)
+                        {
+                            MRPT_LOG_ERROR_STREAM(
+                                "[image prefetch] " << e.what());
+                        }
+                    });
             }
         }
-        if (0 == read_ahead_lidar_obs_.count(replay_next_tim_index_))
+        if (publish_lidar_)
         {
-            if (publish_lidar_) load_lidar(replay_next_tim_index_);
+            if (lidar_read_ahead_ == 0)
+            {
+                // synchronous one-step read-ahead (legacy behavior):
+                auto lck = mrpt::lockHelper(read_ahead_mtx_);
+                if (0 == read_ahead_lidar_obs_.count(replay_next_tim_index_))
+                {
+                    lck.unlock();
+                    load_lidar(replay_next_tim_index_);
+                }
+            }
+            else
+            {
+                // Keep the worker decoding the next scans ahead of the
+                // playback cursor, overlapping disk I/O and point cloud
+                // construction with downstream processing:
+                const auto lastStep = std::min<timestep_t>(
+                    replay_next_tim_index_ + lidar_read_ahead_,
+                    lst_timestamps_.size());
+
+                for (timestep_t s = replay_next_tim_index_; s < lastStep; s++)
+                {
+                    {
+                        auto lck = mrpt::lockHelper(read_ahead_mtx_);
+                        if (read_ahead_lidar_obs_.count(s) != 0 ||
+                            lidar_decode_inflight_.count(s) != 0)
+                            continue;
+                    }
+                    // bounded queue: never pile up more than the window:
+                    if (lidarPrefetchPool_.pendingTasks() >= lidar_read_ahead_)
+                        break;
+
+                    lidarPrefetchPool_.enqueue(
+                        [this, s]()
+                        {
+                            try
+                            {
+                                load_lidar(s);
+                            }
+                            catch (const std::exception& e)
+                            {
+                                MRPT_LOG_ERROR_STREAM(
+                                    "[lidar prefetch] " << e.what());
+                            }
+                        });
+                }
+            }
         }
     }
 
@@ -444,8 +584,35 @@ void KittiOdometryDataset::load_img(
     // unload() very old observations.
     autoUnloadOldEntries();
 
-    // Already loaded?
-    if (read_ahead_image_obs_[step][cam_idx]) return;
+    // Already loaded? If another worker is decoding this same (step, cam)
+    // right now, wait for it instead of decoding the file twice:
+    const size_t key = step * 4 + cam_idx;
+    {
+        std::unique_lock<std::mutex> lck(read_ahead_mtx_);
+        read_ahead_cv_.wait(
+            lck,
+            [this, key]() { return img_decode_inflight_.count(key) == 0; });
+
+        if (read_ahead_image_obs_[step][cam_idx]) return;
+        img_decode_inflight_.insert(key);
+    }
+
+    // clears the in-flight mark and wakes up waiters at scope exit, even
+    // if decoding throws:
+    struct InflightGuard
+    {
+        const KittiOdometryDataset& parent;
+        const size_t                key;
+        ~InflightGuard()
+        {
+            {
+                auto lck = mrpt::lockHelper(parent.read_ahead_mtx_);
+                parent.img_decode_inflight_.erase(key);
+            }
+            parent.read_ahead_cv_.notify_all();
+        }
+    };
+    const InflightGuard guard{*this, key};
 
     ProfilerEntry tleg(profiler_, "load_img");
 
@@ -469,7 +636,10 @@ void KittiOdometryDataset::load_img(
     obs->timestamp = mrpt::Clock::fromDouble(lst_timestamps_.at(step));
 
     auto o = mrpt::ptr_cast<mrpt::obs::CObservation>::from(obs);
-    read_ahead_image_obs_[step][cam_idx] = std::move(o);
+    {
+        auto lck = mrpt::lockHelper(read_ahead_mtx_);
+        read_ahead_image_obs_[step][cam_idx] = std::move(o);
+    }
 
     MRPT_END
 }
@@ -481,8 +651,34 @@ void KittiOdometryDataset::load_lidar(timestep_t step) const
     // unload() very old observations.
     autoUnloadOldEntries();
 
-    // Already loaded?
-    if (read_ahead_lidar_obs_[step]) return;
+    // Already loaded? If the prefetch worker is decoding this same step
+    // right now, wait for it instead of parsing the file twice:
+    {
+        std::unique_lock<std::mutex> lck(read_ahead_mtx_);
+        read_ahead_cv_.wait(
+            lck, [this, step]()
+            { return lidar_decode_inflight_.count(step) == 0; });
+
+        if (read_ahead_lidar_obs_[step]) return;
+        lidar_decode_inflight_.insert(step);
+    }
+
+    // clears the in-flight mark and wakes up waiters at scope exit, even
+    // if decoding throws:
+    struct InflightGuard
+    {
+        const KittiOdometryDataset& parent;
+        const timestep_t            step;
+        ~InflightGuard()
+        {
+            {
+                auto lck = mrpt::lockHelper(parent.read_ahead_mtx_);
+                parent.lidar_decode_inflight_.erase(step);
+            }
+            parent.read_ahead_cv_.notify_all();
+        }
+    };
+    const InflightGuard guard{*this, step};
 
     ProfilerEntry tleg(profiler_, "load_lidar");
 
@@ -619,7 +815,10 @@ void KittiOdometryDataset::load_lidar(timestep_t step) const
     }
 
     // Store in the output queue:
-    read_ahead_lidar_obs_[step] = std::move(o);
+    {
+        auto lck                    = mrpt::lockHelper(read_ahead_mtx_);
+        read_ahead_lidar_obs_[step] = std::move(o);
+    }
 
     MRPT_END
 }
@@ -631,7 +830,8 @@ mrpt::obs::CObservation::Ptr KittiOdometryDataset::getPointCloud(
     ASSERT_LT_(step, lst_timestamps_.size());
 
     load_lidar(step);
-    auto o = read_ahead_lidar_obs_.at(step);
+    auto lck = mrpt::lockHelper(read_ahead_mtx_);
+    auto o   = read_ahead_lidar_obs_.at(step);
     return o;
 }
 
@@ -642,7 +842,8 @@ std::shared_ptr<mrpt::obs::CObservationImage> KittiOdometryDataset::getImage(
     ASSERT_LT_(step, lst_timestamps_.size());
 
     load_img(cam_idx, step);
-    auto o = std::dynamic_pointer_cast<mrpt::obs::CObservationImage>(
+    auto lck = mrpt::lockHelper(read_ahead_mtx_);
+    auto o   = std::dynamic_pointer_cast<mrpt::obs::CObservationImage>(
         read_ahead_image_obs_.at(step).at(cam_idx));
     ASSERT_(o);
     return o;
@@ -679,6 +880,8 @@ constexpr size_t MAX_UNLOAD_LEN = 250;
 
 void KittiOdometryDataset::autoUnloadOldEntries() const
 {
+    auto lck = mrpt::lockHelper(read_ahead_mtx_);
+
     while (read_ahead_lidar_obs_.size() > MAX_UNLOAD_LEN)
         read_ahead_lidar_obs_.erase(read_ahead_lidar_obs_.begin());
 
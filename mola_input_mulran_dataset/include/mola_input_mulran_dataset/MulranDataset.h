@@ -23,6 +23,8 @@
 #include <mrpt/obs/obs_frwds.h>
 
 #include <array>
+#include <utility>
+#include <vector>
 
 // fwrd decls:
 namespace mrpt::obs
@@ -160,6 +162,11 @@ class MulranDataset : public RawDataSourceBase,
     bool        publish_gps_{true};
     bool        publish_ground_truth_{true};
 
+    /** If non-empty, decoded XYZIRT scans are serialized into this
+     *  directory (one ".obs.gz" file per scan), so subsequent playback
+     *  runs skip the binary scan parsing entirely. */
+    std::string decoded_scans_cache_dir_;
+
     std::optional<mrpt::Clock::time_point> last_play_wallclock_time_;
     double                                 last_dataset_time_ = 0;
 
@@ -181,12 +188,24 @@ class MulranDataset : public RawDataSourceBase,
         timestep_t gtIdx    = 0;  // idx in groundTruthTrajectory_
     };
 
-    std::multimap<double, Entry>           datasetEntries_;
-    std::multimap<double, Entry>::iterator replay_next_it_;
+    /** Precomputed synchronization index: all sensor events of the
+     * sequence merged into one schedule, time-sorted once at the end of
+     * initialize_rds(). Playback then advances a plain index cursor, so
+     * emitting the next observation, reporting progress and teleporting
+     * are all O(1) (vs. walking multimap iterators per spin). */
+    std::vector<std::pair<double, Entry>> datasetEntries_;
+    size_t                                replay_next_idx_ = 0;
 
     std::vector<std::string> lstPointCloudFiles_;
 
     trajectory_t groundTruthTrajectory_;
+
+    /** Flat copy of groundTruthTrajectory_ in time order, so replaying a
+     * GroundTruth entry is a direct lookup by Entry::gtIdx instead of
+     * advancing a map iterator. */
+    std::vector<std::pair<mrpt::Clock::time_point, mrpt::math::TPose3D>>
+        groundTruthOrdered_;
+
     mutable std::map<timestep_t, mrpt::obs::CObservationPointCloud::Ptr>
         read_ahead_lidar_obs_;
 
@@ -27,10 +27,15 @@
 #include <mrpt/obs/CObservationRobotPose.h>
 #include <mrpt/obs/CObservationRotatingScan.h>
 #include <mrpt/obs/gnss_messages_ascii_nmea.h>
+#include <mrpt/io/CFileGZInputStream.h>
+#include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/CDirectoryExplorer.h>
 #include <mrpt/system/filesystem.h>  //ASSERT_DIRECTORY_EXISTS_()
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <fstream>
 
 using namespace mola;
 
@@ -97,6 +102,14 @@ void MulranDataset::initialize_rds(const Yaml& c)
     YAML_LOAD_MEMBER_OPT(publish_gps, bool);
     YAML_LOAD_MEMBER_OPT(publish_ground_truth, bool);
 
+    YAML_LOAD_MEMBER_OPT(decoded_scans_cache_dir, std::string);
+    if (!decoded_scans_cache_dir_.empty() &&
+        !mrpt::system::directoryExists(decoded_scans_cache_dir_))
+    {
+        mrpt::system::createDirectory(decoded_scans_cache_dir_);
+        ASSERT_DIRECTORY_EXISTS_(decoded_scans_cache_dir_);
+    }
+
     // Make list of all existing files and preload everything we may need later
     // to quickly replay the dataset in realtime:
     MRPT_LOG_INFO_STREAM("Loading dataset from: " << seq_dir_);
@@ -154,7 +167,7 @@ void MulranDataset::initialize_rds(const Yaml& c)
             const double t     = 1e-9 * gpsCsvData_(row, 0);
             Entry        entry = {EntryType::GNSS};
             entry.gpsIdx       = row;
-            datasetEntries_.emplace(t, entry);
+            datasetEntries_.emplace_back(t, entry);
         }
     }
     else
@@ -221,10 +234,11 @@ void MulranDataset::initialize_rds(const Yaml& c)
                 }
 
                 groundTruthTrajectory_.insert(ts, p);
+                groundTruthOrdered_.emplace_back(ts, p.asTPose());
 
                 Entry entry = {EntryType::GroundTruth};
                 entry.gtIdx = groundTruthTrajectory_.size() - 1;
-                datasetEntries_.emplace(t, entry);
+                datasetEntries_.emplace_back(t, entry);
             }
 
             // remove in reverse order!
@@ -255,11 +269,20 @@ void MulranDataset::initialize_rds(const Yaml& c)
         // nanoseconds -> seconds
         const double t     = LidarFileNameToTimestamp(lstPointCloudFiles_[i]);
         const Entry  entry = {EntryType::Lidar, i};
-        datasetEntries_.emplace(t, entry);
+        datasetEntries_.emplace_back(t, entry);
     }
 
-    replay_next_it_ = datasetEntries_.begin();
-    initialized_    = true;
+    // Build the precomputed synchronization index: merge all the
+    // per-sensor streams above into one time-sorted schedule, so playback
+    // just advances an integer cursor instead of searching timestamps.
+    // stable_sort: entries sharing a timestamp (GT matched 1-to-1 to a
+    // lidar scan) keep their insertion order, i.e. GT before lidar.
+    std::stable_sort(
+        datasetEntries_.begin(), datasetEntries_.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    replay_next_idx_ = 0;
+    initialized_     = true;
 
     MRPT_END
 }  // end initialize()
@@ -289,16 +312,13 @@ void MulranDataset::spinOnce()
                 time_warp_scale;
     last_play_wallclock_time_ = tNow;
 
-    const double t0 = datasetEntries_.begin()->first;
+    const double t0 = datasetEntries_.front().first;
 
     // override by an special teleport order?
     if (teleport_here.has_value() && *teleport_here < datasetEntries_.size())
     {
-        auto it = datasetEntries_.begin();
-        std::advance(it, *teleport_here);
-
-        replay_next_it_    = it;
-        last_dataset_time_ = it->first - t0;
+        replay_next_idx_   = *teleport_here;
+        last_dataset_time_ = datasetEntries_[replay_next_idx_].first - t0;
     }
     else
     {
@@ -307,7 +327,7 @@ void MulranDataset::spinOnce()
         last_dataset_time_ += dt;
     }
 
-    if (replay_next_it_ == datasetEntries_.end())
+    if (replay_next_idx_ >= datasetEntries_.size())
     {
         onDatasetPlaybackEnds();  // notify base class
 
@@ -318,8 +338,7 @@ void MulranDataset::spinOnce()
     }
     else if (!datasetEntries_.empty())
     {
-        const auto pos =
-            std::distance(datasetEntries_.begin(), replay_next_it_);
+        const auto pos = replay_next_idx_;
 
         MRPT_LOG_THROTTLE_INFO_FMT(
             5.0, "Dataset replay progress: %lu / %lu  (%4.02f%%)",
@@ -331,14 +350,14 @@ void MulranDataset::spinOnce()
     std::optional<timestep_t> lastUsedLidarIdx;
 
     // We have to publish all observations until "t":
-    while (replay_next_it_ != datasetEntries_.end() &&
-           last_dataset_time_ >= (replay_next_it_->first - t0))
+    while (replay_next_idx_ < datasetEntries_.size() &&
+           last_dataset_time_ >= (datasetEntries_[replay_next_idx_].first - t0))
     {
         MRPT_LOG_DEBUG_STREAM(
             "Sending observations for replay time: "
             << mrpt::system::formatTimeInterval(last_dataset_time_));
 
-        const auto& de = replay_next_it_->second;
+        const auto& de = datasetEntries_[replay_next_idx_].second;
 
         switch (de.type)
         {
@@ -372,16 +391,16 @@ void MulranDataset::spinOnce()
                 if (!publish_ground_truth_) break;
 
                 // Get GT pose: it's already stored and correctly transformed
-                // into groundTruthTrajectory_:
-                auto it = groundTruthTrajectory_.begin();
-                std::advance(it, de.gtIdx);
+                // into groundTruthOrdered_:
+                const auto& [gtTim, gtPose] =
+                    groundTruthOrdered_.at(de.gtIdx);
 
                 // Publish as robot pose observation:
                 auto o         = mrpt::obs::CObservationRobotPose::Create();
                 o->sensorLabel = "ground_truth";
-                o->pose.mean   = mrpt::poses::CPose3D(it->second);
+                o->pose.mean   = mrpt::poses::CPose3D(gtPose);
                 // o->pose.cov? don't use
-                o->timestamp = it->first;
+                o->timestamp = gtTim;
 
                 this->sendObservationsToFrontEnds(o);
             }
@@ -392,13 +411,12 @@ void MulranDataset::spinOnce()
         };
 
         // move on:
-        replay_next_it_++;
+        replay_next_idx_++;
     }
 
     {
-        auto lck = mrpt::lockHelper(dataset_ui_mtx_);
-        last_used_tim_index_ =
-            std::distance(datasetEntries_.begin(), replay_next_it_);
+        auto lck             = mrpt::lockHelper(dataset_ui_mtx_);
+        last_used_tim_index_ = replay_next_idx_;
     }
 
     // Read ahead to save delays in the next iteration:
@@ -429,7 +447,41 @@ void MulranDataset::load_lidar(timestep_t step) const
 
     ProfilerEntry tleg(profiler_, "load_lidar");
 
-    // Load velodyne pointcloud:
+    // Pre-converted scan cached on disk from a former run?
+    std::string cacheFil;
+    if (!decoded_scans_cache_dir_.empty())
+    {
+        cacheFil = mrpt::system::pathJoin(
+            {decoded_scans_cache_dir_,
+             mrpt::system::extractFileName(lstPointCloudFiles_[step]) +
+                 std::string(".obs.gz")});
+
+        if (mrpt::system::fileExists(cacheFil))
+        {
+            try
+            {
+                mrpt::io::CFileGZInputStream fc(cacheFil);
+                auto arch = mrpt::serialization::archiveFrom(fc);
+
+                auto o = mrpt::ptr_cast<mrpt::obs::CObservationPointCloud>::
+                    from(arch.ReadObject());
+                ASSERT_(o);
+
+                read_ahead_lidar_obs_[step] = std::move(o);
+                return;
+            }
+            catch (const std::exception& e)
+            {
+                MRPT_LOG_WARN_STREAM(
+                    "Ignoring corrupt cached scan (will re-convert): "
+                    << cacheFil << "\n"
+                    << e.what());
+            }
+        }
+    }
+
+    // Load Ouster pointcloud (kitti-like binary format: interleaved
+    // x,y,z,intensity float32 records):
     const auto f =
         mrpt::system::pathJoin({seq_dir_, "Ouster", lstPointCloudFiles_[step]});
 
@@ -439,30 +491,50 @@ void MulranDataset::load_lidar(timestep_t step) const
     auto pts        = mrpt::maps::CPointsMapXYZIRT::Create();
     obs->pointcloud = pts;
 
-    // Load XYZI from kitti-like file:
-    mrpt::maps::CPointsMapXYZI kittiData;
-
-    bool loadOk = kittiData.loadFromKittiVelodyneFile(f);
+    std::ifstream fi(f, std::ios::binary | std::ios::ate);
     ASSERTMSG_(
-        loadOk, mrpt::format("Error loading kitti scan file: '%s'", f.c_str()));
+        fi.is_open(),
+        mrpt::format("Error opening kitti scan file: '%s'", f.c_str()));
+
+    constexpr size_t BYTES_PER_POINT = 4 * sizeof(float);
 
-    // Copy XYZI:
-    *pts = kittiData;
+    const auto fileBytes = static_cast<size_t>(fi.tellg());
+    fi.seekg(0);
+    ASSERT_EQUAL_(fileBytes % BYTES_PER_POINT, 0U);
 
-    const size_t nPts = pts->size();
+    const size_t nPts = fileBytes / BYTES_PER_POINT;
     ASSERT_EQUAL_(nPts, 1024 * 64);
+
+    // One bulk read of the raw interleaved records:
+    std::vector<float> raw(4 * nPts);
+    fi.read(reinterpret_cast<char*>(raw.data()), fileBytes);
+    ASSERTMSG_(
+        fi.good(),
+        mrpt::format("Error loading kitti scan file: '%s'", f.c_str()));
+
+    // Allocate the destination buffers once at the known ring x column
+    // geometry, then write decoded points straight into them: no
+    // intermediate XYZI map, no extra copy pass, no per-point push_back:
     pts->resize_XYZIRT(nPts, true /*i*/, true /*R*/, true /*t*/);
 
+    auto& Is = *pts->getPointsBufferRef_intensity();
+    auto& Rs = *pts->getPointsBufferRef_ring();
+    auto& Ts = *pts->getPointsBufferRef_timestamp();
+
     // Fixed to 10 Hz rotation in this dataset:
     const double sweepDuration = 0.1;  //  [s]
     const double At            = -0.5 * sweepDuration;
 
     for (size_t i = 0; i < nPts; i++)
     {
+        const float* p = &raw[4 * i];
+        pts->setPointFast(i, p[0], p[1], p[2]);
+        Is[i] = p[3];
+
         const int row = i % 64;
         const int col = i / 64;
-        pts->setPointTime(i, At + sweepDuration * col / 1024.0);
-        pts->setPointRing(i, row);
+        Ts[i]         = At + sweepDuration * col / 1024.0;
+        Rs[i]         = row;
     }
 
     // Pose:
@@ -527,6 +599,23 @@ void MulranDataset::load_lidar(timestep_t step) const
     }
 #endif
 
+    // Save to the on-disk cache for subsequent runs:
+    if (!cacheFil.empty())
+    {
+        try
+        {
+            mrpt::io::CFileGZOutputStream fo(cacheFil);
+            auto arch = mrpt::serialization::archiveFrom(fo);
+            arch << *obs;
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_WARN_STREAM(
+                "Cannot write cached scan: " << cacheFil << "\n"
+                                             << e.what());
+        }
+    }
+
     // Store in the output queue:
     read_ahead_lidar_obs_[step] = std::move(obs);
 
@@ -539,12 +628,11 @@ mrpt::obs::CObservationPointCloud::Ptr MulranDataset::getPointCloud(
     ASSERT_(initialized_);
     ASSERT_LT_(step, datasetEntries_.size());
 
-    auto it = datasetEntries_.begin();
-    std::advance(it, step);
+    const auto& e = datasetEntries_[step].second;
 
-    if (it->second.type != EntryType::Lidar) return {};
+    if (e.type != EntryType::Lidar) return {};
 
-    auto lidarIdx = it->second.lidarIdx;
+    auto lidarIdx = e.lidarIdx;
 
     load_lidar(lidarIdx);
     return read_ahead_lidar_obs_.at(lidarIdx);
@@ -555,12 +643,11 @@ mrpt::obs::CObservationGPS::Ptr MulranDataset::getGPS(timestep_t step) const
     ASSERT_(initialized_);
     ASSERT_LT_(step, datasetEntries_.size());
 
-    auto it = datasetEntries_.begin();
-    std::advance(it, step);
+    const auto& e = datasetEntries_[step].second;
 
-    if (it->second.type != EntryType::GNSS) return {};
+    if (e.type != EntryType::GNSS) return {};
 
-    return get_gps_by_row_index(it->second.gpsIdx);
+    return get_gps_by_row_index(e.gpsIdx);
 }
 
 mrpt::obs::CObservationGPS::Ptr MulranDataset::get_gps_by_row_index(
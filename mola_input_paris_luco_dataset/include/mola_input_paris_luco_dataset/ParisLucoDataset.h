@@ -11,6 +11,7 @@
  */
 #pragma once
 
+#include <mola_kernel/DatasetPrefetcher.h>
 #include <mola_kernel/interfaces/Dataset_UI.h>
 #include <mola_kernel/interfaces/OfflineDatasetSource.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
@@ -20,6 +21,7 @@
 #include <mrpt/obs/obs_frwds.h>
 
 #include <array>
+#include <atomic>
 
 // fwrd decls:
 namespace mrpt::obs
@@ -120,8 +122,13 @@ class ParisLucoDataset : public RawDataSourceBase,
     }
     void datasetUI_teleport(size_t timestep) override
     {
-        auto lck       = mrpt::lockHelper(dataset_ui_mtx_);
-        teleport_here_ = timestep;
+        {
+            auto lck       = mrpt::lockHelper(dataset_ui_mtx_);
+            teleport_here_ = timestep;
+        }
+        // start warming up the cache around the new cursor right away:
+        if (lidarPrefetcher_.initialized())
+            lidarPrefetcher_.prefetch_from(timestep);
     }
 
    protected:
@@ -142,16 +149,23 @@ class ParisLucoDataset : public RawDataSourceBase,
     std::vector<std::string>  lstLidarFiles_;
     mrpt::math::CMatrixDouble groundTruthTranslations_;
     trajectory_t              groundTruthTrajectory_;
-    mutable std::map<timestep_t, mrpt::obs::CObservation::Ptr>
-        read_ahead_lidar_obs_;
+
+    /// Shared read-ahead/caching engine; its decode functor is
+    /// decode_lidar(), which only reads immutable members:
+    mutable DatasetPrefetcher lidarPrefetcher_;
 
     std::vector<double> lst_timestamps_;
     double              replay_time_{.0};
     std::string         seq_dir_;
 
-    void load_lidar(timestep_t step) const;
-    void readAheadSome();
-    void autoUnloadOldEntries() const;
+    mrpt::obs::CObservation::Ptr decode_lidar(timestep_t step) const;
+
+    /** Point count of the last decoded scan: the HDL-32 geometry is
+     * constant across the sequence, so the cloud of each new frame is
+     * pre-sized to this before parsing, filling its buffers in one pass
+     * with no intermediate re-growth (atomic: decode_lidar() may run
+     * concurrently in prefetch workers). */
+    mutable std::atomic<size_t> lastScanPoints_{0};
 
     mutable timestep_t    last_used_tim_index_ = 0;
     bool                  paused_              = false;
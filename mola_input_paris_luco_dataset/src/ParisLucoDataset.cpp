@@ -124,7 +124,19 @@ void ParisLucoDataset::initialize_rds(const Yaml& c)
             "Ground truth translations: not found. Expected file: " << gtFile);
     }
 
-    readAheadSome();
+    // Read-ahead/caching engine: overlaps .ply parsing and ring-id
+    // reconstruction with downstream processing:
+    {
+        DatasetPrefetcher::Parameters p;
+        p.look_ahead = cfg.getOrDefault<unsigned int>(
+            "read_ahead_length", p.look_ahead);
+
+        lidarPrefetcher_.initialize(
+            [this](size_t step) { return decode_lidar(step); },
+            lstLidarFiles_.size(), p);
+
+        lidarPrefetcher_.prefetch_from(0);
+    }
 
     initialized_ = true;
 
@@ -201,9 +213,8 @@ void ParisLucoDataset::spinOnce()
 
         {
             ProfilerEntry tle(profiler_, "spinOnce.publishLidar");
-            load_lidar(replay_next_tim_index_);
-            auto o = read_ahead_lidar_obs_[replay_next_tim_index_];
-            // o->timestamp = obs_tim; // already done in load_lidar()
+            auto o = lidarPrefetcher_.get(replay_next_tim_index_);
+            // o->timestamp = obs_tim; // already done in decode_lidar()
             this->sendObservationsToFrontEnds(o);
         }
 
@@ -224,9 +235,6 @@ void ParisLucoDataset::spinOnce()
             this->sendObservationsToFrontEnds(o);
         }
 
-        // Free memory in read-ahead buffers:
-        read_ahead_lidar_obs_.erase(replay_next_tim_index_);
-
         replay_next_tim_index_++;
     }
 
@@ -236,22 +244,17 @@ void ParisLucoDataset::spinOnce()
     }
 
     // Read ahead to save delays in the next iteration:
-    readAheadSome();
+    lidarPrefetcher_.prefetch_from(replay_next_tim_index_);
 
     MRPT_END
 }
 
-void ParisLucoDataset::load_lidar(timestep_t step) const
+mrpt::obs::CObservation::Ptr ParisLucoDataset::decode_lidar(
+    timestep_t step) const
 {
     MRPT_START
 
-    // unload() very old observations.
-    autoUnloadOldEntries();
-
-    // Already loaded?
-    if (read_ahead_lidar_obs_[step]) return;
-
-    ProfilerEntry tleg(profiler_, "load_lidar");
+    ProfilerEntry tleg(profiler_, "decode_lidar");
 
     // Load velodyne pointcloud:
     const auto f =
@@ -259,6 +262,14 @@ void ParisLucoDataset::load_lidar(timestep_t step) const
 
     auto pts = mrpt::maps::CPointsMapXYZIRT::Create();
 
+    // The sensor geometry is constant across the sequence: pre-size the
+    // cloud to the previous frame's point count so the PLY parser fills
+    // its buffers in one pass, with no intermediate re-growth. (Each
+    // observation still owns its own cloud: front-ends keep shared
+    // references to it as an immutable object.)
+    if (const size_t nPrev = lastScanPoints_.load(); nPrev > 0)
+        pts->reserve_XYZIRT(nPrev, true /*I*/, true /*R*/, true /*T*/);
+
     bool ok = pts->loadFromPlyFile(f);
     if (!ok)
         THROW_EXCEPTION_FMT(
@@ -279,13 +290,12 @@ void ParisLucoDataset::load_lidar(timestep_t step) const
     });
 
     // Fix missing RING_ID: ParisLuco does not have a RING_ID field,
-    // but we can generate it from the timestamps + pitch angle:
+    // but we can generate it from the pitch angle, assigned point by
+    // point in a single pass (no intermediate per-ring containers):
     ASSERT_(pts->hasRingField());
     ASSERT_EQUAL_(
         pts->getPointsBufferRef_ring()->size(),
         pts->getPointsBufferRef_timestamp()->size());
-    std::map<int /*ring*/, std::map<float /*time*/, size_t /*index*/>>
-        histogram;
 
     // Equivalent matlab code:
     // depth = sqrt(D(:,1).^2 + D(:,2).^2);  % (x,y) only
@@ -300,6 +310,8 @@ void ParisLucoDataset::load_lidar(timestep_t step) const
     const float fov_down = mrpt::DEG2RAD(36.374f);
     const float fov      = mrpt::DEG2RAD(10.860f) + fov_down;
 
+    auto& Rs = *pts->getPointsBufferRef_ring();
+
     for (size_t i = 0; i < nPts; i++)
     {
         const float depth = sqrt(mrpt::square(xs[i]) + mrpt::square(ys[i]));
@@ -309,13 +321,10 @@ void ParisLucoDataset::load_lidar(timestep_t step) const
         int iP = mrpt::round(31 * (pitch + fov_down) / fov);
         mrpt::saturate(iP, 0, 31);
 
-        auto& vec     = histogram[iP];
-        vec[(*Ts)[i]] = i;
+        Rs[i] = iP;
     }
 
-    auto& Rs = *pts->getPointsBufferRef_ring();
-    for (const auto& [ringId, vec] : histogram)
-        for (const auto& [time, idx] : vec) Rs[idx] = ringId;
+    lastScanPoints_.store(nPts);
 
     // Lidar is at the origin of the vehicle frame:
     obs->sensorPose = mrpt::poses::CPose3D();
@@ -326,22 +335,11 @@ void ParisLucoDataset::load_lidar(timestep_t step) const
         mrpt::format("paris_%s_%06zu.txt", sequence_.c_str(), step));
 #endif
 
-    mrpt::obs::CObservation::Ptr o;
-    o = std::dynamic_pointer_cast<mrpt::obs::CObservation>(obs);
-    read_ahead_lidar_obs_[step] = std::move(o);
+    return std::dynamic_pointer_cast<mrpt::obs::CObservation>(obs);
 
     MRPT_END
 }
 
-void ParisLucoDataset::readAheadSome()
-{
-    if (replay_next_tim_index_ >= lstLidarFiles_.size()) return;
-
-    ProfilerEntry tle(profiler_, "spinOnce.read_ahead");
-    if (0 == read_ahead_lidar_obs_.count(replay_next_tim_index_))
-        load_lidar(replay_next_tim_index_);
-}
-
 size_t ParisLucoDataset::datasetSize() const
 {
     ASSERT_(initialized_);
@@ -359,18 +357,9 @@ mrpt::obs::CSensoryFrame::Ptr ParisLucoDataset::datasetGetObservations(
         last_used_tim_index_ = timestep;
     }
 
-    load_lidar(timestep);
-    auto o = read_ahead_lidar_obs_.at(timestep);
+    auto o = lidarPrefetcher_.get(timestep);
 
     auto sf = mrpt::obs::CSensoryFrame::Create();
     sf->insert(o);
     return sf;
 }
-
-constexpr size_t MAX_UNLOAD_LEN = 250;
-
-void ParisLucoDataset::autoUnloadOldEntries() const
-{
-    while (read_ahead_lidar_obs_.size() > MAX_UNLOAD_LEN)
-        read_ahead_lidar_obs_.erase(read_ahead_lidar_obs_.begin());
-}
@@ -14,13 +14,31 @@
 #include <mola_kernel/interfaces/Dataset_UI.h>
 #include <mola_kernel/interfaces/OfflineDatasetSource.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/obs/CRawlog.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <condition_variable>
+#include <memory>
+#include <set>
+
 namespace mola
 {
 /** RawDataSource for datasets in MRPT rawlog format
+ *
+ * The option `only_sensor_labels` (comma-separated list; empty=all) limits
+ * playback to the given sensor labels: other observations are dropped as
+ * they are read and their delayed-load payloads (e.g. externally-stored
+ * camera images) are never materialized, so front-ends interested in, say,
+ * LiDAR only do not pay for decoding images nobody consumes.
+ *
+ * For rawlogs with externally-stored payloads (mrpt delayed-load images
+ * and point clouds), a small I/O pool (option `lazy_load_prefetch_threads`;
+ * 0 = synchronous loading at publish time) resolves the external-file
+ * references of the observations in the read-ahead window before they are
+ * published, so the per-image file open/decode overlaps playback instead
+ * of stalling it — which matters on network file systems.
  *
  * \ingroup mola_input_rawlog_grp */
 class RawlogDataset : public RawDataSourceBase,
@@ -93,6 +111,15 @@ class RawlogDataset : public RawDataSourceBase,
     mrpt::Clock::time_point rawlog_begin_time_{INVALID_TIMESTAMP};
     bool                    read_all_first_ = true;
 
+    /** See `only_sensor_labels` in the class doc. Empty = publish all. */
+    std::set<std::string> only_sensor_labels_;
+
+    bool accept_label(const std::string& label) const
+    {
+        return only_sensor_labels_.empty() ||
+               only_sensor_labels_.count(label) != 0;
+    }
+
     std::optional<mrpt::Clock::time_point> last_play_wallclock_time_;
     double                                 last_dataset_time_ = 0;
 
@@ -113,6 +140,34 @@ class RawlogDataset : public RawDataSourceBase,
     double                time_warp_scale_     = 1.0;
     std::optional<size_t> teleport_here_;
     mutable std::mutex    dataset_ui_mtx_;
+
+    /** See `lazy_load_prefetch_threads` in the class doc. Only effective
+     * for rawlogs with an external files directory. */
+    unsigned int lazy_load_prefetch_threads_ = 2;
+
+    /** Hands the not-yet-queued read-ahead entries to the I/O pool, which
+     * load()s their delayed-load payloads in the background. */
+    void enqueuePrefetchJobs();
+
+    /** Blocks until any in-flight prefetch of `obs` finishes, then
+     * load()s it (a no-op if a worker already brought the payload in).
+     * Called right before publishing the observation. */
+    void ensurePayloadLoaded(const mrpt::obs::CObservation::Ptr& obs);
+
+    /** Guards prefetch_inflight_; held only for bookkeeping, never while
+     * a payload is being read from disk. */
+    std::mutex                               prefetch_mtx_;
+    std::condition_variable                  prefetch_cv_;
+    std::set<const mrpt::obs::CObservation*> prefetch_inflight_;
+
+    /** Entries already handed to the pool (module thread only), so each
+     * observation is enqueued at most once while in the window. */
+    std::set<const mrpt::obs::CObservation*> prefetch_queued_;
+
+    /** Workers load()ing the delayed-load payloads of upcoming
+     *  observations concurrently. Declared last so its destructor joins
+     *  them before the queues their tasks use are destroyed. */
+    std::unique_ptr<mrpt::WorkerThreadsPool> lazyLoadPool_;
 };
 
 }  // namespace mola
@@ -23,6 +23,7 @@
 #include <mrpt/obs/CActionCollection.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/system/filesystem.h>
+#include <mrpt/system/string_utils.h>
 
 using namespace mola;
 
@@ -53,8 +54,23 @@ void RawlogDataset::initialize_rds(const Yaml& c)
     YAML_LOAD_MEMBER_OPT(read_all_first, bool);
     paused_ = cfg.getOrDefault<bool>("start_paused", paused_);
 
+    if (cfg.has("only_sensor_labels"))
+    {
+        std::vector<std::string> lst;
+        mrpt::system::tokenize(
+            cfg["only_sensor_labels"].as<std::string>(), " ,", lst);
+        only_sensor_labels_.insert(lst.begin(), lst.end());
+        ASSERT_(!only_sensor_labels_.empty());
+
+        MRPT_LOG_INFO_STREAM(
+            "Limiting playback to " << only_sensor_labels_.size()
+                                    << " sensor label(s).");
+    }
+
     ASSERT_FILE_EXISTS_(rawlog_filename_);
 
+    YAML_LOAD_MEMBER_OPT(lazy_load_prefetch_threads, unsigned int);
+
     // Detect the external files directory, if used:
     const auto imgsDir =
         mrpt::obs::CRawlog::detectImagesDirectory(rawlog_filename_);
@@ -63,6 +79,15 @@ void RawlogDataset::initialize_rds(const Yaml& c)
         mrpt::io::setLazyLoadPathBase(imgsDir);
         MRPT_LOG_INFO_STREAM(
             "Setting rawlog external directory to: " << imgsDir);
+
+        // Only rawlogs with external payloads benefit from prefetching;
+        // for self-contained ones the pool would just run load() no-ops:
+        if (lazy_load_prefetch_threads_ > 0)
+        {
+            lazyLoadPool_ = std::make_unique<mrpt::WorkerThreadsPool>(
+                lazy_load_prefetch_threads_,
+                mrpt::WorkerThreadsPool::POLICY_FIFO, "RawlogLazyLoad");
+        }
     }
 
     if (read_all_first_)
@@ -155,6 +180,7 @@ void RawlogDataset::spinOnce()
     {
         //
         CObservation::Ptr obs = read_ahead_.begin()->second;
+        ensurePayloadLoaded(obs);
         this->sendObservationsToFrontEnds(obs);
 
         unload_queue_.emplace(obs->getTimeStamp(), obs);
@@ -195,7 +221,10 @@ void RawlogDataset::doReadAheadFromFile()
                     std::dynamic_pointer_cast<mrpt::obs::CObservation>(obj);
                 obs)
             {  // Single observation:
-                read_ahead_.emplace(obs->getTimeStamp(), std::move(obs));
+                if (accept_label(obs->sensorLabel))
+                    read_ahead_.emplace(obs->getTimeStamp(), std::move(obs));
+                else
+                    obs->unload();  // payload never gets materialized
             }
             else  //
                 if (auto sf =
@@ -204,7 +233,12 @@ void RawlogDataset::doReadAheadFromFile()
                     sf)
             {
                 for (const auto& o : *sf)
-                    read_ahead_.emplace(o->getTimeStamp(), o);
+                {
+                    if (accept_label(o->sensorLabel))
+                        read_ahead_.emplace(o->getTimeStamp(), o);
+                    else
+                        o->unload();  // payload never gets materialized
+                }
             }
             else if (auto acts = std::dynamic_pointer_cast<
                          mrpt::obs::CActionCollection>(obj);
@@ -241,14 +275,23 @@ void RawlogDataset::doReadAheadFromEntireRawlog()
         if (auto obs = std::dynamic_pointer_cast<mrpt::obs::CObservation>(obj);
             obs)
         {  // Single observation:
-            read_ahead_.emplace(obs->getTimeStamp(), std::move(obs));
+            if (accept_label(obs->sensorLabel))
+                read_ahead_.emplace(obs->getTimeStamp(), std::move(obs));
+            else
+                obs->unload();  // payload never gets materialized
         }
         else  //
             if (auto sf =
                     std::dynamic_pointer_cast<mrpt::obs::CSensoryFrame>(obj);
                 sf)
         {
-            for (const auto& o : *sf) read_ahead_.emplace(o->getTimeStamp(), o);
+            for (const auto& o : *sf)
+            {
+                if (accept_label(o->sensorLabel))
+                    read_ahead_.emplace(o->getTimeStamp(), o);
+                else
+                    o->unload();  // payload never gets materialized
+            }
         }
         else if (auto acts =
                      std::dynamic_pointer_cast<mrpt::obs::CActionCollection>(
@@ -273,10 +316,67 @@ void RawlogDataset::doReadAhead()
     else
         doReadAheadFromFile();
 
+    // resolve external-file payloads of the upcoming entries in the
+    // background, ahead of their publication:
+    enqueuePrefetchJobs();
+
     // and also, unload() very old observations.
     autoUnloadOldEntries();
 }
 
+void RawlogDataset::enqueuePrefetchJobs()
+{
+    if (!lazyLoadPool_) return;
+
+    for (const auto& [tim, obs] : read_ahead_)
+    {
+        // bounded queue: never pile up more I/O jobs than the read-ahead
+        // window itself. Skipped entries are not lost: they fall back to
+        // the synchronous load in ensurePayloadLoaded() at publish time.
+        if (lazyLoadPool_->pendingTasks() >= READ_AHEAD_LEN) break;
+
+        // at most one job per observation while it sits in the window:
+        if (!prefetch_queued_.insert(obs.get()).second) continue;
+
+        {
+            auto lck = mrpt::lockHelper(prefetch_mtx_);
+            prefetch_inflight_.insert(obs.get());
+        }
+        lazyLoadPool_->enqueue(
+            [this, o = obs]()
+            {
+                try
+                {
+                    o->load();
+                }
+                catch (const std::exception& e)
+                {
+                    MRPT_LOG_ERROR_STREAM("[lazy-load prefetch] " << e.what());
+                }
+                auto lck = mrpt::lockHelper(prefetch_mtx_);
+                prefetch_inflight_.erase(o.get());
+                prefetch_cv_.notify_all();
+            });
+    }
+}
+
+void RawlogDataset::ensurePayloadLoaded(const mrpt::obs::CObservation::Ptr& obs)
+{
+    if (lazyLoadPool_)
+    {
+        // if a worker is reading this very payload, wait for it instead
+        // of racing it with a second load():
+        std::unique_lock<std::mutex> lck(prefetch_mtx_);
+        prefetch_cv_.wait(
+            lck, [&]() { return prefetch_inflight_.count(obs.get()) == 0; });
+    }
+    prefetch_queued_.erase(obs.get());
+
+    // no-op if already in memory (self-contained observation, or payload
+    // brought in by the pool above):
+    obs->load();
+}
+
 void RawlogDataset::autoUnloadOldEntries() const
 {
     // unload() very old observations.
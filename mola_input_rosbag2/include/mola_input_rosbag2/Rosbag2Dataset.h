@@ -14,11 +14,17 @@
 #include <mola_kernel/interfaces/Dataset_UI.h>
 #include <mola_kernel/interfaces/OfflineDatasetSource.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <condition_variable>
+#include <cstdint>
 #include <list>
+#include <mutex>
+#include <set>
+#include <vector>
 
 // forward decls to isolate build dependencies downstream:
 namespace tf2
@@ -116,7 +122,9 @@ class Rosbag2Dataset : public RawDataSourceBase,
     std::string base_link_frame_id_   = "base_footprint";
 
     std::optional<mrpt::Clock::time_point> rosbag_begin_time_;
-    size_t                                 read_ahead_length_ = 15;
+    size_t                                 read_ahead_length_  = 15;
+    bool                                   build_message_index_ = true;
+    bool                                   parallel_decode_     = true;
 
     std::optional<mrpt::Clock::time_point> last_play_wallclock_time_;
     double                                 last_dataset_time_ = 0;
@@ -132,6 +140,22 @@ class Rosbag2Dataset : public RawDataSourceBase,
         const std::optional<size_t>& requestedIndex  = std::nullopt,
         bool                         skipBufferAhead = false);
 
+    /** Per-message bag timestamps [ns], loaded from (or built once and saved
+     *  to) a sidecar index file next to the bag. It enables O(log n) random
+     *  seeks via reader_->seek() instead of sequentially re-reading the bag,
+     *  including going backwards in time. Empty if disabled or unavailable.
+     */
+    std::vector<int64_t> msg_timestamps_;
+
+    std::string index_filename() const;
+    bool        load_index();   //!< true if a valid sidecar file was loaded
+    void        build_index();  //!< one-time pass over the whole bag
+    void        save_index() const;
+
+    /** Repositions reader_ right before message `idx` using the index above.
+     *  Returns false if no index is available. */
+    bool seekToIndex(size_t idx);
+
     // timestep in this class is just the index of the message in the rosbag:
     struct DatasetEntry
     {
@@ -211,6 +235,39 @@ class Rosbag2Dataset : public RawDataSourceBase,
     double                time_warp_scale_     = 1.0;
     std::optional<size_t> teleport_here_;
     mutable std::mutex    dataset_ui_mtx_;
+
+    // Per-topic parallel decode lanes (parallel_decode_=true)
+    // -------------------------------------------------------
+    /** Decodes the given raw bag message into read_ahead_[idx]: either
+     *  synchronously, or (for subscribed sensor topics, with
+     *  parallel_decode_ enabled) enqueued on the per-topic decode lane.
+     *  /tf and /tf_static are always decoded in place, in bag order, since
+     *  they mutate tfBuffer_; topics without a registered converter are
+     *  never deserialized at all. */
+    void dispatchDecode(
+        const std::shared_ptr<rosbag2_storage::SerializedBagMessage>& msg,
+        size_t                                                        idx);
+
+    /// Fills read_ahead_[idx] and wakes up waitForEntry() callers.
+    void storeEntry(size_t idx, const SF::Ptr& sf);
+
+    /// Blocks until read_ahead_[idx] is decoded, if it is in flight.
+    void waitForEntry(size_t idx);
+
+    /// Indices dispatched to a decode lane and not yet stored.
+    std::set<size_t>                decode_inflight_;
+    mutable std::mutex              read_ahead_mtx_;
+    mutable std::condition_variable read_ahead_cv_;
+
+    /** One single-thread worker per subscribed sensor topic, so e.g.
+     *  deserializing a large PointCloud2 does not delay IMU or odometry
+     *  decoding; one thread per lane preserves per-topic order, and
+     *  read_ahead_ (indexed by global message number) doubles as the
+     *  reorder buffer: playback consumes entries strictly in bag order.
+     *  Declared last so lanes are joined before the members they use are
+     *  destroyed. */
+    std::map<std::string, std::shared_ptr<mrpt::WorkerThreadsPool>>
+        decode_pools_;
 };
 
 }  // namespace mola
@@ -59,6 +59,10 @@
 #include <tf2_geometry_msgs/tf2_geometry_msgs.hpp>
 #include <tf2_msgs/msg/tf_message.hpp>
 
+#include <algorithm>
+#include <fstream>
+#include <string_view>
+
 using namespace mola;
 
 // arguments: class_name, parent_class, class namespace
@@ -101,6 +105,8 @@ void Rosbag2Dataset::initialize_rds(const Yaml& c)
     YAML_LOAD_MEMBER_OPT(rosbag_serialization, std::string);
     YAML_LOAD_MEMBER_OPT(base_link_frame_id, std::string);
     YAML_LOAD_MEMBER_OPT(read_ahead_length, size_t);
+    YAML_LOAD_MEMBER_OPT(build_message_index, bool);
+    YAML_LOAD_MEMBER_OPT(parallel_decode, bool);
     paused_ = cfg.getOrDefault<bool>("start_paused", paused_);
 
     ASSERT_FILE_EXISTS_(rosbag_filename_);
@@ -158,6 +164,16 @@ void Rosbag2Dataset::initialize_rds(const Yaml& c)
         MRPT_LOG_INFO_STREAM(" " << t.name << " (" << t.type << ")");
     }
 
+    // Sidecar index for O(log n) random seeks (see seekToIndex()):
+    if (build_message_index_)
+    {
+        if (!load_index())
+        {
+            build_index();
+            save_index();
+        }
+    }
+
     read_ahead_.clear();
     read_ahead_.resize(bagMessageCount_);
     rosbag_next_idx_ = 0;
@@ -387,11 +403,13 @@ void Rosbag2Dataset::spinOnce()
     // override by an special teleport order?
     if (teleport_here.has_value() && *teleport_here < bagMessageCount_)
     {
-        if (*teleport_here > rosbag_next_idx_write_)
+        // Without a message index, the sequential reader can only jump
+        // forward; with one, seekToIndex() (via doReadAhead) handles any
+        // direction in O(log n):
+        if (*teleport_here > rosbag_next_idx_write_ || !msg_timestamps_.empty())
         {
             MRPT_LOG_INFO_STREAM(
-                "Request to fast-forward ('teleport') to timestep: "
-                << *teleport_here);
+                "Request to 'teleport' to timestep: " << *teleport_here);
 
             rosbag_next_idx_ = *teleport_here;
             doReadAhead(rosbag_next_idx_, true /* skip read ahead buffer */);
@@ -404,7 +422,9 @@ void Rosbag2Dataset::spinOnce()
             MRPT_LOG_WARN_STREAM(
                 "IGNORING order to go backwards in time to index="
                 << *teleport_here
-                << " due to limitation of serialized rosbag2 reader.");
+                << " due to limitation of serialized rosbag2 reader "
+                   "(no message index available; see option "
+                   "'build_message_index').");
         }
     }
     else
@@ -444,7 +464,10 @@ void Rosbag2Dataset::spinOnce()
         // EOF?
         if (rosbag_next_idx_ >= read_ahead_.size()) break;
 
-        // current dataset entry:
+        // current dataset entry (with parallel decode lanes, it may still
+        // be in flight on its per-topic worker):
+        waitForEntry(rosbag_next_idx_);
+
         auto& de = read_ahead_.at(rosbag_next_idx_);
         ASSERT_(de.has_value());
 
@@ -506,7 +529,10 @@ void Rosbag2Dataset::spinOnce()
         }
 
         // Free memory in read-ahead buffer:
-        read_ahead_.at(rosbag_next_idx_).reset();
+        {
+            auto lck = mrpt::lockHelper(read_ahead_mtx_);
+            read_ahead_.at(rosbag_next_idx_).reset();
+        }
 
         // Move on:
         rosbag_next_idx_++;
@@ -528,6 +554,17 @@ void Rosbag2Dataset::doReadAhead(
 
     ASSERT_(initialized_);
 
+    // With a message index available, reposition the reader instead of
+    // sequentially reading through the bag whenever the target is far ahead,
+    // or behind us (which the sequential reader cannot reach at all):
+    if (requestedIndex && *requestedIndex < read_ahead_.size() &&
+        !read_ahead_.at(*requestedIndex).has_value() &&
+        (*requestedIndex < rosbag_next_idx_write_ ||
+         *requestedIndex > rosbag_next_idx_write_ + read_ahead_length_))
+    {
+        seekToIndex(*requestedIndex);
+    }
+
     // ensure we have observation data at the desired read point, plus a few
     // more:
     const auto startIdx = rosbag_next_idx_write_;
@@ -549,7 +586,12 @@ void Rosbag2Dataset::doReadAhead(
 
     for (size_t idx = startIdx; idx <= endIdx; idx++)
     {
-        if (read_ahead_.at(idx).has_value()) continue;  // already read:
+        bool pendingDecode = false;
+        {
+            auto lck = mrpt::lockHelper(read_ahead_mtx_);
+            if (read_ahead_.at(idx).has_value()) continue;  // already read:
+            pendingDecode = decode_inflight_.count(idx) != 0;
+        }
 
         // serialized data
         ASSERT_EQUAL_(rosbag_next_idx_write_, idx);
@@ -557,24 +599,254 @@ void Rosbag2Dataset::doReadAhead(
 
         auto serialized_message = reader_->read_next();
 
+        // an older, still in-flight decode of this index will fill it in:
+        if (pendingDecode) continue;
+
         if (skipBufferAhead && idx != endIdx) continue;
 
-        SF::Ptr sf = to_mrpt(*serialized_message);
+        dispatchDecode(serialized_message, idx);
+    }
+
+    // Block only until the specifically requested entry is decoded;
+    // look-ahead entries keep decoding in the background:
+    if (requestedIndex && *requestedIndex < read_ahead_.size() &&
+        *requestedIndex < rosbag_next_idx_write_)
+        waitForEntry(*requestedIndex);
+
+    MRPT_END
+}
+
+void Rosbag2Dataset::dispatchDecode(
+    const std::shared_ptr<rosbag2_storage::SerializedBagMessage>& msg,
+    size_t                                                        idx)
+{
+    const auto& topic = msg->topic_name;
+
+    // tf topics are tiny and mutate tfBuffer_, so they are always decoded
+    // synchronously, keeping the buffer consistent in bag order. Topics
+    // without a registered converter skip deserialization altogether (see
+    // to_mrpt()):
+    const bool handled = lookup_.count(topic) != 0;
+    const bool useLane =
+        parallel_decode_ && handled && topic != "/tf" && topic != "/tf_static";
+
+    if (!useLane)
+    {
+        SF::Ptr sf = to_mrpt(*msg);
         ASSERT_(sf);
+        storeEntry(idx, sf);
+        return;
+    }
 
-        DatasetEntry& de = read_ahead_.at(idx).emplace();
+    auto& lane = decode_pools_[topic];
+    if (!lane)
+    {
+        lane = std::make_shared<mrpt::WorkerThreadsPool>(
+            1 /* one thread: preserves per-topic message order */,
+            mrpt::WorkerThreadsPool::POLICY_FIFO, "decode:" + topic);
+    }
 
-        de.obs = sf;
+    {
+        auto lck = mrpt::lockHelper(read_ahead_mtx_);
+        decode_inflight_.insert(idx);
+    }
 
-        if (!sf->empty())
+    lane->enqueue(
+        [this, msg, idx]()
         {
-            de.timestamp = sf->getObservationByIndex(0)->timestamp;
-        }
+            SF::Ptr sf;
+            try
+            {
+                sf = to_mrpt(*msg);
+                ASSERT_(sf);
+            }
+            catch (const std::exception& e)
+            {
+                MRPT_LOG_ERROR_STREAM(
+                    "Exception decoding bag message #" << idx << ": "
+                                                       << e.what());
+                sf = SF::Create();
+            }
+            storeEntry(idx, sf);
+        });
+}
+
+void Rosbag2Dataset::storeEntry(size_t idx, const SF::Ptr& sf)
+{
+    auto lck = mrpt::lockHelper(read_ahead_mtx_);
+
+    DatasetEntry& de = read_ahead_.at(idx).emplace();
+
+    de.obs = sf;
+
+    if (!sf->empty())
+    {
+        de.timestamp = sf->getObservationByIndex(0)->timestamp;
     }
 
+    decode_inflight_.erase(idx);
+    read_ahead_cv_.notify_all();
+}
+
+void Rosbag2Dataset::waitForEntry(size_t idx)
+{
+    std::unique_lock<std::mutex> lck(read_ahead_mtx_);
+
+    // in-flight entries will be stored by their decode lane; anything else
+    // is either already there, or a logic error the caller's ASSERT on
+    // has_value() will catch:
+    read_ahead_cv_.wait(
+        lck,
+        [this, idx]()
+        {
+            return read_ahead_.at(idx).has_value() ||
+                   decode_inflight_.count(idx) == 0;
+        });
+}
+
+std::string Rosbag2Dataset::index_filename() const
+{
+    return rosbag_filename_ + std::string(".msgidx");
+}
+
+bool Rosbag2Dataset::load_index()
+{
+    const auto fil = index_filename();
+    if (!mrpt::system::fileExists(fil)) return false;
+
+    std::ifstream f(fil, std::ios::binary);
+    if (!f.is_open()) return false;
+
+    char     magic[8] = {0};
+    uint64_t count    = 0;
+    f.read(magic, sizeof(magic));
+    f.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+    // Compare magic *and* version byte, so a future "MOLAIDX2" file is
+    // rejected (and the index rebuilt) instead of misread with this layout:
+    if (!f.good() || std::string_view(magic, 8) != "MOLAIDX1")
+    {
+        MRPT_LOG_WARN_STREAM("Ignoring unrecognized index file: " << fil);
+        return false;
+    }
+    if (count != bagMessageCount_)
+    {
+        MRPT_LOG_WARN_STREAM(
+            "Ignoring stale index file (bag has "
+            << bagMessageCount_ << " messages, index has " << count
+            << "): " << fil);
+        return false;
+    }
+
+    msg_timestamps_.resize(count);
+    f.read(
+        reinterpret_cast<char*>(msg_timestamps_.data()),
+        sizeof(int64_t) * count);
+    if (!f.good())
+    {
+        msg_timestamps_.clear();
+        MRPT_LOG_WARN_STREAM("Ignoring truncated index file: " << fil);
+        return false;
+    }
+
+    MRPT_LOG_INFO_STREAM(
+        "Loaded message index (" << count << " entries): " << fil);
+    return true;
+}
+
+void Rosbag2Dataset::build_index()
+{
+    MRPT_START
+    ProfilerEntry tle(profiler_, "build_index");
+
+    MRPT_LOG_INFO(
+        "Building one-time message index for random access (this reads "
+        "through the whole bag once)...");
+
+    rosbag2_storage::StorageOptions storage_options;
+    storage_options.uri        = rosbag_filename_;
+    storage_options.storage_id = rosbag_storage_id_;
+
+    rosbag2_cpp::ConverterOptions converter_options;
+    converter_options.input_serialization_format  = rosbag_serialization_;
+    converter_options.output_serialization_format = rosbag_serialization_;
+
+    // A dedicated reader, so the playback one keeps its position:
+    auto idxReader = std::make_shared<rosbag2_cpp::readers::SequentialReader>();
+    idxReader->open(storage_options, converter_options);
+
+    msg_timestamps_.clear();
+    msg_timestamps_.reserve(bagMessageCount_);
+
+    while (idxReader->has_next())
+        msg_timestamps_.push_back(idxReader->read_next()->time_stamp);
+
+    ASSERT_EQUAL_(msg_timestamps_.size(), bagMessageCount_);
+
+    MRPT_LOG_INFO_STREAM(
+        "Message index built (" << msg_timestamps_.size() << " entries).");
     MRPT_END
 }
 
+void Rosbag2Dataset::save_index() const
+{
+    const auto fil = index_filename();
+
+    std::ofstream f(fil, std::ios::binary | std::ios::trunc);
+    if (!f.is_open())
+    {
+        MRPT_LOG_WARN_STREAM(
+            "Cannot write message index file (will be rebuilt next run): "
+            << fil);
+        return;
+    }
+
+    const char     magic[8] = {'M', 'O', 'L', 'A', 'I', 'D', 'X', '1'};
+    const uint64_t count    = msg_timestamps_.size();
+    f.write(magic, sizeof(magic));
+    f.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    f.write(
+        reinterpret_cast<const char*>(msg_timestamps_.data()),
+        sizeof(int64_t) * count);
+
+    if (f.good()) MRPT_LOG_INFO_STREAM("Saved message index: " << fil);
+}
+
+bool Rosbag2Dataset::seekToIndex(size_t idx)
+{
+    if (msg_timestamps_.empty()) return false;
+    ASSERT_LT_(idx, msg_timestamps_.size());
+
+    const int64_t ts = msg_timestamps_[idx];
+
+    // seek() repositions at the first message with timestamp >= ts, which
+    // may be earlier than idx if several messages share that timestamp:
+    const size_t firstIdx = static_cast<size_t>(
+        std::lower_bound(msg_timestamps_.begin(), msg_timestamps_.end(), ts) -
+        msg_timestamps_.begin());
+
+    MRPT_LOG_DEBUG_STREAM(
+        "[seekToIndex] idx=" << idx << " => reader_->seek(" << ts
+                             << "), firstIdx=" << firstIdx);
+
+    reader_->seek(ts);
+
+    // invalidate buffered entries at and after the new reader position, so
+    // doReadAhead() re-reads them sequentially from here (entries with an
+    // in-flight decode are kept: their lane will re-fill the same content):
+    {
+        auto lck = mrpt::lockHelper(read_ahead_mtx_);
+        for (size_t i = firstIdx; i < read_ahead_.size(); i++)
+        {
+            if (decode_inflight_.count(i) != 0) continue;
+            read_ahead_[i].reset();
+        }
+    }
+
+    rosbag_next_idx_write_ = firstIdx;
+    return true;
+}
+
 // See docs in base class:
 size_t Rosbag2Dataset::datasetSize() const
 {
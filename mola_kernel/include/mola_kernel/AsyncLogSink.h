@@ -0,0 +1,65 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   AsyncLogSink.h
+ * @brief  Asynchronous console sink for COutputLogger-based modules
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/system/COutputLogger.h>
+
+#include <cstdint>
+#include <string>
+
+namespace mola
+{
+/** Asynchronous replacement for the synchronous console output of
+ * mrpt::system::COutputLogger: attached modules stop writing to the
+ * console from their own threads; instead, each emitted message is pushed
+ * into a lock-free per-thread ring buffer and a single background thread
+ * decorates and writes them, so the timing impact of enabling verbose
+ * logging on a hot path drops to one string copy per message. If a
+ * producer outruns the writer its ring fills and messages are
+ * dropped (and counted), never blocking the module.
+ *
+ * An optional per-label throttle (label = logger name) caps the sustained
+ * console rate of each module, so a misbehaving DEBUG-level producer
+ * cannot drown the output of the others: suppressed-message counts are
+ * reported periodically instead.
+ *
+ * Typically enabled system-wide from the mola-cli launch YAML
+ * (`launcher: {async_logging: true}`) rather than used directly.
+ *
+ * \note The message body is still formatted on the caller thread (that is
+ * how COutputLogger hands messages to its callbacks); what this sink
+ * removes from module threads is the console I/O and decoration, which
+ * dominate the cost.
+ *
+ * \ingroup mola_kernel_grp */
+class AsyncLogSink
+{
+   public:
+    /** Routes the given logger through the async sink: disables its
+     * synchronous console output and registers the enqueueing callback.
+     * Idempotent per logger object. Thread-safe. */
+    static void attach(mrpt::system::COutputLogger& logger);
+
+    /** Sustained per-label (= per logger name) output rate cap, in
+     * messages/second; 0 (default) disables throttling. Bursts up to 2x
+     * the rate are allowed. */
+    static void set_max_rate_per_label(const double maxPerSecond);
+
+    /** Blocks until everything enqueued so far has been written out (e.g.
+     * before printing a final report). */
+    static void flush();
+
+    /** Messages dropped so far because a producer overran its ring. */
+    static uint64_t dropped_count();
+};
+
+}  // namespace mola
@@ -0,0 +1,138 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   DatasetPrefetcher.h
+ * @brief  Shared read-ahead/caching engine for offline dataset sources
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/obs/CObservation.h>
+
+#include <condition_variable>
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+
+namespace mola
+{
+/** Shared read-ahead and caching engine for offline dataset sources.
+ *
+ * Each dataset input module used to re-implement its own ad-hoc lazy
+ * loading, one-step read-ahead, and "unload old entries" logic. This class
+ * factors all of that out:
+ *
+ * - A background pool decodes the `look_ahead` timesteps past the playback
+ *   cursor, overlapping file I/O and observation construction with
+ *   downstream processing.
+ * - Decoded entries are cached with least-recently-used eviction, bounded
+ *   by `max_cached_entries`.
+ * - Moving the cursor anywhere (e.g. Dataset_UI::datasetUI_teleport())
+ *   simply re-aims the prefetch window; queued decode jobs that fell
+ *   outside it are dropped before doing any work.
+ *
+ * The owner provides a decode functor mapping a timestep to a fully built
+ * observation. The functor runs in the worker thread, so anything it
+ * touches besides its own locals must be immutable or thread-safe.
+ *
+ * \ingroup mola_kernel_grp
+ */
+class DatasetPrefetcher
+{
+   public:
+    DatasetPrefetcher()  = default;
+    ~DatasetPrefetcher() = default;
+
+    using decode_function_t =
+        std::function<mrpt::obs::CObservation::Ptr(size_t timestep)>;
+
+    struct Parameters
+    {
+        /** How many timesteps are decoded ahead of the playback cursor
+         * (0 = fully synchronous operation, no worker thread). */
+        unsigned int look_ahead = 5;
+
+        /** Upper bound for the number of cached decoded entries; the
+         * least-recently-used ones are evicted past it. */
+        size_t max_cached_entries = 250;
+
+        /** Number of background decoding threads. */
+        unsigned int decode_threads = 1;
+    };
+
+    /** Must be called once before get(). `datasetLength` is the number of
+     * valid timesteps, as in OfflineDatasetSource::datasetSize(). */
+    void initialize(
+        decode_function_t decoder, size_t datasetLength,
+        const Parameters& params = {});
+
+    bool initialized() const { return !!decoder_; }
+
+    /** Returns the decoded entry for the given timestep: served from the
+     * cache if already prefetched, decoded synchronously otherwise (or,
+     * if a worker is decoding that same step right now, waiting for it
+     * instead of decoding the file twice). Marks the entry as
+     * most-recently-used, moves the prefetch cursor to `step`, and
+     * schedules the decode of the following timesteps.
+     */
+    mrpt::obs::CObservation::Ptr get(size_t step);
+
+    /** Re-aims the prefetch window after a random seek, without blocking.
+     * Optional (get() already moves the cursor): it lets UIs warm up the
+     * new window before the next get().
+     */
+    void prefetch_from(size_t step);
+
+    /** Empties the cache. Queued decode jobs are dropped as they come up.
+     */
+    void clear();
+
+   private:
+    decode_function_t decoder_;
+    size_t            datasetLength_ = 0;
+    Parameters        params_;
+
+    /// Guards all fields below; never held while decoding:
+    std::mutex              mtx_;
+    std::condition_variable cv_;
+
+    std::map<size_t, mrpt::obs::CObservation::Ptr> cache_;
+
+    /// LRU bookkeeping: lru_ is ordered from most- to least-recently used,
+    /// lruPos_ locates each cached step within it in O(log n):
+    std::list<size_t>                             lru_;
+    std::map<size_t, std::list<size_t>::iterator> lruPos_;
+
+    /// Timesteps being decoded right now (by workers or a get() call):
+    std::set<size_t> inflight_;
+
+    size_t cursor_ = 0;
+
+    /// Declared last so its destructor joins the workers before the fields
+    /// their tasks use are destroyed:
+    std::unique_ptr<mrpt::WorkerThreadsPool> pool_;
+
+    /// Moves `step` to the front of the LRU order. mtx_ must be held.
+    void touch(size_t step);
+
+    /// Applies max_cached_entries. mtx_ must be held.
+    void evict();
+
+    /// Enqueues decode jobs for the window past cursor_. Call WITHOUT mtx_.
+    void scheduleAhead();
+
+    /// Decodes `step`, which the caller must have inserted in inflight_,
+    /// stores it in the cache and wakes up any waiters:
+    mrpt::obs::CObservation::Ptr decodeInflight(size_t step);
+};
+
+}  // namespace mola
@@ -36,6 +36,15 @@ using Entity = std::variant<
     std::monostate, RefPose3, RelPose3, RelPose3KF, RelDynPose3KF,
     LandmarkPoint3, EntityOther>;
 
+// The point of the variant is that the common (keyframe) entity types live
+// contiguously in the container slot itself. Keep their inline footprint
+// bounded: entity types with heavyweight payloads must be stored via
+// EntityOther (heap) instead of being added to the variant above.
+static_assert(
+    sizeof(Entity) <= 192,
+    "mola::Entity grew too large: store heavyweight entity types via "
+    "EntityOther");
+
 /** \addtogroup entity_utils Entity handling utilities
  *  \ingroup mola_kernel_grp
  *  @{ */
@@ -11,9 +11,21 @@
  */
 #pragma once
 
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>  // std::hash, std::less
 #include <map>
 #include <memory>  // std::allocator
+#include <mutex>
 #include <set>
+#include <string>
+#include <utility>
+#include <vector>
 #if MOLA_KERNEL_HAS_TBB
 #include <tbb/tbb_allocator.h>
 #endif
@@ -28,11 +40,358 @@ template <typename T>
 using FastAllocator = std::allocator<T>;
 #endif
 
+/** Lock-free per-module heap accounting.
+ *
+ * Each module executor thread is tagged once at launch with
+ * set_thread_module() (done by MolaLauncherApp); every allocation performed
+ * through the accounting-aware containers below (fast_set, fast_map,
+ * fast_unordered_*, and the FrameArena blocks) then charges a set of relaxed
+ * atomic counters of that module's slot. Threads never tagged are aggregated
+ * under the "untagged" slot. The hot path is two or three relaxed atomic
+ * increments; registration (rare: once per module) is the only operation
+ * taking a lock.
+ *
+ * snapshot() returns all per-module figures; ProfilerDashboard exposes them
+ * as `mola_memory_*` metrics, so attributing RSS growth to a module becomes
+ * a metrics query instead of requiring an external heap profiler.
+ *
+ * \note Frees are credited to the thread performing them, so containers
+ * handed across modules can skew individual figures; the sum over all
+ * modules of bytes_in_use remains exact.
+ * \ingroup mola_kernel_grp */
+class MemoryAccounting
+{
+   public:
+    struct Stats
+    {
+        int64_t  bytes_in_use    = 0;
+        uint64_t bytes_allocated = 0;  //!< cumulative
+        uint64_t alloc_calls     = 0;
+        uint64_t free_calls      = 0;
+    };
+
+    /** Tags the calling thread as belonging to the given module; all
+     * subsequent accounted (de)allocations from this thread charge that
+     * module's counters. */
+    static void set_thread_module(const std::string& moduleName)
+    {
+        tls_slot() = &slot_for(moduleName);
+    }
+
+    static void on_alloc(const std::size_t nBytes) noexcept
+    {
+        auto& s = *tls_slot();
+        s.bytesInUse.fetch_add(
+            static_cast<int64_t>(nBytes), std::memory_order_relaxed);
+        s.bytesAllocated.fetch_add(nBytes, std::memory_order_relaxed);
+        s.allocCalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void on_free(const std::size_t nBytes) noexcept
+    {
+        auto& s = *tls_slot();
+        s.bytesInUse.fetch_sub(
+            static_cast<int64_t>(nBytes), std::memory_order_relaxed);
+        s.freeCalls.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** One entry per known module (plus "untagged"), by module name. */
+    static std::map<std::string, Stats> snapshot()
+    {
+        std::map<std::string, Stats> out;
+        auto&                        r = registry();
+        const std::size_t n = r.count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            const auto& s  = r.slots[i];
+            auto&       st = out[s.name];
+            st.bytes_in_use    = s.bytesInUse.load(std::memory_order_relaxed);
+            st.bytes_allocated =
+                s.bytesAllocated.load(std::memory_order_relaxed);
+            st.alloc_calls = s.allocCalls.load(std::memory_order_relaxed);
+            st.free_calls  = s.freeCalls.load(std::memory_order_relaxed);
+        }
+        return out;
+    }
+
+   private:
+    struct Slot
+    {
+        std::string           name;  //!< set once at registration
+        std::atomic<int64_t>  bytesInUse{0};
+        std::atomic<uint64_t> bytesAllocated{0};
+        std::atomic<uint64_t> allocCalls{0};
+        std::atomic<uint64_t> freeCalls{0};
+    };
+
+    /// Slots are append-only, so readers scan without locking:
+    constexpr static std::size_t MAX_SLOTS = 64;
+
+    struct Registry
+    {
+        Registry() { slots[0].name = "untagged"; }
+
+        std::array<Slot, MAX_SLOTS> slots;
+        std::atomic<std::size_t>    count{1};  // slots[0] = "untagged"
+        std::mutex                  registerMtx;
+    };
+    static Registry& registry()
+    {
+        static Registry r;
+        return r;
+    }
+
+    static Slot& slot_for(const std::string& name)
+    {
+        auto& r = registry();
+
+        std::size_t n = r.count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; i++)
+            if (r.slots[i].name == name) return r.slots[i];
+
+        std::lock_guard<std::mutex> lck(r.registerMtx);
+        n = r.count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < n; i++)
+            if (r.slots[i].name == name) return r.slots[i];
+
+        // Overflowing MAX_SLOTS aggregates into "untagged" rather than
+        // failing; no sane launch file has that many modules:
+        if (n >= MAX_SLOTS) return r.slots[0];
+
+        r.slots[n].name = name;
+        r.count.store(n + 1, std::memory_order_release);
+        return r.slots[n];
+    }
+
+    static Slot*& tls_slot()
+    {
+        thread_local Slot* s = &registry().slots[0];
+        return s;
+    }
+};
+
+/** STL allocator adaptor charging each (de)allocation to the calling
+ * thread's module slot (see MemoryAccounting), then forwarding to Base.
+ * Stateless, like the allocators it wraps. */
+template <typename T, class Base = FastAllocator<T>>
+class AccountingAllocator : public Base
+{
+   public:
+    using value_type = T;
+
+    AccountingAllocator() noexcept = default;
+    template <typename U, class B2>
+    AccountingAllocator(const AccountingAllocator<U, B2>&) noexcept
+    {
+    }
+
+    template <typename U>
+    struct rebind
+    {
+        using other = AccountingAllocator<
+            U, typename std::allocator_traits<Base>::template rebind_alloc<U>>;
+    };
+
+    T* allocate(const std::size_t n)
+    {
+        MemoryAccounting::on_alloc(n * sizeof(T));
+        return Base::allocate(n);
+    }
+    void deallocate(T* p, const std::size_t n) noexcept
+    {
+        MemoryAccounting::on_free(n * sizeof(T));
+        Base::deallocate(p, n);
+    }
+
+    template <typename U, class B2>
+    bool operator==(const AccountingAllocator<U, B2>&) const noexcept
+    {
+        return true;
+    }
+    template <typename U, class B2>
+    bool operator!=(const AccountingAllocator<U, B2>&) const noexcept
+    {
+        return false;
+    }
+};
+
 template <class T, class Compare = std::less<T>>
-using fast_set = std::set<T, Compare, FastAllocator<T>>;
+using fast_set = std::set<T, Compare, AccountingAllocator<T>>;
 
 template <class Key, class T, class Compare = std::less<Key>>
 using fast_map =
-    std::map<Key, T, Compare, FastAllocator<std::pair<const Key, T>>>;
+    std::map<Key, T, Compare, AccountingAllocator<std::pair<const Key, T>>>;
+
+/** Open-addressing (robin-hood) hash map, for keys whose access pattern is
+ * unordered in nature (entity/factor ids, voxel indices, ...): lookups and
+ * insertions are one probe sequence over linear memory instead of a tree
+ * walk. Iteration order is unspecified; use fast_map where callers rely on
+ * sorted traversal. Backed by the tsl::robin_map bundled with MRPT, over
+ * FastAllocator (TBB when available). */
+template <
+    class Key, class T, class Hash = std::hash<Key>,
+    class KeyEqual = std::equal_to<Key>>
+using fast_unordered_map = tsl::robin_map<
+    Key, T, Hash, KeyEqual, AccountingAllocator<std::pair<Key, T>>>;
+
+/** Open-addressing counterpart of fast_set; see fast_unordered_map. */
+template <
+    class Key, class Hash = std::hash<Key>,
+    class KeyEqual = std::equal_to<Key>>
+using fast_unordered_set =
+    tsl::robin_set<Key, Hash, KeyEqual, AccountingAllocator<Key>>;
+
+/** Thread-local bump ("arena") allocator for per-frame transient containers.
+ *
+ * allocate() just advances a pointer inside thread-local memory blocks;
+ * individual frees are no-ops, and all memory of the calling thread is
+ * recycled at once with reset_epoch(), typically at the top of a module's
+ * spinOnce(). Blocks are kept across epochs, so steady-state frames perform
+ * no heap allocation at all.
+ *
+ * \warning Containers using this arena must not outlive the epoch they were
+ * created in: reset_epoch() invalidates all of the thread's arena memory.
+ * \ingroup mola_kernel_grp */
+class FrameArena
+{
+   public:
+    /** Recycles all arena memory of the calling thread (O(1), except when
+     *  the ending epoch made oversized requests: those blocks are returned
+     *  to the heap here). */
+    static void reset_epoch()
+    {
+        auto& s    = tls();
+        s.blockIdx = 0;
+        s.offset   = 0;
+        // Oversized blocks are never bump-allocated from, so keeping them
+        // across epochs would only grow the arena:
+        if (!s.bigBlocks.empty())
+        {
+            MemoryAccounting::on_free(s.bigBytes);
+            s.totalBytes -= s.bigBytes;
+            s.bigBytes = 0;
+            s.bigBlocks.clear();
+        }
+    }
+
+    /** Bytes currently handed out in this thread's epoch */
+    static std::size_t used_bytes()
+    {
+        return tls().blockIdx * BLOCK_SIZE + tls().offset + tls().bigBytes;
+    }
+
+    static void* allocate(const std::size_t nBytes, const std::size_t align)
+    {
+        auto& s = tls();
+
+        // Requests larger than a whole block fall back to the heap. Kept in
+        // a list of their own: the bump-allocation walk below visits every
+        // entry of `blocks`, and would overwrite a live oversized
+        // allocation placed there once the regular blocks run out within
+        // the same epoch.
+        if (nBytes + align > BLOCK_SIZE)
+        {
+            auto& blk = s.bigBlocks.emplace_back(
+                std::make_unique<std::uint8_t[]>(nBytes + align));
+            s.bigBytes += nBytes + align;
+            s.totalBytes += nBytes + align;
+            MemoryAccounting::on_alloc(nBytes + align);
+            const auto b = reinterpret_cast<std::uintptr_t>(blk.get());
+            return reinterpret_cast<void*>((b + align - 1) & ~(align - 1));
+        }
+
+        for (;;)
+        {
+            if (s.blockIdx >= s.blocks.size())
+            {
+                s.blocks.emplace_back(
+                    std::make_unique<std::uint8_t[]>(BLOCK_SIZE));
+                s.totalBytes += BLOCK_SIZE;
+                MemoryAccounting::on_alloc(BLOCK_SIZE);
+            }
+
+            const auto base =
+                reinterpret_cast<std::uintptr_t>(s.blocks[s.blockIdx].get());
+            const std::size_t ofs =
+                ((base + s.offset + align - 1) & ~(align - 1)) - base;
+
+            if (ofs + nBytes <= BLOCK_SIZE)
+            {
+                s.offset = ofs + nBytes;
+                return reinterpret_cast<void*>(base + ofs);
+            }
+            // Block exhausted: move to the next one.
+            s.blockIdx++;
+            s.offset = 0;
+        }
+    }
+
+   private:
+    constexpr static std::size_t BLOCK_SIZE = 256 * 1024;
+
+    struct ThreadState
+    {
+        ThreadState() = default;
+        ~ThreadState()
+        {
+            // blocks are only released at thread exit; credit them back:
+            if (totalBytes) MemoryAccounting::on_free(totalBytes);
+        }
+
+        std::vector<std::unique_ptr<std::uint8_t[]>> blocks;
+        /** Heap fallbacks for requests larger than BLOCK_SIZE; released at
+         *  reset_epoch(). See allocate(). */
+        std::vector<std::unique_ptr<std::uint8_t[]>> bigBlocks;
+        std::size_t                                  blockIdx   = 0;
+        std::size_t                                  offset     = 0;
+        std::size_t                                  totalBytes = 0;
+        std::size_t                                  bigBytes   = 0;
+    };
+    static ThreadState& tls()
+    {
+        thread_local ThreadState s;
+        return s;
+    }
+};
+
+/** STL-compatible allocator over FrameArena; deallocate() is a no-op. */
+template <typename T>
+class FrameArenaAllocator
+{
+   public:
+    using value_type = T;
+
+    FrameArenaAllocator() noexcept = default;
+    template <typename U>
+    FrameArenaAllocator(const FrameArenaAllocator<U>&) noexcept
+    {
+    }
+
+    T* allocate(const std::size_t n)
+    {
+        return static_cast<T*>(FrameArena::allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T*, std::size_t) noexcept {}
+
+    template <typename U>
+    bool operator==(const FrameArenaAllocator<U>&) const noexcept
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const FrameArenaAllocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+/** Per-frame scratch containers over the thread-local FrameArena: free to
+ * destroy, recycled wholesale by FrameArena::reset_epoch(). */
+template <class T>
+using fast_vector = std::vector<T, FrameArenaAllocator<T>>;
+
+template <class Key, class T, class Compare = std::less<Key>>
+using fast_small_map = std::map<
+    Key, T, Compare, FrameArenaAllocator<std::pair<const Key, T>>>;
 
 }  // namespace mola
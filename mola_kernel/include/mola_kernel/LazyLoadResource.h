@@ -14,7 +14,10 @@
 #include <mola_kernel/id.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <atomic>
+#include <cstdint>
 #include <string>
+#include <utility>
 
 namespace mola
 {
@@ -33,6 +36,14 @@ class LazyLoadResource
     {
     }
 
+    // Custom copies/moves exist only because of the atomic pin count, which
+    // is deliberately NOT propagated: pins are held on a specific instance
+    // by whoever called pin() on it.
+    LazyLoadResource(const LazyLoadResource& o) { *this = o; }
+    LazyLoadResource& operator=(const LazyLoadResource& o);
+    LazyLoadResource(LazyLoadResource&& o) noexcept { *this = std::move(o); }
+    LazyLoadResource& operator=(LazyLoadResource&& o) noexcept;
+
     const std::string& externalStorage() const { return external_filename_; }
 
     /** Access (a copy of) the underlying smart pointer to the object */
@@ -48,13 +59,41 @@ class LazyLoadResource
         return data_;
     }
 
-    /** Ensure data is loaded from disk, if it was automatically swapped-off */
+    /** Ensure data is loaded from disk, if it was automatically swapped-off.
+     * If the data is still sitting in the background write queue (see
+     * unload()), it is recovered from there without touching the disk. */
     void load() const;
 
-    /** Unload data and save to disk now, if not already done before */
+    /** Unload data, enqueuing it to be saved to disk by a background writer
+     * thread (if not already stored before), so the caller never blocks on
+     * disk I/O. Repeated unloads of the same entity are coalesced into one
+     * write. */
     void unload() const;
     bool isUnloaded() const;
 
+    /** Pins this resource in memory: while the refcounted pin count is
+     * nonzero, unload() is a no-op, so eviction sweeps cannot swap the data
+     * off while it is in use (e.g. mid-optimization during loop closure).
+     * Thread-safe; pair every pin() with exactly one unpin(), or use the
+     * scoped WorldModel::EntityPin handle. */
+    void pin() const { pin_count_.fetch_add(1, std::memory_order_relaxed); }
+
+    void unpin() const { pin_count_.fetch_sub(1, std::memory_order_relaxed); }
+
+    bool isPinned() const
+    {
+        return pin_count_.load(std::memory_order_relaxed) > 0;
+    }
+
+    /** Blocks until all writes enqueued by unload() have reached disk.
+     * Call it, e.g. before snapshotting the map storage directory. */
+    static void flushAllPendingWrites();
+
+    /** Approximate in-memory size [bytes] of the loaded object, estimated
+     * from its external storage size. Returns 0 if unloaded, or if the data
+     * has never been swapped off to disk yet. */
+    std::size_t approxMemoryFootprint() const;
+
     /** Empty this container. */
     void reset() { *this = LazyLoadResource(); }
 
@@ -74,6 +113,43 @@ class LazyLoadResource
 
     static std::string EXTERNAL_BASE_DIR;
 
+    /** If enabled (env var `MOLA_MMAP_STORAGE`, default=false), entities are
+     * swapped off as raw (uncompressed) archives which are read back by
+     * memory-mapping the file and deserializing straight from the mapped
+     * pages, instead of pulling everything through a gzip stream. On
+     * platforms without mmap() this flag is ignored. */
+    static bool MMAP_STORAGE;
+
+    /** gzip level (0=store ... 9) used when swapping entities off to disk
+     * (ignored in mmap mode, which writes raw). Settable via env var
+     * `MOLA_GZ_COMPRESS_LEVEL`; default=1, which compresses at streaming
+     * speed, so long missions no longer fill the disk with raw payloads. */
+    static int GZ_COMPRESS_LEVEL;
+
+    /** Entities per storage subdirectory (`shard_NNNN/`, keyed by
+     * parent entity id): keeps per-directory entry counts bounded, so
+     * filesystem lookups stay flat past 100k keyframes instead of
+     * degrading with one huge directory. Settable via env var
+     * `MOLA_MAP_DIR_SHARD_SIZE`; 0 recovers the legacy flat layout.
+     * Files from flat-layout maps are still found on load(). */
+    static unsigned int DIR_SHARD_SIZE;
+
+    /** Durability batching of the background writer: after this many
+     * swapped-off files, one filesystem sync is issued for the whole batch
+     * instead of per-file barriers. Settable via env var
+     * `MOLA_MAP_FSYNC_BATCH`; 0 disables explicit syncs (OS writeback
+     * only). flushAllPendingWrites() always ends with a sync. */
+    static unsigned int FSYNC_BATCH;
+
+    /** Serialized (uncompressed) and on-disk (compressed) sizes [bytes] of
+     * the given external file, as recorded by the background writer of this
+     * process; (0, 0) if unknown (e.g. the file was written by a previous
+     * run). The uncompressed size is what feeds the working-set memory
+     * budget (see approxMemoryFootprint()): with compression enabled, raw
+     * file sizes would under-estimate the in-RAM footprint. */
+    static std::pair<uint64_t, uint64_t> storedSizes(
+        const std::string& absFileName);
+
    private:
     inline void internalLoadProxy() const
     {
@@ -89,5 +165,9 @@ class LazyLoadResource
     mola::id_t          parent_entity_id_{INVALID_ID};
     mutable std::string cached_abs_fil_;
     mutable bool        cached_file_ok_{false};
+    mutable std::size_t approx_size_{0};
+
+    /** See pin(). Not copied and not serialized. */
+    mutable std::atomic<std::uint32_t> pin_count_{0};
 };
 }  // namespace mola
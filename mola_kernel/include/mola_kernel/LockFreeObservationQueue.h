@@ -0,0 +1,145 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   LockFreeObservationQueue.h
+ * @brief  Bounded lock-free MPMC broadcast queue for observation delivery
+ * @author Jose Luis Blanco Claraco
+ * @date   Mar 12, 2024
+ */
+#pragma once
+
+#include <mrpt/obs/CObservation.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace mola
+{
+/** Bounded, lock-free, multi-producer broadcast queue of observations.
+ *
+ * Producers (sensor threads) publish via publish() without taking any lock;
+ * each registered consumer owns an independent read cursor, so all consumers
+ * see every published observation, each at its own pace. Slots are recycled
+ * once *all* consumers have advanced past them; when the ring is full,
+ * publish() spins (yielding) until the slowest consumer frees a slot.
+ *
+ * Consumers must be registered *before* the first call to publish().
+ * Capacity is rounded up to the next power of two.
+ *
+ * \ingroup mola_kernel_grp
+ */
+class LockFreeObservationQueue
+{
+   public:
+    explicit LockFreeObservationQueue(size_t capacity = 1024)
+    {
+        size_t cap = 8;
+        while (cap < capacity) cap <<= 1;
+        slots_.resize(cap);
+        mask_ = cap - 1;
+        for (size_t i = 0; i < cap; i++)
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    /** Registers a new consumer; returns its index, to be passed to poll().
+     *  Not thread-safe: call before any publish(). */
+    size_t register_consumer()
+    {
+        cursors_.push_back(std::make_unique<Cursor>());
+        return cursors_.size() - 1;
+    }
+
+    size_t consumers_count() const { return cursors_.size(); }
+
+    /** Publishes one observation to all registered consumers.
+     *  Thread-safe for concurrent producers. Blocks (spinning/yielding) if
+     *  the ring is full because of a slow consumer. */
+    void publish(const mrpt::obs::CObservation::Ptr& obs)
+    {
+        const uint64_t ticket = head_.fetch_add(1, std::memory_order_relaxed);
+        Slot&          s      = slots_[ticket & mask_];
+
+        // Wait until the slot has been released by all consumers, i.e. its
+        // sequence has wrapped around to this lap:
+        while (s.seq.load(std::memory_order_acquire) != ticket)
+            std::this_thread::yield();
+
+        s.obs = obs;
+        // Every registered consumer must read this slot before it can be
+        // recycled (see poll()):
+        s.readers_left.store(
+            static_cast<uint32_t>(cursors_.size()), std::memory_order_relaxed);
+        // Mark slot as readable for lap `ticket`:
+        s.seq.store(ticket + 1, std::memory_order_release);
+    }
+
+    /** Non-blocking read for consumer `idx`. Returns nullptr if no new
+     *  observation is available for that consumer. */
+    mrpt::obs::CObservation::Ptr poll(const size_t idx)
+    {
+        Cursor&        c      = *cursors_[idx];
+        const uint64_t ticket = c.pos.load(std::memory_order_relaxed);
+        Slot&          s      = slots_[ticket & mask_];
+
+        if (s.seq.load(std::memory_order_acquire) != ticket + 1)
+            return {};  // not yet published
+
+        auto obs = s.obs;  // shared_ptr copy; slot stays valid for others
+        c.pos.store(ticket + 1, std::memory_order_release);
+
+        // Single-owner release: each consumer reads a given lap of a slot
+        // exactly once (cursors are per-consumer), so the countdown reaches
+        // zero exactly once and only that last reader recycles the slot.
+        // This closes the window where two readers could both decide to
+        // release, one of them after a producer had already reclaimed the
+        // slot (destroying the freshly-published observation and rolling
+        // the sequence back, wedging the ring).
+        if (s.readers_left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            s.obs.reset();
+            s.seq.store(ticket + mask_ + 1, std::memory_order_release);
+        }
+        return obs;
+    }
+
+    /** Number of published observations not yet consumed by the slowest
+     *  consumer. Approximate (other threads keep moving), but good enough
+     *  as a backlog/overload signal. */
+    size_t max_backlog() const
+    {
+        const uint64_t head   = head_.load(std::memory_order_acquire);
+        uint64_t       minPos = head;
+        for (const auto& c : cursors_)
+            minPos = std::min(minPos, c->pos.load(std::memory_order_acquire));
+        return static_cast<size_t>(head - minPos);
+    }
+
+   private:
+    struct Slot
+    {
+        std::atomic<uint64_t> seq{0};
+        /** Consumers that have not read this lap of the slot yet; set by
+         * the producer before publishing, decremented once per consumer in
+         * poll(). The last reader (and only it) recycles the slot. */
+        std::atomic<uint32_t>        readers_left{0};
+        mrpt::obs::CObservation::Ptr obs;
+    };
+    struct Cursor
+    {
+        // Cache-line padding to avoid false sharing between consumers:
+        alignas(64) std::atomic<uint64_t> pos{0};
+    };
+
+    std::vector<Slot>                    slots_;
+    size_t                               mask_ = 0;
+    std::atomic<uint64_t>                head_{0};
+    std::vector<std::unique_ptr<Cursor>> cursors_;
+};
+
+}  // namespace mola
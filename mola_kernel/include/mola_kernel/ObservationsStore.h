@@ -0,0 +1,68 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ObservationsStore.h
+ * @brief  Content-addressed shared store of raw keyframe observations
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/obs/CObservation.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/serialization/CSerializable.h>
+
+#include <cstdint>
+
+namespace mola
+{
+/** Content-addressed, process-wide store of raw observations.
+ *
+ * Overlapping keyframes built from the same sensor burst often carry the
+ * very same observation; interning replaces such duplicates by one shared,
+ * refcounted instance, so the payload (e.g. a large point cloud) lives once
+ * in memory no matter how many keyframes reference it.
+ *
+ * The store holds only weak references: when the last keyframe drops an
+ * observation it is freed normally, and its entry is purged lazily.
+ *
+ * Lookup is two-level so the common (non-duplicate) path stays cheap: a
+ * hash of (class, sensorLabel, timestamp) selects a bucket, and the exact
+ * content hash (FNV-1a over the serialized bytes) is computed — once per
+ * instance, then cached — only when that bucket is non-empty, i.e. when a
+ * duplicate is actually suspected.
+ *
+ * Used by WorldModel::entity_emplace_back() and on keyframe
+ * deserialization; disable with env var `MOLA_DEDUP_OBSERVATIONS=false`.
+ *
+ * \sa KeyFrameBase \ingroup mola_kernel_grp */
+class ObservationsStore
+{
+   public:
+    /** Enabled unless env var `MOLA_DEDUP_OBSERVATIONS` is set to false */
+    static bool enabled();
+
+    /** Returns the canonical instance for this observation content: an
+     * already-interned identical one, or `obs` itself (interned now). */
+    static mrpt::obs::CObservation::Ptr intern(
+        const mrpt::obs::CObservation::Ptr& obs);
+
+    /** Interns every observation of a sensory frame in place, replacing
+     * duplicates by their canonical instances. */
+    static void internInPlace(mrpt::obs::CSensoryFrame& sf);
+
+    /** FNV-1a hash over the serialized bytes of the object */
+    static uint64_t contentHash(const mrpt::serialization::CSerializable& o);
+
+    struct Stats
+    {
+        uint64_t interned      = 0;  //!< Observations seen by intern()
+        uint64_t deduplicated  = 0;  //!< Replaced by an existing instance
+    };
+    static Stats stats();
+};
+
+}  // namespace mola
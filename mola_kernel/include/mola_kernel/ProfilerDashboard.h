@@ -0,0 +1,94 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ProfilerDashboard.h
+ * @brief  Module exporting all modules' profiler stats over HTTP
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 14, 2024
+ */
+#pragma once
+
+#include <mola_kernel/interfaces/ExecutableBase.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace mola
+{
+/** Live profiling dashboard: periodically snapshots the CTimeLogger of every
+ * running module and serves the aggregated stats on an embedded HTTP
+ * endpoint, so per-module latency can be watched during a mission instead of
+ * only in the stats dumped at shutdown (see ProfilerSaverAtDtor).
+ *
+ * Endpoints (plain GET, one request per connection):
+ *  - `/metrics`: Prometheus text format (`mola_profiler_*` metric families
+ *    with `module` and `entry` labels).
+ *  - any other path: one JSON document with all modules and entries.
+ *
+ * Exported per profiler entry: call count, call rate [Hz] since the previous
+ * snapshot, and min/mean/max/last call times [s]. (CTimeLogger keeps no
+ * histogram, so true percentiles are not available; min/mean/max bound the
+ * distribution.)
+ *
+ * Modules whose profiler is disabled report nothing; enable them globally
+ * from mola-cli or per module in their YAML config.
+ *
+ * Per-module heap accounting (see mola::MemoryAccounting) is exported too,
+ * as `mola_memory_*` metric families with a `module` label and a "memory"
+ * section of the JSON document.
+ *
+ * Launch-YAML parameters:
+ *  - `http_port`: (Default=8090) TCP port to listen on.
+ *  - `snapshot_period`: (Default=1.0) [s] Between profiler snapshots.
+ *
+ * \note The HTTP server requires a POSIX sockets platform; elsewhere the
+ * module logs a warning and only takes snapshots.
+ * \ingroup mola_kernel_grp
+ */
+class ProfilerDashboard : public ExecutableBase
+{
+    DEFINE_MRPT_OBJECT(ProfilerDashboard, mola)
+
+   public:
+    ProfilerDashboard();
+    ~ProfilerDashboard() override;
+
+    // Virtual interface of any ExecutableBase. See base docs:
+    void initialize(const Yaml& cfg) override final;
+    void spinOnce() override;
+
+    /** Launched last, so all other modules already exist when scanning. */
+    int launchOrderPriority() const override { return 90; }
+
+   private:
+    unsigned int http_port_       = 8090;
+    double       snapshot_period_ = 1.0;  //!< [s]
+
+    /** Takes one snapshot of all modules' profilers and re-renders the
+     * JSON & Prometheus payloads. */
+    void take_snapshot();
+
+    /** Pre-rendered payloads served verbatim by the HTTP thread */
+    std::string latest_json_ = "{}\n", latest_prom_;
+    std::mutex  latest_mtx_;
+
+    double lastSnapshotTime_ = 0;
+    /** Per "module/entry" call counts at the previous snapshot, to derive
+     * call rates */
+    std::map<std::string, uint64_t> lastCallCounts_;
+
+    // Minimal embedded HTTP server (one worker thread):
+    std::thread      http_thread_;
+    std::atomic_bool http_stop_{false};
+
+    void http_server_thread();
+};
+
+}  // namespace mola
@@ -0,0 +1,91 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   Tracer.h
+ * @brief  System-wide low-overhead tracing of cross-module latency chains
+ * @author Jose Luis Blanco Claraco
+ * @date   Apr 2, 2024
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace mola
+{
+/** System-wide tracing facility, complementing the per-module aggregate
+ * profilers: each traced scope becomes a span with a unique id and an
+ * optional parent id, so latency chains crossing module/thread boundaries
+ * (e.g. sensor -> front-end -> publish) can be reconstructed offline.
+ *
+ * Events are recorded into lock-free per-thread ring buffers (fixed-size,
+ * overwriting the oldest entries), so tracing is safe and cheap on hot
+ * paths. Enable it by setting the env var `MOLA_TRACE` to the output file
+ * name; the Chrome trace-format JSON (loadable in chrome://tracing, Perfetto
+ * or flamegraph tools) is written at program exit, or on demand with
+ * dumpToFile().
+ *
+ * \sa TraceSpan \ingroup mola_kernel_grp */
+class Tracer
+{
+   public:
+    /** Whether tracing is globally enabled (env var `MOLA_TRACE`) */
+    static bool enabled();
+
+    /** Allocates a new unique span id (thread-safe) */
+    static uint64_t newSpanId();
+
+    /** The innermost active span id of the calling thread (0 if none).
+     * Pass it along (e.g. together with an enqueued observation) to chain
+     * spans across threads. */
+    static uint64_t currentSpanId();
+
+    /** Records one complete span. Times are microseconds since the steady
+     * clock epoch. Normally called via TraceSpan, not directly. */
+    static void recordEvent(
+        const char* name, uint64_t t_start_us, uint64_t t_end_us,
+        uint64_t spanId, uint64_t parentId);
+
+    /** Writes all buffered events as Chrome trace-format JSON */
+    static void dumpToFile(const std::string& fileName);
+
+    /** Microseconds since the steady clock epoch */
+    static uint64_t nowUs();
+};
+
+/** RAII scoped span for Tracer: records begin/end timestamps and parent
+ * chaining. Does nothing (beyond one branch) if tracing is disabled.
+ * \ingroup mola_kernel_grp */
+class TraceSpan
+{
+   public:
+    /** Starts a span, chained to the calling thread's innermost active span
+     * (if any). `name` must outlive the span (e.g. a string literal or a
+     * module member). */
+    explicit TraceSpan(const char* name)
+        : TraceSpan(name, Tracer::currentSpanId())
+    {
+    }
+
+    /** Starts a span with an explicit parent, for cross-thread chains */
+    TraceSpan(const char* name, const uint64_t parentId);
+
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&)            = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+   private:
+    const char* name_     = nullptr;
+    uint64_t    t0_       = 0;
+    uint64_t    spanId_   = 0;
+    uint64_t    parentId_ = 0;
+    uint64_t    prevSpan_ = 0;
+    bool        active_   = false;
+};
+
+}  // namespace mola
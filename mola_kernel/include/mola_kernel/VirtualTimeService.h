@@ -0,0 +1,116 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   VirtualTimeService.h
+ * @brief  Logical replay clock for deterministic, faster-than-realtime runs
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mola
+{
+/** A shared logical ("virtual") clock for deterministic dataset replay.
+ *
+ * In normal operation dataset sources pace themselves against the wall
+ * clock; when the launcher is started with `launcher: {virtual_time: true}`
+ * it creates one instance of this service and injects it into every module
+ * (see ExecutableBase::virtual_time_). The dataset source then becomes the
+ * time master: it publishes each observation and advances the logical
+ * clock to its timestamp via advanceTo(), which acts as a barrier —
+ * blocking while previously published observations are still in flight to
+ * consumers — instead of sleeping. Downstream modules' rate timers key off
+ * now() rather than the wall clock (see
+ * ExecutableBase::waitForNextSpin()), so the whole system runs as fast as
+ * consumers can drain, with a spin/delivery ordering that does not depend
+ * on host load.
+ *
+ * \ingroup mola_kernel_grp */
+class VirtualTimeService
+{
+   public:
+    using Ptr = std::shared_ptr<VirtualTimeService>;
+
+    VirtualTimeService() = default;
+
+    /** Current logical time, in seconds. Starts at 0 and only moves via
+     * advanceTo(). */
+    double now() const
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        return t_;
+    }
+
+    /** Time master API (dataset sources): blocks while pending deliveries
+     * remain (the drain barrier), then publishes the new logical time and
+     * invokes every registered listener, so parked modules re-evaluate
+     * their logical deadlines. The barrier gives up after
+     * BARRIER_TIMEOUT_SECONDS so a consumer stopped mid-run (e.g. during
+     * shutdown) cannot deadlock the time master. */
+    void advanceTo(const double t)
+    {
+        std::vector<std::function<void()>> listeners;
+        {
+            std::unique_lock<std::mutex> lck(mtx_);
+            drainedCv_.wait_for(
+                lck,
+                std::chrono::duration<double>(BARRIER_TIMEOUT_SECONDS),
+                [this]() { return pendingWork_ == 0; });
+
+            if (t > t_) t_ = t;
+            listeners = onAdvance_;
+        }
+        for (const auto& cb : listeners) cb();
+    }
+
+    /** Pending-delivery accounting for the barrier in advanceTo();
+     * incremented when observations are published to asynchronous consumer
+     * queues and decremented upon delivery (see RawDataSourceBase). */
+    void addPendingWork(const size_t n)
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        pendingWork_ += n;
+    }
+    void removePendingWork(const size_t n)
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            pendingWork_ = (n <= pendingWork_) ? pendingWork_ - n : 0;
+            if (pendingWork_ != 0) return;
+        }
+        drainedCv_.notify_all();
+    }
+
+    /** Registers a callback run (from the advancing thread) after every
+     * clock advance; the launcher registers one per module to wake its
+     * waitForNextSpin(). */
+    void addOnAdvanceListener(const std::function<void()>& cb)
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        onAdvance_.push_back(cb);
+    }
+
+    static constexpr double BARRIER_TIMEOUT_SECONDS = 1.0;
+
+   private:
+    mutable std::mutex      mtx_;
+    std::condition_variable drainedCv_;
+
+    double t_           = 0;
+    size_t pendingWork_ = 0;
+
+    std::vector<std::function<void()>> onAdvance_;
+};
+
+}  // namespace mola
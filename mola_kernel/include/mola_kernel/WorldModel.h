@@ -17,9 +17,14 @@
 #include <mola_kernel/Yaml.h>
 #include <mola_kernel/id.h>
 #include <mola_kernel/interfaces/ExecutableBase.h>
+#include <mola_kernel/variant_helper.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <shared_mutex>
 
 namespace mola
@@ -27,7 +32,12 @@ namespace mola
 /** \addtogroup mola_kernel_grp
  * @{ */
 
-using entity_connected_factors_t = mola::fast_map<id_t, mola::fast_set<fid_t>>;
+/** Open-addressing map by entity id; the per-entity factor rows stay
+ * ordered (fast_set) since consumers expect sorted factor ids. Callers
+ * needing id-sorted traversal of the whole adjacency should go through
+ * WorldModel::entity_factors_adjacency(). */
+using entity_connected_factors_t =
+    mola::fast_unordered_map<id_t, mola::fast_set<fid_t>>;
 
 /** A serializable data container for all WorldModel data (i.e. a "map")
  */
@@ -54,8 +64,9 @@ class WorldModelData : public mrpt::serialization::CSerializable
     std::unique_ptr<FactorsContainer> factors_;
     std::shared_mutex                 factors_mtx_;
 
-    mutable mola::fast_map<id_t, mrpt::Clock::time_point> entity_last_access_;
-    std::shared_mutex entity_last_access_mtx_;
+    // Note: last-access times for the LRU/aging unload policies are stored
+    // per entity (EntityBase::last_access_epoch_, atomic), so entity reads
+    // perform no locking for that bookkeeping.
 };
 
 /** The main class for a "map" or "world model".
@@ -80,6 +91,19 @@ class WorldModel : public ExecutableBase
     struct Parameters
     {
         double age_to_unload_keyframes{15.0};  //!< [s]
+
+        /** If >0, replaces the age-based policy above: entities are unloaded
+         * in least-recently-used order whenever the estimated resident
+         * memory of loaded entities exceeds this budget [bytes], so hot
+         * loop-closure candidates stay in RAM regardless of their age. */
+        uint64_t max_resident_memory{0};
+
+        /** Graph-aware prefetch: when an entity access hits an unloaded
+         * (swapped-off) entity, its factor-graph neighbors within this hop
+         * radius are loaded asynchronously by a background worker, hiding
+         * disk latency behind the optimization work that will touch them
+         * next (e.g. during loop closure). 0 disables prefetching. */
+        unsigned int prefetch_hop_radius{1};
     };
 
     Parameters params_;
@@ -100,6 +124,35 @@ class WorldModel : public ExecutableBase
 
     void map_save_to(const std::string& fileName) const;
 
+    /** Saves the map in the "indexed" format: a table of contents with
+     * per-entity/per-factor file offsets, so map_load_from() can deserialize
+     * the payloads in parallel across a thread pool. Uncompressed, seekable
+     * (unlike the gz stream format of map_save_to()). */
+    void map_save_to_indexed(const std::string& fileName) const;
+
+    /** Loads a map written by map_save_to_indexed(), deserializing entities
+     * and factors in parallel. Note that map_load_from(fileName) auto-detects
+     * the format, so calling this directly is rarely needed. */
+    void map_load_from_indexed(const std::string& fileName);
+
+    /** Incremental checkpointing: writes all entities & factors inserted
+     * since the last checkpoint as a numbered delta file under
+     * `<map_base_directory>/checkpoints/`, serialized from a background
+     * thread so the SLAM pipeline is never frozen. Cost is proportional to
+     * recent changes, not total map size. No-op if nothing changed. */
+    void map_checkpoint_delta();
+
+    /** Compaction: waits for pending delta writes, saves one full-map
+     * snapshot to the given file, and removes the now-redundant delta
+     * files. */
+    void map_checkpoint_compact(const std::string& fileName);
+
+    /** Replays one delta file (as written by map_checkpoint_delta()) on top
+     * of the current map contents. Deltas must be applied in order over the
+     * base snapshot they were journaled against.
+     * \exception std::runtime_error on id mismatches or I/O errors. */
+    void map_apply_delta(const std::string& fileName);
+
     /** Returns the directory where entities will be swapped-off to disk when
      * unloaded, i.e. the map database directory.
      * This directory is built at construction from `MOLA_MAP_STORAGE_DIR` and
@@ -111,6 +164,11 @@ class WorldModel : public ExecutableBase
 
     /** @name Main map content API
      * @{ */
+
+    /** \note With the default `sharded` map container (see
+     * `map_container_type` param), id-based lookups/insertions are internally
+     * synchronized per-shard, and these coarse-grained locks are only needed
+     * (as a compatibility wrapper) by code that iterates the whole map. */
     void entities_lock_for_read() { data_.entities_mtx_.lock_shared(); }
     void entities_unlock_for_read() { data_.entities_mtx_.unlock_shared(); }
     void entities_lock_for_write() { data_.entities_mtx_.lock(); }
@@ -124,6 +182,61 @@ class WorldModel : public ExecutableBase
     const Entity& entity_by_id(const id_t id) const;
     Entity&       entity_by_id(const id_t id);
 
+    /** Scoped, refcounted pin over one entity (see EntityBase::pin()): for
+     * the lifetime of the handle the unload sweep cannot swap the entity
+     * off, so e.g. the backend can hold pins on the keyframes of a
+     * loop-closure batch while optimizing them without globally disabling
+     * the working-set manager. Move-only; obtain it via entity_pin(). */
+    class EntityPin
+    {
+       public:
+        EntityPin() = default;
+        ~EntityPin() { release(); }
+
+        EntityPin(const EntityPin&)            = delete;
+        EntityPin& operator=(const EntityPin&) = delete;
+
+        EntityPin(EntityPin&& o) noexcept
+            : wm_(o.wm_), id_(o.id_), entity_(o.entity_)
+        {
+            o.wm_     = nullptr;
+            o.entity_ = nullptr;
+        }
+        EntityPin& operator=(EntityPin&& o) noexcept
+        {
+            if (this != &o)
+            {
+                release();
+                wm_       = o.wm_;
+                id_       = o.id_;
+                entity_   = o.entity_;
+                o.wm_     = nullptr;
+                o.entity_ = nullptr;
+            }
+            return *this;
+        }
+
+        id_t id() const { return id_; }
+
+        Entity&       get();
+        const Entity& get() const;
+
+        /** Drops the pin before the handle goes out of scope. */
+        void release();
+
+       private:
+        friend class WorldModel;
+        EntityPin(WorldModel& wm, id_t id);
+
+        WorldModel* wm_     = nullptr;
+        id_t        id_     = INVALID_ID;
+        Entity*     entity_ = nullptr;
+    };
+
+    /** Looks up the given entity and returns a scoped pin on it (see
+     * EntityPin). \exception std::exception if the id does not exist. */
+    EntityPin entity_pin(const id_t id) { return EntityPin(*this, id); }
+
     const Factor& factor_by_id(const fid_t id) const;
     Factor&       factor_by_id(const fid_t id);
 
@@ -133,9 +246,65 @@ class WorldModel : public ExecutableBase
     id_t  entity_push_back(const Entity& e);
     fid_t factor_push_back(const Factor& f);
 
+    /** Bulk factor insertion, for e.g. multi-hundred-factor loop-closure
+     * batches: takes the factors write lock exactly once for the whole
+     * batch (so readers are blocked for one short interval instead of once
+     * per factor), inserts all factors, updates the
+     * entity -> connected-factors adjacency in the same pass, and journals
+     * them in one go. Returns the assigned ids, in input order. The input
+     * vector is consumed (moved-from).
+     *
+     * \note Callers must NOT hold factors_lock_for_write(); this method
+     * acquires it itself, like factor_emplace_back() callers do around each
+     * single insertion. */
+    std::vector<fid_t> factors_emplace_batch(std::vector<Factor>&& fs);
+
     std::vector<id_t>  entity_all_ids() const;
     std::vector<fid_t> factor_all_ids() const;
 
+    /** Visits all entities without holding any map lock during the visit:
+     * a point-in-time, id-sorted snapshot of (id, pointer) pairs is taken
+     * first (brief per-shard shared locks with the default `sharded`
+     * container), then the visitor runs over that contiguous array in id
+     * order. Storage is node/deque-based and entities are never erased
+     * in-place, so the references stay valid and writers can keep
+     * inserting concurrently; entities inserted after the snapshot are
+     * simply not visited. Prefer this over entity_all_ids() + per-id
+     * lookups under entities_lock_for_read(). */
+    void entities_visit_all(
+        const std::function<void(const id_t, const Entity&)>& visitor) const;
+
+    /** Like entities_visit_all(), for factors. */
+    void factors_visit_all(
+        const std::function<void(const fid_t, const Factor&)>& visitor) const;
+
+    /** Sweeps only the entities holding the variant alternative `T`, e.g.
+     * `entities_visit_by_type<RelPose3KF>([](id_t id, const RelPose3KF& kf)
+     * {...});`. The containers bucket ids by variant alternative at
+     * insertion time, so the sweep touches only the entities of that type
+     * and runs as one tight monomorphic loop, with no per-element
+     * std::visit dispatch. Snapshot/locking semantics are those of
+     * entities_visit_all(). The rare entity whose alternative was switched
+     * in-place after insertion is skipped. */
+    template <typename T, typename VISITOR>
+    void entities_visit_by_type(VISITOR&& visitor) const
+    {
+        const auto snap =
+            entities_snapshot_of_type(variant_index<Entity, T>());
+        for (const auto& [id, e] : snap)
+            if (const T* v = std::get_if<T>(e)) visitor(id, *v);
+    }
+
+    /** Like entities_visit_by_type(), for factors. */
+    template <typename T, typename VISITOR>
+    void factors_visit_by_type(VISITOR&& visitor) const
+    {
+        const auto snap =
+            factors_snapshot_of_type(variant_index<Factor, T>());
+        for (const auto& [id, f] : snap)
+            if (const T* v = std::get_if<T>(f)) visitor(id, *v);
+    }
+
     annotations_data_t&       entity_annotations_by_id(const id_t id);
     const annotations_data_t& entity_annotations_by_id(const id_t id) const;
 
@@ -144,23 +313,140 @@ class WorldModel : public ExecutableBase
      */
     std::set<id_t> entity_neighbors(const id_t id) const;
 
+    /** Time-window query over a secondary timestamp index: returns the ids
+     * of all entities whose EntityBase timestamp falls within [t0, t1]
+     * (inclusive), in ascending time order, in O(log n + k). The index is
+     * maintained upon insertion as a sorted vector plus a small unsorted
+     * tail merged in (amortized) on the next query, so trajectory
+     * extraction and reporting no longer scan all entities. Entities with
+     * an unset (default) timestamp are not indexed. */
+    std::vector<id_t> entities_in_time_range(
+        const mrpt::Clock::time_point& t0,
+        const mrpt::Clock::time_point& t1) const;
+
+    /** CSR-style (compressed sparse row) compiled view of the
+     * entity -> connected-factors adjacency: all per-entity factor lists are
+     * stored contiguously in one flat array, so backends iterating a
+     * keyframe's factors (e.g. during marginalization) walk linear memory
+     * instead of chasing tree nodes. Build it with
+     * entity_factors_adjacency(). */
+    struct EntityFactorsAdjacency
+    {
+        std::vector<id_t>        entity_ids;  //!< sorted ascending
+        std::vector<std::size_t> row_start;   //!< entity_ids.size()+1 offsets
+        std::vector<fid_t>       factor_ids;  //!< concatenated rows
+
+        /** [begin,end) of the factors of the i-th entity in entity_ids */
+        std::pair<const fid_t*, const fid_t*> row(const std::size_t i) const
+        {
+            return {
+                factor_ids.data() + row_start[i],
+                factor_ids.data() + row_start[i + 1]};
+        }
+    };
+
+    /** Bulk-rebuilds and returns a CSR adjacency snapshot from the current
+     * entity_connected_factors_ data (one pass, one allocation per array). */
+    EntityFactorsAdjacency entity_factors_adjacency() const;
+
+    /** Bulk id remap, for multi-robot map merging: rewrites every key and
+     * factor reference of the entity -> connected-factors adjacency (plus
+     * the LRU bookkeeping) in one linear pass, applying the given old->new
+     * id transformations. With the partitioned id scheme of id.h, each
+     * lambda is typically just `make_robot_id(robot, id)`, so re-tagging a
+     * whole robot's map is a single O(map) pass instead of one hash lookup
+     * per reference.
+     *
+     * \note The ids stored inside each factor (FactorBase::my_id_ and its
+     * edge_indices()) belong to the concrete factor classes and are not
+     * touched here; remap them while inserting the factors into the merged
+     * map. */
+    void entity_factors_remap_ids(
+        const std::function<id_t(id_t)>&   entityIdMap,
+        const std::function<fid_t(fid_t)>& factorIdMap);
+
     /** @} */
 
    private:
     /** All map data */
     WorldModelData data_;
 
+    /** Coarse access-epoch counter: seconds since map construction,
+     * refreshed once per spinOnce(). See EntityBase::last_access_epoch_. */
+    std::atomic<std::uint32_t>    access_epoch_now_{0};
+    const mrpt::Clock::time_point access_epoch_base_ = mrpt::Clock::now();
+
+    /** Lock-free LRU touch: stamps the entity with the current access
+     * epoch. Relaxed on both sides; the unload sweep only needs a coarse,
+     * eventually-consistent view. */
+    void internal_touch_entity(const EntityBase& eb) const noexcept
+    {
+        eb.last_access_epoch_.store(
+            access_epoch_now_.load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+
+    /** Id-sorted (id, pointer) snapshot of the entities whose variant held
+     * the given alternative index at insertion time (non-template bridge
+     * for entities_visit_by_type(), since the container types are opaque
+     * here). */
+    std::vector<std::pair<id_t, const Entity*>> entities_snapshot_of_type(
+        std::size_t variantTypeIndex) const;
+
+    /** Like entities_snapshot_of_type(), for factors. */
+    std::vector<std::pair<fid_t, const Factor*>> factors_snapshot_of_type(
+        std::size_t variantTypeIndex) const;
+
     std::string map_base_dir_;
 
+    /** Journal of insertions since the last checkpoint (see
+     * map_checkpoint_delta()) */
+    std::vector<id_t>        journal_new_entities_;
+    std::vector<fid_t>       journal_new_factors_;
+    std::vector<std::string> checkpoint_delta_files_;
+    unsigned int             checkpoint_seq_ = 0;
+    std::mutex               journal_mtx_;
+
+    mrpt::WorkerThreadsPool checkpoint_pool_{
+        1, mrpt::WorkerThreadsPool::POLICY_FIFO, "worldmodel_checkpoints"};
+
+    mrpt::WorkerThreadsPool prefetch_pool_{
+        1, mrpt::WorkerThreadsPool::POLICY_FIFO, "worldmodel_prefetch"};
+
+    /** Enqueues background loads of the factor-graph neighbors of `id`
+     * within Parameters::prefetch_hop_radius hops (see that param). Called
+     * upon lazy-load misses; cheap no-op when prefetching is disabled or
+     * the worker is already backlogged. */
+    void internal_prefetch_neighbors(const id_t id);
+
     /** Returns a list with all those entities that have not been accessed in
-     * `age_to_unload_keyframes`. Once an entity is reported as "aged", it's
-     * removed from the list of entities to watch, so it will be not reported
-     * again unless re-loaded. */
+     * `age_to_unload_keyframes`, or, if `max_resident_memory` is set, the
+     * least-recently-used entities whose eviction brings the resident-memory
+     * estimate back under budget. Once an entity is reported, it's removed
+     * from the list of entities to watch, so it will be not reported again
+     * unless re-loaded. */
     std::vector<id_t> findEntitiesToSwapOff();
 
     /** Updates entity_connected_factors_ within each call to
-     * factor_emplace_back() */
+     * factor_emplace_back() / factors_emplace_batch() */
     void internal_update_neighbors(const FactorBase& f);
+
+    /** Secondary time -> id index (see entities_in_time_range()): a sorted
+     * main vector plus an unsorted insertion tail, merged in on query.
+     * Mutable: consolidation happens inside const queries. */
+    mutable std::vector<std::pair<mrpt::Clock::time_point, id_t>>
+        time_index_sorted_;
+    mutable std::vector<std::pair<mrpt::Clock::time_point, id_t>>
+                       time_index_pending_;
+    mutable std::mutex time_index_mtx_;
+
+    /** Appends one entry to the index tail; no-op for unset timestamps. */
+    void internal_time_index_add(
+        const mrpt::Clock::time_point& t, const id_t id);
+
+    /** Rebuilds the whole index from the current entities (used after bulk
+     * map loads, which bypass entity_emplace_back()). */
+    void internal_time_index_rebuild();
 };
 
 /** @} */
@@ -13,9 +13,67 @@
 
 #include <mrpt/containers/yaml.h>
 
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
 namespace mola
 {
 /** Convenient typedef to save typing in the MOLA project. */
 using Yaml = mrpt::containers::yaml;
 
+/** One entry of a declarative parameter table: binds a YAML key to one
+ * member of a module parameter struct. Create entries with mola::param()
+ * and group them with mola::param_table().
+ * \ingroup mola_kernel_grp */
+template <class Struct, typename T>
+struct ParamBinding
+{
+    const char* name;
+    T Struct::*member;
+};
+
+/** Deduction helper for ParamBinding. \sa param_table */
+template <class Struct, typename T>
+constexpr ParamBinding<Struct, T> param(const char* name, T Struct::*member)
+{
+    return {name, member};
+}
+
+/** Groups param() entries into a constexpr parameter descriptor table, so
+ * a module describes its parameters exactly once, next to the struct:
+ * \code
+ * struct Params { double rate = 10.0; bool enabled = true; };
+ * static constexpr auto PARAMS_TABLE = mola::param_table(
+ *     mola::param("rate", &Params::rate),
+ *     mola::param("enabled", &Params::enabled));
+ * \endcode
+ * \sa load_params \ingroup mola_kernel_grp */
+template <typename... Entries>
+constexpr auto param_table(Entries... entries)
+{
+    return std::make_tuple(entries...);
+}
+
+/** Bulk-parses a YAML map into a parameter struct, as described by its
+ * param_table(): each key present in `cfg` overwrites the corresponding
+ * struct member; absent keys keep the member's default initializer. Meant
+ * to run once in initialize(), so runtime code only ever touches plain
+ * struct members and YAML access stays out of the spin paths.
+ * \ingroup mola_kernel_grp */
+template <class Struct, typename... Entries>
+void load_params(
+    Struct& s, const std::tuple<Entries...>& table,
+    const mrpt::containers::yaml& cfg)
+{
+    auto loadOne = [&](const auto& entry)
+    {
+        using member_t =
+            std::decay_t<decltype(std::declval<Struct&>().*(entry.member))>;
+        if (cfg.has(entry.name))
+            s.*(entry.member) = cfg[entry.name].template as<member_t>();
+    };
+    std::apply([&](const auto&... entry) { (loadOne(entry), ...); }, table);
+}
+
 };  // namespace mola
@@ -16,7 +16,10 @@
 #include <mrpt/core/Clock.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <memory>
 
 namespace mola
 {
@@ -38,6 +41,14 @@ class EntityBase : public mrpt::serialization::CSerializable
     EntityBase();
     virtual ~EntityBase();
 
+    // Annotations are deep-copied (see annotations()). Custom move
+    // operations exist only because of the atomics last_access_epoch_ and
+    // pin_count_ (the latter is never propagated; see pin()):
+    EntityBase(const EntityBase& o);
+    EntityBase& operator=(const EntityBase& o);
+    EntityBase(EntityBase&& o) noexcept;
+    EntityBase& operator=(EntityBase&& o) noexcept;
+
     /** The unique ID of this entity in the world model.
      * Stored here for convenience, notice that it is redundant since entities
      * are already stored in the WorldModel indexed by ID.
@@ -47,18 +58,55 @@ class EntityBase : public mrpt::serialization::CSerializable
     /** Entity creation timestamp */
     mrpt::Clock::time_point timestamp_{};
 
-    /** See annotations_data_t */
-    annotations_data_t annotations_;
+    /** Coarse last-access stamp for the WorldModel LRU/aging unload
+     * policies: the value of WorldModel's access-epoch counter (seconds
+     * since map start, refreshed once per spin) at the last read of this
+     * entity. Written with relaxed atomic stores so touching an entity on
+     * the hot read path involves no lock at all; sampled by the unload
+     * sweep. Not serialized. */
+    mutable std::atomic<std::uint32_t> last_access_epoch_{0};
+
+    /** See annotations_data_t. The map is allocated on first use: most
+     * entities carry no annotations at all, and the indirection keeps the
+     * inline entity record in a mola::Entity variant small. */
+    annotations_data_t& annotations();
+
+    /** Read-only version; returns a reference to an empty map if no
+     * annotation was ever created. */
+    const annotations_data_t& annotations() const;
 
     void load();
     void unload();
     bool is_unloaded() const;
 
+    /** Pins this entity in memory: while the refcounted pin count is
+     * nonzero, unload() is a no-op and the WorldModel eviction sweep skips
+     * the entity altogether, so e.g. the backend cannot have a keyframe
+     * swapped off from under it mid-optimization. Pair every pin() with
+     * exactly one unpin(); prefer the scoped WorldModel::EntityPin handle.
+     * The count is held on this instance and is not copied, moved, nor
+     * serialized. */
+    void pin() const { pin_count_.fetch_add(1, std::memory_order_relaxed); }
+
+    void unpin() const { pin_count_.fetch_sub(1, std::memory_order_relaxed); }
+
+    bool is_pinned() const
+    {
+        return pin_count_.load(std::memory_order_relaxed) > 0;
+    }
+
    protected:
     // Derived classes mus call these methods to serialize the common data in
     // this base class:
     void baseSerializeTo(mrpt::serialization::CArchive& out) const;
     void baseSerializeFrom(mrpt::serialization::CArchive& in);
+
+   private:
+    /** Lazily-allocated; see annotations() */
+    std::unique_ptr<annotations_data_t> annotations_;
+
+    /** See pin(). */
+    mutable std::atomic<std::uint32_t> pin_count_{0};
 };
 
 }  // namespace mola
@@ -30,6 +30,11 @@ namespace mola
 class KeyFrameBase
 {
    public:
+    /** Raw observations of this keyframe. Entries are shared, refcounted
+     * instances: on insertion into a WorldModel (and on map load) they are
+     * interned through mola::ObservationsStore, so an observation
+     * duplicated across overlapping keyframes is stored in memory only
+     * once. */
     mrpt::obs::CSensoryFrame::Ptr raw_observations_;
 };
 
@@ -0,0 +1,156 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   KeyFramePODRecords.h
+ * @brief  Fixed-layout POD records for bulk keyframe (de)serialization
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mola_kernel/entities/RelDynPose3KF.h>
+#include <mola_kernel/entities/RelPose3KF.h>
+
+#include <cstddef>  // offsetof
+#include <cstdint>
+#include <type_traits>
+
+namespace mola
+{
+/** @name Fixed-layout POD records for keyframe entities
+ *
+ * Plain RelPose3KF / RelDynPose3KF entities make up the bulk of the entity
+ * table of typical maps, and writing them field-by-field through the
+ * CArchive virtual stream interface dominates map_save_to()/map_load_from()
+ * once the heavy point payloads are stored externally. These records mirror
+ * the persisted state of those types in a fixed, static_assert-verified
+ * layout, so whole entity tables are written and read back as single
+ * buffers (see WorldModelData::serializeTo(), stream version 1).
+ *
+ * Keyframes carrying annotations or in-memory raw observations do not fit
+ * the records and keep the generic per-object CArchive path, as do all
+ * other entity types.
+ *
+ * All fields are 8-byte scalars in the machine native byte order, like the
+ * raw offsets of the indexed map file format.
+ * @{ */
+
+/** Bump whenever any record layout below changes: */
+constexpr uint16_t KF_POD_FORMAT_VERSION = 0;
+
+/** Persisted state of a RelPose3KF without annotations/observations. */
+struct RelPose3KFRecord
+{
+    uint64_t id        = 0;  //!< EntityBase::my_id_
+    uint64_t base_id   = 0;  //!< EntityRelativeBase::base_id_
+    int64_t  timestamp = 0;  //!< EntityBase::timestamp_, raw clock count
+
+    double x = 0, y = 0, z = 0;  //!< relpose_value translation [m]
+    double yaw = 0, pitch = 0, roll = 0;  //!< relpose_value rotation [rad]
+};
+
+static_assert(std::is_trivially_copyable_v<RelPose3KFRecord>);
+static_assert(sizeof(RelPose3KFRecord) == 9 * sizeof(uint64_t));
+static_assert(offsetof(RelPose3KFRecord, base_id) == 8);
+static_assert(offsetof(RelPose3KFRecord, timestamp) == 16);
+static_assert(offsetof(RelPose3KFRecord, x) == 24);
+static_assert(offsetof(RelPose3KFRecord, roll) == 64);
+
+/** Persisted state of a RelDynPose3KF without annotations. */
+struct RelDynPose3KFRecord
+{
+    uint64_t id        = 0;  //!< EntityBase::my_id_
+    uint64_t base_id   = 0;  //!< EntityRelativeBase::base_id_
+    int64_t  timestamp = 0;  //!< EntityBase::timestamp_, raw clock count
+
+    double x = 0, y = 0, z = 0;  //!< relpose_value translation [m]
+    double yaw = 0, pitch = 0, roll = 0;  //!< relpose_value rotation [rad]
+
+    double vx = 0, vy = 0, vz = 0;  //!< twist_value linear vel. [m/s]
+    double wx = 0, wy = 0, wz = 0;  //!< twist_value angular vel. [rad/s]
+};
+
+static_assert(std::is_trivially_copyable_v<RelDynPose3KFRecord>);
+static_assert(sizeof(RelDynPose3KFRecord) == 15 * sizeof(uint64_t));
+static_assert(offsetof(RelDynPose3KFRecord, x) == 24);
+static_assert(offsetof(RelDynPose3KFRecord, vx) == 72);
+static_assert(offsetof(RelDynPose3KFRecord, wz) == 112);
+
+/** True if the persisted state of the keyframe fits its POD record. */
+inline bool fits_pod_record(const RelPose3KF& kf)
+{
+    return kf.annotations().empty() && !kf.raw_observations_;
+}
+
+/** \overload (RelDynPose3KF never persists its raw observations, so only
+ * annotations disqualify it) */
+inline bool fits_pod_record(const RelDynPose3KF& kf)
+{
+    return kf.annotations().empty();
+}
+
+inline RelPose3KFRecord to_pod_record(const RelPose3KF& kf)
+{
+    RelPose3KFRecord r;
+    r.id        = kf.my_id_;
+    r.base_id   = kf.base_id_;
+    r.timestamp = kf.timestamp_.time_since_epoch().count();
+    r.x         = kf.relpose_value.x;
+    r.y         = kf.relpose_value.y;
+    r.z         = kf.relpose_value.z;
+    r.yaw       = kf.relpose_value.yaw;
+    r.pitch     = kf.relpose_value.pitch;
+    r.roll      = kf.relpose_value.roll;
+    return r;
+}
+
+inline RelPose3KF from_pod_record(const RelPose3KFRecord& r)
+{
+    RelPose3KF kf;
+    kf.my_id_   = r.id;
+    kf.base_id_ = r.base_id;
+    kf.timestamp_ =
+        mrpt::Clock::time_point(mrpt::Clock::duration(r.timestamp));
+    kf.relpose_value = {r.x, r.y, r.z, r.yaw, r.pitch, r.roll};
+    return kf;
+}
+
+inline RelDynPose3KFRecord to_pod_record(const RelDynPose3KF& kf)
+{
+    RelDynPose3KFRecord r;
+    r.id        = kf.my_id_;
+    r.base_id   = kf.base_id_;
+    r.timestamp = kf.timestamp_.time_since_epoch().count();
+    r.x         = kf.relpose_value.x;
+    r.y         = kf.relpose_value.y;
+    r.z         = kf.relpose_value.z;
+    r.yaw       = kf.relpose_value.yaw;
+    r.pitch     = kf.relpose_value.pitch;
+    r.roll      = kf.relpose_value.roll;
+    r.vx        = kf.twist_value.vx;
+    r.vy        = kf.twist_value.vy;
+    r.vz        = kf.twist_value.vz;
+    r.wx        = kf.twist_value.wx;
+    r.wy        = kf.twist_value.wy;
+    r.wz        = kf.twist_value.wz;
+    return r;
+}
+
+inline RelDynPose3KF from_pod_record(const RelDynPose3KFRecord& r)
+{
+    RelDynPose3KF kf;
+    kf.my_id_   = r.id;
+    kf.base_id_ = r.base_id;
+    kf.timestamp_ =
+        mrpt::Clock::time_point(mrpt::Clock::duration(r.timestamp));
+    kf.relpose_value = {r.x, r.y, r.z, r.yaw, r.pitch, r.roll};
+    kf.twist_value   = {r.vx, r.vy, r.vz, r.wx, r.wy, r.wz};
+    return kf;
+}
+
+/** @} */
+
+}  // namespace mola
@@ -12,8 +12,11 @@
 #pragma once
 
 #include <mola_kernel/factors/FactorBase.h>
+#include <mrpt/math/CMatrixFixed.h>
+#include <mrpt/math/TPoint3D.h>
 
 #include <deque>
+#include <optional>
 
 namespace mola
 {
@@ -53,8 +56,51 @@ class SmartFactorIMU : public FactorBase
     double     ax_, ay_, az_, wx_, wy_, wz_, dt_;
     mola::id_t prev_pose_kf_, new_pose_kf_;
 
+    /** One raw IMU sample, buffered so the preintegrated delta can be
+     * recomputed at a new bias linearization point. */
+    struct ImuSample
+    {
+        double ax, ay, az, wx, wy, wz, dt;
+    };
+
+    /** Preintegrated IMU delta of the current window (all samples since
+     * the last createIMUFactor()), valid at the bias linearization point
+     * it was computed with. */
+    struct PreintegratedDelta
+    {
+        mrpt::math::CMatrixDouble33 deltaR;  //!< body_i -> body_j rotation
+        mrpt::math::TVector3D       deltaV = {0, 0, 0};
+        mrpt::math::TVector3D       deltaP = {0, 0, 0};
+        double                      deltaT = 0;  //!< [s]
+
+        /** Bias linearization point used to correct the raw samples */
+        mrpt::math::TVector3D biasAcc = {0, 0, 0}, biasGyr = {0, 0, 0};
+    };
+
+    /** Returns the preintegrated delta of the current measurement window
+     * at the given bias linearization point. The cached delta is reused
+     * (and kept incrementally up to date by integrateMeasurement()) while
+     * the requested biases stay within `bias_reuse_epsilon_` (inf-norm) of
+     * the cached linearization point; only when the bias estimate moves
+     * beyond that tolerance is the whole window re-preintegrated. */
+    const PreintegratedDelta& preintegrated(
+        const mrpt::math::TVector3D& biasAcc,
+        const mrpt::math::TVector3D& biasGyr);
+
+    /** Bias change (inf-norm, either accelerometer [m/s^2] or gyroscope
+     * [rad/s]) beyond which preintegrated() discards the cached delta. */
+    double bias_reuse_epsilon_ = 1.0e-3;
+
    private:
     BackEndBase* slam_backend_{nullptr};
+
+    /** Raw samples of the current window, for re-preintegration */
+    std::deque<ImuSample> samples_;
+
+    std::optional<PreintegratedDelta> cached_delta_;
+
+    /** Folds one sample into a delta (Euler step on SO(3) x R^6) */
+    static void foldSample(PreintegratedDelta& d, const ImuSample& m);
 };
 
 }  // namespace mola
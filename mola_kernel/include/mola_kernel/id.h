@@ -28,4 +28,46 @@ constexpr id_t INVALID_ID = std::numeric_limits<id_t>::max();
 /** A numeric value for invalid IDs. \ingroup mola_kernel_grp */
 constexpr fid_t INVALID_FID = std::numeric_limits<fid_t>::max();
 
+/** @name Partitioned ids for multi-robot setups
+ *
+ * The top ID_ROBOT_PREFIX_BITS bits of an id_t/fid_t can carry a "robot
+ * prefix", leaving the rest as a robot-local counter. Ids minted with
+ * distinct prefixes never collide, so merging maps from several robots
+ * needs no per-reference remapping table: re-tagging an id is one
+ * constant-time bit operation (see WorldModel::entity_factors_remap_ids()
+ * for the bulk adjacency rewrite).
+ *
+ * Prefix 0 is what plain sequential ids naturally use (single-robot
+ * setups are unaffected); the all-ones prefix is reserved, since
+ * INVALID_ID/INVALID_FID live in that range.
+ * @{ */
+
+/** Bits of an id reserved for the robot prefix \ingroup mola_kernel_grp */
+constexpr unsigned int ID_ROBOT_PREFIX_BITS = 8;
+
+/** Bits of an id left for the robot-local counter \ingroup mola_kernel_grp */
+constexpr unsigned int ID_LOCAL_BITS = 64 - ID_ROBOT_PREFIX_BITS;
+
+/** Mask selecting the robot-local counter part \ingroup mola_kernel_grp */
+constexpr id_t ID_LOCAL_MASK = (id_t(1) << ID_LOCAL_BITS) - 1;
+
+/** Composes a partitioned id from a robot prefix and a local counter.
+ * \ingroup mola_kernel_grp */
+constexpr id_t make_robot_id(const uint8_t robot, const id_t localId)
+{
+    return (id_t(robot) << ID_LOCAL_BITS) | (localId & ID_LOCAL_MASK);
+}
+
+/** Extracts the robot prefix of a partitioned id \ingroup mola_kernel_grp */
+constexpr uint8_t id_robot_prefix(const id_t id)
+{
+    return static_cast<uint8_t>(id >> ID_LOCAL_BITS);
+}
+
+/** Extracts the robot-local counter of a partitioned id
+ * \ingroup mola_kernel_grp */
+constexpr id_t id_local_part(const id_t id) { return id & ID_LOCAL_MASK; }
+
+/** @} */
+
 }  // namespace mola
@@ -88,6 +88,50 @@ class BackEndBase : public ExecutableBase
         return slam_be_threadpool_.enqueue(&BackEndBase::doAddFactor, this, f);
     }
 
+    struct Update_Input
+    {
+        /** Optional new KeyFrame proposal. */
+        std::optional<ProposeKF_Input> new_kf{std::nullopt};
+
+        /** Constraint factors, typically involving the new KF. */
+        std::vector<Factor> factors;
+    };
+
+    struct Update_Output
+    {
+        ProposeKF_Output              kf;
+        std::vector<AddFactor_Output> factors;  //!< One per input factor
+    };
+
+    /** Transaction handle for batched submissions; see beginUpdate(). */
+    class Update
+    {
+       public:
+        void setKeyFrame(const ProposeKF_Input& i) { data_.new_kf = i; }
+
+        /** Note that the object is **moved**, as in addFactor(). */
+        void addFactor(Factor& f) { data_.factors.emplace_back(std::move(f)); }
+
+        /** Enqueues the whole transaction as one work unit and returns its
+         * (single) future. Must be called exactly once. */
+        std::future<Update_Output> commit();
+
+       private:
+        friend class BackEndBase;
+        explicit Update(BackEndBase& be) : be_(&be) {}
+
+        BackEndBase* be_;
+        Update_Input data_;
+        bool         committed_ = false;
+    };
+
+    /** Transactional alternative to addKeyFrame()+addFactor(): one keyframe
+     * and all its factors are packaged into a single queued work unit,
+     * resolved by a single future, so front-ends emitting a KF plus a dozen
+     * factors pay one promise allocation and one worker wake-up instead of
+     * one per item. The back-end processes the batch in doUpdate(). */
+    Update beginUpdate() { return Update(*this); }
+
     struct AdvertiseUpdatedLocalization_Input
     {
         /** The timestamp associated to the new Key-Frame. Must be valid. */
@@ -143,6 +187,19 @@ class BackEndBase : public ExecutableBase
     virtual AddFactor_Output doAddFactor(Factor& f)                  = 0;
     virtual void             doAdvertiseUpdatedLocalization(
                     const AdvertiseUpdatedLocalization_Input& l) = 0;
+
+    /** Processes one committed transaction (see beginUpdate()). The default
+     * implementation just runs doAddKeyFrame() and doAddFactor() back to
+     * back; back-ends may override it to handle the whole batch in one
+     * optimized pass (e.g. a single world-model lock or solver update). */
+    virtual Update_Output doUpdate(Update_Input& in)
+    {
+        Update_Output o;
+        if (in.new_kf) o.kf = doAddKeyFrame(*in.new_kf);
+        o.factors.reserve(in.factors.size());
+        for (auto& f : in.factors) o.factors.push_back(doAddFactor(f));
+        return o;
+    }
     /** @} */
 
    protected:
@@ -152,4 +209,15 @@ class BackEndBase : public ExecutableBase
         2, mrpt::WorkerThreadsPool::POLICY_FIFO, "slam_backend"};
 };
 
+inline std::future<BackEndBase::Update_Output> BackEndBase::Update::commit()
+{
+    ASSERTMSG_(!committed_, "commit() called twice on the same Update");
+    committed_ = true;
+
+    // One shared work unit for the whole transaction:
+    auto data = std::make_shared<Update_Input>(std::move(data_));
+    return be_->slam_be_threadpool_.enqueue([be = be_, data]()
+                                            { return be->doUpdate(*data); });
+}
+
 }  // namespace mola
@@ -40,6 +40,16 @@ class Dataset_UI
 
     /** Forces continue replaying in this moment in time */
     virtual void datasetUI_teleport(size_t timestep) = 0;
+
+    /** Scrub preview mode: the GUI calls this with `active=true` when the
+     * user starts dragging the time slider (which fires dozens of
+     * datasetUI_teleport() per second), and with `active=false` once the
+     * slider settles at its final position. While active, dataset sources
+     * may serve teleports with cheap metadata only (e.g. the ground-truth
+     * pose at the cursor) and defer the expensive full observation decode
+     * until the final teleport. Default implementation: ignored, teleports
+     * always decode in full. */
+    virtual void datasetUI_preview_scrub([[maybe_unused]] bool active) {}
     /** @} */
 };
 
@@ -11,16 +11,24 @@
  */
 #pragma once
 
+#include <mola_kernel/VirtualTimeService.h>
 #include <mola_kernel/Yaml.h>
 #include <mrpt/rtti/CObject.h>
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/CTimeLogger.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <typeindex>
+#include <utility>
 #include <vector>
 
 namespace mola
@@ -82,9 +90,26 @@ class ExecutableBase : public mrpt::system::COutputLogger,  // for logging
      * \sa findService() */
     std::function<Ptr(const std::string&)> nameServer_;
 
+    /** Logical replay clock for deterministic faster-than-realtime runs;
+     * empty (nullptr) in normal wall-clock operation. Injected by the
+     * launcher (like nameServer_) when `launcher: {virtual_time: true}` is
+     * set: waitForNextSpin() then schedules against this clock, advanced
+     * by the dataset source, instead of the wall clock.
+     * \sa VirtualTimeService */
+    VirtualTimeService::Ptr virtual_time_;
+
+    /** Revision counter of the module list behind nameServer_: bumped by the
+     * system on every module load/unload. When set (as the standard
+     * MolaLauncherApp does), findService() caches its results per interface
+     * type and only re-polls the name server after the revision changes.
+     * \sa findService() */
+    std::function<uint64_t()> nameServerRevision_;
+
     /** Finds (an)other ExecutableBase(s) by its expected Interface, that is,
-     * a virtual base class.
-     * \sa nameServer_ */
+     * a virtual base class. Modules calling this repeatedly at runtime (e.g.
+     * once per spin) get a cached answer while the module list revision is
+     * unchanged, instead of a full poll with one dynamic_cast per module.
+     * \sa nameServer_, nameServerRevision_ */
     template <class Interface>
     std::vector<Ptr> findService() const;
 
@@ -107,6 +132,120 @@ class ExecutableBase : public mrpt::system::COutputLogger,  // for logging
         return requested_system_shutdown_;
     }
 
+    /** May be called from any thread (e.g. an incoming-data callback) to
+     * signal that this module has pending work: if its executor thread is
+     * parked in waitForNextSpin() it wakes up immediately and runs
+     * spinOnce() without waiting for the rest of the nominal period. */
+    void nudge()
+    {
+        {
+            auto lck           = mrpt::lockHelper(spinWakeupMtx_);
+            spinWakeupPending_ = true;
+        }
+        spinWakeupCV_.notify_one();
+    }
+
+    /** Like nudge(), but only makes a thread parked in waitForNextSpin()
+     * re-evaluate its wait condition, without marking pending work. Used by
+     * the virtual time service on every clock advance. */
+    void notifySpinWaiters() { spinWakeupCV_.notify_one(); }
+
+    /** Used by the module executor (see MolaLauncherApp): parks the calling
+     * thread until the next multiple of the nominal spin period, or until
+     * nudge() signals pending work, whichever comes first. A token bucket
+     * (one token earned per elapsed period, capped at
+     * SPIN_MAX_BURST_TOKENS) lets a backlogged module re-spin immediately
+     * several times in a row to catch up before rate-limiting applies
+     * again.
+     *
+     * \return false if the nominal execution rate could not be achieved
+     * (i.e. spinOnce() took longer than the period), like
+     * mrpt::system::CRateTimer::sleep().
+     */
+    bool waitForNextSpin(const double periodSeconds)
+    {
+        using clock = std::chrono::steady_clock;
+
+        // Deterministic replay (see VirtualTimeService): schedule against
+        // the logical clock instead of the wall clock. Every clock advance
+        // calls notifySpinWaiters() on all modules, so the wait below is
+        // re-evaluated whenever time moves; the bounded wall wait only
+        // guards against a stalled clock (e.g. during shutdown).
+        if (virtual_time_)
+        {
+            std::unique_lock<std::mutex> lck(spinWakeupMtx_);
+            const double                 vnow = virtual_time_->now();
+
+            bool onTime = true;
+            if (spinNextVirtualDeadline_ < 0) spinNextVirtualDeadline_ = vnow;
+            spinNextVirtualDeadline_ += periodSeconds;
+            if (spinNextVirtualDeadline_ < vnow)
+            {
+                onTime                   = false;
+                spinNextVirtualDeadline_ = vnow;
+            }
+
+            while (!spinWakeupPending_ &&
+                   virtual_time_->now() < spinNextVirtualDeadline_)
+            {
+                if (spinWakeupCV_.wait_for(
+                        lck, std::chrono::milliseconds(100)) ==
+                    std::cv_status::timeout)
+                    break;
+            }
+            spinWakeupPending_ = false;
+            return onTime;
+        }
+
+        const auto now    = clock::now();
+        const auto period = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(periodSeconds));
+
+        std::unique_lock<std::mutex> lck(spinWakeupMtx_);
+
+        // Earn burst credit for the time elapsed since the last wake-up:
+        if (periodSeconds > 0 && spinLastWakeup_ != clock::time_point())
+        {
+            spinBurstTokens_ +=
+                std::chrono::duration<double>(now - spinLastWakeup_).count() /
+                periodSeconds;
+            spinBurstTokens_ =
+                std::min(spinBurstTokens_, SPIN_MAX_BURST_TOKENS);
+        }
+        spinLastWakeup_ = now;
+
+        // Pending work + credit => catch-up burst, re-spin right away:
+        if (spinWakeupPending_ && spinBurstTokens_ >= 1.0)
+        {
+            spinBurstTokens_ -= 1.0;
+            spinWakeupPending_ = false;
+            spinNextDeadline_  = now + period;
+            return true;
+        }
+
+        // Nominal schedule: wake at multiples of the period, detecting
+        // overruns, as mrpt::system::CRateTimer did:
+        bool onTime = true;
+        if (spinNextDeadline_ == clock::time_point()) spinNextDeadline_ = now;
+        spinNextDeadline_ += period;
+        if (spinNextDeadline_ < now)
+        {
+            onTime            = false;  // spinOnce() took longer than period
+            spinNextDeadline_ = now;  // reset the schedule
+        }
+
+        if (spinWakeupCV_.wait_until(
+                lck, spinNextDeadline_,
+                [this]() { return spinWakeupPending_; }))
+            spinWakeupPending_ = false;
+
+        return onTime;
+    }
+
+    /** Upper bound for accumulated catch-up credit in waitForNextSpin(), in
+     * units of nominal spin periods. */
+    static constexpr double SPIN_MAX_BURST_TOKENS = 10.0;
+
    protected:
     void requestShutdown()
     {
@@ -118,6 +257,23 @@ class ExecutableBase : public mrpt::system::COutputLogger,  // for logging
     std::string module_instance_name{"unnamed"};
     bool        requested_system_shutdown_ = false;
     std::mutex  requested_system_shutdown_mtx_;
+
+    // See nudge() / waitForNextSpin():
+    std::mutex                            spinWakeupMtx_;
+    std::condition_variable               spinWakeupCV_;
+    bool                                  spinWakeupPending_ = false;
+    double                                spinBurstTokens_   = 0;
+    std::chrono::steady_clock::time_point spinLastWakeup_{};
+    std::chrono::steady_clock::time_point spinNextDeadline_{};
+    /// Logical-clock schedule, used instead of the above when virtual_time_
+    /// is set (<0 = not started yet):
+    double spinNextVirtualDeadline_ = -1;
+
+    /// findService() results per interface type, each tagged with the module
+    /// list revision it was computed for (see nameServerRevision_):
+    mutable std::map<std::type_index, std::pair<uint64_t, std::vector<Ptr>>>
+                       findServiceCache_;
+    mutable std::mutex findServiceCacheMtx_;
 };
 
 // Impl:
@@ -126,6 +282,20 @@ std::vector<ExecutableBase::Ptr> ExecutableBase::findService() const
 {
     std::vector<ExecutableBase::Ptr> ret;
     if (!nameServer_) return ret;
+
+    // Read the revision *before* polling, so a concurrent module load/unload
+    // mid-poll tags the cached entry as already stale:
+    const uint64_t rev = nameServerRevision_ ? nameServerRevision_() : 0;
+    const auto     key = std::type_index(typeid(Interface));
+
+    if (nameServerRevision_)
+    {
+        auto lck = mrpt::lockHelper(findServiceCacheMtx_);
+        if (auto it = findServiceCache_.find(key);
+            it != findServiceCache_.end() && it->second.first == rev)
+            return it->second.second;
+    }
+
     for (size_t idx = 0;; ++idx)
     {
         using namespace std::string_literals;
@@ -135,6 +305,12 @@ std::vector<ExecutableBase::Ptr> ExecutableBase::findService() const
         if (std::dynamic_pointer_cast<Interface>(mod))
             ret.emplace_back(std::move(mod));
     }
+
+    if (nameServerRevision_)
+    {
+        auto lck              = mrpt::lockHelper(findServiceCacheMtx_);
+        findServiceCache_[key] = {rev, ret};
+    }
     return ret;
 }
 
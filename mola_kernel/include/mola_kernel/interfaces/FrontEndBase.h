@@ -46,14 +46,15 @@ class FrontEndBase : public ExecutableBase, public RawDataConsumer
      *   or multiple (e.g. `raw_data_source: [moduleName1, moduleName2]`) MOLA
      *   **module names** to which to subscribe for input raw observations.
      *
+     * - `raw_sensor_labels`: Optional list of sensor-label patterns (exact
+     *   label, or prefix with a trailing `*`, e.g. `raw_sensor_labels:
+     *   [lidar, camera_*]`) this front-end subscribes to; the sources then
+     *   never invoke onNewObservation() for other labels. If absent, all
+     *   observations of the subscribed sources are delivered, and label
+     *   filtering (if any) remains up to the derived class.
+     *
      * Recall that module names are given in the `name:` field of the mola-cli
      * launch YAML file.
-     *
-     * Note that no individual sensor label is read in this abstract class
-     * since it is up to the derived classes to specify whether to subscribe
-     * to one or more sensor sources, and use descriptive names in the case of
-     * multiple sensors.
-     *
      */
     void initialize(const Yaml& cfg) override final;
 
@@ -16,11 +16,15 @@
 #include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/TPose3D.h>
 
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace mola
@@ -35,8 +39,8 @@ namespace mola
 class LocalizationSourceBase
 {
    public:
-    LocalizationSourceBase()          = default;
-    virtual ~LocalizationSourceBase() = default;
+    LocalizationSourceBase() = default;
+    virtual ~LocalizationSourceBase() { locUpdatesShutdown(); }
 
     struct LocalizationUpdate
     {
@@ -59,11 +63,16 @@ class LocalizationSourceBase
     using localization_updates_callback_t =
         std::function<void(const LocalizationUpdate&)>;
 
+    /** Callbacks are invoked from a background worker thread, never from the
+     * thread calling advertiseUpdatedLocalization() (see that method). */
     void subscribeToLocalizationUpdates(
         const localization_updates_callback_t& callback)
     {
         auto lck = mrpt::lockHelper(locUpdSubsMtx_);
         locUpdSubs_.push_back(callback);
+        if (!locUpdWorker_.joinable())
+            locUpdWorker_ = std::thread(
+                &LocalizationSourceBase::locUpdatesWorkerLoop, this);
     }
 
    protected:
@@ -73,26 +82,84 @@ class LocalizationSourceBase
         return !locUpdSubs_.empty();
     }
 
+    /** Publishes the latest localization and returns immediately: the
+     * producer just replaces the shared latest-record slot and bumps its
+     * sequence number (constant cost, independent of the number or speed of
+     * subscribers). A background worker thread delivers it to all
+     * subscriber callbacks; if the producer outpaces a consumer,
+     * intermediate records are coalesced and consumers observe the latest
+     * pose only, so a slow subscriber can never delay the SLAM thread nor
+     * its peers. */
     void advertiseUpdatedLocalization(const LocalizationUpdate& l)
     {
-        auto lck = mrpt::lockHelper(locUpdSubsMtx_);
-        for (const auto& callback : locUpdSubs_)
+        auto u = std::make_shared<const LocalizationUpdate>(l);
         {
-            try
-            {
-                callback(l);
-            }
-            catch (const std::exception& e)
-            {
-                std::cerr << "[LocalizationSourceBase] Exception in callback: "
-                          << e.what();
-            }
+            // Constant-time critical section: two pointer-sized writes.
+            auto lck      = mrpt::lockHelper(locUpdLatestMtx_);
+            locUpdLatest_ = std::move(u);
+            locUpdSeq_++;
         }
+        locUpdCV_.notify_one();
     }
 
    private:
     std::vector<localization_updates_callback_t> locUpdSubs_;
     std::mutex                                   locUpdSubsMtx_;
+
+    /** Latest advertised record + sequence number (see
+     * advertiseUpdatedLocalization()) */
+    std::shared_ptr<const LocalizationUpdate> locUpdLatest_;
+    uint64_t                                  locUpdSeq_ = 0;
+    std::mutex                                locUpdLatestMtx_;
+    std::condition_variable                   locUpdCV_;
+    std::thread                               locUpdWorker_;
+    bool                                      locUpdStop_ = false;
+
+    void locUpdatesWorkerLoop()
+    {
+        std::unique_lock<std::mutex> lck(locUpdLatestMtx_);
+        uint64_t                     lastSeq = 0;
+        for (;;)
+        {
+            locUpdCV_.wait(
+                lck,
+                [&]() { return locUpdStop_ || locUpdSeq_ != lastSeq; });
+            if (locUpdStop_) return;
+
+            // Take the latest record; intermediate ones are coalesced:
+            const auto u = locUpdLatest_;
+            lastSeq      = locUpdSeq_;
+            lck.unlock();
+
+            {
+                auto lck2 = mrpt::lockHelper(locUpdSubsMtx_);
+                for (const auto& callback : locUpdSubs_)
+                {
+                    try
+                    {
+                        callback(*u);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        std::cerr << "[LocalizationSourceBase] Exception in "
+                                     "callback: "
+                                  << e.what();
+                    }
+                }
+            }
+            lck.lock();
+        }
+    }
+
+    void locUpdatesShutdown()
+    {
+        {
+            auto lck    = mrpt::lockHelper(locUpdLatestMtx_);
+            locUpdStop_ = true;
+        }
+        locUpdCV_.notify_all();
+        if (locUpdWorker_.joinable()) locUpdWorker_.join();
+    }
 };
 
 }  // namespace mola
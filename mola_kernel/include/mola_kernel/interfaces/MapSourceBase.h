@@ -11,12 +11,20 @@
  */
 #pragma once
 
+#include <mrpt/core/lock_helper.h>
 #include <mrpt/maps/CMetricMap.h>
+#include <mrpt/math/TBoundingBox.h>
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace mola
@@ -27,8 +35,8 @@ namespace mola
 class MapSourceBase
 {
    public:
-    MapSourceBase()          = default;
-    virtual ~MapSourceBase() = default;
+    MapSourceBase() = default;
+    virtual ~MapSourceBase() { mapUpdatesShutdown(); }
 
     struct MapUpdate
     {
@@ -48,16 +56,38 @@ class MapSourceBase
         std::string map_name = "local_map";
 
         mrpt::maps::CMetricMap::Ptr map;
+
+        /** If set, `map` holds only the contents of this axis-aligned
+         * changed region ("dirty region") instead of the whole layer, so
+         * consumers can publish/apply an incremental patch rather than
+         * re-serializing the full map. */
+        std::optional<mrpt::math::TBoundingBoxf> dirty_region;
+
+        /** Monotonic per-map_name sequence number of incremental patches;
+         * full-map updates (dirty_region not set) restart the sequence, so
+         * consumers can detect missed patches and request/await a full
+         * update. */
+        uint64_t update_seq = 0;
     };
 
     using map_updates_callback_t = std::function<void(const MapUpdate&)>;
 
+    /** Callbacks are invoked from a background worker thread, never from the
+     * thread calling advertiseUpdatedMap() (see that method). */
     void subscribeToMapUpdates(const map_updates_callback_t& callback)
     {
         auto lck = mrpt::lockHelper(mapUpdSubsMtx_);
-        mapUpdSubs_.push_back(callback);
+        auto& s  = mapUpdSubs_.emplace_back();
+        s.callback = callback;
+        if (!mapUpdWorker_.joinable())
+            mapUpdWorker_ =
+                std::thread(&MapSourceBase::mapUpdatesWorkerLoop, this);
     }
 
+    /** Maximum per-subscriber queued map updates before the oldest one is
+     * dropped (see advertiseUpdatedMap()). */
+    static constexpr size_t MAX_QUEUED_MAP_UPDATES = 3;
+
    protected:
     bool anyUpdateMapSubscriber()
     {
@@ -65,26 +95,97 @@ class MapSourceBase
         return !mapUpdSubs_.empty();
     }
 
+    /** Enqueues the update and returns immediately: subscriber callbacks
+     * (and whatever serialization they perform) run in a background worker
+     * thread, with a bounded per-subscriber queue with drop-oldest policy,
+     * so a slow consumer never blocks map insertion in the SLAM thread.
+     *
+     * Note that `l.map` is *shared* with consumers, not deep-copied: after
+     * advertising an update, producers must not modify the pointee in place
+     * but publish a new/cloned object instead (copy-on-write).
+     */
     void advertiseUpdatedMap(const MapUpdate& l)
     {
-        auto lck = mrpt::lockHelper(mapUpdSubsMtx_);
-        for (const auto& callback : mapUpdSubs_)
+        auto u = std::make_shared<const MapUpdate>(l);
         {
-            try
+            auto lck = mrpt::lockHelper(mapUpdSubsMtx_);
+            for (auto& sub : mapUpdSubs_)
             {
-                callback(l);
+                if (sub.queue.size() >= MAX_QUEUED_MAP_UPDATES)
+                    sub.queue.pop_front();  // drop-oldest
+                sub.queue.push_back(u);
             }
-            catch (const std::exception& e)
+        }
+        mapUpdCV_.notify_one();
+    }
+
+   private:
+    struct SubscriberSlot
+    {
+        map_updates_callback_t                       callback;
+        std::deque<std::shared_ptr<const MapUpdate>> queue;
+    };
+
+    std::vector<SubscriberSlot> mapUpdSubs_;
+    std::mutex                  mapUpdSubsMtx_;
+    std::condition_variable     mapUpdCV_;
+    std::thread                 mapUpdWorker_;
+    bool                        mapUpdStop_ = false;
+
+    /// Requires mapUpdSubsMtx_ to be held by the caller:
+    bool mapUpdatesAnyQueued() const
+    {
+        for (const auto& s : mapUpdSubs_)
+            if (!s.queue.empty()) return true;
+        return false;
+    }
+
+    void mapUpdatesWorkerLoop()
+    {
+        std::unique_lock<std::mutex> lck(mapUpdSubsMtx_);
+        for (;;)
+        {
+            mapUpdCV_.wait(
+                lck,
+                [this]() { return mapUpdStop_ || mapUpdatesAnyQueued(); });
+            if (mapUpdStop_) return;
+
+            // Index-based loop: subscribeToMapUpdates() may grow the vector
+            // while the lock is released below.
+            for (size_t i = 0; i < mapUpdSubs_.size(); i++)
             {
-                std::cerr << "[MapSourceBase] Exception in callback: "
-                          << e.what();
+                while (!mapUpdSubs_[i].queue.empty())
+                {
+                    const auto cb = mapUpdSubs_[i].callback;
+                    const auto u  = mapUpdSubs_[i].queue.front();
+                    mapUpdSubs_[i].queue.pop_front();
+
+                    lck.unlock();
+                    try
+                    {
+                        cb(*u);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        std::cerr << "[MapSourceBase] Exception in callback: "
+                                  << e.what();
+                    }
+                    lck.lock();
+                    if (mapUpdStop_) return;
+                }
             }
         }
     }
 
-   private:
-    std::vector<map_updates_callback_t> mapUpdSubs_;
-    std::mutex                          mapUpdSubsMtx_;
+    void mapUpdatesShutdown()
+    {
+        {
+            auto lck    = mrpt::lockHelper(mapUpdSubsMtx_);
+            mapUpdStop_ = true;
+        }
+        mapUpdCV_.notify_all();
+        if (mapUpdWorker_.joinable()) mapUpdWorker_.join();
+    }
 };
 
 }  // namespace mola
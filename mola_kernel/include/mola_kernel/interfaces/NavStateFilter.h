@@ -18,6 +18,8 @@
 #include <mrpt/poses/CPose3DPDFGaussianInf.h>
 #include <mrpt/system/COutputLogger.h>
 
+#include <functional>
+
 #pragma once
 
 namespace mola
@@ -32,9 +34,27 @@ struct NavState
 
     /** SE(3) pose estimation, including information matrix, given
      *  in the requested frame_id.
+     *
+     *  For the information matrix, prefer pose_inv_cov() over reading
+     *  pose.cov_inv directly: the producing filter may have deferred its
+     *  (costly) computation, see deferred_pose_inv_cov.
      */
     mrpt::poses::CPose3DPDFGaussianInf pose;
 
+    /** Producing filters may leave pose.cov_inv unset and store here instead
+     *  a closure over their cached solver artifacts; pose_inv_cov() then
+     *  evaluates it once on first access, so mean-only consumers (e.g. a
+     *  controller) never pay for the covariance extraction.
+     */
+    std::function<mrpt::math::CMatrixDouble66()> deferred_pose_inv_cov;
+
+    /** Returns pose.cov_inv, first evaluating and caching
+     *  deferred_pose_inv_cov into it if the producing filter deferred the
+     *  computation. Note that each *copy* of a NavState carries its own
+     *  cache, so copies evaluate the closure (at most) once each.
+     */
+    const mrpt::math::CMatrixDouble66& pose_inv_cov();
+
     /** Linear and angular velocity estimation, given in the local vehicle
      *  frame. */
     mrpt::math::TTwist3D twist;
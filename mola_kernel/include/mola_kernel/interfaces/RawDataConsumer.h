@@ -14,6 +14,7 @@
 #include <mrpt/obs/CObservation.h>
 
 #include <memory>
+#include <vector>
 
 namespace mola
 {
@@ -34,6 +35,17 @@ class RawDataConsumer
      * fast as possible, enqueuing the data for processing in another thread.
      */
     virtual void onNewObservation(const CObservation::Ptr& o) = 0;
+
+    /** Called with a batch of observations that arrived close together in
+     * time (e.g. a burst of high-rate IMU readings), so they can be processed
+     * in one pass instead of paying per-observation dispatch overhead.
+     * The default implementation just forwards each one to
+     * onNewObservation(), so existing consumers need no changes. */
+    virtual void onNewObservationBatch(
+        const std::vector<CObservation::Ptr>& obs)
+    {
+        for (const auto& o : obs) onNewObservation(o);
+    }
     /** @} */
 };
 
@@ -11,6 +11,7 @@
  */
 #pragma once
 
+#include <mola_kernel/LockFreeObservationQueue.h>
 #include <mola_kernel/Yaml.h>
 #include <mola_kernel/interfaces/ExecutableBase.h>
 #include <mola_kernel/interfaces/RawDataConsumer.h>
@@ -20,6 +21,13 @@
 #include <mrpt/io/CFileGZOutputStream.h>
 #include <mrpt/obs/CObservation.h>
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+
 namespace mola
 {
 /** 0-based indices of observations in a dataset */
@@ -36,21 +44,130 @@ class RawDataSourceBase : public mola::ExecutableBase
     virtual ~RawDataSourceBase();
 
     /** Attach this object to a consumer. A shared_ptr is created to keep a
-     * reference to the object. */
-    void attachToDataConsumer(RawDataConsumer& rdc);
+     * reference to the object.
+     *
+     * The optional `sensor_label_patterns` restricts delivery to
+     * observations whose sensorLabel matches any of the given patterns:
+     * either an exact label, or a prefix followed by a trailing `*` (e.g.
+     * "camera_*"). An empty list (the default) subscribes to everything.
+     * Dispatch consults a per-label precomputed subscriber table, so
+     * consumers are never invoked (no virtual call, no wake-up) for labels
+     * they did not subscribe to. */
+    void attachToDataConsumer(
+        RawDataConsumer&                rdc,
+        const std::vector<std::string>& sensor_label_patterns = {});
 
     /** Loads common parameters for all RDS.
      * This handles:
      * - `gui_preview_sensors`: Enable displaying sensor data in a subwindow.
+     * Per-sensor entries take `raw_sensor_label`, plus optional preview
+     * decimation done here in the source, so enabling previews stays cheap:
+     * `decimation` (show 1 out of N frames, default=1), `max_fps` (cap on
+     * preview updates per second, default=0: unlimited), `downscale`
+     * (integer divisor applied once to camera images before handing them to
+     * MolaViz, default=1), and `win_pos` ("x y w h"). Example:
+     * \code
+     * gui_preview_sensors:
+     *   - raw_sensor_label: camera_front
+     *     max_fps: 5
+     *     downscale: 4
+     * \endcode
      * - `export_to_rawlog`: If defined, save observations to the given rawlog
      * file.
      * - `force_load_lazy_load`: (Default=false) Force load() on all incoming
      * observations.
      * - `quit_mola_app_on_dataset_end`: (Default=false) Quits the MOLA app when
      * end of dataset is reached.
+     * - `use_lockfree_queue`: (Default=false) Deliver observations to
+     * consumers through a bounded lock-free MPMC queue with one dispatch
+     * thread per consumer, so concurrent sensor threads do not serialize on
+     * one lock. Note that this makes delivery *asynchronous* (the sensor
+     * thread returns before consumers ran), and that all consumers must be
+     * attached before the first observation is published: the queue snapshots
+     * the consumer list when created.
+     * - `lockfree_queue_capacity`: (Default=1024) Capacity (number of
+     * observations) of said queue; rounded up to a power of two.
+     * - `batch_delivery_window`: (Default=0, disabled) Time window [s] during
+     * which observations are coalesced and handed to consumers as one call to
+     * RawDataConsumer::onNewObservationBatch(). Requires
+     * `use_lockfree_queue=true`.
+     * - `sensor_queues`: Optional per-sensor-label delivery QoS policies, to
+     * bound end-to-end latency under overload instead of accumulating lag.
+     * Dropped observations are counted per label in the module profiler
+     * (`qos.drop.<label>`) and reported at shutdown. Example:
+     * \code
+     * sensor_queues:
+     *   - raw_sensor_label: camera_front
+     *     policy: keep_latest  # drop while delivery backlog > max_backlog
+     *     max_backlog: 4
+     *   - raw_sensor_label: lidar
+     *     policy: decimate     # enforce a minimum period between obs.
+     *     min_period: 0.1      # [s]
+     *   - raw_sensor_label: imu
+     *     policy: keep_all     # (default) never drop
+     * \endcode
+     * - `observation_prefilter`: Optional per-sensor-label point-cloud
+     * filters, applied once inside prepareObservationBeforeFrontEnds() so all
+     * attached consumers receive the already-reduced cloud instead of each
+     * re-filtering the full one. Supported on CObservationPointCloud and
+     * CObservationVelodyneScan; other observation types pass through
+     * untouched. Example:
+     * \code
+     * observation_prefilter:
+     *   - raw_sensor_label: lidar
+     *     range_clip_min: 0.5       # [m] Drop closer points (0=disabled)
+     *     range_clip_max: 80.0      # [m] Drop farther points (0=disabled)
+     *     fov_azimuth_min_deg: -90  # Keep only this azimuth sector
+     *     fov_azimuth_max_deg: 90   # (omit both to keep the full 360 deg)
+     *     voxel_decimation: 0.5     # [m] Keep 1 point/voxel (0=disabled)
+     * \endcode
+     * - `reorder_window`: (Default=0, disabled) Maximum holding latency [s]
+     * of a small timestamp reorder buffer in front of delivery: each
+     * observation is held until the newest timestamp seen across all sensors
+     * of this source is at least this far ahead of it, and observations are
+     * then released in timestamp order. Fixes the slight cross-sensor
+     * disorder of multi-sensor sources (e.g. a USB camera next to a PTP
+     * LiDAR) at the cost of up to one window of latency, so downstream
+     * fusion stages insert in timestamp order (cheap append-at-end) instead
+     * of paying for out-of-order insertions. Applies to the one-by-one
+     * sendObservationsToFrontEnds() flavor only; batched bursts are assumed
+     * already time-sorted by their source.
      */
     void initialize(const Yaml& cfg) override final;
 
+    /** Per-sensor-label delivery QoS policy. See initialize() */
+    struct SensorQoS
+    {
+        enum class Policy : uint8_t
+        {
+            KeepAll = 0,  //!< Deliver every observation (default)
+            KeepLatest,  //!< Drop while the delivery queue is backlogged
+            Decimate  //!< Enforce a minimum period between observations
+        };
+
+        Policy policy     = Policy::KeepAll;
+        double min_period = 0;  //!< [s] For Policy::Decimate
+
+        /** For Policy::KeepLatest: undelivered observations (any label)
+         * above which new ones of this label are dropped. Only effective
+         * with `use_lockfree_queue=true`; the direct delivery path is
+         * synchronous and never accumulates backlog. */
+        unsigned int max_backlog = 1;
+    };
+
+    /** Per-sensor-label point-cloud pre-filter. See initialize() */
+    struct ObsPreFilter
+    {
+        double range_clip_min = 0;  //!< [m] Drop closer points (0=disabled)
+        double range_clip_max = 0;  //!< [m] Drop farther points (0=disabled)
+
+        /** Azimuth sector to keep, about the sensor +X axis. Disabled while
+         * max <= min (the default). */
+        double fov_azimuth_min_deg = 0, fov_azimuth_max_deg = 0;
+
+        double voxel_decimation = 0;  //!< [m] Keep 1 point/voxel (0=disabled)
+    };
+
    protected:
     /** Loads children specific parameters */
     virtual void initialize_rds(const Yaml& cfg) = 0;
@@ -60,6 +177,15 @@ class RawDataSourceBase : public mola::ExecutableBase
     /** Send an observation to the associated target front-ends */
     void sendObservationsToFrontEnds(const CObservation::Ptr& obs);
 
+    /** Sends a burst of observations that belong together (e.g. the IMU
+     * samples between two consecutive camera frames) as a single delivery,
+     * so consumers wake up once per burst instead of once per observation
+     * (see RawDataConsumer::onNewObservationBatch()). QoS admission and
+     * prepareObservationBeforeFrontEnds() are applied per observation,
+     * exactly as in sendObservationsToFrontEnds(). */
+    void sendObservationBatchToFrontEnds(
+        const std::vector<CObservation::Ptr>& obs);
+
     /** Make sure the observation is loaded in memory (for externally-stored
      * classes), etc. Only has effect if the option `force_load_lazy_load` was
      * set to `true` */
@@ -74,6 +200,41 @@ class RawDataSourceBase : public mola::ExecutableBase
     /** Target of captured data */
     std::vector<RawDataConsumer*> rdc_;
 
+    /** Subscription patterns per consumer, parallel to rdc_ (empty=all).
+     * See attachToDataConsumer() */
+    std::vector<std::vector<std::string>> rdc_subscriptions_;
+
+    /** Precomputed subscribers of one sensor label */
+    struct LabelSubscribers
+    {
+        /** Subscribed consumers, for the direct delivery paths */
+        std::vector<RawDataConsumer*> consumers;
+        /** Subscription flag per rdc_ index, for the dispatch threads */
+        std::vector<uint8_t> mask;
+    };
+
+    /** Memoized label -> subscribers table (sensor labels are few and
+     * stable, so each one is resolved against the patterns only once) */
+    mutable std::map<std::string, LabelSubscribers> label_subscribers_;
+    mutable std::mutex                              label_subscribers_mtx_;
+
+    /** Looks up (building it on first sight of the label) the subscriber
+     * table entry for this label. The returned reference remains valid:
+     * map entries are never erased while data flows. */
+    const LabelSubscribers& subscribersFor(const std::string& label) const;
+
+    /** Lock-free delivery path: sensor threads publish() concurrently, and
+     * one dispatch thread per consumer drains its own cursor and invokes
+     * RawDataConsumer::onNewObservation(). Created on the first published
+     * observation (see lazy_init_obs_queue()). */
+    std::unique_ptr<LockFreeObservationQueue> obs_queue_;
+    std::vector<std::thread>                  obs_dispatch_threads_;
+    std::atomic_bool                          obs_dispatch_stop_{false};
+    std::once_flag                            obs_queue_init_flag_;
+
+    void lazy_init_obs_queue();
+    void stop_obs_dispatch_threads();
+
     /** used to optionally export captured observations to an MRPT rawlog */
     mrpt::io::CFileGZOutputStream export_to_rawlog_out_;
     mrpt::WorkerThreadsPool       worker_pool_export_rawlog_{
@@ -90,6 +251,72 @@ class RawDataSourceBase : public mola::ExecutableBase
 
     bool force_load_lazy_load_         = false;
     bool quit_mola_app_on_dataset_end_ = false;
+
+    bool         use_lockfree_queue_      = false;
+    unsigned int lockfree_queue_capacity_ = 1024;
+    double       batch_delivery_window_   = .0;  //!< [s] 0=disabled
+
+    /** QoS policies indexed by sensor label (see `sensor_queues` YAML) */
+    std::map<std::string, SensorQoS> sensor_qos_;
+
+    struct SensorQoSState
+    {
+        double   last_admitted_tim = 0;  //!< [s] For Policy::Decimate
+        uint64_t dropped           = 0;
+    };
+    std::map<std::string, SensorQoSState> sensor_qos_state_;
+    std::mutex                            sensor_qos_mtx_;
+
+    /** Returns false if `obs` must be dropped as per its label QoS policy */
+    bool admitObservationQoS(const CObservation::Ptr& obs);
+
+    /** Rawlog export + GUI preview of one delivered observation; shared
+     * tail of both sendObservationsToFrontEnds() flavors. */
+    void exportAndPreviewObservation(const CObservation::Ptr& obs);
+
+    /** Pre-filters indexed by sensor label (see `observation_prefilter`) */
+    std::map<std::string, ObsPreFilter> obs_prefilter_;
+
+    /** Applies this label's pre-filter (if any) to the observation in place;
+     * called once per observation from prepareObservationBeforeFrontEnds().
+     * Reentrant: scratch buffers are thread_local, so concurrent sensor
+     * threads do not contend. */
+    void applyObservationPreFilter(const CObservation::Ptr& obs) const;
+
+    /** The actual delivery to consumers (QoS admission, queue publish or
+     * direct calls, rawlog export, GUI preview): the tail of
+     * sendObservationsToFrontEnds() behind the optional reorder stage. */
+    void deliverObservationToFrontEnds(const CObservation::Ptr& obs);
+
+    /** See `reorder_window` in initialize() */
+    double reorder_window_ = 0;  //!< [s] 0 = disabled
+
+    struct ReorderEntry
+    {
+        double            tim = 0;  //!< [s] Observation timestamp
+        CObservation::Ptr obs;
+    };
+    struct ReorderEntryAfter
+    {
+        bool operator()(const ReorderEntry& a, const ReorderEntry& b) const
+        {
+            return a.tim > b.tim;  // min-heap on timestamp
+        }
+    };
+
+    /** Held-back observations, released oldest-first once the watermark
+     * (newest timestamp seen minus `reorder_window`) passes them. */
+    std::priority_queue<
+        ReorderEntry, std::vector<ReorderEntry>, ReorderEntryAfter>
+               reorder_heap_;
+    double     reorder_newest_        = 0;  //!< [s] Newest timestamp seen
+    double     reorder_last_released_ = 0;  //!< [s] For straggler detection
+    uint64_t   reorder_late_          = 0;  //!< Delivered out of order
+    std::mutex reorder_mtx_;
+
+    /** Releases everything still held in the reorder buffer, in timestamp
+     * order; called when the dataset playback ends. */
+    void reorderFlush();
 };
 
 }  // namespace mola
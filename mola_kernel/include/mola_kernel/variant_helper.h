@@ -11,6 +11,10 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <type_traits>
+#include <variant>
+
 namespace mola
 {
 /** Based on https://en.cppreference.com/w/cpp/utility/variant/visit */
@@ -24,4 +28,25 @@ struct overloaded : Ts...
 template <class... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
+/** Index of the alternative `T` inside `VariantType` (a std::variant), at
+ * compile time, i.e. the value of `v.index()` while `v` holds a `T`.
+ * Fails to compile if `T` is not one of the alternatives.
+ * \sa WorldModel::entities_visit_by_type() */
+template <typename VariantType, typename T, std::size_t Index = 0>
+constexpr std::size_t variant_index()
+{
+    static_assert(
+        Index < std::variant_size_v<VariantType>,
+        "T is not an alternative of the given std::variant");
+    if constexpr (std::is_same_v<
+                      std::variant_alternative_t<Index, VariantType>, T>)
+    {
+        return Index;
+    }
+    else
+    {
+        return variant_index<VariantType, T, Index + 1>();
+    }
+}
+
 }  // namespace mola
@@ -0,0 +1,271 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   AsyncLogSink.cpp
+ * @brief  Asynchronous console sink for COutputLogger-based modules
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_kernel/AsyncLogSink.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/typemeta/TEnumType.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace mola;
+
+namespace
+{
+constexpr size_t ENTRIES_PER_THREAD = 1 << 12;  // ring buffer size
+
+struct LogEntry
+{
+    mrpt::Clock::time_point       timestamp;
+    mrpt::system::VerbosityLevel  level = mrpt::system::LVL_INFO;
+    std::string                   loggerName;
+    std::string                   body;
+};
+
+/** SPSC ring: only its owner thread writes, only the writer thread reads */
+struct ThreadLogRing
+{
+    std::vector<LogEntry> entries{ENTRIES_PER_THREAD};
+    std::atomic<uint64_t> writeIdx{0};
+    std::atomic<uint64_t> readIdx{0};
+};
+
+struct ThrottleState
+{
+    double   tokens       = 0;
+    double   lastRefill   = 0;  // [s], steady clock
+    uint64_t suppressed   = 0;
+};
+
+struct SinkRegistry
+{
+    std::mutex                                  ringsMtx;
+    std::vector<std::shared_ptr<ThreadLogRing>> rings;
+
+    std::mutex                             attachedMtx;
+    std::set<const mrpt::system::COutputLogger*> attached;
+
+    std::atomic<double>   maxRatePerLabel{.0};
+    std::atomic<uint64_t> dropped{0};
+
+    std::mutex              wakeMtx;
+    std::condition_variable wakeCv;
+    std::atomic<bool>       mustExit{false};
+    std::thread             writerThread;
+
+    ~SinkRegistry()
+    {
+        mustExit = true;
+        wakeCv.notify_all();
+        if (writerThread.joinable()) writerThread.join();
+    }
+};
+
+SinkRegistry& registry()
+{
+    static SinkRegistry r;
+    return r;
+}
+
+ThreadLogRing& myLogRing()
+{
+    thread_local std::shared_ptr<ThreadLogRing> ring = []()
+    {
+        auto  b   = std::make_shared<ThreadLogRing>();
+        auto& r   = registry();
+        auto  lck = std::lock_guard(r.ringsMtx);
+        r.rings.push_back(b);
+        return b;
+    }();
+    return *ring;
+}
+
+double nowSeconds()
+{
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void writeOut(const LogEntry& e)
+{
+    std::fprintf(
+        stdout, "[%s|%s|%s] %s\n", e.loggerName.c_str(),
+        mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>::value2name(
+            e.level)
+            .c_str(),
+        mrpt::system::timeLocalToString(e.timestamp).c_str(), e.body.c_str());
+}
+
+/** Drains all rings once; applies throttles; returns #messages consumed */
+size_t drainAll(std::map<std::string, ThrottleState>& throttles)
+{
+    auto&        r       = registry();
+    const double maxRate = r.maxRatePerLabel.load(std::memory_order_relaxed);
+
+    size_t consumed = 0;
+    auto   lck      = std::lock_guard(r.ringsMtx);
+    for (auto& ring : r.rings)
+    {
+        const uint64_t end = ring->writeIdx.load(std::memory_order_acquire);
+        uint64_t       i   = ring->readIdx.load(std::memory_order_relaxed);
+        for (; i < end; i++)
+        {
+            LogEntry e = std::move(ring->entries[i % ENTRIES_PER_THREAD]);
+            consumed++;
+
+            if (maxRate > 0)
+            {
+                auto&        th  = throttles[e.loggerName];
+                const double now = nowSeconds();
+                th.tokens        = std::min(
+                    2.0 * maxRate, th.tokens + (now - th.lastRefill) * maxRate);
+                th.lastRefill = now;
+                if (th.tokens < 1.0)
+                {
+                    th.suppressed++;
+                    continue;
+                }
+                th.tokens -= 1.0;
+            }
+            writeOut(e);
+        }
+        ring->readIdx.store(i, std::memory_order_release);
+    }
+    return consumed;
+}
+
+void writerThreadFn()
+{
+    auto& r = registry();
+
+    std::map<std::string, ThrottleState> throttles;
+    double lastSuppressReport = nowSeconds();
+
+    while (!r.mustExit)
+    {
+        {
+            auto lck = std::unique_lock(r.wakeMtx);
+            r.wakeCv.wait_for(lck, std::chrono::milliseconds(10));
+        }
+        if (drainAll(throttles)) std::fflush(stdout);
+
+        // Periodic report of rate-limited messages:
+        const double now = nowSeconds();
+        if (now - lastSuppressReport > 2.0)
+        {
+            lastSuppressReport = now;
+            for (auto& [label, th] : throttles)
+            {
+                if (!th.suppressed) continue;
+                std::fprintf(
+                    stdout,
+                    "[%s|WARN|AsyncLogSink] %lu message(s) suppressed by "
+                    "rate limit\n",
+                    label.c_str(),
+                    static_cast<unsigned long>(th.suppressed));
+                th.suppressed = 0;
+            }
+        }
+    }
+    // Final drain so nothing enqueued before shutdown is lost:
+    drainAll(throttles);
+    std::fflush(stdout);
+}
+
+void ensureWriterThread()
+{
+    auto& r = registry();
+    // attachedMtx is always held by the (only) caller, attach():
+    if (!r.writerThread.joinable()) r.writerThread = std::thread(writerThreadFn);
+}
+
+void enqueueCallback(
+    std::string_view msg, const mrpt::system::VerbosityLevel level,
+    std::string_view loggerName, const mrpt::Clock::time_point timestamp)
+{
+    auto&          b   = myLogRing();
+    const uint64_t idx = b.writeIdx.load(std::memory_order_relaxed);
+    if (idx - b.readIdx.load(std::memory_order_acquire) >= ENTRIES_PER_THREAD)
+    {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // COutputLogger hands messages over with their trailing newline:
+    while (!msg.empty() && (msg.back() == '\n' || msg.back() == '\r'))
+        msg.remove_suffix(1);
+
+    LogEntry& e  = b.entries[idx % ENTRIES_PER_THREAD];
+    e.timestamp  = timestamp;
+    e.level      = level;
+    e.loggerName = loggerName;
+    e.body       = msg;
+
+    // Publish after the payload is complete:
+    b.writeIdx.store(idx + 1, std::memory_order_release);
+    registry().wakeCv.notify_one();
+}
+}  // namespace
+
+void AsyncLogSink::attach(mrpt::system::COutputLogger& logger)
+{
+    auto& r   = registry();
+    auto  lck = std::lock_guard(r.attachedMtx);
+    if (!r.attached.insert(&logger).second) return;  // already attached
+
+    ensureWriterThread();
+
+    logger.logging_enable_console_output = false;
+    logger.logRegisterCallback(&enqueueCallback);
+}
+
+void AsyncLogSink::set_max_rate_per_label(const double maxPerSecond)
+{
+    registry().maxRatePerLabel.store(maxPerSecond, std::memory_order_relaxed);
+}
+
+void AsyncLogSink::flush()
+{
+    auto& r = registry();
+    if (!r.writerThread.joinable()) return;
+
+    for (;;)
+    {
+        bool empty = true;
+        {
+            auto lck = std::lock_guard(r.ringsMtx);
+            for (const auto& ring : r.rings)
+                if (ring->readIdx.load(std::memory_order_acquire) !=
+                    ring->writeIdx.load(std::memory_order_acquire))
+                    empty = false;
+        }
+        if (empty) break;
+        r.wakeCv.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::fflush(stdout);
+}
+
+uint64_t AsyncLogSink::dropped_count()
+{
+    return registry().dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,194 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   DatasetPrefetcher.cpp
+ * @brief  Shared read-ahead/caching engine for offline dataset sources
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_kernel/DatasetPrefetcher.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/lock_helper.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace mola;
+
+void DatasetPrefetcher::initialize(
+    decode_function_t decoder, size_t datasetLength, const Parameters& params)
+{
+    ASSERT_(decoder);
+
+    auto lck = mrpt::lockHelper(mtx_);
+
+    decoder_       = std::move(decoder);
+    datasetLength_ = datasetLength;
+    params_        = params;
+
+    if (params_.look_ahead > 0)
+    {
+        pool_ = std::make_unique<mrpt::WorkerThreadsPool>(
+            std::max<unsigned int>(1, params_.decode_threads),
+            mrpt::WorkerThreadsPool::POLICY_FIFO, "DatasetPrefetcher");
+    }
+}
+
+mrpt::obs::CObservation::Ptr DatasetPrefetcher::get(size_t step)
+{
+    ASSERT_(decoder_);
+    ASSERT_LT_(step, datasetLength_);
+
+    mrpt::obs::CObservation::Ptr o;
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+
+        cursor_ = step;
+
+        // if a worker is decoding this very step, wait for it:
+        cv_.wait(lck, [this, step]() { return inflight_.count(step) == 0; });
+
+        if (auto it = cache_.find(step); it != cache_.end())
+        {
+            o = it->second;
+            touch(step);
+        }
+        else
+        {
+            // decode it ourselves, synchronously:
+            inflight_.insert(step);
+        }
+    }
+
+    if (!o) o = decodeInflight(step);
+
+    scheduleAhead();
+
+    return o;
+}
+
+void DatasetPrefetcher::prefetch_from(size_t step)
+{
+    {
+        auto lck = mrpt::lockHelper(mtx_);
+        cursor_  = std::min(step, datasetLength_);
+    }
+    scheduleAhead();
+}
+
+void DatasetPrefetcher::clear()
+{
+    auto lck = mrpt::lockHelper(mtx_);
+    cache_.clear();
+    lru_.clear();
+    lruPos_.clear();
+}
+
+void DatasetPrefetcher::touch(size_t step)
+{
+    if (auto it = lruPos_.find(step); it != lruPos_.end())
+    {
+        lru_.splice(lru_.begin(), lru_, it->second);
+    }
+    else
+    {
+        lru_.push_front(step);
+        lruPos_[step] = lru_.begin();
+    }
+}
+
+void DatasetPrefetcher::evict()
+{
+    while (cache_.size() > params_.max_cached_entries && !lru_.empty())
+    {
+        const size_t victim = lru_.back();
+        lru_.pop_back();
+        lruPos_.erase(victim);
+        cache_.erase(victim);
+    }
+}
+
+void DatasetPrefetcher::scheduleAhead()
+{
+    if (!pool_) return;
+
+    std::vector<size_t> toQueue;
+    {
+        auto lck = mrpt::lockHelper(mtx_);
+
+        const size_t end =
+            std::min<size_t>(datasetLength_, cursor_ + 1 + params_.look_ahead);
+
+        for (size_t s = cursor_ + 1; s < end; s++)
+            if (cache_.count(s) == 0 && inflight_.count(s) == 0)
+                toQueue.push_back(s);
+    }
+
+    // bounded queue: never pile up more jobs than the window itself:
+    if (pool_->pendingTasks() >= params_.look_ahead) return;
+
+    for (const size_t s : toQueue)
+    {
+        pool_->enqueue(
+            [this, s]()
+            {
+                {
+                    auto lck = mrpt::lockHelper(mtx_);
+
+                    // drop stale jobs, e.g. after a teleport re-aimed the
+                    // window while this one sat in the queue:
+                    if (s < cursor_ || s >= cursor_ + 1 + params_.look_ahead)
+                        return;
+
+                    if (cache_.count(s) != 0 || inflight_.count(s) != 0)
+                        return;
+
+                    inflight_.insert(s);
+                }
+                try
+                {
+                    decodeInflight(s);
+                }
+                catch (const std::exception&)
+                {
+                    // swallowed here on purpose: if the entry is actually
+                    // needed, the synchronous decode in get() will hit the
+                    // same error and surface it to the caller.
+                }
+            });
+    }
+}
+
+mrpt::obs::CObservation::Ptr DatasetPrefetcher::decodeInflight(size_t step)
+{
+    // clears the in-flight mark and wakes up waiters at scope exit, even
+    // if the decoder throws:
+    struct InflightGuard
+    {
+        DatasetPrefetcher& parent;
+        const size_t       step;
+        ~InflightGuard()
+        {
+            {
+                auto lck = mrpt::lockHelper(parent.mtx_);
+                parent.inflight_.erase(step);
+            }
+            parent.cv_.notify_all();
+        }
+    };
+    const InflightGuard guard{*this, step};
+
+    auto o = decoder_(step);  // the heavy part, intentionally unlocked
+
+    {
+        auto lck     = mrpt::lockHelper(mtx_);
+        cache_[step] = o;
+        touch(step);
+        evict();
+    }
+    return o;
+}
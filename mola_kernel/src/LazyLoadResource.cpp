@@ -11,31 +11,343 @@
  */
 
 #include <mola_kernel/LazyLoadResource.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/core/exceptions.h>
+#include <mrpt/core/get_env.h>
+#include <mrpt/core/lock_helper.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/obs/CObservation.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#if !defined(_WIN32)
+#define MOLA_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define MOLA_HAS_MMAP 0
+#endif
+
 using namespace mola;
 
-static const int GZ_COMPRESS_LEVEL = 0;
+int LazyLoadResource::GZ_COMPRESS_LEVEL =
+    mrpt::get_env<int>("MOLA_GZ_COMPRESS_LEVEL", 1);
+
+/** Magic header prepended to files written in the mmap-friendly raw format,
+ * so load() can tell them apart from legacy gz archives. */
+static const char MMAP_MAGIC[8] = {'M', 'O', 'L', 'A', 'M', 'M', 'A', 'P'};
 
 std::string LazyLoadResource::EXTERNAL_BASE_DIR{""};
+bool        LazyLoadResource::MMAP_STORAGE =
+    mrpt::get_env<bool>("MOLA_MMAP_STORAGE", false);
+
+unsigned int LazyLoadResource::DIR_SHARD_SIZE = static_cast<unsigned int>(
+    mrpt::get_env<int>("MOLA_MAP_DIR_SHARD_SIZE", 1000));
+
+unsigned int LazyLoadResource::FSYNC_BATCH =
+    static_cast<unsigned int>(mrpt::get_env<int>("MOLA_MAP_FSYNC_BATCH", 64));
+
+namespace
+{
+/** Shared background writer for all LazyLoadResource instances: unload() just
+ * enqueues (abs_file -> object) here and a worker thread does the actual
+ * serialization, so the caller (e.g. WorldModel::spinOnce unload sweeps)
+ * never blocks on disk I/O. One entry per file also gives us write
+ * coalescing: re-unloading the same entity only updates the queued pointer.
+ */
+struct PendingWrites
+{
+    std::mutex mtx;
+    std::map<std::string, mrpt::serialization::CSerializable::Ptr> queued;
+
+    mrpt::WorkerThreadsPool pool{
+        1, mrpt::WorkerThreadsPool::POLICY_FIFO, "lazyload_writer"};
+
+    /// See LazyLoadResource::FSYNC_BATCH:
+    std::atomic<unsigned int> writesSinceSync{0};
+};
+
+PendingWrites& pendingWrites()
+{
+    static PendingWrites pw;
+    return pw;
+}
+
+/** Per-file (uncompressed, compressed) sizes of everything swapped off by
+ * this process, so the working-set memory budget can use real in-RAM sizes
+ * while disk accounting sees the compressed ones. */
+struct StoredSizes
+{
+    std::mutex                                               mtx;
+    std::map<std::string, std::pair<uint64_t, uint64_t>>     sizes;
+};
+
+StoredSizes& storedSizesRegistry()
+{
+    static StoredSizes ss;
+    return ss;
+}
+
+void registerStoredSizes(
+    const std::string& fil, const uint64_t raw, const uint64_t compressed)
+{
+    auto& ss  = storedSizesRegistry();
+    auto  lck = mrpt::lockHelper(ss.mtx);
+    ss.sizes[fil] = {raw, compressed};
+}
+
+/** Writes `obj` in the mmap-friendly raw format (magic + uncompressed
+ * archive). Returns false if unsupported on this platform. */
+bool writeRawForMMap(
+    const std::string& fil, const mrpt::serialization::CSerializable::Ptr& obj)
+{
+#if MOLA_HAS_MMAP
+    mrpt::io::CFileOutputStream f;
+    if (!f.open(fil))
+        THROW_EXCEPTION_FMT("Cannot write to file: `%s`", fil.c_str());
+    f.Write(MMAP_MAGIC, sizeof(MMAP_MAGIC));
+    auto a = mrpt::serialization::archiveFrom(f);
+    a << obj;
+    return true;
+#else
+    (void)fil;
+    (void)obj;
+    return false;
+#endif
+}
+
+/** If `fil` is in the raw mmap format, maps it and deserializes the object
+ * straight from the mapped pages (no read() copies; the kernel pages data in
+ * on demand). Returns nullptr if the file is a legacy gz archive. */
+mrpt::serialization::CSerializable::Ptr tryLoadMMapped(const std::string& fil)
+{
+#if MOLA_HAS_MMAP
+    const int fd = ::open(fil.c_str(), O_RDONLY);
+    if (fd < 0) return {};
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 ||
+        st.st_size <= static_cast<off_t>(sizeof(MMAP_MAGIC)))
+    {
+        ::close(fd);
+        return {};
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+
+    void* base = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps its own reference
+    if (base == MAP_FAILED) return {};
+
+    mrpt::serialization::CSerializable::Ptr obj;
+    if (std::memcmp(base, MMAP_MAGIC, sizeof(MMAP_MAGIC)) == 0)
+    {
+        try
+        {
+            // Wrap the mapped region in a non-owning memory stream:
+            mrpt::io::CMemoryStream m;
+            // (the stream only reads from it; the region is PROT_READ)
+            m.assignMemoryBlock(
+                reinterpret_cast<char*>(base) + sizeof(MMAP_MAGIC),
+                size - sizeof(MMAP_MAGIC));
+            auto a = mrpt::serialization::archiveFrom(m);
+            obj    = a.ReadObject();
+        }
+        catch (...)
+        {
+            obj.reset();
+        }
+    }
+    ::munmap(base, size);
+    return obj;
+#else
+    (void)fil;
+    return {};
+#endif
+}
+
+/** One sync barrier for a whole batch of swapped-off files, instead of a
+ * per-file fsync() (see LazyLoadResource::FSYNC_BATCH). */
+void syncStorageDir()
+{
+#if !defined(_WIN32)
+    const int fd = ::open(
+        LazyLoadResource::EXTERNAL_BASE_DIR.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return;
+#if defined(__linux__)
+    ::syncfs(fd);
+#else
+    ::fsync(fd);
+#endif
+    ::close(fd);
+#endif
+}
+
+void backgroundWriteToDisk(const std::string fil)
+{
+    auto& pw = pendingWrites();
+
+    mrpt::serialization::CSerializable::Ptr obj;
+    {
+        auto lck = mrpt::lockHelper(pw.mtx);
+        auto it  = pw.queued.find(fil);
+        // Already written by a previous task, or cancelled by a load():
+        if (it == pw.queued.end()) return;
+        obj = it->second;
+    }
+
+    // Ensure the shard subdirectory exists (cheap no-op if it does):
+    if (const auto dir = mrpt::system::extractFileDirectory(fil);
+        !mrpt::system::directoryExists(dir))
+        mrpt::system::createDirectory(dir);
+
+    try
+    {
+        bool written = false;
+        if (LazyLoadResource::MMAP_STORAGE)
+            written = writeRawForMMap(fil, obj);
+        if (!written)
+        {
+            // Serialize to memory first, so the uncompressed payload size is
+            // known for the working-set accounting, then push the whole block
+            // through the compressing stream:
+            mrpt::io::CMemoryStream m;
+            {
+                auto am = mrpt::serialization::archiveFrom(m);
+                am << obj;
+            }
+            const auto rawSize =
+                static_cast<uint64_t>(m.getTotalBytesCount());
+
+            {
+                mrpt::io::CFileGZOutputStream f;
+                if (!f.open(fil, LazyLoadResource::GZ_COMPRESS_LEVEL))
+                    THROW_EXCEPTION_FMT(
+                        "Cannot write to file: `%s`", fil.c_str());
+                f.Write(m.getRawBufferData(), rawSize);
+            }
+
+            registerStoredSizes(fil, rawSize, mrpt::system::getFileSize(fil));
+        }
+    }
+    catch (const std::exception& e)
+    {
+        // The task future is discarded, so a throw here would vanish while
+        // leaving the entry in `queued` forever, wedging
+        // flushAllPendingWrites() and pinning the object in memory. Log the
+        // failure and drop the queued entry (unless a newer version was
+        // queued meanwhile; that one will be retried by its own task):
+        std::cerr << "[LazyLoadResource] Error writing `" << fil
+                  << "` to disk:\n"
+                  << mrpt::exception_to_str(e) << "\n";
+        auto lck = mrpt::lockHelper(pw.mtx);
+        if (auto it = pw.queued.find(fil);
+            it != pw.queued.end() && it->second == obj)
+            pw.queued.erase(it);
+        return;
+    }
+
+    // Batched durability: one sync barrier per FSYNC_BATCH files written,
+    // instead of a per-file fsync():
+    if (const auto batch = LazyLoadResource::FSYNC_BATCH; batch != 0)
+    {
+        if (++pw.writesSinceSync >= batch)
+        {
+            pw.writesSinceSync = 0;
+            syncStorageDir();
+        }
+    }
+
+    bool isFinalVersion = false;
+    {
+        auto lck = mrpt::lockHelper(pw.mtx);
+        auto it  = pw.queued.find(fil);
+        if (it != pw.queued.end() && it->second == obj)
+        {
+            pw.queued.erase(it);
+            isFinalVersion = true;
+        }
+    }
+
+    // Recursive unload of externally-stored observation parts, but only if
+    // nobody re-loaded the object while we were writing it:
+    if (isFinalVersion)
+    {
+        if (auto o = dynamic_cast<mrpt::obs::CObservation*>(obj.get());
+            o != nullptr)
+            o->unload();
+    }
+}
+}  // namespace
+
+std::pair<uint64_t, uint64_t> LazyLoadResource::storedSizes(
+    const std::string& absFileName)
+{
+    auto& ss  = storedSizesRegistry();
+    auto  lck = mrpt::lockHelper(ss.mtx);
+    if (const auto it = ss.sizes.find(absFileName); it != ss.sizes.end())
+        return it->second;
+    return {0, 0};
+}
+
+void LazyLoadResource::flushAllPendingWrites()
+{
+    auto& pw = pendingWrites();
+    for (;;)
+    {
+        {
+            auto lck = mrpt::lockHelper(pw.mtx);
+            if (pw.queued.empty() && pw.pool.pendingTasks() == 0)
+            {
+                // Everything written: close the current durability batch.
+                if (FSYNC_BATCH != 0) syncStorageDir();
+                return;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
 
 const std::string& LazyLoadResource::buildAbsoluteFilePath() const
 {
     if (cached_file_ok_) return cached_abs_fil_;
 
-    cached_abs_fil_ = mrpt::format(
+    ASSERT_(!EXTERNAL_BASE_DIR.empty());
+
+    auto baseName = mrpt::format(
         "ent_%06lu_%s", static_cast<long unsigned>(parent_entity_id_),
         external_filename_.c_str());
+    baseName = mrpt::system::fileNameStripInvalidChars(baseName);
 
-    cached_abs_fil_ = mrpt::system::fileNameStripInvalidChars(cached_abs_fil_);
+    if (DIR_SHARD_SIZE > 0 && parent_entity_id_ != INVALID_ID)
+    {
+        const auto shard = mrpt::format(
+            "shard_%04lu/",
+            static_cast<long unsigned>(parent_entity_id_ / DIR_SHARD_SIZE));
+        cached_abs_fil_ = EXTERNAL_BASE_DIR + shard + baseName;
 
-    ASSERT_(!EXTERNAL_BASE_DIR.empty());
-    cached_abs_fil_ = EXTERNAL_BASE_DIR + cached_abs_fil_;
+        // Maps written with the legacy flat layout keep loading: fall back
+        // if the sharded file does not exist but the flat one does.
+        if (!mrpt::system::fileExists(cached_abs_fil_) &&
+            mrpt::system::fileExists(EXTERNAL_BASE_DIR + baseName))
+            cached_abs_fil_ = EXTERNAL_BASE_DIR + baseName;
+    }
+    else
+    {
+        cached_abs_fil_ = EXTERNAL_BASE_DIR + baseName;
+    }
 
     cached_file_ok_ = true;
     return cached_abs_fil_;
@@ -60,14 +372,41 @@ void LazyLoadResource::load() const
             "Trying to load() a swapped-off resource without an associated "
             "external file");
 
-    mrpt::io::CFileGZInputStream f;
-    if (!f.open(fil))
-        THROW_EXCEPTION_FMT("Cannot read from file: `%s`", fil.c_str());
+    // Still waiting in the background write queue? Recover it from there
+    // (and cancel the write: the data is hot again; a future unload() will
+    // re-enqueue it):
+    {
+        auto& pw  = pendingWrites();
+        auto  lck = mrpt::lockHelper(pw.mtx);
+        if (auto it = pw.queued.find(fil); it != pw.queued.end())
+        {
+            data_ = it->second;
+            pw.queued.erase(it);
+            return;
+        }
+    }
 
-    auto a = mrpt::serialization::archiveFrom(f);
-    data_  = a.ReadObject();
+    // Fast path: files in the raw format are mmap()ed and deserialized
+    // in-place, skipping the gz stream entirely:
+    if (auto obj = tryLoadMMapped(fil); obj) { data_ = obj; }
+    else
+    {
+        mrpt::io::CFileGZInputStream f;
+        if (!f.open(fil))
+            THROW_EXCEPTION_FMT("Cannot read from file: `%s`", fil.c_str());
+
+        auto a = mrpt::serialization::archiveFrom(f);
+        data_  = a.ReadObject();
+    }
     ASSERTMSG_(data_, "Could not load resource from external storage");
 
+    // Prefer the recorded uncompressed size; file sizes under-estimate the
+    // in-RAM footprint once compression is on:
+    if (const auto [raw, comp] = storedSizes(fil); raw != 0)
+        approx_size_ = raw;
+    else
+        approx_size_ = mrpt::system::getFileSize(fil);
+
     if (auto obj = dynamic_cast<mrpt::obs::CObservation*>(data_.get());
         obj != nullptr)
     {
@@ -86,8 +425,55 @@ void LazyLoadResource::setAsExternal(const std::string& relativeFileName)
 
 bool LazyLoadResource::isUnloaded() const { return !data_; }
 
+std::size_t LazyLoadResource::approxMemoryFootprint() const
+{
+    if (!data_) return 0;
+    if (approx_size_ == 0 && !external_filename_.empty())
+    {
+        const auto& fil = buildAbsoluteFilePath();
+
+        // Prefer the uncompressed payload size recorded at write time; the
+        // external file size (compressed) is only a fallback proxy for
+        // files written by a previous run:
+        if (const auto [raw, comp] = storedSizes(fil); raw != 0)
+            approx_size_ = raw;
+        else if (mrpt::system::fileExists(fil))
+            approx_size_ = mrpt::system::getFileSize(fil);
+    }
+    return approx_size_;
+}
+
+LazyLoadResource& LazyLoadResource::operator=(const LazyLoadResource& o)
+{
+    if (this == &o) return *this;
+    data_              = o.data_;
+    external_filename_ = o.external_filename_;
+    parent_entity_id_  = o.parent_entity_id_;
+    cached_abs_fil_    = o.cached_abs_fil_;
+    cached_file_ok_    = o.cached_file_ok_;
+    approx_size_       = o.approx_size_;
+    // pin_count_ deliberately untouched: see header docs.
+    return *this;
+}
+
+LazyLoadResource& LazyLoadResource::operator=(LazyLoadResource&& o) noexcept
+{
+    if (this == &o) return *this;
+    data_              = std::move(o.data_);
+    external_filename_ = std::move(o.external_filename_);
+    parent_entity_id_  = o.parent_entity_id_;
+    cached_abs_fil_    = std::move(o.cached_abs_fil_);
+    cached_file_ok_    = o.cached_file_ok_;
+    approx_size_       = o.approx_size_;
+    // pin_count_ deliberately untouched: see header docs.
+    return *this;
+}
+
 void LazyLoadResource::unload() const
 {
+    // Pinned resources are exempt from eviction while in use (see pin()):
+    if (isPinned()) return;
+
     const auto& fil = buildAbsoluteFilePath();
 
     if (data_ && external_filename_.empty())
@@ -99,18 +485,19 @@ void LazyLoadResource::unload() const
     // needed
 
     // If the file already exists, assume it's up-to-date and dont overwrite.
-    if (!mrpt::system::fileExists(fil))
+    if (data_ && !mrpt::system::fileExists(fil))
     {
-        mrpt::io::CFileGZOutputStream f;
-        if (!f.open(fil, GZ_COMPRESS_LEVEL))
-            THROW_EXCEPTION_FMT("Cannot write to file: `%s`", fil.c_str());
-
-        auto a = mrpt::serialization::archiveFrom(f);
-        a << data_;
+        // Hand over to the background writer thread; the recursive unload of
+        // externally-stored parts also happens there, after the write:
+        auto& pw = pendingWrites();
+        {
+            auto lck        = mrpt::lockHelper(pw.mtx);
+            pw.queued[fil]  = data_;  // coalesce: latest version wins
+        }
+        pw.pool.enqueue(&backgroundWriteToDisk, fil);
     }
-
-    if (auto obj = dynamic_cast<mrpt::obs::CObservation*>(data_.get());
-        obj != nullptr)
+    else if (auto obj = dynamic_cast<mrpt::obs::CObservation*>(data_.get());
+             obj != nullptr)
     {
         // Recursive unload from external storage:
         obj->unload();
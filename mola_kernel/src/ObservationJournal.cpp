@@ -0,0 +1,377 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ObservationJournal.cpp
+ * @brief  Low-overhead observation recorder & bit-exact replay source
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_kernel/ObservationJournal.h>
+#include <mola_yaml/yaml_helpers.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/obs/CSensoryFrame.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/thread_name.h>
+
+#include <chrono>
+#include <cstring>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+using namespace mola;
+
+// arguments: class_name, parent_class, class namespace
+IMPLEMENTS_MRPT_OBJECT(ObservationJournal, ExecutableBase, mola)
+IMPLEMENTS_MRPT_OBJECT(ObservationJournalReplay, RawDataSourceBase, mola)
+
+namespace
+{
+constexpr char    JOURNAL_MAGIC[8]  = "MOLAJRN";  // 7 chars + NUL
+constexpr uint8_t JOURNAL_VERSION   = 1;
+constexpr size_t  JOURNAL_HDR_BYTES = sizeof(JOURNAL_MAGIC) + 1;
+
+void fsync_file([[maybe_unused]] std::FILE* f)
+{
+#if defined(__unix__)
+    if (f) ::fsync(::fileno(f));
+#endif
+}
+}  // namespace
+
+// =====================================
+// ObservationJournal (recorder)
+// =====================================
+ObservationJournal::ObservationJournal() = default;
+
+ObservationJournal::~ObservationJournal()
+{
+    writer_stop_ = true;
+    queue_cv_.notify_all();
+    if (writer_thread_.joinable()) writer_thread_.join();
+
+    if (dataFile_)
+    {
+        std::fflush(dataFile_);
+        fsync_file(dataFile_);
+        std::fclose(dataFile_);
+        dataFile_ = nullptr;
+    }
+    if (idxFile_)
+    {
+        std::fflush(idxFile_);
+        fsync_file(idxFile_);
+        std::fclose(idxFile_);
+        idxFile_ = nullptr;
+    }
+    MRPT_LOG_INFO_STREAM(
+        "Journal closed: " << recordCount_ << " observations in '"
+                           << journal_file_ << "'");
+}
+
+void ObservationJournal::initialize(const Yaml& c)
+{
+    MRPT_TRY_START
+
+    // Subscribe to the requested data source module(s), as front-ends do:
+    ENSURE_YAML_ENTRY_EXISTS(c, "raw_data_source");
+    std::vector<std::string> srcNames;
+    const auto               ds = c["raw_data_source"];
+    if (ds.isSequence())
+        for (const auto& v : ds.asSequence())
+            srcNames.push_back(v.as<std::string>());
+    else
+        srcNames.push_back(ds.as<std::string>());
+
+    for (const auto& srcName : srcNames)
+    {
+        ASSERT_(this->nameServer_);
+        auto dataSrc = nameServer_(srcName);
+        if (!dataSrc)
+            THROW_EXCEPTION_FMT(
+                "Cannot find data source module named `%s`", srcName.c_str());
+        auto rdsb = std::dynamic_pointer_cast<RawDataSourceBase>(dataSrc);
+        if (!rdsb)
+            THROW_EXCEPTION_FMT(
+                "Could not cast data source module named `%s` to "
+                "RawDataSourceBase",
+                srcName.c_str());
+        rdsb->attachToDataConsumer(*this);
+    }
+
+    ENSURE_YAML_ENTRY_EXISTS(c, "params");
+    auto cfg = c["params"];
+    YAML_LOAD_MEMBER_REQ(journal_file, std::string);
+    YAML_LOAD_MEMBER_OPT(fsync_period, double);
+    ASSERT_GT_(fsync_period_, .0);
+
+    dataFile_ = std::fopen(journal_file_.c_str(), "wb");
+    if (!dataFile_)
+        THROW_EXCEPTION_FMT(
+            "Cannot create journal file '%s'", journal_file_.c_str());
+    idxFile_ = std::fopen((journal_file_ + ".idx").c_str(), "wb");
+    if (!idxFile_)
+        THROW_EXCEPTION_FMT(
+            "Cannot create journal index file '%s.idx'",
+            journal_file_.c_str());
+
+    std::fwrite(JOURNAL_MAGIC, 1, sizeof(JOURNAL_MAGIC), dataFile_);
+    std::fwrite(&JOURNAL_VERSION, 1, 1, dataFile_);
+    writeOffset_ = JOURNAL_HDR_BYTES;
+
+    writer_thread_ =
+        std::thread(&ObservationJournal::writer_thread_fn, this);
+
+    MRPT_LOG_INFO_STREAM("Journaling observations to '" << journal_file_
+                                                        << "'");
+    MRPT_TRY_END
+}
+
+void ObservationJournal::spinOnce()
+{
+    // All work happens in onNewObservation() + the writer thread.
+}
+
+void ObservationJournal::onNewObservation(const CObservation::Ptr& o)
+{
+    ASSERT_(o);
+    {
+        std::lock_guard<std::mutex> lck(queue_mtx_);
+        queue_.push_back(o);
+    }
+    queue_cv_.notify_one();
+}
+
+void ObservationJournal::write_record(const CObservation::Ptr& obs)
+{
+    // Raw binary image of the observation, exactly as CArchive streams it:
+    mrpt::io::CMemoryStream m;
+    auto                    arch = mrpt::serialization::archiveFrom(m);
+    arch << *obs;
+
+    const double   tim = mrpt::Clock::toDouble(obs->timestamp);
+    const uint32_t len = static_cast<uint32_t>(m.getTotalBytesCount());
+
+    bool ok = std::fwrite(&tim, sizeof(tim), 1, dataFile_) == 1 &&
+              std::fwrite(&len, sizeof(len), 1, dataFile_) == 1 &&
+              std::fwrite(m.getRawBufferData(), 1, len, dataFile_) == len;
+
+    ok = ok && std::fwrite(&tim, sizeof(tim), 1, idxFile_) == 1 &&
+         std::fwrite(&writeOffset_, sizeof(writeOffset_), 1, idxFile_) == 1;
+
+    if (!ok)
+        THROW_EXCEPTION_FMT(
+            "I/O error writing journal '%s' (disk full?)",
+            journal_file_.c_str());
+
+    writeOffset_ += sizeof(tim) + sizeof(len) + len;
+    recordCount_++;
+}
+
+void ObservationJournal::writer_thread_fn()
+{
+    using namespace std::chrono_literals;
+
+    mrpt::system::thread_name("obsJournalWriter");
+
+    double lastFsync = mrpt::Clock::nowDouble();
+
+    std::deque<CObservation::Ptr> batch;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lck(queue_mtx_);
+            queue_cv_.wait_for(
+                lck, 100ms,
+                [this] { return writer_stop_.load() || !queue_.empty(); });
+            batch.swap(queue_);
+        }
+
+        try
+        {
+            for (const auto& obs : batch) write_record(obs);
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM("Stopping journal writer: " << e.what());
+            return;
+        }
+
+        if (!batch.empty())
+        {
+            std::fflush(dataFile_);
+            std::fflush(idxFile_);
+            batch.clear();
+        }
+
+        // Batched durability: one fsync per period, not per observation.
+        const double now = mrpt::Clock::nowDouble();
+        if (now - lastFsync >= fsync_period_)
+        {
+            fsync_file(dataFile_);
+            fsync_file(idxFile_);
+            lastFsync = now;
+        }
+
+        if (writer_stop_)
+        {
+            std::lock_guard<std::mutex> lck(queue_mtx_);
+            if (queue_.empty()) return;  // final drain done
+        }
+    }
+}
+
+// =====================================
+// ObservationJournalReplay
+// =====================================
+ObservationJournalReplay::ObservationJournalReplay() = default;
+
+ObservationJournalReplay::~ObservationJournalReplay()
+{
+    if (dataFile_)
+    {
+        std::fclose(dataFile_);
+        dataFile_ = nullptr;
+    }
+}
+
+void ObservationJournalReplay::initialize_rds(const Yaml& c)
+{
+    MRPT_TRY_START
+
+    ENSURE_YAML_ENTRY_EXISTS(c, "params");
+    auto cfg = c["params"];
+    YAML_LOAD_MEMBER_REQ(journal_file, std::string);
+    YAML_LOAD_MEMBER_OPT(time_warp, double);
+    ASSERT_GT_(time_warp_, .0);
+
+    dataFile_ = std::fopen(journal_file_.c_str(), "rb");
+    if (!dataFile_)
+        THROW_EXCEPTION_FMT(
+            "Cannot open journal file '%s'", journal_file_.c_str());
+
+    char    magic[sizeof(JOURNAL_MAGIC)];
+    uint8_t version = 0;
+    if (std::fread(magic, 1, sizeof(magic), dataFile_) != sizeof(magic) ||
+        std::memcmp(magic, JOURNAL_MAGIC, sizeof(magic)) != 0 ||
+        std::fread(&version, 1, 1, dataFile_) != 1)
+        THROW_EXCEPTION_FMT(
+            "'%s' is not an observation journal file", journal_file_.c_str());
+    ASSERT_EQUAL_(version, JOURNAL_VERSION);
+
+    // Prefer the sidecar index; rebuild by scanning if it is missing
+    // (e.g. lost in a crash):
+    if (std::FILE* idx = std::fopen((journal_file_ + ".idx").c_str(), "rb");
+        idx != nullptr)
+    {
+        IndexEntry e;
+        while (std::fread(&e.tim, sizeof(e.tim), 1, idx) == 1 &&
+               std::fread(&e.offset, sizeof(e.offset), 1, idx) == 1)
+            index_.push_back(e);
+        std::fclose(idx);
+    }
+    else
+    {
+        MRPT_LOG_WARN_STREAM(
+            "Journal index '" << journal_file_
+                              << ".idx' not found: scanning the journal.");
+        build_index_by_scanning();
+    }
+
+    MRPT_LOG_INFO_STREAM(
+        "Replaying journal '" << journal_file_ << "': " << index_.size()
+                              << " observations.");
+    MRPT_TRY_END
+}
+
+void ObservationJournalReplay::build_index_by_scanning()
+{
+    uint64_t offset = JOURNAL_HDR_BYTES;
+    for (;;)
+    {
+        IndexEntry e;
+        e.offset = offset;
+
+        uint32_t len = 0;
+        if (std::fseek(dataFile_, static_cast<long>(offset), SEEK_SET) != 0 ||
+            std::fread(&e.tim, sizeof(e.tim), 1, dataFile_) != 1 ||
+            std::fread(&len, sizeof(len), 1, dataFile_) != 1)
+            break;  // clean EOF, or a truncated trailing record: stop here
+
+        index_.push_back(e);
+        offset += sizeof(e.tim) + sizeof(len) + len;
+    }
+}
+
+CObservation::Ptr ObservationJournalReplay::read_record(size_t i) const
+{
+    ASSERT_LT_(i, index_.size());
+
+    std::vector<uint8_t> buf;
+    double               tim = 0;
+    {
+        std::lock_guard<std::mutex> lck(file_mtx_);
+
+        if (std::fseek(
+                dataFile_, static_cast<long>(index_[i].offset), SEEK_SET) != 0)
+            THROW_EXCEPTION("Cannot seek in journal file");
+
+        uint32_t len = 0;
+        if (std::fread(&tim, sizeof(tim), 1, dataFile_) != 1 ||
+            std::fread(&len, sizeof(len), 1, dataFile_) != 1)
+            THROW_EXCEPTION("Truncated journal record header");
+
+        buf.resize(len);
+        if (std::fread(buf.data(), 1, len, dataFile_) != len)
+            THROW_EXCEPTION("Truncated journal record payload");
+    }
+
+    mrpt::io::CMemoryStream m;
+    m.assignMemoryNotOwn(buf.data(), buf.size());
+    auto arch = mrpt::serialization::archiveFrom(m);
+
+    auto obs =
+        std::dynamic_pointer_cast<mrpt::obs::CObservation>(arch.ReadObject());
+    ASSERTMSG_(obs, "Journal record is not a CObservation");
+    return obs;
+}
+
+size_t ObservationJournalReplay::datasetSize() const { return index_.size(); }
+
+mrpt::obs::CSensoryFrame::Ptr ObservationJournalReplay::datasetGetObservations(
+    size_t timestep) const
+{
+    auto sf = mrpt::obs::CSensoryFrame::Create();
+    sf->insert(read_record(timestep));
+    return sf;
+}
+
+void ObservationJournalReplay::spinOnce()
+{
+    MRPT_TRY_START
+
+    if (index_.empty() || playbackEnded_) return;
+
+    const double now = mrpt::Clock::nowDouble();
+    if (replayStartWall_ <= 0) replayStartWall_ = now;
+
+    // Virtual dataset clock, anchored at the first spin:
+    const double cur =
+        index_.front().tim + (now - replayStartWall_) * time_warp_;
+
+    while (nextEntry_ < index_.size() && index_[nextEntry_].tim <= cur)
+        sendObservationsToFrontEnds(read_record(nextEntry_++));
+
+    if (nextEntry_ >= index_.size())
+    {
+        playbackEnded_ = true;
+        onDatasetPlaybackEnds();
+    }
+
+    MRPT_TRY_END
+}
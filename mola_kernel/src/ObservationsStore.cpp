@@ -0,0 +1,155 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ObservationsStore.cpp
+ * @brief  Content-addressed shared store of raw keyframe observations
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_kernel/ObservationsStore.h>
+#include <mrpt/core/get_env.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <cstring>  // strlen()
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace mola;
+
+namespace
+{
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME  = 0x00000100000001b3ULL;
+
+uint64_t fnv1a(const void* data, size_t len, uint64_t h = FNV_OFFSET)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < len; i++)
+    {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+/** Cheap pre-key: identical observations always collide here, everything
+ * else almost never does, so the expensive content hash is only computed
+ * for actual duplicate suspects. */
+uint64_t cheapKey(const mrpt::obs::CObservation& o)
+{
+    uint64_t    h  = FNV_OFFSET;
+    const char* cn = o.GetRuntimeClass()->className;
+    h              = fnv1a(cn, std::strlen(cn), h);
+    h = fnv1a(o.sensorLabel.data(), o.sensorLabel.size(), h);
+    const int64_t t = o.timestamp.time_since_epoch().count();
+    h               = fnv1a(&t, sizeof(t), h);
+    return h;
+}
+
+struct Entry
+{
+    uint64_t content_hash = 0;  //!< 0 = not computed yet
+    std::weak_ptr<mrpt::obs::CObservation> obs;
+};
+
+struct StoreState
+{
+    std::mutex mtx;
+    /** cheapKey -> candidate duplicates of that (class,label,timestamp) */
+    std::unordered_map<uint64_t, std::vector<Entry>> buckets;
+    ObservationsStore::Stats                         stats;
+};
+
+StoreState& theStore()
+{
+    static StoreState s;
+    return s;
+}
+}  // namespace
+
+bool ObservationsStore::enabled()
+{
+    static const bool e = mrpt::get_env<bool>("MOLA_DEDUP_OBSERVATIONS", true);
+    return e;
+}
+
+uint64_t ObservationsStore::contentHash(
+    const mrpt::serialization::CSerializable& o)
+{
+    mrpt::io::CMemoryStream buf;
+    auto                    arch = mrpt::serialization::archiveFrom(buf);
+    arch << o;
+    return fnv1a(
+        buf.getRawBufferData(),
+        static_cast<size_t>(buf.getTotalBytesCount()));
+}
+
+mrpt::obs::CObservation::Ptr ObservationsStore::intern(
+    const mrpt::obs::CObservation::Ptr& obs)
+{
+    if (!obs || !enabled()) return obs;
+
+    auto&      st  = theStore();
+    const auto key = cheapKey(*obs);
+
+    std::lock_guard<std::mutex> lck(st.mtx);
+    st.stats.interned++;
+
+    auto& bucket = st.buckets[key];
+
+    // Lazy purge of entries whose last owner is gone:
+    for (size_t i = 0; i < bucket.size();)
+    {
+        if (bucket[i].obs.expired())
+        {
+            bucket[i] = std::move(bucket.back());
+            bucket.pop_back();
+        }
+        else
+            i++;
+    }
+
+    if (bucket.empty())
+    {
+        // Common path: first sight of this (class,label,timestamp); no
+        // serialization needed at all:
+        bucket.push_back({0, obs});
+        return obs;
+    }
+
+    // Duplicate suspected: now pay for the exact content hashes.
+    const auto h = contentHash(*obs);
+    for (auto& e : bucket)
+    {
+        auto existing = e.obs.lock();
+        if (!existing) continue;
+        if (e.content_hash == 0) e.content_hash = contentHash(*existing);
+        if (e.content_hash != h) continue;
+
+        if (existing != obs) st.stats.deduplicated++;
+        return existing;
+    }
+    bucket.push_back({h, obs});
+    return obs;
+}
+
+void ObservationsStore::internInPlace(mrpt::obs::CSensoryFrame& sf)
+{
+    if (!enabled()) return;
+    for (auto& o : sf)
+        if (o) o = intern(o);
+}
+
+ObservationsStore::Stats ObservationsStore::stats()
+{
+    auto&                       st = theStore();
+    std::lock_guard<std::mutex> lck(st.mtx);
+    return st.stats;
+}
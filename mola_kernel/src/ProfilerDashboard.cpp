@@ -0,0 +1,271 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ProfilerDashboard.cpp
+ * @brief  Module exporting all modules' profiler stats over HTTP
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 14, 2024
+ */
+
+#include <mola_kernel/FastAllocator.h>
+#include <mola_kernel/ProfilerDashboard.h>
+#include <mola_yaml/yaml_helpers.h>
+#include <mrpt/core/lock_helper.h>
+#include <mrpt/system/thread_name.h>
+
+#include <cstring>
+
+#if defined(__unix__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+using namespace mola;
+
+// arguments: class_name, parent_class, class namespace
+IMPLEMENTS_MRPT_OBJECT(ProfilerDashboard, ExecutableBase, mola)
+
+namespace
+{
+/** Escapes `"` and `\` for use inside JSON strings & Prometheus labels */
+std::string escape_label(const std::string& s)
+{
+    std::string r;
+    r.reserve(s.size());
+    for (const char c : s)
+    {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r;
+}
+}  // namespace
+
+ProfilerDashboard::ProfilerDashboard() = default;
+
+ProfilerDashboard::~ProfilerDashboard()
+{
+    http_stop_ = true;
+    if (http_thread_.joinable()) http_thread_.join();
+}
+
+void ProfilerDashboard::initialize(const Yaml& c)
+{
+    MRPT_TRY_START
+
+    if (c.has("params"))
+    {
+        auto cfg = c["params"];
+        YAML_LOAD_MEMBER_OPT(http_port, unsigned int);
+        YAML_LOAD_MEMBER_OPT(snapshot_period, double);
+    }
+    ASSERT_GT_(snapshot_period_, .0);
+
+#if defined(__unix__)
+    http_thread_ = std::thread(&ProfilerDashboard::http_server_thread, this);
+#else
+    MRPT_LOG_WARN(
+        "No POSIX sockets on this platform: profiler snapshots will be taken "
+        "but the HTTP endpoint is unavailable.");
+#endif
+
+    MRPT_TRY_END
+}
+
+void ProfilerDashboard::spinOnce()
+{
+    MRPT_TRY_START
+
+    const double tNow = mrpt::Clock::nowDouble();
+    if (tNow - lastSnapshotTime_ < snapshot_period_) return;
+
+    take_snapshot();
+    lastSnapshotTime_ = tNow;
+
+    MRPT_TRY_END
+}
+
+void ProfilerDashboard::take_snapshot()
+{
+    using namespace std::string_literals;
+
+    const double tNow = mrpt::Clock::nowDouble();
+    const double dt   = lastSnapshotTime_ > 0 ? tNow - lastSnapshotTime_ : 0;
+
+    std::string json =
+        mrpt::format("{\n\"timestamp\": %.3f,\n\"modules\": {\n", tNow);
+    std::string prom;
+
+    const auto mods = findService<ExecutableBase>();
+
+    bool firstMod = true;
+    for (const auto& mod : mods)
+    {
+        if (!mod) continue;
+
+        // Read-only pass over the profiler's call-stats map. Writers only
+        // touch their own entry's accumulators, so sampling is effectively
+        // contention-free; worst case a stat from the very last call is
+        // slightly stale, which is fine for a dashboard.
+        std::map<std::string, mrpt::system::CTimeLogger::TCallStats> stats;
+        mod->profiler_.getStats(stats);
+        if (stats.empty()) continue;
+
+        const auto modName = escape_label(mod->getModuleInstanceName());
+
+        if (!firstMod) json += ",\n";
+        firstMod = false;
+        json += "\""s + modName + "\": {\n"s;
+
+        bool firstEntry = true;
+        for (const auto& [entry, s] : stats)
+        {
+            const auto entryName = escape_label(entry);
+
+            // Call rate since the previous snapshot:
+            auto&  lastCalls = lastCallCounts_[modName + "/"s + entryName];
+            double rate      = 0;
+            if (dt > 0 && s.n_calls >= lastCalls)
+                rate = (s.n_calls - lastCalls) / dt;
+            lastCalls = s.n_calls;
+
+            if (!firstEntry) json += ",\n";
+            firstEntry = false;
+            json += mrpt::format(
+                "  \"%s\": {\"calls\": %lu, \"rate_hz\": %.3f, "
+                "\"min_s\": %.9f, \"mean_s\": %.9f, \"max_s\": %.9f, "
+                "\"last_s\": %.9f}",
+                entryName.c_str(), static_cast<unsigned long>(s.n_calls),
+                rate, s.min_t, s.mean_t, s.max_t, s.last_t);
+
+            const auto labels = mrpt::format(
+                "{module=\"%s\",entry=\"%s\"}", modName.c_str(),
+                entryName.c_str());
+            prom += mrpt::format(
+                "mola_profiler_calls_total%s %lu\n"
+                "mola_profiler_call_rate_hz%s %.3f\n"
+                "mola_profiler_min_seconds%s %.9f\n"
+                "mola_profiler_mean_seconds%s %.9f\n"
+                "mola_profiler_max_seconds%s %.9f\n"
+                "mola_profiler_last_seconds%s %.9f\n",
+                labels.c_str(), static_cast<unsigned long>(s.n_calls),
+                labels.c_str(), rate, labels.c_str(), s.min_t, labels.c_str(),
+                s.mean_t, labels.c_str(), s.max_t, labels.c_str(), s.last_t);
+        }
+        json += "\n}";
+    }
+    json += "\n},\n\"memory\": {\n";
+
+    // Per-module heap accounting (see mola::MemoryAccounting): one entry
+    // per module executor thread, plus "untagged" for everything else:
+    bool firstMem = true;
+    for (const auto& [name, st] : mola::MemoryAccounting::snapshot())
+    {
+        const auto memName = escape_label(name);
+
+        if (!firstMem) json += ",\n";
+        firstMem = false;
+        json += mrpt::format(
+            "  \"%s\": {\"bytes_in_use\": %ld, \"bytes_allocated\": %lu, "
+            "\"alloc_calls\": %lu, \"free_calls\": %lu}",
+            memName.c_str(), static_cast<long>(st.bytes_in_use),
+            static_cast<unsigned long>(st.bytes_allocated),
+            static_cast<unsigned long>(st.alloc_calls),
+            static_cast<unsigned long>(st.free_calls));
+
+        const auto labels =
+            mrpt::format("{module=\"%s\"}", memName.c_str());
+        prom += mrpt::format(
+            "mola_memory_bytes_in_use%s %ld\n"
+            "mola_memory_allocated_bytes_total%s %lu\n"
+            "mola_memory_alloc_calls_total%s %lu\n"
+            "mola_memory_free_calls_total%s %lu\n",
+            labels.c_str(), static_cast<long>(st.bytes_in_use),
+            labels.c_str(), static_cast<unsigned long>(st.bytes_allocated),
+            labels.c_str(), static_cast<unsigned long>(st.alloc_calls),
+            labels.c_str(), static_cast<unsigned long>(st.free_calls));
+    }
+    json += "\n}\n}\n";
+
+    {
+        auto lck     = mrpt::lockHelper(latest_mtx_);
+        latest_json_ = std::move(json);
+        latest_prom_ = std::move(prom);
+    }
+}
+
+void ProfilerDashboard::http_server_thread()
+{
+#if defined(__unix__)
+    mrpt::system::thread_name("profilerDashboardHttp");
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        MRPT_LOG_ERROR("Could not create HTTP server socket.");
+        return;
+    }
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(static_cast<uint16_t>(http_port_));
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, 4) != 0)
+    {
+        MRPT_LOG_ERROR_FMT(
+            "Could not listen on HTTP port %u.", http_port_);
+        ::close(fd);
+        return;
+    }
+    MRPT_LOG_INFO_FMT(
+        "Profiler dashboard listening on http://0.0.0.0:%u/ "
+        "(Prometheus: /metrics)",
+        http_port_);
+
+    while (!http_stop_)
+    {
+        pollfd pfd{fd, POLLIN, 0};
+        if (::poll(&pfd, 1, 200 /*ms*/) <= 0) continue;
+
+        const int client = ::accept(fd, nullptr, nullptr);
+        if (client < 0) continue;
+
+        char          buf[1024];
+        const ssize_t n = ::recv(client, buf, sizeof(buf) - 1, 0);
+        buf[n > 0 ? n : 0] = '\0';
+
+        const bool prometheus =
+            std::strncmp(buf, "GET /metrics", 12) == 0;
+
+        std::string body;
+        {
+            auto lck = mrpt::lockHelper(latest_mtx_);
+            body     = prometheus ? latest_prom_ : latest_json_;
+        }
+
+        const std::string resp =
+            mrpt::format(
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: %s\r\n"
+                "Content-Length: %zu\r\n"
+                "Connection: close\r\n\r\n",
+                prometheus ? "text/plain; version=0.0.4" : "application/json",
+                body.size()) +
+            body;
+
+        ::send(client, resp.data(), resp.size(), MSG_NOSIGNAL);
+        ::close(client);
+    }
+    ::close(fd);
+#endif
+}
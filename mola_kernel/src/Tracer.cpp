@@ -0,0 +1,191 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   Tracer.cpp
+ * @brief  System-wide low-overhead tracing of cross-module latency chains
+ * @author Jose Luis Blanco Claraco
+ * @date   Apr 2, 2024
+ */
+
+#include <mola_kernel/Tracer.h>
+#include <mrpt/core/get_env.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mola;
+
+namespace
+{
+constexpr size_t EVENTS_PER_THREAD = 1 << 16;  // ring buffer size
+constexpr size_t MAX_NAME_LEN      = 47;
+
+struct TraceEvent
+{
+    char     name[MAX_NAME_LEN + 1] = {0};
+    uint64_t t_start_us             = 0;
+    uint64_t t_end_us               = 0;
+    uint64_t spanId                 = 0;
+    uint64_t parentId               = 0;
+};
+
+/** Ring buffer of one thread; only its owner thread writes to it */
+struct ThreadTraceBuffer
+{
+    std::vector<TraceEvent> events{EVENTS_PER_THREAD};
+    std::atomic<uint64_t>   writeIdx{0};
+    uint64_t                threadId = 0;
+};
+
+struct TracerRegistry
+{
+    std::string traceFile = mrpt::get_env<std::string>("MOLA_TRACE", "");
+
+    std::mutex                                      buffersMtx;
+    std::vector<std::shared_ptr<ThreadTraceBuffer>> buffers;
+
+    std::atomic<uint64_t> nextSpanId{1};
+
+    ~TracerRegistry()
+    {
+        if (!traceFile.empty())
+        {
+            try
+            {
+                Tracer::dumpToFile(traceFile);
+            }
+            catch (...)
+            {
+            }
+        }
+    }
+};
+
+TracerRegistry& registry()
+{
+    static TracerRegistry r;
+    return r;
+}
+
+ThreadTraceBuffer& myThreadBuffer()
+{
+    thread_local std::shared_ptr<ThreadTraceBuffer> buf = []()
+    {
+        auto  b = std::make_shared<ThreadTraceBuffer>();
+        b->threadId =
+            std::hash<std::thread::id>()(std::this_thread::get_id()) & 0xffff;
+        auto& r   = registry();
+        auto  lck = std::lock_guard(r.buffersMtx);
+        r.buffers.push_back(b);
+        return b;
+    }();
+    return *buf;
+}
+
+uint64_t& tlsCurrentSpan()
+{
+    thread_local uint64_t current = 0;
+    return current;
+}
+}  // namespace
+
+bool Tracer::enabled()
+{
+    static const bool on = !registry().traceFile.empty();
+    return on;
+}
+
+uint64_t Tracer::newSpanId() { return registry().nextSpanId.fetch_add(1); }
+
+uint64_t Tracer::currentSpanId() { return tlsCurrentSpan(); }
+
+uint64_t Tracer::nowUs()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Tracer::recordEvent(
+    const char* name, const uint64_t t_start_us, const uint64_t t_end_us,
+    const uint64_t spanId, const uint64_t parentId)
+{
+    auto&          b   = myThreadBuffer();
+    const uint64_t idx = b.writeIdx.load(std::memory_order_relaxed);
+
+    TraceEvent& ev = b.events[idx % EVENTS_PER_THREAD];
+    std::strncpy(ev.name, name, MAX_NAME_LEN);
+    ev.t_start_us = t_start_us;
+    ev.t_end_us   = t_end_us;
+    ev.spanId     = spanId;
+    ev.parentId   = parentId;
+
+    // Publish after the payload is complete (the reader in dumpToFile()
+    // skips the slot currently being written):
+    b.writeIdx.store(idx + 1, std::memory_order_release);
+}
+
+void Tracer::dumpToFile(const std::string& fileName)
+{
+    auto& r = registry();
+
+    std::FILE* f = std::fopen(fileName.c_str(), "wt");
+    if (!f) return;
+
+    std::fprintf(f, "{\"traceEvents\":[\n");
+
+    bool first = true;
+    auto lck   = std::lock_guard(r.buffersMtx);
+    for (const auto& b : r.buffers)
+    {
+        const uint64_t end = b->writeIdx.load(std::memory_order_acquire);
+        const uint64_t begin =
+            end > EVENTS_PER_THREAD ? end - EVENTS_PER_THREAD : 0;
+        for (uint64_t i = begin; i < end; i++)
+        {
+            const TraceEvent& ev = b->events[i % EVENTS_PER_THREAD];
+            if (!ev.t_end_us) continue;
+            std::fprintf(
+                f,
+                "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%lu,"
+                "\"ts\":%lu,\"dur\":%lu,\"args\":{\"span\":%lu,"
+                "\"parent\":%lu}}",
+                first ? "" : ",\n", ev.name,
+                static_cast<unsigned long>(b->threadId),
+                static_cast<unsigned long>(ev.t_start_us),
+                static_cast<unsigned long>(ev.t_end_us - ev.t_start_us),
+                static_cast<unsigned long>(ev.spanId),
+                static_cast<unsigned long>(ev.parentId));
+            first = false;
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    std::fclose(f);
+}
+
+TraceSpan::TraceSpan(const char* name, const uint64_t parentId)
+{
+    if (!Tracer::enabled()) return;
+    active_   = true;
+    name_     = name;
+    parentId_ = parentId;
+    spanId_   = Tracer::newSpanId();
+    prevSpan_ = tlsCurrentSpan();
+    tlsCurrentSpan() = spanId_;
+    t0_              = Tracer::nowUs();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (!active_) return;
+    Tracer::recordEvent(name_, t0_, Tracer::nowUs(), spanId_, parentId_);
+    tlsCurrentSpan() = prevSpan_;
+}
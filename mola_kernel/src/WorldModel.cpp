@@ -14,8 +14,10 @@
  */
 
 #include <mola_kernel/FastAllocator.h>
+#include <mola_kernel/ObservationsStore.h>
 #include <mola_kernel/WorldModel.h>
 #include <mola_kernel/entities/KeyFrameBase.h>
+#include <mola_kernel/entities/KeyFramePODRecords.h>
 #include <mola_kernel/variant_helper.h>
 #include <mola_yaml/yaml_helpers.h>
 #include <mrpt/containers/yaml.h>
@@ -23,12 +25,23 @@
 #include <mrpt/core/lock_helper.h>
 #include <mrpt/io/CFileGZInputStream.h>
 #include <mrpt/io/CFileGZOutputStream.h>
+#include <mrpt/io/CFileInputStream.h>
+#include <mrpt/io/CFileOutputStream.h>
+#include <mrpt/io/CMemoryStream.h>
 #include <mrpt/serialization/CArchive.h>
 #include <mrpt/system/filesystem.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <deque>
+#include <limits>
 #include <map>
 #include <numeric>  // iota()
+#include <shared_mutex>
+#include <thread>
 #include <type_traits>
 
 using namespace mola;
@@ -84,7 +97,14 @@ struct WorldModelData::EntitiesContainer
     virtual Entity&                  by_id(const id_t id)       = 0;
     virtual std::pair<id_t, Entity*> emplace_back(Entity&& e)   = 0;
     virtual std::vector<id_t>        all_ids() const            = 0;
-    virtual void                     clear()                    = 0;
+    /** Id-sorted point-in-time view (see WorldModel::entities_visit_all) */
+    virtual std::vector<std::pair<id_t, const Entity*>> snapshot() const = 0;
+    /** Like snapshot(), restricted to entities whose variant held the
+     * given alternative index (Entity::index()) when inserted (see
+     * WorldModel::entities_visit_by_type) */
+    virtual std::vector<std::pair<id_t, const Entity*>> snapshot_of_type(
+        std::size_t typeIdx) const                                       = 0;
+    virtual void                                        clear()          = 0;
 };
 
 WorldModelData::EntitiesContainer::~EntitiesContainer() = default;
@@ -101,7 +121,14 @@ struct WorldModelData::FactorsContainer
     virtual Factor&                   by_id(const fid_t id)       = 0;
     virtual std::pair<fid_t, Factor*> emplace_back(Factor&& e)    = 0;
     virtual std::vector<fid_t>        all_ids() const             = 0;
-    virtual void                      clear()                     = 0;
+    /** Id-sorted point-in-time view (see WorldModel::factors_visit_all) */
+    virtual std::vector<std::pair<fid_t, const Factor*>> snapshot() const = 0;
+    /** Like snapshot(), restricted to factors whose variant held the given
+     * alternative index (Factor::index()) when inserted (see
+     * WorldModel::factors_visit_by_type) */
+    virtual std::vector<std::pair<fid_t, const Factor*>> snapshot_of_type(
+        std::size_t typeIdx) const                                        = 0;
+    virtual void                                         clear()          = 0;
 };
 WorldModelData::FactorsContainer::~FactorsContainer() = default;
 
@@ -111,6 +138,9 @@ template <class T, class BASE, class Tbase, class Tother, typename ID>
 struct ContainerDeque : public BASE
 {
     std::deque<T> data_;
+    /** Ids bucketed by variant alternative, appended at insertion (see
+     * snapshot_of_type) */
+    std::array<std::vector<ID>, std::variant_size_v<T>> byType_;
 
     ContainerDeque()           = default;
     ~ContainerDeque() override = default;
@@ -125,6 +155,7 @@ struct ContainerDeque : public BASE
                 [new_id](Tother& o) { o->my_id_ = new_id; },
                 [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
             e);
+        byType_[e.index()].push_back(new_id);
         auto& e_ref = data_.emplace_back(e);
         return std::make_pair(new_id, &e_ref);
     }
@@ -145,7 +176,29 @@ struct ContainerDeque : public BASE
         std::iota(ret.begin(), ret.end(), 1);
         return ret;
     }
-    void clear() override { data_.clear(); }
+    std::vector<std::pair<ID, const T*>> snapshot() const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        ret.reserve(data_.size());
+        for (ID id = 0; id < static_cast<ID>(data_.size()); id++)
+            ret.emplace_back(id, &data_[id]);
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot_of_type(
+        const std::size_t typeIdx) const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        const auto&                          ids = byType_.at(typeIdx);
+        ret.reserve(ids.size());
+        // Ids are allocated monotonically => already sorted:
+        for (const ID id : ids) ret.emplace_back(id, &data_[id]);
+        return ret;
+    }
+    void clear() override
+    {
+        data_.clear();
+        for (auto& b : byType_) b.clear();
+    }
 };
 
 template <
@@ -156,6 +209,9 @@ struct ContainerFastMap : public BASE
     using map_t = mola::fast_map<ID, T>;
 
     map_t data_;
+    /** Ids bucketed by variant alternative, appended at insertion (see
+     * snapshot_of_type) */
+    std::array<std::vector<ID>, std::variant_size_v<T>> byType_;
 
     ContainerFastMap()           = default;
     ~ContainerFastMap() override = default;
@@ -170,6 +226,7 @@ struct ContainerFastMap : public BASE
                 [new_id](Tother& o) { o->my_id_ = new_id; },
                 [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
             e);
+        byType_[e.index()].push_back(new_id);
         T& e_ref = data_[new_id] = std::move(e);
         return std::make_pair(new_id, &e_ref);
     }
@@ -202,7 +259,254 @@ struct ContainerFastMap : public BASE
         for (const auto& e : data_) ret.push_back(e.first);
         return ret;
     }
-    void clear() override { data_.clear(); }
+    std::vector<std::pair<ID, const T*>> snapshot() const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        ret.reserve(data_.size());
+        for (const auto& e : data_) ret.emplace_back(e.first, &e.second);
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot_of_type(
+        const std::size_t typeIdx) const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        const auto&                          ids = byType_.at(typeIdx);
+        ret.reserve(ids.size());
+        // Ids are allocated monotonically => already sorted:
+        for (const ID id : ids) ret.emplace_back(id, &data_.at(id));
+        return ret;
+    }
+    void clear() override
+    {
+        data_.clear();
+        for (auto& b : byType_) b.clear();
+    }
+};
+
+/** Slot-map container for the common dense-id case: ids index directly into
+ * deque-backed slots (stable references, no tree walk), with a per-slot
+ * generation counter so stale handles to erased/recycled slots are detected
+ * instead of silently aliasing. Lookup is O(1).
+ * \ingroup mola_kernel_grp */
+template <
+    class T, class BASE, class Tbase, class Tother, typename ID,
+    const char* Tstr>
+struct ContainerSlotMap : public BASE
+{
+    struct Slot
+    {
+        uint32_t generation = 0;
+        bool     occupied   = false;
+        T        value;
+    };
+
+    std::deque<Slot> slots_;
+    std::size_t      count_ = 0;
+    /** Ids bucketed by variant alternative, appended at insertion (see
+     * snapshot_of_type) */
+    std::array<std::vector<ID>, std::variant_size_v<T>> byType_;
+
+    ContainerSlotMap()           = default;
+    ~ContainerSlotMap() override = default;
+
+    std::size_t       size() const override { return count_; }
+    std::pair<ID, T*> emplace_back(T&& e) override
+    {
+        const ID new_id = slots_.size();
+        std::visit(
+            overloaded{
+                [new_id](Tbase& b) { b.my_id_ = new_id; },
+                [new_id](Tother& o) { o->my_id_ = new_id; },
+                [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
+            e);
+        byType_[e.index()].push_back(new_id);
+        auto& slot    = slots_.emplace_back();
+        slot.value    = std::move(e);
+        slot.occupied = true;
+        slot.generation++;
+        count_++;
+        return std::make_pair(new_id, &slot.value);
+    }
+    const T& by_id(const ID id) const override
+    {
+        if (id >= slots_.size() || !slots_[id].occupied)
+        {
+            THROW_EXCEPTION(mrpt::format(
+                "`%s` not found with id=`%lu`", Tstr,
+                static_cast<unsigned long>(id)));
+        }
+        return slots_[id].value;
+    }
+    T& by_id(const ID id) override
+    {
+        return const_cast<T&>(std::as_const(*this).by_id(id));
+    }
+    std::vector<ID> all_ids() const override
+    {
+        std::vector<ID> ret;
+        ret.reserve(count_);
+        for (ID id = 0; id < slots_.size(); id++)
+            if (slots_[id].occupied) ret.push_back(id);
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot() const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        ret.reserve(count_);
+        for (ID id = 0; id < slots_.size(); id++)
+            if (slots_[id].occupied) ret.emplace_back(id, &slots_[id].value);
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot_of_type(
+        const std::size_t typeIdx) const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        const auto&                          ids = byType_.at(typeIdx);
+        ret.reserve(ids.size());
+        // Ids are allocated monotonically => already sorted:
+        for (const ID id : ids)
+            if (slots_[id].occupied) ret.emplace_back(id, &slots_[id].value);
+        return ret;
+    }
+    void clear() override
+    {
+        slots_.clear();
+        count_ = 0;
+        for (auto& b : byType_) b.clear();
+    }
+};
+
+/** Sharded container: elements are distributed into NUM_SHARDS independent
+ * maps by id, each protected by its own shared_mutex, so concurrent readers
+ * and writers only contend when they hit the same shard. Id-based lookups
+ * take just a shared lock on one shard; ids are monotonically allocated from
+ * an atomic counter, so emplace_back() from several threads never serializes
+ * on a single global lock.
+ *
+ * Note: the WorldModel-level entities/factors locks remain available as a
+ * coarse-grained compatibility wrapper for code iterating the whole map.
+ * \ingroup mola_kernel_grp */
+template <
+    class T, class BASE, class Tbase, class Tother, typename ID,
+    const char* Tstr>
+struct ContainerShardedMap : public BASE
+{
+    constexpr static size_t NUM_SHARDS = 16;  // Must be a power of two
+
+    struct Shard
+    {
+        mola::fast_map<ID, T> data_;
+        /** Ids bucketed by variant alternative, appended at insertion
+         * under mtx_ (see snapshot_of_type) */
+        std::array<std::vector<ID>, std::variant_size_v<T>> byType_;
+        mutable std::shared_mutex                           mtx_;
+    };
+
+    std::array<Shard, NUM_SHARDS> shards_;
+    std::atomic<ID>               next_id_{0};
+
+    ContainerShardedMap()           = default;
+    ~ContainerShardedMap() override = default;
+
+    static constexpr size_t shard_of(const ID id)
+    {
+        return static_cast<size_t>(id) & (NUM_SHARDS - 1);
+    }
+
+    std::size_t size() const override
+    {
+        std::size_t n = 0;
+        for (const auto& s : shards_)
+        {
+            std::shared_lock lck(s.mtx_);
+            n += s.data_.size();
+        }
+        return n;
+    }
+    std::pair<ID, T*> emplace_back(T&& e) override
+    {
+        const ID new_id = next_id_.fetch_add(1);
+        std::visit(
+            overloaded{
+                [new_id](Tbase& b) { b.my_id_ = new_id; },
+                [new_id](Tother& o) { o->my_id_ = new_id; },
+                [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
+            e);
+
+        Shard&           s = shards_[shard_of(new_id)];
+        std::unique_lock lck(s.mtx_);
+        s.byType_[e.index()].push_back(new_id);
+        T& e_ref = s.data_[new_id] = std::move(e);
+        return std::make_pair(new_id, &e_ref);
+    }
+    const T& by_id(const ID id) const override
+    {
+        const Shard&     s = shards_[shard_of(id)];
+        std::shared_lock lck(s.mtx_);
+        const auto       it = s.data_.find(id);
+        if (it == s.data_.end())
+        {
+            THROW_EXCEPTION(mrpt::format(
+                "`%s` not found with id=`%lu`", Tstr,
+                static_cast<unsigned long>(id)));
+        }
+        // Note: node-based map => reference remains valid after unlock.
+        return it->second;
+    }
+    T& by_id(const ID id) override
+    {
+        return const_cast<T&>(std::as_const(*this).by_id(id));
+    }
+    std::vector<ID> all_ids() const override
+    {
+        std::vector<ID> ret;
+        ret.reserve(this->size());
+        for (const auto& s : shards_)
+        {
+            std::shared_lock lck(s.mtx_);
+            for (const auto& e : s.data_) ret.push_back(e.first);
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot() const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        ret.reserve(this->size());
+        for (const auto& s : shards_)
+        {
+            std::shared_lock lck(s.mtx_);
+            // Node-based map => pointers remain valid after unlock.
+            for (const auto& e : s.data_)
+                ret.emplace_back(e.first, &e.second);
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+    std::vector<std::pair<ID, const T*>> snapshot_of_type(
+        const std::size_t typeIdx) const override
+    {
+        std::vector<std::pair<ID, const T*>> ret;
+        for (const auto& s : shards_)
+        {
+            std::shared_lock lck(s.mtx_);
+            // Node-based map => pointers remain valid after unlock.
+            for (const ID id : s.byType_.at(typeIdx))
+                ret.emplace_back(id, &s.data_.at(id));
+        }
+        std::sort(ret.begin(), ret.end());
+        return ret;
+    }
+    void clear() override
+    {
+        for (auto& s : shards_)
+        {
+            std::unique_lock lck(s.mtx_);
+            s.data_.clear();
+            for (auto& b : s.byType_) b.clear();
+        }
+        next_id_ = 0;
+    }
 };
 
 /** Implementation of EntitiesContainer using a std::deque.
@@ -227,6 +531,28 @@ using FactorsContainerFastMap = ContainerFastMap<
     Factor, WorldModelData::FactorsContainer, FactorBase, FactorOther, fid_t,
     f_str>;
 
+/** Slot-map implementations: O(1) array-indexed lookup for dense ids
+ * (see ContainerSlotMap docs above).
+ * \ingroup mola_kernel_grp */
+using EntitiesContainerSlotMap = ContainerSlotMap<
+    Entity, WorldModelData::EntitiesContainer, EntityBase, EntityOther, id_t,
+    e_str>;
+
+using FactorsContainerSlotMap = ContainerSlotMap<
+    Factor, WorldModelData::FactorsContainer, FactorBase, FactorOther, fid_t,
+    f_str>;
+
+/** Sharded implementations, for concurrent front-end/back-end access
+ * (see ContainerShardedMap docs above).
+ * \ingroup mola_kernel_grp */
+using EntitiesContainerSharded = ContainerShardedMap<
+    Entity, WorldModelData::EntitiesContainer, EntityBase, EntityOther, id_t,
+    e_str>;
+
+using FactorsContainerSharded = ContainerShardedMap<
+    Factor, WorldModelData::FactorsContainer, FactorBase, FactorOther, fid_t,
+    f_str>;
+
 }  // namespace mola
 
 void WorldModel::initialize(const Yaml& c)
@@ -237,12 +563,41 @@ void WorldModel::initialize(const Yaml& c)
     auto cfg = c["params"];
     MRPT_LOG_DEBUG_STREAM("Loading these params:\n" << cfg);
 
-    YAML_LOAD_OPT(params_, age_to_unload_keyframes, double);
+    // Declarative parameter binding: described once, bulk-parsed here, and
+    // only the plain params_ members are touched at runtime:
+    static constexpr auto PARAMS_TABLE = mola::param_table(
+        mola::param(
+            "age_to_unload_keyframes", &Parameters::age_to_unload_keyframes),
+        mola::param("max_resident_memory", &Parameters::max_resident_memory),
+        mola::param("prefetch_hop_radius", &Parameters::prefetch_hop_radius));
+
+    mola::load_params(params_, PARAMS_TABLE, cfg);
 
     // Create map container:
-    // TODO(jlbc): Switch between container type per cfg
-    data_.entities_ = std::make_unique<EntitiesContainerFastMap>();
-    data_.factors_  = std::unique_ptr<FactorsContainerFastMap>();
+    const auto containerType =
+        cfg.getOrDefault<std::string>("map_container_type", "sharded");
+
+    if (containerType == "sharded")
+    {
+        data_.entities_ = std::make_unique<EntitiesContainerSharded>();
+        data_.factors_  = std::make_unique<FactorsContainerSharded>();
+    }
+    else if (containerType == "fastmap")
+    {
+        data_.entities_ = std::make_unique<EntitiesContainerFastMap>();
+        data_.factors_  = std::make_unique<FactorsContainerFastMap>();
+    }
+    else if (containerType == "slotmap")
+    {
+        data_.entities_ = std::make_unique<EntitiesContainerSlotMap>();
+        data_.factors_  = std::make_unique<FactorsContainerSlotMap>();
+    }
+    else
+    {
+        THROW_EXCEPTION_FMT(
+            "Invalid value for `map_container_type`: `%s`",
+            containerType.c_str());
+    }
 
     ASSERT_(data_.entities_);
     ASSERT_(data_.factors_);
@@ -261,6 +616,33 @@ Entity& WorldModel::entity_by_id(const id_t id)
     return e;
 }
 
+WorldModel::EntityPin::EntityPin(WorldModel& wm, const id_t id)
+    : wm_(&wm), id_(id)
+{
+    entity_ = &wm.entity_by_id(id);
+    mola::entity_get_base(*entity_).pin();
+}
+
+void WorldModel::EntityPin::release()
+{
+    if (!wm_ || !entity_) return;
+    mola::entity_get_base(*entity_).unpin();
+    wm_     = nullptr;
+    entity_ = nullptr;
+}
+
+Entity& WorldModel::EntityPin::get()
+{
+    ASSERT_(entity_);
+    return *entity_;
+}
+
+const Entity& WorldModel::EntityPin::get() const
+{
+    ASSERT_(entity_);
+    return *entity_;
+}
+
 const Factor& WorldModel::factor_by_id(const fid_t id) const
 {
     return data_.factors_->by_id(id);
@@ -280,17 +662,65 @@ std::vector<mola::fid_t> WorldModel::factor_all_ids() const
     return data_.factors_->all_ids();
 }
 
+void WorldModel::entities_visit_all(
+    const std::function<void(const id_t, const Entity&)>& visitor) const
+{
+    MRPT_START
+    ASSERT_(visitor);
+
+    // Snapshot first (brief per-shard shared locks with the default
+    // `sharded` container), then run the visitor with no lock held at all,
+    // walking the id-sorted, contiguous (id, pointer) array:
+    const auto snap = data_.entities_->snapshot();
+    for (const auto& [id, e] : snap) visitor(id, *e);
+
+    MRPT_END
+}
+
+void WorldModel::factors_visit_all(
+    const std::function<void(const fid_t, const Factor&)>& visitor) const
+{
+    MRPT_START
+    ASSERT_(visitor);
+
+    const auto snap = data_.factors_->snapshot();
+    for (const auto& [id, f] : snap) visitor(id, *f);
+
+    MRPT_END
+}
+
+std::vector<std::pair<mola::id_t, const Entity*>>
+    WorldModel::entities_snapshot_of_type(
+        const std::size_t variantTypeIndex) const
+{
+    return data_.entities_->snapshot_of_type(variantTypeIndex);
+}
+
+std::vector<std::pair<mola::fid_t, const Factor*>>
+    WorldModel::factors_snapshot_of_type(
+        const std::size_t variantTypeIndex) const
+{
+    return data_.factors_->snapshot_of_type(variantTypeIndex);
+}
+
 mola::id_t WorldModel::entity_emplace_back(Entity&& e)
 {
     const auto [id, eptr] = data_.entities_->emplace_back(std::move(e));
-    (void)eptr;
+
+    // Content-addressed dedup: keyframes of the same sensor burst end up
+    // sharing one refcounted instance of each raw observation:
+    if (auto* kf = dynamic_cast<KeyFrameBase*>(&entity_get_base(*eptr));
+        kf && kf->raw_observations_)
+        ObservationsStore::internInPlace(*kf->raw_observations_);
+
+    internal_time_index_add(entity_get_base(*eptr).timestamp_, id);
 
     data_.entity_connected_factors_[id];  // Create empty entry
 
+    internal_touch_entity(entity_get_base(*eptr));
     {
-        auto lock = mrpt::lockHelper(data_.entity_last_access_mtx_);
-
-        data_.entity_last_access_[id] = mrpt::Clock::now();
+        auto lock = mrpt::lockHelper(journal_mtx_);
+        journal_new_entities_.push_back(id);
     }
 
     return id;
@@ -306,9 +736,57 @@ mola::fid_t WorldModel::factor_emplace_back(Factor&& f)
             [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
         *fptr);
 
+    {
+        auto lock = mrpt::lockHelper(journal_mtx_);
+        journal_new_factors_.push_back(id);
+    }
+
     return id;
 }
 
+std::vector<mola::fid_t> WorldModel::factors_emplace_batch(
+    std::vector<Factor>&& fs)
+{
+    MRPT_START
+
+    std::vector<fid_t> ids;
+    ids.reserve(fs.size());
+    if (fs.empty()) return ids;
+
+    {
+        // One write-lock acquisition for the whole batch, instead of one
+        // per factor as in caller-locked factor_emplace_back() loops:
+        auto lck = mrpt::lockHelper(data_.factors_mtx_);
+
+        for (auto& f : fs)
+        {
+            const auto [id, fptr] = data_.factors_->emplace_back(std::move(f));
+
+            std::visit(
+                overloaded{
+                    [this](const FactorBase& b)
+                    { internal_update_neighbors(b); },
+                    [this](const FactorOther& o)
+                    { internal_update_neighbors(*o); },
+                    [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
+                *fptr);
+
+            ids.push_back(id);
+        }
+    }
+
+    {
+        auto lock = mrpt::lockHelper(journal_mtx_);
+        journal_new_factors_.insert(
+            journal_new_factors_.end(), ids.begin(), ids.end());
+    }
+
+    fs.clear();
+    return ids;
+
+    MRPT_END
+}
+
 // These versions end up calling the two versions above:
 mola::id_t WorldModel::entity_push_back(const Entity& e)
 {
@@ -363,45 +841,248 @@ std::set<mola::id_t> WorldModel::entity_neighbors(const mola::id_t id) const
     MRPT_END
 }
 
-annotations_data_t& WorldModel::entity_annotations_by_id(const id_t id)
+void WorldModel::internal_time_index_add(
+    const mrpt::Clock::time_point& t, const id_t id)
 {
-    return const_cast<annotations_data_t&>(
-        const_cast<const WorldModel*>(this)->entity_annotations_by_id(id));
+    // Unstamped entities (e.g. calibration parameter sets) are not indexed:
+    if (t == mrpt::Clock::time_point{}) return;
+
+    auto lck = mrpt::lockHelper(time_index_mtx_);
+    time_index_pending_.emplace_back(t, id);
 }
-const annotations_data_t& WorldModel::entity_annotations_by_id(
-    const id_t id) const
+
+void WorldModel::internal_time_index_rebuild()
 {
     MRPT_START
 
+    const auto snap = data_.entities_->snapshot();
+
+    auto lck = mrpt::lockHelper(time_index_mtx_);
+    time_index_sorted_.clear();
+    time_index_pending_.clear();
+    time_index_sorted_.reserve(snap.size());
+    for (const auto& [id, e] : snap)
     {
-        auto lock = mrpt::lockHelper(data_.entity_last_access_mtx_);
-        data_.entity_last_access_[id] = mrpt::Clock::now();
+        const auto& t = entity_get_base(*e).timestamp_;
+        if (t == mrpt::Clock::time_point{}) continue;
+        time_index_sorted_.emplace_back(t, id);
     }
+    std::sort(time_index_sorted_.begin(), time_index_sorted_.end());
+
+    MRPT_END
+}
+
+std::vector<mola::id_t> WorldModel::entities_in_time_range(
+    const mrpt::Clock::time_point& t0, const mrpt::Clock::time_point& t1) const
+{
+    MRPT_START
 
-    const annotations_data_t* ret = nullptr;
-    auto&                     e   = data_.entities_->by_id(id);
+    auto lck = mrpt::lockHelper(time_index_mtx_);
+
+    // Amortized consolidation of the unsorted insertion tail:
+    if (!time_index_pending_.empty())
+    {
+        std::sort(time_index_pending_.begin(), time_index_pending_.end());
+        const auto mid = time_index_sorted_.size();
+        time_index_sorted_.insert(
+            time_index_sorted_.end(), time_index_pending_.begin(),
+            time_index_pending_.end());
+        std::inplace_merge(
+            time_index_sorted_.begin(), time_index_sorted_.begin() + mid,
+            time_index_sorted_.end());
+        time_index_pending_.clear();
+    }
+
+    const auto itBegin = std::lower_bound(
+        time_index_sorted_.begin(), time_index_sorted_.end(),
+        std::make_pair(t0, id_t{0}));
+    const auto itEnd = std::upper_bound(
+        itBegin, time_index_sorted_.end(),
+        std::make_pair(t1, std::numeric_limits<id_t>::max()));
+
+    std::vector<id_t> ids;
+    ids.reserve(static_cast<size_t>(itEnd - itBegin));
+    for (auto it = itBegin; it != itEnd; ++it) ids.push_back(it->second);
+    return ids;
+
+    MRPT_END
+}
+
+WorldModel::EntityFactorsAdjacency WorldModel::entity_factors_adjacency() const
+{
+    MRPT_START
+
+    EntityFactorsAdjacency adj;
+    const auto&            src = data_.entity_connected_factors_;
+
+    adj.entity_ids.reserve(src.size());
+    adj.row_start.reserve(src.size() + 1);
+
+    // The adjacency map is open-addressing (unordered): sort (id, row)
+    // pointers first to keep the documented ascending entity_ids order:
+    std::vector<std::pair<id_t, const mola::fast_set<fid_t>*>> rows;
+    rows.reserve(src.size());
+    std::size_t totalFactors = 0;
+    for (const auto& [id, fids] : src)
+    {
+        rows.emplace_back(id, &fids);
+        totalFactors += fids.size();
+    }
+    std::sort(rows.begin(), rows.end());
+    adj.factor_ids.reserve(totalFactors);
+
+    adj.row_start.push_back(0);
+    for (const auto& [id, fids] : rows)
+    {
+        adj.entity_ids.push_back(id);
+        for (const auto fid : *fids) adj.factor_ids.push_back(fid);
+        adj.row_start.push_back(adj.factor_ids.size());
+    }
+    return adj;
+
+    MRPT_END
+}
+
+void WorldModel::entity_factors_remap_ids(
+    const std::function<id_t(id_t)>&   entityIdMap,
+    const std::function<fid_t(fid_t)>& factorIdMap)
+{
+    MRPT_START
+    ASSERT_(entityIdMap);
+    ASSERT_(factorIdMap);
+
+    entities_lock_for_write();
+
+    // One linear pass over the adjacency: remap each key and its factor
+    // row into a fresh container, then swap. Rows iterate in sorted order,
+    // and monotonic id maps (e.g. make_robot_id()) preserve it, so the
+    // end() insertion hint keeps each row O(row size):
+    entity_connected_factors_t remapped;
+    for (const auto& [oldId, fids] : data_.entity_connected_factors_)
+    {
+        auto& row = remapped[entityIdMap(oldId)];
+        for (const auto fid : fids) row.insert(row.end(), factorIdMap(fid));
+    }
+    data_.entity_connected_factors_ = std::move(remapped);
+
+    entities_unlock_for_write();
+
+    // (LRU last-access stamps live inside each EntityBase, so they follow
+    // the entities through any id remap with no work here.)
+
+    // And the secondary time index (timestamps are unaffected, so sortedness
+    // is preserved):
+    {
+        auto lck = mrpt::lockHelper(time_index_mtx_);
+        for (auto& [tim, id] : time_index_sorted_) id = entityIdMap(id);
+        for (auto& [tim, id] : time_index_pending_) id = entityIdMap(id);
+    }
+
+    MRPT_END
+}
+
+annotations_data_t& WorldModel::entity_annotations_by_id(const id_t id)
+{
+    MRPT_START
+
+    auto& eb = entity_get_base(data_.entities_->by_id(id));
+    internal_touch_entity(eb);
 
     // Load on-the-fly if required:
-    entity_get_base(e).load();
+    const bool wasMiss = eb.is_unloaded();
+    eb.load();
 
-    std::visit(
-        overloaded{
-            [&ret](const EntityBase& b) { ret = &b.annotations_; },
-            [&ret](const EntityOther& o)
-            {
-                ASSERT_(o);
-                ret = &o->annotations_;
-            },
-            [](std::monostate) {}},
-        e);
+    // A miss means we are touching a cold map region (e.g. loop closure):
+    // warm its graph neighborhood up in the background:
+    if (wasMiss) internal_prefetch_neighbors(id);
 
-    if (!ret) { THROW_EXCEPTION("Empty variant!"); }
-    else
-        return *ret;
+    // Note: this one (unlike the const overload) allocates the annotations
+    // map on first use:
+    return eb.annotations();
+
+    MRPT_END
+}
+const annotations_data_t& WorldModel::entity_annotations_by_id(
+    const id_t id) const
+{
+    MRPT_START
+
+    auto& eb = entity_get_base(data_.entities_->by_id(id));
+    internal_touch_entity(eb);
+
+    // Load on-the-fly if required:
+    const bool wasMiss = eb.is_unloaded();
+    eb.load();
+
+    // See the non-const overload:
+    if (wasMiss)
+        const_cast<WorldModel*>(this)->internal_prefetch_neighbors(id);
+
+    return eb.annotations();
 
     MRPT_END
 }
 
+void WorldModel::internal_prefetch_neighbors(const id_t id)
+{
+    if (params_.prefetch_hop_radius == 0) return;
+
+    // Already backlogged => the disk is the bottleneck anyway, adding more
+    // hints would only delay the loads the optimizer is really waiting for:
+    if (prefetch_pool_.pendingTasks() > 100) return;
+
+    prefetch_pool_.enqueue(
+        [this, id]()
+        {
+            try
+            {
+                ProfilerEntry tle(profiler_, "prefetch_neighbors");
+
+                std::set<id_t> visited{id};
+                std::set<id_t> frontier{id};
+
+                for (unsigned int hop = 0;
+                     hop < params_.prefetch_hop_radius && !frontier.empty();
+                     hop++)
+                {
+                    std::set<id_t> next;
+                    for (const auto eid : frontier)
+                        for (const auto nid : this->entity_neighbors(eid))
+                            if (visited.insert(nid).second) next.insert(nid);
+
+                    for (const auto nid : next)
+                    {
+                        auto& eb =
+                            entity_get_base(data_.entities_->by_id(nid));
+                        if (!eb.is_unloaded()) continue;
+
+                        // Touch the LRU stamp first, so the freshly loaded
+                        // entity is not immediately swapped off again:
+                        internal_touch_entity(eb);
+                        eb.load();
+                    }
+                    frontier = std::move(next);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                MRPT_LOG_DEBUG_STREAM("[prefetch_neighbors] " << e.what());
+            }
+        });
+}
+
+namespace
+{
+/** Sum of the estimated in-memory sizes of all (loaded) entity annotations */
+uint64_t entity_memory_footprint(const EntityBase& e)
+{
+    uint64_t bytes = 0;
+    for (const auto& [label, lazy] : e.annotations())
+        bytes += lazy.approxMemoryFootprint();
+    return bytes;
+}
+}  // namespace
+
 std::vector<mola::id_t> WorldModel::findEntitiesToSwapOff()
 {
     MRPT_START
@@ -409,24 +1090,73 @@ std::vector<mola::id_t> WorldModel::findEntitiesToSwapOff()
 
     std::vector<id_t> aged_ids;
 
-    auto       lk    = mrpt::lockHelper(data_.entity_last_access_mtx_);
-    const auto t_now = mrpt::Clock::now();
+    // Sample the per-entity atomic access stamps (relaxed: this sweep only
+    // needs a coarse, eventually-consistent view):
+    const auto epochNow = access_epoch_now_.load(std::memory_order_relaxed);
 
-    for (auto it_ent = data_.entity_last_access_.begin();
-         it_ent != data_.entity_last_access_.end();)
+    // LRU working-set policy, driven by a resident-memory budget:
+    if (params_.max_resident_memory > 0)
     {
-        const double age = mrpt::system::timeDifference(it_ent->second, t_now);
+        // 1) Snapshot (last_access_epoch, id, footprint), oldest first;
+        //    unloaded entities carry no resident memory and are skipped:
+        struct Candidate
+        {
+            uint32_t epoch;
+            id_t     id;
+            uint64_t bytes;
+        };
+        std::vector<Candidate> lru;
+        uint64_t               totalBytes = 0;
+
+        entities_lock_for_read();
+        const auto snap = data_.entities_->snapshot();
+        lru.reserve(snap.size());
+        for (const auto& [id, e] : snap)
+        {
+            const auto&    eb = mola::entity_get_base(*e);
+            const uint64_t sz = entity_memory_footprint(eb);
+            if (sz == 0) continue;  // already unloaded
+            totalBytes += sz;
+            // Pinned entities stay resident (their bytes still count
+            // against the budget above, so unpinned ones make room):
+            if (eb.is_pinned()) continue;
+            lru.push_back(
+                {eb.last_access_epoch_.load(std::memory_order_relaxed), id,
+                 sz});
+        }
+        entities_unlock_for_read();
+
+        std::sort(
+            lru.begin(), lru.end(),
+            [](const Candidate& a, const Candidate& b)
+            { return a.epoch < b.epoch; });
 
-        if (age > params_.age_to_unload_keyframes)
+        // 2) Evict least-recently-used entities until under budget:
+        for (size_t i = 0;
+             totalBytes > params_.max_resident_memory && i < lru.size(); i++)
         {
-            const auto id = it_ent->first;
-            // Remove from list:
-            it_ent = data_.entity_last_access_.erase(it_ent);
-            // and report:
-            aged_ids.push_back(id);
+            aged_ids.push_back(lru[i].id);
+            totalBytes -= lru[i].bytes;
         }
-        else { ++it_ent; }
+
+        profiler_.registerUserMeasure(
+            "resident_entities_bytes", static_cast<double>(totalBytes));
+        return aged_ids;
+    }
+
+    // Legacy age-based policy (epochs are seconds since map start):
+    entities_lock_for_read();
+    const auto snap = data_.entities_->snapshot();
+    for (const auto& [id, e] : snap)
+    {
+        const auto& eb = mola::entity_get_base(*e);
+        if (eb.is_unloaded() || eb.is_pinned()) continue;
+
+        const double age =
+            epochNow - eb.last_access_epoch_.load(std::memory_order_relaxed);
+        if (age > params_.age_to_unload_keyframes) aged_ids.push_back(id);
     }
+    entities_unlock_for_read();
 
     return aged_ids;
     MRPT_END
@@ -436,6 +1166,13 @@ void WorldModel::spinOnce()
 {
     MRPT_START
 
+    // Refresh the coarse access-epoch counter ("timer" tick): entity reads
+    // just copy this value with a relaxed store, never calling the clock:
+    access_epoch_now_.store(
+        static_cast<uint32_t>(mrpt::system::timeDifference(
+            access_epoch_base_, mrpt::Clock::now())),
+        std::memory_order_relaxed);
+
     // Unload KeyFrames that have not been used in a while:
     const std::vector<id_t> aged_ids = findEntitiesToSwapOff();
 
@@ -464,12 +1201,30 @@ void WorldModel::map_load_from(mrpt::serialization::CArchive& in)
 {
     MRPT_START
     in >> data_;
+    internal_time_index_rebuild();
     MRPT_END
 }
 
+/** Magic header of the indexed (TOC-first) map file format */
+static const char MAP_IDX_MAGIC[8] = {'M', 'O', 'L', 'A', 'M', 'I', 'D', 'X'};
+
 void WorldModel::map_load_from(const std::string& fileName)
 {
     MRPT_START
+
+    // Sniff the format: indexed files start with a magic header, anything
+    // else is assumed to be the legacy gz archive:
+    {
+        mrpt::io::CFileInputStream f(fileName);
+        char                       magic[sizeof(MAP_IDX_MAGIC)] = {0};
+        if (f.Read(magic, sizeof(magic)) == sizeof(magic) &&
+            0 == std::memcmp(magic, MAP_IDX_MAGIC, sizeof(magic)))
+        {
+            map_load_from_indexed(fileName);
+            return;
+        }
+    }
+
     mrpt::io::CFileGZInputStream f(fileName);
 
     auto in = mrpt::serialization::archiveFrom(f);
@@ -477,6 +1232,201 @@ void WorldModel::map_load_from(const std::string& fileName)
     MRPT_END
 }
 
+void WorldModel::map_save_to_indexed(const std::string& fileName) const
+{
+    MRPT_START
+
+    auto& me = const_cast<WorldModel&>(*this);
+    me.entities_lock_for_read();
+    me.factors_lock_for_read();
+
+    mrpt::io::CFileOutputStream f;
+    if (!f.open(fileName))
+        THROW_EXCEPTION_FMT("Cannot write to file: `%s`", fileName.c_str());
+
+    f.Write(MAP_IDX_MAGIC, sizeof(MAP_IDX_MAGIC));
+
+    // Placeholder for the table-of-contents offset, patched at the end:
+    uint64_t tocOffset = 0;
+    f.Write(&tocOffset, sizeof(tocOffset));
+
+    const std::vector<id_t>  entityIds = data_.entities_->all_ids();
+    const std::vector<fid_t> factorIds = data_.factors_->all_ids();
+
+    std::vector<uint64_t> entOffs(entityIds.size()),
+        entLens(entityIds.size()), facOffs(factorIds.size()),
+        facLens(factorIds.size());
+
+    // Payload blobs, one archive per object so each can be deserialized
+    // independently:
+    auto writeBlob = [&f](const mrpt::serialization::CSerializable& o,
+                          uint64_t& off, uint64_t& len)
+    {
+        off = f.getPosition();
+        {
+            auto a = mrpt::serialization::archiveFrom(f);
+            a << o;
+        }
+        len = f.getPosition() - off;
+    };
+
+    for (size_t i = 0; i < entityIds.size(); i++)
+        writeBlob(
+            mola::entity_get_base(data_.entities_->by_id(entityIds[i])),
+            entOffs[i], entLens[i]);
+    for (size_t i = 0; i < factorIds.size(); i++)
+        writeBlob(
+            mola::factor_get_base(data_.factors_->by_id(factorIds[i])),
+            facOffs[i], facLens[i]);
+
+    // Table of contents:
+    tocOffset = f.getPosition();
+    {
+        auto a = mrpt::serialization::archiveFrom(f);
+        a << data_.map_name_;
+        a << entityIds << entOffs << entLens;
+        a << factorIds << facOffs << facLens;
+    }
+
+    // Patch the TOC offset in the header:
+    f.Seek(sizeof(MAP_IDX_MAGIC));
+    f.Write(&tocOffset, sizeof(tocOffset));
+
+    me.factors_unlock_for_read();
+    me.entities_unlock_for_read();
+
+    MRPT_END
+}
+
+void WorldModel::map_load_from_indexed(const std::string& fileName)
+{
+    MRPT_START
+    ProfilerEntry tle(profiler_, "map_load_from_indexed");
+
+    std::string           mapName;
+    std::vector<id_t>     entityIds;
+    std::vector<fid_t>    factorIds;
+    std::vector<uint64_t> entOffs, entLens, facOffs, facLens;
+
+    {
+        mrpt::io::CFileInputStream f;
+        if (!f.open(fileName))
+            THROW_EXCEPTION_FMT(
+                "Cannot read from file: `%s`", fileName.c_str());
+
+        char magic[sizeof(MAP_IDX_MAGIC)] = {0};
+        f.Read(magic, sizeof(magic));
+        ASSERTMSG_(
+            0 == std::memcmp(magic, MAP_IDX_MAGIC, sizeof(magic)),
+            "Not an indexed map file");
+
+        uint64_t tocOffset = 0;
+        f.Read(&tocOffset, sizeof(tocOffset));
+        f.Seek(tocOffset);
+
+        auto a = mrpt::serialization::archiveFrom(f);
+        a >> mapName;
+        a >> entityIds >> entOffs >> entLens;
+        a >> factorIds >> facOffs >> facLens;
+    }
+
+    // Parallel deserialization: each worker opens its own file handle and
+    // parses a contiguous chunk of the object table:
+    std::vector<Entity> ents(entityIds.size());
+    std::vector<Factor> facts(factorIds.size());
+
+    const size_t nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto parseChunk = [&fileName](
+                          const std::vector<uint64_t>& offs,
+                          const std::vector<uint64_t>& lens, auto& out,
+                          auto readOne, const size_t i0, const size_t i1)
+    {
+        mrpt::io::CFileInputStream fi(fileName);
+        std::vector<uint8_t>       buf;
+        for (size_t i = i0; i < i1; i++)
+        {
+            buf.resize(lens[i]);
+            fi.Seek(offs[i]);
+            fi.Read(buf.data(), lens[i]);
+
+            mrpt::io::CMemoryStream ms;
+            ms.assignMemoryBlock(buf.data(), lens[i]);
+            auto a = mrpt::serialization::archiveFrom(ms);
+            out[i] = readOne(a);
+        }
+    };
+
+    auto readEntity = [](mrpt::serialization::CArchive& a) -> Entity
+    {
+        return a.ReadVariant<
+            std::monostate, RefPose3, RelPose3, RelPose3KF, RelDynPose3KF,
+            LandmarkPoint3, EntityOther>();
+    };
+    auto readFactor = [](mrpt::serialization::CArchive& a) -> Factor
+    {
+        return a.ReadVariant<
+            std::monostate, FactorRelativePose3, FactorConstVelKinematics,
+            FactorStereoProjectionPose, SmartFactorStereoProjectionPose,
+            SmartFactorIMU, FactorOther>();
+    };
+
+    auto runParallel = [&](const size_t n, auto parseFn)
+    {
+        std::vector<std::thread> workers;
+        const size_t             chunk = (n + nThreads - 1) / nThreads;
+        for (size_t t = 0; t < nThreads && t * chunk < n; t++)
+            workers.emplace_back(
+                parseFn, t * chunk, std::min(n, (t + 1) * chunk));
+        for (auto& w : workers) w.join();
+    };
+
+    runParallel(
+        entityIds.size(), [&](size_t i0, size_t i1)
+        { parseChunk(entOffs, entLens, ents, readEntity, i0, i1); });
+    runParallel(
+        factorIds.size(), [&](size_t i0, size_t i1)
+        { parseChunk(facOffs, facLens, facts, readFactor, i0, i1); });
+
+    // Sequential (cheap) insertion, preserving the original ids:
+    entities_lock_for_write();
+    data_.entities_->clear();
+    for (size_t i = 0; i < ents.size(); i++)
+    {
+        mola::entity_get_base(ents[i]).my_id_ = entityIds[i];
+        const auto [newId, ePtr] =
+            data_.entities_->emplace_back(std::move(ents[i]));
+        (void)ePtr;
+        ASSERT_EQUAL_(newId, entityIds[i]);
+    }
+    entities_unlock_for_write();
+
+    factors_lock_for_write();
+    data_.factors_->clear();
+    for (size_t i = 0; i < facts.size(); i++)
+    {
+        mola::factor_get_base(facts[i]).my_id_ = factorIds[i];
+        const auto [newId, fPtr] =
+            data_.factors_->emplace_back(std::move(facts[i]));
+        ASSERT_EQUAL_(newId, factorIds[i]);
+
+        std::visit(
+            overloaded{
+                [this](const FactorBase& b) { internal_update_neighbors(b); },
+                [this](const FactorOther& o)
+                { internal_update_neighbors(*o); },
+                [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
+            *fPtr);
+    }
+    factors_unlock_for_write();
+
+    data_.map_name_ = mapName;
+
+    internal_time_index_rebuild();
+
+    MRPT_END
+}
+
 void WorldModel::map_save_to(mrpt::serialization::CArchive& out) const
 {
     MRPT_START
@@ -494,9 +1444,135 @@ void WorldModel::map_save_to(const std::string& fileName) const
     MRPT_END
 }
 
+void WorldModel::map_checkpoint_delta()
+{
+    MRPT_START
+
+    // Drain the journal:
+    std::vector<id_t>  ents;
+    std::vector<fid_t> facts;
+    std::string        deltaFil;
+    {
+        auto lock = mrpt::lockHelper(journal_mtx_);
+        if (journal_new_entities_.empty() && journal_new_factors_.empty())
+            return;
+        ents  = std::move(journal_new_entities_);
+        facts = std::move(journal_new_factors_);
+        journal_new_entities_.clear();
+        journal_new_factors_.clear();
+
+        const auto dir = map_base_dir_ + "checkpoints/";
+        if (!mrpt::system::directoryExists(dir))
+            mrpt::system::createDirectory(dir);
+        deltaFil = dir + mrpt::format("delta_%06u.bin", checkpoint_seq_++);
+        checkpoint_delta_files_.push_back(deltaFil);
+    }
+
+    // Serialize the delta off the SLAM thread:
+    checkpoint_pool_.enqueue(
+        [this, deltaFil, ents = std::move(ents), facts = std::move(facts)]()
+        {
+            try
+            {
+                ProfilerEntry tle(profiler_, "map_checkpoint_delta.write");
+
+                mrpt::io::CFileGZOutputStream f(deltaFil);
+                auto out = mrpt::serialization::archiveFrom(f);
+
+                out << ents;
+                entities_lock_for_read();
+                for (const auto eid : ents)
+                    out << mola::entity_get_base(data_.entities_->by_id(eid));
+                entities_unlock_for_read();
+
+                out << facts;
+                factors_lock_for_read();
+                for (const auto fid : facts)
+                    out << mola::factor_get_base(data_.factors_->by_id(fid));
+                factors_unlock_for_read();
+            }
+            catch (const std::exception& e)
+            {
+                MRPT_LOG_ERROR_STREAM(
+                    "Error writing map checkpoint delta:\n"
+                    << mrpt::exception_to_str(e));
+            }
+        });
+
+    MRPT_END
+}
+
+void WorldModel::map_checkpoint_compact(const std::string& fileName)
+{
+    MRPT_START
+
+    // Wait for in-flight delta writes:
+    while (checkpoint_pool_.pendingTasks() != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    map_save_to(fileName);
+
+    // Deltas are now redundant:
+    auto lock = mrpt::lockHelper(journal_mtx_);
+    for (const auto& f : checkpoint_delta_files_) mrpt::system::deleteFile(f);
+    checkpoint_delta_files_.clear();
+
+    MRPT_END
+}
+
+void WorldModel::map_apply_delta(const std::string& fileName)
+{
+    MRPT_START
+
+    mrpt::io::CFileGZInputStream f(fileName);
+    auto                         in = mrpt::serialization::archiveFrom(f);
+
+    std::vector<id_t> ents;
+    in >> ents;
+    entities_lock_for_write();
+    for (const auto eid : ents)
+    {
+        Entity e = in.ReadVariant<
+            std::monostate, RefPose3, RelPose3, RelPose3KF, RelDynPose3KF,
+            LandmarkPoint3, EntityOther>();
+
+        mola::entity_get_base(e).my_id_ = eid;
+        const auto [newId, ePtr] = data_.entities_->emplace_back(std::move(e));
+        ASSERT_EQUAL_(newId, eid);
+        internal_time_index_add(mola::entity_get_base(*ePtr).timestamp_, newId);
+    }
+    entities_unlock_for_write();
+
+    std::vector<fid_t> facts;
+    in >> facts;
+    factors_lock_for_write();
+    for (const auto fid : facts)
+    {
+        Factor fa = in.ReadVariant<
+            std::monostate, FactorRelativePose3, FactorConstVelKinematics,
+            FactorStereoProjectionPose, SmartFactorStereoProjectionPose,
+            SmartFactorIMU, FactorOther>();
+
+        mola::factor_get_base(fa).my_id_ = fid;
+        const auto [newId, fPtr] = data_.factors_->emplace_back(std::move(fa));
+        ASSERT_EQUAL_(newId, fid);
+
+        std::visit(
+            overloaded{
+                [this](const FactorBase& b) { internal_update_neighbors(b); },
+                [this](const FactorOther& o)
+                { internal_update_neighbors(*o); },
+                [](std::monostate) { THROW_EXCEPTION("Empty variant!"); }},
+            *fPtr);
+    }
+    factors_unlock_for_write();
+
+    MRPT_END
+}
+
 // =============== WorldModelData ===============
 // See docs for mrpt-serialization:
-uint8_t WorldModelData::serializeGetVersion() const { return 0; }
+uint8_t WorldModelData::serializeGetVersion() const { return 1; }
 void    WorldModelData::serializeTo(mrpt::serialization::CArchive& out) const
 {
     // Ensure lock:
@@ -516,10 +1592,43 @@ void    WorldModelData::serializeTo(mrpt::serialization::CArchive& out) const
 
     // TODO(jlbc): Improvement: offer a visitor-like instead of call all_ids()
 
-    // Entities:
-    std::vector<id_t> entity_ids = entities_->all_ids();
-    out << entity_ids;
+    // Entities. Plain keyframes (the bulk of any map) are packed into
+    // fixed-layout POD tables written as single buffers; everything else
+    // (exotic types, annotated KFs, KFs with in-memory observations)
+    // keeps the per-object CArchive path. See KeyFramePODRecords.h.
+    const std::vector<id_t> entity_ids = entities_->all_ids();
+
+    std::vector<RelPose3KFRecord>    kfRecs;
+    std::vector<RelDynPose3KFRecord> dynKfRecs;
+    std::vector<id_t>                archiveIds;
+
     for (auto eid : entity_ids)
+    {
+        const Entity& ent = entities_->by_id(eid);
+        if (const auto* kf = std::get_if<RelPose3KF>(&ent);
+            kf && fits_pod_record(*kf))
+            kfRecs.push_back(to_pod_record(*kf));
+        else if (const auto* dkf = std::get_if<RelDynPose3KF>(&ent);
+                 dkf && fits_pod_record(*dkf))
+            dynKfRecs.push_back(to_pod_record(*dkf));
+        else
+            archiveIds.push_back(eid);
+    }
+
+    out.WriteAs<uint16_t>(KF_POD_FORMAT_VERSION);
+
+    out.WriteAs<uint64_t>(kfRecs.size());
+    if (!kfRecs.empty())
+        out.WriteBuffer(
+            kfRecs.data(), sizeof(RelPose3KFRecord) * kfRecs.size());
+
+    out.WriteAs<uint64_t>(dynKfRecs.size());
+    if (!dynKfRecs.empty())
+        out.WriteBuffer(
+            dynKfRecs.data(), sizeof(RelDynPose3KFRecord) * dynKfRecs.size());
+
+    out << archiveIds;
+    for (auto eid : archiveIds)
     {
         const Entity&     ent = entities_->by_id(eid);
         const EntityBase& e   = mola::entity_get_base(ent);
@@ -586,6 +1695,70 @@ void WorldModelData::serializeFrom(
             }
         }
         break;
+        case 1:
+        {
+            // Entities. POD keyframe tables first (KeyFramePODRecords.h):
+            const auto podVersion = in.ReadAs<uint16_t>();
+            ASSERTMSG_(
+                podVersion == KF_POD_FORMAT_VERSION,
+                "Unsupported keyframe POD record format version");
+
+            std::vector<std::pair<id_t, Entity>> ents;
+
+            std::vector<RelPose3KFRecord> kfRecs(in.ReadAs<uint64_t>());
+            if (!kfRecs.empty())
+                in.ReadBuffer(
+                    kfRecs.data(), sizeof(RelPose3KFRecord) * kfRecs.size());
+            for (const auto& r : kfRecs)
+                ents.emplace_back(r.id, from_pod_record(r));
+
+            std::vector<RelDynPose3KFRecord> dynKfRecs(
+                in.ReadAs<uint64_t>());
+            if (!dynKfRecs.empty())
+                in.ReadBuffer(
+                    dynKfRecs.data(),
+                    sizeof(RelDynPose3KFRecord) * dynKfRecs.size());
+            for (const auto& r : dynKfRecs)
+                ents.emplace_back(r.id, from_pod_record(r));
+
+            // ...then the CArchive-path entities:
+            std::vector<id_t> archiveIds;
+            in >> archiveIds;
+            for (auto eid : archiveIds)
+            {
+                Entity e = in.ReadVariant<
+                    std::monostate, RefPose3, RelPose3, RelPose3KF,
+                    RelDynPose3KF, LandmarkPoint3, EntityOther>();
+                ents.emplace_back(eid, std::move(e));
+            }
+
+            // The containers assign ids sequentially on insertion, so
+            // re-insert in the original (ascending) id order:
+            std::sort(
+                ents.begin(), ents.end(), [](const auto& a, const auto& b)
+                { return a.first < b.first; });
+            for (auto& [eid, e] : ents)
+            {
+                mola::entity_get_base(e).my_id_ = eid;
+                entities_->emplace_back(std::move(e));
+            }
+
+            // Factors (same as version 0):
+            std::vector<fid_t> factor_ids;
+            in >> factor_ids;
+            for (auto fid : factor_ids)
+            {
+                Factor f = in.ReadVariant<
+                    std::monostate, FactorRelativePose3,
+                    FactorConstVelKinematics, FactorStereoProjectionPose,
+                    SmartFactorStereoProjectionPose, SmartFactorIMU,
+                    FactorOther>();
+
+                mola::factor_get_base(f).my_id_ = fid;
+                factors_->emplace_back(std::move(f));
+            }
+        }
+        break;
         default:
             MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
     };
@@ -15,6 +15,8 @@
 #include <mola_kernel/variant_helper.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <utility>  // std::move
+
 using namespace mola;
 
 // arguments: class, parent class, namespace
@@ -24,15 +26,60 @@ IMPLEMENTS_VIRTUAL_SERIALIZABLE(
 EntityBase::EntityBase()  = default;
 EntityBase::~EntityBase() = default;
 
+EntityBase::EntityBase(const EntityBase& o) : CSerializable(o) { *this = o; }
+
+EntityBase& EntityBase::operator=(const EntityBase& o)
+{
+    if (this == &o) return *this;
+    my_id_     = o.my_id_;
+    timestamp_ = o.timestamp_;
+    last_access_epoch_.store(
+        o.last_access_epoch_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    annotations_ =
+        o.annotations_ ? std::make_unique<annotations_data_t>(*o.annotations_)
+                       : nullptr;
+    return *this;
+}
+
+EntityBase::EntityBase(EntityBase&& o) noexcept { *this = std::move(o); }
+
+EntityBase& EntityBase::operator=(EntityBase&& o) noexcept
+{
+    if (this == &o) return *this;
+    my_id_     = o.my_id_;
+    timestamp_ = o.timestamp_;
+    last_access_epoch_.store(
+        o.last_access_epoch_.load(std::memory_order_relaxed),
+        std::memory_order_relaxed);
+    annotations_ = std::move(o.annotations_);
+    return *this;
+}
+
+annotations_data_t& EntityBase::annotations()
+{
+    if (!annotations_) annotations_ = std::make_unique<annotations_data_t>();
+    return *annotations_;
+}
+
+const annotations_data_t& EntityBase::annotations() const
+{
+    static const annotations_data_t emptyMap;
+    return annotations_ ? *annotations_ : emptyMap;
+}
+
 void EntityBase::load()
 {
     MRPT_TRY_START
 
     // Always: unload annotations:
-    for (auto& a : annotations_)
+    if (annotations_)
     {
-        a.second.setParentEntityID(my_id_);
-        a.second.load();
+        for (auto& a : *annotations_)
+        {
+            a.second.setParentEntityID(my_id_);
+            a.second.load();
+        }
     }
 
     // If I am a KeyFrame: unload observations:
@@ -47,11 +94,17 @@ void EntityBase::unload()
 {
     MRPT_TRY_START
 
+    // Pinned entities are exempt from eviction while in use (see pin()):
+    if (is_pinned()) return;
+
     // Always: unload annotations:
-    for (auto& a : annotations_)
+    if (annotations_)
     {
-        a.second.setParentEntityID(my_id_);
-        a.second.unload();
+        for (auto& a : *annotations_)
+        {
+            a.second.setParentEntityID(my_id_);
+            a.second.unload();
+        }
     }
 
     // If I am a KeyFrame: unload observations:
@@ -76,7 +129,7 @@ bool EntityBase::is_unloaded() const
     bool is_unloaded = true;
 
     // Always: unload annotations:
-    for (auto& a : annotations_)
+    for (const auto& a : annotations())
         is_unloaded = is_unloaded && a.second.isUnloaded();
 
     /*    // If I am a KeyFrame: unload observations:
@@ -95,8 +148,9 @@ void EntityBase::baseSerializeTo(mrpt::serialization::CArchive& out) const
 
     out << my_id_ << timestamp_;
 
-    out.WriteAs<uint32_t>(annotations_.size());
-    for (const auto& a : annotations_)
+    const auto& anns = annotations();
+    out.WriteAs<uint32_t>(anns.size());
+    for (const auto& a : anns)
     {
         out << a.first;
         // this saves data to disk to independent file
@@ -114,13 +168,13 @@ void EntityBase::baseSerializeFrom(mrpt::serialization::CArchive& in)
     in >> my_id_ >> timestamp_;
 
     const auto nAnnotations = in.ReadAs<uint32_t>();
-    annotations_.clear();
+    annotations_.reset();
 
     for (uint32_t i = 0; i < nAnnotations; i++)
     {
         std::string annotationName, annotationExternalFilename;
         in >> annotationName >> annotationExternalFilename;
-        auto& a = annotations_[annotationName];
+        auto& a = annotations()[annotationName];
         a.setAsExternal(annotationExternalFilename);
     }
 }
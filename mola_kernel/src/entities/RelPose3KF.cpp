@@ -10,6 +10,7 @@
  * @date   Jan 08, 2019
  */
 
+#include <mola_kernel/ObservationsStore.h>
 #include <mola_kernel/entities/RelPose3KF.h>
 #include <mrpt/serialization/CArchive.h>
 
@@ -36,6 +37,10 @@ void RelPose3KF::serializeFrom(
         case 0:
         {
             in >> relpose_value >> raw_observations_;
+            // Re-share observations duplicated across the keyframes of one
+            // sensor burst (each KF serializes its own full copy):
+            if (raw_observations_)
+                ObservationsStore::internInPlace(*raw_observations_);
         }
         break;
         default:
@@ -33,14 +33,16 @@ mola::id_t FactorRelativePose3::edge_indices(const std::size_t i) const
 }
 
 // Implementation of the CSerializable virtual interface:
-uint8_t FactorRelativePose3::serializeGetVersion() const { return 0; }
+uint8_t FactorRelativePose3::serializeGetVersion() const { return 1; }
 void FactorRelativePose3::serializeTo(mrpt::serialization::CArchive& out) const
 {
     baseSerializeTo(out);
 
     out << from_kf_ << to_kf_ << rel_pose_;
     out.WriteAs<bool>(noise_model_.has_value());
-    if (noise_model_) out << mrpt::math::CMatrixD(*noise_model_);
+    // v1: fixed-size matrix written in-place; no dynamic-matrix temporary:
+    if (noise_model_)
+        out.WriteBufferFixedEndianness(noise_model_->data(), 6 * 6);
     out << noise_model_diag_xyz_ << noise_model_diag_rot_;
 }
 void FactorRelativePose3::serializeFrom(
@@ -64,6 +66,17 @@ void FactorRelativePose3::serializeFrom(
             in >> noise_model_diag_xyz_ >> noise_model_diag_rot_;
         }
         break;
+        case 1:
+        {
+            in >> from_kf_ >> to_kf_ >> rel_pose_;
+            if (in.ReadAs<bool>())
+            {
+                auto& m = noise_model_.emplace();
+                in.ReadBufferFixedEndianness(m.data(), 6 * 6);
+            }
+            in >> noise_model_diag_xyz_ >> noise_model_diag_rot_;
+        }
+        break;
         default:
             MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
     };
@@ -12,8 +12,12 @@
 
 #include <mola_kernel/factors/SmartFactorIMU.h>
 #include <mola_kernel/interfaces/BackEndBase.h>
+#include <mrpt/poses/Lie/SO.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace mola;
 
 // arguments: classname, parent class, namespace
@@ -42,6 +46,14 @@ void SmartFactorIMU::integrateMeasurement(
     wy_        = wy;
     wz_        = wz;
     dt_        = dt;
+
+    // Buffer the raw sample (so the window can be re-preintegrated at a
+    // new bias linearization point) and keep the cached delta current by
+    // folding the sample into it incrementally:
+    const ImuSample m{accx, accy, accz, wx, wy, wz, dt};
+    samples_.push_back(m);
+    if (cached_delta_) foldSample(*cached_delta_, m);
+
     new_state_ = NewState::MEASURE;
     slam_backend_->onSmartFactorChanged(my_id_, this);
     new_state_ = NewState::NONE;
@@ -55,6 +67,63 @@ void SmartFactorIMU::createIMUFactor(
     new_state_    = NewState::FACTOR;
     slam_backend_->onSmartFactorChanged(my_id_, this);
     new_state_ = NewState::NONE;
+
+    // The new factor closes the current preintegration window:
+    samples_.clear();
+    cached_delta_.reset();
+}
+
+void SmartFactorIMU::foldSample(PreintegratedDelta& d, const ImuSample& m)
+{
+    // Bias-corrected measurements:
+    const mrpt::math::TVector3D a = {
+        m.ax - d.biasAcc.x, m.ay - d.biasAcc.y, m.az - d.biasAcc.z};
+    const mrpt::math::TVector3D w = {
+        m.wx - d.biasGyr.x, m.wy - d.biasGyr.y, m.wz - d.biasGyr.z};
+
+    // Rotate the acceleration into the frame of the window start:
+    const auto& R  = d.deltaR;
+    const auto  aW = mrpt::math::TVector3D(
+        R(0, 0) * a.x + R(0, 1) * a.y + R(0, 2) * a.z,
+        R(1, 0) * a.x + R(1, 1) * a.y + R(1, 2) * a.z,
+        R(2, 0) * a.x + R(2, 1) * a.y + R(2, 2) * a.z);
+
+    d.deltaP = d.deltaP + d.deltaV * m.dt + aW * (0.5 * m.dt * m.dt);
+    d.deltaV = d.deltaV + aW * m.dt;
+
+    mrpt::math::CVectorFixedDouble<3> wdt;
+    wdt[0] = w.x * m.dt;
+    wdt[1] = w.y * m.dt;
+    wdt[2] = w.z * m.dt;
+    d.deltaR = d.deltaR * mrpt::poses::Lie::SO<3>::exp(wdt);
+
+    d.deltaT += m.dt;
+}
+
+const SmartFactorIMU::PreintegratedDelta& SmartFactorIMU::preintegrated(
+    const mrpt::math::TVector3D& biasAcc, const mrpt::math::TVector3D& biasGyr)
+{
+    if (cached_delta_)
+    {
+        const auto dba = biasAcc - cached_delta_->biasAcc;
+        const auto dbg = biasGyr - cached_delta_->biasGyr;
+
+        const double biasChange = std::max(
+            {std::abs(dba.x), std::abs(dba.y), std::abs(dba.z),
+             std::abs(dbg.x), std::abs(dbg.y), std::abs(dbg.z)});
+
+        if (biasChange <= bias_reuse_epsilon_) return *cached_delta_;
+    }
+
+    // The bias estimate moved beyond tolerance (or this is the first call):
+    // re-preintegrate the whole window at the new linearization point.
+    auto& d = cached_delta_.emplace();
+    d.deltaR.setIdentity();
+    d.biasAcc = biasAcc;
+    d.biasGyr = biasGyr;
+    for (const auto& m : samples_) foldSample(d, m);
+
+    return *cached_delta_;
 }
 
 // Implementation of the CSerializable virtual interface:
@@ -36,6 +36,20 @@ void FrontEndBase::initialize(const Yaml& cfg)
         }
         else { front_end_source_names_.insert(ds_source.as<std::string>()); }
 
+        // Optional sensor-label subscription patterns, so the sources never
+        // even invoke onNewObservation() for labels we will discard anyway:
+        std::vector<std::string> labelPatterns;
+        if (cfg.has("raw_sensor_labels"))
+        {
+            auto lbls = cfg["raw_sensor_labels"];
+            if (lbls.isSequence())
+            {
+                for (const auto& v : lbls.asSequence())
+                    labelPatterns.push_back(v.as<std::string>());
+            }
+            else { labelPatterns.push_back(lbls.as<std::string>()); }
+        }
+
         for (const auto& src_name : front_end_source_names_)
         {
             MRPT_LOG_DEBUG_STREAM(
@@ -58,7 +72,7 @@ void FrontEndBase::initialize(const Yaml& cfg)
                     src_name.c_str());
 
             // Subscribe:
-            rdsb->attachToDataConsumer(*this);
+            rdsb->attachToDataConsumer(*this, labelPatterns);
         }
     }
     else
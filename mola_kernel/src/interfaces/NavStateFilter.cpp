@@ -38,10 +38,22 @@ NavStateFilter::NavStateFilter()
 
 NavStateFilter::~NavStateFilter() = default;
 
+const mrpt::math::CMatrixDouble66& NavState::pose_inv_cov()
+{
+    if (deferred_pose_inv_cov)
+    {
+        pose.cov_inv          = deferred_pose_inv_cov();
+        deferred_pose_inv_cov = {};  // now cached in pose.cov_inv
+    }
+    return pose.cov_inv;
+}
+
 std::string NavState::asString() const
 {
     std::ostringstream ss;
     ss << "pose  : " << pose;
+    if (deferred_pose_inv_cov)
+        ss << "pose inv_cov: (deferred, not evaluated yet)\n";
     ss << "twist : " << twist.asString() << "\n";
     ss << "twist inv_cov diagonal: "
        << twist_inv_cov.asEigen().diagonal().transpose() << "\n";
@@ -10,15 +10,26 @@
  * @date   Nov 21, 2018
  */
 
+#include <mola_kernel/Tracer.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
 #include <mola_kernel/interfaces/VizInterface.h>
 #include <mola_yaml/yaml_helpers.h>
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/lock_helper.h>
+#include <mrpt/maps/CPointsMap.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationImage.h>
+#include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <chrono>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <unordered_set>
 
 using namespace mola;
 
@@ -28,6 +39,9 @@ IMPLEMENTS_VIRTUAL_MRPT_OBJECT(RawDataSourceBase, ExecutableBase, mola)
 struct RawDataSourceBase::SensorViewerImpl
 {
     unsigned int decimation{1}, decim_counter{0};
+    double       max_fps{0};  //!< Max preview update rate [Hz] (0=unlimited)
+    double       last_preview_tim{0};  //!< [s] For max_fps
+    unsigned int downscale{1};  //!< Preview image size divisor (camera obs)
     std::string  sensor_label;
     std::string  win_pos;  //!< "[x,y,width,height]"
 
@@ -38,6 +52,35 @@ RawDataSourceBase::RawDataSourceBase() = default;
 
 RawDataSourceBase::~RawDataSourceBase()
 {
+    stop_obs_dispatch_threads();
+
+    // Report reorder-stage counters, if any. No flush here: consumers may
+    // already be tearing down, and datasets flush in onDatasetPlaybackEnds():
+    {
+        auto lck = mrpt::lockHelper(reorder_mtx_);
+        if (reorder_late_)
+            MRPT_LOG_WARN_STREAM(
+                "reorder_window: " << reorder_late_
+                                   << " observations arrived too late and "
+                                      "were delivered out of order.");
+        if (!reorder_heap_.empty())
+            MRPT_LOG_INFO_STREAM(
+                "reorder_window: discarding "
+                << reorder_heap_.size()
+                << " observations still held at shutdown.");
+    }
+
+    // Report QoS dropped-message counters, if any:
+    {
+        auto lck = mrpt::lockHelper(sensor_qos_mtx_);
+        for (const auto& [label, st] : sensor_qos_state_)
+            if (st.dropped)
+                MRPT_LOG_INFO_STREAM(
+                    "QoS policy for sensor '" << label << "' dropped "
+                                              << st.dropped
+                                              << " observations.");
+    }
+
     if (gui_updater_threadpool_.pendingTasks())
     {
         MRPT_LOG_INFO_STREAM(
@@ -65,12 +108,16 @@ void RawDataSourceBase::initialize(const Yaml& cfg)
         auto ds_preview = cfg["gui_preview_sensors"];
         for (const auto& s : ds_preview.asSequence())
         {
-            const auto sensor = mrpt::containers::yaml(s);
+            const auto sensor = mola::YamlView(s);
             const auto label  = sensor["raw_sensor_label"].as<std::string>();
             const auto decim =
                 sensor.getOrDefault<unsigned int>("decimation", 1);
+            const auto maxFPS = sensor.getOrDefault<double>("max_fps", .0);
+            const auto downscale =
+                sensor.getOrDefault<unsigned int>("downscale", 1);
             const auto win_pos =
                 sensor.getOrDefault<std::string>("win_pos", "");
+            ASSERT_GE_(downscale, 1U);
 
             ASSERTMSG_(
                 sensor_preview_gui_.find(label) == sensor_preview_gui_.end(),
@@ -81,6 +128,8 @@ void RawDataSourceBase::initialize(const Yaml& cfg)
                 mrpt::make_impl<RawDataSourceBase::SensorViewerImpl>();
 
             sv->decimation   = decim;
+            sv->max_fps      = maxFPS;
+            sv->downscale    = downscale;
             sv->sensor_label = label;
             sv->win_pos      = win_pos;
             // sv->win: Create a window when the sensor actually publishes.
@@ -100,6 +149,78 @@ void RawDataSourceBase::initialize(const Yaml& cfg)
     YAML_LOAD_MEMBER_OPT(force_load_lazy_load, bool);
     YAML_LOAD_MEMBER_OPT(quit_mola_app_on_dataset_end, bool);
 
+    // Lock-free observation delivery queue:
+    YAML_LOAD_MEMBER_OPT(use_lockfree_queue, bool);
+    YAML_LOAD_MEMBER_OPT(lockfree_queue_capacity, unsigned int);
+    YAML_LOAD_MEMBER_OPT(batch_delivery_window, double);
+
+    // Optional bounded-latency timestamp reorder stage:
+    YAML_LOAD_MEMBER_OPT(reorder_window, double);
+    ASSERT_GE_(reorder_window_, .0);
+
+    // Optional per-sensor-label delivery QoS policies:
+    if (cfg.has("sensor_queues"))
+    {
+        for (const auto& s : cfg["sensor_queues"].asSequence())
+        {
+            const auto sensor = mola::YamlView(s);
+            const auto label  = sensor["raw_sensor_label"].as<std::string>();
+            const auto sPolicy =
+                sensor.getOrDefault<std::string>("policy", "keep_all");
+
+            SensorQoS qos;
+            if (sPolicy == "keep_all")  //
+                qos.policy = SensorQoS::Policy::KeepAll;
+            else if (sPolicy == "keep_latest")
+                qos.policy = SensorQoS::Policy::KeepLatest;
+            else if (sPolicy == "decimate")
+                qos.policy = SensorQoS::Policy::Decimate;
+            else
+                THROW_EXCEPTION_FMT(
+                    "Unknown QoS `policy`: `%s` for sensor label `%s` "
+                    "(expected: keep_all | keep_latest | decimate)",
+                    sPolicy.c_str(), label.c_str());
+
+            qos.min_period = sensor.getOrDefault<double>("min_period", .0);
+            qos.max_backlog = sensor.getOrDefault<unsigned int>(
+                "max_backlog", qos.max_backlog);
+            if (qos.policy == SensorQoS::Policy::Decimate)
+                ASSERT_GT_(qos.min_period, .0);
+
+            sensor_qos_[label] = qos;
+        }
+    }
+
+    // Optional per-sensor-label observation pre-filters:
+    if (cfg.has("observation_prefilter"))
+    {
+        for (const auto& s : cfg["observation_prefilter"].asSequence())
+        {
+            const auto sensor = mola::YamlView(s);
+            const auto label  = sensor["raw_sensor_label"].as<std::string>();
+
+            ObsPreFilter f;
+            f.range_clip_min =
+                sensor.getOrDefault<double>("range_clip_min", .0);
+            f.range_clip_max =
+                sensor.getOrDefault<double>("range_clip_max", .0);
+            f.fov_azimuth_min_deg =
+                sensor.getOrDefault<double>("fov_azimuth_min_deg", .0);
+            f.fov_azimuth_max_deg =
+                sensor.getOrDefault<double>("fov_azimuth_max_deg", .0);
+            f.voxel_decimation =
+                sensor.getOrDefault<double>("voxel_decimation", .0);
+
+            ASSERT_GE_(f.range_clip_min, .0);
+            if (f.range_clip_max > 0)
+                ASSERT_GT_(f.range_clip_max, f.range_clip_min);
+            ASSERT_GE_(f.fov_azimuth_max_deg, f.fov_azimuth_min_deg);
+            ASSERT_GE_(f.voxel_decimation, .0);
+
+            obs_prefilter_[label] = f;
+        }
+    }
+
     // children params:
     this->initialize_rds(cfg);
 
@@ -112,6 +233,91 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
     MRPT_TRY_START
 
     ASSERT_(obs);
+
+    // Optional reorder stage (`reorder_window` in initialize()): hold each
+    // observation in a small min-heap until the newest timestamp seen is a
+    // full window ahead of it, then release oldest-first, so slightly
+    // out-of-order multi-sensor streams reach consumers sorted in time:
+    if (reorder_window_ <= 0 || obs->timestamp == INVALID_TIMESTAMP)
+    {
+        deliverObservationToFrontEnds(obs);
+        return;
+    }
+
+    const double tim = mrpt::Clock::toDouble(obs->timestamp);
+
+    bool                                      deliverLate = false;
+    std::vector<mrpt::obs::CObservation::Ptr> release;
+    {
+        auto lck = mrpt::lockHelper(reorder_mtx_);
+
+        // A straggler older than something already released cannot be
+        // reordered anymore; pass it through (better than dropping it):
+        if (tim < reorder_last_released_)
+        {
+            reorder_late_++;
+            deliverLate = true;
+        }
+        else
+        {
+            reorder_heap_.push({tim, obs});
+            reorder_newest_ = std::max(reorder_newest_, tim);
+
+            while (!reorder_heap_.empty() &&
+                   reorder_heap_.top().tim <=
+                       reorder_newest_ - reorder_window_)
+            {
+                reorder_last_released_ = reorder_heap_.top().tim;
+                release.push_back(reorder_heap_.top().obs);
+                reorder_heap_.pop();
+            }
+        }
+    }
+
+    if (deliverLate)
+    {
+        MRPT_LOG_THROTTLE_WARN_FMT(
+            10.0,
+            "reorder_window: observation '%s' arrived too late to be "
+            "reordered; delivering it out of order. Consider enlarging the "
+            "window.",
+            obs->sensorLabel.c_str());
+        deliverObservationToFrontEnds(obs);
+        return;
+    }
+
+    for (const auto& o : release) deliverObservationToFrontEnds(o);
+
+    MRPT_TRY_END
+}
+
+void RawDataSourceBase::reorderFlush()
+{
+    std::vector<mrpt::obs::CObservation::Ptr> release;
+    {
+        auto lck = mrpt::lockHelper(reorder_mtx_);
+        while (!reorder_heap_.empty())
+        {
+            reorder_last_released_ = reorder_heap_.top().tim;
+            release.push_back(reorder_heap_.top().obs);
+            reorder_heap_.pop();
+        }
+    }
+    for (const auto& o : release) deliverObservationToFrontEnds(o);
+}
+
+void RawDataSourceBase::deliverObservationToFrontEnds(
+    const mrpt::obs::CObservation::Ptr& obs)
+{
+    MRPT_TRY_START
+
+    TraceSpan span("sendObservationsToFrontEnds");
+
+    // QoS admission: apply this label's policy *before* spending any work on
+    // the observation, so shed load actually bounds end-to-end latency (see
+    // `sensor_queues` in initialize()):
+    if (!admitObservationQoS(obs)) return;
+
     // Forward the data to my associated consumer:
     if (!rdc_.empty())
     {
@@ -119,7 +325,32 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
         prepareObservationBeforeFrontEnds(obs);
 
         // Forward data:
-        for (auto& subscriber : rdc_) subscriber->onNewObservation(obs);
+        if (use_lockfree_queue_)
+        {
+            // Lock-free path: publish once; each consumer has its own cursor
+            // and dispatch thread, so concurrent sensor threads never
+            // serialize on a mutex here.
+            std::call_once(
+                obs_queue_init_flag_, [this]() { lazy_init_obs_queue(); });
+            // Virtual-time drain barrier: one pending delivery per
+            // *subscribed* consumer cursor (see
+            // VirtualTimeService::advanceTo()):
+            if (virtual_time_)
+                virtual_time_->addPendingWork(
+                    subscribersFor(obs->sensorLabel).consumers.size());
+            obs_queue_->publish(obs);
+        }
+        else
+        {
+            for (auto* subscriber : subscribersFor(obs->sensorLabel).consumers)
+            {
+                subscriber->onNewObservation(obs);
+                // Wake up the consumer module at once if it is parked
+                // waiting for its next spin period:
+                if (auto* eb = dynamic_cast<ExecutableBase*>(subscriber); eb)
+                    eb->nudge();
+            }
+        }
     }
     else
     {
@@ -138,6 +369,95 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
         }
     }
 
+    exportAndPreviewObservation(obs);
+
+    MRPT_TRY_END
+}
+
+void RawDataSourceBase::sendObservationBatchToFrontEnds(
+    const std::vector<mrpt::obs::CObservation::Ptr>& obs)
+{
+    MRPT_TRY_START
+
+    if (obs.empty()) return;
+
+    // A singleton burst gains nothing from the batch path:
+    if (obs.size() == 1)
+    {
+        sendObservationsToFrontEnds(obs.front());
+        return;
+    }
+
+    TraceSpan span("sendObservationBatchToFrontEnds");
+
+    // QoS admission per observation, as in the one-by-one path:
+    std::vector<mrpt::obs::CObservation::Ptr> admitted;
+    admitted.reserve(obs.size());
+    for (const auto& o : obs)
+    {
+        ASSERT_(o);
+        if (admitObservationQoS(o)) admitted.push_back(o);
+    }
+    if (admitted.empty()) return;
+
+    if (!rdc_.empty())
+    {
+        for (const auto& o : admitted) prepareObservationBeforeFrontEnds(o);
+
+        if (use_lockfree_queue_)
+        {
+            // Queued path: publish back-to-back. The burst is re-coalesced
+            // into one onNewObservationBatch() call by the per-consumer
+            // dispatch thread when `batch_delivery_window`>0; otherwise
+            // observations are still drained in one polling pass, without
+            // intervening sleeps.
+            std::call_once(
+                obs_queue_init_flag_, [this]() { lazy_init_obs_queue(); });
+            if (virtual_time_)
+                for (const auto& o : admitted)
+                    virtual_time_->addPendingWork(
+                        subscribersFor(o->sensorLabel).consumers.size());
+            for (const auto& o : admitted) obs_queue_->publish(o);
+        }
+        else
+        {
+            // Direct path: one call (and one wake-up) per consumer, with the
+            // burst narrowed down to each consumer's subscribed labels:
+            for (size_t i = 0; i < rdc_.size(); i++)
+            {
+                std::vector<mrpt::obs::CObservation::Ptr> filtered;
+                filtered.reserve(admitted.size());
+                for (const auto& o : admitted)
+                    if (subscribersFor(o->sensorLabel).mask[i])
+                        filtered.push_back(o);
+                if (filtered.empty()) continue;
+
+                rdc_[i]->onNewObservationBatch(filtered);
+                if (auto* eb = dynamic_cast<ExecutableBase*>(rdc_[i]); eb)
+                    eb->nudge();
+            }
+        }
+    }
+    else
+    {
+        MRPT_LOG_THROTTLE_WARN_FMT(
+            10.0,
+            "[sendObservationBatchToFrontEnds] Dropping a batch of %u "
+            "observations ('%s',...): no consumer is attached.",
+            static_cast<unsigned int>(admitted.size()),
+            admitted.front()->sensorLabel.c_str());
+    }
+
+    for (const auto& o : admitted) exportAndPreviewObservation(o);
+
+    MRPT_TRY_END
+}
+
+void RawDataSourceBase::exportAndPreviewObservation(
+    const mrpt::obs::CObservation::Ptr& obs)
+{
+    MRPT_TRY_START
+
     // if we are storing data to .rawlog, enqueue it in the specific worker
     // thread:
     if (export_to_rawlog_out_.is_open())
@@ -156,9 +476,23 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
     const auto it_sen_gui = sensor_preview_gui_.find(obs->sensorLabel);
     if (it_sen_gui != sensor_preview_gui_.end())
     {
-        // Create and enque the GUI update function, as a lambda:
         RawDataSourceBase::SensorViewerImpl* sv = &(*it_sen_gui->second);
 
+        // Preview decimation, applied here in the source so skipped frames
+        // do not even pay for the task enqueue + lambda capture:
+        if (++sv->decim_counter < sv->decimation) return;
+        sv->decim_counter = 0;
+
+        // Optional max preview rate (count-based decimation above cannot
+        // express a wall-clock cap across sensors of different rates):
+        if (sv->max_fps > 0)
+        {
+            const double now = mrpt::Clock::nowDouble();
+            if (now - sv->last_preview_tim < 1.0 / sv->max_fps) return;
+            sv->last_preview_tim = now;
+        }
+
+        // Create and enque the GUI update function, as a lambda:
         auto func = [this, sv, obs]() {
             try
             {
@@ -166,10 +500,6 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
 
                 using namespace mrpt::opengl;
 
-                // GUI update decimation:
-                if (++sv->decim_counter < sv->decimation) return;
-                sv->decim_counter = 0;
-
                 // Create subwindow now:
                 auto vizMods = this->findService<mola::VizInterface>();
                 ASSERTMSG_(
@@ -203,10 +533,31 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
                     }
                 }
 
+                // Optional image downscale before handoff to the viz queue:
+                // done once here (on this single preview thread) instead of
+                // pushing the full-resolution frame through MolaViz:
+                mrpt::obs::CObservation::Ptr vizObs = obs;
+                if (sv->downscale > 1)
+                {
+                    if (auto oi = std::dynamic_pointer_cast<
+                            mrpt::obs::CObservationImage>(obs);
+                        oi && oi->image.getWidth() >= sv->downscale)
+                    {
+                        ProfilerEntry peD(profiler_, "preview downscale");
+                        auto o2 = mrpt::obs::CObservationImage::Create(*oi);
+                        oi->image.scaleImage(
+                            o2->image, oi->image.getWidth() / sv->downscale,
+                            oi->image.getHeight() / sv->downscale,
+                            mrpt::img::IMG_INTERP_NN);
+                        vizObs = o2;
+                    }
+                    // other observation types pass through untouched
+                }
+
                 // Update the GUI:
                 // (We don't need to wait for the future result, just move on)
                 // auto fut =
-                viz->subwindow_update_visualization(obs, sv->sensor_label);
+                viz->subwindow_update_visualization(vizObs, sv->sensor_label);
             }
             catch (const std::exception& e)
             {
@@ -222,10 +573,239 @@ void RawDataSourceBase::sendObservationsToFrontEnds(
     MRPT_TRY_END
 }
 
-void RawDataSourceBase::attachToDataConsumer(RawDataConsumer& rdc)
+bool RawDataSourceBase::admitObservationQoS(const CObservation::Ptr& obs)
 {
+    const auto itQoS = sensor_qos_.find(obs->sensorLabel);
+    if (itQoS == sensor_qos_.end()) return true;  // no policy: keep all
+    const auto& qos = itQoS->second;
+
+    bool admit = true;
+    {
+        auto  lck = mrpt::lockHelper(sensor_qos_mtx_);
+        auto& st  = sensor_qos_state_[obs->sensorLabel];
+
+        switch (qos.policy)
+        {
+            case SensorQoS::Policy::KeepAll:
+                break;
+
+            case SensorQoS::Policy::KeepLatest:
+                // Only meaningful with the queued delivery path; the direct
+                // path is synchronous and never accumulates backlog:
+                if (use_lockfree_queue_ && obs_queue_ &&
+                    obs_queue_->max_backlog() > qos.max_backlog)
+                    admit = false;
+                break;
+
+            case SensorQoS::Policy::Decimate:
+            {
+                const double t = mrpt::Clock::toDouble(obs->timestamp);
+                if (st.last_admitted_tim != 0 &&
+                    t - st.last_admitted_tim < qos.min_period)
+                    admit = false;
+                else
+                    st.last_admitted_tim = t;
+                break;
+            }
+        }
+        if (!admit) st.dropped++;
+    }
+
+    if (!admit)
+    {
+        profiler_.registerUserMeasure(
+            ("qos.drop." + obs->sensorLabel).c_str(), 1.0);
+        MRPT_LOG_THROTTLE_DEBUG_FMT(
+            5.0, "QoS policy dropped observation of sensor '%s'.",
+            obs->sensorLabel.c_str());
+    }
+    return admit;
+}
+
+void RawDataSourceBase::lazy_init_obs_queue()
+{
+    obs_queue_ =
+        std::make_unique<LockFreeObservationQueue>(lockfree_queue_capacity_);
+
+    obs_dispatch_stop_ = false;
+    for (size_t i = 0; i < rdc_.size(); i++)
+    {
+        const size_t cursorIdx  = obs_queue_->register_consumer();
+        auto*        subscriber = rdc_[i];
+
+        const size_t rdcIdx = i;
+
+        obs_dispatch_threads_.emplace_back(
+            [this, cursorIdx, rdcIdx, subscriber]() {
+                // To wake up the consumer module right after delivery,
+                // if it is parked waiting for its next spin period:
+                auto* subscriberExec =
+                    dynamic_cast<ExecutableBase*>(subscriber);
+
+                // A throwing consumer must not kill this thread: its frozen
+                // cursor would eventually stall every producer on the full
+                // ring. Exceptions are contained per delivery, and the
+                // pending-work accounting still runs so the virtual-time
+                // barrier cannot get stuck either:
+                const auto deliverOne =
+                    [this, subscriber](const CObservation::Ptr& o)
+                {
+                    try
+                    {
+                        TraceSpan span("onNewObservation");
+                        subscriber->onNewObservation(o);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        MRPT_LOG_ERROR_STREAM(
+                            "Exception in onNewObservation() of a consumer:\n"
+                            << mrpt::exception_to_str(e));
+                    }
+                    if (virtual_time_) virtual_time_->removePendingWork(1);
+                };
+                const auto deliverBatch =
+                    [this, subscriber](
+                        const std::vector<CObservation::Ptr>& b)
+                {
+                    try
+                    {
+                        subscriber->onNewObservationBatch(b);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        MRPT_LOG_ERROR_STREAM(
+                            "Exception in onNewObservationBatch() of a "
+                            "consumer:\n"
+                            << mrpt::exception_to_str(e));
+                    }
+                    if (virtual_time_)
+                        virtual_time_->removePendingWork(b.size());
+                };
+
+                // Coalescing buffer for batched delivery:
+                std::vector<mrpt::obs::CObservation::Ptr> batch;
+                double batchT0 = 0;  // time of first obs in `batch`
+
+                while (!obs_dispatch_stop_)
+                {
+                    if (auto obs = obs_queue_->poll(cursorIdx); obs)
+                    {
+                        // Subscription filter: labels this consumer did
+                        // not subscribe to are skipped without invoking
+                        // it (their pending work was never counted):
+                        if (!subscribersFor(obs->sensorLabel).mask[rdcIdx])
+                        {
+                            // fall through to the batch flush check
+                        }
+                        else if (batch_delivery_window_ <= 0)
+                        {
+                            deliverOne(obs);
+                            if (subscriberExec) subscriberExec->nudge();
+                            continue;
+                        }
+                        else
+                        {
+                            if (batch.empty())
+                                batchT0 = mrpt::Clock::nowDouble();
+                            batch.push_back(obs);
+                        }
+                    }
+                    else
+                    {
+                        // Sleep also while a batch is open: its flush below
+                        // only needs ~batch_delivery_window resolution, and
+                        // polling without this pause would busy-spin a full
+                        // core for the whole window:
+                        std::this_thread::sleep_for(
+                            std::chrono::microseconds(100));
+                    }
+
+                    // Flush the batch once the window has elapsed, even
+                    // if observations keep arriving (bounds latency):
+                    if (!batch.empty() &&
+                        mrpt::Clock::nowDouble() - batchT0 >=
+                            batch_delivery_window_)
+                    {
+                        deliverBatch(batch);
+                        batch.clear();
+                        if (subscriberExec) subscriberExec->nudge();
+                    }
+                }
+                // Do not lose pending data on shutdown:
+                if (!batch.empty()) deliverBatch(batch);
+            });
+    }
+}
+
+void RawDataSourceBase::stop_obs_dispatch_threads()
+{
+    obs_dispatch_stop_ = true;
+    for (auto& t : obs_dispatch_threads_)
+        if (t.joinable()) t.join();
+    obs_dispatch_threads_.clear();
+}
+
+void RawDataSourceBase::attachToDataConsumer(
+    RawDataConsumer& rdc, const std::vector<std::string>& sensor_label_patterns)
+{
+    // The lock-free queue snapshots the consumer list when it is created
+    // (first publish); a consumer attached later would silently never be
+    // served, so fail loudly instead:
+    ASSERTMSG_(
+        !obs_queue_,
+        "attachToDataConsumer() called after the first published observation "
+        "while `use_lockfree_queue=true`: all consumers must be attached "
+        "before data starts flowing.");
+
     // TODO(jlbc) fix shared_from_this()??
     rdc_.push_back(&rdc);  // rdc.getAsPtr();
+    rdc_subscriptions_.push_back(sensor_label_patterns);
+
+    // Invalidate the memoized label->subscribers table:
+    auto lck = mrpt::lockHelper(label_subscribers_mtx_);
+    label_subscribers_.clear();
+}
+
+namespace
+{
+/** Either an exact label, or a prefix match for patterns with a trailing
+ * `*` (see attachToDataConsumer()) */
+bool label_matches_pattern(const std::string& label, const std::string& pat)
+{
+    if (!pat.empty() && pat.back() == '*')
+        return label.compare(0, pat.size() - 1, pat, 0, pat.size() - 1) == 0;
+    return label == pat;
+}
+}  // namespace
+
+const RawDataSourceBase::LabelSubscribers& RawDataSourceBase::subscribersFor(
+    const std::string& label) const
+{
+    auto lck = mrpt::lockHelper(label_subscribers_mtx_);
+
+    auto it = label_subscribers_.find(label);
+    if (it != label_subscribers_.end()) return it->second;
+
+    // First observation of this label: resolve it against the patterns.
+    auto& ls = label_subscribers_[label];
+    ls.mask.assign(rdc_.size(), 0);
+    for (size_t i = 0; i < rdc_.size(); i++)
+    {
+        const auto& patterns = rdc_subscriptions_[i];
+
+        bool subscribed = patterns.empty();  // empty = everything
+        for (const auto& pat : patterns)
+            if (label_matches_pattern(label, pat))
+            {
+                subscribed = true;
+                break;
+            }
+
+        if (!subscribed) continue;
+        ls.mask[i] = 1;
+        ls.consumers.push_back(rdc_[i]);
+    }
+    return ls;
 }
 
 void RawDataSourceBase::prepareObservationBeforeFrontEnds(
@@ -259,11 +839,194 @@ void RawDataSourceBase::prepareObservationBeforeFrontEnds(
         ASSERT_EQUAL_(pc.x.size(), pc.laser_id.size());
         ASSERT_EQUAL_(pc.x.size(), pc.timestamp.size());
     }
+
+    // Optional per-sensor pre-filter, applied once here so every attached
+    // consumer receives the already-reduced cloud:
+    if (!obs_prefilter_.empty()) applyObservationPreFilter(obs);
+
+    MRPT_TRY_END
+}
+
+namespace
+{
+/** Sets keep[i]=1 for points passing all the enabled tests of `f`, and
+ * returns the number of dropped points. The flat x/y/z channels are walked
+ * with plain indexed loops on purpose: the squared-range test compiles to
+ * SIMD under -O2, and the costlier atan2()/hash stages only touch survivors
+ * of the cheap ones. */
+size_t computeKeepMask(
+    const RawDataSourceBase::ObsPreFilter& f, const float* xs, const float* ys,
+    const float* zs, const size_t n, std::vector<uint8_t>& keep)
+{
+    keep.assign(n, 1);
+
+    // 1) Range clip, on squared ranges (no sqrt needed):
+    if (f.range_clip_min > 0 || f.range_clip_max > 0)
+    {
+        const float rMin2 = mrpt::square(static_cast<float>(f.range_clip_min));
+        const float rMax2 =
+            f.range_clip_max > 0
+                ? mrpt::square(static_cast<float>(f.range_clip_max))
+                : std::numeric_limits<float>::max();
+        for (size_t i = 0; i < n; i++)
+        {
+            const float d2 =
+                xs[i] * xs[i] + ys[i] * ys[i] + zs[i] * zs[i];
+            keep[i] = static_cast<uint8_t>(d2 >= rMin2 && d2 <= rMax2);
+        }
+    }
+
+    // 2) Azimuth FOV mask:
+    if (f.fov_azimuth_max_deg > f.fov_azimuth_min_deg)
+    {
+        const float azMin = static_cast<float>(mrpt::DEG2RAD(f.fov_azimuth_min_deg));
+        const float azMax = static_cast<float>(mrpt::DEG2RAD(f.fov_azimuth_max_deg));
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!keep[i]) continue;
+            const float az = std::atan2(ys[i], xs[i]);
+            keep[i] = static_cast<uint8_t>(az >= azMin && az <= azMax);
+        }
+    }
+
+    // 3) Voxel decimation: keep the first point seen per voxel.
+    if (f.voxel_decimation > 0)
+    {
+        const float inv = 1.0f / static_cast<float>(f.voxel_decimation);
+
+        // Reusable across observations (cleared, capacity kept):
+        thread_local std::unordered_set<uint64_t> seen;
+        seen.clear();
+        seen.reserve(n / 4);
+
+        // 21 bits per biased axis index => unique keys over +-2^20 voxels:
+        constexpr uint64_t MASK = (1ULL << 21) - 1;
+        constexpr int64_t  BIAS = 1LL << 20;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (!keep[i]) continue;
+            const auto vx =
+                static_cast<uint64_t>(
+                    static_cast<int64_t>(xs[i] * inv) + BIAS) & MASK;
+            const auto vy =
+                static_cast<uint64_t>(
+                    static_cast<int64_t>(ys[i] * inv) + BIAS) & MASK;
+            const auto vz =
+                static_cast<uint64_t>(
+                    static_cast<int64_t>(zs[i] * inv) + BIAS) & MASK;
+            if (!seen.insert(vx | (vy << 21) | (vz << 42)).second)
+                keep[i] = 0;
+        }
+    }
+
+    size_t removed = 0;
+    for (size_t i = 0; i < n; i++)
+        if (!keep[i]) removed++;
+    return removed;
+}
+}  // namespace
+
+void RawDataSourceBase::applyObservationPreFilter(
+    const CObservation::Ptr& obs) const
+{
+    MRPT_TRY_START
+
+    using namespace mrpt::obs;
+
+    const auto itF = obs_prefilter_.find(obs->sensorLabel);
+    if (itF == obs_prefilter_.end()) return;
+    const auto& f = itF->second;
+
+    // Reusable scratch; this may run in several sensor threads at once:
+    thread_local std::vector<uint8_t> keep;
+
+    size_t removed = 0, n = 0;
+
+    if (auto oPc = mrpt::ptr_cast<CObservationPointCloud>::from(obs);
+        oPc && oPc->pointcloud)
+    {
+        auto& pc = *oPc->pointcloud;
+        n        = pc.size();
+        if (!n) return;
+
+        removed = computeKeepMask(
+            f, pc.getPointsBufferRef_x().data(),
+            pc.getPointsBufferRef_y().data(),
+            pc.getPointsBufferRef_z().data(), n, keep);
+        if (removed)
+        {
+            // applyDeletionMask() also compacts the extra per-point channels
+            // (intensity, ring,...) of derived point map classes:
+            std::vector<bool> delMask(n);
+            for (size_t i = 0; i < n; i++) delMask[i] = !keep[i];
+            pc.applyDeletionMask(delMask);
+        }
+    }
+    else if (auto oVelo = mrpt::ptr_cast<CObservationVelodyneScan>::from(obs);
+             oVelo)
+    {
+        auto& pc = oVelo->point_cloud;
+        n        = pc.x.size();
+        if (!n) return;
+
+        removed =
+            computeKeepMask(f, pc.x.data(), pc.y.data(), pc.z.data(), n, keep);
+        if (removed)
+        {
+            // Compact every parallel per-point channel in place. Guarded by
+            // size: optional channels may be empty depending on the
+            // generatePointCloud() parameters used.
+            const auto compact = [n](auto& vec, const std::vector<uint8_t>& k)
+            {
+                if (vec.size() != n) return;
+                size_t o = 0;
+                for (size_t i = 0; i < n; i++)
+                    if (k[i]) vec[o++] = vec[i];
+                vec.resize(o);
+            };
+            compact(pc.x, keep);
+            compact(pc.y, keep);
+            compact(pc.z, keep);
+            compact(pc.intensity, keep);
+            compact(pc.timestamp, keep);
+            compact(pc.azimuth, keep);
+            compact(pc.laser_id, keep);
+
+            // The per-laser lists hold point indices, now stale; rebuild:
+            if (!pc.pointsForLaserID.empty())
+            {
+                for (auto& lst : pc.pointsForLaserID) lst.clear();
+                for (size_t i = 0; i < pc.laser_id.size(); i++)
+                {
+                    const auto id = pc.laser_id[i];
+                    if (id >= 0 && static_cast<size_t>(id) <
+                                       pc.pointsForLaserID.size())
+                        pc.pointsForLaserID[id].push_back(i);
+                }
+            }
+        }
+    }
+    else
+    {
+        // Unsupported observation type for this filter: pass through.
+        return;
+    }
+
+    if (removed)
+        MRPT_LOG_THROTTLE_DEBUG_FMT(
+            5.0, "[prefilter] '%s': removed %u of %u points.",
+            obs->sensorLabel.c_str(), static_cast<unsigned int>(removed),
+            static_cast<unsigned int>(n));
+
     MRPT_TRY_END
 }
 
 void RawDataSourceBase::onDatasetPlaybackEnds()
 {
+    // No more data is coming that could advance the reorder watermark, so
+    // hand over whatever the reorder buffer still holds:
+    reorderFlush();
+
     if (!quit_mola_app_on_dataset_end_) return;  // do nothing
 
     this->requestShutdown();  // Quit mola app
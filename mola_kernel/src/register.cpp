@@ -11,6 +11,8 @@
  */
 
 #include <mola_kernel/Factor.h>
+#include <mola_kernel/ObservationJournal.h>
+#include <mola_kernel/ProfilerDashboard.h>
 #include <mola_kernel/WorldModel.h>
 #include <mrpt/core/initializer.h>
 
@@ -21,6 +23,9 @@ MRPT_INITIALIZER(do_register_mrpt_kernel)
 {
     // Register module:
     MOLA_REGISTER_MODULE(WorldModel);
+    MOLA_REGISTER_MODULE(ProfilerDashboard);
+    MOLA_REGISTER_MODULE(ObservationJournal);
+    MOLA_REGISTER_MODULE(ObservationJournalReplay);
 
     // Register serializable classes:
     mrpt::rtti::registerClass(CLASS_ID(mola::WorldModelData));
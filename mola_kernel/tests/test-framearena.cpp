@@ -0,0 +1,129 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-framearena.cpp
+ * @brief  Tests for the FrameArena thread-local bump allocator
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_kernel/FastAllocator.h>
+#include <mrpt/core/exceptions.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Must exceed FrameArena's internal block size (256 KiB) so the request
+// takes the oversized heap-fallback path:
+constexpr std::size_t OVERSIZED_LEN = 1024 * 1024;
+
+void fill_pattern(std::uint8_t* p, const std::size_t len)
+{
+    for (std::size_t i = 0; i < len; i++)
+        p[i] = static_cast<std::uint8_t>(i * 2654435761u);
+}
+
+void check_pattern(const std::uint8_t* p, const std::size_t len)
+{
+    for (std::size_t i = 0; i < len; i++)
+        ASSERT_EQUAL_(p[i], static_cast<std::uint8_t>(i * 2654435761u));
+}
+}  // namespace
+
+void test_basic_and_reset()
+{
+    mola::FrameArena::reset_epoch();
+    ASSERT_EQUAL_(mola::FrameArena::used_bytes(), 0UL);
+
+    auto* a =
+        static_cast<std::uint8_t*>(mola::FrameArena::allocate(1000, 16));
+    ASSERT_(a != nullptr);
+    ASSERT_EQUAL_(reinterpret_cast<std::uintptr_t>(a) % 16, 0UL);
+    ASSERT_GE_(mola::FrameArena::used_bytes(), 1000UL);
+
+    mola::FrameArena::reset_epoch();
+    ASSERT_EQUAL_(mola::FrameArena::used_bytes(), 0UL);
+
+    // After a reset, regular blocks are reused: the same request must land
+    // on the same address.
+    auto* b =
+        static_cast<std::uint8_t*>(mola::FrameArena::allocate(1000, 16));
+    ASSERT_EQUAL_(a, b);
+    mola::FrameArena::reset_epoch();
+}
+
+void test_oversized_survives_block_exhaustion()
+{
+    mola::FrameArena::reset_epoch();
+
+    // An oversized allocation, filled with a known pattern:
+    auto* big = static_cast<std::uint8_t*>(
+        mola::FrameArena::allocate(OVERSIZED_LEN, 64));
+    fill_pattern(big, OVERSIZED_LEN);
+
+    ASSERT_GE_(mola::FrameArena::used_bytes(), OVERSIZED_LEN);
+
+    // Now exhaust several regular blocks within the same epoch. This used
+    // to bump-allocate *into* the oversized block, corrupting it:
+    std::vector<std::uint8_t*> smalls;
+    for (int i = 0; i < 200; i++)
+    {
+        auto* p = static_cast<std::uint8_t*>(
+            mola::FrameArena::allocate(16 * 1024, 16));
+        std::memset(p, 0xee, 16 * 1024);
+        smalls.push_back(p);
+    }
+
+    check_pattern(big, OVERSIZED_LEN);
+
+    // The oversized block must not be part of the bump walk:
+    for (const auto* p : smalls)
+        ASSERT_(
+            p + 16 * 1024 <= big || p >= big + OVERSIZED_LEN);
+
+    mola::FrameArena::reset_epoch();
+    ASSERT_EQUAL_(mola::FrameArena::used_bytes(), 0UL);
+
+    // And a fresh epoch must be able to make oversized requests again:
+    auto* big2 = static_cast<std::uint8_t*>(
+        mola::FrameArena::allocate(OVERSIZED_LEN, 64));
+    fill_pattern(big2, OVERSIZED_LEN);
+    check_pattern(big2, OVERSIZED_LEN);
+    mola::FrameArena::reset_epoch();
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_basic_and_reset();
+        test_oversized_survives_block_exhaustion();
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
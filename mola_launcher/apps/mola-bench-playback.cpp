@@ -0,0 +1,289 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   mola-bench-playback.cpp
+ * @brief  Throughput benchmark for end-to-end dataset playback
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+// Runs one dataset source module against a null-processing consumer, at
+// maximum speed, and reports observations/s, inter-delivery latency
+// percentiles at the consumer side, the source's profiler summary, and peak
+// RSS. Useful to quantify the framework overhead of the RawDataSourceBase
+// dispatch path (queues, delivery threads) with zero SLAM processing in the
+// way, and to catch throughput regressions.
+//
+// The YAML config file contains one module block, like in a mola-cli system
+// file, e.g.:
+//
+//   type: mola::KittiOdometryDataset
+//   params:
+//     base_dir: ${KITTI_BASE_DIR}
+//     sequence: '00'
+
+#include <mola_kernel/interfaces/RawDataConsumer.h>
+#include <mola_kernel/interfaces/RawDataSourceBase.h>
+#include <mola_kernel/pretty_print_exception.h>
+#include <mola_launcher/MolaLauncherApp.h>
+#include <mola_yaml/yaml_helpers.h>
+#include <mrpt/3rdparty/tclap/CmdLine.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/rtti/CObject.h>
+#include <mrpt/system/datetime.h>
+#include <mrpt/typemeta/TEnumType.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(WIN32)
+#include <sys/resource.h>  // getrusage(): peak RSS
+#endif
+
+// Declare supported cli switches ===========
+struct Cli
+{
+    TCLAP::CmdLine                        cmd{"mola-bench-playback"};
+    TCLAP::UnlabeledValueArg<std::string> arg_yaml_cfg{
+        "config",
+        "YAML file with one dataset source module block: `type:` and "
+        "`params:` (required)",
+        true,
+        "",
+        "dataset.yaml",
+        cmd};
+
+    TCLAP::ValueArg<std::string> arg_verbosity_level{
+        "v",
+        "verbosity",
+        "Verbosity level: ERROR|WARN|INFO|DEBUG (Default: WARN)",
+        false,
+        "WARN",
+        "WARN",
+        cmd};
+
+    TCLAP::ValueArg<double> arg_time_warp{
+        "w",
+        "time-warp",
+        "Playback speed override (`time_warp_scale`). The default is a large "
+        "value so the source publishes as fast as it can.",
+        false,
+        1e6,
+        "1e6",
+        cmd};
+
+    TCLAP::ValueArg<double> arg_max_time{
+        "t",
+        "max-time",
+        "Stop after this many wall-clock seconds even if the dataset did not "
+        "end (Default: 0, no limit)",
+        false,
+        .0,
+        "seconds",
+        cmd};
+};
+
+namespace
+{
+/** Null-processing sink: counts deliveries and timestamps them, so we can
+ * measure the pure framework dispatch overhead. */
+class BenchSink : public mola::RawDataConsumer
+{
+   public:
+    void onNewObservation(const mola::CObservation::Ptr& o) override
+    {
+        const double tNow = mrpt::Clock::nowDouble();
+
+        auto lck = std::lock_guard(mtx_);
+        arrival_times_.push_back(tNow);
+        perLabelCount_[o->sensorLabel]++;
+    }
+
+    struct Stats
+    {
+        size_t count    = 0;
+        double duration = 0;  //!< [s] first to last delivery
+        /// Inter-delivery gap percentiles [s]:
+        double p50 = 0, p90 = 0, p99 = 0, pMax = 0;
+        std::map<std::string, size_t> perLabelCount;
+    };
+
+    Stats stats() const
+    {
+        auto lck = std::lock_guard(mtx_);
+
+        Stats s;
+        s.count         = arrival_times_.size();
+        s.perLabelCount = perLabelCount_;
+        if (s.count < 2) return s;
+
+        s.duration = arrival_times_.back() - arrival_times_.front();
+
+        std::vector<double> gaps(s.count - 1);
+        for (size_t i = 1; i < arrival_times_.size(); i++)
+            gaps[i - 1] = arrival_times_[i] - arrival_times_[i - 1];
+        std::sort(gaps.begin(), gaps.end());
+
+        const auto pc = [&gaps](double p)
+        {
+            const auto idx = static_cast<size_t>(
+                std::min<double>(gaps.size() - 1, p * (gaps.size() - 1)));
+            return gaps[idx];
+        };
+        s.p50  = pc(0.50);
+        s.p90  = pc(0.90);
+        s.p99  = pc(0.99);
+        s.pMax = gaps.back();
+        return s;
+    }
+
+   private:
+    mutable std::mutex            mtx_;
+    std::vector<double>           arrival_times_;
+    std::map<std::string, size_t> perLabelCount_;
+};
+
+double peak_rss_MiB()
+{
+#if !defined(WIN32)
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024.0;  // [KiB] -> [MiB]
+#else
+    return .0;
+#endif
+}
+
+int bench_playback(Cli& cli)
+{
+    using namespace std::chrono_literals;
+
+    // Load YAML config file:
+    const auto file_yml = cli.arg_yaml_cfg.getValue();
+
+    auto cfg = mola::load_yaml_file(file_yml);
+    ASSERTMSG_(cfg.has("type"), "YAML config must have a `type: <class>`");
+    const auto classname = cfg["type"].as<std::string>();
+
+    // Benchmark overrides: full speed, and make the source flag us when the
+    // dataset is over (via ExecutableBase::requestedShutdown()):
+    if (!cfg.has("params")) cfg["params"] = mrpt::containers::yaml::Map();
+    cfg["params"]["time_warp_scale"]             = cli.arg_time_warp.getValue();
+    cfg["params"]["quit_mola_app_on_dataset_end"] = true;
+
+    // Load all MOLA module libraries, so the class can be found:
+    mola::MolaLauncherApp app;
+    app.scanAndLoadLibraries();
+
+    auto obj = mrpt::rtti::classFactory(classname);
+    if (!obj) obj = mrpt::rtti::classFactory("mola::" + classname);
+    ASSERTMSG_(
+        obj, mrpt::format(
+                 "Cannot create an object of type `%s`. Check the class name "
+                 "spelling, and whether its MOLA module is on the lib path.",
+                 classname.c_str()));
+
+    auto ds = std::dynamic_pointer_cast<mola::RawDataSourceBase>(obj);
+    ASSERTMSG_(
+        ds, mrpt::format(
+                "Class `%s` is not a RawDataSourceBase", classname.c_str()));
+
+    using vl = mrpt::typemeta::TEnumType<mrpt::system::VerbosityLevel>;
+    ds->setMinLoggingLevel(vl::name2value(cli.arg_verbosity_level.getValue()));
+    ds->setModuleInstanceName("bench_input");
+    ds->profiler_.setName(classname);
+    ds->profiler_.enable(true);
+
+    BenchSink sink;
+    ds->attachToDataConsumer(sink);
+
+    std::cout << "Initializing `" << classname << "`...\n";
+    {
+        const double t0 = mrpt::Clock::nowDouble();
+        ds->initialize(cfg);
+        std::cout << mrpt::format(
+            "Initialized in %.03f s.\n", mrpt::Clock::nowDouble() - t0);
+    }
+
+    // Spin at full speed until the dataset ends (or the time limit):
+    const double maxTime = cli.arg_max_time.getValue();
+    const double tStart  = mrpt::Clock::nowDouble();
+
+    while (!ds->requestedShutdown())
+    {
+        ds->spinOnce();
+
+        if (maxTime > 0 && mrpt::Clock::nowDouble() - tStart > maxTime)
+        {
+            std::cout << "(--max-time limit reached)\n";
+            break;
+        }
+    }
+    const double spinTime = mrpt::Clock::nowDouble() - tStart;
+
+    // let the delivery queues drain before taking the final snapshot:
+    std::this_thread::sleep_for(200ms);
+
+    const auto st = sink.stats();
+
+    std::cout << "\n===== mola-bench-playback results =====\n";
+    std::cout << mrpt::format(
+        "Observations delivered : %zu (%zu sensor labels)\n", st.count,
+        st.perLabelCount.size());
+    for (const auto& [label, n] : st.perLabelCount)
+        std::cout << mrpt::format("  - %-30s: %zu\n", label.c_str(), n);
+
+    std::cout << mrpt::format("Playback wall time     : %.03f s\n", spinTime);
+    if (st.duration > 0)
+        std::cout << mrpt::format(
+            "Throughput             : %.01f obs/s\n", st.count / st.duration);
+    std::cout << mrpt::format(
+        "Delivery gap percentiles [ms]: p50=%.03f p90=%.03f p99=%.03f "
+        "max=%.03f\n",
+        1e3 * st.p50, 1e3 * st.p90, 1e3 * st.p99, 1e3 * st.pMax);
+    std::cout << mrpt::format(
+        "Peak RSS               : %.01f MiB\n", peak_rss_MiB());
+
+    // Per-stage timings, as measured by the module itself:
+    std::cout << "\n----- source module profiler -----\n";
+    std::cout << ds->profiler_.getStatsAsText() << "\n";
+
+    // Destroy the module (joining its delivery threads) while the sink they
+    // may still reference is alive:
+    ds.reset();
+    obj.reset();
+
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        Cli cli;
+
+        // Parse arguments:
+        if (!cli.cmd.parse(argc, argv)) return 1;  // should exit.
+
+        return bench_playback(cli);
+    }
+    catch (std::exception& e)
+    {
+        mola::pretty_print_exception(
+            e, "[mola-bench-playback] Exit due to exception:");
+        return 1;
+    }
+}
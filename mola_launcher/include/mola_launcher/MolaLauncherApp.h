@@ -16,9 +16,15 @@
 #include <mrpt/system/COutputLogger.h>
 #include <mrpt/system/CTimeLogger.h>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <vector>
 
@@ -114,6 +120,32 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
     /** @name SLAM system control & monitoring
      * @{ */
 
+    /** Hot-reloads one module while the rest of the system keeps running:
+     * stops and joins only that module's executor thread (destroying its
+     * object), re-creates it from the class factory — optionally with a
+     * replacement YAML config block — and relaunches the executor, which
+     * re-runs initialize() with the new configuration. Other modules, their
+     * attached queues, dataset caches and the WorldModel are untouched;
+     * their cached findService() results are invalidated via the module
+     * list revision counter, so they pick up the new instance.
+     *
+     * Notes: only available in the default thread-per-module mode (not with
+     * `use_thread_pool`); must not be called concurrently with shutdown();
+     * and while the new module initializes, other modules keep spinning but
+     * skip their spinOnce() work (the same gating used during system
+     * launch).
+     *
+     * \param name        Module instance name (the `name:` YAML entry).
+     * \param newCfgBlock If given, replaces the whole stored module config
+     *                    block (must keep the `type:` and `params:`
+     *                    entries); otherwise the block from setup() is
+     *                    reused.
+     * \return false if no module with that instance name exists.
+     */
+    bool reloadModule(
+        const std::string&         name,
+        const std::optional<Yaml>& newCfgBlock = std::nullopt);
+
     /** @} */
 
     /** Scans and loads MOLA module libraries. This is automatically called
@@ -132,6 +164,135 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
     std::map<module_name_t, module_shared_path_t>
         scanForModuleSharedDirectories() const;
 
+    /** Per-module spinOnce() latency and deadline tracking.
+     *
+     * Execution times are accumulated into an HDR-style histogram: log2
+     * main buckets with 8 linear sub-buckets each, so counts keep <=12.5%
+     * relative resolution from one microsecond up to minutes in a small
+     * fixed footprint. Recording is two relaxed atomic increments plus the
+     * clock reads the executor loop performs anyway, cheap enough to stay
+     * always on. Written by the module's executor thread; snapshot() can
+     * be called live from any other thread.
+     *
+     * A per-module budget is set with the optional `spin_deadline` [s]
+     * launch-YAML entry (0 = no deadline); overruns increment a miss
+     * counter and invoke on_spin_deadline_miss_, if set.
+     * \sa getSpinStats()
+     */
+    class SpinStats
+    {
+       public:
+        void record(double spin_time_sec, double deadline_sec);
+
+        struct Snapshot
+        {
+            uint64_t spin_count      = 0;
+            uint64_t deadline_misses = 0;
+
+            /// Percentiles and maximum of the spin time [s], reconstructed
+            /// from the histogram (upper bucket bounds):
+            double p50 = 0, p90 = 0, p99 = 0, max = 0;
+        };
+        Snapshot snapshot() const;
+
+       private:
+        /// log2 main buckets (of integer microseconds) x 8 sub-buckets:
+        constexpr static unsigned SUB_BITS    = 3;
+        constexpr static unsigned NUM_MAIN    = 34;
+        constexpr static unsigned NUM_BUCKETS = NUM_MAIN << SUB_BITS;
+
+        static unsigned bucket_of(uint64_t us);
+        static double   bucket_upper_sec(unsigned idx);
+
+        std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets_{};
+
+        std::atomic<uint64_t> count_{0};
+        std::atomic<uint64_t> misses_{0};
+        std::atomic<uint64_t> maxUs_{0};
+    };
+
+    /** Live spinOnce() stats of a running module, or std::nullopt if no
+     * module with that instance name exists. \sa SpinStats */
+    std::optional<SpinStats::Snapshot> getSpinStats(
+        const std::string& name) const;
+
+    /** Opt-in per-module hardware performance counters (Linux perf_event).
+     *
+     * When enabled with the launcher-level `perf_counters` YAML flag, each
+     * module's executor thread opens a PMU counter group on itself (CPU
+     * cycles, retired instructions, last-level-cache misses, branch
+     * misses) and accumulates the deltas measured across each spinOnce()
+     * call, so the sleep time between spins is excluded. This answers what
+     * wall-clock profiling cannot: whether a slow module is memory-bound
+     * (high LLC miss rate, low IPC) or compute-bound (high IPC, low miss
+     * rates), i.e. whether to invest in data layout or in SIMD work.
+     *
+     * Counters are user-space only (no kernel events), so they work under
+     * the default `kernel.perf_event_paranoid=2`. Where perf_event is
+     * unavailable (non-Linux, VM without a PMU, seccomp) the feature
+     * degrades to Snapshot::available=false. Only supported in the
+     * default thread-per-module mode (not with `use_thread_pool`, where
+     * modules migrate between worker threads).
+     * \sa getPerfCounters()
+     */
+    class PerfCounters
+    {
+       public:
+        ~PerfCounters();
+
+        /** Opens the counter group on the calling thread (the module's
+         * executor). Returns false if perf_event is unavailable. */
+        bool open_on_this_thread();
+
+        bool is_open() const { return fds_[0] >= 0; }
+
+        void sample_begin();  //!< Read counters right before spinOnce()
+        void sample_end();  //!< Read again; accumulate the spin's deltas
+
+        struct Snapshot
+        {
+            bool     available  = false;
+            uint64_t spin_count = 0;
+
+            /// Totals over all sampled spinOnce() calls:
+            uint64_t cycles = 0, instructions = 0;
+            uint64_t llc_misses = 0, branch_misses = 0;
+        };
+        /// Thread-safe; can be called live from any thread.
+        Snapshot snapshot() const;
+
+       private:
+        constexpr static unsigned NUM_COUNTERS = 4;
+
+        /// perf_event fds, [0] is the group leader; -1 = not open.
+        std::array<int, NUM_COUNTERS> fds_{{-1, -1, -1, -1}};
+
+        /// Counter values at the last sample_begin():
+        std::array<uint64_t, NUM_COUNTERS> before_{};
+        bool                               beforeValid_ = false;
+
+        /// Written by the executor thread, read by snapshot():
+        std::array<std::atomic<uint64_t>, NUM_COUNTERS> accum_{};
+        std::atomic<uint64_t>                           spins_{0};
+
+        bool read_group(std::array<uint64_t, NUM_COUNTERS>& vals) const;
+        void close_all();
+    };
+
+    /** Live PMU counters of a running module, or std::nullopt if no
+     * module with that instance name exists. Snapshot::available is false
+     * unless Parameters::perf_counters is set and the counters could be
+     * opened. \sa PerfCounters */
+    std::optional<PerfCounters::Snapshot> getPerfCounters(
+        const std::string& name) const;
+
+    /** If set, invoked (from the offending module's executor thread) every
+     * time a spinOnce() call exceeds the module's `spin_deadline` budget.
+     * Keep the callback cheap and non-blocking. \sa SpinStats */
+    std::function<void(
+        const std::string& module, double spin_time, double deadline)>
+        on_spin_deadline_miss_;
+
     /** Time profiler. It's enabled/disabled status will be inherited (by
      * default, unless set otherwise in their YAML config files) by all
      * modules created upon the call to setup() */
@@ -145,11 +306,53 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
     struct Parameters
     {
         bool enforce_initialize_one_at_a_time{false};
+
+        /** If true, modules are executed as rate-scheduled tasks on a shared
+         * thread pool instead of one dedicated thread per module, which
+         * saves context-switch overhead on boxes with many modules and few
+         * cores. Selectable in the YAML top-level `launcher:` block. */
+        bool use_thread_pool{false};
+
+        /** Number of worker threads in pool mode (0 = hardware
+         * concurrency) */
+        unsigned int thread_pool_size{0};
+
+        /** If true, all module loggers are routed through
+         * mola::AsyncLogSink: console I/O happens on a background thread
+         * instead of the module threads, so verbose logging barely
+         * perturbs their timing. Selectable in the YAML top-level
+         * `launcher:` block. */
+        bool async_logging{false};
+
+        /** With async_logging: per-module cap of console messages per
+         * second (0 = unlimited); excess messages are counted and
+         * reported instead of printed. */
+        double async_logging_max_rate{0};
+
+        /** If true, a VirtualTimeService is created and injected into
+         * every module: dataset sources advance a logical replay clock
+         * (gated by a consumer drain barrier) instead of pacing against
+         * the wall clock, and module rate timers key off that clock. This
+         * yields deterministic faster-than-realtime replay for regression
+         * runs. Selectable in the YAML top-level `launcher:` block. */
+        bool virtual_time{false};
+
+        /** If true, each module executor thread samples hardware PMU
+         * counters (cycles, instructions, LLC misses, branch misses)
+         * across its spinOnce() calls; a per-module summary is reported
+         * at shutdown alongside the profiler stats. Linux perf_event
+         * only; ignored with `use_thread_pool`. Selectable in the YAML
+         * top-level `launcher:` block. \sa PerfCounters */
+        bool perf_counters{false};
     };
 
     Parameters launcher_params_;
 
    private:
+    /** Created in setup() when Parameters::virtual_time is set; injected
+     * into every module (including reloaded ones). */
+    VirtualTimeService::Ptr virtual_time_srv_;
+
     struct InfoPerRunningThread
     {
         Yaml                yaml_cfg_block;
@@ -158,8 +361,27 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
         std::string         name;
         double              execution_rate{10.0};  //!< (Hz)
         int                 launch_priority{0};
-        std::atomic_bool    initialization_done{false};
-        std::atomic_bool    this_thread_must_end{false};
+
+        /** CPU ids this module's executor thread is pinned to; empty =
+         * no pinning. Parsed from the optional per-module launch-YAML
+         * entry `cpu_affinity` (e.g. "0-3,8"). On Linux, memory is
+         * allocated with a first-touch policy, so pinning a module to the
+         * cores of one NUMA node also keeps the data it allocates on that
+         * node's local memory. */
+        std::vector<int> cpu_affinity;
+
+        /** spinOnce() wall-clock budget [s]; 0 = no deadline. Parsed from
+         * the optional per-module launch-YAML entry `spin_deadline`.
+         * \sa SpinStats */
+        double spin_deadline{0};
+
+        SpinStats spin_stats;
+
+        /** Only opened with Parameters::perf_counters. \sa PerfCounters */
+        PerfCounters perf_counters;
+
+        std::atomic_bool initialization_done{false};
+        std::atomic_bool this_thread_must_end{false};
     };
     /** Indexed by `name` */
     std::map<std::string, InfoPerRunningThread> running_threads_;
@@ -179,6 +401,11 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
 
     void executor_thread(InfoPerRunningThread& rds);  //!< Thread func.
 
+    /** Pool-mode main loop: modules run as tasks scheduled by their
+     * execution_rate on a shared worker pool (see
+     * Parameters::use_thread_pool). */
+    void spin_pooled();
+
     /** Set to true to command all running threads to exit */
     std::atomic_bool threads_must_end_{false};
     std::thread::id  spin_thread_id_;
@@ -196,13 +423,55 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
     /** Implementation for nameServer in the ExecutableBase interface */
     ExecutableBase::Ptr nameServerImpl(const std::string& name);
 
+    /** Bumped on every module load/unload; modules read it through
+     * ExecutableBase::nameServerRevision_ to know when their cached
+     * findService() results went stale. */
+    std::atomic<uint64_t> module_list_revision_{0};
+
     /** Household tasks to be done while in the infinite main loop. */
     void internal_spin_tasks();
 
+    /** One timed startup phase: library scan, module creation, each module's
+     * initialize() and first spinOnce(). Times are seconds since this object
+     * was constructed. */
+    struct StartupPhase
+    {
+        std::string name;
+        double      t_start = 0, t_end = 0;  //!< [s]
+    };
+
+    /** Filled during setup()/spin() and by the executor threads; reported
+     * once as a sorted table when the system reaches its main loop, so a
+     * slow boot can be attributed module by module. */
+    std::vector<StartupPhase> startup_phases_;
+    std::mutex                startup_phases_mtx_;
+    std::atomic_bool          startup_report_done_{false};
+
+    const std::chrono::steady_clock::time_point startup_t0_ =
+        std::chrono::steady_clock::now();
+
+    /** Records one timed startup phase (thread-safe). If tracing is active
+     * (`MOLA_TRACE`), the phase is also emitted as a Tracer span, so the
+     * boot sequence shows up in the same Chrome trace timeline as the
+     * runtime spans. */
+    void record_startup_phase(
+        const std::string&                           name,
+        const std::chrono::steady_clock::time_point& t0,
+        const std::chrono::steady_clock::time_point& t1);
+
+    /** Prints the recorded startup phases as a table, longest first. */
+    void report_startup_phases();
+
+    /** Prints the per-module PMU counter summary (IPC, miss rates) at
+     * shutdown, when Parameters::perf_counters is enabled. */
+    void report_perf_counters();
+
     template <typename T>
     void stopAllThreadsOfType()
     {
-        // signal them to end:
+        // Signal all matching modules at once (nudging them out of any
+        // spin-period sleep), so they all wind down concurrently:
+        std::vector<InfoPerRunningThread*> toJoin;
         for (auto& th : running_threads_)
         {
             InfoPerRunningThread& rds = th.second;
@@ -212,20 +481,22 @@ class MolaLauncherApp : public mrpt::system::COutputLogger
                     continue;  // nothing to do
 
                 rds.this_thread_must_end = true;
+                if (rds.impl) rds.impl->nudge();
                 MRPT_LOG_DEBUG_FMT(
                     "stopAllThreadsOfType<>: Requesting end of thread '%s'.",
                     rds.name.c_str());
-                // and wait for them:
-                if (rds.executor.joinable())
-                {
-                    rds.executor.join();
-                    MRPT_LOG_DEBUG_FMT(
-                        "stopAllThreadsOfType<>: thread '%s' successfully "
-                        "ended.",
-                        rds.name.c_str());
-                }
+                toJoin.push_back(&rds);
             }
         }
+        // ...then wait: since all were already signalled, the total join
+        // time is that of the slowest module of this type, not the sum:
+        for (auto* rds : toJoin)
+        {
+            rds->executor.join();
+            MRPT_LOG_DEBUG_FMT(
+                "stopAllThreadsOfType<>: thread '%s' successfully ended.",
+                rds->name.c_str());
+        }
         MRPT_LOG_DEBUG("stopAllThreadsOfType<> done.");
     }
 };
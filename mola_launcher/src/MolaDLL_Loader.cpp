@@ -12,16 +12,19 @@
 
 #include "MolaDLL_Loader.h"
 #include <mrpt/core/exceptions.h>
+#include <mrpt/rtti/CObject.h>
 #include <mrpt/system/CDirectoryExplorer.h>
+#include <mrpt/system/filesystem.h>
+
+#include <cstdlib>
+#include <fstream>
 #include <map>
+#include <sstream>
 
 #if defined(__unix__)
 #include <dlfcn.h>
 #endif
 
-MRPT_TODO(
-    "Improvement: automatic scanning libraries and extract their classes");
-
 /** From internal_load_lib_modules() */
 static std::map<std::string, LoadedModules> loaded_lib_handled;
 
@@ -30,10 +33,131 @@ const std::map<std::string, LoadedModules>& get_loaded_modules()
     return loaded_lib_handled;
 }
 
+// ---------------------------------------------------------------------------
+// Persisted module registry cache: maps each library file to the RTTI
+// classes it registers, so later launches can skip dlopen()ing libraries
+// whose classes are not referenced at all (see MolaDLL_Loader.h).
+// ---------------------------------------------------------------------------
+namespace
+{
+constexpr const char* MODULE_INDEX_MAGIC = "% MOLA-MODULES-CACHE 1";
+
+struct ModuleIndexEntry
+{
+    int64_t                  mtime = 0;
+    uint64_t                 size  = 0;
+    std::vector<std::string> classes;
+};
+
+// key: library absolute path
+std::map<std::string, ModuleIndexEntry> module_index;
+bool                                    module_index_loaded = false;
+
+/** Empty string = cache disabled. */
+std::string module_index_file()
+{
+    const char* f = ::getenv("MOLA_MODULES_CACHE");
+    if (f == nullptr || f[0] == '\0' || std::string(f) == "0") return {};
+    if (std::string(f) != "1") return f;  // explicit cache file path
+
+    // "1" = use the default location:
+    const char* home = ::getenv("HOME");
+#if defined(_WIN32)
+    if (home == nullptr) home = ::getenv("USERPROFILE");
+#endif
+    if (home == nullptr) return {};
+    return std::string(home) + "/.cache/mola-modules-index";
+}
+
+void load_module_index(const std::string& file)
+{
+    module_index.clear();
+
+    std::ifstream f(file);
+    if (!f.is_open()) return;
+
+    std::string line;
+    if (!std::getline(f, line) || line != MODULE_INDEX_MAGIC) return;
+
+    ModuleIndexEntry* cur = nullptr;
+    while (std::getline(f, line))
+    {
+        std::istringstream ss(line);
+        std::string        tag;
+        ss >> tag;
+        if (tag == "lib")
+        {
+            int64_t  mtime = 0;
+            uint64_t size  = 0;
+            ss >> mtime >> size;
+            std::string path;
+            std::getline(ss, path);
+            if (path.empty()) return;  // corrupted: discard the rest
+            path = path.substr(1);  // skip separator blank
+
+            cur        = &module_index[path];
+            cur->mtime = mtime;
+            cur->size  = size;
+        }
+        else if (tag == "class" && cur != nullptr)
+        {
+            std::string name;
+            ss >> name;
+            if (!name.empty()) cur->classes.push_back(name);
+        }
+    }
+}
+
+void save_module_index(const std::string& file)
+{
+    try
+    {
+        const auto dir = mrpt::system::extractFileDirectory(file);
+        if (!dir.empty() && !mrpt::system::directoryExists(dir))
+            mrpt::system::createDirectory(dir);
+
+        // Write to a temporary and rename, so concurrent launches never
+        // read a half-written index:
+        const auto tmpFile = file + "~";
+        {
+            std::ofstream f(tmpFile, std::ios::trunc);
+            if (!f.is_open()) return;
+
+            f << MODULE_INDEX_MAGIC << "\n";
+            for (const auto& [path, e] : module_index)
+            {
+                f << "lib " << e.mtime << " " << e.size << " " << path << "\n";
+                for (const auto& c : e.classes) f << "class " << c << "\n";
+            }
+        }
+        std::rename(tmpFile.c_str(), file.c_str());
+    }
+    catch (const std::exception&)
+    {
+        // the cache is best-effort only
+    }
+}
+
+std::set<std::string> registered_class_names()
+{
+    std::set<std::string> ret;
+    for (const auto* c : mrpt::rtti::getAllRegisteredClasses())
+        ret.insert(c->className);
+    return ret;
+}
+
+// "mola::Foo" -> "Foo" (launch files may use either form in `type:`)
+std::string strip_mola_ns(const std::string& s)
+{
+    return s.rfind("mola::", 0) == 0 ? s.substr(6) : s;
+}
+}  // namespace
+
 /** Loads all libs under lib_search_paths_. \sa setup() */
 void internal_load_lib_modules(
-    mrpt::system::COutputLogger&    app,
-    const std::vector<std::string>& lib_search_paths)
+    mrpt::system::COutputLogger&                app,
+    const std::vector<std::string>&             lib_search_paths,
+    const std::optional<std::set<std::string>>& only_for_classes)
 {
     MRPT_TRY_START
 
@@ -46,6 +170,15 @@ void internal_load_lib_modules(
     using direxpl = mrpt::system::CDirectoryExplorer;
     using mrpt::system::LVL_DEBUG;
 
+    const std::string cacheFile    = module_index_file();
+    const bool        cacheEnabled = !cacheFile.empty();
+    if (cacheEnabled && !module_index_loaded)
+    {
+        load_module_index(cacheFile);
+        module_index_loaded = true;
+    }
+    bool indexDirty = false;
+
     for (const auto& path : lib_search_paths)
     {
         app.logStr(
@@ -76,7 +209,55 @@ void internal_load_lib_modules(
                     continue;  // skip
                 }
             }
+#endif
+
+            // Valid cache entry for this library file?
+            bool haveFreshIndex = false;
+            if (cacheEnabled)
+            {
+                const auto mtime = static_cast<int64_t>(
+                    mrpt::system::getFileModificationTime(lib.wholePath));
+                const auto fsize = mrpt::system::getFileSize(lib.wholePath);
 
+                if (auto it = module_index.find(lib.wholePath);
+                    it != module_index.end() && it->second.mtime == mtime &&
+                    it->second.size == fsize)
+                    haveFreshIndex = true;
+            }
+
+            // If we know what this library exports and nothing in it is
+            // referenced by the present launch, do not load it at all:
+            if (haveFreshIndex && only_for_classes.has_value())
+            {
+                bool needed = false;
+                for (const auto& c : module_index[lib.wholePath].classes)
+                {
+                    if (only_for_classes->count(c) != 0 ||
+                        only_for_classes->count(strip_mola_ns(c)) != 0)
+                    {
+                        needed = true;
+                        break;
+                    }
+                }
+                if (!needed)
+                {
+                    app.logStr(
+                        LVL_DEBUG,
+                        mrpt::format(
+                            "[load modules]: Skipping `%s`: none of its "
+                            "classes are referenced by this system.",
+                            lib.name.c_str()));
+                    continue;  // skip
+                }
+            }
+
+            // Snapshot the RTTI registry so the classes this library adds
+            // can be attributed to it in the cache:
+            std::set<std::string> classesBefore;
+            const bool            reindex = cacheEnabled && !haveFreshIndex;
+            if (reindex) classesBefore = registered_class_names();
+
+#if defined(__unix__)
             void* handle = dlopen(lib.wholePath.c_str(), RTLD_LAZY);
 #else
             HMODULE handle = LoadLibrary(lib.wholePath.c_str());
@@ -96,9 +277,23 @@ void internal_load_lib_modules(
                                lib.name.c_str()));
 
             loaded_lib_handled[lib.name] = LoadedModules{lib.wholePath, handle};
+
+            if (reindex)
+            {
+                auto& e = module_index[lib.wholePath];
+                e.mtime = static_cast<int64_t>(
+                    mrpt::system::getFileModificationTime(lib.wholePath));
+                e.size = mrpt::system::getFileSize(lib.wholePath);
+                e.classes.clear();
+                for (const auto& c : registered_class_names())
+                    if (classesBefore.count(c) == 0) e.classes.push_back(c);
+                indexDirty = true;
+            }
         }
     }
 
+    if (indexDirty) save_module_index(cacheFile);
+
 #undef DLL_EXT
     MRPT_TRY_END
 }
@@ -13,6 +13,10 @@
 #pragma once
 
 #include <mrpt/system/COutputLogger.h>
+
+#include <map>
+#include <optional>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -23,10 +27,21 @@ struct LoadedModules
     void*       handle{nullptr};
 };
 
-/** Loads all libs under lib_search_paths_. \sa setup() */
+/** Loads all libs under lib_search_paths_. \sa setup()
+ *
+ * If `only_for_classes` is given AND the persisted module registry cache is
+ * enabled (environment variable `MOLA_MODULES_CACHE` set to a cache file
+ * path, or to `1` for the default `$HOME/.cache/mola-modules-index`),
+ * libraries whose cached class list (validated against file mtime+size)
+ * contains none of the given class names are not dlopen()ed at all.
+ * Libraries without a valid cache entry are always loaded (and indexed for
+ * the next run).
+ */
 void internal_load_lib_modules(
-    mrpt::system::COutputLogger&    app,
-    const std::vector<std::string>& lib_search_paths);
+    mrpt::system::COutputLogger&                app,
+    const std::vector<std::string>&             lib_search_paths,
+    const std::optional<std::set<std::string>>& only_for_classes =
+        std::nullopt);
 
 /** Returns the current list of loaded module dyanmic libraries. */
 const std::map<std::string, LoadedModules>& get_loaded_modules();
@@ -14,6 +14,9 @@
  * systems
  */
 
+#include <mola_kernel/AsyncLogSink.h>
+#include <mola_kernel/FastAllocator.h>
+#include <mola_kernel/Tracer.h>
 #include <mola_kernel/interfaces/FrontEndBase.h>
 #include <mola_kernel/interfaces/RawDataSourceBase.h>
 #include <mola_launcher/MolaLauncherApp.h>
@@ -21,18 +24,35 @@
 #include <mrpt/core/exceptions.h>
 #include <mrpt/core/get_env.h>
 #include <mrpt/system/CDirectoryExplorer.h>
-#include <mrpt/system/CRateTimer.h>
 #include <mrpt/system/filesystem.h>
 #include <mrpt/system/memory.h>
 #include <mrpt/system/string_utils.h>
 #include <mrpt/system/thread_name.h>
 
+#include <algorithm>  // min,max
+#include <atomic>
 #include <chrono>
 #include <iostream>
+#include <queue>
+#include <set>
 #include <thread>
 
 #include "MolaDLL_Loader.h"
 
+#if defined(__unix__)
+#include <pthread.h>
+#include <sched.h>
+
+#include <cstring>  // strerror()
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #if STD_FS_IS_EXPERIMENTAL
 #include <experimental/filesystem>
 namespace fs = std::experimental::filesystem;
@@ -89,6 +109,70 @@ std::string relative_to_abs_path(
     else
         return path;
 }
+
+// Parses a cpuset-like string ("0-3,8") into the list of CPU ids:
+std::vector<int> parse_cpuset(const std::string& s)
+{
+    std::vector<int> cpus;
+
+    std::vector<std::string> parts;
+    mrpt::system::tokenize(s, ", ", parts);
+    for (const auto& p : parts)
+    {
+        if (const auto dash = p.find('-'); dash != std::string::npos)
+        {
+            const int c0 = std::stoi(p.substr(0, dash));
+            const int c1 = std::stoi(p.substr(dash + 1));
+            ASSERT_LE_(c0, c1);
+            for (int c = c0; c <= c1; c++) cpus.push_back(c);
+        }
+        else
+            cpus.push_back(std::stoi(p));
+    }
+    return cpus;
+}
+
+// Pins the calling thread to the given CPU set. With the Linux first-touch
+// memory policy, this also keeps the memory the thread allocates local to
+// the NUMA node(s) owning those cores.
+void apply_cpu_affinity(
+    mrpt::system::COutputLogger& app, const std::string& threadName,
+    const std::vector<int>& cpus)
+{
+    if (cpus.empty()) return;
+
+#if defined(__unix__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int c : cpus) CPU_SET(c, &cpuset);
+
+    if (const int rc = pthread_setaffinity_np(
+            pthread_self(), sizeof(cpu_set_t), &cpuset);
+        rc != 0)
+    {
+        app.logStr(
+            mrpt::system::LVL_WARN,
+            mrpt::format(
+                "Cannot set CPU affinity for module thread `%s`: %s",
+                threadName.c_str(), strerror(rc)));
+    }
+    else
+    {
+        app.logStr(
+            mrpt::system::LVL_DEBUG,
+            mrpt::format(
+                "Thread for module `%s` pinned to %u CPU(s).",
+                threadName.c_str(), static_cast<unsigned int>(cpus.size())));
+    }
+#else
+    app.logStr(
+        mrpt::system::LVL_WARN,
+        mrpt::format(
+            "`cpu_affinity` requested for module `%s`, but thread pinning "
+            "is not implemented on this platform.",
+            threadName.c_str()));
+#endif
+}
 }  // namespace
 
 MolaLauncherApp::MolaLauncherApp()
@@ -132,20 +216,61 @@ void MolaLauncherApp::shutdown()
     stopAllThreadsOfType<FrontEndBase>();
     std::this_thread::sleep_for(50ms);
 
-    // End all threads:
+    // End all threads: signal every remaining module at once, then join,
+    // so the wait is bounded by the slowest module instead of the sum:
     MRPT_LOG_DEBUG("shutdown(): stopping all other modules.");
     for (auto& ds : running_threads_)
     {
-        if (ds.second.executor.joinable())
+        if (!ds.second.executor.joinable()) continue;
+        ds.second.this_thread_must_end = true;
+        if (ds.second.impl) ds.second.impl->nudge();
+        MRPT_LOG_DEBUG_FMT(
+            "shutdown(): stopping '%s'.", ds.second.name.c_str());
+    }
+    for (auto& ds : running_threads_)
+        if (ds.second.executor.joinable()) ds.second.executor.join();
+
+    // Final PMU counter summary, next to the profiler dumps below:
+    if (launcher_params_.perf_counters) report_perf_counters();
+
+    // Destroy the module instances from a small pool: per-module teardown
+    // work (whole-history profiler dumps, map persistence in destructors)
+    // then overlaps instead of flushing serially:
+    {
+        std::vector<ExecutableBase::Ptr> mods;
+        mods.reserve(running_threads_.size());
+        for (auto& ds : running_threads_)
+            if (ds.second.impl) mods.emplace_back(std::move(ds.second.impl));
+        running_threads_.clear();
+
+        const size_t nWorkers = std::min<size_t>(
+            mods.size(),
+            std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+        std::atomic<size_t>      nextIdx{0};
+        std::vector<std::thread> workers;
+        workers.reserve(nWorkers);
+        for (size_t w = 0; w < nWorkers; w++)
         {
-            ds.second.this_thread_must_end = true;
-            MRPT_LOG_DEBUG_FMT(
-                "shutdown(): stopping '%s'.", ds.second.name.c_str());
-            ds.second.executor.join();
+            workers.emplace_back(
+                [&]()
+                {
+                    for (;;)
+                    {
+                        const size_t i = nextIdx.fetch_add(1);
+                        if (i >= mods.size()) return;
+                        // Note: modules holding references to peers (via
+                        // nameServer) just defer that peer's destruction
+                        // to whoever drops the last reference.
+                        mods[i].reset();
+                    }
+                });
         }
+        for (auto& w : workers) w.join();
     }
+
     MRPT_LOG_INFO("shutdown(): Done.");
-    running_threads_.clear();
+    module_list_revision_++;  // invalidate findService() caches
 
     threads_must_end_ = true;
     // we need to wait for the end of spin, only if we are now in a different
@@ -158,6 +283,126 @@ void MolaLauncherApp::shutdown()
     }
 }
 
+bool MolaLauncherApp::reloadModule(
+    const std::string& name, const std::optional<Yaml>& newCfgBlock)
+{
+    MRPT_TRY_START
+    using namespace std::string_literals;
+
+    ASSERTMSG_(
+        !launcher_params_.use_thread_pool,
+        "reloadModule() is only supported in the default thread-per-module "
+        "mode (not with `use_thread_pool`).");
+
+    const auto itM = running_threads_.find(name);
+    if (itM == running_threads_.end())
+    {
+        MRPT_LOG_ERROR_STREAM("reloadModule(): unknown module `" << name
+                                                                 << "`");
+        return false;
+    }
+    InfoPerRunningThread& info = itM->second;
+
+    MRPT_LOG_INFO_STREAM("reloadModule(): stopping module `" << name << "`");
+
+    // 1) Stop and join this module's executor thread only; the rest of the
+    // system keeps running. The executor destroys the old impl on its way
+    // out (see executor_thread()).
+    info.this_thread_must_end = true;
+    if (info.impl) info.impl->nudge();  // wake it if parked between spins
+    if (info.executor.joinable()) info.executor.join();
+    ASSERT_(!info.impl);
+
+    // 2) Updated configuration (if given) and a fresh object from the
+    // factory, re-applying the same per-module settings as setup():
+    if (newCfgBlock) info.yaml_cfg_block = *newCfgBlock;
+
+    ENSURE_YAML_ENTRY_EXISTS(info.yaml_cfg_block, "type");
+    ENSURE_YAML_ENTRY_EXISTS(info.yaml_cfg_block, "params");
+    const auto ds_classname = info.yaml_cfg_block["type"].as<std::string>();
+
+    info.impl = mola::ExecutableBase::Factory(ds_classname);
+    ASSERTMSG_(
+        info.impl,
+        mrpt::format(
+            "reloadModule(): object for module `%s` of type `%s` couldn't "
+            "be constructed from the Factory.",
+            name.c_str(), ds_classname.c_str()));
+
+    auto verb_level = this->getMinLoggingLevel();
+    if (const auto verbLvl = info.yaml_cfg_block.getOrDefault<std::string>(
+            "verbosity_level", "");
+        !verbLvl.empty())
+    {
+        verb_level = mrpt::typemeta::TEnumType<
+            mrpt::system::VerbosityLevel>::name2value(verbLvl);
+    }
+    info.impl->setMinLoggingLevel(verb_level);
+
+    const auto logName = ds_classname + ":"s + name;
+    info.impl->setLoggerName(logName);
+    info.impl->setModuleInstanceName(logName);
+
+    if (launcher_params_.async_logging)
+        mola::AsyncLogSink::attach(*info.impl);
+
+    info.execution_rate = info.yaml_cfg_block.getOrDefault<double>(
+        "execution_rate", info.execution_rate);
+    info.launch_priority = info.impl->launchOrderPriority();
+
+    if (const auto sCpus =
+            info.yaml_cfg_block.getOrDefault<std::string>("cpu_affinity", "");
+        !sCpus.empty())
+        info.cpu_affinity = parse_cpuset(sCpus);
+
+    info.spin_deadline = info.yaml_cfg_block.getOrDefault<double>(
+        "spin_deadline", info.spin_deadline);
+
+    info.impl->profiler_.setName(logName);
+    info.impl->profiler_.enable(profiler_.isEnabled());
+    if (profiler_.isEnabledKeepWholeHistory())
+    {
+        info.impl->profiler_.enableKeepWholeHistory(true);
+        info.impl->profiler_dtor_save_stats_.emplace(info.impl->profiler_);
+    }
+
+    info.impl->nameServer_ = std::bind(
+        &MolaLauncherApp::nameServerImpl, this, std::placeholders::_1);
+    info.impl->nameServerRevision_ = [this]()
+    { return module_list_revision_.load(); };
+
+    if (virtual_time_srv_)
+    {
+        info.impl->virtual_time_ = virtual_time_srv_;
+        virtual_time_srv_->addOnAdvanceListener(
+            [w = std::weak_ptr<ExecutableBase>(info.impl)]()
+            {
+                if (auto m = w.lock()) m->notifySpinWaiters();
+            });
+    }
+
+    module_list_revision_++;  // invalidate findService() caches
+
+    // 3) Relaunch its executor, which re-runs initialize() with the new
+    // configuration. Other modules skip their spinOnce() work while
+    // pending_initializations_ > 0, exactly as during system launch:
+    info.this_thread_must_end = false;
+    info.initialization_done  = false;
+    pending_initializations_++;
+
+    info.executor = std::thread(
+        &MolaLauncherApp::executor_thread, this, std::ref(info));
+
+    while (!threads_must_end_ && !info.initialization_done)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    MRPT_LOG_INFO_STREAM(
+        "reloadModule(): module `" << name << "` relaunched.");
+    return true;
+
+    MRPT_TRY_END
+}
+
 void MolaLauncherApp::addPathModuleLibs(const std::string& path)
 {
     lib_search_paths_.push_back(path);
@@ -188,7 +433,23 @@ void MolaLauncherApp::setup(
 {
     MRPT_TRY_START
 
-    scanAndLoadLibraries();
+    // Collect the module classes this launch actually references, so the
+    // loader (with the module registry cache enabled, see
+    // `MOLA_MODULES_CACHE`) can avoid dlopen()ing unrelated libraries:
+    std::optional<std::set<std::string>> requiredClasses;
+    if (cfg.has("modules"))
+    {
+        auto& req = requiredClasses.emplace();
+        for (const auto& dsMap : cfg["modules"].asSequence())
+        {
+            const auto ds = mola::YamlView(dsMap);
+            if (ds.has("type")) req.insert(ds["type"].as<std::string>());
+        }
+    }
+    const auto tLoadLibs0 = std::chrono::steady_clock::now();
+    internal_load_lib_modules(*this, lib_search_paths_, requiredClasses);
+    record_startup_phase(
+        "setup.load_libraries", tLoadLibs0, std::chrono::steady_clock::now());
 
     MRPT_LOG_INFO(
         "Setting up system from YAML config... (set DEBUG verbosity level to "
@@ -204,6 +465,45 @@ void MolaLauncherApp::setup(
         << cfg << std::endl
         << "==================================================\n");
 
+    // Optional launcher-level parameters:
+    if (cfg.has("launcher"))
+    {
+        const auto l = cfg["launcher"];
+        launcher_params_.enforce_initialize_one_at_a_time = l.getOrDefault(
+            "enforce_initialize_one_at_a_time",
+            launcher_params_.enforce_initialize_one_at_a_time);
+        launcher_params_.use_thread_pool = l.getOrDefault(
+            "use_thread_pool", launcher_params_.use_thread_pool);
+        launcher_params_.thread_pool_size = l.getOrDefault(
+            "thread_pool_size", launcher_params_.thread_pool_size);
+        launcher_params_.async_logging = l.getOrDefault(
+            "async_logging", launcher_params_.async_logging);
+        launcher_params_.async_logging_max_rate = l.getOrDefault(
+            "async_logging_max_rate", launcher_params_.async_logging_max_rate);
+        launcher_params_.virtual_time =
+            l.getOrDefault("virtual_time", launcher_params_.virtual_time);
+        launcher_params_.perf_counters = l.getOrDefault(
+            "perf_counters", launcher_params_.perf_counters);
+    }
+
+    if (launcher_params_.perf_counters && launcher_params_.use_thread_pool)
+    {
+        MRPT_LOG_WARN(
+            "`perf_counters` is not supported with `use_thread_pool` "
+            "(modules migrate between worker threads): disabled.");
+        launcher_params_.perf_counters = false;
+    }
+
+    if (launcher_params_.virtual_time && !virtual_time_srv_)
+        virtual_time_srv_ = std::make_shared<VirtualTimeService>();
+
+    if (launcher_params_.async_logging)
+    {
+        mola::AsyncLogSink::set_max_rate_per_label(
+            launcher_params_.async_logging_max_rate);
+        mola::AsyncLogSink::attach(*this);
+    }
+
     // clang-format off
     const std::vector<
         std::pair<std::string, std::function<ExecutableBase::Ptr(const std::string &)>>>
@@ -223,6 +523,7 @@ void MolaLauncherApp::setup(
     // Refer to docs:
     // https://docs.mola-slam.org/latest/concept-slam-configuration-file.html
     //
+    const auto tCreate0 = std::chrono::steady_clock::now();
     for (const auto& section : lstSections)
     {
         const auto& sectName      = section.first;
@@ -236,7 +537,9 @@ void MolaLauncherApp::setup(
         // Create each module instance in this section:
         for (const auto& dsMap : cfg_blk.asSequence())
         {
-            const auto ds = mrpt::containers::yaml(dsMap);
+            // Non-owning view: avoids deep copying each module block just
+            // to read a few entries from it:
+            const auto ds = mola::YamlView(dsMap);
 
             ENSURE_YAML_ENTRY_EXISTS(ds, "type");
             ENSURE_YAML_ENTRY_EXISTS(ds, "name");
@@ -254,8 +557,9 @@ void MolaLauncherApp::setup(
             ASSERTMSG_(!ds_classname.empty(), "`type` cannot be empty!");
 
             InfoPerRunningThread& info = running_threads_[ds_label];
-            // Make a copy of the YAML config block:
-            info.yaml_cfg_block = ds;
+            // Make a copy of the YAML config block (the module thread will
+            // use it after this function returns):
+            info.yaml_cfg_block = ds.materialize();
             info.name           = ds_label;
 
             // Special case for params to be given in an external file:
@@ -325,8 +629,20 @@ void MolaLauncherApp::setup(
                 ds.getOrDefault<double>("execution_rate", 1.0);
             info.launch_priority = info.impl->launchOrderPriority();
 
+            // Optional CPU pinning (e.g. "0-3,8"); see InfoPerRunningThread:
+            if (const auto sCpus =
+                    ds.getOrDefault<std::string>("cpu_affinity", "");
+                !sCpus.empty())
+                info.cpu_affinity = parse_cpuset(sCpus);
+
+            info.spin_deadline =
+                ds.getOrDefault<double>("spin_deadline", 0.0);
+
             info.impl->setModuleInstanceName(logName);
 
+            if (launcher_params_.async_logging)
+                mola::AsyncLogSink::attach(*info.impl);
+
             info.impl->profiler_.setName(logName);
             info.impl->profiler_.enable(profiler_.isEnabled());
             if (profiler_.isEnabledKeepWholeHistory())
@@ -339,9 +655,26 @@ void MolaLauncherApp::setup(
 
             info.impl->nameServer_ = std::bind(
                 &MolaLauncherApp::nameServerImpl, this, std::placeholders::_1);
+            info.impl->nameServerRevision_ = [this]()
+            { return module_list_revision_.load(); };
+
+            if (virtual_time_srv_)
+            {
+                info.impl->virtual_time_ = virtual_time_srv_;
+                virtual_time_srv_->addOnAdvanceListener(
+                    [w = std::weak_ptr<ExecutableBase>(info.impl)]()
+                    {
+                        if (auto m = w.lock()) m->notifySpinWaiters();
+                    });
+            }
+
+            module_list_revision_++;  // invalidate findService() caches
         }
     }
 
+    record_startup_phase(
+        "setup.create_modules", tCreate0, std::chrono::steady_clock::now());
+
     MRPT_LOG_DEBUG_STREAM("All modules have been created");
 
     MRPT_TRY_END
@@ -366,39 +699,69 @@ void MolaLauncherApp::spin()
 
     MRPT_TRY_START
 
+    // Alternative scheduler: modules as rate-driven tasks on a shared pool:
+    if (launcher_params_.use_thread_pool)
+    {
+        spin_pooled();
+        return;
+    }
+
     // Launch working threads:
     // ---------------------------------
     // Sort by launch priority:
+    const auto tLaunch0 = std::chrono::steady_clock::now();
     {
-        std::multimap<int, std::string> lst;
-        std::transform(
-            running_threads_.begin(), running_threads_.end(),
-            std::inserter(lst, lst.begin()),
-            [](auto& ds) {
-                return std::make_pair(
-                    ds.second.launch_priority, ds.second.name);
-            });
-
-        for (auto& name : lst)
+        // Group by launch priority: levels are launched strictly in order,
+        // but all modules within the same level initialize() concurrently
+        // (they have no interdependencies by definition of the priority):
+        std::map<int, std::vector<std::string>> lst;
+        for (auto& ds : running_threads_)
+            lst[ds.second.launch_priority].push_back(ds.second.name);
+
+        for (auto& [priority, names] : lst)
         {
-            // atomic counter. See docs in the variable declaration (in the .h)
-            pending_initializations_++;
+            for (auto& name : names)
+            {
+                // atomic counter. See docs in the variable declaration (in
+                // the .h)
+                pending_initializations_++;
 
-            auto& ds    = running_threads_[name.second];
-            ds.executor = std::thread(
-                &MolaLauncherApp::executor_thread, this, std::ref(ds));
+                auto& ds    = running_threads_[name];
+                ds.executor = std::thread(
+                    &MolaLauncherApp::executor_thread, this, std::ref(ds));
 
-            // Wait until the new thread is done with its initialization():
-            if (launcher_params_.enforce_initialize_one_at_a_time)
+                // Wait until the new thread is done with its
+                // initialization():
+                if (launcher_params_.enforce_initialize_one_at_a_time)
+                {
+                    std::unique_lock<std::mutex> lock(thread_launch_init_mtx_);
+                    thread_launch_condition_.wait_for(
+                        lock, std::chrono::milliseconds(5),
+                        [&ds, this] {
+                            return !threads_must_end_ &&
+                                   ds.initialization_done;
+                        });
+                }
+            }
+
+            // Do not launch the next priority level until this one is fully
+            // initialized:
+            for (auto& name : names)
             {
-                std::unique_lock<std::mutex> lock(thread_launch_init_mtx_);
-                thread_launch_condition_.wait_for(
-                    lock, std::chrono::milliseconds(5),
-                    [&ds, this]
-                    { return !threads_must_end_ && ds.initialization_done; });
+                auto& ds = running_threads_[name];
+                while (!threads_must_end_ && !ds.initialization_done)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
             }
+            if (threads_must_end_) break;
+
+            MRPT_LOG_DEBUG_STREAM(
+                "spin: all modules with launch priority "
+                << priority << " are initialized.");
         }
     }
+    record_startup_phase(
+        "spin.launch_and_initialize", tLaunch0,
+        std::chrono::steady_clock::now());
 
     // Main SLAM/Localization infinite loop
     // -------------------------------------------
@@ -434,13 +797,24 @@ void MolaLauncherApp::executor_thread(InfoPerRunningThread& rds)
         // Set thread name (for debuggers)
         mrpt::system::thread_name(rds.name);
 
+        // Tag this thread for per-module memory accounting, so heap growth
+        // can be attributed to the module (see mola::MemoryAccounting):
+        mola::MemoryAccounting::set_thread_module(rds.name);
+
+        // Optional CPU/NUMA pinning, before initialize() so first-touch
+        // allocations already land on the target node:
+        apply_cpu_affinity(*this, rds.name, rds.cpu_affinity);
+
         // Ensure that modules initialize one by one, if so defined:
         std::unique_ptr<std::unique_lock<std::mutex>> lock;
         if (launcher_params_.enforce_initialize_one_at_a_time)
             lock = std::make_unique<std::unique_lock<std::mutex>>(
                 thread_launch_init_mtx_);
 
+        const auto tInit0 = std::chrono::steady_clock::now();
         rds.impl->initialize(rds.yaml_cfg_block);
+        record_startup_phase(
+            "initialize." + rds.name, tInit0, std::chrono::steady_clock::now());
 
         // Notify that we are done with initialization:
         rds.initialization_done = true;
@@ -449,7 +823,26 @@ void MolaLauncherApp::executor_thread(InfoPerRunningThread& rds)
 
         lock.reset();  // unlock at dtor, if created
 
-        mrpt::system::CRateTimer timer(rds.execution_rate);
+        // Opt-in PMU sampling of this module's spinOnce() work, attached
+        // to this very thread (after the affinity call above, so counts
+        // come from the pinned cores):
+        if (launcher_params_.perf_counters &&
+            !rds.perf_counters.open_on_this_thread())
+        {
+            MRPT_LOG_WARN_STREAM(
+                "`perf_counters` enabled but perf_event is unavailable "
+                "for module `"
+                << rds.name
+                << "` (non-Linux, no PMU, or perf_event_paranoid too "
+                   "strict): hardware counters disabled.");
+        }
+        const bool pmu = rds.perf_counters.is_open();
+
+        const double spinPeriod = 1.0 / rds.execution_rate;
+
+        const std::string spinSpanName = "spinOnce." + rds.name;
+
+        bool firstSpinDone = false;
 
         while (!threads_must_end_ && !rds.this_thread_must_end &&
                !rds.impl->requestedShutdown())
@@ -458,11 +851,47 @@ void MolaLauncherApp::executor_thread(InfoPerRunningThread& rds)
             if (pending_initializations_ == 0)
             {
                 // Run the main module loop code:
-                rds.impl->spinOnce();
+                TraceSpan span(spinSpanName.c_str());
+
+                const auto tSpin0 = std::chrono::steady_clock::now();
+                if (pmu) rds.perf_counters.sample_begin();
+                if (!firstSpinDone)
+                {
+                    // The first spin often pays one-off costs (map loading,
+                    // buffer warm-up, ...): report it as a startup phase.
+                    rds.impl->spinOnce();
+                    record_startup_phase(
+                        "first_spinOnce." + rds.name, tSpin0,
+                        std::chrono::steady_clock::now());
+                    firstSpinDone = true;
+                }
+                else
+                    rds.impl->spinOnce();
+                if (pmu) rds.perf_counters.sample_end();
+
+                // Latency histogram + deadline tracking (see SpinStats):
+                const double spinTime =
+                    std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - tSpin0)
+                        .count();
+                rds.spin_stats.record(spinTime, rds.spin_deadline);
+                if (rds.spin_deadline > 0 && spinTime > rds.spin_deadline)
+                {
+                    MRPT_LOG_THROTTLE_WARN_STREAM(
+                        5.0, "Module `"
+                                 << rds.name << "` spinOnce() took "
+                                 << spinTime * 1e3
+                                 << " ms, over its deadline of "
+                                 << rds.spin_deadline * 1e3 << " ms");
+                    if (on_spin_deadline_miss_)
+                        on_spin_deadline_miss_(
+                            rds.name, spinTime, rds.spin_deadline);
+                }
             }
 
-            // Done, cycle:
-            const bool ontime = timer.sleep();
+            // Done, cycle: park until the next period or until the module
+            // is nudge()d because new work arrived (event-driven wake-up):
+            const bool ontime = rds.impl->waitForNextSpin(spinPeriod);
             if (!ontime)
                 MRPT_LOG_THROTTLE_WARN_STREAM(
                     30.0,
@@ -500,10 +929,463 @@ void MolaLauncherApp::executor_thread(InfoPerRunningThread& rds)
                                          << rds.impl.use_count()
                                          << " references.");
         rds.impl.reset();
+        module_list_revision_++;  // invalidate findService() caches
         MRPT_LOG_DEBUG_STREAM("Done with dtor of module '" << rds.name << "'");
     }
 }
 
+// ---------- SpinStats: HDR latency histogram + deadline tracking ----------
+
+unsigned MolaLauncherApp::SpinStats::bucket_of(uint64_t us)
+{
+    constexpr unsigned SUB_COUNT = 1u << SUB_BITS;
+    if (us < SUB_COUNT) return static_cast<unsigned>(us);
+
+    unsigned msb = 0;
+    for (auto v = us >> 1; v; v >>= 1) msb++;
+
+    const unsigned shift = msb - SUB_BITS;
+    const auto     sub =
+        static_cast<unsigned>((us >> shift) & (SUB_COUNT - 1));
+
+    const unsigned idx = ((msb - SUB_BITS + 1) << SUB_BITS) + sub;
+    return std::min(idx, NUM_BUCKETS - 1);
+}
+
+double MolaLauncherApp::SpinStats::bucket_upper_sec(unsigned idx)
+{
+    constexpr unsigned SUB_COUNT = 1u << SUB_BITS;
+    if (idx < SUB_COUNT) return (idx + 1) * 1e-6;
+
+    const unsigned group = idx >> SUB_BITS;  // >= 1
+    const unsigned sub   = idx & (SUB_COUNT - 1);
+
+    const uint64_t step  = 1ULL << (group - 1);
+    const uint64_t lower = (uint64_t(SUB_COUNT) + sub) << (group - 1);
+    return (lower + step) * 1e-6;
+}
+
+void MolaLauncherApp::SpinStats::record(
+    double spin_time_sec, double deadline_sec)
+{
+    const auto us = static_cast<uint64_t>(spin_time_sec * 1e6);
+
+    buckets_[bucket_of(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t prevMax = maxUs_.load(std::memory_order_relaxed);
+    while (us > prevMax && !maxUs_.compare_exchange_weak(prevMax, us)) {}
+
+    if (deadline_sec > 0 && spin_time_sec > deadline_sec)
+        misses_.fetch_add(1, std::memory_order_relaxed);
+}
+
+MolaLauncherApp::SpinStats::Snapshot MolaLauncherApp::SpinStats::snapshot()
+    const
+{
+    Snapshot s;
+    s.spin_count      = count_.load(std::memory_order_relaxed);
+    s.deadline_misses = misses_.load(std::memory_order_relaxed);
+    s.max = maxUs_.load(std::memory_order_relaxed) * 1e-6;
+
+    if (!s.spin_count) return s;
+
+    // Reconstruct percentiles walking the cumulative histogram:
+    const auto percentile = [&](double p)
+    {
+        const uint64_t target = static_cast<uint64_t>(p * s.spin_count);
+        uint64_t       acc    = 0;
+        for (unsigned i = 0; i < NUM_BUCKETS; i++)
+        {
+            acc += buckets_[i].load(std::memory_order_relaxed);
+            if (acc > target) return bucket_upper_sec(i);
+        }
+        return s.max;
+    };
+    s.p50 = percentile(0.50);
+    s.p90 = percentile(0.90);
+    s.p99 = percentile(0.99);
+    return s;
+}
+
+std::optional<MolaLauncherApp::SpinStats::Snapshot>
+    MolaLauncherApp::getSpinStats(const std::string& name) const
+{
+    const auto it = running_threads_.find(name);
+    if (it == running_threads_.end()) return std::nullopt;
+    return it->second.spin_stats.snapshot();
+}
+
+// ---------- PerfCounters: per-module-thread PMU sampling ----------
+
+MolaLauncherApp::PerfCounters::~PerfCounters() { close_all(); }
+
+void MolaLauncherApp::PerfCounters::close_all()
+{
+#if defined(__linux__)
+    // Close the members first, the group leader last:
+    for (unsigned i = NUM_COUNTERS; i-- > 0;)
+    {
+        if (fds_[i] >= 0) ::close(fds_[i]);
+        fds_[i] = -1;
+    }
+#endif
+}
+
+bool MolaLauncherApp::PerfCounters::open_on_this_thread()
+{
+#if defined(__linux__)
+    close_all();  // e.g. re-opened after reloadModule()
+    for (auto& a : accum_) a.store(0, std::memory_order_relaxed);
+    spins_.store(0, std::memory_order_relaxed);
+    beforeValid_ = false;
+
+    constexpr std::array<uint64_t, NUM_COUNTERS> configs = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (unsigned i = 0; i < NUM_COUNTERS; i++)
+    {
+        perf_event_attr pe;
+        std::memset(&pe, 0, sizeof(pe));
+        pe.type     = PERF_TYPE_HARDWARE;
+        pe.size     = sizeof(pe);
+        pe.config   = configs[i];
+        pe.disabled = (i == 0) ? 1 : 0;  // group starts atomically below
+        // user-space only, so the default perf_event_paranoid=2 suffices:
+        pe.exclude_kernel = 1;
+        pe.exclude_hv     = 1;
+        if (i == 0)
+            pe.read_format = PERF_FORMAT_GROUP |
+                             PERF_FORMAT_TOTAL_TIME_ENABLED |
+                             PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        const auto fd = static_cast<int>(syscall(
+            SYS_perf_event_open, &pe, 0 /*this thread*/, -1 /*any cpu*/,
+            i == 0 ? -1 : fds_[0] /*group leader*/, 0UL));
+        if (fd < 0)
+        {
+            close_all();
+            return false;
+        }
+        fds_[i] = fd;
+    }
+
+    ioctl(fds_[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool MolaLauncherApp::PerfCounters::read_group(
+    std::array<uint64_t, NUM_COUNTERS>& vals) const
+{
+#if defined(__linux__)
+    // One read() returns the whole group:
+    // { nr, time_enabled, time_running, value[nr] } (PERF_FORMAT_GROUP)
+    struct
+    {
+        uint64_t nr, time_enabled, time_running;
+        uint64_t value[NUM_COUNTERS];
+    } buf;
+
+    if (::read(fds_[0], &buf, sizeof(buf)) !=
+            static_cast<ssize_t>(sizeof(buf)) ||
+        buf.nr != NUM_COUNTERS)
+        return false;
+
+    // Scale for counter multiplexing (rare with only 4 hardware events,
+    // but possible if something else grabs the PMU):
+    double scale = 1.0;
+    if (buf.time_running > 0 && buf.time_running < buf.time_enabled)
+        scale = static_cast<double>(buf.time_enabled) /
+                static_cast<double>(buf.time_running);
+
+    for (unsigned i = 0; i < NUM_COUNTERS; i++)
+        vals[i] = static_cast<uint64_t>(
+            static_cast<double>(buf.value[i]) * scale);
+    return true;
+#else
+    (void)vals;
+    return false;
+#endif
+}
+
+void MolaLauncherApp::PerfCounters::sample_begin()
+{
+    beforeValid_ = read_group(before_);
+}
+
+void MolaLauncherApp::PerfCounters::sample_end()
+{
+    if (!beforeValid_) return;
+
+    std::array<uint64_t, NUM_COUNTERS> now;
+    if (!read_group(now)) return;
+
+    for (unsigned i = 0; i < NUM_COUNTERS; i++)
+        accum_[i].fetch_add(now[i] - before_[i], std::memory_order_relaxed);
+    spins_.fetch_add(1, std::memory_order_relaxed);
+}
+
+MolaLauncherApp::PerfCounters::Snapshot
+    MolaLauncherApp::PerfCounters::snapshot() const
+{
+    Snapshot s;
+    s.available = is_open();
+    if (!s.available) return s;
+
+    s.spin_count    = spins_.load(std::memory_order_relaxed);
+    s.cycles        = accum_[0].load(std::memory_order_relaxed);
+    s.instructions  = accum_[1].load(std::memory_order_relaxed);
+    s.llc_misses    = accum_[2].load(std::memory_order_relaxed);
+    s.branch_misses = accum_[3].load(std::memory_order_relaxed);
+    return s;
+}
+
+std::optional<MolaLauncherApp::PerfCounters::Snapshot>
+    MolaLauncherApp::getPerfCounters(const std::string& name) const
+{
+    const auto it = running_threads_.find(name);
+    if (it == running_threads_.end()) return std::nullopt;
+    return it->second.perf_counters.snapshot();
+}
+
+void MolaLauncherApp::report_perf_counters()
+{
+    MRPT_LOG_INFO(
+        "Per-module hardware counters (user-space, spinOnce() only):");
+    MRPT_LOG_INFO(
+        "      Gcycles      Ginstr    IPC  LLCmiss/ki  brmiss/ki  module");
+
+    for (const auto& [name, rds] : running_threads_)
+    {
+        const auto s = rds.perf_counters.snapshot();
+        if (!s.available || !s.spin_count)
+        {
+            MRPT_LOG_INFO_FMT("%57s  %s", "(n/a)", name.c_str());
+            continue;
+        }
+        const double kInstr = 1e-3 * static_cast<double>(s.instructions);
+        MRPT_LOG_INFO_FMT(
+            "  %11.3f %11.3f  %5.2f  %10.2f %10.2f  %s", s.cycles * 1e-9,
+            s.instructions * 1e-9,
+            s.cycles ? static_cast<double>(s.instructions) / s.cycles : .0,
+            kInstr > 0 ? s.llc_misses / kInstr : .0,
+            kInstr > 0 ? s.branch_misses / kInstr : .0, name.c_str());
+    }
+}
+
+void MolaLauncherApp::spin_pooled()
+{
+    MRPT_TRY_START
+
+    using clock = std::chrono::steady_clock;
+
+    // Initialize all modules: strictly ordered across launch-priority
+    // levels, concurrently within each level:
+    {
+        std::map<int, std::vector<std::string>> lst;
+        for (auto& ds : running_threads_)
+            lst[ds.second.launch_priority].push_back(ds.second.name);
+
+        for (auto& [priority, names] : lst)
+        {
+            if (threads_must_end_) return;
+
+            std::vector<std::thread> initThreads;
+            for (auto& name : names)
+            {
+                auto& ds = running_threads_[name];
+                initThreads.emplace_back(
+                    [this, &ds]()
+                    {
+                        try
+                        {
+                            MRPT_LOG_DEBUG_STREAM(
+                                "spin_pooled: initializing module `"
+                                << ds.name << "`");
+                            const auto t0 = std::chrono::steady_clock::now();
+                            ds.impl->initialize(ds.yaml_cfg_block);
+                            record_startup_phase(
+                                "initialize." + ds.name, t0,
+                                std::chrono::steady_clock::now());
+                            ds.initialization_done = true;
+                        }
+                        catch (const std::exception& e)
+                        {
+                            MRPT_LOG_ERROR_STREAM(
+                                "Error initializing module `"
+                                << ds.name << "`:\n"
+                                << mrpt::exception_to_str(e));
+                            threads_must_end_ = true;
+                        }
+                    });
+            }
+            for (auto& t : initThreads) t.join();
+        }
+    }
+
+    // Rate scheduler: a min-heap of (next_due, module) shared by all
+    // workers; a module is re-armed only after its spinOnce() returns, so it
+    // never runs concurrently with itself:
+    struct ScheduledTask
+    {
+        clock::time_point     next_due;
+        InfoPerRunningThread* rds = nullptr;
+
+        bool operator>(const ScheduledTask& o) const
+        {
+            return next_due > o.next_due;
+        }
+    };
+    std::priority_queue<
+        ScheduledTask, std::vector<ScheduledTask>, std::greater<ScheduledTask>>
+                            heap;
+    std::mutex              heapMtx;
+    std::condition_variable heapCV;
+
+    {
+        const auto now = clock::now();
+        for (auto& th : running_threads_) heap.push({now, &th.second});
+    }
+
+    unsigned int nWorkers = launcher_params_.thread_pool_size;
+    if (nWorkers == 0)
+        nWorkers = std::max(1u, std::thread::hardware_concurrency());
+    nWorkers = std::min<unsigned int>(
+        nWorkers, std::max<size_t>(1, running_threads_.size()));
+
+    MRPT_LOG_INFO_STREAM(
+        "spin_pooled: scheduling " << running_threads_.size()
+                                   << " modules on " << nWorkers
+                                   << " worker threads.");
+
+    auto workerFn = [&]()
+    {
+        for (;;)
+        {
+            ScheduledTask task;
+            {
+                std::unique_lock<std::mutex> lk(heapMtx);
+                if (threads_must_end_) return;
+                if (heap.empty())
+                {
+                    heapCV.wait(lk);
+                    continue;
+                }
+                const auto now = clock::now();
+                if (heap.top().next_due > now)
+                {
+                    heapCV.wait_until(lk, heap.top().next_due);
+                    continue;
+                }
+                task = heap.top();
+                heap.pop();
+            }
+
+            auto& rds = *task.rds;
+            if (rds.this_thread_must_end) continue;  // drop, don't re-arm
+
+            try
+            {
+                TraceSpan span("spinOnce");
+
+                const auto tSpin0 = clock::now();
+                rds.impl->spinOnce();
+
+                // Latency histogram + deadline tracking (see SpinStats):
+                const double spinTime =
+                    std::chrono::duration<double>(clock::now() - tSpin0)
+                        .count();
+                rds.spin_stats.record(spinTime, rds.spin_deadline);
+                if (rds.spin_deadline > 0 && spinTime > rds.spin_deadline)
+                {
+                    MRPT_LOG_THROTTLE_WARN_STREAM(
+                        5.0, "Module `"
+                                 << rds.name << "` spinOnce() took "
+                                 << spinTime * 1e3
+                                 << " ms, over its deadline of "
+                                 << rds.spin_deadline * 1e3 << " ms");
+                    if (on_spin_deadline_miss_)
+                        on_spin_deadline_miss_(
+                            rds.name, spinTime, rds.spin_deadline);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                MRPT_LOG_ERROR_STREAM(
+                    "Error: Will shutdown since module `"
+                    << rds.name << "` raised an exception in spinOnce():\n"
+                    << mrpt::exception_to_str(e));
+                threads_must_end_ = true;
+                heapCV.notify_all();
+                return;
+            }
+
+            if (rds.impl->requestedShutdown())
+            {
+                MRPT_LOG_INFO_STREAM(
+                    "Shutdown requested by module `" << rds.name << "`");
+                threads_must_end_ = true;
+                heapCV.notify_all();
+                return;
+            }
+
+            // Re-arm at the module rate, skipping missed deadlines:
+            const auto period = std::chrono::duration_cast<clock::duration>(
+                std::chrono::duration<double>(1.0 / rds.execution_rate));
+            auto next = task.next_due + period;
+            if (const auto now = clock::now(); next < now) next = now;
+
+            {
+                std::lock_guard<std::mutex> lk(heapMtx);
+                heap.push({next, &rds});
+            }
+            heapCV.notify_one();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < nWorkers; i++)
+        workers.emplace_back(workerFn);
+
+    // clang-format off
+    MRPT_LOG_INFO("╔═══════════════════════════════════════╦═════════════════════════════════╗");
+    MRPT_LOG_INFO("║  Entering main MOLA application loop  ║ > CTRL+C for mola-cli to quit < ║");
+    MRPT_LOG_INFO("╚═══════════════════════════════════════╩═════════════════════════════════╝");
+    // clang-format on
+
+    spin_thread_id_ = std::this_thread::get_id();
+    while (!threads_must_end_)
+    {
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(200ms);
+        internal_spin_tasks();
+    }
+
+    heapCV.notify_all();
+    for (auto& w : workers) w.join();
+
+    // Tear down, mirroring the per-thread executor path:
+    for (auto& th : running_threads_)
+    {
+        auto& rds = th.second;
+        if (!rds.impl) continue;
+        rds.impl->onQuit();
+        MRPT_LOG_DEBUG_STREAM(
+            "spin_pooled: destructing module '" << rds.name << "'");
+        rds.impl.reset();
+        module_list_revision_++;  // invalidate findService() caches
+    }
+
+    MRPT_LOG_INFO("Main SLAM/localization loop ended.");
+
+    MRPT_TRY_END
+}
+
 ExecutableBase::Ptr MolaLauncherApp::nameServerImpl(const std::string& name)
 {
     // Special syntax to sequentially access all existing modules:
@@ -536,9 +1418,79 @@ void MolaLauncherApp::internal_spin_tasks()
     const auto mem_used = mrpt::system::getMemoryUsage();
     profiler_.registerUserMeasure("memory_used", mem_used);
 
+    // One-shot startup timing report, once all modules made it through
+    // initialize() (slow first spins of low-rate modules may be missing):
+    if (!startup_report_done_ && pending_initializations_ == 0)
+    {
+        startup_report_done_ = true;
+        report_startup_phases();
+    }
+
     MRPT_END
 }
 
+void MolaLauncherApp::record_startup_phase(
+    const std::string&                           name,
+    const std::chrono::steady_clock::time_point& t0,
+    const std::chrono::steady_clock::time_point& t1)
+{
+    using namespace std::chrono;
+
+    {
+        std::lock_guard<std::mutex> lck(startup_phases_mtx_);
+
+        auto& p   = startup_phases_.emplace_back();
+        p.name    = name;
+        p.t_start = duration<double>(t0 - startup_t0_).count();
+        p.t_end   = duration<double>(t1 - startup_t0_).count();
+    }
+
+    // Mirror the phase into the tracer (Tracer uses the same steady clock),
+    // so `MOLA_TRACE` Chrome traces show the whole boot sequence alongside
+    // the runtime spans:
+    if (Tracer::enabled())
+    {
+        Tracer::recordEvent(
+            name.c_str(),
+            duration_cast<microseconds>(t0.time_since_epoch()).count(),
+            duration_cast<microseconds>(t1.time_since_epoch()).count(),
+            Tracer::newSpanId(), 0 /*no parent*/);
+    }
+}
+
+void MolaLauncherApp::report_startup_phases()
+{
+    std::vector<StartupPhase> phases;
+    {
+        std::lock_guard<std::mutex> lck(startup_phases_mtx_);
+        phases = startup_phases_;
+    }
+    if (phases.empty()) return;
+
+    double tEnd = 0;
+    for (const auto& p : phases) tEnd = std::max(tEnd, p.t_end);
+
+    // Longest phases first, so a slow boot can be attacked top-down.
+    // Note that phases overlap (modules of the same launch priority
+    // initialize concurrently), hence the START column:
+    std::sort(
+        phases.begin(), phases.end(),
+        [](const StartupPhase& a, const StartupPhase& b)
+        { return (a.t_end - a.t_start) > (b.t_end - b.t_start); });
+
+    std::string s = mrpt::format(
+        "Startup timing report (%.2f s from construction to main loop):\n",
+        tEnd);
+    s += "   DURATION |      START | PHASE\n";
+    s += "------------+------------+-----------------------------------\n";
+    for (const auto& p : phases)
+        s += mrpt::format(
+            "%8.1f ms |%8.1f ms | %s\n", 1e3 * (p.t_end - p.t_start),
+            1e3 * p.t_start, p.name.c_str());
+
+    MRPT_LOG_INFO_STREAM(s);
+}
+
 std::map<MolaLauncherApp::module_name_t, MolaLauncherApp::module_shared_path_t>
     MolaLauncherApp::scanForModuleSharedDirectories() const
 {
@@ -0,0 +1,225 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   mola_metric_maps_benchmarks.cpp
+ * @brief  Micro-benchmarks of the mola_metric_maps classes (CSV output)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ *
+ * Emits one CSV row per benchmark on stdout
+ * (benchmark,map_points,ops,total_time_s,ns_per_op), so throughput can be
+ * tracked across releases with plain tooling.
+ *
+ * The voxel storage is hugepage-backed by default (see HugePageAllocator.h);
+ * to document its impact on TLB-bound runs, compare:
+ *
+ *     ./mola_metric_maps_benchmarks -f nn_                        # 2MB pages
+ *     MOLA_USE_HUGEPAGES=0 ./mola_metric_maps_benchmarks -f nn_   # 4kB pages
+ *
+ * The difference only shows at the largest map densities, where the shard
+ * bucket arrays outgrow the 4 kB-page TLB reach.
+ */
+
+#include <mola_metric_maps/HashedVoxelPointCloud.h>
+#include <mola_metric_maps/SparseTreesPointCloud.h>
+#include <mola_metric_maps/SparseVoxelPointCloud.h>
+#include <mrpt/3rdparty/tclap/CmdLine.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+#include <mrpt/system/CTicTac.h>
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Declare supported cli switches ===========
+static TCLAP::CmdLine cmd("mola_metric_maps_benchmarks");
+
+static TCLAP::ValueArg<double> argMinTime(
+    "t", "min-time",
+    "Minimum wall-clock time [s] spent per benchmark (default: 0.5)", false,
+    0.5, "seconds", cmd);
+
+static TCLAP::ValueArg<std::string> argFilter(
+    "f", "filter",
+    "Only run benchmarks whose name contains this substring", false, "",
+    "substring", cmd);
+
+namespace
+{
+std::vector<mrpt::math::TPoint3Df> synthetic_cloud(
+    const size_t n, const float extent)
+{
+    std::mt19937                          rng(42);  // deterministic runs
+    std::uniform_real_distribution<float> u(-extent, extent);
+
+    std::vector<mrpt::math::TPoint3Df> pts;
+    pts.reserve(n);
+    for (size_t i = 0; i < n; i++)
+        pts.emplace_back(u(rng), u(rng), 0.2f * u(rng));
+    return pts;
+}
+
+/** Repeats fn() until argMinTime elapses, then prints one CSV row.
+ *  opsPerCall is the number of "operations" (points, queries, ...) each
+ *  call to fn() performs, so ns_per_op is comparable across map sizes. */
+void benchmark(
+    const std::string& name, const size_t mapPoints, const size_t opsPerCall,
+    const std::function<void()>& fn)
+{
+    if (!argFilter.getValue().empty() &&
+        name.find(argFilter.getValue()) == std::string::npos)
+        return;
+
+    fn();  // warm-up (fills caches / pools)
+
+    mrpt::system::CTicTac tictac;
+    tictac.Tic();
+
+    size_t calls = 0;
+    double t     = 0;
+    do {
+        fn();
+        calls++;
+        t = tictac.Tac();
+    } while (t < argMinTime.getValue());
+
+    const double nsPerOp = 1e9 * t / (calls * opsPerCall);
+    std::printf(
+        "%s,%zu,%zu,%.6f,%.1f\n", name.c_str(), mapPoints, calls * opsPerCall,
+        t, nsPerOp);
+    std::fflush(stdout);
+}
+
+void benchmarks_for_density(const size_t N)
+{
+    const auto pts = synthetic_cloud(N, 50.0f /*extent [m]*/);
+
+    // queries slightly off the map points, as a scan matcher would issue:
+    auto queries = pts;
+    for (auto& q : queries) q += {0.03f, -0.02f, 0.01f};
+
+    // --- insertion ---
+    benchmark("hashed_insertPoint", N, N, [&]() {
+        mola::HashedVoxelPointCloud map(0.5f);
+        for (const auto& pt : pts) map.insertPoint(pt);
+    });
+
+    benchmark("hashed_insertPoints_batch", N, N, [&]() {
+        mola::HashedVoxelPointCloud map(0.5f);
+        map.insertPoints(pts.data(), pts.size());
+    });
+
+    benchmark("sparsevoxel_insertPoint", N, N, [&]() {
+        mola::SparseVoxelPointCloud map(0.5f);
+        for (const auto& pt : pts) map.insertPoint(pt);
+    });
+
+    benchmark("sparsetrees_insertPoint", N, N, [&]() {
+        mola::SparseTreesPointCloud map(10.0f);
+        for (const auto& pt : pts) map.insertPoint(pt);
+    });
+
+    // --- queries, over a pre-built map ---
+    mola::HashedVoxelPointCloud map(0.5f);
+    map.insertPoints(pts.data(), pts.size());
+
+    benchmark("hashed_nn_single_search", N, queries.size(), [&]() {
+        mrpt::math::TPoint3Df result;
+        float                 distSqr;
+        uint64_t              id;
+        for (const auto& q : queries)
+            (void)map.nn_single_search(q, result, distSqr, id);
+    });
+
+    benchmark("hashed_nn_multiple_search_k8", N, queries.size(), [&]() {
+        std::vector<mrpt::math::TPoint3Df> results;
+        std::vector<float>                 distsSqr;
+        std::vector<uint64_t>              ids;
+        for (const auto& q : queries)
+            map.nn_multiple_search(q, 8, results, distsSqr, ids);
+    });
+
+    benchmark("hashed_nn_radius_search_1m", N, queries.size(), [&]() {
+        std::vector<mrpt::math::TPoint3Df> results;
+        std::vector<float>                 distsSqr;
+        std::vector<uint64_t>              ids;
+        for (const auto& q : queries)
+            map.nn_radius_search(
+                q, 1.0f /*radius^2*/, results, distsSqr, ids, 0);
+    });
+
+    // --- traversal ---
+    benchmark("hashed_visitAllPoints", N, N, [&]() {
+        size_t n = 0;
+        map.visitAllPoints([&n](const mrpt::math::TPoint3Df&) { n++; });
+        ASSERT_(n != 0);
+    });
+
+    // --- serialization ---
+    benchmark("hashed_serialize", N, N, [&]() {
+        mrpt::io::CMemoryStream buf;
+        auto arch = mrpt::serialization::archiveFrom(buf);
+        arch << map;
+    });
+
+    mrpt::io::CMemoryStream buf;
+    {
+        auto arch = mrpt::serialization::archiveFrom(buf);
+        arch << map;
+    }
+    benchmark("hashed_deserialize", N, N, [&]() {
+        buf.Seek(0);
+        auto                        arch = mrpt::serialization::archiveFrom(buf);
+        mola::HashedVoxelPointCloud map2;
+        arch >> map2;
+    });
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // Parse arguments:
+        if (!cmd.parse(argc, argv)) return 1;  // should exit.
+
+        std::printf("benchmark,map_points,ops,total_time_s,ns_per_op\n");
+
+        // several map densities (the largest one is where hugepage backing
+        // of the voxel storage becomes measurable; see the note on top):
+        for (const size_t N : {10000UL, 100000UL, 500000UL, 2000000UL})
+            benchmarks_for_density(N);
+
+        return 0;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Exit due to exception:\n"
+                  << mrpt::exception_to_str(e) << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   FinalizedVoxelPointCloud.h
+ * @brief  Immutable compact voxel map for localization-only missions
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mola_metric_maps/HugePageAllocator.h>
+#include <mola_metric_maps/index3d_t.h>
+#include <mrpt/maps/NearestNeighborsCapable.h>
+#include <mrpt/math/TBoundingBox.h>
+#include <mrpt/math/TPoint3D.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mola
+{
+class HashedVoxelPointCloud;
+
+/** Immutable, compacted form of a HashedVoxelPointCloud for
+ * localization-only missions, produced by
+ * HashedVoxelPointCloud::finalize().
+ *
+ * The prior map of a localization-only deployment is never inserted into,
+ * so the hash-map shards, per-shard mutexes and per-voxel SSO containers of
+ * the live map are pure overhead there. This class keeps just two
+ * contiguous arrays: one flat XYZ point buffer grouped by voxel, and one
+ * voxel directory sorted by the Morton code of each voxel's global index
+ * (\sa index3d_morton_code). Voxel lookup during NN search is a binary
+ * search over the directory, lock-free and allocation-free, and the
+ * Morton ordering keeps spatially close voxels close in memory.
+ *
+ * The on-disk form (saveToBinaryFile()) is one blob with a fixed-size
+ * header followed by the two raw POD arrays at fixed offsets - no pointers
+ * and no per-element encoding - so it can also be memory-mapped directly
+ * by external tools; loadFromBinaryFile() here simply reads it back into
+ * the vectors.
+ *
+ * NN search semantics match the live map (3x3x3 voxel neighborhood for
+ * KNN queries), but result IDs are contiguous indices into the flat point
+ * array instead of collapsed voxel IDs.
+ */
+class FinalizedVoxelPointCloud : public mrpt::maps::NearestNeighborsCapable
+{
+   public:
+    using global_index3d_t = index3d_t<int32_t>;
+
+    /** Builds an empty map; fill it via HashedVoxelPointCloud::finalize()
+     * or loadFromBinaryFile(). */
+    FinalizedVoxelPointCloud() = default;
+
+    /** One entry of the voxel directory: the Morton code of the voxel's
+     * global index, and the range of its points within the flat XYZ
+     * array. The directory is sorted by mortonCode. */
+    struct VoxelEntry
+    {
+        uint64_t mortonCode = 0;
+        uint32_t firstPoint = 0;  //!< index into points()
+        uint32_t numPoints  = 0;
+    };
+
+    /** Multi-GB maps profit from hugepage backing of the two flat arrays
+     * (see HugePageAllocator); smaller ones land on the regular heap. */
+    using voxel_vector_t =
+        std::vector<VoxelEntry, HugePageAllocator<VoxelEntry>>;
+    using point_vector_t = std::vector<
+        mrpt::math::TPoint3Df, HugePageAllocator<mrpt::math::TPoint3Df>>;
+
+    float voxelSize() const { return voxel_size_; }
+
+    bool        empty() const { return xyz_.empty(); }
+    std::size_t size() const { return xyz_.size(); }
+
+    const voxel_vector_t& voxels() const { return voxels_; }
+    const point_vector_t& points() const { return xyz_; }
+
+    /** Bounding box of all points, computed once at finalization (or read
+     * from the file header); (0,0,0)-(0,0,0) if the map is empty. */
+    const mrpt::math::TBoundingBoxf& boundingBox() const { return bbox_; }
+
+    void visitAllPoints(
+        const std::function<void(const mrpt::math::TPoint3Df&)>& f) const
+    {
+        for (const auto& pt : xyz_) f(pt);
+    }
+
+    /** Writes the whole map as one binary blob (see class docs for the
+     * layout). Returns false on I/O errors. */
+    bool saveToBinaryFile(const std::string& fileName) const;
+
+    /** Inverse of saveToBinaryFile(); replaces the current contents.
+     * Returns false on I/O errors or a malformed/incompatible file. */
+    bool loadFromBinaryFile(const std::string& fileName);
+
+    /** @name API of the NearestNeighborsCapable virtual interface
+    @{ */
+    [[nodiscard]] bool   nn_has_indices_or_ids() const override;
+    [[nodiscard]] size_t nn_index_count() const override;
+    [[nodiscard]] bool   nn_single_search(
+          const mrpt::math::TPoint3Df& query, mrpt::math::TPoint3Df& result,
+          float& out_dist_sqr, uint64_t& resultIndexOrID) const override;
+    [[nodiscard]] bool nn_single_search(
+        const mrpt::math::TPoint2Df& query, mrpt::math::TPoint2Df& result,
+        float& out_dist_sqr, uint64_t& resultIndexOrID) const override;
+    void nn_multiple_search(
+        const mrpt::math::TPoint3Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const override;
+    void nn_multiple_search(
+        const mrpt::math::TPoint2Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint2Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const override;
+    void nn_radius_search(
+        const mrpt::math::TPoint3Df& query, const float search_radius_sqr,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs,
+        size_t                              maxPoints) const override;
+    void nn_radius_search(
+        const mrpt::math::TPoint2Df& query, const float search_radius_sqr,
+        std::vector<mrpt::math::TPoint2Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs,
+        size_t                              maxPoints) const override;
+    /** @} */
+
+   private:
+    /// finalize() fills the arrays below directly:
+    friend class HashedVoxelPointCloud;
+
+    float voxel_size_     = 1.0f;
+    float voxel_size_inv_ = 1.0f;
+
+    /// Sorted by mortonCode (unique per voxel):
+    voxel_vector_t voxels_;
+
+    /// Flat XYZ buffer, grouped by voxel, in directory order:
+    point_vector_t xyz_;
+
+    mrpt::math::TBoundingBoxf bbox_ = {{0, 0, 0}, {0, 0, 0}};
+
+    /** Binary search of the directory; nullptr if the voxel is empty. */
+    const VoxelEntry* findVoxel(const global_index3d_t& idx) const;
+
+    template <size_t MAX_KNN>
+    void nn_multiple_search_impl(
+        const mrpt::math::TPoint3Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const;
+};
+
+}  // namespace mola
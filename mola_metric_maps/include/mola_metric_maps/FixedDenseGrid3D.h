@@ -28,12 +28,158 @@
 #include <mola_metric_maps/index3d_t.h>
 #include <mrpt/core/exceptions.h>
 
+#include <algorithm>  // std::fill_n
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <mutex>
 #include <type_traits>
+#include <vector>
 
 namespace mola
 {
+/** IEEE 754 half-precision (binary16) storage type, convertible to/from
+ *  `float`, for use as a FixedDenseGrid3D cell payload: halves the cell
+ *  footprint of float grids so twice as many blocks fit in cache.
+ *  Conversions truncate the mantissa (no rounding), which is more than
+ *  enough for occupancy-style payloads.
+ */
+struct fp16_t
+{
+    uint16_t bits = 0;
+
+    fp16_t() = default;
+    fp16_t(float f) : bits(fromFloat(f)) {}
+
+    fp16_t& operator=(float f)
+    {
+        bits = fromFloat(f);
+        return *this;
+    }
+
+    operator float() const { return toFloat(bits); }
+
+    static uint16_t fromFloat(float f)
+    {
+        uint32_t x;
+        std::memcpy(&x, &f, sizeof(x));
+
+        const auto sign = static_cast<uint16_t>((x >> 16) & 0x8000u);
+        x &= 0x7fffffffu;
+
+        // overflows the half range: +-inf (or NaN):
+        if (x >= 0x47800000u)
+            return sign | (x > 0x7f800000u ? 0x7e00u : 0x7c00u);
+
+        // subnormal half (or zero):
+        if (x < 0x38800000u)
+        {
+            if (x < 0x33000000u) return sign;  // underflows to +-0
+            const uint32_t e = x >> 23;
+            const uint32_t m = (x & 0x7fffffu) | 0x800000u;
+            return sign | static_cast<uint16_t>(m >> (126u - e));
+        }
+
+        // normal half:
+        return sign | static_cast<uint16_t>((x - 0x38000000u) >> 13);
+    }
+
+    static float toFloat(uint16_t h)
+    {
+        const uint32_t sign = (static_cast<uint32_t>(h) & 0x8000u) << 16;
+        int            e    = (h >> 10) & 0x1f;
+        uint32_t       m    = h & 0x3ffu;
+
+        uint32_t x;
+        if (e == 0)
+        {
+            if (m == 0) { x = sign; /* +-0 */ }
+            else
+            {
+                // subnormal half: normalize it as a float:
+                e = 1;
+                while (!(m & 0x400u))
+                {
+                    m <<= 1;
+                    e--;
+                }
+                m &= 0x3ffu;
+                x = sign | (static_cast<uint32_t>(e + 112) << 23) | (m << 13);
+            }
+        }
+        else if (e == 31) { x = sign | 0x7f800000u | (m << 13); /* inf/NaN */ }
+        else { x = sign | (static_cast<uint32_t>(e + 112) << 23) | (m << 13); }
+
+        float f;
+        std::memcpy(&f, &x, sizeof(f));
+        return f;
+    }
+};
+
+namespace internal
+{
+/** Free list recycling the cell buffers of FixedDenseGrid3D: all buffers
+ *  of one template instantiation share a single size class, so blocks
+ *  erased from a dynamic map (e.g. `remove_voxels_farther_than`) are
+ *  recycled into newly created ones and the steady-state create/evict
+ *  cycle stops producing heap traffic. Capped so a transient map growth
+ *  cannot pin memory forever.
+ */
+template <size_t BUFFER_BYTES>
+class CellBufferPool
+{
+   public:
+    static void* allocate()
+    {
+        auto& p = instance();
+        {
+            std::lock_guard<std::mutex> lck(p.mtx_);
+            if (!p.buffers_.empty())
+            {
+                void* b = p.buffers_.back();
+                p.buffers_.pop_back();
+                // recycled buffers must look calloc()-fresh:
+                std::memset(b, 0, BUFFER_BYTES);
+                return b;
+            }
+        }
+        return calloc(1, BUFFER_BYTES);
+    }
+
+    static void release(void* b)
+    {
+        auto& p = instance();
+        {
+            std::lock_guard<std::mutex> lck(p.mtx_);
+            if (p.buffers_.size() < MAX_POOLED_BUFFERS)
+            {
+                p.buffers_.push_back(b);
+                return;
+            }
+        }
+        free(b);
+    }
+
+   private:
+    constexpr static size_t MAX_POOLED_BUFFERS = 256;
+
+    CellBufferPool() = default;
+    ~CellBufferPool()
+    {
+        for (void* b : buffers_) free(b);
+    }
+
+    static CellBufferPool& instance()
+    {
+        static CellBufferPool p;
+        return p;
+    }
+
+    std::mutex         mtx_;
+    std::vector<void*> buffers_;
+};
+}  // namespace internal
+
 /** A dense 3D grid holding cells of type "T" of fixed size
  *  NxNxN cells, with N=2^SIDE_NUM_BITS.
  *
@@ -49,11 +195,13 @@ class FixedDenseGrid3D
     // The use of "calloc()" for super fast allocation needs this:
     static_assert(std::is_trivially_copyable_v<T>);
 
+    using pool_t = internal::CellBufferPool<sizeof(T) * TOTAL_CELL_COUNT>;
+
     FixedDenseGrid3D()
     {
-        cells_ = reinterpret_cast<T*>(calloc(sizeof(T), TOTAL_CELL_COUNT));
+        cells_ = reinterpret_cast<T*>(pool_t::allocate());
     }
-    ~FixedDenseGrid3D() { free(cells_); }
+    ~FixedDenseGrid3D() { pool_t::release(cells_); }
 
     T& cellByIndex(const index3d_t<inner_coord_t>& idx)
     {
@@ -79,8 +227,164 @@ class FixedDenseGrid3D
     const T* cells() const { return cells_; }
     T*       cells() { return cells_; }
 
+    /** Visits the cells of the axis-aligned box [idx0, idx1] (inclusive
+     * bounds), one x-row at a time: `f(rowStart, cells, count)`, with
+     * `cells` pointing at cellByIndex(rowStart) and `count` cells along +x.
+     * x is the fastest-varying index of the layout, so each row is one
+     * contiguous span: callers scan sub-boxes at memory bandwidth, with the
+     * index arithmetic done once per row instead of once per cell. */
+    template <typename ROW_FN>
+    void forEachCellInBox(
+        const index3d_t<inner_coord_t>& idx0,
+        const index3d_t<inner_coord_t>& idx1, ROW_FN&& f)
+    {
+        ASSERTDEB_LE_(idx0.cx, idx1.cx);
+        ASSERTDEB_LE_(idx0.cy, idx1.cy);
+        ASSERTDEB_LE_(idx0.cz, idx1.cz);
+        ASSERTDEB_LT_(idx1.cx, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx1.cy, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx1.cz, CELLS_PER_DIM);
+
+        const size_t count = static_cast<size_t>(idx1.cx - idx0.cx) + 1;
+        for (auto cz = idx0.cz; cz <= idx1.cz; cz++)
+            for (auto cy = idx0.cy; cy <= idx1.cy; cy++)
+            {
+                const index3d_t<inner_coord_t> rowStart{idx0.cx, cy, cz};
+                f(rowStart, &cellByIndex(rowStart), count);
+            }
+    }
+    /// \overload (read-only spans)
+    template <typename ROW_FN>
+    void forEachCellInBox(
+        const index3d_t<inner_coord_t>& idx0,
+        const index3d_t<inner_coord_t>& idx1, ROW_FN&& f) const
+    {
+        ASSERTDEB_LE_(idx0.cx, idx1.cx);
+        ASSERTDEB_LE_(idx0.cy, idx1.cy);
+        ASSERTDEB_LE_(idx0.cz, idx1.cz);
+        ASSERTDEB_LT_(idx1.cx, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx1.cy, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx1.cz, CELLS_PER_DIM);
+
+        const size_t count = static_cast<size_t>(idx1.cx - idx0.cx) + 1;
+        for (auto cz = idx0.cz; cz <= idx1.cz; cz++)
+            for (auto cy = idx0.cy; cy <= idx1.cy; cy++)
+            {
+                const index3d_t<inner_coord_t> rowStart{idx0.cx, cy, cz};
+                f(rowStart, &cellByIndex(rowStart), count);
+            }
+    }
+
+    /** Sets every cell to `value`: a plain std::fill_n over the flat cell
+     * buffer, which vectorizes over the trivially-copyable cells (and
+     * becomes one memset for byte-uniform patterns). */
+    void fill(const T& value) { std::fill_n(cells_, TOTAL_CELL_COUNT, value); }
+
+    /** Sets the cells of the box [idx0, idx1] (inclusive) to `value`,
+     * filling one contiguous row span at a time. */
+    void fillBox(
+        const index3d_t<inner_coord_t>& idx0,
+        const index3d_t<inner_coord_t>& idx1, const T& value)
+    {
+        forEachCellInBox(
+            idx0, idx1,
+            [&value](const index3d_t<inner_coord_t>&, T* row, size_t n)
+            { std::fill_n(row, n, value); });
+    }
+
+    /** Zeroes the whole grid (back to the calloc()-fresh state) at memset
+     * speed. */
+    void clear() { std::memset(cells_, 0, sizeof(T) * TOTAL_CELL_COUNT); }
+
    private:
     T* cells_;
 };
 
+/** Specialization for bit-packed boolean cells: 1 bit per cell, packed in
+ *  64-bit words, so e.g. a 32^3 block takes 4 KiB instead of the 32 KiB
+ *  of `FixedDenseGrid3D<bool>` with one byte per cell. cellByIndex()
+ *  keeps the same call sites working through a proxy reference; being a
+ *  template specialization, the packing is resolved at compile time with
+ *  no runtime branching.
+ */
+template <size_t SIDE_NUM_BITS, typename inner_coord_t>
+class FixedDenseGrid3D<bool, SIDE_NUM_BITS, inner_coord_t>
+{
+   public:
+    constexpr static size_t CELLS_PER_DIM    = 1 << SIDE_NUM_BITS;
+    constexpr static size_t TOTAL_CELL_COUNT = 1 << (3 * SIDE_NUM_BITS);
+    constexpr static size_t WORD_COUNT       = (TOTAL_CELL_COUNT + 63) / 64;
+
+    using pool_t = internal::CellBufferPool<sizeof(uint64_t) * WORD_COUNT>;
+
+    FixedDenseGrid3D()
+    {
+        words_ = reinterpret_cast<uint64_t*>(pool_t::allocate());
+    }
+    ~FixedDenseGrid3D() { pool_t::release(words_); }
+
+    /** Writable stand-in for a `bool&` into the packed bit array */
+    class BitCellProxy
+    {
+       public:
+        BitCellProxy(uint64_t& word, uint64_t mask) : word_(word), mask_(mask)
+        {
+        }
+
+        operator bool() const { return (word_ & mask_) != 0; }
+
+        BitCellProxy& operator=(bool v)
+        {
+            if (v)
+                word_ |= mask_;
+            else
+                word_ &= ~mask_;
+            return *this;
+        }
+
+       private:
+        uint64_t&      word_;
+        const uint64_t mask_;
+    };
+
+    BitCellProxy cellByIndex(const index3d_t<inner_coord_t>& idx)
+    {
+        ASSERTDEB_LT_(idx.cx, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx.cy, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx.cz, CELLS_PER_DIM);
+
+        const size_t bit = idx.cx + (idx.cy << SIDE_NUM_BITS) +
+                           (idx.cz << (2 * SIDE_NUM_BITS));
+        return {words_[bit >> 6], uint64_t(1) << (bit & 63)};
+    }
+    bool cellByIndex(const index3d_t<inner_coord_t>& idx) const
+    {
+        ASSERTDEB_LT_(idx.cx, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx.cy, CELLS_PER_DIM);
+        ASSERTDEB_LT_(idx.cz, CELLS_PER_DIM);
+
+        const size_t bit = idx.cx + (idx.cy << SIDE_NUM_BITS) +
+                           (idx.cz << (2 * SIDE_NUM_BITS));
+        return (words_[bit >> 6] & (uint64_t(1) << (bit & 63))) != 0;
+    }
+
+    /// Raw access to the packed 64-bit words, for bulk operations:
+    const uint64_t* cells() const { return words_; }
+    uint64_t*       cells() { return words_; }
+
+    /** Sets every cell at memset speed over the packed words. Any surplus
+     * bits of the last word are written too, but never read back. */
+    void fill(const bool value)
+    {
+        std::memset(
+            words_, value ? 0xff : 0x00, sizeof(uint64_t) * WORD_COUNT);
+    }
+
+    /** Zeroes the whole grid (back to the calloc()-fresh state). */
+    void clear() { std::memset(words_, 0, sizeof(uint64_t) * WORD_COUNT); }
+
+   private:
+    uint64_t* words_;
+};
+
 }  // namespace mola
@@ -25,6 +25,7 @@
  */
 #pragma once
 
+#include <mola_metric_maps/HugePageAllocator.h>
 #include <mola_metric_maps/index3d_t.h>
 #include <mrpt/core/round.h>
 #include <mrpt/img/TColor.h>
@@ -37,13 +38,25 @@
 #include <tsl/robin_map.h>
 
 #include <array>
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 //#define HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS
 
+// fwrd decls:
+namespace mrpt::opengl
+{
+class CPointCloud;
+class CPointCloudColoured;
+}  // namespace mrpt::opengl
+
 namespace mola
 {
+class FinalizedVoxelPointCloud;
+
 /** HashedVoxelPointCloud: a pointcloud stored as a sparse set of cubic voxels,
  * indexed by a hash map. Efficient for storing point clouds, decimating them,
  *  and running nearest nearest-neighbor search.
@@ -64,6 +77,13 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
     static_assert(
         SSO_MAX_POINTS_PER_VOXEL <= (1 << GLOBAL_ID_SUBVOXEL_BITCOUNT));
 
+    /// The voxel hash map is split into this many independent shards, so
+    /// concurrent insertion threads (see insertPointsConcurrent()) contend
+    /// on per-shard locks only instead of one global lock:
+    constexpr static std::size_t N_VOXEL_MAP_SHARDS_BITS = 4;
+    constexpr static std::size_t N_VOXEL_MAP_SHARDS = 1
+                                                      << N_VOXEL_MAP_SHARDS_BITS;
+
     using global_index3d_t = index3d_t<int32_t>;
 
     /// collapsed plain unique ID for global indices
@@ -130,14 +150,8 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
     /** @name Data structures
      *  @{ */
 
-#if 0
-    using point_vector_t =
-        mrpt::containers::vector_with_small_size_optimization<
-            mrpt::math::TPoint3Df, SSO_MAX_POINTS_PER_VOXEL>;
-#endif
-
-    using point_vector_t =
-        std::array<mrpt::math::TPoint3Df, SSO_MAX_POINTS_PER_VOXEL>;
+    /// One coordinate (x, y, or z) for all the points in a voxel:
+    using coord_array_t = std::array<float, SSO_MAX_POINTS_PER_VOXEL>;
 
     struct VoxelData
     {
@@ -146,44 +160,70 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
 
         struct PointSpan
         {
-            PointSpan(const point_vector_t& points, uint32_t n)
-                : points_(points), n_(n)
+            PointSpan(
+                const coord_array_t& xs, const coord_array_t& ys,
+                const coord_array_t& zs, uint32_t n)
+                : xs_(xs), ys_(ys), zs_(zs), n_(n)
             {
             }
 
             size_t size() const { return n_; }
             bool   empty() const { return n_ == 0; }
 
-            const mrpt::math::TPoint3Df& operator[](int i) const
+            mrpt::math::TPoint3Df operator[](int i) const
             {
-                return points_[i];
+                return {xs_[i], ys_[i], zs_[i]};
             }
 
+            /// Raw access to the structure-of-arrays coordinate buffers,
+            /// 32-byte aligned, for vectorized distance kernels:
+            const float* xs() const { return xs_.data(); }
+            const float* ys() const { return ys_.data(); }
+            const float* zs() const { return zs_.data(); }
+
            private:
-            const point_vector_t& points_;
-            const uint32_t        n_;
+            const coord_array_t& xs_;
+            const coord_array_t& ys_;
+            const coord_array_t& zs_;
+            const uint32_t       n_;
         };
 
         auto points() const -> PointSpan
         {
-            return PointSpan(points_, nPoints_);
+            return PointSpan(xs_, ys_, zs_, nPoints_);
         }
 
         void insertPoint(const mrpt::math::TPoint3Df& p)
         {
-            if (nPoints_ < SSO_MAX_POINTS_PER_VOXEL) points_[nPoints_++] = p;
+            if (nPoints_ >= SSO_MAX_POINTS_PER_VOXEL) return;
+            xs_[nPoints_] = p.x;
+            ys_[nPoints_] = p.y;
+            zs_[nPoints_] = p.z;
+            nPoints_++;
         }
 
         // for serialization, do not use in normal use:
         size_t size() const { return nPoints_; }
 
        private:
-        point_vector_t points_;
-        uint32_t       nPoints_ = 0;
+        // Structure-of-arrays storage, so distance evaluations against all
+        // the points in a voxel can use full-width SIMD lanes. 32-byte
+        // alignment allows aligned AVX loads:
+        alignas(32) coord_array_t xs_;
+        alignas(32) coord_array_t ys_;
+        alignas(32) coord_array_t zs_;
+        uint32_t nPoints_ = 0;
     };
 
-    using grids_map_t =
-        tsl::robin_map<global_index3d_t, VoxelData, index3d_hash<int32_t>>;
+    /** Sharded voxel storage. The robin-hood bucket array is a single flat
+     * allocation holding the VoxelData blocks inline, so for large maps it
+     * is backed by 2 MB hugepages (see HugePageAllocator) to cut TLB misses
+     * during the random-access probes of NN queries; small maps fall back
+     * to the regular heap automatically. */
+    using grids_map_t = tsl::robin_map<
+        global_index3d_t, VoxelData, index3d_hash<int32_t>,
+        std::equal_to<global_index3d_t>,
+        HugePageAllocator<std::pair<global_index3d_t, VoxelData>>>;
 
     /** @} */
 
@@ -198,6 +238,12 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
      * Function defined in the header file so compilers can optimize
      * for literals "createIfNew"
      */
+    /// Shard holding a given voxel index (see N_VOXEL_MAP_SHARDS):
+    static inline std::size_t shardOf(const global_index3d_t& idx)
+    {
+        return index3d_hash<int32_t>()(idx) & (N_VOXEL_MAP_SHARDS - 1);
+    }
+
     inline VoxelData* voxelByGlobalIdxs(
         const global_index3d_t& idx, bool createIfNew)
     {
@@ -205,35 +251,50 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
         VoxelData* voxel = nullptr;
 
 #if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
-        for (int i = 0; i < CachedData::NUM_CACHED_IDXS; i++)
+        const int set = CachedData::cacheSetOf(idx);
+        for (int w = 0; w < CachedData::CACHE_WAYS; w++)
         {
-            if (cached_.lastAccessVoxel[i] && cached_.lastAccessIdx[i] == idx)
+            if (cached_.lastAccessVoxel[set][w] &&
+                cached_.lastAccessIdx[set][w] == idx)
             {
                 // Cache hit:
 #ifdef USE_DEBUG_PROFILER
                 mrpt::system::CTimeLoggerEntry tle(
                     profiler, "insertPoint.cache_hit");
 #endif
-                voxel = cached_.lastAccessVoxel[i];
+                cached_.cacheHits++;
+                voxel = cached_.lastAccessVoxel[set][w];
                 break;
             }
         }
 
         if (!voxel)
         {
+            cached_.cacheMisses++;
 #endif
 #ifdef USE_DEBUG_PROFILER
             mrpt::system::CTimeLoggerEntry tle(
                 profiler, "insertPoint.cache_misss");
 #endif
 
-            auto it = voxels_.find(idx);
-            if (it == voxels_.end())
+            auto& shard = voxels_[shardOf(idx)];
+
+            auto it = shard.find(idx);
+            if (it == shard.end())
             {
                 if (!createIfNew)
                     return nullptr;
-                else
-                    voxel = &voxels_[idx];  // Create it
+
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+                // Creating a voxel may rehash the shard, which moves its
+                // entries and invalidates any cached pointers into it:
+                const auto bucketsBefore = shard.bucket_count();
+#endif
+                voxel = &shard[idx];  // Create it
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+                if (shard.bucket_count() != bucketsBefore)
+                    cached_.resetLookupCache();
+#endif
             }
             else
             {
@@ -241,11 +302,12 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
                 voxel = &it.value();
             }
 #if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
-            // Add to cache:
-            cached_.lastAccessIdx[cached_.lastAccessNextWrite]   = idx;
-            cached_.lastAccessVoxel[cached_.lastAccessNextWrite] = voxel;
-            cached_.lastAccessNextWrite++;
-            cached_.lastAccessNextWrite &= CachedData::NUM_CACHED_IDX_MASK;
+            // Add to cache, round-robin within the set:
+            const auto w             = cached_.lastAccessNextWay[set];
+            cached_.lastAccessNextWay[set] =
+                (w + 1) & (CachedData::CACHE_WAYS - 1);
+            cached_.lastAccessIdx[set][w]   = idx;
+            cached_.lastAccessVoxel[set][w] = voxel;
         }
 #endif
         return voxel;
@@ -277,7 +339,31 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
     /** Insert one point into the dual voxel map */
     void insertPoint(const mrpt::math::TPoint3Df& pt);
 
-    const grids_map_t& voxels() const { return voxels_; }
+    /** Batched version of insertPoint(): converts coordinates to voxel
+     * indices for the whole batch (AVX2-vectorized where available), then
+     * sorts the batch by voxel so the hash map is probed once per run of
+     * points falling in the same voxel, and updates the cached bounding box
+     * with vectorized min/max. Points are inserted in the given order within
+     * each voxel, so per-voxel insertion options behave as with N calls to
+     * insertPoint(). */
+    void insertPoints(const mrpt::math::TPoint3Df* pts, std::size_t num);
+
+    /** Thread-safe variant of insertPoints(): may be called from several
+     * decoding threads at once on the same live map. Points are grouped by
+     * shard, and each shard is protected by its own short-lived mutex, so
+     * threads only contend when their batches land in the same shard.
+     * Readers (NN searches, visitors, etc.) must NOT run concurrently with
+     * insertions. The cached bounding box is grown with the whole batch
+     * even if per-point insertion options reject some points (same
+     * over-approximation insertPoint() makes when a voxel is full). */
+    void insertPointsConcurrent(
+        const mrpt::math::TPoint3Df* pts, std::size_t num);
+
+    /// Access to one shard of the voxel map (shard < N_VOXEL_MAP_SHARDS):
+    const grids_map_t& voxels(const std::size_t shard) const
+    {
+        return voxels_[shard];
+    }
 
     /** Computes the bounding box of all the points, or (0,0 ,0,0, 0,0) if
      * there are no points. Results are cached unless the map is somehow
@@ -285,6 +371,30 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
      */
     mrpt::math::TBoundingBoxf boundingBox() const override;
 
+    /** Version counter of the cached bounding box: it only changes when the
+     * box may have SHRUNK (voxel pruning, clear(), deserialization), never
+     * on the monotonic growth caused by insertions. A reader holding a copy
+     * of boundingBox() can thus keep using it, lock-free, until this value
+     * differs from the one observed at copy time. */
+    uint32_t boundingBoxVersion() const
+    {
+        return cached_.bboxVersion.load(std::memory_order_relaxed);
+    }
+
+    /** Cumulative hit/miss counters of the internal set-associative voxel
+     * lookup cache, for monitoring its effectiveness in production runs.
+     * Both remain at zero unless the library was built with
+     * HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS. */
+    void voxelCacheStats(uint64_t& hits, uint64_t& misses) const
+    {
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+        hits   = cached_.cacheHits;
+        misses = cached_.cacheMisses;
+#else
+        hits = misses = 0;
+#endif
+    }
+
     void visitAllPoints(
         const std::function<void(const mrpt::math::TPoint3Df&)>& f) const;
 
@@ -292,11 +402,78 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
         const std::function<void(const global_index3d_t&, const VoxelData&)>& f)
         const;
 
+    /** Parallel variant of visitAllPoints(): the voxels are partitioned
+     * across `numThreads` workers (0 = hardware concurrency) that keep
+     * stealing fixed-size chunks of voxels from a shared cursor, so uneven
+     * voxel occupancies self-balance. `f` runs concurrently and receives the
+     * worker index in [0, numThreads) as its second argument: use it to
+     * index per-worker accumulators, then reduce them once this returns.
+     * For read-only visitors only: the map must not be modified while
+     * visiting, and `f` must not throw. */
+    void visitAllPointsParallel(
+        const std::function<
+            void(const mrpt::math::TPoint3Df&, unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
+    /** Parallel variant of visitAllVoxels(); same threading contract as
+     * visitAllPointsParallel(). */
+    void visitAllVoxelsParallel(
+        const std::function<void(
+            const global_index3d_t&, const VoxelData&,
+            unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
     /** Save to a text file. Each line contains "X Y Z" point coordinates.
      *  Returns false if any error occured, true elsewere.
      */
     bool saveToTextFile(const std::string& file) const;
 
+    /** One voxel of the flat export produced by exportFlat(): its collapsed
+     *  64-bit index (see g2plain()) and the range of points belonging to it
+     *  within the XYZ array. */
+    struct FlatVoxelEntry
+    {
+        uint64_t voxelID    = 0;
+        uint32_t firstPoint = 0;  //!< index into the XYZ array
+        uint32_t numPoints  = 0;
+    };
+
+    /** Exports all map points into one contiguous buffer in a single pass,
+     * so host<->device (or IPC) transfers become one memcpy-class
+     * operation: TPoint3Df is three packed floats, hence `xyz.data()` is a
+     * plain interleaved `float[3*N]` array. Points are grouped by voxel;
+     * if voxelInfo is not nullptr, one entry per voxel is emitted
+     * describing each group. */
+    void exportFlat(
+        std::vector<mrpt::math::TPoint3Df>& xyz,
+        std::vector<FlatVoxelEntry>*        voxelInfo = nullptr) const;
+
+    /** Inverse of exportFlat(): clears the map and bulk-inserts the given
+     * contiguous point array, bypassing the per-point insertion filters
+     * (max_points_per_voxel, min_distance_between_points) so an
+     * exportFlat()/importFlat() round trip reproduces the map exactly. */
+    void importFlat(const mrpt::math::TPoint3Df* xyz, std::size_t num);
+
+    /** Erases, at whole-voxel granularity, the map contents within the given
+     * axis-aligned box: every voxel whose global index falls inside the
+     * inclusive index range spanned by the box corners is dropped as a unit,
+     * without visiting its points, so the cost is O(voxels in the map)
+     * instead of O(points). Intended for map maintenance, e.g. clearing the
+     * region once occupied by a dynamic object.
+     * Returns the number of erased voxels. \sa cropToBox() */
+    std::size_t eraseBox(const mrpt::math::TBoundingBoxf& box);
+
+    /** Complement of eraseBox(): drops every voxel whose global index falls
+     * OUTSIDE the index range spanned by the box corners, keeping only the
+     * box contents. Returns the number of erased voxels. */
+    std::size_t cropToBox(const mrpt::math::TBoundingBoxf& box);
+
+    /** Produces the immutable, compacted form of this map for
+     * localization-only missions: flat Morton-sorted arrays, lock-free
+     * binary-searched NN queries, and a mmap-able on-disk blob. This map
+     * is left untouched; see FinalizedVoxelPointCloud. */
+    FinalizedVoxelPointCloud finalize() const;
+
     /** @} */
 
     /** @name API of the NearestNeighborsCapable virtual interface
@@ -339,6 +516,56 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
         std::vector<float>&                 out_dists_sqr,
         std::vector<uint64_t>&              resultIndicesOrIDs) const;
 
+    /** Batched version of nn_multiple_search(): answers one KNN query per
+     * entry of `queries`, partitioning the batch across worker threads
+     * (numberOfThreads=0 means hardware concurrency; small batches fall
+     * back to serial execution). Output vectors are resized to numQueries,
+     * with the i-th entry holding the matches of queries[i]. */
+    void nn_multiple_search_batch(
+        const mrpt::math::TPoint3Df* queries, size_t numQueries,
+        const size_t                                     N,
+        std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+        std::vector<std::vector<float>>&                 out_dists_sqr,
+        std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+        unsigned int numberOfThreads = 0) const;
+
+    /** Reusable query context for iterative nn_single_search() callers
+     * (e.g. ICP, which asks for the NN of the same source point once per
+     * iteration with a barely-moved query): caches, per source-point
+     * index, the voxel matched in the previous iteration. See
+     * nn_single_search_with_context(). Grown on demand; clear() it when
+     * the source point cloud changes. */
+    struct NNSearchContext
+    {
+        /** Acceptance threshold [m²] for the cached-voxel fast path: a
+         * candidate from the cached voxel closer than this is returned
+         * without the full neighborhood search. Callers typically set it
+         * to their squared correspondence-rejection distance; with the
+         * default 0 the context is pass-through (always full search). */
+        float accept_dist_sqr = .0f;
+
+        void clear()
+        {
+            cached_voxel.clear();
+            valid.clear();
+        }
+
+        std::vector<global_index3d_t> cached_voxel;
+        std::vector<uint8_t>          valid;
+    };
+
+    /** Like the single-point nn_single_search(), exploiting motion
+     * coherence across calls: if the voxel that matched `queryIndex` in a
+     * previous call still exists and holds a point within
+     * `ctx.accept_dist_sqr` of the query, that candidate is returned
+     * directly (exact within that voxel; the true NN might rarely lie in
+     * a neighboring one); otherwise the regular full search of the 3x3x3
+     * voxel neighborhood runs and the cache entry is refreshed. */
+    [[nodiscard]] bool nn_single_search_with_context(
+        const mrpt::math::TPoint3Df& query, const size_t queryIndex,
+        NNSearchContext& ctx, mrpt::math::TPoint3Df& result,
+        float& out_dist_sqr, uint64_t& resultIndexOrID) const;
+
     /** @} */
 
     /** @name Public virtual methods implementation for CMetricMap
@@ -392,6 +619,14 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
         /** If !=0 skip the insertion of points that are closer than this
          * distance to any other already in the voxel. */
         float min_distance_between_points = .0f;
+
+        /** Number of voxel map shards swept for far-voxel eviction per
+         * insertObservation() call (see remove_voxels_farther_than).
+         * With N_VOXEL_MAP_SHARDS=16 and the default of 2, a full
+         * eviction pass completes every 8 insertions, bounding the
+         * per-insertion latency to 1/8 of a whole-map sweep. 0 means
+         * sweep the whole map at once (the old behavior). */
+        uint32_t eviction_shards_per_insertion = 2;
     };
     TInsertionOptions insertionOptions;
 
@@ -475,26 +710,89 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
     float                 voxel_size_sqr_ = voxel_size_ * voxel_size_;
     mrpt::math::TPoint3Df voxelDiagonal_;
 
-    /** Voxel map as a set of fixed-size grids */
-    grids_map_t voxels_;
+    /** Voxel map as a set of fixed-size grids, sharded by voxel index hash
+     * (see shardOf()) so concurrent insertions take per-shard locks only */
+    std::array<grids_map_t, N_VOXEL_MAP_SHARDS> voxels_;
+
+    /** One lock per shard, taken by insertPointsConcurrent() only: the
+     * single-writer paths stay lock-free */
+    std::array<std::mutex, N_VOXEL_MAP_SHARDS> shard_mtxs_;
+
+    /** Protects cached_.boundingBox_ merges in insertPointsConcurrent() */
+    std::mutex bbox_mtx_;
+
+    /** Rotating cursor of the incremental far-voxel eviction: the next
+     * shard to sweep (see eviction_shards_per_insertion) */
+    std::size_t evictionNextShard_ = 0;
 
     struct CachedData
     {
         CachedData() = default;
 
-        void reset() { *this = CachedData(); }
+        void reset()
+        {
+            boundingBox_.reset();
+            erasedVoxelsSinceBBox = 0;
+            bboxVersion.fetch_add(1, std::memory_order_relaxed);
+            for (auto& c : shardMutations)
+                c.fetch_add(1, std::memory_order_relaxed);
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+            resetLookupCache();
+#endif
+        }
+
+        /// Per-shard mutation counters: bumped by every accepted insertion
+        /// or voxel erase touching the shard (and all of them on clear()
+        /// or deserialization). Consumed by the renderable snapshot cache
+        /// of getVisualizationInto() to skip rebuilding unchanged shards.
+        std::array<std::atomic<uint64_t>, N_VOXEL_MAP_SHARDS> shardMutations{};
 
         mutable std::optional<mrpt::math::TBoundingBoxf> boundingBox_;
 
+        /// Voxels erased since the last full bbox recompute. A full
+        /// recompute is triggered (lazily) only once this becomes a
+        /// significant fraction of the map; until then the cached bbox is
+        /// kept as a slightly over-sized but valid approximation:
+        mutable uint64_t erasedVoxelsSinceBBox = 0;
+
+        /// Fraction of erased voxels that triggers a full bbox recompute:
+        constexpr static double BBOX_RECOMPUTE_FRACTION = 0.10;
+
+        /// Incremented whenever the cached bounding box may SHRINK (voxel
+        /// pruning past the threshold above, clear(), deserialization).
+        /// Monotonic growth from insertions does not bump it: an older,
+        /// smaller box is still a valid approximation, so lock-free readers
+        /// may keep a stale snapshot until this version changes.
+        std::atomic<uint32_t> bboxVersion{0};
+
 #if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
-        // 2 bits seems to be the optimum for typical cases:
-        constexpr static int CBITS               = 2;
-        constexpr static int NUM_CACHED_IDXS     = 1 << CBITS;
-        constexpr static int NUM_CACHED_IDX_MASK = NUM_CACHED_IDXS - 1;
-
-        int              lastAccessNextWrite = 0;
-        global_index3d_t lastAccessIdx[NUM_CACHED_IDXS];
-        VoxelData*       lastAccessVoxel[NUM_CACHED_IDXS] = {nullptr};
+        // 16-entry, 2-way set-associative voxel lookup cache. The set is
+        // picked from the lowest bit of each voxel coordinate, so the
+        // neighboring voxels a scan keeps alternating between land in
+        // different sets instead of evicting each other:
+        constexpr static int NUM_CACHE_SETS = 8;
+        constexpr static int CACHE_WAYS     = 2;
+
+        static int cacheSetOf(const global_index3d_t& idx)
+        {
+            return (idx.cx & 1) | ((idx.cy & 1) << 1) | ((idx.cz & 1) << 2);
+        }
+
+        uint8_t          lastAccessNextWay[NUM_CACHE_SETS]           = {0};
+        global_index3d_t lastAccessIdx[NUM_CACHE_SETS][CACHE_WAYS];
+        VoxelData*       lastAccessVoxel[NUM_CACHE_SETS][CACHE_WAYS] = {};
+
+        /// Cumulative counters, see voxelCacheStats():
+        mutable uint64_t cacheHits = 0, cacheMisses = 0;
+
+        /// Drops all cached pointers (the counters are kept): must be
+        /// called whenever voxels may have been erased or moved.
+        void resetLookupCache()
+        {
+            for (auto& w : lastAccessNextWay) w = 0;
+            for (auto& set : lastAccessVoxel)
+                for (auto& entry : set) entry = nullptr;
+        }
 #endif
     };
 
@@ -526,12 +824,132 @@ class HashedVoxelPointCloud : public mrpt::maps::CMetricMap,
         const mrpt::poses::CPose3D& pc_in_map, const float* xs, const float* ys,
         const float* zs, const std::size_t num_pts);
 
+    /** Shared implementation of eraseBox() / cropToBox(): erases every voxel
+     * whose global index lies inside (eraseInside=true) or outside
+     * (eraseInside=false) the inclusive index range [idx0, idx1]. */
+    std::size_t internal_eraseIndexRange(
+        const global_index3d_t& idx0, const global_index3d_t& idx1,
+        bool eraseInside);
+
     // See docs in base class
     bool internal_canComputeObservationLikelihood(
         const mrpt::obs::CObservation& obs) const override;
 
+    /** Per-voxel insertion checks and bbox update shared by insertPoint()
+     *  and insertPoints(). With updateBBox=false, the caller is responsible
+     *  for the bounding box (batch path). Returns false if the point was
+     *  rejected by the insertion options. */
+    bool internal_insertPointIntoVoxel(
+        VoxelData& v, const mrpt::math::TPoint3Df& pt, bool updateBBox);
+
     /// Used for getAsSimplePointsMap only.
     mutable mrpt::maps::CSimplePointsMap::Ptr cachedPoints_;
+
+    /** Renderable snapshot cache of getVisualizationInto(): per-shard
+     * sub-objects (single-color mode) or one whole-map object (colormap
+     * mode, whose recolorization normalizes over all points), handed out
+     * again as long as the shard mutation counters did not move. Any
+     * renderOptions change drops all cached objects. */
+    struct VizCache
+    {
+        /// renderOptions snapshot the cached objects were built with:
+        std::optional<TRenderOptions> builtOptions;
+
+        std::array<
+            std::shared_ptr<mrpt::opengl::CPointCloud>, N_VOXEL_MAP_SHARDS>
+                                                 shardObjs;
+        std::array<uint64_t, N_VOXEL_MAP_SHARDS> shardBuiltAt{};
+
+        std::shared_ptr<mrpt::opengl::CPointCloudColoured> wholeObj;
+        uint64_t                                           wholeBuiltAt = 0;
+    };
+    mutable VizCache   vizCache_;
+    mutable std::mutex vizCacheMtx_;
+};
+
+/** HashedVoxelPointCloudSubmapView: a lightweight, non-owning view of a
+ * HashedVoxelPointCloud restricted to a bounding box ("the map within X
+ * meters of the robot"), for feeding local submaps to scan matchers
+ * without copying any point out of the parent map.
+ *
+ * Construction only converts the box corners into a voxel index range, so
+ * a view is created in microseconds; the nn_* searches then run directly
+ * over the parent's voxel storage, with the searched voxel neighborhood
+ * clamped to that index range.
+ *
+ * Filtering is per whole voxel: points of a boundary voxel lying slightly
+ * outside the box are still visible through the view.
+ *
+ * The view keeps a plain reference to the parent map: the parent must
+ * outlive the view, and must not be modified while the view is queried
+ * (the same reader contract of the parent's own nn_* methods).
+ */
+class HashedVoxelPointCloudSubmapView
+    : public mrpt::maps::NearestNeighborsCapable
+{
+   public:
+    using global_index3d_t = HashedVoxelPointCloud::global_index3d_t;
+
+    HashedVoxelPointCloudSubmapView(
+        const HashedVoxelPointCloud&     parent,
+        const mrpt::math::TBoundingBoxf& box)
+        : parent_(parent),
+          idxMin_(parent.coordToGlobalIdx(box.min)),
+          idxMax_(parent.coordToGlobalIdx(box.max))
+    {
+    }
+
+    const HashedVoxelPointCloud& parent() const { return parent_; }
+
+    /// Voxel index range covered by the view, both ends inclusive:
+    const global_index3d_t& voxelIdxMin() const { return idxMin_; }
+    const global_index3d_t& voxelIdxMax() const { return idxMax_; }
+
+    /** @name API of the NearestNeighborsCapable virtual interface
+    @{ */
+    [[nodiscard]] bool   nn_has_indices_or_ids() const override;
+    [[nodiscard]] size_t nn_index_count() const override;
+    [[nodiscard]] bool   nn_single_search(
+          const mrpt::math::TPoint3Df& query, mrpt::math::TPoint3Df& result,
+          float& out_dist_sqr, uint64_t& resultIndexOrID) const override;
+    [[nodiscard]] bool nn_single_search(
+        const mrpt::math::TPoint2Df& query, mrpt::math::TPoint2Df& result,
+        float& out_dist_sqr, uint64_t& resultIndexOrID) const override;
+    void nn_multiple_search(
+        const mrpt::math::TPoint3Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const override;
+    void nn_multiple_search(
+        const mrpt::math::TPoint2Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint2Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const override;
+    void nn_radius_search(
+        const mrpt::math::TPoint3Df& query, const float search_radius_sqr,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs,
+        size_t                              maxPoints) const override;
+    void nn_radius_search(
+        const mrpt::math::TPoint2Df& query, const float search_radius_sqr,
+        std::vector<mrpt::math::TPoint2Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs,
+        size_t                              maxPoints) const override;
+
+    template <size_t MAX_KNN>
+    void nn_multiple_search_impl(
+        const mrpt::math::TPoint3Df& query, const size_t N,
+        std::vector<mrpt::math::TPoint3Df>& results,
+        std::vector<float>&                 out_dists_sqr,
+        std::vector<uint64_t>&              resultIndicesOrIDs) const;
+
+    /** @} */
+
+   private:
+    const HashedVoxelPointCloud& parent_;
+    const global_index3d_t       idxMin_, idxMax_;
 };
 
 }  // namespace mola
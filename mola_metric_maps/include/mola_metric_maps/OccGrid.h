@@ -19,23 +19,34 @@
  * ------------------------------------------------------------------------- */
 /**
  * @file   OccGrid.h
- * @brief  Class extending MRPT occupancy grid with additional functionalities
+ * @brief  Tiled occupancy grid with super-resolution likelihood field
  * @author Jose Luis Blanco Claraco
  * @date   Feb 21, 2021
  */
 #pragma once
 
+#include <mola_metric_maps/index3d_t.h>
 #include <mrpt/containers/CDynamicGrid.h>
-#include <mrpt/maps/COccupancyGridMap2D.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/math/TPoint2D.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/serialization/CSerializable.h>
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
 namespace mola
 {
 /**
- * @brief Extends MRPT's occupancy grid with super-resolution likelihood field.
+ * @brief Occupancy grid stored as fixed-size dense tiles in a hash map, with
+ * a per-tile super-resolution likelihood field cache.
  *
+ * Growing the map only inserts new tiles into the hash map, so crossing the
+ * current map boundary during exploration never triggers the full-grid
+ * reallocation and copy of a monolithic occupancy grid.
  */
 class OccGrid : public mrpt::serialization::CSerializable
 {
@@ -45,10 +56,43 @@ class OccGrid : public mrpt::serialization::CSerializable
     OccGrid();
     ~OccGrid() = default;
 
+    /** Copies everything but the background prewarm worker (see
+     * prewarmLikelihoodCacheAsync()), which belongs to its own instance. */
+    OccGrid(const OccGrid& o);
+    OccGrid& operator=(const OccGrid& o);
+    OccGrid(OccGrid&& o)            = default;
+    OccGrid& operator=(OccGrid&& o) = default;
+
+    /** @name Compile-time parameters and types
+     * @{ */
+
+    /** Cells per tile side: each tile spans TILE_CELLS*resolution() meters */
+    constexpr static uint32_t TILE_CELLS = 64;
+
+    /** Discrete tile index in the sparse tile hash map (cz is always 0) */
+    using tile_index_t = index3d_t<int32_t>;
+
+    /** For use in the per-tile likelihood cache grids */
+    static constexpr float CACHE_MISS_VALUE = std::numeric_limits<float>::min();
+
+    /** One fixed-size dense tile: occupancy log-odds (row-major,
+     * TILE_CELLS*TILE_CELLS entries; positive means free, following the MRPT
+     * convention that occupancy values near 1 are free), plus the tile's
+     * likelihood cache at super resolution (sized lazily upon the first
+     * likelihood evaluation touching the tile). */
+    struct Tile
+    {
+        std::vector<float>                    logodds;
+        mrpt::containers::CDynamicGrid<float> likCache;
+    };
+
+    /** @} */
+
     /** @name Grid size API
      * @{ */
 
-    /** Change the size of gridmap, erasing all its previous contents.
+    /** Reset the grid, erasing all previous contents, and allocate the tiles
+     * covering the given box.
      * \param minCorner The (x,y) coordinates of left-bottom grid corner.
      * \param maxCorner The (x,y) coordinates of right-top grid corner.
      * \param resolution The new size of square cells [meters]
@@ -59,7 +103,9 @@ class OccGrid : public mrpt::serialization::CSerializable
         const mrpt::math::TPoint2Df& maxCorner, float resolution,
         float occupancyValue = 0.5f);
 
-    /** Change the size of gridmap, maintaining previous contents.
+    /** Ensure the tiles covering the given box exist, maintaining all
+     * previous contents. Only the missing tiles are allocated: existing
+     * cells are never copied nor moved.
      * \param minCorner The (x,y) coordinates of left-bottom grid corner.
      * \param maxCorner The (x,y) coordinates of right-top grid corner.
      * \param newCellsOccupancyValue Occupancy of new cells, tipically 0.5.
@@ -103,18 +149,44 @@ class OccGrid : public mrpt::serialization::CSerializable
          * range values!) */
         uint16_t decimation{1};
 
-        /** Enabled: Rays widen with distance to approximate the real behavior
-         * of lasers, disabled: insert rays as simple lines (Default=false) */
-        bool wideningBeamsWithDistance{false};
+        /** Number of worker threads tracing the scan beams (default=1:
+         * the classic sequential path; 0 = hardware concurrency). With
+         * N>1, beams are partitioned across threads that write their
+         * log-odds updates into per-thread tile-local staging buffers,
+         * merged afterwards with one saturating add per cell (vectorized
+         * under AVX2). The merge runs in fixed thread order, so the
+         * resulting grid is deterministic across runs. */
+        uint16_t insertion_threads{1};
     };
 
     InsertionParameters insertionParameters_;
 
+    /** Updates the grid with a 2D scan: free-space updates along each beam
+     * and an occupied update at valid beam end points. Sequential per beam
+     * by default; see InsertionParameters::insertion_threads for the
+     * parallel staged mode. The only observable difference of the staged
+     * mode is that the ±log-odds clamp is applied once per merged batch
+     * instead of per individual cell update, which can only matter when a
+     * single scan alone saturates a cell. */
     void insertObservation(
         const mrpt::obs::CObservation2DRangeScan& obs,
         const mrpt::math::TPose2D&                robotPose);
 
-    const mrpt::maps::COccupancyGridMap2D& grid() const { return grid_; }
+    float resolution() const { return resolution_; }
+
+    std::size_t tileCount() const { return tiles_.size(); }
+
+    /** Occupancy at a world position, following the MRPT convention:
+     * 0=occupied, 1=free, 0.5=unknown (also for positions outside of any
+     * allocated tile). */
+    float occupancyAtPos(float x, float y) const;
+
+    /** Visits all allocated tiles, one call per tile. `tileMinCorner` is the
+     * world coordinate of the corner of the tile's (0,0) cell. */
+    void visitAllTiles(
+        const std::function<void(
+            const tile_index_t& idx, const mrpt::math::TPoint2Df& tileMinCorner,
+            const Tile& tile)>& visitor) const;
 
     /** @} */
 
@@ -125,28 +197,120 @@ class OccGrid : public mrpt::serialization::CSerializable
         LikelihoodParameters() = default;
 
         double superResolutionFactor = 4;
+
+        /** Gaussian std. deviation of the sensor noise, for the
+         * likelihood-field model [meters] */
+        float sigmaHit = 0.20f;
+
+        /** Search radius around each beam end point for the closest
+         * occupied cell [meters] */
+        float maxCorrDistance = 1.0f;
+
+        /** Cells with occupancy below this value are considered occupied
+         * (MRPT convention: 0=occupied, 1=free) */
+        float occupiedThreshold = 0.35f;
+
+        /** Evaluate one out of this number of scan rays (default=1: all) */
+        uint16_t decimation = 1;
     };
 
     LikelihoodParameters likelihoodParameters_;
 
+    /** Evaluates the log-likelihood of a whole 2D scan observed from the
+     * given robot pose, as one batch: all beam end points are projected at
+     * once, then looked up in the super-resolution likelihood cache of their
+     * tile (consecutive beams hit nearby cells, and the next cell is
+     * prefetched while the current one is scored). Cache misses are filled
+     * in-place with the likelihood-field model, so repeated evaluations
+     * around the same area (e.g. particle filters) quickly become pure table
+     * lookups.
+     */
+    double likelihoodOf(
+        const mrpt::obs::CObservation2DRangeScan& obs,
+        const mrpt::math::TPose2D&                robotPose);
+
     /** Invalidates all cached likelihood values (normally users do not need to
      * call this) */
     void resetLikelihoodCache();
 
-    /** For use in likelihoodCacheGrid_ */
-    static constexpr float CACHE_MISS_VALUE = std::numeric_limits<float>::min();
+    /** Invalidates the cached likelihood values within the given axis-aligned
+     * region only [meters], leaving the still-valid cells elsewhere untouched.
+     * The region is automatically grown by maxCorrDistance, since the cached
+     * value of a cell depends on occupied cells up to that far away.
+     * Called by insertObservation() for the area affected by each update. */
+    void resetLikelihoodCache(
+        const mrpt::math::TPoint2Df& minCorner,
+        const mrpt::math::TPoint2Df& maxCorner);
+
+    /** Fills the likelihood cache of all allocated tiles overlapping the
+     * given axis-aligned region [meters] for the still-uncached cells, so a
+     * later likelihoodOf() over that area runs as pure table lookups instead
+     * of paying the cold-cache penalty in a burst. Call it around the
+     * predicted robot pose between filter updates, or use the Async variant
+     * to run it on a background thread. */
+    void prewarmLikelihoodCache(
+        const mrpt::math::TPoint2Df& minCorner,
+        const mrpt::math::TPoint2Df& maxCorner);
+
+    /** Enqueues prewarmLikelihoodCache() on a background worker thread and
+     * returns immediately. Running it concurrently with likelihoodOf() is
+     * fine (cache cells are filled with idempotent aligned stores), but NOT
+     * with insertObservation(), setSize() or resizeGrid(), which modify the
+     * tile hash map itself: schedule it only between map updates. */
+    void prewarmLikelihoodCacheAsync(
+        const mrpt::math::TPoint2Df& minCorner,
+        const mrpt::math::TPoint2Df& maxCorner);
 
     /** @} */
 
    private:
-    mrpt::maps::COccupancyGridMap2D grid_;
+    /** Clamp for accumulated per-cell log-odds */
+    constexpr static float LOGODDS_MAX = 8.0f;
+
+    /** World coordinate -> discrete global (whole-map) cell coordinate */
+    int32_t coordToCell(float v) const;
+
+    /** Floor division of a global cell coordinate into its tile index */
+    static int32_t cellToTile(int32_t g) noexcept;
 
-    /** This grid has a higher resolution than grid_ and holds cached likelihood
-     * log-likelihood values for it.
-     *
-     * Cells without cached values hold the invalid value CACHE_MISS_VALUE.
+    /** Offset of a global cell coordinate within its tile, in [0,TILE_CELLS)
      */
-    mrpt::containers::CDynamicGrid<float> likelihoodCacheGrid_;
+    static uint32_t cellWithinTile(int32_t g) noexcept;
+
+    /** The tile holding the given global cell, or nullptr if not allocated */
+    const Tile* tileOfCell(int32_t gx, int32_t gy) const;
+
+    /** Adds `logoddsInc` to the given cell, allocating its tile if needed */
+    void updateCell(int32_t gx, int32_t gy, float logoddsInc);
+
+    /** Applies the free-cells update along the ray between two global cells,
+     * excluding the end point cell itself */
+    void markFreeRay(
+        int32_t gx0, int32_t gy0, int32_t gx1, int32_t gy1, float lFree);
+
+    /** Allocates (only) the missing tiles covering the given box, with their
+     * cells at `occupancyValue` */
+    void ensureTilesCover(
+        const mrpt::math::TPoint2Df& minCorner,
+        const mrpt::math::TPoint2Df& maxCorner, float occupancyValue);
+
+    /** Sizes (empty) per-tile likelihood caches to the tile extent at the
+     * current superResolutionFactor */
+    void ensureLikCache(const tile_index_t& idx, Tile& t) const;
+
+    /** Likelihood-field score of one beam end point (map coordinates),
+     * evaluated against the occupancy tiles. Used to fill cache misses. */
+    float computeMissLikelihood(float x, float y) const;
+
+    float resolution_ = 0.10f;
+
+    /** All allocated tiles; absent tiles are implicitly unknown space */
+    std::unordered_map<tile_index_t, Tile, index3d_hash<int32_t>> tiles_;
+
+    /** Worker behind prewarmLikelihoodCacheAsync(), created on first use.
+     * Declared last so its destructor joins any in-flight prewarm task
+     * before the tiles it reads are destroyed. */
+    std::unique_ptr<mrpt::WorkerThreadsPool> prewarmPool_;
 };
 
 }  // namespace mola
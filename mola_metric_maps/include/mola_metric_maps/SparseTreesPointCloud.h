@@ -41,6 +41,7 @@
 #include <map>
 #include <optional>
 #include <shared_mutex>
+#include <vector>
 
 namespace mola
 {
@@ -226,6 +227,9 @@ class SparseTreesPointCloud : public mrpt::maps::CMetricMap,
         auto* g = gridByOuterIdxs(coordToOuterIdx(pt), true);
         g->insertPoint(pt);
 
+        // Keep the optional multi-resolution pyramid up to date:
+        for (auto& lvl : pyramid_) lvl.insert(pt);
+
         // Also, update bbox:
         if (!cached_.boundingBox_.has_value())
             cached_.boundingBox_.emplace(pt, pt);
@@ -248,16 +252,94 @@ class SparseTreesPointCloud : public mrpt::maps::CMetricMap,
         const std::function<void(const outer_index3d_t&, const GridData&)>& f)
         const;
 
+    /** Parallel variant of visitAllPoints(): the submap blocks are
+     * partitioned across `numThreads` workers (0 = hardware concurrency)
+     * stealing chunks of blocks from a shared cursor, so uneven block
+     * occupancies self-balance. `f` runs concurrently and receives the
+     * worker index in [0, numThreads) as its second argument: use it to
+     * index per-worker accumulators, then reduce them once this returns.
+     * For read-only visitors only: the map must not be modified while
+     * visiting, and `f` must not throw. */
+    void visitAllPointsParallel(
+        const std::function<
+            void(const mrpt::math::TPoint3Df&, unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
+    /** Parallel variant of visitAllGrids(); same threading contract as
+     * visitAllPointsParallel(). */
+    void visitAllGridsParallel(
+        const std::function<void(
+            const outer_index3d_t&, const GridData&,
+            unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
     /** Save to a text file. Each line contains "X Y Z" point coordinates.
      *  Returns false if any error occured, true elsewere.
      */
     bool saveToTextFile(const std::string& file) const;
 
+    /** Exports all map points into one contiguous buffer in a single pass
+     * (TPoint3Df is three packed floats, so `xyz.data()` is a plain
+     * interleaved `float[3*N]` array), suitable for bulk host<->device
+     * copies. Points are grouped by submap block. */
+    void exportFlat(std::vector<mrpt::math::TPoint3Df>& xyz) const;
+
+    /** Inverse of exportFlat(): clears the map and re-inserts the given
+     * contiguous point array through the regular insertion path. */
+    void importFlat(const mrpt::math::TPoint3Df* xyz, std::size_t num);
+
     /** Erase submap blocks entirely farther away than the given distance
      * threshold. */
     void eraseGridsFartherThan(
         const mrpt::math::TPoint3Df& pt, const float distanceMeters);
 
+    /** Erases, at whole-block granularity, the map contents within the given
+     * axis-aligned box: every submap block whose outer index lies in the
+     * inclusive index range spanned by the box corners is dropped as a unit,
+     * without visiting its points, so the cost is O(blocks) instead of
+     * O(points). Note the coarse granularity (blocks are grid_size meters
+     * per side): points merely sharing a block with the box are removed
+     * too. Pyramid levels are kept consistent.
+     * Returns the number of erased blocks. \sa cropToBox() */
+    std::size_t eraseBox(const mrpt::math::TBoundingBoxf& box);
+
+    /** Complement of eraseBox(): drops every submap block whose outer index
+     * lies OUTSIDE the index range spanned by the box corners. Points
+     * sharing a block with the box survive the crop (whole-block
+     * granularity). Returns the number of erased blocks. */
+    std::size_t cropToBox(const mrpt::math::TBoundingBoxf& box);
+
+    /** @} */
+
+    /** @name Multi-resolution pyramid API
+     *  @{ */
+
+    /** Enables a built-in coarse-to-fine pyramid with the given number of
+     * levels: level `l` (l=0...numLevels-1) keeps one representative point
+     * per voxel of size finestVoxelSize*2^l, and is updated incrementally
+     * by insertPoint() (one map write per level), so a coarse-to-fine scan
+     * matcher can query the same object at any resolution without building
+     * decimated copies each keyframe. Pre-existing map points are folded
+     * into the new levels. numLevels=0 disables the pyramid. */
+    void setPyramidLevels(std::size_t numLevels, float finestVoxelSize = 0.5f);
+
+    std::size_t pyramidLevels() const { return pyramid_.size(); }
+
+    /** Voxel size [m] of the given pyramid level */
+    float pyramidLevelResolution(std::size_t level) const
+    {
+        return pyramid_.at(level).voxelSize;
+    }
+
+    /** Approximate nearest-neighbor search over one pyramid level: only
+     * the 3x3x3 voxel neighborhood of the query is inspected, which is the
+     * right granularity for coarse alignment (pairings farther than one
+     * coarse voxel are not useful there anyway). Returns false if that
+     * neighborhood holds no representative point. */
+    bool nn_single_search_level(
+        std::size_t level, const mrpt::math::TPoint3Df& query,
+        mrpt::math::TPoint3Df& result, float& out_dist_sqr) const;
+
     /** @} */
 
     /** @name API of the NearestNeighborsCapable virtual interface
@@ -294,6 +376,21 @@ class SparseTreesPointCloud : public mrpt::maps::CMetricMap,
         std::vector<float>&                 out_dists_sqr,
         std::vector<uint64_t>&              resultIndicesOrIDs,
         size_t                              maxPoints) const override;
+
+    /** Batched version of nn_multiple_search(): answers one KNN query per
+     * entry of `queries`, partitioning the batch across worker threads
+     * (numberOfThreads=0 means hardware concurrency; small batches fall
+     * back to serial execution). Output vectors are resized to numQueries,
+     * with the i-th entry holding the matches of queries[i]. Concurrent
+     * queries are safe: the last-access grid cache is protected by
+     * cachedMtx_. */
+    void nn_multiple_search_batch(
+        const mrpt::math::TPoint3Df* queries, size_t numQueries,
+        const size_t                                     N,
+        std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+        std::vector<std::vector<float>>&                 out_dists_sqr,
+        std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+        unsigned int numberOfThreads = 0) const;
     /** @} */
 
     /** @name Public virtual methods implementation for CMetricMap
@@ -448,6 +545,47 @@ class SparseTreesPointCloud : public mrpt::maps::CMetricMap,
     CachedData        cached_;
     std::shared_mutex cachedMtx_;
 
+    /** One level of the optional coarse-to-fine pyramid (see
+     * setPyramidLevels()): a voxel -> representative-point decimation of
+     * the whole map, reusing the index3d_t machinery of the main grid. */
+    struct PyramidLevel
+    {
+        float voxelSize    = 1.0f;
+        float voxelSizeInv = 1.0f;
+
+        std::map<
+            outer_index3d_t, mrpt::math::TPoint3Df, index3d_hash<int32_t>>
+            voxels;
+
+        outer_index3d_t coordToIdx(const mrpt::math::TPoint3Df& pt) const
+        {
+            return outer_index3d_t(
+                static_cast<int32_t>(pt.x * voxelSizeInv),  //
+                static_cast<int32_t>(pt.y * voxelSizeInv),  //
+                static_cast<int32_t>(pt.z * voxelSizeInv));
+        }
+
+        void insert(const mrpt::math::TPoint3Df& pt)
+        {
+            voxels.emplace(coordToIdx(pt), pt);  // keeps the first point
+        }
+    };
+
+    /** Coarsening levels, finest first. Empty (the default) means the
+     * pyramid is disabled and insertPoint() pays no extra cost. */
+    std::vector<PyramidLevel> pyramid_;
+
+    /** Rebuilds all pyramid levels from the current map contents */
+    void internal_rebuildPyramid();
+
+    /** Shared implementation of eraseBox() / cropToBox(): erases every
+     * submap block whose outer index lies inside (eraseInside=true) or
+     * outside (eraseInside=false) the inclusive index range [o0, o1], and
+     * filters the pyramid levels by the same criterion. */
+    std::size_t internal_eraseIndexRange(
+        const outer_index3d_t& o0, const outer_index3d_t& o1,
+        bool eraseInside);
+
    protected:
     // See docs in base CMetricMap class:
     void internal_clear() override;
@@ -33,6 +33,7 @@
 #include <mrpt/maps/CMetricMap.h>
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/maps/NearestNeighborsCapable.h>
+#include <mrpt/math/CMatrixFixed.h>
 #include <mrpt/math/TBoundingBox.h>
 #include <mrpt/math/TPoint3D.h>
 
@@ -124,6 +125,19 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
             idx.cz * voxel_size_};
     }
 
+    /** Morton (Z-order) code of an outer grid-block index, used to keep the
+     * sorted flat view of the blocks spatially coherent
+     * (\sa gridsMortonOrdered(), visitGridsInBox()) */
+    static inline uint64_t outerIdxToMortonCode(const outer_index3d_t& idx)
+    {
+        // outer indices are multiples of INNER_GRID_SIDE; compact them first
+        // so consecutive blocks get consecutive per-axis values:
+        return index3d_morton_code(index3d_t<int32_t>(
+            idx.cx >> INNER_GRID_BIT_COUNT,  //
+            idx.cy >> INNER_GRID_BIT_COUNT,  //
+            idx.cz >> INNER_GRID_BIT_COUNT));
+    }
+
     static inline global_plain_index_t g2plain(
         const global_index3d_t& g, int subVoxelIndex = 0)
     {
@@ -200,6 +214,16 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         /** Gets the mean of all points in the voxel. Throws if empty. */
         const mrpt::math::TPoint3Df& mean() const { return mean_; }
 
+        /** NDT-style Gaussian of the voxel, from the moment statistics
+         * kept incrementally on insertion (O(1): the stored points are
+         * not touched): `mean` is the point mean, `cov` the 3x3 sample
+         * covariance with `minVar` added to its diagonal to regularize
+         * near-planar voxels. Returns false while the voxel holds fewer
+         * than 3 points and the covariance estimate is degenerate. */
+        bool ndtGaussian(
+            mrpt::math::TPoint3Df& mean, mrpt::math::CMatrixFloat33& cov,
+            float minVar) const;
+
         // for serialization, do not use in normal use:
         size_t   size() const { return numPoints_; }
         void     resize(size_t n) { numPoints_ = n; }
@@ -211,6 +235,11 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
 
         uint8_t                       numPoints_ = 0;
         mutable mrpt::math::TPoint3Df mean_      = {0, 0, 0};
+
+        /** Running means of the second-order products
+         * {xx, yy, zz, xy, xz, yz}, updated together with mean_ on each
+         * insertion (\sa ndtGaussian()) */
+        float mom2_[6] = {0, 0, 0, 0, 0, 0};
     };
 
     struct InnerGrid
@@ -272,18 +301,28 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
                 if (!createIfNew)
                     return {nullptr, nullptr};
                 else
+                {
                     grid = &grids_[oIdx];  // Create it
+                    // new block => the Morton-sorted flat view is stale:
+                    cached_.mortonIndexValid = false;
+                }
             }
             else
             {
                 // Use the found grid
                 grid = &it->second;
             }
-            // Add to cache:
-            cached_.lastAccessIdx[cached_.lastAccessNextWrite]  = oIdx;
-            cached_.lastAccessGrid[cached_.lastAccessNextWrite] = grid;
-            cached_.lastAccessNextWrite++;
-            cached_.lastAccessNextWrite &= CachedData::NUM_CACHED_IDX_MASK;
+            // Add to cache, unless a parallel batch query is running (see
+            // nn_radius_search_batch()), in which case concurrent writes
+            // would race; reads of previous entries are still fine since the
+            // map structure does not change during queries:
+            if (!cached_.concurrentQueries)
+            {
+                cached_.lastAccessIdx[cached_.lastAccessNextWrite]  = oIdx;
+                cached_.lastAccessGrid[cached_.lastAccessNextWrite] = grid;
+                cached_.lastAccessNextWrite++;
+                cached_.lastAccessNextWrite &= CachedData::NUM_CACHED_IDX_MASK;
+            }
         }
 
         // Now, look for the cell withi the grid block:
@@ -317,6 +356,29 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
 
     const grids_map_t& grids() const { return grids_; }
 
+    /** One entry per inner grid block, sorted by Morton code of its outer
+     * index (\sa gridsMortonOrdered()) */
+    using morton_index_t =
+        std::vector<std::pair<uint64_t, const grids_map_t::value_type*>>;
+
+    /** Returns a flat view of all grid blocks sorted by the Morton code of
+     * their outer index, so traversing it visits spatially-close blocks in
+     * nearby memory iterations. The view is cached and lazily re-sorted the
+     * first time it is needed after blocks were created (pointers into
+     * grids_ remain valid, since std::map never relocates its nodes).
+     * Used by visitAllPoints()/visitAllVoxels() and visitGridsInBox(). */
+    const morton_index_t& gridsMortonOrdered() const;
+
+    /** Visits all grid blocks whose outer index box intersects the given
+     * axis-aligned box of map coordinates, using binary search over the
+     * Morton-ordered flat view: all candidate codes lie within
+     * [code(boxMin), code(boxMax)], so only that sub-range is scanned and
+     * filtered against the actual box. */
+    void visitGridsInBox(
+        const mrpt::math::TBoundingBoxf& bbox,
+        const std::function<void(const outer_index3d_t&, const InnerGrid&)>& f)
+        const;
+
     /** Computes the bounding box of all the points, or (0,0 ,0,0, 0,0) if
      * there are no points. Results are cached unless the map is somehow
      * modified to avoid repeated calculations.
@@ -334,11 +396,56 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         const std::function<void(const outer_index3d_t&, const InnerGrid&)>& f)
         const;
 
+    /** Parallel variant of visitAllPoints(): the inner grids are partitioned
+     * across `numThreads` workers (0 = hardware concurrency) stealing chunks
+     * of grids from a shared cursor, so uneven grid occupancies self-balance.
+     * `f` runs concurrently and receives the worker index in [0, numThreads)
+     * as its second argument: use it to index per-worker accumulators, then
+     * reduce them once this returns. For read-only visitors only: the map
+     * must not be modified while visiting, and `f` must not throw. */
+    void visitAllPointsParallel(
+        const std::function<
+            void(const mrpt::math::TPoint3Df&, unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
+    /** Parallel variant of visitAllVoxels(); same threading contract as
+     * visitAllPointsParallel(). */
+    void visitAllVoxelsParallel(
+        const std::function<void(
+            const outer_index3d_t&, const inner_plain_index_t,
+            const VoxelData&, const InnerGrid&, unsigned int workerIdx)>& f,
+        unsigned int numThreads = 0) const;
+
     /** Save to a text file. Each line contains "X Y Z" point coordinates.
      *  Returns false if any error occured, true elsewere.
      */
     bool saveToTextFile(const std::string& file) const;
 
+    /** Exports all map points into one contiguous buffer in a single pass
+     * (TPoint3Df is three packed floats, so `xyz.data()` is a plain
+     * interleaved `float[3*N]` array), suitable for bulk host<->device
+     * copies. Points are grouped by inner grid block, in Morton order. */
+    void exportFlat(std::vector<mrpt::math::TPoint3Df>& xyz) const;
+
+    /** Inverse of exportFlat(): clears the map and re-inserts the given
+     * contiguous point array through the regular insertion path. */
+    void importFlat(const mrpt::math::TPoint3Df* xyz, std::size_t num);
+
+    /** Erases, at whole-block granularity, the map contents within the given
+     * axis-aligned box: every inner grid block (INNER_GRID_SIDE voxels per
+     * side) whose extent overlaps the inclusive voxel-index range spanned by
+     * the box corners is dropped as a unit, without visiting its voxels or
+     * points, so the cost is O(blocks) instead of O(points). Note the
+     * granularity: points merely sharing a block with the box are removed
+     * too. Returns the number of erased blocks. \sa cropToBox() */
+    std::size_t eraseBox(const mrpt::math::TBoundingBoxf& box);
+
+    /** Complement of eraseBox(): drops every inner grid block whose extent
+     * does NOT overlap the voxel-index range spanned by the box corners.
+     * Points sharing a block with the box survive the crop (whole-block
+     * granularity). Returns the number of erased blocks. */
+    std::size_t cropToBox(const mrpt::math::TBoundingBoxf& box);
+
     /** @} */
 
     /** @name API of the NearestNeighborsCapable virtual interface
@@ -373,6 +480,20 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         std::vector<float>&                 out_dists_sqr,
         std::vector<uint64_t>&              resultIndicesOrIDs,
         size_t                              maxPoints) const override;
+
+    /** Batched version of nn_radius_search() (KNN queries are not
+     * implemented for this map type): answers one radius query per entry of
+     * `queries`, partitioning the batch across worker threads
+     * (numberOfThreads=0 means hardware concurrency; small batches fall
+     * back to serial execution). Output vectors are resized to numQueries,
+     * with the i-th entry holding the matches of queries[i]. */
+    void nn_radius_search_batch(
+        const mrpt::math::TPoint3Df* queries, size_t numQueries,
+        const float                                      search_radius_sqr,
+        std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+        std::vector<std::vector<float>>&                 out_dists_sqr,
+        std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+        size_t maxPoints, unsigned int numberOfThreads = 0) const;
     /** @} */
 
     /** @name Public virtual methods implementation for CMetricMap
@@ -455,6 +576,19 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
          * the NN (nearest-neighbors) API methods.
          */
         bool match_mean = false;
+
+        /** If true, each scan point is scored against the NDT-style
+         * Gaussian (mean + covariance) of the voxel containing it, built
+         * from the per-voxel moment statistics kept on insertion: O(1)
+         * per point, with no search over the stored points. Takes
+         * precedence over match_mean for the likelihood evaluation;
+         * the NN API methods are not affected. */
+        bool match_ndt = false;
+
+        /** Variance [m^2] added to the diagonal of the per-voxel
+         * covariances when `match_ndt` is enabled, regularizing voxels
+         * whose points are (near) coplanar or collinear. */
+        double ndt_min_variance = 1e-2;
     };
     TLikelihoodOptions likelihoodOptions;
 
@@ -532,6 +666,14 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         int             lastAccessNextWrite = 0;
         outer_index3d_t lastAccessIdx[NUM_CACHED_IDXS];
         InnerGrid*      lastAccessGrid[NUM_CACHED_IDXS] = {nullptr};
+
+        /// Set while nn_radius_search_batch() runs its worker threads, to
+        /// disable the (unguarded) cache writes above:
+        bool concurrentQueries = false;
+
+        /// Morton-sorted flat view of grids_ (see gridsMortonOrdered()):
+        mutable morton_index_t mortonIndex_;
+        mutable bool           mortonIndexValid = false;
     };
 
     CachedData cached_;
@@ -555,6 +697,12 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         const mrpt::poses::CPose3D& pc_in_map, const float* xs, const float* ys,
         const float* zs, const std::size_t num_pts) const;
 
+    /** likelihoodOptions.match_ndt=true flavor of the above: scores each
+     * decimated point against the Gaussian of the voxel containing it. */
+    double internal_computeObservationLikelihoodPointCloud3D_ndt(
+        const mrpt::poses::CPose3D& pc_in_map, const float* xs, const float* ys,
+        const float* zs, const std::size_t num_pts) const;
+
     /** - (xs,ys,zs): Sensed point local coordinates in the robot frame.
      *  - pc_in_map: SE(3) pose of the robot in the map frame.
      */
@@ -562,6 +710,14 @@ class SparseVoxelPointCloud : public mrpt::maps::CMetricMap,
         const mrpt::poses::CPose3D& pc_in_map, const float* xs, const float* ys,
         const float* zs, const std::size_t num_pts);
 
+    /** Shared implementation of eraseBox() / cropToBox(): erases every inner
+     * grid block whose extent overlaps (eraseOverlapping=true) or does not
+     * overlap (eraseOverlapping=false) the inclusive global voxel-index
+     * range [g0, g1]. */
+    std::size_t internal_eraseBlocks(
+        const global_index3d_t& g0, const global_index3d_t& g1,
+        bool eraseOverlapping);
+
     // See docs in base class
     bool internal_canComputeObservationLikelihood(
         const mrpt::obs::CObservation& obs) const override;
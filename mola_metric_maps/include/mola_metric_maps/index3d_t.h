@@ -26,10 +26,18 @@
  */
 #pragma once
 
+#include <mrpt/core/round.h>
+#include <mrpt/math/TPoint3D.h>
+
+#include <cstddef>
 #include <cstdint>
 #include <functional>  // hash<>
 #include <iostream>
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 namespace mola
 {
 /** Discrete index type for voxel or 3D grid maps, suitable for std::map and
@@ -73,6 +81,34 @@ std::ostream& operator<<(std::ostream& o, const index3d_t<cell_coord_t>& idx)
     return o;
 }
 
+/** Spreads out the lowest 21 bits of the input, leaving two zero bits
+ * between each of them, for 3D Morton code interleaving. */
+inline uint64_t morton_spread3(uint64_t v) noexcept
+{
+    v &= 0x1fffffULL;
+    v = (v | (v << 32)) & 0x001f00000000ffffULL;
+    v = (v | (v << 16)) & 0x001f0000ff0000ffULL;
+    v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+/** 63-bit Morton (Z-order) code of a discrete 3D index. Each coordinate is
+ * offset by 2^20 so negative indices map to increasing codes, hence codes
+ * preserve spatial locality over the whole +-2^20 cell range, and the codes
+ * of all cells inside an axis-aligned index box lie within
+ * [code(boxMin), code(boxMax)].
+ */
+template <typename cell_coord_t = int32_t>
+inline uint64_t index3d_morton_code(const index3d_t<cell_coord_t>& idx) noexcept
+{
+    constexpr int64_t BIAS = 1ll << 20;
+    return morton_spread3(static_cast<uint64_t>(idx.cx + BIAS)) |
+           (morton_spread3(static_cast<uint64_t>(idx.cy + BIAS)) << 1) |
+           (morton_spread3(static_cast<uint64_t>(idx.cz + BIAS)) << 2);
+}
+
 /** This implement the optimized hash from this paper:
  *
  *  Teschner, M., Heidelberger, B., Müller, M., Pomerantes, D., & Gross, M. H.
@@ -111,4 +147,76 @@ struct index3d_hash
     }
 };
 
+/** float->int rounding mode of batch_coords_to_indices(), matching the
+ * per-map scalar conversions: HashedVoxelPointCloud and
+ * SparseTreesPointCloud truncate towards zero (`static_cast<int32_t>`),
+ * SparseVoxelPointCloud rounds to nearest (`mrpt::round`). */
+enum class index_rounding : uint8_t
+{
+    Truncate = 0,
+    Nearest
+};
+
+/** Converts a whole batch of 3D points into discrete grid indices:
+ *
+ *   out[i] = R((pts[i] + offset) * scale), per coordinate,
+ *
+ * where R is given by ROUND. The points are processed as one flat stream
+ * of packed floats (TPoint3Df is three packed floats, and so is
+ * index3d_t<int32_t>), so with AVX2 eight coordinates are converted per
+ * instruction instead of one function call per point; map classes use this
+ * in their insertion and query hot loops. If `hashes` is not nullptr, the
+ * spatial hash of each index (identical to index3d_hash) is also emitted,
+ * so callers sharding or bucketing by hash skip recomputing it.
+ *
+ * \note index_rounding::Nearest matches mrpt::round() under the default
+ * FP rounding mode (round-to-nearest).
+ */
+template <index_rounding ROUND = index_rounding::Truncate>
+inline void batch_coords_to_indices(
+    const mrpt::math::TPoint3Df* pts, const std::size_t num,
+    const float offset, const float scale, index3d_t<int32_t>* out,
+    std::size_t* hashes = nullptr) noexcept
+{
+    static_assert(sizeof(mrpt::math::TPoint3Df) == 3 * sizeof(float));
+    static_assert(sizeof(index3d_t<int32_t>) == 3 * sizeof(int32_t));
+
+    if (num == 0) return;
+
+    const float* f  = &pts[0].x;
+    int32_t*     o  = &out[0].cx;
+    const std::size_t nf = 3 * num;
+
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    {
+        const __m256 vOff = _mm256_set1_ps(offset);
+        const __m256 vSc  = _mm256_set1_ps(scale);
+        for (; i + 8 <= nf; i += 8)
+        {
+            const __m256 v = _mm256_mul_ps(
+                _mm256_add_ps(_mm256_loadu_ps(f + i), vOff), vSc);
+            const __m256i vi = (ROUND == index_rounding::Truncate)
+                                   ? _mm256_cvttps_epi32(v)
+                                   : _mm256_cvtps_epi32(v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(o + i), vi);
+        }
+    }
+#endif
+    for (; i < nf; i++)
+    {
+        const float v = (f[i] + offset) * scale;
+        if constexpr (ROUND == index_rounding::Truncate)
+            o[i] = static_cast<int32_t>(v);
+        else
+            o[i] = mrpt::round(v);
+    }
+
+    if (hashes)
+    {
+        const index3d_hash<int32_t> h;
+        for (std::size_t k = 0; k < num; k++) hashes[k] = h(out[k]);
+    }
+}
+
 }  // namespace mola
@@ -0,0 +1,412 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   FinalizedVoxelPointCloud.cpp
+ * @brief  Immutable compact voxel map for localization-only missions
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_metric_maps/FinalizedVoxelPointCloud.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/core/round.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+using namespace mola;
+
+namespace
+{
+/// Limit on the number of neighbors in KNN searches (same as the live
+/// HashedVoxelPointCloud):
+constexpr size_t HARD_MAX_MATCHES = 3;
+
+/** Fixed-size header of the on-disk blob: all fields are POD at fixed
+ * offsets (padded to 64 bytes), followed directly by the raw VoxelEntry
+ * and TPoint3Df arrays, so the whole file can be memory-mapped. */
+struct FileHeader
+{
+    char     magic[8];
+    uint32_t version   = 0;
+    uint32_t reserved_ = 0;
+    float    voxel_size = 0;
+    float    bbox[6]    = {0, 0, 0, 0, 0, 0};
+    uint64_t numVoxels  = 0;
+    uint64_t numPoints  = 0;
+};
+static_assert(sizeof(FileHeader) == 64);
+static_assert(sizeof(FinalizedVoxelPointCloud::VoxelEntry) == 16);
+static_assert(sizeof(mrpt::math::TPoint3Df) == 3 * sizeof(float));
+
+constexpr char     FILE_MAGIC[8] = {'M', 'O', 'L', 'A', 'F', 'V', 'P', 'C'};
+constexpr uint32_t FILE_VERSION  = 1;
+
+inline FinalizedVoxelPointCloud::global_index3d_t coord_to_idx(
+    const mrpt::math::TPoint3Df& pt, const float voxel_size_inv)
+{
+    return {
+        mrpt::round(pt.x * voxel_size_inv),  //
+        mrpt::round(pt.y * voxel_size_inv),  //
+        mrpt::round(pt.z * voxel_size_inv)};
+}
+}  // namespace
+
+const FinalizedVoxelPointCloud::VoxelEntry* FinalizedVoxelPointCloud::findVoxel(
+    const global_index3d_t& idx) const
+{
+    const uint64_t code = index3d_morton_code(idx);
+
+    auto it = std::lower_bound(
+        voxels_.begin(), voxels_.end(), code,
+        [](const VoxelEntry& e, const uint64_t k)
+        { return e.mortonCode < k; });
+
+    if (it == voxels_.end() || it->mortonCode != code) return nullptr;
+    return &(*it);
+}
+
+bool FinalizedVoxelPointCloud::saveToBinaryFile(
+    const std::string& fileName) const
+{
+    std::ofstream f(fileName, std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) return false;
+
+    FileHeader h;
+    std::memcpy(h.magic, FILE_MAGIC, sizeof(h.magic));
+    h.version    = FILE_VERSION;
+    h.voxel_size = voxel_size_;
+    h.bbox[0]    = bbox_.min.x;
+    h.bbox[1]    = bbox_.min.y;
+    h.bbox[2]    = bbox_.min.z;
+    h.bbox[3]    = bbox_.max.x;
+    h.bbox[4]    = bbox_.max.y;
+    h.bbox[5]    = bbox_.max.z;
+    h.numVoxels  = voxels_.size();
+    h.numPoints  = xyz_.size();
+
+    f.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    f.write(
+        reinterpret_cast<const char*>(voxels_.data()),
+        static_cast<std::streamsize>(voxels_.size() * sizeof(VoxelEntry)));
+    f.write(
+        reinterpret_cast<const char*>(xyz_.data()),
+        static_cast<std::streamsize>(
+            xyz_.size() * sizeof(mrpt::math::TPoint3Df)));
+
+    return f.good();
+}
+
+bool FinalizedVoxelPointCloud::loadFromBinaryFile(const std::string& fileName)
+{
+    std::ifstream f(fileName, std::ios::binary);
+    if (!f.is_open()) return false;
+
+    FileHeader h;
+    f.read(reinterpret_cast<char*>(&h), sizeof(h));
+    if (!f.good() || std::memcmp(h.magic, FILE_MAGIC, sizeof(h.magic)) != 0 ||
+        h.version != FILE_VERSION || h.voxel_size <= 0)
+        return false;
+
+    voxel_size_     = h.voxel_size;
+    voxel_size_inv_ = 1.0f / h.voxel_size;
+    bbox_.min       = {h.bbox[0], h.bbox[1], h.bbox[2]};
+    bbox_.max       = {h.bbox[3], h.bbox[4], h.bbox[5]};
+
+    voxels_.resize(h.numVoxels);
+    xyz_.resize(h.numPoints);
+    f.read(
+        reinterpret_cast<char*>(voxels_.data()),
+        static_cast<std::streamsize>(voxels_.size() * sizeof(VoxelEntry)));
+    f.read(
+        reinterpret_cast<char*>(xyz_.data()),
+        static_cast<std::streamsize>(
+            xyz_.size() * sizeof(mrpt::math::TPoint3Df)));
+
+    if (!f.good())
+    {
+        voxels_.clear();
+        xyz_.clear();
+        return false;
+    }
+
+    // Sanity of the directory ranges, so NN search cannot run off the
+    // arrays on a corrupted file:
+    uint64_t prevCode = 0;
+    for (size_t i = 0; i < voxels_.size(); i++)
+    {
+        const auto& e = voxels_[i];
+        if ((i > 0 && e.mortonCode <= prevCode) ||
+            uint64_t(e.firstPoint) + e.numPoints > xyz_.size())
+        {
+            voxels_.clear();
+            xyz_.clear();
+            return false;
+        }
+        prevCode = e.mortonCode;
+    }
+    return true;
+}
+
+bool FinalizedVoxelPointCloud::nn_has_indices_or_ids() const
+{  // true: IDs are contiguous indices into points()
+    return true;
+}
+
+size_t FinalizedVoxelPointCloud::nn_index_count() const
+{  //
+    return xyz_.size();
+}
+
+bool FinalizedVoxelPointCloud::nn_single_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df& query,
+    [[maybe_unused]] mrpt::math::TPoint2Df&       result,
+    [[maybe_unused]] float&                       out_dist_sqr,
+    [[maybe_unused]] uint64_t&                    resultIndexOrID) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a FinalizedVoxelPointCloud");
+}
+void FinalizedVoxelPointCloud::nn_multiple_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df&        query,
+    [[maybe_unused]] const size_t                        N,
+    [[maybe_unused]] std::vector<mrpt::math::TPoint2Df>& results,
+    [[maybe_unused]] std::vector<float>&                 out_dists_sqr,
+    [[maybe_unused]] std::vector<uint64_t>& resultIndicesOrIDs) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a FinalizedVoxelPointCloud");
+}
+void FinalizedVoxelPointCloud::nn_radius_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df&        query,
+    [[maybe_unused]] const float                         search_radius_sqr,
+    [[maybe_unused]] std::vector<mrpt::math::TPoint2Df>& results,
+    [[maybe_unused]] std::vector<float>&                 out_dists_sqr,
+    [[maybe_unused]] std::vector<uint64_t>&              resultIndicesOrIDs,
+    [[maybe_unused]] size_t                              maxPoints) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a FinalizedVoxelPointCloud");
+}
+
+bool FinalizedVoxelPointCloud::nn_single_search(
+    const mrpt::math::TPoint3Df& query, mrpt::math::TPoint3Df& result,
+    float& out_dist_sqr, uint64_t& resultIndexOrID) const
+{
+    std::vector<mrpt::math::TPoint3Df> r;
+    std::vector<float>                 dist_sqr;
+    std::vector<uint64_t>              resultIndices;
+    nn_multiple_search_impl<1>(query, 1, r, dist_sqr, resultIndices);
+    if (r.empty()) return false;  // none found
+    result          = r[0];
+    out_dist_sqr    = dist_sqr[0];
+    resultIndexOrID = resultIndices[0];
+    return true;
+}
+
+void FinalizedVoxelPointCloud::nn_multiple_search(
+    const mrpt::math::TPoint3Df& query, const size_t N,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>&              resultIndicesOrIDs) const
+{
+    nn_multiple_search_impl<HARD_MAX_MATCHES>(
+        query, N, results, out_dists_sqr, resultIndicesOrIDs);
+}
+
+template <size_t MAX_KNN>
+void FinalizedVoxelPointCloud::nn_multiple_search_impl(
+    const mrpt::math::TPoint3Df& query, const size_t N,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>&              resultIndicesOrIDs) const
+{
+    results.clear();
+    out_dists_sqr.clear();
+    resultIndicesOrIDs.clear();
+
+    ASSERT_(N > 0);
+
+    const global_index3d_t idxQuery = coord_to_idx(query, voxel_size_inv_);
+
+    // Same stack-only candidate handling as the live map:
+    struct Match
+    {
+        mrpt::math::TPoint3Df globalPt;
+        float                 sqrDist;
+        uint64_t              id;
+    };
+    std::array<Match, MAX_KNN> matches;  // sorted by sqrDist!
+    size_t                     foundMatches = 0;
+
+    auto lambdaProcessCandidate = [&](const float                  sqrDist,
+                                      const mrpt::math::TPoint3Df& pt,
+                                      const uint64_t               id)
+    {
+        // found its position in the list:
+        size_t i = 0;
+        for (i = 0; i < foundMatches; i++)
+        {
+            if (sqrDist < matches[i].sqrDist) break;
+        }
+        if (i >= MAX_KNN) return;
+
+        // insert new one at [i], shift [i+1:end] one position.
+        const size_t last = std::min(foundMatches + 1, MAX_KNN);
+        for (size_t j = i + 1; j < last; j++) matches[j] = matches[j - 1];
+
+        matches[i].globalPt = pt;
+        matches[i].id       = id;
+        matches[i].sqrDist  = sqrDist;
+
+        if (foundMatches < MAX_KNN) foundMatches++;
+    };
+
+    auto lambdaCheckCell = [&](const global_index3d_t& p)
+    {
+        const auto* e = findVoxel(p);
+        if (!e) return;
+
+        const auto* pts = &xyz_[e->firstPoint];
+        for (uint32_t i = 0; i < e->numPoints; i++)
+        {
+            const float dx      = pts[i].x - query.x;
+            const float dy      = pts[i].y - query.y;
+            const float dz      = pts[i].z - query.z;
+            const float sqrDist = dx * dx + dy * dy + dz * dz;
+            lambdaProcessCandidate(sqrDist, pts[i], e->firstPoint + i);
+        }
+    };
+
+    for (int32_t cx = idxQuery.cx - 1; cx <= idxQuery.cx + 1; cx++)
+        for (int32_t cy = idxQuery.cy - 1; cy <= idxQuery.cy + 1; cy++)
+            for (int32_t cz = idxQuery.cz - 1; cz <= idxQuery.cz + 1; cz++)
+                lambdaCheckCell({cx, cy, cz});
+
+    for (size_t i = 0; i < std::min<size_t>(N, foundMatches); i++)
+    {
+        const auto& m = matches[i];
+
+        out_dists_sqr.push_back(m.sqrDist);
+        results.push_back(m.globalPt);
+        resultIndicesOrIDs.push_back(m.id);
+    }
+}
+
+void FinalizedVoxelPointCloud::nn_radius_search(
+    const mrpt::math::TPoint3Df& query, const float search_radius_sqr,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>& resultIndicesOrIDs, size_t maxPoints) const
+{
+    results.clear();
+    out_dists_sqr.clear();
+    resultIndicesOrIDs.clear();
+
+    if (search_radius_sqr <= 0) return;
+
+    const float radius = std::sqrt(search_radius_sqr);
+    const auto  diagonal =
+        mrpt::math::TPoint3Df(1.0f, 1.0f, 1.0f) * radius;
+
+    const global_index3d_t idxs0 =
+        coord_to_idx(query - diagonal, voxel_size_inv_);
+    const global_index3d_t idxs1 =
+        coord_to_idx(query + diagonal, voxel_size_inv_);
+
+    struct Match
+    {
+        mrpt::math::TPoint3Df globalPt;
+        float                 sqrDist;
+        uint64_t              id;
+    };
+    std::array<Match, HARD_MAX_MATCHES> matches;  // sorted by sqrDist!
+    size_t                              foundMatches = 0;
+
+    auto lambdaProcessCandidate = [&](const float                  sqrDist,
+                                      const mrpt::math::TPoint3Df& pt,
+                                      const uint64_t               id)
+    {
+        size_t i = 0;
+        for (i = 0; i < foundMatches; i++)
+        {
+            if (sqrDist < matches[i].sqrDist) break;
+        }
+        if (i >= HARD_MAX_MATCHES) return;
+
+        const size_t last = std::min(foundMatches + 1, HARD_MAX_MATCHES);
+        for (size_t j = i + 1; j < last; j++) matches[j] = matches[j - 1];
+
+        matches[i].globalPt = pt;
+        matches[i].id       = id;
+        matches[i].sqrDist  = sqrDist;
+
+        if (foundMatches < HARD_MAX_MATCHES) foundMatches++;
+    };
+
+    auto lambdaCheckCell = [&](const global_index3d_t& p)
+    {
+        const auto* e = findVoxel(p);
+        if (!e) return;
+
+        const auto* pts = &xyz_[e->firstPoint];
+        for (uint32_t i = 0; i < e->numPoints; i++)
+        {
+            const float dx      = pts[i].x - query.x;
+            const float dy      = pts[i].y - query.y;
+            const float dz      = pts[i].z - query.z;
+            const float distSqr = dx * dx + dy * dy + dz * dz;
+            if (distSqr > search_radius_sqr) continue;
+
+            const uint64_t id = e->firstPoint + i;
+
+            if (maxPoints != 0)
+            {
+                // temporary list:
+                lambdaProcessCandidate(distSqr, pts[i], id);
+            }
+            else
+            {
+                // directly save output:
+                out_dists_sqr.push_back(distSqr);
+                results.push_back(pts[i]);
+                resultIndicesOrIDs.push_back(id);
+            }
+        }
+    };
+
+    for (int32_t cx = idxs0.cx; cx <= idxs1.cx; cx++)
+        for (int32_t cy = idxs0.cy; cy <= idxs1.cy; cy++)
+            for (int32_t cz = idxs0.cz; cz <= idxs1.cz; cz++)
+                lambdaCheckCell({cx, cy, cz});
+
+    if (maxPoints != 0)
+    {
+        // we saved results in a temporary buffer, save them out now:
+        for (size_t i = 0; i < std::min<size_t>(maxPoints, foundMatches); i++)
+        {
+            const auto& m = matches[i];
+
+            out_dists_sqr.push_back(m.sqrDist);
+            results.push_back(m.globalPt);
+            resultIndicesOrIDs.push_back(m.id);
+        }
+    }
+}
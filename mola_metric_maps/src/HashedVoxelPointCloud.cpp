@@ -25,6 +25,7 @@
  * @date   Oct 31, 2023
  */
 
+#include <mola_metric_maps/FinalizedVoxelPointCloud.h>
 #include <mola_metric_maps/HashedVoxelPointCloud.h>
 #include <mrpt/config/CConfigFileBase.h>  // MRPT_LOAD_CONFIG_VAR
 #include <mrpt/maps/CSimplePointsMap.h>
@@ -36,9 +37,23 @@
 #include <mrpt/obs/CObservationVelodyneScan.h>
 #include <mrpt/opengl/CPointCloud.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
+#include <mrpt/core/bits_math.h>  // keep_min(), keep_max()
+#include <mrpt/core/lock_helper.h>
 #include <mrpt/serialization/CArchive.h>  // serialization
 #include <mrpt/system/os.h>
 
+#include "serial_layout.h"
+#include "text_export.h"
+#include "visit_parallel.h"
+
+#include <algorithm>  // sort()
+#include <thread>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 #include <cmath>
 
 constexpr size_t HARD_MAX_MATCHES = 3;
@@ -111,7 +126,7 @@ IMPLEMENTS_SERIALIZABLE(HashedVoxelPointCloud, CMetricMap, mola)
 // Serialization
 // =====================================
 
-uint8_t HashedVoxelPointCloud::serializeGetVersion() const { return 0; }
+uint8_t HashedVoxelPointCloud::serializeGetVersion() const { return 1; }
 void    HashedVoxelPointCloud::serializeTo(
        mrpt::serialization::CArchive& out) const
 {
@@ -121,16 +136,20 @@ void    HashedVoxelPointCloud::serializeTo(
     likelihoodOptions.writeToStream(out);
     renderOptions.writeToStream(out);
 
-    // data:
-    out.WriteAs<uint32_t>(voxels_.size());
-    for (const auto& [idx, voxel] : voxels_)
-    {
-        out << idx.cx << idx.cy << idx.cz;
-        const auto&  pts = voxel.points();
-        const size_t N   = pts.size();
-        out.WriteAs<uint16_t>(N);
-        for (size_t j = 0; j < N; j++) out << pts[j];
-    }
+    // data (v1): the whole map as one contiguous raw XYZ block (see
+    // exportFlat()), written with a single WriteBuffer() call so saving
+    // runs at sequential-I/O speed instead of per-point stream operators.
+    // A small layout header lets a loader on an incompatible architecture
+    // fail loudly instead of silently misreading the raw bytes:
+    out.WriteAs<uint8_t>(mola::internal::serial_layout_tag());
+
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
+
+    out.WriteAs<uint64_t>(xyz.size());
+    if (!xyz.empty())
+        out.WriteBuffer(
+            xyz.data(), sizeof(mrpt::math::TPoint3Df) * xyz.size());
 }
 void HashedVoxelPointCloud::serializeFrom(
     mrpt::serialization::CArchive& in, uint8_t version)
@@ -138,6 +157,7 @@ void HashedVoxelPointCloud::serializeFrom(
     switch (version)
     {
         case 0:
+        case 1:
         {
             // params:
             in >> voxel_size_;
@@ -149,21 +169,39 @@ void HashedVoxelPointCloud::serializeFrom(
             likelihoodOptions.readFromStream(in);
             renderOptions.readFromStream(in);
 
-            // data:
-            const auto nGrids = in.ReadAs<uint32_t>();
-            for (uint32_t i = 0; i < nGrids; i++)
+            if (version >= 1)
             {
-                global_index3d_t idx;
-                in >> idx.cx >> idx.cy >> idx.cz;
-
-                auto& grid = voxels_[idx];
-
-                const auto nPts = in.ReadAs<uint16_t>();
-                for (size_t j = 0; j < nPts; j++)
+                // data (v1): one raw XYZ block:
+                const auto layoutTag = in.ReadAs<uint8_t>();
+                ASSERT_EQUAL_(
+                    layoutTag, mola::internal::serial_layout_tag());
+
+                const auto n = in.ReadAs<uint64_t>();
+                std::vector<mrpt::math::TPoint3Df> xyz(n);
+                if (n != 0)
+                    in.ReadBuffer(
+                        xyz.data(), sizeof(mrpt::math::TPoint3Df) * n);
+
+                importFlat(xyz.data(), n);
+            }
+            else
+            {
+                // data (v0): per-point stream operators:
+                const auto nGrids = in.ReadAs<uint32_t>();
+                for (uint32_t i = 0; i < nGrids; i++)
                 {
-                    mrpt::math::TPoint3Df pt;
-                    in >> pt;
-                    grid.insertPoint(pt);
+                    global_index3d_t idx;
+                    in >> idx.cx >> idx.cy >> idx.cz;
+
+                    auto& grid = voxels_[shardOf(idx)][idx];
+
+                    const auto nPts = in.ReadAs<uint16_t>();
+                    for (size_t j = 0; j < nPts; j++)
+                    {
+                        mrpt::math::TPoint3Df pt;
+                        in >> pt;
+                        grid.insertPoint(pt);
+                    }
                 }
             }
         }
@@ -206,28 +244,82 @@ std::string HashedVoxelPointCloud::asString() const
         boundingBox().asString().c_str());
 }
 
+namespace
+{
+// TRenderOptions has no operator==; compare the fields that affect the
+// generated opengl objects:
+bool sameRenderOptions(
+    const HashedVoxelPointCloud::TRenderOptions& a,
+    const HashedVoxelPointCloud::TRenderOptions& b)
+{
+    return a.point_size == b.point_size && a.color.R == b.color.R &&
+           a.color.G == b.color.G && a.color.B == b.color.B &&
+           a.color.A == b.color.A && a.colormap == b.colormap &&
+           a.recolorizeByCoordinateIndex == b.recolorizeByCoordinateIndex;
+}
+}  // namespace
+
 void HashedVoxelPointCloud::getVisualizationInto(
     mrpt::opengl::CSetOfObjects& outObj) const
 {
     MRPT_START
     if (!genericMapParams.enableSaveAs3DObject) return;
 
+    auto lck = mrpt::lockHelper(vizCacheMtx_);
+    auto& vc = vizCache_;
+
+    // Any change in render options invalidates all cached snapshots:
+    if (!vc.builtOptions || !sameRenderOptions(*vc.builtOptions, renderOptions))
+    {
+        for (auto& o : vc.shardObjs) o.reset();
+        vc.wholeObj.reset();
+        vc.builtOptions = renderOptions;
+    }
+
     if (renderOptions.colormap == mrpt::img::cmNONE)
     {
-        // Single color:
-        auto obj = mrpt::opengl::CPointCloud::Create();
+        // Single color: one cached sub-object per hash shard, rebuilt only
+        // when that shard's mutation counter moved since it was built, so
+        // steady-state viz frames do not re-scan the map at all:
+        for (size_t s = 0; s < N_VOXEL_MAP_SHARDS; s++)
+        {
+            const uint64_t cur =
+                cached_.shardMutations[s].load(std::memory_order_relaxed);
 
-        const auto lambdaVisitPoints = [&obj](const mrpt::math::TPoint3Df& pt)
-        { obj->insertPoint(pt); };
-        this->visitAllPoints(lambdaVisitPoints);
+            if (!vc.shardObjs[s] || vc.shardBuiltAt[s] != cur)
+            {
+                auto obj = mrpt::opengl::CPointCloud::Create();
+                for (const auto& [idx, v] : voxels_[s])
+                {
+                    const auto pts = v.points();
+                    for (size_t i = 0; i < pts.size(); i++)
+                        obj->insertPoint(pts[i]);
+                }
+                obj->setColor(renderOptions.color);
+                obj->setPointSize(renderOptions.point_size);
+                obj->enableColorFromZ(false);
 
-        obj->setColor(renderOptions.color);
-        obj->setPointSize(renderOptions.point_size);
-        obj->enableColorFromZ(false);
-        outObj.insert(obj);
+                vc.shardObjs[s]    = obj;
+                vc.shardBuiltAt[s] = cur;
+            }
+            outObj.insert(vc.shardObjs[s]);
+        }
     }
     else
     {
+        // Colormap mode: recolorizeByCoordinate() normalizes over the whole
+        // cloud, so per-shard sub-objects would not compose; cache the whole
+        // object instead, keyed on the (monotone) sum of shard counters:
+        uint64_t cur = 0;
+        for (const auto& c : cached_.shardMutations)
+            cur += c.load(std::memory_order_relaxed);
+
+        if (vc.wholeObj && vc.wholeBuiltAt == cur)
+        {
+            outObj.insert(vc.wholeObj);
+            return;
+        }
+
         auto obj = mrpt::opengl::CPointCloudColoured::Create();
 
         auto bb = this->boundingBox();
@@ -279,12 +371,19 @@ void HashedVoxelPointCloud::getVisualizationInto(
                 min, max, renderOptions.recolorizeByCoordinateIndex,
                 renderOptions.colormap);
         }
-        outObj.insert(obj);
+        vc.wholeObj     = obj;
+        vc.wholeBuiltAt = cur;
+        outObj.insert(vc.wholeObj);
     }
     MRPT_END
 }
 
-void HashedVoxelPointCloud::internal_clear() { voxels_.clear(); }
+void HashedVoxelPointCloud::internal_clear()
+{
+    for (auto& shard : voxels_) shard.clear();
+    // drop the cached bbox too (and bump its shrink version):
+    cached_.reset();
+}
 
 bool HashedVoxelPointCloud::internal_insertObservation(
     const mrpt::obs::CObservation&                   obs,
@@ -315,18 +414,72 @@ bool HashedVoxelPointCloud::internal_insertObservation(
         const auto idxCurObs =
             coordToGlobalIdx(robotPose3D.translation().cast<float>());
 
-        for (auto it = voxels_.begin(); it != voxels_.end();)
+        uint64_t nErased = 0;
+
+        // Incremental eviction: instead of one full-map sweep eating a
+        // latency spike on the inserting thread, only sweep a few shards
+        // per call, rotating through all of them across insertions:
+        const std::size_t nShardsToSweep =
+            (insertionOptions.eviction_shards_per_insertion == 0)
+                ? N_VOXEL_MAP_SHARDS
+                : std::min<std::size_t>(
+                      N_VOXEL_MAP_SHARDS,
+                      insertionOptions.eviction_shards_per_insertion);
+
+        for (std::size_t k = 0; k < nShardsToSweep; k++)
         {
-            // manhattan distance:
-            const int dist = mrpt::max3(
-                std::abs(it->first.cx - idxCurObs.cx),
-                std::abs(it->first.cy - idxCurObs.cy),
-                std::abs(it->first.cz - idxCurObs.cz));
-
-            if (dist > distInGrid)
-                it = voxels_.erase(it);
-            else
-                ++it;
+            const auto shardIdx = evictionNextShard_;
+            auto&      shard    = voxels_[shardIdx];
+            evictionNextShard_ =
+                (evictionNextShard_ + 1) % N_VOXEL_MAP_SHARDS;
+
+            uint64_t nErasedInShard = 0;
+            for (auto it = shard.begin(); it != shard.end();)
+            {
+                // manhattan distance:
+                const int dist = mrpt::max3(
+                    std::abs(it->first.cx - idxCurObs.cx),
+                    std::abs(it->first.cy - idxCurObs.cy),
+                    std::abs(it->first.cz - idxCurObs.cz));
+
+                if (dist > distInGrid)
+                {
+                    it = shard.erase(it);
+                    nErasedInShard++;
+                }
+                else
+                    ++it;
+            }
+            if (nErasedInShard)
+            {
+                nErased += nErasedInShard;
+                cached_.shardMutations[shardIdx].fetch_add(
+                    1, std::memory_order_relaxed);
+            }
+        }
+
+        if (nErased != 0)
+        {
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+            // Erasing robin_map entries shifts its neighbors around, so any
+            // cached voxel pointer may now dangle:
+            cached_.resetLookupCache();
+#endif
+            // The cached bbox is now (at most) over-sized, which is still a
+            // valid approximation; only pay for a full recompute once the
+            // accumulated shrinkage becomes significant:
+            cached_.erasedVoxelsSinceBBox += nErased;
+
+            size_t nRemaining = 0;
+            for (const auto& shard : voxels_) nRemaining += shard.size();
+
+            if (cached_.erasedVoxelsSinceBBox >
+                CachedData::BBOX_RECOMPUTE_FRACTION *
+                    (nRemaining + cached_.erasedVoxelsSinceBBox))
+            {
+                cached_.boundingBox_.reset();  // recomputed lazily
+                cached_.bboxVersion.fetch_add(1, std::memory_order_relaxed);
+            }
         }
     }
 
@@ -514,30 +667,76 @@ double HashedVoxelPointCloud::internal_computeObservationLikelihoodPointCloud3D(
 
     ASSERT_GT_(likelihoodOptions.sigma_dist, .0);
 
+    const float max_sqr_err = mrpt::square(likelihoodOptions.max_corr_distance);
+
+    // Hoist the SE(3) transform coefficients into plain floats, so the
+    // per-point transform below is 9 fma-friendly products instead of
+    // going through CPose3D::composePoint():
+    const auto& R = pc_in_map.getRotationMatrix();
+
+    const float r00 = static_cast<float>(R(0, 0)),
+                r01 = static_cast<float>(R(0, 1)),
+                r02 = static_cast<float>(R(0, 2));
+    const float r10 = static_cast<float>(R(1, 0)),
+                r11 = static_cast<float>(R(1, 1)),
+                r12 = static_cast<float>(R(1, 2));
+    const float r20 = static_cast<float>(R(2, 0)),
+                r21 = static_cast<float>(R(2, 1)),
+                r22 = static_cast<float>(R(2, 2));
+    const float tx = static_cast<float>(pc_in_map.x()),
+                ty = static_cast<float>(pc_in_map.y()),
+                tz = static_cast<float>(pc_in_map.z());
+
+    const std::size_t decim =
+        std::max<std::size_t>(1, likelihoodOptions.decimation);
+
+    // Collect all the NN squared distances into one contiguous buffer, so
+    // the saturation + accumulation of the scoring kernel below runs
+    // branch-free and vectorized, decoupled from the NN lookups:
+    std::vector<float> nnSqrDists;
+    nnSqrDists.reserve(num_pts / decim + 1);
+
     mrpt::math::TPoint3Df closest;
     float                 closest_err;
     uint64_t              closest_id;
-    const float max_sqr_err = mrpt::square(likelihoodOptions.max_corr_distance);
-    double      sumSqrDist  = .0;
 
     std::size_t nPtsForAverage = 0;
-    for (std::size_t i = 0; i < num_pts;
-         i += likelihoodOptions.decimation, nPtsForAverage++)
+    for (std::size_t i = 0; i < num_pts; i += decim, nPtsForAverage++)
     {
         // Transform the point from the scan reference to its global 3D
         // position:
-        const auto gPt = pc_in_map.composePoint({xs[i], ys[i], zs[i]});
+        const float lx = xs[i], ly = ys[i], lz = zs[i];
 
-        const bool found =
-            nn_single_search(gPt, closest, closest_err, closest_id);
-        if (!found) continue;
+        const mrpt::math::TPoint3Df gPt = {
+            r00 * lx + r01 * ly + r02 * lz + tx,
+            r10 * lx + r11 * ly + r12 * lz + ty,
+            r20 * lx + r21 * ly + r22 * lz + tz};
 
-        // Put a limit:
-        mrpt::keep_min(closest_err, max_sqr_err);
+        if (nn_single_search(gPt, closest, closest_err, closest_id))
+            nnSqrDists.push_back(closest_err);
+    }
+    if (!nPtsForAverage) return .0;
 
-        sumSqrDist += static_cast<double>(closest_err);
+    // Saturated accumulation, 8 distances per iteration with AVX2:
+    double      sumSqrDist = .0;
+    std::size_t i          = 0;
+#if defined(__AVX2__)
+    {
+        const __m256 vMax = _mm256_set1_ps(max_sqr_err);
+        __m256       acc  = _mm256_setzero_ps();
+        for (; i + 8 <= nnSqrDists.size(); i += 8)
+            acc = _mm256_add_ps(
+                acc, _mm256_min_ps(_mm256_loadu_ps(&nnSqrDists[i]), vMax));
+
+        alignas(32) float accArr[8];
+        _mm256_store_ps(accArr, acc);
+        for (int k = 0; k < 8; k++) sumSqrDist += accArr[k];
     }
-    if (nPtsForAverage) sumSqrDist /= nPtsForAverage;
+#endif
+    for (; i < nnSqrDists.size(); i++)
+        sumSqrDist += std::min(nnSqrDists[i], max_sqr_err);
+
+    sumSqrDist /= nPtsForAverage;
 
     // Log-likelihood:
     return -sumSqrDist / likelihoodOptions.sigma_dist;
@@ -558,7 +757,9 @@ bool HashedVoxelPointCloud::internal_canComputeObservationLikelihood(
 bool HashedVoxelPointCloud::isEmpty() const
 {
     // empty if no voxels exist:
-    return voxels_.empty();
+    for (const auto& shard : voxels_)
+        if (!shard.empty()) return false;
+    return true;
 }
 
 void HashedVoxelPointCloud::saveMetricMapRepresentationToFile(
@@ -572,56 +773,502 @@ void HashedVoxelPointCloud::saveMetricMapRepresentationToFile(
 
 bool HashedVoxelPointCloud::saveToTextFile(const std::string& file) const
 {
-    FILE* f = mrpt::system::os::fopen(file.c_str(), "wt");
-    if (!f) return false;
+    // Collapse the map into one contiguous buffer, then format/write it in
+    // parallel chunks (see text_export.h):
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
 
-    const auto lambdaVisitPoints = [f](const mrpt::math::TPoint3Df& pt)
-    { mrpt::system::os::fprintf(f, "%f %f %f\n", pt.x, pt.y, pt.z); };
+    return mola::internal::saveXYZToTextFile(file, xyz);
+}
 
-    this->visitAllPoints(lambdaVisitPoints);
+namespace
+{
+/** Squared distances from `query` to the first `n` points of a voxel's
+ * structure-of-arrays coordinate buffers (32-byte aligned, see VoxelData),
+ * written into out[0..n-1]. AVX2 processes 8 points per iteration. */
+void soaSqrDistances(
+    const float* xs, const float* ys, const float* zs, const size_t n,
+    const mrpt::math::TPoint3Df& query, float* out)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256 qx = _mm256_set1_ps(query.x);
+    const __m256 qy = _mm256_set1_ps(query.y);
+    const __m256 qz = _mm256_set1_ps(query.z);
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 dx = _mm256_sub_ps(_mm256_load_ps(xs + i), qx);
+        const __m256 dy = _mm256_sub_ps(_mm256_load_ps(ys + i), qy);
+        const __m256 dz = _mm256_sub_ps(_mm256_load_ps(zs + i), qz);
+        const __m256 d2 = _mm256_add_ps(
+            _mm256_mul_ps(dx, dx),
+            _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+        _mm256_storeu_ps(out + i, d2);
+    }
+#endif
+    for (; i < n; i++)
+    {
+        const float dx = xs[i] - query.x;
+        const float dy = ys[i] - query.y;
+        const float dz = zs[i] - query.z;
+        out[i]         = dx * dx + dy * dy + dz * dz;
+    }
+}
 
-    mrpt::system::os::fclose(f);
-    return true;
+/** Bounding box of a whole batch of points, with vectorized min/max.
+ *  Requires num>=1. */
+mrpt::math::TBoundingBoxf batchBoundingBox(
+    const mrpt::math::TPoint3Df* pts, const std::size_t num)
+{
+    auto        bb = mrpt::math::TBoundingBoxf(pts[0], pts[0]);
+    std::size_t j  = 0;
+#if defined(__AVX2__)
+    if (num >= 8)
+    {
+        // The batch is a packed (x,y,z,x,y,z,...) float array: process it
+        // as 3 vectors of 8 floats per 8 points, so each accumulator lane
+        // always holds the same coordinate (24 % 8 == 0), and reduce
+        // lane->coordinate at the end:
+        const float* f = &pts[0].x;
+        __m256       accMin[3], accMax[3];
+        for (int k = 0; k < 3; k++)
+            accMin[k] = accMax[k] = _mm256_loadu_ps(f + 8 * k);
+        std::size_t p = 8;
+        for (; p + 8 <= num; p += 8)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                const __m256 v8 = _mm256_loadu_ps(f + 3 * p + 8 * k);
+                accMin[k]       = _mm256_min_ps(accMin[k], v8);
+                accMax[k]       = _mm256_max_ps(accMax[k], v8);
+            }
+        }
+        alignas(32) float mn[24], mx[24];
+        for (int k = 0; k < 3; k++)
+        {
+            _mm256_store_ps(&mn[8 * k], accMin[k]);
+            _mm256_store_ps(&mx[8 * k], accMax[k]);
+        }
+        for (int k = 0; k < 24; k++)
+        {
+            mrpt::keep_min(bb.min[k % 3], mn[k]);
+            mrpt::keep_max(bb.max[k % 3], mx[k]);
+        }
+        j = p;
+    }
+#endif
+    for (; j < num; j++) bb.updateWithPoint(pts[j]);
+
+    return bb;
 }
+}  // namespace
 
 void HashedVoxelPointCloud::insertPoint(const mrpt::math::TPoint3Df& pt)
 {
-    auto& v = *voxelByCoords(pt, true /*create if new*/);
+    const auto idx = coordToGlobalIdx(pt);
+    auto&      v   = *voxelByGlobalIdxs(idx, true /*create if new*/);
+    if (internal_insertPointIntoVoxel(v, pt, true /*updateBBox*/))
+        cached_.shardMutations[shardOf(idx)].fetch_add(
+            1, std::memory_order_relaxed);
+}
 
+bool HashedVoxelPointCloud::internal_insertPointIntoVoxel(
+    VoxelData& v, const mrpt::math::TPoint3Df& pt, bool updateBBox)
+{
     const auto nPreviousPoints = v.points().size();
 
     if (insertionOptions.max_points_per_voxel != 0 &&
         nPreviousPoints >= insertionOptions.max_points_per_voxel)
-        return;  // skip, voxel is full
+        return false;  // skip, voxel is full
 
     if (insertionOptions.min_distance_between_points > 0 &&
         nPreviousPoints != 0)
     {
         // Look for the closest existing point in the voxel:
-        std::optional<float> curClosestDistSqr;
-
         const auto& pts = v.points();
-        for (size_t i = 0; i < pts.size(); i++)
-        {
-            const float distSqr = pts[i].sqrDistanceTo(pt);
-            if (!curClosestDistSqr.has_value() ||
-                distSqr < curClosestDistSqr.value())
-                curClosestDistSqr = distSqr;
-        }
+
+        alignas(32) float distsSqr[SSO_MAX_POINTS_PER_VOXEL];
+        soaSqrDistances(
+            pts.xs(), pts.ys(), pts.zs(), pts.size(), pt, distsSqr);
+
+        float curClosestDistSqr = distsSqr[0];
+        for (size_t i = 1; i < pts.size(); i++)
+            mrpt::keep_min(curClosestDistSqr, distsSqr[i]);
+
         const float minDistSqr =
             mrpt::square(insertionOptions.min_distance_between_points);
 
         // Skip if the point is too close to existing ones:
-        if (curClosestDistSqr.value() < minDistSqr) return;
+        if (curClosestDistSqr < minDistSqr) return false;
     }
 
     v.insertPoint(pt);
 
     // Also, update bbox:
+    if (!updateBBox) return true;
+
     if (!cached_.boundingBox_.has_value())
         cached_.boundingBox_.emplace(pt, pt);
     else
         cached_.boundingBox_->updateWithPoint(pt);
+
+    return true;
+}
+
+void HashedVoxelPointCloud::insertPoints(
+    const mrpt::math::TPoint3Df* pts, const std::size_t num)
+{
+    MRPT_TRY_START
+
+    if (num == 0) return;
+
+    struct BatchEntry
+    {
+        global_plain_index_t key;
+        uint32_t             i;
+    };
+
+    thread_local std::vector<global_index3d_t> idxs;
+    thread_local std::vector<BatchEntry>       entries;
+    idxs.resize(num);
+    entries.resize(num);
+
+    // 1) coordinate->voxel index conversion for the whole batch (SIMD;
+    //    truncation matches the static_cast<int32_t> in coordToGlobalIdx()):
+    batch_coords_to_indices<index_rounding::Truncate>(
+        pts, num, .0f, voxel_size_inv_, idxs.data());
+
+    for (std::size_t j = 0; j < num; j++)
+        entries[j] = {g2plain(idxs[j]), static_cast<uint32_t>(j)};
+
+    // 2) sort by voxel key (keeping insertion order within each voxel) so
+    //    the hash map is probed only once per run of equal indices:
+    std::sort(
+        entries.begin(), entries.end(),
+        [](const BatchEntry& a, const BatchEntry& b) {
+            return a.key < b.key || (a.key == b.key && a.i < b.i);
+        });
+
+    for (auto& shard : voxels_)
+        shard.reserve(shard.size() + num / N_VOXEL_MAP_SHARDS);
+
+    // If any per-point rejection option is active, the bbox must be updated
+    // only with the points actually accepted; otherwise it can be computed
+    // for the whole batch at once with SIMD min/max below:
+    const bool bboxPerPoint =
+        insertionOptions.max_points_per_voxel != 0 ||
+        insertionOptions.min_distance_between_points > 0;
+
+    VoxelData*           v        = nullptr;
+    global_plain_index_t lastKey  = 0;
+    std::size_t          curShard = 0;
+    for (const auto& e : entries)
+    {
+        if (!v || e.key != lastKey)
+        {
+            v        = voxelByGlobalIdxs(idxs[e.i], true /*create if new*/);
+            lastKey  = e.key;
+            curShard = shardOf(idxs[e.i]);
+        }
+        if (internal_insertPointIntoVoxel(*v, pts[e.i], bboxPerPoint))
+            cached_.shardMutations[curShard].fetch_add(
+                1, std::memory_order_relaxed);
+    }
+
+    if (!bboxPerPoint)
+    {
+        // 3) batch bounding-box update:
+        const auto bb = batchBoundingBox(pts, num);
+
+        if (!cached_.boundingBox_.has_value()) { cached_.boundingBox_ = bb; }
+        else
+        {
+            cached_.boundingBox_->updateWithPoint(bb.min);
+            cached_.boundingBox_->updateWithPoint(bb.max);
+        }
+    }
+
+    MRPT_TRY_END
+}
+
+void HashedVoxelPointCloud::insertPointsConcurrent(
+    const mrpt::math::TPoint3Df* pts, const std::size_t num)
+{
+    MRPT_TRY_START
+
+    if (num == 0) return;
+
+    struct BatchEntry
+    {
+        uint32_t             shard;
+        global_plain_index_t key;
+        uint32_t             i;
+    };
+
+    // thread_local: this method is meant to run in several threads at once,
+    // so each caller keeps its own scratch buffers:
+    thread_local std::vector<global_index3d_t> idxs;
+    thread_local std::vector<BatchEntry>       entries;
+    idxs.resize(num);
+    entries.resize(num);
+
+    batch_coords_to_indices<index_rounding::Truncate>(
+        pts, num, .0f, voxel_size_inv_, idxs.data());
+    for (std::size_t j = 0; j < num; j++)
+        entries[j] = {
+            static_cast<uint32_t>(shardOf(idxs[j])), g2plain(idxs[j]),
+            static_cast<uint32_t>(j)};
+
+    // Sort by (shard, voxel, insertion order) so each shard lock is taken
+    // exactly once per batch and each voxel is looked up once per run:
+    std::sort(
+        entries.begin(), entries.end(),
+        [](const BatchEntry& a, const BatchEntry& b) {
+            if (a.shard != b.shard) return a.shard < b.shard;
+            if (a.key != b.key) return a.key < b.key;
+            return a.i < b.i;
+        });
+
+    std::size_t j = 0;
+    while (j < num)
+    {
+        const uint32_t shardIdx = entries[j].shard;
+
+        auto  lck   = mrpt::lockHelper(shard_mtxs_[shardIdx]);
+        auto& shard = voxels_[shardIdx];
+
+        VoxelData*           v         = nullptr;
+        global_plain_index_t lastKey   = 0;
+        uint64_t             nAccepted = 0;
+        for (; j < num && entries[j].shard == shardIdx; j++)
+        {
+            const auto& e = entries[j];
+            if (!v || e.key != lastKey)
+            {
+                v       = &shard[idxs[e.i]];  // create if new
+                lastKey = e.key;
+            }
+            if (internal_insertPointIntoVoxel(
+                    *v, pts[e.i], false /*bbox updated below*/))
+                nAccepted++;
+        }
+        if (nAccepted)
+            cached_.shardMutations[shardIdx].fetch_add(
+                nAccepted, std::memory_order_relaxed);
+    }
+
+    // Merge the batch bbox into the shared cache under its own lock:
+    const auto bb = batchBoundingBox(pts, num);
+    {
+        auto lck = mrpt::lockHelper(bbox_mtx_);
+        if (!cached_.boundingBox_.has_value()) { cached_.boundingBox_ = bb; }
+        else
+        {
+            cached_.boundingBox_->updateWithPoint(bb.min);
+            cached_.boundingBox_->updateWithPoint(bb.max);
+        }
+    }
+
+    MRPT_TRY_END
+}
+
+void HashedVoxelPointCloud::exportFlat(
+    std::vector<mrpt::math::TPoint3Df>& xyz,
+    std::vector<FlatVoxelEntry>*        voxelInfo) const
+{
+    std::size_t nPoints = 0, nVoxels = 0;
+    for (const auto& shard : voxels_)
+    {
+        nVoxels += shard.size();
+        for (const auto& [idx, v] : shard) nPoints += v.size();
+    }
+
+    xyz.clear();
+    xyz.reserve(nPoints);
+    if (voxelInfo)
+    {
+        voxelInfo->clear();
+        voxelInfo->reserve(nVoxels);
+    }
+
+    for (const auto& shard : voxels_)
+    {
+        for (const auto& [idx, v] : shard)
+        {
+            const auto pts = v.points();
+            if (voxelInfo)
+                voxelInfo->push_back(
+                    {g2plain(idx), static_cast<uint32_t>(xyz.size()),
+                     static_cast<uint32_t>(pts.size())});
+            for (size_t k = 0; k < pts.size(); k++)
+                xyz.emplace_back(pts.xs()[k], pts.ys()[k], pts.zs()[k]);
+        }
+    }
+}
+
+void HashedVoxelPointCloud::importFlat(
+    const mrpt::math::TPoint3Df* xyz, const std::size_t num)
+{
+    MRPT_TRY_START
+
+    this->clear();
+    if (num == 0) return;
+
+    // The buffer normally comes voxel-grouped from exportFlat(), so the
+    // lookup below hits the same voxel for whole runs of points. Insertion
+    // filters are bypassed on purpose: these points were already accepted
+    // once, and the round trip must be exact.
+    VoxelData*       v       = nullptr;
+    global_index3d_t lastIdx = {0, 0, 0};
+    for (std::size_t i = 0; i < num; i++)
+    {
+        const auto idx = coordToGlobalIdx(xyz[i]);
+        if (!v || idx != lastIdx)
+        {
+            v       = voxelByGlobalIdxs(idx, true /*create if new*/);
+            lastIdx = idx;
+        }
+        v->insertPoint(xyz[i]);
+    }
+
+    cached_.boundingBox_ = batchBoundingBox(xyz, num);
+
+    MRPT_TRY_END
+}
+
+std::size_t HashedVoxelPointCloud::eraseBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseIndexRange(
+        coordToGlobalIdx(box.min), coordToGlobalIdx(box.max),
+        true /*eraseInside*/);
+}
+
+std::size_t HashedVoxelPointCloud::cropToBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseIndexRange(
+        coordToGlobalIdx(box.min), coordToGlobalIdx(box.max),
+        false /*eraseInside*/);
+}
+
+std::size_t HashedVoxelPointCloud::internal_eraseIndexRange(
+    const global_index3d_t& idx0, const global_index3d_t& idx1,
+    const bool eraseInside)
+{
+    uint64_t nErased = 0;
+
+    for (std::size_t shardIdx = 0; shardIdx < N_VOXEL_MAP_SHARDS; shardIdx++)
+    {
+        auto& shard = voxels_[shardIdx];
+
+        uint64_t nErasedInShard = 0;
+        for (auto it = shard.begin(); it != shard.end();)
+        {
+            const auto& idx    = it->first;
+            const bool  inside =  //
+                idx.cx >= idx0.cx && idx.cx <= idx1.cx &&
+                idx.cy >= idx0.cy && idx.cy <= idx1.cy &&
+                idx.cz >= idx0.cz && idx.cz <= idx1.cz;
+
+            if (inside == eraseInside)
+            {
+                it = shard.erase(it);
+                nErasedInShard++;
+            }
+            else
+                ++it;
+        }
+        if (nErasedInShard)
+        {
+            nErased += nErasedInShard;
+            cached_.shardMutations[shardIdx].fetch_add(
+                1, std::memory_order_relaxed);
+        }
+    }
+
+    if (nErased != 0)
+    {
+#if defined(HASHED_VOXEL_POINT_CLOUD_WITH_CACHED_ACCESS)
+        // Erasing robin_map entries shifts its neighbors around, so any
+        // cached voxel pointer may now dangle:
+        cached_.resetLookupCache();
+#endif
+        // Same lazy bbox-shrink bookkeeping as the far-voxel eviction in
+        // internal_insertObservation():
+        cached_.erasedVoxelsSinceBBox += nErased;
+
+        size_t nRemaining = 0;
+        for (const auto& shard : voxels_) nRemaining += shard.size();
+
+        if (cached_.erasedVoxelsSinceBBox >
+            CachedData::BBOX_RECOMPUTE_FRACTION *
+                (nRemaining + cached_.erasedVoxelsSinceBBox))
+        {
+            cached_.boundingBox_.reset();  // recomputed lazily
+            cached_.bboxVersion.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    return static_cast<std::size_t>(nErased);
+}
+
+FinalizedVoxelPointCloud HashedVoxelPointCloud::finalize() const
+{
+    FinalizedVoxelPointCloud out;
+    out.voxel_size_     = voxel_size_;
+    out.voxel_size_inv_ = voxel_size_inv_;
+
+    // Gather all non-empty voxels and sort them by the Morton code of
+    // their index, so the flat layout keeps spatially close voxels close
+    // in memory:
+    std::vector<std::pair<uint64_t, const VoxelData*>> order;
+    {
+        size_t nVoxels = 0;
+        for (const auto& shard : voxels_) nVoxels += shard.size();
+        order.reserve(nVoxels);
+    }
+
+    size_t nTotalPts = 0;
+    for (const auto& shard : voxels_)
+    {
+        for (const auto& [idx, v] : shard)
+        {
+            if (v.points().empty()) continue;
+            order.emplace_back(index3d_morton_code(idx), &v);
+            nTotalPts += v.points().size();
+        }
+    }
+    std::sort(
+        order.begin(), order.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // The compact directory stores 32-bit point ranges:
+    ASSERT_LT_(nTotalPts, size_t(UINT32_MAX));
+
+    out.voxels_.reserve(order.size());
+    out.xyz_.reserve(nTotalPts);
+    for (const auto& [code, v] : order)
+    {
+        auto& e      = out.voxels_.emplace_back();
+        e.mortonCode = code;
+        e.firstPoint = static_cast<uint32_t>(out.xyz_.size());
+        e.numPoints  = static_cast<uint32_t>(v->points().size());
+
+        const auto& pts = v->points();
+        for (size_t i = 0; i < pts.size(); i++) out.xyz_.push_back(pts[i]);
+    }
+
+    // Exact bbox from the points themselves (the live map's cached one may
+    // be an over-approximation after voxel erases):
+    if (!out.xyz_.empty())
+    {
+        auto bb = mrpt::math::TBoundingBoxf(out.xyz_[0], out.xyz_[0]);
+        for (const auto& pt : out.xyz_) bb.updateWithPoint(pt);
+        out.bbox_ = bb;
+    }
+
+    return out;
 }
 
 bool HashedVoxelPointCloud::nn_has_indices_or_ids() const
@@ -677,6 +1324,58 @@ bool HashedVoxelPointCloud::nn_single_search(
     return true;
 }
 
+bool HashedVoxelPointCloud::nn_single_search_with_context(
+    const mrpt::math::TPoint3Df& query, const size_t queryIndex,
+    NNSearchContext& ctx, mrpt::math::TPoint3Df& result, float& out_dist_sqr,
+    uint64_t& resultIndexOrID) const
+{
+    if (queryIndex >= ctx.cached_voxel.size())
+    {
+        // grow geometrically so per-point calls do not reallocate each time:
+        const size_t newSize =
+            std::max<size_t>(queryIndex + 1, 2 * ctx.cached_voxel.size());
+        ctx.cached_voxel.resize(newSize);
+        ctx.valid.resize(newSize, 0);
+    }
+
+    // Fast path: between ICP iterations the query barely moves, so the
+    // voxel that matched last time almost always holds the answer:
+    if (ctx.valid[queryIndex] && ctx.accept_dist_sqr > 0)
+    {
+        const auto cIdx = ctx.cached_voxel[queryIndex];
+        if (auto* v = voxelByGlobalIdxs(cIdx); v && !v->points().empty())
+        {
+            const auto&  pts = v->points();
+            const size_t n   = pts.size();
+
+            alignas(32) float distsSqr[SSO_MAX_POINTS_PER_VOXEL];
+            soaSqrDistances(pts.xs(), pts.ys(), pts.zs(), n, query, distsSqr);
+
+            size_t best = 0;
+            for (size_t i = 1; i < n; i++)
+                if (distsSqr[i] < distsSqr[best]) best = i;
+
+            if (distsSqr[best] <= ctx.accept_dist_sqr)
+            {
+                result          = pts[best];
+                out_dist_sqr    = distsSqr[best];
+                resultIndexOrID = g2plain(cIdx, best);
+                return true;
+            }
+        }
+        ctx.valid[queryIndex] = 0;  // stale: repair below via full search
+    }
+
+    const bool found =
+        nn_single_search(query, result, out_dist_sqr, resultIndexOrID);
+    if (found)
+    {
+        ctx.cached_voxel[queryIndex] = coordToGlobalIdx(result);
+        ctx.valid[queryIndex]        = 1;
+    }
+    return found;
+}
+
 void HashedVoxelPointCloud::nn_multiple_search(
     const mrpt::math::TPoint3Df& query, const size_t N,
     std::vector<mrpt::math::TPoint3Df>& results,
@@ -687,6 +1386,53 @@ void HashedVoxelPointCloud::nn_multiple_search(
         query, N, results, out_dists_sqr, resultIndicesOrIDs);
 }
 
+void HashedVoxelPointCloud::nn_multiple_search_batch(
+    const mrpt::math::TPoint3Df* queries, const size_t numQueries,
+    const size_t                                     N,
+    std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+    std::vector<std::vector<float>>&                 out_dists_sqr,
+    std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+    unsigned int                                     numberOfThreads) const
+{
+    results.resize(numQueries);
+    out_dists_sqr.resize(numQueries);
+    resultIndicesOrIDs.resize(numQueries);
+    if (numQueries == 0) return;
+
+    // Each thread writes only into the output slots of its own range of
+    // query indices, so no merge step or locking is required:
+    const auto lambdaWorker = [&](const size_t idx0, const size_t idx1) {
+        for (size_t i = idx0; i < idx1; i++)
+            nn_multiple_search_impl<HARD_MAX_MATCHES>(
+                queries[i], N, results[i], out_dists_sqr[i],
+                resultIndicesOrIDs[i]);
+    };
+
+    // Not worth spawning threads for short batches:
+    constexpr size_t MIN_QUERIES_PER_THREAD = 64;
+
+    size_t nThreads = numberOfThreads != 0
+                          ? numberOfThreads
+                          : std::thread::hardware_concurrency();
+    nThreads = std::min(
+        nThreads, std::max<size_t>(1, numQueries / MIN_QUERIES_PER_THREAD));
+
+    if (nThreads <= 1)
+    {
+        lambdaWorker(0, numQueries);
+        return;
+    }
+
+    const size_t chunk = (numQueries + nThreads - 1) / nThreads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (size_t t = 0; t < nThreads; t++)
+        workers.emplace_back(
+            lambdaWorker, t * chunk, std::min(numQueries, (t + 1) * chunk));
+    for (auto& w : workers) w.join();
+}
+
 template <size_t MAX_KNN>
 void HashedVoxelPointCloud::nn_multiple_search_impl(
     const mrpt::math::TPoint3Df& query, const size_t N,
@@ -744,15 +1490,14 @@ void HashedVoxelPointCloud::nn_multiple_search_impl(
     {
         if (auto* v = voxelByGlobalIdxs(p); v && !v->points().empty())
         {
-            const auto& pts = v->points();
-            for (size_t i = 0; i < pts.size(); i++)
-            {
-                const auto& pt      = pts[i];
-                float       distSqr = (pt - query).sqrNorm();
-                const auto  id      = g2plain(p, i);
+            const auto&  pts = v->points();
+            const size_t n   = pts.size();
 
-                lambdaProcessCandidate(distSqr, pt, id);
-            }
+            alignas(32) float distsSqr[SSO_MAX_POINTS_PER_VOXEL];
+            soaSqrDistances(pts.xs(), pts.ys(), pts.zs(), n, query, distsSqr);
+
+            for (size_t i = 0; i < n; i++)
+                lambdaProcessCandidate(distsSqr[i], pts[i], g2plain(p, i));
         }
     };
 
@@ -828,11 +1573,15 @@ void HashedVoxelPointCloud::nn_radius_search(
     {
         if (auto* v = voxelByGlobalIdxs(p); v && !v->points().empty())
         {
-            const auto& pts = v->points();
-            for (size_t i = 0; i < pts.size(); i++)
+            const auto&  pts = v->points();
+            const size_t n   = pts.size();
+
+            alignas(32) float distsSqr[SSO_MAX_POINTS_PER_VOXEL];
+            soaSqrDistances(pts.xs(), pts.ys(), pts.zs(), n, query, distsSqr);
+
+            for (size_t i = 0; i < n; i++)
             {
-                const auto& pt      = pts[i];
-                float       distSqr = (pt - query).sqrNorm();
+                const float distSqr = distsSqr[i];
                 if (distSqr > search_radius_sqr) continue;
 
                 const auto id = g2plain(p, i);
@@ -840,13 +1589,273 @@ void HashedVoxelPointCloud::nn_radius_search(
                 if (maxPoints != 0)
                 {
                     // temporary list:
-                    lambdaProcessCandidate(distSqr, pt, id);
+                    lambdaProcessCandidate(distSqr, pts[i], id);
+                }
+                else
+                {
+                    // directly save output:
+                    out_dists_sqr.push_back(distSqr);
+                    results.push_back(pts[i]);
+                    resultIndicesOrIDs.push_back(id);
+                }
+            }
+        }
+    };
+
+    for (int32_t cx = idxs0.cx; cx <= idxs1.cx; cx++)
+        for (int32_t cy = idxs0.cy; cy <= idxs1.cy; cy++)
+            for (int32_t cz = idxs0.cz; cz <= idxs1.cz; cz++)
+                lambdaCheckCell({cx, cy, cz});
+
+    if (maxPoints != 0)
+    {
+        // we saved results in a temporary buffer, save them out now:
+        for (size_t i = 0; i < std::min<size_t>(maxPoints, foundMatches); i++)
+        {
+            const auto& m = matches[i];
+
+            out_dists_sqr.push_back(m.sqrDist);
+            results.push_back(m.globalPt);
+            resultIndicesOrIDs.push_back(m.id);
+        }
+    }
+}
+
+// ---------------- HashedVoxelPointCloudSubmapView ----------------
+
+bool HashedVoxelPointCloudSubmapView::nn_has_indices_or_ids() const
+{  // false: IDs, not contiguous indices
+    return false;
+}
+
+size_t HashedVoxelPointCloudSubmapView::nn_index_count() const
+{  // Not used.
+    return 0;
+}
+
+bool HashedVoxelPointCloudSubmapView::nn_single_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df& query,
+    [[maybe_unused]] mrpt::math::TPoint2Df&       result,
+    [[maybe_unused]] float&                       out_dist_sqr,
+    [[maybe_unused]] uint64_t&                    resultIndexOrID) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a HashedVoxelPointCloud");
+}
+void HashedVoxelPointCloudSubmapView::nn_multiple_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df&        query,
+    [[maybe_unused]] const size_t                        N,
+    [[maybe_unused]] std::vector<mrpt::math::TPoint2Df>& results,
+    [[maybe_unused]] std::vector<float>&                 out_dists_sqr,
+    [[maybe_unused]] std::vector<uint64_t>& resultIndicesOrIDs) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a HashedVoxelPointCloud");
+}
+void HashedVoxelPointCloudSubmapView::nn_radius_search(
+    [[maybe_unused]] const mrpt::math::TPoint2Df&        query,
+    [[maybe_unused]] const float                         search_radius_sqr,
+    [[maybe_unused]] std::vector<mrpt::math::TPoint2Df>& results,
+    [[maybe_unused]] std::vector<float>&                 out_dists_sqr,
+    [[maybe_unused]] std::vector<uint64_t>&              resultIndicesOrIDs,
+    [[maybe_unused]] size_t                              maxPoints) const
+{
+    THROW_EXCEPTION("Cannot run a 2D search on a HashedVoxelPointCloud");
+}
+
+bool HashedVoxelPointCloudSubmapView::nn_single_search(
+    const mrpt::math::TPoint3Df& query, mrpt::math::TPoint3Df& result,
+    float& out_dist_sqr, uint64_t& resultIndexOrID) const
+{
+    std::vector<mrpt::math::TPoint3Df> r;
+    std::vector<float>                 dist_sqr;
+    std::vector<uint64_t>              resultIndices;
+    nn_multiple_search_impl<1>(query, 1, r, dist_sqr, resultIndices);
+    if (r.empty()) return false;  // none found
+    result          = r[0];
+    out_dist_sqr    = dist_sqr[0];
+    resultIndexOrID = resultIndices[0];
+    return true;
+}
+
+void HashedVoxelPointCloudSubmapView::nn_multiple_search(
+    const mrpt::math::TPoint3Df& query, const size_t N,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>&              resultIndicesOrIDs) const
+{
+    nn_multiple_search_impl<HARD_MAX_MATCHES>(
+        query, N, results, out_dists_sqr, resultIndicesOrIDs);
+}
+
+template <size_t MAX_KNN>
+void HashedVoxelPointCloudSubmapView::nn_multiple_search_impl(
+    const mrpt::math::TPoint3Df& query, const size_t N,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>&              resultIndicesOrIDs) const
+{
+    results.clear();
+    out_dists_sqr.clear();
+    resultIndicesOrIDs.clear();
+
+    ASSERT_(N > 0);
+
+    // Same neighborhood sweep as the parent's, but clamped to the voxel
+    // index range of the view:
+    const auto qIdx = parent_.coordToGlobalIdx(query);
+
+    const global_index3d_t idxs0(
+        std::max(qIdx.cx - 1, idxMin_.cx), std::max(qIdx.cy - 1, idxMin_.cy),
+        std::max(qIdx.cz - 1, idxMin_.cz));
+    const global_index3d_t idxs1(
+        std::min(qIdx.cx + 1, idxMax_.cx), std::min(qIdx.cy + 1, idxMax_.cy),
+        std::min(qIdx.cz + 1, idxMax_.cz));
+
+    struct Match
+    {
+        mrpt::math::TPoint3Df globalPt;
+        float                 sqrDist;
+        uint64_t              id;
+    };
+    std::array<Match, MAX_KNN> matches;  // sorted by sqrDist!
+    size_t                     foundMatches = 0;
+
+    auto lambdaProcessCandidate =
+        [&](const float sqrDist, const mrpt::math::TPoint3Df& pt,
+            const HashedVoxelPointCloud::global_plain_index_t& id)
+    {
+        size_t i = 0;
+        for (i = 0; i < foundMatches; i++)
+        {
+            if (sqrDist < matches[i].sqrDist) break;
+        }
+        if (i >= MAX_KNN) return;
+
+        const size_t last = std::min(foundMatches + 1, MAX_KNN);
+        for (size_t j = i + 1; j < last; j++) matches[j] = matches[j - 1];
+
+        matches[i].globalPt = pt;
+        matches[i].id       = id;
+        matches[i].sqrDist  = sqrDist;
+
+        if (foundMatches < MAX_KNN) foundMatches++;
+    };
+
+    auto lambdaCheckCell = [&](const global_index3d_t& p)
+    {
+        if (auto* v = parent_.voxelByGlobalIdxs(p); v && !v->points().empty())
+        {
+            const auto&  pts = v->points();
+            const size_t n   = pts.size();
+
+            alignas(32)
+                float distsSqr[HashedVoxelPointCloud::SSO_MAX_POINTS_PER_VOXEL];
+            soaSqrDistances(pts.xs(), pts.ys(), pts.zs(), n, query, distsSqr);
+
+            for (size_t i = 0; i < n; i++)
+                lambdaProcessCandidate(
+                    distsSqr[i], pts[i], HashedVoxelPointCloud::g2plain(p, i));
+        }
+    };
+
+    for (int32_t cx = idxs0.cx; cx <= idxs1.cx; cx++)
+        for (int32_t cy = idxs0.cy; cy <= idxs1.cy; cy++)
+            for (int32_t cz = idxs0.cz; cz <= idxs1.cz; cz++)
+                lambdaCheckCell({cx, cy, cz});
+
+    for (size_t i = 0; i < std::min<size_t>(N, foundMatches); i++)
+    {
+        const auto& m = matches[i];
+
+        out_dists_sqr.push_back(m.sqrDist);
+        results.push_back(m.globalPt);
+        resultIndicesOrIDs.push_back(m.id);
+    }
+}
+
+void HashedVoxelPointCloudSubmapView::nn_radius_search(
+    const mrpt::math::TPoint3Df& query, const float search_radius_sqr,
+    std::vector<mrpt::math::TPoint3Df>& results,
+    std::vector<float>&                 out_dists_sqr,
+    std::vector<uint64_t>& resultIndicesOrIDs, size_t maxPoints) const
+{
+    results.clear();
+    out_dists_sqr.clear();
+    resultIndicesOrIDs.clear();
+
+    if (search_radius_sqr <= 0) return;
+
+    const float radius   = std::sqrt(search_radius_sqr);
+    const auto  diagonal = mrpt::math::TPoint3Df(1.0f, 1.0f, 1.0f) * radius;
+
+    // Same sweep as the parent's, clamped to the view range:
+    const auto i0 = parent_.coordToGlobalIdx(query - diagonal);
+    const auto i1 = parent_.coordToGlobalIdx(query + diagonal);
+
+    const global_index3d_t idxs0(
+        std::max(i0.cx, idxMin_.cx), std::max(i0.cy, idxMin_.cy),
+        std::max(i0.cz, idxMin_.cz));
+    const global_index3d_t idxs1(
+        std::min(i1.cx, idxMax_.cx), std::min(i1.cy, idxMax_.cy),
+        std::min(i1.cz, idxMax_.cz));
+
+    struct Match
+    {
+        mrpt::math::TPoint3Df globalPt;
+        float                 sqrDist;
+        uint64_t              id;
+    };
+    std::array<Match, HARD_MAX_MATCHES> matches;  // sorted by sqrDist!
+    size_t                              foundMatches = 0;
+
+    auto lambdaProcessCandidate =
+        [&](const float sqrDist, const mrpt::math::TPoint3Df& pt,
+            const HashedVoxelPointCloud::global_plain_index_t& id)
+    {
+        size_t i = 0;
+        for (i = 0; i < foundMatches; i++)
+        {
+            if (sqrDist < matches[i].sqrDist) break;
+        }
+        if (i >= HARD_MAX_MATCHES) return;
+
+        const size_t last = std::min(foundMatches + 1, HARD_MAX_MATCHES);
+        for (size_t j = i + 1; j < last; j++) matches[j] = matches[j - 1];
+
+        matches[i].globalPt = pt;
+        matches[i].id       = id;
+        matches[i].sqrDist  = sqrDist;
+
+        if (foundMatches < HARD_MAX_MATCHES) foundMatches++;
+    };
+
+    auto lambdaCheckCell = [&](const global_index3d_t& p)
+    {
+        if (auto* v = parent_.voxelByGlobalIdxs(p); v && !v->points().empty())
+        {
+            const auto&  pts = v->points();
+            const size_t n   = pts.size();
+
+            alignas(32)
+                float distsSqr[HashedVoxelPointCloud::SSO_MAX_POINTS_PER_VOXEL];
+            soaSqrDistances(pts.xs(), pts.ys(), pts.zs(), n, query, distsSqr);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                const float distSqr = distsSqr[i];
+                if (distSqr > search_radius_sqr) continue;
+
+                const auto id = HashedVoxelPointCloud::g2plain(p, i);
+
+                if (maxPoints != 0)
+                {
+                    // temporary list:
+                    lambdaProcessCandidate(distSqr, pts[i], id);
                 }
                 else
                 {
                     // directly save output:
                     out_dists_sqr.push_back(distSqr);
-                    results.push_back(pt);
+                    results.push_back(pts[i]);
                     resultIndicesOrIDs.push_back(id);
                 }
             }
@@ -900,6 +1909,9 @@ mrpt::math::TBoundingBoxf HashedVoxelPointCloud::boundingBox() const
 
             this->visitAllVoxels(lambdaForEachVoxel);
         }
+
+        // freshly recomputed: restart the shrinkage accounting
+        cached_.erasedVoxelsSinceBBox = 0;
     }
 
     return cached_.boundingBox_.value();
@@ -908,10 +1920,13 @@ mrpt::math::TBoundingBoxf HashedVoxelPointCloud::boundingBox() const
 void HashedVoxelPointCloud::visitAllPoints(
     const std::function<void(const mrpt::math::TPoint3Df&)>& f) const
 {
-    for (const auto& [idx, v] : voxels_)
+    for (const auto& shard : voxels_)
     {
-        const auto& pts = v.points();
-        for (size_t i = 0; i < pts.size(); i++) f(pts[i]);
+        for (const auto& [idx, v] : shard)
+        {
+            const auto& pts = v.points();
+            for (size_t i = 0; i < pts.size(); i++) f(pts[i]);
+        }
     }
 }
 
@@ -919,17 +1934,53 @@ void HashedVoxelPointCloud::visitAllVoxels(
     const std::function<void(const global_index3d_t&, const VoxelData&)>& f)
     const
 {
-    for (const auto& [idx, v] : voxels_) f(idx, v);
+    for (const auto& shard : voxels_)
+        for (const auto& [idx, v] : shard) f(idx, v);
+}
+
+void HashedVoxelPointCloud::visitAllPointsParallel(
+    const std::function<void(const mrpt::math::TPoint3Df&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    visitAllVoxelsParallel(
+        [&f](const global_index3d_t&, const VoxelData& v,
+             const unsigned int workerIdx)
+        {
+            const auto& pts = v.points();
+            for (size_t i = 0; i < pts.size(); i++) f(pts[i], workerIdx);
+        },
+        numThreads);
+}
+
+void HashedVoxelPointCloud::visitAllVoxelsParallel(
+    const std::function<
+        void(const global_index3d_t&, const VoxelData&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    // Flat snapshot of voxel addresses (stable while the map is unmodified):
+    std::size_t total = 0;
+    for (const auto& shard : voxels_) total += shard.size();
+
+    std::vector<const grids_map_t::value_type*> entries;
+    entries.reserve(total);
+    for (const auto& shard : voxels_)
+        for (const auto& kv : shard) entries.push_back(&kv);
+
+    internal::parallel_visit(
+        entries.size(), numThreads,
+        [&](const unsigned int workerIdx, const std::size_t i)
+        { f(entries[i]->first, entries[i]->second, workerIdx); });
 }
 
 // ========== Option structures ==========
 void HashedVoxelPointCloud::TInsertionOptions::writeToStream(
     mrpt::serialization::CArchive& out) const
 {
-    const int8_t version = 0;
+    const int8_t version = 1;
     out << version;
     out << max_points_per_voxel << remove_voxels_farther_than
         << min_distance_between_points;
+    out << eviction_shards_per_insertion;  // v1
 }
 
 void HashedVoxelPointCloud::TInsertionOptions::readFromStream(
@@ -940,9 +1991,11 @@ void HashedVoxelPointCloud::TInsertionOptions::readFromStream(
     switch (version)
     {
         case 0:
+        case 1:
         {
             in >> max_points_per_voxel >> remove_voxels_farther_than >>
                 min_distance_between_points;
+            if (version >= 1) in >> eviction_shards_per_insertion;
         }
         break;
         default:
@@ -1013,6 +2066,7 @@ void HashedVoxelPointCloud::TInsertionOptions::dumpToTextStream(
     LOADABLEOPTS_DUMP_VAR(max_points_per_voxel, int);
     LOADABLEOPTS_DUMP_VAR(remove_voxels_farther_than, double);
     LOADABLEOPTS_DUMP_VAR(min_distance_between_points, float)
+    LOADABLEOPTS_DUMP_VAR(eviction_shards_per_insertion, int);
 }
 
 void HashedVoxelPointCloud::TLikelihoodOptions::dumpToTextStream(
@@ -1045,6 +2099,7 @@ void HashedVoxelPointCloud::TInsertionOptions::loadFromConfigFile(
     MRPT_LOAD_CONFIG_VAR(max_points_per_voxel, int, c, s);
     MRPT_LOAD_CONFIG_VAR(remove_voxels_farther_than, double, c, s);
     MRPT_LOAD_CONFIG_VAR(min_distance_between_points, float, c, s);
+    MRPT_LOAD_CONFIG_VAR(eviction_shards_per_insertion, int, c, s);
 }
 
 void HashedVoxelPointCloud::TLikelihoodOptions::loadFromConfigFile(
@@ -1072,15 +2127,15 @@ void HashedVoxelPointCloud::internal_insertPointCloud3D(
 {
     MRPT_TRY_START
 
-    voxels_.reserve(voxels_.size() + num_pts);
-
+    // Transform the points from the scan reference to their global 3D
+    // position, then insert them all at once (see insertPoints() for the
+    // batched, vectorized insertion path):
+    thread_local std::vector<mrpt::math::TPoint3Df> gPts;
+    gPts.resize(num_pts);
     for (std::size_t i = 0; i < num_pts; i++)
-    {
-        // Transform the point from the scan reference to its global 3D
-        // position:
-        const auto gPt = pc_in_map.composePoint({xs[i], ys[i], zs[i]});
-        insertPoint(gPt);
-    }
+        gPts[i] = pc_in_map.composePoint({xs[i], ys[i], zs[i]});
+
+    insertPoints(gPts.data(), gPts.size());
 
     MRPT_TRY_END
 }
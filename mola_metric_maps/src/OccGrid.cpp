@@ -20,49 +20,258 @@
 
 /**
  * @file   OccGrid.cpp
- * @brief  Class extending MRPT occupancy grid with additional functionalities
+ * @brief  Tiled occupancy grid with super-resolution likelihood field
  * @author Jose Luis Blanco Claraco
  * @date   Feb 21, 2021
  */
 
 #include <mola_metric_maps/OccGrid.h>
+#include <mrpt/core/bits_math.h>  // keep_min()
+#include <mrpt/maps/COccupancyGridMap2D.h>  // only for reading old files
+#include <mrpt/poses/CPose2D.h>
+#include <mrpt/poses/CPose3D.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 using namespace mola;
 
 IMPLEMENTS_SERIALIZABLE(OccGrid, CSerializable, mola)
 
-OccGrid::OccGrid()
+namespace
+{
+/** Log-odds of the freeness probability `p` (MRPT convention: 1=free) */
+float prob2logodds(float p)
+{
+    p = std::clamp(p, 1e-4f, 1.0f - 1e-4f);
+    return std::log(p / (1.0f - p));
+}
+float logodds2prob(float l) { return 1.0f / (1.0f + std::exp(-l)); }
+
+/** Bresenham sweep over the global cells between two end points, invoking
+ * f(x,y) for every cell except the end point itself. */
+template <class CellFn>
+void bresenhamRay(
+    int32_t gx0, int32_t gy0, int32_t gx1, int32_t gy1, CellFn&& f)
+{
+    const int32_t dx = std::abs(gx1 - gx0), sx = gx0 < gx1 ? 1 : -1;
+    const int32_t dy = -std::abs(gy1 - gy0), sy = gy0 < gy1 ? 1 : -1;
+
+    int32_t err = dx + dy;
+    int32_t x = gx0, y = gy0;
+
+    while (x != gx1 || y != gy1)
+    {
+        f(x, y);
+        const int32_t e2 = 2 * err;
+        if (e2 >= dy)
+        {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx)
+        {
+            err += dx;
+            y += sy;
+        }
+    }
+}
+
+/** dst[i] = clamp(dst[i] + inc[i], -maxAbs, maxAbs), 8 cells per iteration
+ * with AVX2. Used to merge the per-thread staging buffers of the parallel
+ * insertion path. */
+void saturatingAdd(
+    float* dst, const float* inc, const std::size_t n, const float maxAbs)
+{
+    std::size_t i = 0;
+#if defined(__AVX2__)
+    const __m256 vMax = _mm256_set1_ps(maxAbs);
+    const __m256 vMin = _mm256_set1_ps(-maxAbs);
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256 v = _mm256_add_ps(
+            _mm256_loadu_ps(dst + i), _mm256_loadu_ps(inc + i));
+        v = _mm256_min_ps(_mm256_max_ps(v, vMin), vMax);
+        _mm256_storeu_ps(dst + i, v);
+    }
+#endif
+    for (; i < n; i++) dst[i] = std::clamp(dst[i] + inc[i], -maxAbs, maxAbs);
+}
+}  // namespace
+
+OccGrid::OccGrid() = default;
+
+OccGrid::OccGrid(const OccGrid& o) { *this = o; }
+
+OccGrid& OccGrid::operator=(const OccGrid& o)
+{
+    insertionParameters_  = o.insertionParameters_;
+    likelihoodParameters_ = o.likelihoodParameters_;
+    resolution_           = o.resolution_;
+    tiles_                = o.tiles_;
+    // prewarmPool_ belongs to each instance; created on first use.
+    return *this;
+}
+
+// =====================================
+// Cell & tile indexing
+// =====================================
+int32_t OccGrid::coordToCell(float v) const
 {
-    // reset:
-    resetLikelihoodCache();
+    return static_cast<int32_t>(std::floor(v / resolution_));
+}
+
+int32_t OccGrid::cellToTile(int32_t g) noexcept
+{
+    // floor division (g may be negative):
+    constexpr int32_t T = static_cast<int32_t>(TILE_CELLS);
+    return (g >= 0) ? (g / T) : (-1 - ((-1 - g) / T));
+}
+
+uint32_t OccGrid::cellWithinTile(int32_t g) noexcept
+{
+    constexpr int32_t T = static_cast<int32_t>(TILE_CELLS);
+    return static_cast<uint32_t>(g - cellToTile(g) * T);
+}
+
+const OccGrid::Tile* OccGrid::tileOfCell(int32_t gx, int32_t gy) const
+{
+    const auto it = tiles_.find({cellToTile(gx), cellToTile(gy), 0});
+    return it != tiles_.end() ? &it->second : nullptr;
 }
 
 // =====================================
 // Serialization
 // =====================================
 
-uint8_t OccGrid::serializeGetVersion() const { return 0; }
+namespace
+{
+/** Run-length encodes a tile's cell array: sparse floorplans are mostly
+ * uniform runs of unknown (or fill-value) cells, which collapse to a
+ * handful of (length, value) pairs. */
+void rleEncodeTile(
+    mrpt::serialization::CArchive& out, const std::vector<float>& cells)
+{
+    thread_local std::vector<std::pair<uint32_t, float>> runs;
+    runs.clear();
+    for (const float v : cells)
+    {
+        if (!runs.empty() && runs.back().second == v)
+            runs.back().first++;
+        else
+            runs.emplace_back(1u, v);
+    }
+    out << static_cast<uint32_t>(runs.size());
+    for (const auto& [len, v] : runs) out << len << v;
+}
+
+void rleDecodeTile(
+    mrpt::serialization::CArchive& in, std::vector<float>& cells,
+    const std::size_t expectedCells)
+{
+    cells.clear();
+    cells.reserve(expectedCells);
+
+    uint32_t nRuns = 0;
+    in >> nRuns;
+    for (uint32_t r = 0; r < nRuns; r++)
+    {
+        uint32_t len = 0;
+        float    v   = 0;
+        in >> len >> v;
+        ASSERT_LE_(cells.size() + len, expectedCells);
+        cells.insert(cells.end(), len, v);
+    }
+    ASSERT_EQUAL_(cells.size(), expectedCells);
+}
+}  // namespace
+
+uint8_t OccGrid::serializeGetVersion() const { return 2; }
 void    OccGrid::serializeTo(mrpt::serialization::CArchive& out) const
 {
-    // The data
-    out << grid_;
+    out << resolution_;
+    out << static_cast<uint32_t>(tiles_.size());
+    for (const auto& [idx, t] : tiles_)
+    {
+        out << idx.cx << idx.cy;
+        rleEncodeTile(out, t.logodds);
+    }
 }
 void OccGrid::serializeFrom(mrpt::serialization::CArchive& in, uint8_t version)
 {
+    tiles_.clear();
+
     switch (version)
     {
         case 0:
         {
-            in >> grid_;
+            // Old monolithic single-grid layout: import into tiles.
+            mrpt::maps::COccupancyGridMap2D oldGrid;
+            in >> oldGrid;
+
+            resolution_ = oldGrid.getResolution();
+            for (unsigned int cy = 0; cy < oldGrid.getSizeY(); cy++)
+            {
+                for (unsigned int cx = 0; cx < oldGrid.getSizeX(); cx++)
+                {
+                    const float p = oldGrid.getCell(cx, cy);
+                    if (p == 0.5f) continue;  // unknown: implicit in tiles
+
+                    const int32_t gx = coordToCell(oldGrid.idx2x(cx));
+                    const int32_t gy = coordToCell(oldGrid.idx2y(cy));
+
+                    auto& t = tiles_[{cellToTile(gx), cellToTile(gy), 0}];
+                    if (t.logodds.empty())
+                        t.logodds.assign(TILE_CELLS * TILE_CELLS, .0f);
+                    t.logodds
+                        [cellWithinTile(gy) * TILE_CELLS + cellWithinTile(gx)] =
+                        prob2logodds(p);
+                }
+            }
+        }
+        break;
+        case 1:
+        {
+            // Raw (non-RLE) tile cell arrays:
+            in >> resolution_;
+            uint32_t nTiles = 0;
+            in >> nTiles;
+            for (uint32_t i = 0; i < nTiles; i++)
+            {
+                tile_index_t idx;
+                in >> idx.cx >> idx.cy;
+                auto& t = tiles_[idx];
+                t.logodds.resize(TILE_CELLS * TILE_CELLS);
+                in.ReadBufferFixEndianness(t.logodds.data(), t.logodds.size());
+            }
+        }
+        break;
+        case 2:
+        {
+            in >> resolution_;
+            uint32_t nTiles = 0;
+            in >> nTiles;
+            for (uint32_t i = 0; i < nTiles; i++)
+            {
+                tile_index_t idx;
+                in >> idx.cx >> idx.cy;
+                rleDecodeTile(
+                    in, tiles_[idx].logodds, TILE_CELLS * TILE_CELLS);
+            }
         }
         break;
         default:
             MRPT_THROW_UNKNOWN_SERIALIZATION_VERSION(version);
     };
-
-    // cache reset
-    resetLikelihoodCache();
 }
 
 // =====================================
@@ -74,60 +283,530 @@ void OccGrid::setSize(
     const mrpt::math::TPoint2Df& maxCorner, float resolution,
     float occupancyValue)
 {
-    grid_.setSize(
-        minCorner.x, maxCorner.x, minCorner.y, maxCorner.y, resolution,
-        occupancyValue);
+    ASSERT_GT_(resolution, .0f);
 
-    resetLikelihoodCache();
+    tiles_.clear();
+    resolution_ = resolution;
+    ensureTilesCover(minCorner, maxCorner, occupancyValue);
 }
 
 void OccGrid::resizeGrid(
     const mrpt::math::TPoint2Df& minCorner,
     const mrpt::math::TPoint2Df& maxCorner, float newCellsOccupancy) noexcept
 {
-    grid_.resizeGrid(
-        minCorner.x, maxCorner.x, minCorner.y, maxCorner.y, newCellsOccupancy);
+    // Only the missing tiles are allocated; nothing is copied.
+    ensureTilesCover(minCorner, maxCorner, newCellsOccupancy);
+}
 
-    const auto defValue = CACHE_MISS_VALUE;
-    likelihoodCacheGrid_.resize(
-        grid_.getXMin(), grid_.getXMax(), grid_.getYMin(), grid_.getYMax(),
-        defValue, 0.5 /* extra margin [meters] */);
+void OccGrid::ensureTilesCover(
+    const mrpt::math::TPoint2Df& minCorner,
+    const mrpt::math::TPoint2Df& maxCorner, float occupancyValue)
+{
+    const int32_t tx0 = cellToTile(coordToCell(minCorner.x));
+    const int32_t tx1 = cellToTile(coordToCell(maxCorner.x));
+    const int32_t ty0 = cellToTile(coordToCell(minCorner.y));
+    const int32_t ty1 = cellToTile(coordToCell(maxCorner.y));
+
+    const float l0 = prob2logodds(occupancyValue);
+
+    for (int32_t ty = ty0; ty <= ty1; ty++)
+    {
+        for (int32_t tx = tx0; tx <= tx1; tx++)
+        {
+            const auto [it, isNew] = tiles_.try_emplace({tx, ty, 0});
+            if (isNew) it->second.logodds.assign(TILE_CELLS * TILE_CELLS, l0);
+        }
+    }
 }
 
 // =====================================
 //   Read and update API
 // =====================================
+float OccGrid::occupancyAtPos(float x, float y) const
+{
+    const Tile* t = tileOfCell(coordToCell(x), coordToCell(y));
+    if (!t) return 0.5f;
+
+    const float l = t->logodds
+        [cellWithinTile(coordToCell(y)) * TILE_CELLS +
+         cellWithinTile(coordToCell(x))];
+    return logodds2prob(l);
+}
+
+void OccGrid::visitAllTiles(
+    const std::function<void(
+        const tile_index_t&, const mrpt::math::TPoint2Df&, const Tile&)>&
+        visitor) const
+{
+    const float span = TILE_CELLS * resolution_;
+    for (const auto& [idx, t] : tiles_)
+        visitor(idx, {idx.cx * span, idx.cy * span}, t);
+}
+
+void OccGrid::updateCell(int32_t gx, int32_t gy, float logoddsInc)
+{
+    auto& t = tiles_[{cellToTile(gx), cellToTile(gy), 0}];
+    if (t.logodds.empty()) t.logodds.assign(TILE_CELLS * TILE_CELLS, .0f);
+
+    auto& l = t.logodds[cellWithinTile(gy) * TILE_CELLS + cellWithinTile(gx)];
+    l       = std::clamp(l + logoddsInc, -LOGODDS_MAX, LOGODDS_MAX);
+}
+
+void OccGrid::markFreeRay(
+    int32_t gx0, int32_t gy0, int32_t gx1, int32_t gy1, float lFree)
+{
+    // Bresenham over global cells; the end point cell itself is left for
+    // the (possible) occupied update by the caller.
+    bresenhamRay(
+        gx0, gy0, gx1, gy1,
+        [this, lFree](int32_t x, int32_t y) { updateCell(x, y, lFree); });
+}
+
 void OccGrid::insertObservation(
     const mrpt::obs::CObservation2DRangeScan& obs,
     const mrpt::math::TPose2D&                robotPose)
 {
-    // Update the grid:
-    auto&       gio = grid_.insertionOptions;
-    const auto& ip  = insertionParameters_;
+    const auto& ip = insertionParameters_;
+
+    const size_t n = obs.getScanSize();
+    if (n == 0) return;
+
+    const auto sensorGlobalPose = mrpt::poses::CPose2D(
+        mrpt::poses::CPose3D(robotPose) + obs.sensorPose);
+
+    const double sx  = sensorGlobalPose.x();
+    const double sy  = sensorGlobalPose.y();
+    const double phi = sensorGlobalPose.phi();
+
+    const double sense = obs.rightToLeft ? 1.0 : -1.0;
+    const double dA    = n > 1 ? sense * obs.aperture / (n - 1) : 0;
+    const double A0    = phi - sense * 0.5 * obs.aperture;
+
+    // Update certainties -> per-cell log-odds increments (freeness):
+    const float certOcc  = ip.maxOccupancyUpdateCertainty;
+    const float certFree = ip.maxFreenessUpdateCertainty > 0.5f
+                               ? ip.maxFreenessUpdateCertainty
+                               : certOcc;
+    const float certFreeInv =
+        ip.maxFreenessInvalidRanges > 0.5f ? ip.maxFreenessInvalidRanges
+                                           : certFree;
+
+    const float lOccInc     = -prob2logodds(certOcc);
+    const float lFreeInc    = prob2logodds(certFree);
+    const float lFreeInvInc = prob2logodds(certFreeInv);
 
-    gio.maxDistanceInsertion        = insertionParameters_.maxDistanceInsertion;
-    gio.maxOccupancyUpdateCertainty = ip.maxOccupancyUpdateCertainty;
-    gio.maxFreenessUpdateCertainty  = ip.maxFreenessUpdateCertainty;
-    gio.maxFreenessInvalidRanges    = ip.maxFreenessInvalidRanges;
-    gio.decimation                  = ip.decimation;
-    gio.wideningBeamsWithDistance   = ip.wideningBeamsWithDistance;
-    gio.considerInvalidRangesAsFreeSpace = ip.considerInvalidRangesAsFreeSpace;
+    const int32_t gsx = coordToCell(static_cast<float>(sx));
+    const int32_t gsy = coordToCell(static_cast<float>(sy));
 
-    const auto p = mrpt::poses::CPose3D(robotPose);
-    grid_.insertObservation(obs, p);
+    const unsigned int decim =
+        std::max<unsigned int>(1, ip.decimation);
+
+    float maxRangeUsed = 0;
+
+    // 1) Project the decimated, validated beams once:
+    struct Beam
+    {
+        int32_t gex, gey;
+        float   lFree;
+        bool    hit;
+    };
+    thread_local std::vector<Beam> beams;
+    beams.clear();
+    beams.reserve(n / decim + 1);
+
+    for (size_t i = 0; i < n; i += decim)
+    {
+        const bool valid = obs.getScanRangeValidity(i);
+
+        double r;
+        float  lFree;
+        bool   hit;
+        if (valid)
+        {
+            r     = obs.getScanRange(i);
+            hit   = r < ip.maxDistanceInsertion;
+            r     = std::min<double>(r, ip.maxDistanceInsertion);
+            lFree = lFreeInc;
+        }
+        else
+        {
+            if (!ip.considerInvalidRangesAsFreeSpace) continue;
+            // Only when the neighbor rays are also invalid (spurious no-echo
+            // readings next to real echos are ignored):
+            if (i > 0 && obs.getScanRangeValidity(i - 1)) continue;
+            if (i + 1 < n && obs.getScanRangeValidity(i + 1)) continue;
+
+            r     = std::min<double>(obs.maxRange, ip.maxDistanceInsertion);
+            hit   = false;
+            lFree = lFreeInvInc;
+        }
+        if (r <= 0) continue;
 
-    // Enqueue areas as pending of likelihood recalculation:
-    // TODO;
+        const double a  = A0 + i * dA;
+        const float  ex = static_cast<float>(sx + r * std::cos(a));
+        const float  ey = static_cast<float>(sy + r * std::sin(a));
+
+        beams.push_back({coordToCell(ex), coordToCell(ey), lFree, hit});
+
+        mrpt::keep_max(maxRangeUsed, static_cast<float>(r));
+    }
+
+    // Not worth spawning threads for short scans:
+    constexpr size_t MIN_BEAMS_PER_THREAD = 64;
+
+    size_t nThreads = ip.insertion_threads != 0
+                          ? ip.insertion_threads
+                          : std::thread::hardware_concurrency();
+    nThreads = std::min(
+        nThreads, std::max<size_t>(1, beams.size() / MIN_BEAMS_PER_THREAD));
+
+    if (nThreads <= 1)
+    {
+        // 2a) Classic sequential tracing:
+        for (const auto& b : beams)
+        {
+            markFreeRay(gsx, gsy, b.gex, b.gey, b.lFree);
+            if (b.hit) updateCell(b.gex, b.gey, lOccInc);
+        }
+    }
+    else
+    {
+        // 2b) Parallel staged tracing: each thread traces its contiguous
+        // range of beams into its own tile-local increment buffers, never
+        // touching the shared tile hash map:
+        using staging_map_t = std::unordered_map<
+            tile_index_t, std::vector<float>, index3d_hash<int32_t>>;
+
+        std::vector<staging_map_t> staging(nThreads);
+
+        const auto lambdaWorker =
+            [&](const size_t tIdx, const size_t i0, const size_t i1)
+        {
+            auto& stage = staging[tIdx];
+
+            // One-entry memo: consecutive ray cells share the tile most
+            // of the time.
+            tile_index_t        lastIdx{INT32_MIN, INT32_MIN, 0};
+            std::vector<float>* lastBlock = nullptr;
+
+            const auto addCell = [&](int32_t gx, int32_t gy, float inc)
+            {
+                const tile_index_t idx{cellToTile(gx), cellToTile(gy), 0};
+                if (idx != lastIdx)
+                {
+                    lastIdx     = idx;
+                    auto& block = stage[idx];
+                    if (block.empty())
+                        block.assign(TILE_CELLS * TILE_CELLS, .0f);
+                    lastBlock = &block;
+                }
+                (*lastBlock)
+                    [cellWithinTile(gy) * TILE_CELLS + cellWithinTile(gx)] +=
+                    inc;
+            };
+
+            for (size_t i = i0; i < i1; i++)
+            {
+                const auto& b = beams[i];
+                bresenhamRay(
+                    gsx, gsy, b.gex, b.gey, [&](int32_t x, int32_t y)
+                    { addCell(x, y, b.lFree); });
+                if (b.hit) addCell(b.gex, b.gey, lOccInc);
+            }
+        };
+
+        const size_t chunk = (beams.size() + nThreads - 1) / nThreads;
+
+        std::vector<std::thread> workers;
+        workers.reserve(nThreads);
+        for (size_t t = 0; t < nThreads; t++)
+            workers.emplace_back(
+                lambdaWorker, t, t * chunk,
+                std::min(beams.size(), (t + 1) * chunk));
+        for (auto& w : workers) w.join();
+
+        // 3) Merge the staged increments, in fixed thread order so the
+        // result does not depend on scheduling:
+        for (const auto& stage : staging)
+        {
+            for (const auto& [idx, block] : stage)
+            {
+                auto& t = tiles_[idx];
+                if (t.logodds.empty())
+                    t.logodds.assign(TILE_CELLS * TILE_CELLS, .0f);
+
+                saturatingAdd(
+                    t.logodds.data(), block.data(), TILE_CELLS * TILE_CELLS,
+                    LOGODDS_MAX);
+            }
+        }
+    }
+
+    // Invalidate the cached likelihood values of the updated area only:
+    // the scan can only touch cells within maxRangeUsed of the sensor,
+    // so drop that bounding box instead of the whole cache.
+    const float fsx = static_cast<float>(sx), fsy = static_cast<float>(sy);
+    resetLikelihoodCache(
+        {fsx - maxRangeUsed, fsy - maxRangeUsed},
+        {fsx + maxRangeUsed, fsy + maxRangeUsed});
 }
 
 // =====================================
 // Likelihood API
 // =====================================
-void OccGrid::resetLikelihoodCache()
+void OccGrid::ensureLikCache(const tile_index_t& idx, Tile& t) const
 {
+    if (t.likCache.getSizeX() != 0) return;
+
+    const float span = TILE_CELLS * resolution_;
+    const float x0 = idx.cx * span, y0 = idx.cy * span;
+
     const auto defValue = CACHE_MISS_VALUE;
-    likelihoodCacheGrid_.setSize(
-        grid_.getXMin(), grid_.getXMax(), grid_.getYMin(), grid_.getYMax(),
-        grid_.getResolution() * likelihoodParameters_.superResolutionFactor,
-        &defValue);
+    t.likCache.setSize(
+        x0, x0 + span, y0, y0 + span,
+        resolution_ * likelihoodParameters_.superResolutionFactor, &defValue);
+}
+
+void OccGrid::resetLikelihoodCache()
+{
+    for (auto& [idx, t] : tiles_)
+        if (t.likCache.getSizeX() != 0) t.likCache.fill(CACHE_MISS_VALUE);
+}
+
+void OccGrid::resetLikelihoodCache(
+    const mrpt::math::TPoint2Df& minCorner,
+    const mrpt::math::TPoint2Df& maxCorner)
+{
+    // The cached value of a cell depends on occupied cells up to
+    // maxCorrDistance away, so grow the dirty region accordingly:
+    const float pad = likelihoodParameters_.maxCorrDistance;
+
+    const mrpt::math::TPoint2Df rMin{minCorner.x - pad, minCorner.y - pad};
+    const mrpt::math::TPoint2Df rMax{maxCorner.x + pad, maxCorner.y + pad};
+
+    const int32_t tx0 = cellToTile(coordToCell(rMin.x));
+    const int32_t tx1 = cellToTile(coordToCell(rMax.x));
+    const int32_t ty0 = cellToTile(coordToCell(rMin.y));
+    const int32_t ty1 = cellToTile(coordToCell(rMax.y));
+
+    for (int32_t ty = ty0; ty <= ty1; ty++)
+    {
+        for (int32_t tx = tx0; tx <= tx1; tx++)
+        {
+            const auto it = tiles_.find({tx, ty, 0});
+            if (it == tiles_.end()) continue;
+            auto& g = it->second.likCache;
+            if (g.getSizeX() == 0) continue;  // nothing cached yet
+
+            const int cxMin = std::max(0, g.x2idx(rMin.x));
+            const int cxMax = std::min<int>(g.getSizeX() - 1, g.x2idx(rMax.x));
+            const int cyMin = std::max(0, g.y2idx(rMin.y));
+            const int cyMax = std::min<int>(g.getSizeY() - 1, g.y2idx(rMax.y));
+
+            for (int cy = cyMin; cy <= cyMax; cy++)
+                for (int cx = cxMin; cx <= cxMax; cx++)
+                    *g.cellByIndex(cx, cy) = CACHE_MISS_VALUE;
+        }
+    }
+}
+
+void OccGrid::prewarmLikelihoodCache(
+    const mrpt::math::TPoint2Df& minCorner,
+    const mrpt::math::TPoint2Df& maxCorner)
+{
+    const int32_t tx0 = cellToTile(coordToCell(minCorner.x));
+    const int32_t tx1 = cellToTile(coordToCell(maxCorner.x));
+    const int32_t ty0 = cellToTile(coordToCell(minCorner.y));
+    const int32_t ty1 = cellToTile(coordToCell(maxCorner.y));
+
+    for (int32_t ty = ty0; ty <= ty1; ty++)
+    {
+        for (int32_t tx = tx0; tx <= tx1; tx++)
+        {
+            const tile_index_t idx{tx, ty, 0};
+
+            const auto it = tiles_.find(idx);
+            if (it == tiles_.end()) continue;
+            ensureLikCache(idx, it->second);
+
+            auto& g = it->second.likCache;
+
+            const int cxMin = std::max(0, g.x2idx(minCorner.x));
+            const int cxMax =
+                std::min<int>(g.getSizeX() - 1, g.x2idx(maxCorner.x));
+            const int cyMin = std::max(0, g.y2idx(minCorner.y));
+            const int cyMax =
+                std::min<int>(g.getSizeY() - 1, g.y2idx(maxCorner.y));
+
+            for (int cy = cyMin; cy <= cyMax; cy++)
+            {
+                for (int cx = cxMin; cx <= cxMax; cx++)
+                {
+                    float* c = g.cellByIndex(cx, cy);
+                    if (*c != CACHE_MISS_VALUE) continue;
+                    *c = computeMissLikelihood(
+                        static_cast<float>(g.idx2x(cx)),
+                        static_cast<float>(g.idx2y(cy)));
+                }
+            }
+        }
+    }
+}
+
+void OccGrid::prewarmLikelihoodCacheAsync(
+    const mrpt::math::TPoint2Df& minCorner,
+    const mrpt::math::TPoint2Df& maxCorner)
+{
+    if (!prewarmPool_)
+        prewarmPool_ = std::make_unique<mrpt::WorkerThreadsPool>(
+            1 /*threads*/, mrpt::WorkerThreadsPool::POLICY_DROP_OLD,
+            "occgrid_prewarm");
+
+    prewarmPool_->enqueue([this, minCorner, maxCorner]()
+                          { prewarmLikelihoodCache(minCorner, maxCorner); });
+}
+
+double OccGrid::likelihoodOf(
+    const mrpt::obs::CObservation2DRangeScan& obs,
+    const mrpt::math::TPose2D&                robotPose)
+{
+    MRPT_TRY_START
+
+    const size_t n = obs.getScanSize();
+    if (n == 0) return .0;
+
+    const auto sensorGlobalPose =
+        mrpt::poses::CPose2D(mrpt::poses::CPose3D(robotPose) + obs.sensorPose);
+
+    const double sx  = sensorGlobalPose.x();
+    const double sy  = sensorGlobalPose.y();
+    const double phi = sensorGlobalPose.phi();
+
+    // 1) Project all valid beam end points in one pass. Beams are angularly
+    //    ordered, so consecutive end points land in nearby cache cells:
+    const double sense = obs.rightToLeft ? 1.0 : -1.0;
+    const double dA    = n > 1 ? sense * obs.aperture / (n - 1) : 0;
+    const double A0    = phi - sense * 0.5 * obs.aperture;
+
+    thread_local std::vector<float> gx, gy;
+    gx.clear();
+    gy.clear();
+    gx.reserve(n);
+    gy.reserve(n);
+
+    const unsigned int decim = std::max<unsigned int>(
+        1, likelihoodParameters_.decimation);
+
+    for (size_t i = 0; i < n; i += decim)
+    {
+        if (!obs.getScanRangeValidity(i)) continue;
+        const double r = obs.getScanRange(i);
+        const double a = A0 + i * dA;
+        gx.push_back(static_cast<float>(sx + r * std::cos(a)));
+        gy.push_back(static_cast<float>(sy + r * std::sin(a)));
+    }
+
+    // Worst-case score, also used for end points out of any allocated tile:
+    const auto& lp = likelihoodParameters_;
+    const float minLogLik =
+        -0.5f * mrpt::square(lp.maxCorrDistance) / mrpt::square(lp.sigmaHit);
+
+    // Per-tile cache lookup with a one-entry memo: consecutive beams land
+    // in the same tile most of the time.
+    tile_index_t lastIdx{INT32_MIN, INT32_MIN, 0};
+    Tile*        lastTile = nullptr;
+
+    const auto likCellByPos = [&](float x, float y) -> float*
+    {
+        const tile_index_t idx{
+            cellToTile(coordToCell(x)), cellToTile(coordToCell(y)), 0};
+        if (idx != lastIdx)
+        {
+            lastIdx       = idx;
+            const auto it = tiles_.find(idx);
+            lastTile      = it != tiles_.end() ? &it->second : nullptr;
+            if (lastTile) ensureLikCache(idx, *lastTile);
+        }
+        if (!lastTile) return nullptr;
+        return lastTile->likCache.cellByPos(x, y);
+    };
+
+    // 2) Score all end points against the super-resolution cache grids,
+    //    prefetching the next one's cache cell while the current one is
+    //    processed (cache misses fall back to the likelihood-field kernel
+    //    below, and fill the cache for subsequent evaluations):
+    double sumLogLik = 0;
+    for (size_t i = 0; i < gx.size(); i++)
+    {
+#if defined(__GNUC__)
+        if (i + 1 < gx.size())
+            if (const float* next = likCellByPos(gx[i + 1], gy[i + 1]); next)
+                __builtin_prefetch(next);
+#endif
+
+        float* c = likCellByPos(gx[i], gy[i]);
+        if (!c)
+        {
+            sumLogLik += minLogLik;
+            continue;
+        }
+        if (*c == CACHE_MISS_VALUE)
+            *c = computeMissLikelihood(gx[i], gy[i]);
+
+        sumLogLik += *c;
+    }
+
+    return sumLogLik;
+
+    MRPT_TRY_END
+}
+
+float OccGrid::computeMissLikelihood(float x, float y) const
+{
+    const auto& lp = likelihoodParameters_;
+
+    const float res = resolution_;
+    const int   W = static_cast<int>(std::ceil(lp.maxCorrDistance / res));
+
+    const int32_t cx0 = coordToCell(x), cy0 = coordToCell(y);
+
+    // Occupied iff freeness < occupiedThreshold; compare in log-odds space
+    // to avoid a per-cell exp(). The small slack keeps cells sitting exactly
+    // at the threshold (e.g. one single occupied update with certainty
+    // 1-occupiedThreshold) counted as occupied despite rounding:
+    const float lThr = prob2logodds(lp.occupiedThreshold) + 1e-4f;
+
+    tile_index_t lastIdx{INT32_MIN, INT32_MIN, 0};
+    const Tile*  lastTile = nullptr;
+
+    // Row-major window scan over the occupancy tiles for the closest
+    // occupied cell (tile rows are contiguous in memory):
+    float minDistSqr = mrpt::square(lp.maxCorrDistance);
+    for (int32_t cy = cy0 - W; cy <= cy0 + W; cy++)
+    {
+        const float dy2 = mrpt::square((cy - cy0) * res);
+        for (int32_t cx = cx0 - W; cx <= cx0 + W; cx++)
+        {
+            const tile_index_t idx{cellToTile(cx), cellToTile(cy), 0};
+            if (idx != lastIdx)
+            {
+                lastIdx       = idx;
+                const auto it = tiles_.find(idx);
+                lastTile      = it != tiles_.end() ? &it->second : nullptr;
+            }
+            if (!lastTile)
+            {
+                // whole tile is unknown space: skip to its right edge
+                cx = (idx.cx + 1) * static_cast<int32_t>(TILE_CELLS) - 1;
+                continue;
+            }
+            const float l = lastTile->logodds
+                [cellWithinTile(cy) * TILE_CELLS + cellWithinTile(cx)];
+            if (l >= lThr) continue;  // free or unknown
+            mrpt::keep_min(
+                minDistSqr, mrpt::square((cx - cx0) * res) + dy2);
+        }
+    }
+
+    return -0.5f * minDistSqr / mrpt::square(lp.sigmaHit);
 }
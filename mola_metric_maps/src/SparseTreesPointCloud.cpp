@@ -27,6 +27,7 @@
 
 #include <mola_metric_maps/SparseTreesPointCloud.h>
 #include <mrpt/config/CConfigFileBase.h>  // MRPT_LOAD_CONFIG_VAR
+#include <mrpt/core/bits_math.h>          // square()
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/math/CHistogram.h>
 #include <mrpt/math/distributions.h>  // confidenceIntervals()
@@ -39,7 +40,14 @@
 #include <mrpt/serialization/CArchive.h>  // serialization
 #include <mrpt/system/os.h>
 
+#include "serial_layout.h"
+#include "text_export.h"
+#include "visit_parallel.h"
+
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <thread>
 
 //#define USE_DEBUG_PROFILER
 
@@ -108,7 +116,7 @@ IMPLEMENTS_SERIALIZABLE(SparseTreesPointCloud, CMetricMap, mola)
 // Serialization
 // =====================================
 
-uint8_t SparseTreesPointCloud::serializeGetVersion() const { return 0; }
+uint8_t SparseTreesPointCloud::serializeGetVersion() const { return 1; }
 void    SparseTreesPointCloud::serializeTo(
     mrpt::serialization::CArchive& out) const
 {
@@ -118,13 +126,17 @@ void    SparseTreesPointCloud::serializeTo(
     likelihoodOptions.writeToStream(out);
     renderOptions.writeToStream(out);
 
-    // data:
-    out.WriteAs<uint32_t>(grids_.size());
-    for (const auto& kv : grids_)
-    {
-        out << kv.first.cx << kv.first.cy << kv.first.cz;
-        out << kv.second.points();
-    }
+    // data (v1): all points as one raw contiguous XYZ block, dumped with
+    // a single WriteBuffer() call (block structure is rebuilt on load):
+    out.WriteAs<uint8_t>(mola::internal::serial_layout_tag());
+
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
+
+    out.WriteAs<uint64_t>(xyz.size());
+    if (!xyz.empty())
+        out.WriteBuffer(
+            xyz.data(), sizeof(mrpt::math::TPoint3Df) * xyz.size());
 }
 void SparseTreesPointCloud::serializeFrom(
     mrpt::serialization::CArchive& in, uint8_t version)
@@ -132,6 +144,7 @@ void SparseTreesPointCloud::serializeFrom(
     switch (version)
     {
         case 0:
+        case 1:
         {
             // params:
             const auto expected_grid_bit_count = in.ReadAs<uint8_t>();
@@ -146,15 +159,33 @@ void SparseTreesPointCloud::serializeFrom(
             likelihoodOptions.readFromStream(in);
             renderOptions.readFromStream(in);
 
-            // data:
-            const auto nGrids = in.ReadAs<uint32_t>();
-            for (uint32_t i = 0; i < nGrids; i++)
+            if (version >= 1)
             {
-                outer_index3d_t idx;
-                in >> idx.cx >> idx.cy >> idx.cz;
-
-                auto& grid = grids_[idx];
-                in >> grid.points();
+                // data (v1): one raw XYZ block:
+                const auto layoutTag = in.ReadAs<uint8_t>();
+                ASSERT_EQUAL_(
+                    layoutTag, mola::internal::serial_layout_tag());
+
+                const auto n = in.ReadAs<uint64_t>();
+                std::vector<mrpt::math::TPoint3Df> xyz(n);
+                if (n != 0)
+                    in.ReadBuffer(
+                        xyz.data(), sizeof(mrpt::math::TPoint3Df) * n);
+
+                importFlat(xyz.data(), n);
+            }
+            else
+            {
+                // data (v0): one serialized points map per block:
+                const auto nGrids = in.ReadAs<uint32_t>();
+                for (uint32_t i = 0; i < nGrids; i++)
+                {
+                    outer_index3d_t idx;
+                    in >> idx.cx >> idx.cy >> idx.cz;
+
+                    auto& grid = grids_[idx];
+                    in >> grid.points();
+                }
             }
         }
         break;
@@ -164,6 +195,9 @@ void SparseTreesPointCloud::serializeFrom(
 
     // cache reset:
     cached_.reset();
+
+    // derived data:
+    if (!pyramid_.empty()) internal_rebuildPyramid();
 }
 
 // Ctor:
@@ -282,7 +316,12 @@ void SparseTreesPointCloud::getVisualizationInto(
     MRPT_END
 }
 
-void SparseTreesPointCloud::internal_clear() { grids_.clear(); }
+void SparseTreesPointCloud::internal_clear()
+{
+    grids_.clear();
+    // Empty the pyramid levels too, but keep their configuration:
+    for (auto& lvl : pyramid_) lvl.voxels.clear();
+}
 
 bool SparseTreesPointCloud::internal_insertObservation(
     const mrpt::obs::CObservation&                   obs,
@@ -550,17 +589,40 @@ void SparseTreesPointCloud::saveMetricMapRepresentationToFile(
 
 bool SparseTreesPointCloud::saveToTextFile(const std::string& file) const
 {
-    FILE* f = mrpt::system::os::fopen(file.c_str(), "wt");
-    if (!f) return false;
+    // Collapse the map into one contiguous buffer, then format/write it in
+    // parallel chunks (see text_export.h):
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
 
-    const auto lambdaVisitPoints = [f](const mrpt::math::TPoint3Df& pt) {
-        mrpt::system::os::fprintf(f, "%f %f %f\n", pt.x, pt.y, pt.z);
-    };
+    return mola::internal::saveXYZToTextFile(file, xyz);
+}
+
+void SparseTreesPointCloud::exportFlat(
+    std::vector<mrpt::math::TPoint3Df>& xyz) const
+{
+    std::size_t nPoints = 0;
+    for (const auto& [idx, g] : grids_) nPoints += g.points().size();
 
-    this->visitAllPoints(lambdaVisitPoints);
+    xyz.clear();
+    xyz.reserve(nPoints);
 
-    mrpt::system::os::fclose(f);
-    return true;
+    for (const auto& [idx, g] : grids_)
+    {
+        const auto& xs = g.points().getPointsBufferRef_x();
+        const auto& ys = g.points().getPointsBufferRef_y();
+        const auto& zs = g.points().getPointsBufferRef_z();
+        for (std::size_t k = 0; k < xs.size(); k++)
+            xyz.emplace_back(xs[k], ys[k], zs[k]);
+    }
+}
+
+void SparseTreesPointCloud::importFlat(
+    const mrpt::math::TPoint3Df* xyz, const std::size_t num)
+{
+    this->clear();
+    // The buffer comes grouped by block from exportFlat(), so the insertion
+    // cache hits the same submap for whole runs of points:
+    for (std::size_t i = 0; i < num; i++) insertPoint(xyz[i]);
 }
 
 bool SparseTreesPointCloud::nn_has_indices_or_ids() const
@@ -642,6 +704,53 @@ void SparseTreesPointCloud::nn_multiple_search(
         query, N, results, out_dists_sqr, resultIndicesOrIDs);
 }
 
+void SparseTreesPointCloud::nn_multiple_search_batch(
+    const mrpt::math::TPoint3Df* queries, const size_t numQueries,
+    const size_t                                     N,
+    std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+    std::vector<std::vector<float>>&                 out_dists_sqr,
+    std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+    unsigned int                                     numberOfThreads) const
+{
+    results.resize(numQueries);
+    out_dists_sqr.resize(numQueries);
+    resultIndicesOrIDs.resize(numQueries);
+    if (numQueries == 0) return;
+
+    // Each thread writes only into the output slots of its own range of
+    // query indices, so no merge step or locking is required:
+    const auto lambdaWorker = [&](const size_t idx0, const size_t idx1) {
+        for (size_t i = idx0; i < idx1; i++)
+            nn_multiple_search(
+                queries[i], N, results[i], out_dists_sqr[i],
+                resultIndicesOrIDs[i]);
+    };
+
+    // Not worth spawning threads for short batches:
+    constexpr size_t MIN_QUERIES_PER_THREAD = 64;
+
+    size_t nThreads = numberOfThreads != 0
+                          ? numberOfThreads
+                          : std::thread::hardware_concurrency();
+    nThreads = std::min(
+        nThreads, std::max<size_t>(1, numQueries / MIN_QUERIES_PER_THREAD));
+
+    if (nThreads <= 1)
+    {
+        lambdaWorker(0, numQueries);
+        return;
+    }
+
+    const size_t chunk = (numQueries + nThreads - 1) / nThreads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (size_t t = 0; t < nThreads; t++)
+        workers.emplace_back(
+            lambdaWorker, t * chunk, std::min(numQueries, (t + 1) * chunk));
+    for (auto& w : workers) w.join();
+}
+
 void SparseTreesPointCloud::nn_radius_search(
     const mrpt::math::TPoint3Df& query, const float search_radius_sqr,
     std::vector<mrpt::math::TPoint3Df>& results,
@@ -766,6 +875,43 @@ void SparseTreesPointCloud::visitAllGrids(
     }
 }
 
+void SparseTreesPointCloud::visitAllPointsParallel(
+    const std::function<void(const mrpt::math::TPoint3Df&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    visitAllGridsParallel(
+        [&f](const outer_index3d_t&, const GridData& g,
+             const unsigned int workerIdx)
+        {
+            const auto& pts = g.points();
+
+            const auto&  xs = pts.getPointsBufferRef_x();
+            const auto&  ys = pts.getPointsBufferRef_y();
+            const auto&  zs = pts.getPointsBufferRef_z();
+            const size_t N  = xs.size();
+
+            for (size_t k = 0; k < N; k++)
+                f({xs[k], ys[k], zs[k]}, workerIdx);
+        },
+        numThreads);
+}
+
+void SparseTreesPointCloud::visitAllGridsParallel(
+    const std::function<
+        void(const outer_index3d_t&, const GridData&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    // Flat snapshot of block addresses (stable while the map is unmodified):
+    std::vector<const grids_map_t::value_type*> entries;
+    entries.reserve(grids_.size());
+    for (const auto& kv : grids_) entries.push_back(&kv);
+
+    internal::parallel_visit(
+        entries.size(), numThreads,
+        [&](const unsigned int workerIdx, const std::size_t i)
+        { f(entries[i]->first, entries[i]->second, workerIdx); });
+}
+
 // ========== Option structures ==========
 void SparseTreesPointCloud::TInsertionOptions::writeToStream(
     mrpt::serialization::CArchive& out) const
@@ -997,4 +1143,158 @@ void SparseTreesPointCloud::eraseGridsFartherThan(
         }
     }
     cachedMtx_.unlock();
+
+    // Drop pyramid representative points whose parent block was removed
+    // (same index-box criterion as above):
+    for (auto& lvl : pyramid_)
+    {
+        for (auto it = lvl.voxels.begin(); it != lvl.voxels.end();)
+        {
+            const auto bIdx = coordToOuterIdx(it->second);
+            const bool keep =
+                bIdx.cx >= curIdxs0.cx && bIdx.cy >= curIdxs0.cy &&
+                bIdx.cz >= curIdxs0.cz && bIdx.cx <= curIdxs1.cx &&
+                bIdx.cy <= curIdxs1.cy && bIdx.cz <= curIdxs1.cz;
+            if (keep)
+                ++it;
+            else
+                it = lvl.voxels.erase(it);
+        }
+    }
+}
+
+std::size_t SparseTreesPointCloud::eraseBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseIndexRange(
+        coordToOuterIdx(box.min), coordToOuterIdx(box.max),
+        true /*eraseInside*/);
+}
+
+std::size_t SparseTreesPointCloud::cropToBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseIndexRange(
+        coordToOuterIdx(box.min), coordToOuterIdx(box.max),
+        false /*eraseInside*/);
+}
+
+std::size_t SparseTreesPointCloud::internal_eraseIndexRange(
+    const outer_index3d_t& o0, const outer_index3d_t& o1,
+    const bool eraseInside)
+{
+    const auto isInside = [&](const outer_index3d_t& idx) {
+        return idx.cx >= o0.cx && idx.cy >= o0.cy && idx.cz >= o0.cz &&
+               idx.cx <= o1.cx && idx.cy <= o1.cy && idx.cz <= o1.cz;
+    };
+
+    // Remove the matching blocks from the local map, and also from the
+    // access cache (same pattern as eraseGridsFartherThan()):
+    std::size_t nErased = 0;
+
+    cachedMtx_.lock();
+    for (auto it = grids_.begin(); it != grids_.end();)
+    {
+        if (isInside(it->first) != eraseInside)
+        {
+            ++it;
+            continue;
+        }
+
+        for (int i = 0; i < CachedData::NUM_CACHED_IDXS; i++)
+        {
+            if (cached_.lastAccessIdx[i] == it->first)
+            {
+                cached_.lastAccessIdx[i]  = {0, 0, 0};
+                cached_.lastAccessGrid[i] = nullptr;
+            }
+        }
+        it = grids_.erase(it);
+        nErased++;
+    }
+    cachedMtx_.unlock();
+
+    if (nErased == 0) return 0;
+
+    // The bbox may have shrunk; recomputed lazily on demand:
+    cached_.boundingBox_.reset();
+
+    // Drop pyramid representative points whose parent block was removed
+    // (same index-box criterion as above):
+    for (auto& lvl : pyramid_)
+    {
+        for (auto it = lvl.voxels.begin(); it != lvl.voxels.end();)
+        {
+            if (isInside(coordToOuterIdx(it->second)) == eraseInside)
+                it = lvl.voxels.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    return nErased;
+}
+
+void SparseTreesPointCloud::setPyramidLevels(
+    const std::size_t numLevels, const float finestVoxelSize)
+{
+    pyramid_.clear();
+    pyramid_.resize(numLevels);
+    for (std::size_t l = 0; l < numLevels; l++)
+    {
+        auto& lvl        = pyramid_[l];
+        lvl.voxelSize    = finestVoxelSize * (1 << l);
+        lvl.voxelSizeInv = 1.0f / lvl.voxelSize;
+    }
+    internal_rebuildPyramid();
+}
+
+void SparseTreesPointCloud::internal_rebuildPyramid()
+{
+    for (auto& lvl : pyramid_) lvl.voxels.clear();
+
+    this->visitAllPoints([this](const mrpt::math::TPoint3Df& pt) {
+        for (auto& lvl : pyramid_) lvl.insert(pt);
+    });
+}
+
+bool SparseTreesPointCloud::nn_single_search_level(
+    const std::size_t level, const mrpt::math::TPoint3Df& query,
+    mrpt::math::TPoint3Df& result, float& out_dist_sqr) const
+{
+    ASSERT_LT_(level, pyramid_.size());
+    const auto& lvl = pyramid_[level];
+    if (lvl.voxels.empty()) return false;
+
+    const auto idx0 = lvl.coordToIdx(query);
+
+    bool  found   = false;
+    float bestSqr = std::numeric_limits<float>::max();
+
+    for (int32_t dz = -1; dz <= 1; dz++)
+    {
+        for (int32_t dy = -1; dy <= 1; dy++)
+        {
+            for (int32_t dx = -1; dx <= 1; dx++)
+            {
+                const auto it = lvl.voxels.find(
+                    {idx0.cx + dx, idx0.cy + dy, idx0.cz + dz});
+                if (it == lvl.voxels.end()) continue;
+
+                const auto& p = it->second;
+                const float distSqr = mrpt::square(p.x - query.x) +
+                                      mrpt::square(p.y - query.y) +
+                                      mrpt::square(p.z - query.z);
+                if (distSqr < bestSqr)
+                {
+                    bestSqr = distSqr;
+                    result  = p;
+                    found   = true;
+                }
+            }
+        }
+    }
+
+    out_dist_sqr = bestSqr;
+    return found;
 }
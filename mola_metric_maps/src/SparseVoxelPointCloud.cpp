@@ -39,7 +39,14 @@
 #include <mrpt/serialization/CArchive.h>  // serialization
 #include <mrpt/system/os.h>
 
+#include "serial_layout.h"
+#include "text_export.h"
+#include "visit_parallel.h"
+
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <thread>
 
 //#define USE_DEBUG_PROFILER
 
@@ -108,7 +115,7 @@ IMPLEMENTS_SERIALIZABLE(SparseVoxelPointCloud, CMetricMap, mola)
 // Serialization
 // =====================================
 
-uint8_t SparseVoxelPointCloud::serializeGetVersion() const { return 0; }
+uint8_t SparseVoxelPointCloud::serializeGetVersion() const { return 1; }
 void    SparseVoxelPointCloud::serializeTo(
     mrpt::serialization::CArchive& out) const
 {
@@ -118,23 +125,18 @@ void    SparseVoxelPointCloud::serializeTo(
     likelihoodOptions.writeToStream(out);
     renderOptions.writeToStream(out);
 
-    // data:
-    out.WriteAs<uint32_t>(grids_.size());
-    for (const auto& kv : grids_)
-    {
-        out << kv.first.cx << kv.first.cy << kv.first.cz;
+    // data (v1): all points as one raw contiguous XYZ block, dumped with
+    // a single WriteBuffer() call. Blocks and per-voxel indices are
+    // deterministically rebuilt on load by replaying the insertions:
+    out.WriteAs<uint8_t>(mola::internal::serial_layout_tag());
 
-        out << kv.second.points;
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
 
-        const auto* cells = kv.second.gridData.cells();
-        for (size_t i = 0; i < kv.second.gridData.TOTAL_CELL_COUNT; i++)
-        {
-            const auto N = cells[i].size();
-            out.WriteAs<uint16_t>(N);
-            for (size_t j = 0; j < N; j++)
-                out.WriteAs<uint32_t>(cells[i].getIndex(j));
-        }
-    }
+    out.WriteAs<uint64_t>(xyz.size());
+    if (!xyz.empty())
+        out.WriteBuffer(
+            xyz.data(), sizeof(mrpt::math::TPoint3Df) * xyz.size());
 }
 void SparseVoxelPointCloud::serializeFrom(
     mrpt::serialization::CArchive& in, uint8_t version)
@@ -142,6 +144,7 @@ void SparseVoxelPointCloud::serializeFrom(
     switch (version)
     {
         case 0:
+        case 1:
         {
             // params:
             const auto expected_inner_grid_bit_count = in.ReadAs<uint32_t>();
@@ -156,26 +159,44 @@ void SparseVoxelPointCloud::serializeFrom(
             likelihoodOptions.readFromStream(in);
             renderOptions.readFromStream(in);
 
-            // data:
-            const auto nGrids = in.ReadAs<uint32_t>();
-            for (uint32_t i = 0; i < nGrids; i++)
+            if (version >= 1)
             {
-                outer_index3d_t idx;
-                in >> idx.cx >> idx.cy >> idx.cz;
+                // data (v1): one raw XYZ block:
+                const auto layoutTag = in.ReadAs<uint8_t>();
+                ASSERT_EQUAL_(
+                    layoutTag, mola::internal::serial_layout_tag());
+
+                const auto n = in.ReadAs<uint64_t>();
+                std::vector<mrpt::math::TPoint3Df> xyz(n);
+                if (n != 0)
+                    in.ReadBuffer(
+                        xyz.data(), sizeof(mrpt::math::TPoint3Df) * n);
+
+                importFlat(xyz.data(), n);
+            }
+            else
+            {
+                // data (v0): per-block points maps and voxel indices:
+                const auto nGrids = in.ReadAs<uint32_t>();
+                for (uint32_t i = 0; i < nGrids; i++)
+                {
+                    outer_index3d_t idx;
+                    in >> idx.cx >> idx.cy >> idx.cz;
 
-                auto& grid = grids_[idx];
+                    auto& grid = grids_[idx];
 
-                in >> grid.points;
+                    in >> grid.points;
 
-                auto* cells = grid.gridData.cells();
+                    auto* cells = grid.gridData.cells();
 
-                for (size_t k = 0; k < grid.gridData.TOTAL_CELL_COUNT; k++)
-                {
-                    const auto nPts = in.ReadAs<uint16_t>();
-                    cells[k].resize(nPts);
+                    for (size_t k = 0; k < grid.gridData.TOTAL_CELL_COUNT; k++)
+                    {
+                        const auto nPts = in.ReadAs<uint16_t>();
+                        cells[k].resize(nPts);
 
-                    for (size_t j = 0; j < nPts; j++)
-                        cells[k].setIndex(j, in.ReadAs<uint32_t>());
+                        for (size_t j = 0; j < nPts; j++)
+                            cells[k].setIndex(j, in.ReadAs<uint32_t>());
+                    }
                 }
             }
         }
@@ -197,10 +218,38 @@ void SparseVoxelPointCloud::VoxelData::insertPoint(
 
     mean_ = (numPoints_ * mean_ + p);
 
+    // second-order product means, for ndtGaussian():
+    mom2_[0] = numPoints_ * mom2_[0] + p.x * p.x;
+    mom2_[1] = numPoints_ * mom2_[1] + p.y * p.y;
+    mom2_[2] = numPoints_ * mom2_[2] + p.z * p.z;
+    mom2_[3] = numPoints_ * mom2_[3] + p.x * p.y;
+    mom2_[4] = numPoints_ * mom2_[4] + p.x * p.z;
+    mom2_[5] = numPoints_ * mom2_[5] + p.y * p.z;
+
     pointIndices_[numPoints_++] = parent.points.size();
     parent.points.insertPoint(p);
 
-    mean_ *= 1.0f / numPoints_;
+    const float invN = 1.0f / numPoints_;
+    mean_ *= invN;
+    for (float& m : mom2_) m *= invN;
+}
+
+bool SparseVoxelPointCloud::VoxelData::ndtGaussian(
+    mrpt::math::TPoint3Df& mean, mrpt::math::CMatrixFloat33& cov,
+    const float minVar) const
+{
+    if (numPoints_ < 3) return false;
+
+    mean = mean_;
+
+    cov(0, 0) = mom2_[0] - mean_.x * mean_.x + minVar;
+    cov(1, 1) = mom2_[1] - mean_.y * mean_.y + minVar;
+    cov(2, 2) = mom2_[2] - mean_.z * mean_.z + minVar;
+    cov(0, 1) = cov(1, 0) = mom2_[3] - mean_.x * mean_.y;
+    cov(0, 2) = cov(2, 0) = mom2_[4] - mean_.x * mean_.z;
+    cov(1, 2) = cov(2, 1) = mom2_[5] - mean_.y * mean_.z;
+
+    return true;
 }
 
 // Ctor:
@@ -357,7 +406,13 @@ void SparseVoxelPointCloud::getVisualizationInto(
     MRPT_END
 }
 
-void SparseVoxelPointCloud::internal_clear() { grids_.clear(); }
+void SparseVoxelPointCloud::internal_clear()
+{
+    grids_.clear();
+    // also drop the cached bbox, last-access grid pointers, and the
+    // Morton-sorted view, all of which would be stale now:
+    cached_.reset();
+}
 
 bool SparseVoxelPointCloud::internal_insertObservation(
     const mrpt::obs::CObservation&                   obs,
@@ -564,6 +619,10 @@ double SparseVoxelPointCloud::internal_computeObservationLikelihoodPointCloud3D(
 
     ASSERT_GT_(likelihoodOptions.sigma_dist, .0);
 
+    if (likelihoodOptions.match_ndt)
+        return internal_computeObservationLikelihoodPointCloud3D_ndt(
+            pc_in_map, xs, ys, zs, num_pts);
+
     mrpt::math::TPoint3Df closest;
     float                 closest_err;
     uint64_t              closest_id;
@@ -595,6 +654,94 @@ double SparseVoxelPointCloud::internal_computeObservationLikelihoodPointCloud3D(
     MRPT_TRY_END
 }
 
+namespace
+{
+/** Squared Mahalanobis distance d^T C^{-1} d of a symmetric (and, after
+ * the minVar regularization, positive-definite) 3x3 covariance, via its
+ * closed-form cofactor inverse: a few tens of flops, no heap. */
+float mahalanobisSqr(
+    const mrpt::math::CMatrixFloat33& C, const mrpt::math::TPoint3Df& d)
+{
+    const float a = C(0, 0), b = C(0, 1), c = C(0, 2);
+    const float e = C(1, 1), f = C(1, 2), g = C(2, 2);
+
+    // cofactors of the upper triangle:
+    const float A = e * g - f * f;
+    const float B = c * f - b * g;
+    const float D = b * f - c * e;
+
+    const float det = a * A + b * B + c * D;
+    if (det <= 0)  // numerically degenerate despite regularization
+        return std::numeric_limits<float>::max();
+
+    const float E = a * g - c * c;
+    const float F = b * c - a * f;
+    const float G = a * e - b * b;
+
+    const float q = d.x * (A * d.x + B * d.y + D * d.z) +
+                    d.y * (B * d.x + E * d.y + F * d.z) +
+                    d.z * (D * d.x + F * d.y + G * d.z);
+    return q / det;
+}
+}  // namespace
+
+double
+    SparseVoxelPointCloud::internal_computeObservationLikelihoodPointCloud3D_ndt(
+        const mrpt::poses::CPose3D& pc_in_map, const float* xs,
+        const float* ys, const float* zs, const std::size_t num_pts) const
+{
+    MRPT_TRY_START
+
+    const float minVar =
+        static_cast<float>(likelihoodOptions.ndt_min_variance);
+    ASSERT_GT_(minVar, .0f);
+
+    // Cap equivalent to max_corr_distance under a covariance collapsed to
+    // the isotropic minVar floor, so points falling in unmodelled space
+    // saturate instead of dominating the score:
+    const float maxMahal =
+        mrpt::square(static_cast<float>(likelihoodOptions.max_corr_distance)) /
+        minVar;
+
+    double      sumMahal       = .0;
+    std::size_t nPtsForAverage = 0;
+
+    mrpt::math::TPoint3Df      m;
+    mrpt::math::CMatrixFloat33 cov;
+
+    for (std::size_t i = 0; i < num_pts;
+         i += likelihoodOptions.decimation, nPtsForAverage++)
+    {
+        const auto gPt = pc_in_map.composePoint({xs[i], ys[i], zs[i]});
+
+        // O(1): only the voxel containing the point is looked up, there
+        // is no search over stored points:
+        const auto [v, grid] = voxelByGlobalIdxs(coordToGlobalIdx(gPt), false);
+        if (!v || v->size() == 0) continue;
+
+        float mahal;
+        if (v->ndtGaussian(m, cov, minVar))
+        {
+            mahal = mahalanobisSqr(cov, gPt - m);
+        }
+        else
+        {
+            // too few points for a covariance: point-to-mean distance
+            // under the isotropic floor:
+            mahal = (gPt - v->mean()).sqrNorm() / minVar;
+        }
+
+        mrpt::keep_min(mahal, maxMahal);
+        sumMahal += static_cast<double>(mahal);
+    }
+    if (nPtsForAverage) sumMahal /= nPtsForAverage;
+
+    // Log-likelihood of the average Gaussian exponent:
+    return -0.5 * sumMahal;
+
+    MRPT_TRY_END
+}
+
 bool SparseVoxelPointCloud::internal_canComputeObservationLikelihood(
     const mrpt::obs::CObservation& obs) const
 {
@@ -622,17 +769,94 @@ void SparseVoxelPointCloud::saveMetricMapRepresentationToFile(
 
 bool SparseVoxelPointCloud::saveToTextFile(const std::string& file) const
 {
-    FILE* f = mrpt::system::os::fopen(file.c_str(), "wt");
-    if (!f) return false;
+    // Collapse the map into one contiguous buffer, then format/write it in
+    // parallel chunks (see text_export.h):
+    std::vector<mrpt::math::TPoint3Df> xyz;
+    exportFlat(xyz);
 
-    const auto lambdaVisitPoints = [f](const mrpt::math::TPoint3Df& pt) {
-        mrpt::system::os::fprintf(f, "%f %f %f\n", pt.x, pt.y, pt.z);
-    };
+    return mola::internal::saveXYZToTextFile(file, xyz);
+}
 
-    this->visitAllPoints(lambdaVisitPoints);
+void SparseVoxelPointCloud::exportFlat(
+    std::vector<mrpt::math::TPoint3Df>& xyz) const
+{
+    std::size_t nPoints = 0;
+    for (const auto& [idx, g] : grids_) nPoints += g.points.size();
 
-    mrpt::system::os::fclose(f);
-    return true;
+    xyz.clear();
+    xyz.reserve(nPoints);
+
+    for (const auto& e : gridsMortonOrdered())
+    {
+        const auto& pts = e.second->second.points;
+        const auto& xs  = pts.getPointsBufferRef_x();
+        const auto& ys  = pts.getPointsBufferRef_y();
+        const auto& zs  = pts.getPointsBufferRef_z();
+        for (std::size_t k = 0; k < xs.size(); k++)
+            xyz.emplace_back(xs[k], ys[k], zs[k]);
+    }
+}
+
+void SparseVoxelPointCloud::importFlat(
+    const mrpt::math::TPoint3Df* xyz, const std::size_t num)
+{
+    this->clear();
+    // The buffer comes grouped by block from exportFlat(), so the insertion
+    // cache hits the same inner grid for whole runs of points:
+    for (std::size_t i = 0; i < num; i++) insertPoint(xyz[i]);
+}
+
+std::size_t SparseVoxelPointCloud::eraseBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseBlocks(
+        coordToGlobalIdx(box.min), coordToGlobalIdx(box.max),
+        true /*eraseOverlapping*/);
+}
+
+std::size_t SparseVoxelPointCloud::cropToBox(
+    const mrpt::math::TBoundingBoxf& box)
+{
+    return internal_eraseBlocks(
+        coordToGlobalIdx(box.min), coordToGlobalIdx(box.max),
+        false /*eraseOverlapping*/);
+}
+
+std::size_t SparseVoxelPointCloud::internal_eraseBlocks(
+    const global_index3d_t& g0, const global_index3d_t& g1,
+    const bool eraseOverlapping)
+{
+    // Each block covers the global voxel indices [oIdx, oIdx + LAST]:
+    constexpr int32_t LAST = static_cast<int32_t>(INNER_GRID_SIDE - 1);
+
+    std::size_t nErased = 0;
+    for (auto it = grids_.begin(); it != grids_.end();)
+    {
+        const auto& o        = it->first;
+        const bool  overlaps =  //
+            o.cx <= g1.cx && o.cx + LAST >= g0.cx &&
+            o.cy <= g1.cy && o.cy + LAST >= g0.cy &&
+            o.cz <= g1.cz && o.cz + LAST >= g0.cz;
+
+        if (overlaps == eraseOverlapping)
+        {
+            it = grids_.erase(it);
+            nErased++;
+        }
+        else
+            ++it;
+    }
+
+    if (nErased != 0)
+    {
+        // The access cache and the Morton-sorted flat view may now hold
+        // pointers into erased blocks:
+        for (auto& g : cached_.lastAccessGrid) g = nullptr;
+        cached_.mortonIndexValid = false;
+        cached_.boundingBox_.reset();  // may have shrunk; recomputed lazily
+    }
+
+    return nErased;
 }
 
 void SparseVoxelPointCloud::insertPoint(const mrpt::math::TPoint3Df& pt)
@@ -797,6 +1021,61 @@ void SparseVoxelPointCloud::nn_radius_search(
     }
 }
 
+void SparseVoxelPointCloud::nn_radius_search_batch(
+    const mrpt::math::TPoint3Df* queries, const size_t numQueries,
+    const float                                      search_radius_sqr,
+    std::vector<std::vector<mrpt::math::TPoint3Df>>& results,
+    std::vector<std::vector<float>>&                 out_dists_sqr,
+    std::vector<std::vector<uint64_t>>&              resultIndicesOrIDs,
+    const size_t maxPoints, unsigned int numberOfThreads) const
+{
+    results.resize(numQueries);
+    out_dists_sqr.resize(numQueries);
+    resultIndicesOrIDs.resize(numQueries);
+    if (numQueries == 0) return;
+
+    // Each thread writes only into the output slots of its own range of
+    // query indices, so no merge step or locking is required:
+    const auto lambdaWorker = [&](const size_t idx0, const size_t idx1) {
+        for (size_t i = idx0; i < idx1; i++)
+            nn_radius_search(
+                queries[i], search_radius_sqr, results[i], out_dists_sqr[i],
+                resultIndicesOrIDs[i], maxPoints);
+    };
+
+    // Not worth spawning threads for short batches:
+    constexpr size_t MIN_QUERIES_PER_THREAD = 64;
+
+    size_t nThreads = numberOfThreads != 0
+                          ? numberOfThreads
+                          : std::thread::hardware_concurrency();
+    nThreads = std::min(
+        nThreads, std::max<size_t>(1, numQueries / MIN_QUERIES_PER_THREAD));
+
+    if (nThreads <= 1)
+    {
+        lambdaWorker(0, numQueries);
+        return;
+    }
+
+    // Disable the (unguarded) last-access grid cache writes while the
+    // worker threads run (see voxelByGlobalIdxs()):
+    auto& me = const_cast<SparseVoxelPointCloud&>(*this);
+
+    me.cached_.concurrentQueries = true;
+
+    const size_t chunk = (numQueries + nThreads - 1) / nThreads;
+
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+    for (size_t t = 0; t < nThreads; t++)
+        workers.emplace_back(
+            lambdaWorker, t * chunk, std::min(numQueries, (t + 1) * chunk));
+    for (auto& w : workers) w.join();
+
+    me.cached_.concurrentQueries = false;
+}
+
 mrpt::math::TBoundingBoxf SparseVoxelPointCloud::boundingBox() const
 {
     if (!cached_.boundingBox_)
@@ -830,12 +1109,65 @@ mrpt::math::TBoundingBoxf SparseVoxelPointCloud::boundingBox() const
     return cached_.boundingBox_.value();
 }
 
+const SparseVoxelPointCloud::morton_index_t&
+    SparseVoxelPointCloud::gridsMortonOrdered() const
+{
+    if (!cached_.mortonIndexValid)
+    {
+        // (Re)build and sort the flat view. This runs once per batch of
+        // insertions, the first time iteration or a box query is needed:
+        auto& mi = cached_.mortonIndex_;
+        mi.clear();
+        mi.reserve(grids_.size());
+        for (const auto& kv : grids_)
+            mi.emplace_back(outerIdxToMortonCode(kv.first), &kv);
+
+        std::sort(
+            mi.begin(), mi.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        cached_.mortonIndexValid = true;
+    }
+    return cached_.mortonIndex_;
+}
+
+void SparseVoxelPointCloud::visitGridsInBox(
+    const mrpt::math::TBoundingBoxf& bbox,
+    const std::function<void(const outer_index3d_t&, const InnerGrid&)>& f)
+    const
+{
+    const outer_index3d_t o0 = g2o(coordToGlobalIdx(bbox.min));
+    const outer_index3d_t o1 = g2o(coordToGlobalIdx(bbox.max));
+
+    const uint64_t key0 = outerIdxToMortonCode(o0);
+    const uint64_t key1 = outerIdxToMortonCode(o1);
+
+    const auto& mi = gridsMortonOrdered();
+
+    auto it = std::lower_bound(
+        mi.begin(), mi.end(), key0,
+        [](const morton_index_t::value_type& e, uint64_t k)
+        { return e.first < k; });
+
+    // The Morton range [key0,key1] is a superset of the box, so filter each
+    // candidate against the actual index box:
+    for (; it != mi.end() && it->first <= key1; ++it)
+    {
+        const outer_index3d_t& idx = it->second->first;
+        if (idx.cx < o0.cx || idx.cx > o1.cx ||  //
+            idx.cy < o0.cy || idx.cy > o1.cy ||  //
+            idx.cz < o0.cz || idx.cz > o1.cz)
+            continue;
+        f(idx, it->second->second);
+    }
+}
+
 void SparseVoxelPointCloud::visitAllPoints(
     const std::function<void(const mrpt::math::TPoint3Df&)>& f) const
 {
-    for (const auto& kv : grids_)
+    for (const auto& e : gridsMortonOrdered())
     {
-        const InnerGrid& grid = kv.second;
+        const InnerGrid& grid = e.second->second;
 
         const auto&  xs = grid.points.getPointsBufferRef_x();
         const auto&  ys = grid.points.getPointsBufferRef_y();
@@ -851,11 +1183,11 @@ void SparseVoxelPointCloud::visitAllVoxels(
         const outer_index3d_t&, const inner_plain_index_t, const VoxelData&,
         const InnerGrid&)>& f) const
 {
-    for (const auto& kv : grids_)
+    for (const auto& e : gridsMortonOrdered())
     {
-        const outer_index3d_t outer_idx = kv.first;
+        const outer_index3d_t outer_idx = e.second->first;
 
-        const InnerGrid& grid   = kv.second;
+        const InnerGrid& grid   = e.second->second;
         const auto&      cells  = grid.gridData.cells();
         const size_t     nCells = grid.gridData.TOTAL_CELL_COUNT;
         for (inner_plain_index_t plainIdx = 0; plainIdx < nCells; plainIdx++)
@@ -869,11 +1201,55 @@ void SparseVoxelPointCloud::visitAllGrids(
     const std::function<void(const outer_index3d_t&, const InnerGrid&)>& f)
     const
 {
-    for (const auto& kv : grids_)
-    {
-        const outer_index3d_t outer_idx = kv.first;
-        f(outer_idx, kv.second);
-    }
+    for (const auto& e : gridsMortonOrdered())
+        f(e.second->first, e.second->second);
+}
+
+void SparseVoxelPointCloud::visitAllPointsParallel(
+    const std::function<void(const mrpt::math::TPoint3Df&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    const auto& grids = gridsMortonOrdered();
+
+    internal::parallel_visit(
+        grids.size(), numThreads,
+        [&](const unsigned int workerIdx, const std::size_t i)
+        {
+            const InnerGrid& grid = grids[i].second->second;
+
+            const auto&  xs = grid.points.getPointsBufferRef_x();
+            const auto&  ys = grid.points.getPointsBufferRef_y();
+            const auto&  zs = grid.points.getPointsBufferRef_z();
+            const size_t N  = xs.size();
+
+            for (size_t k = 0; k < N; k++)
+                f({xs[k], ys[k], zs[k]}, workerIdx);
+        });
+}
+
+void SparseVoxelPointCloud::visitAllVoxelsParallel(
+    const std::function<void(
+        const outer_index3d_t&, const inner_plain_index_t, const VoxelData&,
+        const InnerGrid&, unsigned int)>& f,
+    unsigned int numThreads) const
+{
+    const auto& grids = gridsMortonOrdered();
+
+    internal::parallel_visit(
+        grids.size(), numThreads,
+        [&](const unsigned int workerIdx, const std::size_t i)
+        {
+            const outer_index3d_t outer_idx = grids[i].second->first;
+
+            const InnerGrid& grid   = grids[i].second->second;
+            const auto&      cells  = grid.gridData.cells();
+            const size_t     nCells = grid.gridData.TOTAL_CELL_COUNT;
+            for (inner_plain_index_t plainIdx = 0; plainIdx < nCells;
+                 plainIdx++)
+            {
+                f(outer_idx, plainIdx, cells[plainIdx], grid, workerIdx);
+            }
+        });
 }
 
 // ========== Option structures ==========
@@ -905,9 +1281,11 @@ void SparseVoxelPointCloud::TInsertionOptions::readFromStream(
 void SparseVoxelPointCloud::TLikelihoodOptions::writeToStream(
     mrpt::serialization::CArchive& out) const
 {
-    const int8_t version = 0;
+    const int8_t version = 1;
     out << version;
     out << sigma_dist << max_corr_distance << decimation << match_mean;
+    // v1:
+    out << match_ndt << ndt_min_variance;
 }
 
 void SparseVoxelPointCloud::TLikelihoodOptions::readFromStream(
@@ -918,8 +1296,10 @@ void SparseVoxelPointCloud::TLikelihoodOptions::readFromStream(
     switch (version)
     {
         case 0:
+        case 1:
         {
             in >> sigma_dist >> max_corr_distance >> decimation >> match_mean;
+            if (version >= 1) in >> match_ndt >> ndt_min_variance;
         }
         break;
         default:
@@ -975,6 +1355,8 @@ void SparseVoxelPointCloud::TLikelihoodOptions::dumpToTextStream(
     LOADABLEOPTS_DUMP_VAR(max_corr_distance, double);
     LOADABLEOPTS_DUMP_VAR(decimation, int);
     LOADABLEOPTS_DUMP_VAR(match_mean, bool);
+    LOADABLEOPTS_DUMP_VAR(match_ndt, bool);
+    LOADABLEOPTS_DUMP_VAR(ndt_min_variance, double);
 }
 
 void SparseVoxelPointCloud::TRenderOptions::dumpToTextStream(
@@ -1005,6 +1387,8 @@ void SparseVoxelPointCloud::TLikelihoodOptions::loadFromConfigFile(
     MRPT_LOAD_CONFIG_VAR(max_corr_distance, double, c, s);
     MRPT_LOAD_CONFIG_VAR(decimation, int, c, s);
     MRPT_LOAD_CONFIG_VAR(match_mean, bool, c, s);
+    MRPT_LOAD_CONFIG_VAR(match_ndt, bool, c, s);
+    MRPT_LOAD_CONFIG_VAR(ndt_min_variance, double, c, s);
 }
 
 void SparseVoxelPointCloud::TRenderOptions::loadFromConfigFile(
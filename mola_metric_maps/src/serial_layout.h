@@ -0,0 +1,46 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   serial_layout.h
+ * @brief  Layout tag for raw-block map serialization (internal)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace mola::internal
+{
+/** Tag identifying the in-memory layout of raw serialized blocks:
+ *  endianness in the low bit, sizeof(float) in the upper bits. Written
+ *  once per map dump and checked on load, so a raw block read can never
+ *  silently succeed on an incompatible architecture. */
+inline uint8_t serial_layout_tag()
+{
+    const uint32_t probe = 1;
+    uint8_t        firstByte;
+    std::memcpy(&firstByte, &probe, sizeof(firstByte));
+
+    const uint8_t littleEndian = (firstByte == 1) ? 1 : 0;
+    return static_cast<uint8_t>((sizeof(float) << 1) | littleEndian);
+}
+}  // namespace mola::internal
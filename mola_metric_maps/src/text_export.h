@@ -0,0 +1,101 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   text_export.h
+ * @brief  Buffered parallel "X Y Z" text export for point maps (internal)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/system/os.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "visit_parallel.h"
+
+namespace mola::internal
+{
+/** Writes one "X Y Z\n" line per point into `file`. Fixed-size chunks of
+ * the input are formatted in parallel, each into its own large buffer
+ * (std::to_chars, shortest round-trip representation, no iostreams/printf),
+ * then the buffers are flushed to disk in chunk order so the output is
+ * identical to a sequential write. Returns false on I/O error. */
+inline bool saveXYZToTextFile(
+    const std::string& file, const std::vector<mrpt::math::TPoint3Df>& pts)
+{
+    FILE* f = mrpt::system::os::fopen(file.c_str(), "wt");
+    if (!f) return false;
+
+    constexpr std::size_t POINTS_PER_CHUNK = 1 << 16;
+
+    const std::size_t nChunks =
+        (pts.size() + POINTS_PER_CHUNK - 1) / POINTS_PER_CHUNK;
+
+    std::vector<std::string> chunkBufs(nChunks);
+
+    parallel_visit(
+        nChunks, 0 /* hw threads */,
+        [&](unsigned int, const std::size_t c)
+        {
+            const std::size_t i0 = c * POINTS_PER_CHUNK;
+            const std::size_t i1 =
+                std::min(pts.size(), i0 + POINTS_PER_CHUNK);
+
+            auto& buf = chunkBufs[c];
+            // "-123.45678 " per coordinate is ~12 chars; overshoot a bit to
+            // avoid reallocations:
+            buf.reserve((i1 - i0) * 48);
+
+            char num[32];
+            for (std::size_t i = i0; i < i1; i++)
+            {
+                const auto& p = pts[i];
+                for (int k = 0; k < 3; k++)
+                {
+                    const auto res =
+                        std::to_chars(num, num + sizeof(num), p[k]);
+                    buf.append(num, res.ptr);
+                    buf += (k < 2) ? ' ' : '\n';
+                }
+            }
+        });
+
+    bool ok = true;
+    for (const auto& buf : chunkBufs)
+    {
+        if (buf.empty()) continue;
+        if (std::fwrite(buf.data(), 1, buf.size(), f) != buf.size())
+        {
+            ok = false;
+            break;
+        }
+    }
+
+    mrpt::system::os::fclose(f);
+    return ok;
+}
+
+}  // namespace mola::internal
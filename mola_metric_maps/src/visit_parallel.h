@@ -0,0 +1,80 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   visit_parallel.h
+ * @brief  Chunk-stealing parallel loop for map visitors (internal)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace mola::internal
+{
+/** Runs `fn(workerIdx, bucketIdx)` for all bucket indices in [0, numBuckets)
+ * using `numThreads` workers (0 = hardware concurrency). Workers pull
+ * fixed-size chunks of consecutive buckets from one shared atomic cursor, so
+ * an idle worker always steals the next unclaimed chunk and uneven bucket
+ * sizes self-balance. The calling thread acts as worker #0 and small inputs
+ * run inline without spawning threads. `fn` must not throw. */
+template <typename PerBucketFn>
+void parallel_visit(
+    const std::size_t numBuckets, unsigned int numThreads,
+    const PerBucketFn& fn)
+{
+    constexpr std::size_t CHUNK = 16;
+
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    if (numThreads == 1 || numBuckets <= CHUNK)
+    {
+        for (std::size_t b = 0; b < numBuckets; b++) fn(0u, b);
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+
+    const auto worker = [&](const unsigned int workerIdx)
+    {
+        for (;;)
+        {
+            const std::size_t b0 =
+                next.fetch_add(CHUNK, std::memory_order_relaxed);
+            if (b0 >= numBuckets) return;
+            const std::size_t b1 = std::min(numBuckets, b0 + CHUNK);
+            for (std::size_t b = b0; b < b1; b++) fn(workerIdx, b);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for (unsigned int i = 1; i < numThreads; i++)
+        threads.emplace_back(worker, i);
+    worker(0u);
+    for (auto& t : threads) t.join();
+}
+
+}  // namespace mola::internal
@@ -0,0 +1,157 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-fixeddensegrid3d.cpp
+ * @brief  Test the fixed-size dense grid and its packed cell variants
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_metric_maps/FixedDenseGrid3D.h>
+#include <mrpt/core/exceptions.h>
+
+#include <cmath>
+#include <iostream>
+
+void test_bitpacked_cells()
+{
+    using grid_t = mola::FixedDenseGrid3D<bool, 4, uint32_t>;
+    grid_t g;
+
+    // 1 bit per cell:
+    static_assert(grid_t::WORD_COUNT * 64 >= grid_t::TOTAL_CELL_COUNT);
+
+    // calloc() zero-initialization:
+    for (uint32_t i = 0; i < grid_t::CELLS_PER_DIM; i++)
+        ASSERT_(!g.cellByIndex({i, i, i}));
+
+    // set/clear a scattered pattern and read it back:
+    for (uint32_t cz = 0; cz < grid_t::CELLS_PER_DIM; cz++)
+        for (uint32_t cy = 0; cy < grid_t::CELLS_PER_DIM; cy++)
+            for (uint32_t cx = 0; cx < grid_t::CELLS_PER_DIM; cx++)
+                g.cellByIndex({cx, cy, cz}) = ((cx + cy + cz) % 3) == 0;
+
+    const auto& cg = g;
+    for (uint32_t cz = 0; cz < grid_t::CELLS_PER_DIM; cz++)
+        for (uint32_t cy = 0; cy < grid_t::CELLS_PER_DIM; cy++)
+            for (uint32_t cx = 0; cx < grid_t::CELLS_PER_DIM; cx++)
+                ASSERT_EQUAL_(
+                    cg.cellByIndex({cx, cy, cz}), ((cx + cy + cz) % 3) == 0);
+}
+
+void test_fp16_cells()
+{
+    // round trips that are exact in binary16:
+    for (const float v : {0.0f, -0.0f, 1.0f, -1.0f, 0.5f, 1024.0f, -0.25f})
+        ASSERT_EQUAL_(static_cast<float>(mola::fp16_t(v)), v);
+
+    // inexact values keep ~3 decimal digits:
+    for (const float v : {0.1f, 3.14159f, -17.77f, 123.456f})
+        ASSERT_NEAR_(static_cast<float>(mola::fp16_t(v)), v, 1e-3f * std::abs(v));
+
+    // out-of-range values saturate to +-inf:
+    ASSERT_(std::isinf(static_cast<float>(mola::fp16_t(1e6f))));
+    ASSERT_(std::isinf(static_cast<float>(mola::fp16_t(-1e6f))));
+
+    // subnormal halves survive the round trip too:
+    const float tiny = 1e-6f;
+    ASSERT_NEAR_(static_cast<float>(mola::fp16_t(tiny)), tiny, 1e-7f);
+
+    // and they work as grid cells through the generic template:
+    mola::FixedDenseGrid3D<mola::fp16_t, 3, uint32_t> g;
+    g.cellByIndex({1, 2, 3}) = 0.75f;
+    ASSERT_EQUAL_(static_cast<float>(g.cellByIndex({1, 2, 3})), 0.75f);
+}
+
+void test_box_operations()
+{
+    using grid_t = mola::FixedDenseGrid3D<float, 4, uint32_t>;
+    grid_t g;
+
+    g.fill(1.0f);
+    g.fillBox({2, 3, 4}, {10, 5, 6}, 7.0f);
+
+    // Every row span handed out must be contiguous +x memory:
+    size_t nRows = 0, nCells = 0;
+    g.forEachCellInBox(
+        {2, 3, 4}, {10, 5, 6},
+        [&](const mola::index3d_t<uint32_t>& rowStart, const float* row,
+            size_t n)
+        {
+            ASSERT_EQUAL_(rowStart.cx, 2U);
+            ASSERT_EQUAL_(n, 9U);
+            ASSERT_EQUAL_(row, &g.cellByIndex(rowStart));
+            for (size_t i = 0; i < n; i++) ASSERT_EQUAL_(row[i], 7.0f);
+            nRows++;
+            nCells += n;
+        });
+    ASSERT_EQUAL_(nRows, 3U * 3U);
+    ASSERT_EQUAL_(nCells, 9U * 3U * 3U);
+
+    // ...and cells outside the box kept the fill() value:
+    ASSERT_EQUAL_(g.cellByIndex({1, 3, 4}), 1.0f);
+    ASSERT_EQUAL_(g.cellByIndex({11, 5, 6}), 1.0f);
+    ASSERT_EQUAL_(g.cellByIndex({2, 3, 7}), 1.0f);
+
+    g.clear();
+    ASSERT_EQUAL_(g.cellByIndex({5, 5, 5}), 0.0f);
+
+    // bit-packed specialization: whole-grid fill/clear over the words:
+    mola::FixedDenseGrid3D<bool, 4, uint32_t> gb;
+    gb.fill(true);
+    ASSERT_(gb.cellByIndex({15, 15, 15}));
+    gb.clear();
+    ASSERT_(!gb.cellByIndex({0, 0, 0}));
+}
+
+void test_cell_buffer_pool()
+{
+    using grid_t = mola::FixedDenseGrid3D<float, 4, uint32_t>;
+
+    const float* freedBuffer = nullptr;
+    {
+        grid_t g;
+        g.cellByIndex({1, 1, 1}) = 42.0f;
+        freedBuffer = g.cells();
+    }
+
+    // The destroyed grid's buffer must be recycled into the next one
+    // (LIFO free list), re-zeroed as if it came from calloc():
+    grid_t g2;
+    ASSERT_EQUAL_(g2.cells(), freedBuffer);
+    ASSERT_EQUAL_(static_cast<float>(g2.cellByIndex({1, 1, 1})), 0.0f);
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_bitpacked_cells();
+        test_fp16_cells();
+        test_box_operations();
+        test_cell_buffer_pool();
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
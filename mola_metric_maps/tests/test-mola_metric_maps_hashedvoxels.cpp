@@ -25,12 +25,18 @@
  * @date   Oct 31, 2023
  */
 
+#include <mola_metric_maps/FinalizedVoxelPointCloud.h>
 #include <mola_metric_maps/HashedVoxelPointCloud.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
 #include <mrpt/obs/stock_observations.h>
 #include <mrpt/opengl/Scene.h>
+#include <mrpt/system/filesystem.h>
 
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 void test_voxelmap_basic_ops()
 {
@@ -39,6 +45,161 @@ void test_voxelmap_basic_ops()
 
     map.insertPoint({1.0f, 2.0f, 3.0f});
     ASSERT_(!map.isEmpty());
+
+    // inserting points only grows the bbox, so its version must not change:
+    const auto bboxVer = map.boundingBoxVersion();
+    map.insertPoint({-1.0f, 0.0f, 5.0f});
+    ASSERT_EQUAL_(map.boundingBoxVersion(), bboxVer);
+
+    // ...but clearing the map may shrink it:
+    map.clear();
+    ASSERT_(map.boundingBoxVersion() != bboxVer);
+}
+
+void test_voxelmap_batch_insert()
+{
+    // insertPoints() must be equivalent to N calls to insertPoint():
+    std::vector<mrpt::math::TPoint3Df> pts;
+    for (int i = 0; i < 1000; i++)
+        pts.emplace_back(
+            std::cos(i * 0.01f) * 10.0f, std::sin(i * 0.013f) * 8.0f,
+            std::sin(i * 0.02f) * 2.0f);
+
+    mola::HashedVoxelPointCloud mapOneByOne(0.25f /*voxel size*/);
+    for (const auto& pt : pts) mapOneByOne.insertPoint(pt);
+
+    mola::HashedVoxelPointCloud mapBatch(0.25f /*voxel size*/);
+    mapBatch.insertPoints(pts.data(), pts.size());
+
+    size_t n1 = 0, n2 = 0;
+    mapOneByOne.visitAllPoints([&n1](const mrpt::math::TPoint3Df&) { n1++; });
+    mapBatch.visitAllPoints([&n2](const mrpt::math::TPoint3Df&) { n2++; });
+    ASSERT_EQUAL_(n1, n2);
+
+    const auto bb1 = mapOneByOne.boundingBox();
+    const auto bb2 = mapBatch.boundingBox();
+    ASSERT_NEAR_(bb1.min.x, bb2.min.x, 1e-6f);
+    ASSERT_NEAR_(bb1.min.y, bb2.min.y, 1e-6f);
+    ASSERT_NEAR_(bb1.min.z, bb2.min.z, 1e-6f);
+    ASSERT_NEAR_(bb1.max.x, bb2.max.x, 1e-6f);
+    ASSERT_NEAR_(bb1.max.y, bb2.max.y, 1e-6f);
+    ASSERT_NEAR_(bb1.max.z, bb2.max.z, 1e-6f);
+}
+
+void test_voxelmap_flat_roundtrip()
+{
+    mola::HashedVoxelPointCloud map(0.25f /*voxel size*/);
+    for (int i = 0; i < 1000; i++)
+        map.insertPoint(
+            {std::cos(i * 0.01f) * 10.0f, std::sin(i * 0.013f) * 8.0f,
+             std::sin(i * 0.02f) * 2.0f});
+
+    std::vector<mrpt::math::TPoint3Df>                       xyz;
+    std::vector<mola::HashedVoxelPointCloud::FlatVoxelEntry> voxelInfo;
+    map.exportFlat(xyz, &voxelInfo);
+
+    size_t nPts = 0;
+    map.visitAllPoints([&nPts](const mrpt::math::TPoint3Df&) { nPts++; });
+    ASSERT_EQUAL_(xyz.size(), nPts);
+
+    size_t nFromVoxels = 0;
+    for (const auto& v : voxelInfo) nFromVoxels += v.numPoints;
+    ASSERT_EQUAL_(nFromVoxels, xyz.size());
+
+    // exportFlat() -> importFlat() must reproduce the map exactly:
+    mola::HashedVoxelPointCloud map2(0.25f /*voxel size*/);
+    map2.importFlat(xyz.data(), xyz.size());
+
+    std::vector<mrpt::math::TPoint3Df> xyz2;
+    map2.exportFlat(xyz2);
+    ASSERT_EQUAL_(xyz2.size(), xyz.size());
+
+    const auto bb1 = map.boundingBox();
+    const auto bb2 = map2.boundingBox();
+    ASSERT_NEAR_(bb1.min.x, bb2.min.x, 1e-6f);
+    ASSERT_NEAR_(bb1.max.z, bb2.max.z, 1e-6f);
+}
+
+void test_voxelmap_concurrent_insert()
+{
+    // N threads inserting disjoint chunks via insertPointsConcurrent() must
+    // yield the same point count and bbox as one serial insertPoints():
+    std::vector<mrpt::math::TPoint3Df> pts;
+    for (int i = 0; i < 4000; i++)
+        pts.emplace_back(
+            std::cos(i * 0.002f) * 20.0f, std::sin(i * 0.0033f) * 15.0f,
+            std::cos(i * 0.005f) * 4.0f);
+
+    mola::HashedVoxelPointCloud mapSerial(0.5f /*voxel size*/);
+    mapSerial.insertPoints(pts.data(), pts.size());
+
+    mola::HashedVoxelPointCloud mapConcurrent(0.5f /*voxel size*/);
+    {
+        constexpr size_t         NT    = 4;
+        const size_t             chunk = pts.size() / NT;
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < NT; t++)
+        {
+            const size_t i0 = t * chunk;
+            const size_t i1 = (t + 1 == NT) ? pts.size() : (t + 1) * chunk;
+            threads.emplace_back(
+                [&, i0, i1]() {
+                    mapConcurrent.insertPointsConcurrent(
+                        pts.data() + i0, i1 - i0);
+                });
+        }
+        for (auto& th : threads) th.join();
+    }
+
+    size_t n1 = 0, n2 = 0;
+    mapSerial.visitAllPoints([&n1](const mrpt::math::TPoint3Df&) { n1++; });
+    mapConcurrent.visitAllPoints([&n2](const mrpt::math::TPoint3Df&) { n2++; });
+    ASSERT_EQUAL_(n1, n2);
+
+    const auto bb1 = mapSerial.boundingBox();
+    const auto bb2 = mapConcurrent.boundingBox();
+    ASSERT_NEAR_(bb1.min.x, bb2.min.x, 1e-6f);
+    ASSERT_NEAR_(bb1.max.z, bb2.max.z, 1e-6f);
+}
+
+void test_voxelmap_parallel_visit()
+{
+    mola::HashedVoxelPointCloud map(0.25f /*voxel size*/);
+    for (int i = 0; i < 5000; i++)
+        map.insertPoint(
+            {std::cos(i * 0.004f) * 25.0f, std::sin(i * 0.007f) * 18.0f,
+             std::sin(i * 0.01f) * 3.0f});
+
+    size_t nSerial  = 0;
+    double xsSerial = 0;
+    map.visitAllPoints(
+        [&](const mrpt::math::TPoint3Df& pt)
+        {
+            nSerial++;
+            xsSerial += pt.x;
+        });
+
+    // Per-worker accumulators, reduced after the parallel visit:
+    constexpr unsigned int NT = 4;
+    std::array<size_t, NT> nPerWorker{};
+    std::array<double, NT> xsPerWorker{};
+    map.visitAllPointsParallel(
+        [&](const mrpt::math::TPoint3Df& pt, const unsigned int workerIdx)
+        {
+            nPerWorker.at(workerIdx)++;
+            xsPerWorker.at(workerIdx) += pt.x;
+        },
+        NT);
+
+    size_t nPar  = 0;
+    double xsPar = 0;
+    for (unsigned int t = 0; t < NT; t++)
+    {
+        nPar += nPerWorker[t];
+        xsPar += xsPerWorker[t];
+    }
+    ASSERT_EQUAL_(nPar, nSerial);
+    ASSERT_NEAR_(xsPar, xsSerial, 1e-3);
 }
 
 void test_voxelmap_insert_2d_scan()
@@ -116,6 +277,257 @@ void test_voxelmap_insert_2d_scan()
             }
         }
     }
+
+    // test the parallel batch API against the serial per-query one:
+    {
+        std::vector<mrpt::math::TPoint3Df> queries;
+        for (size_t i = 0; i < queryPts.size(); i++)
+        {
+            float x, y, z;
+            queryPts.getPoint(i, x, y, z);
+            queries.emplace_back(x, y, z);
+        }
+
+        std::vector<std::vector<mrpt::math::TPoint3Df>> batchResults;
+        std::vector<std::vector<float>>                 batchDistsSqr;
+        std::vector<std::vector<uint64_t>>              batchIDs;
+        map.nn_multiple_search_batch(
+            queries.data(), queries.size(), 2 /*knn*/, batchResults,
+            batchDistsSqr, batchIDs, 4 /*threads*/);
+
+        ASSERT_EQUAL_(batchResults.size(), queries.size());
+
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            std::vector<mrpt::math::TPoint3Df> results;
+            std::vector<float>                 dists_sqr;
+            std::vector<uint64_t>              IDs;
+            map.nn_multiple_search(
+                queries[i], 2 /*knn*/, results, dists_sqr, IDs);
+
+            ASSERT_EQUAL_(batchResults[i].size(), results.size());
+            for (size_t k = 0; k < results.size(); k++)
+            {
+                ASSERT_NEAR_(batchResults[i][k].x, results[k].x, 1e-6f);
+                ASSERT_NEAR_(batchResults[i][k].y, results[k].y, 1e-6f);
+                ASSERT_NEAR_(batchResults[i][k].z, results[k].z, 1e-6f);
+                ASSERT_NEAR_(batchDistsSqr[i][k], dists_sqr[k], 1e-6f);
+            }
+        }
+    }
+}
+
+void test_voxelmap_nn_context()
+{
+    std::vector<mrpt::math::TPoint3Df> pts;
+    for (int i = 0; i < 1000; i++)
+        pts.emplace_back(
+            std::cos(i * 0.01f) * 10.0f, std::sin(i * 0.013f) * 8.0f,
+            std::sin(i * 0.02f) * 2.0f);
+
+    mola::HashedVoxelPointCloud map(0.25f /*voxel size*/);
+    map.insertPoints(pts.data(), pts.size());
+
+    // Queries = the points themselves, slightly perturbed; then "ICP
+    // iterations" shift them a bit more each time:
+    mola::HashedVoxelPointCloud::NNSearchContext ctx;
+
+    // With accept_dist_sqr=0 (default), results must be identical to the
+    // plain search, for any number of repeated passes:
+    for (int iter = 0; iter < 3; iter++)
+    {
+        const float shift = 0.005f * iter;
+        for (size_t i = 0; i < pts.size(); i++)
+        {
+            const auto query = mrpt::math::TPoint3Df(
+                pts[i].x + 0.01f + shift, pts[i].y - 0.01f, pts[i].z);
+
+            mrpt::math::TPoint3Df p1, p2;
+            float                 d1 = 0, d2 = 0;
+            uint64_t              id1 = 0, id2 = 0;
+            const bool ok1 = map.nn_single_search(query, p1, d1, id1);
+            const bool ok2 =
+                map.nn_single_search_with_context(query, i, ctx, p2, d2, id2);
+            ASSERT_EQUAL_(ok1, ok2);
+            ASSERT_NEAR_(d1, d2, 1e-9f);
+            ASSERT_EQUAL_(id1, id2);
+        }
+    }
+
+    // With a finite acceptance threshold, the cached fast path may return
+    // a point that is not the strict NN, but never one farther than the
+    // threshold (unless the strict NN itself is farther):
+    ctx.clear();
+    ctx.accept_dist_sqr = 0.10f * 0.10f;
+    for (int iter = 0; iter < 3; iter++)
+    {
+        const float shift = 0.005f * iter;
+        for (size_t i = 0; i < pts.size(); i++)
+        {
+            const auto query = mrpt::math::TPoint3Df(
+                pts[i].x + 0.01f + shift, pts[i].y - 0.01f, pts[i].z);
+
+            mrpt::math::TPoint3Df p1, p2;
+            float                 d1 = 0, d2 = 0;
+            uint64_t              id1 = 0, id2 = 0;
+            const bool ok1 = map.nn_single_search(query, p1, d1, id1);
+            const bool ok2 =
+                map.nn_single_search_with_context(query, i, ctx, p2, d2, id2);
+            ASSERT_EQUAL_(ok1, ok2);
+            ASSERT_LE_(d2, std::max(ctx.accept_dist_sqr, d1) + 1e-9f);
+        }
+    }
+}
+
+void test_voxelmap_submap_view()
+{
+    std::vector<mrpt::math::TPoint3Df> pts;
+    for (int i = 0; i < 2000; i++)
+        pts.emplace_back(
+            std::cos(i * 0.01f) * 40.0f, std::sin(i * 0.013f) * 30.0f,
+            std::sin(i * 0.02f) * 2.0f);
+
+    mola::HashedVoxelPointCloud map(0.5f /*voxel size*/);
+    map.insertPoints(pts.data(), pts.size());
+
+    // A view covering the whole map must reproduce the parent's results:
+    const mola::HashedVoxelPointCloudSubmapView fullView(
+        map, map.boundingBox());
+
+    // A view of the +X half-space must only ever return points from voxels
+    // inside it:
+    auto halfBox  = map.boundingBox();
+    halfBox.min.x = 0.5f;  // one voxel inwards, to avoid boundary voxels
+    const mola::HashedVoxelPointCloudSubmapView halfView(map, halfBox);
+
+    for (size_t i = 0; i < pts.size(); i += 7)
+    {
+        const auto query = mrpt::math::TPoint3Df(
+            pts[i].x + 0.02f, pts[i].y - 0.03f, pts[i].z + 0.01f);
+
+        mrpt::math::TPoint3Df p1, p2;
+        float                 d1 = 0, d2 = 0;
+        uint64_t              id1 = 0, id2 = 0;
+        const bool ok1 = map.nn_single_search(query, p1, d1, id1);
+        const bool ok2 = fullView.nn_single_search(query, p2, d2, id2);
+        ASSERT_EQUAL_(ok1, ok2);
+        ASSERT_NEAR_(d1, d2, 1e-9f);
+        ASSERT_EQUAL_(id1, id2);
+
+        mrpt::math::TPoint3Df p3;
+        float                 d3  = 0;
+        uint64_t              id3 = 0;
+        if (halfView.nn_single_search(query, p3, d3, id3))
+        {
+            ASSERT_GE_(p3.x, .0f);
+            // inside the view, results must match the parent's:
+            if (p1.x >= halfBox.min.x + 0.5f)
+            {
+                ASSERT_NEAR_(d1, d3, 1e-9f);
+                ASSERT_EQUAL_(id1, id3);
+            }
+        }
+
+        // radius search through the view never yields out-of-view points:
+        std::vector<mrpt::math::TPoint3Df> results;
+        std::vector<float>                 dists_sqr;
+        std::vector<uint64_t>              IDs;
+        halfView.nn_radius_search(
+            query, 4.0f /*r^2*/, results, dists_sqr, IDs, 0 /*no limit*/);
+        for (const auto& p : results) ASSERT_GE_(p.x, .0f);
+    }
+}
+
+void test_voxelmap_erase_crop_box()
+{
+    // Points at voxel centers (unit voxels at integer coordinates), so the
+    // box <-> voxel-index mapping below is exact:
+    mola::HashedVoxelPointCloud map(1.0f /*voxel size*/);
+    for (int x = -5; x <= 5; x++)
+        for (int y = -5; y <= 5; y++)
+            map.insertPoint(
+                {static_cast<float>(x), static_cast<float>(y), 0.0f});
+
+    const auto countPoints = [&map]() {
+        size_t n = 0;
+        map.visitAllPoints([&n](const mrpt::math::TPoint3Df&) { n++; });
+        return n;
+    };
+    ASSERT_EQUAL_(countPoints(), 11U * 11U);
+
+    // Erase the 3x3 voxel region around the origin:
+    const auto eraseRegion =
+        mrpt::math::TBoundingBoxf({-1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f});
+    ASSERT_EQUAL_(map.eraseBox(eraseRegion), 9U);
+    ASSERT_EQUAL_(countPoints(), 11U * 11U - 9U);
+    map.visitAllPoints([](const mrpt::math::TPoint3Df& p)
+                       { ASSERT_(std::abs(p.x) > 1.5f || std::abs(p.y) > 1.5f); });
+
+    // Re-running it must be a no-op:
+    ASSERT_EQUAL_(map.eraseBox(eraseRegion), 0U);
+
+    // Crop to the +X columns: only voxels with x in [1,5] survive, minus
+    // the 3 already erased above:
+    const auto cropRegion =
+        mrpt::math::TBoundingBoxf({1.0f, -5.0f, 0.0f}, {5.0f, 5.0f, 0.0f});
+    ASSERT_GT_(map.cropToBox(cropRegion), 0U);
+    ASSERT_EQUAL_(countPoints(), 5U * 11U - 3U);
+    map.visitAllPoints(
+        [](const mrpt::math::TPoint3Df& p) { ASSERT_GE_(p.x, 1.0f); });
+}
+
+void test_voxelmap_finalized()
+{
+    std::vector<mrpt::math::TPoint3Df> pts;
+    for (int i = 0; i < 2000; i++)
+        pts.emplace_back(
+            std::cos(i * 0.01f) * 40.0f, std::sin(i * 0.013f) * 30.0f,
+            std::sin(i * 0.02f) * 2.0f);
+
+    mola::HashedVoxelPointCloud map(0.5f /*voxel size*/);
+    map.insertPoints(pts.data(), pts.size());
+
+    const auto compact = map.finalize();
+
+    // All stored points must survive finalization:
+    size_t nLive = 0;
+    map.visitAllPoints([&nLive](const mrpt::math::TPoint3Df&) { nLive++; });
+    ASSERT_EQUAL_(compact.size(), nLive);
+
+    // NN searches must agree with the live map:
+    for (size_t i = 0; i < pts.size(); i += 13)
+    {
+        const auto query = mrpt::math::TPoint3Df(
+            pts[i].x + 0.02f, pts[i].y - 0.03f, pts[i].z + 0.01f);
+
+        mrpt::math::TPoint3Df p1, p2;
+        float                 d1 = 0, d2 = 0;
+        uint64_t              id1 = 0, id2 = 0;
+        const bool ok1 = map.nn_single_search(query, p1, d1, id1);
+        const bool ok2 = compact.nn_single_search(query, p2, d2, id2);
+        ASSERT_EQUAL_(ok1, ok2);
+        if (ok1) ASSERT_NEAR_(d1, d2, 1e-9f);
+    }
+
+    // Binary blob round trip:
+    const std::string fil = mrpt::system::getTempFileName() + "_fvpc.bin";
+    ASSERT_(compact.saveToBinaryFile(fil));
+
+    mola::FinalizedVoxelPointCloud loaded;
+    ASSERT_(loaded.loadFromBinaryFile(fil));
+    ASSERT_EQUAL_(loaded.size(), compact.size());
+    ASSERT_EQUAL_(loaded.voxels().size(), compact.voxels().size());
+    ASSERT_NEAR_(
+        loaded.boundingBox().min.x, compact.boundingBox().min.x, 1e-6f);
+    ASSERT_NEAR_(
+        loaded.boundingBox().max.z, compact.boundingBox().max.z, 1e-6f);
+
+    // An inserted point must be found at zero distance after the roundtrip:
+    mrpt::math::TPoint3Df p3;
+    float                 d3  = 0;
+    uint64_t              id3 = 0;
+    ASSERT_(loaded.nn_single_search(pts[0], p3, d3, id3));
+    ASSERT_NEAR_(d3, .0f, 1e-6f);
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
@@ -123,7 +535,15 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
     try
     {
         test_voxelmap_basic_ops();
+        test_voxelmap_batch_insert();
+        test_voxelmap_flat_roundtrip();
+        test_voxelmap_concurrent_insert();
+        test_voxelmap_parallel_visit();
         test_voxelmap_insert_2d_scan();
+        test_voxelmap_nn_context();
+        test_voxelmap_submap_view();
+        test_voxelmap_erase_crop_box();
+        test_voxelmap_finalized();
     }
     catch (std::exception& e)
     {
@@ -25,11 +25,13 @@
  * @date   Oct 31, 2023
  */
 
+#include <mola_metric_maps/HashedVoxelPointCloud.h>
 #include <mola_metric_maps/OccGrid.h>
 #include <mola_metric_maps/SparseVoxelPointCloud.h>
 #include <mrpt/io/CMemoryStream.h>
 #include <mrpt/serialization/CArchive.h>
 
+#include <cmath>
 #include <iostream>
 
 template <typename T>
@@ -86,11 +88,39 @@ void test_serialization()
     }
 }
 
+// The raw-block (v1) format must round-trip actual map contents:
+void test_hashedvoxels_roundtrip()
+{
+    mola::HashedVoxelPointCloud map(0.25f /*voxel size*/);
+    for (int i = 0; i < 500; i++)
+        map.insertPoint(
+            {i * 0.01f, std::sin(i * 0.1f) * 5.0f, std::cos(i * 0.07f)});
+
+    mrpt::io::CMemoryStream buf;
+    auto arch = mrpt::serialization::archiveFrom(buf);
+    arch << map;
+    buf.Seek(0);
+
+    mola::HashedVoxelPointCloud map2;
+    arch >> map2;
+
+    size_t n1 = 0, n2 = 0;
+    map.visitAllPoints([&n1](const mrpt::math::TPoint3Df&) { n1++; });
+    map2.visitAllPoints([&n2](const mrpt::math::TPoint3Df&) { n2++; });
+    ASSERT_EQUAL_(n1, n2);
+
+    const auto bb1 = map.boundingBox();
+    const auto bb2 = map2.boundingBox();
+    ASSERT_NEAR_(bb1.min.x, bb2.min.x, 1e-6f);
+    ASSERT_NEAR_(bb1.max.y, bb2.max.y, 1e-6f);
+}
+
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
     try
     {
         test_serialization();
+        test_hashedvoxels_roundtrip();
     }
     catch (std::exception& e)
     {
@@ -27,6 +27,7 @@
 
 #include <mola_metric_maps/SparseVoxelPointCloud.h>
 #include <mrpt/obs/CObservation2DRangeScan.h>
+#include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/stock_observations.h>
 #include <mrpt/opengl/Scene.h>
 
@@ -90,6 +91,114 @@ void test_voxelmap_insert_2d_scan()
 
         ASSERT_EQUAL_(nVoxels, 96UL);
     }
+
+    {
+        // The Morton-ordered flat view must cover all blocks, sorted by key:
+        const auto& mi = map.gridsMortonOrdered();
+        ASSERT_EQUAL_(mi.size(), map.grids().size());
+        for (size_t i = 1; i < mi.size(); i++)
+            ASSERT_(mi[i - 1].first <= mi[i].first);
+
+        // A box covering the whole map must visit every block; a box far
+        // away from it, none:
+        size_t nGrids = 0;
+        map.visitGridsInBox(
+            map.boundingBox(),
+            [&nGrids](
+                const mola::SparseVoxelPointCloud::outer_index3d_t&,
+                const mola::SparseVoxelPointCloud::InnerGrid&) { nGrids++; });
+        ASSERT_EQUAL_(nGrids, map.grids().size());
+
+        nGrids = 0;
+        map.visitGridsInBox(
+            {{1e3f, 1e3f, 1e3f}, {1.1e3f, 1.1e3f, 1.1e3f}},
+            [&nGrids](
+                const mola::SparseVoxelPointCloud::outer_index3d_t&,
+                const mola::SparseVoxelPointCloud::InnerGrid&) { nGrids++; });
+        ASSERT_EQUAL_(nGrids, 0UL);
+    }
+}
+
+void test_voxelmap_ndt_likelihood()
+{
+    mola::SparseVoxelPointCloud map(1.0f /*voxel size*/);
+
+    // A small cluster inside one voxel, elongated along +x:
+    map.insertPoint({-0.30f, 0.0f, 0.0f});
+    map.insertPoint({-0.10f, 0.02f, 0.0f});
+    map.insertPoint({+0.10f, -0.02f, 0.0f});
+    map.insertPoint({+0.30f, 0.0f, 0.0f});
+
+    // The incremental moment statistics must reproduce the sample
+    // mean/covariance of the inserted points:
+    {
+        const auto& [v, grid] = map.voxelByCoords({0.0f, 0.0f, 0.0f});
+        ASSERT_EQUAL_(v.points(grid).size(), 4UL);
+
+        mrpt::math::TPoint3Df      m;
+        mrpt::math::CMatrixFloat33 cov;
+        ASSERT_(v.ndtGaussian(m, cov, 0.0f /*minVar*/));
+
+        ASSERT_NEAR_(m.x, 0.0f, 1e-5f);
+        ASSERT_NEAR_(m.y, 0.0f, 1e-5f);
+        ASSERT_NEAR_(cov(0, 0), 0.05f, 1e-5f);  // E[x^2]
+        ASSERT_NEAR_(cov(1, 1), 2e-4f, 1e-6f);  // E[y^2]
+        ASSERT_NEAR_(cov(2, 2), 0.0f, 1e-6f);
+    }
+
+    // NDT-mode likelihood must peak at the true pose:
+    auto obsPts = mrpt::maps::CSimplePointsMap::Create();
+    obsPts->insertPoint(-0.20f, 0.0f, 0.0f);
+    obsPts->insertPoint(+0.20f, 0.0f, 0.0f);
+
+    auto obs        = mrpt::obs::CObservationPointCloud();
+    obs.pointcloud  = obsPts;
+    obs.sensorLabel = "test";
+
+    map.likelihoodOptions.match_ndt  = true;
+    map.likelihoodOptions.decimation = 1;
+
+    const double llGood =
+        map.computeObservationLikelihood(obs, mrpt::poses::CPose3D::Identity());
+    const double llBad = map.computeObservationLikelihood(
+        obs, mrpt::poses::CPose3D(0.0, 0.4, 0.0, 0.0, 0.0, 0.0));
+
+    ASSERT_GT_(llGood, llBad);
+}
+
+void test_voxelmap_erase_crop_box()
+{
+    mola::SparseVoxelPointCloud map(1.0f /*voxel size*/);
+
+    // Two identical clusters, far enough apart to land in different
+    // 32^3-voxel inner grid blocks:
+    for (int i = 0; i < 10; i++)
+    {
+        map.insertPoint({0.0f + i * 0.1f, 0.0f, 0.0f});
+        map.insertPoint({100.0f + i * 0.1f, 0.0f, 0.0f});
+    }
+
+    const auto countPoints = [&map]() {
+        size_t n = 0;
+        map.visitAllPoints([&n](const mrpt::math::TPoint3Df&) { n++; });
+        return n;
+    };
+    const size_t n0 = countPoints();
+    ASSERT_GT_(n0, 0U);
+
+    // Erase the block(s) holding the far cluster:
+    const auto farBox = mrpt::math::TBoundingBoxf(
+        {95.0f, -5.0f, -5.0f}, {105.0f, 5.0f, 5.0f});
+    ASSERT_GT_(map.eraseBox(farBox), 0U);
+    map.visitAllPoints(
+        [](const mrpt::math::TPoint3Df& p) { ASSERT_LT_(p.x, 50.0f); });
+    ASSERT_EQUAL_(map.eraseBox(farBox), 0U);  // re-running it is a no-op
+
+    // Cropping to the near cluster's region must not drop anything now:
+    const auto nearBox = mrpt::math::TBoundingBoxf(
+        {-5.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f});
+    ASSERT_EQUAL_(map.cropToBox(nearBox), 0U);
+    ASSERT_EQUAL_(countPoints(), n0 / 2);
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
@@ -98,6 +207,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
     {
         test_voxelmap_basic_ops();
         test_voxelmap_insert_2d_scan();
+        test_voxelmap_ndt_likelihood();
+        test_voxelmap_erase_crop_box();
     }
     catch (std::exception& e)
     {
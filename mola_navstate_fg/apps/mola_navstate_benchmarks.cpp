@@ -0,0 +1,425 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   mola_navstate_benchmarks.cpp
+ * @brief  Fusion-latency benchmarks of the navstate filters (JSON output)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ *
+ * Replays a fuse_pose/fuse_odometry/fuse_imu schedule (synthetic by
+ * default, or captured timestamps via `--schedule`) against each navstate
+ * filter at full speed, while measuring per-call latency percentiles of
+ * estimated_navstate() queries issued under the fusion load, as a
+ * controller would. `--json FILE` emits the figures for trend tracking.
+ *
+ * Captured schedule files hold one event per line, `<t_rel_seconds> <kind>`
+ * with kind one of `pose`, `odom`, `imu` ('#' comments allowed); payloads
+ * are synthesized along the benchmark trajectory at those timestamps, so a
+ * capture only needs the event *timing* of a field log.
+ */
+
+#include <mola_navstate_fg/NavStateFG.h>
+#include <mrpt/3rdparty/tclap/CmdLine.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/obs/CObservationIMU.h>
+#include <mrpt/obs/CObservationOdometry.h>
+#include <mrpt/system/CTicTac.h>
+
+#if defined(HAVE_MOLA_NAVSTATE_FUSE)
+#include <mola_navstate_fuse/NavStateFuse.h>
+#endif
+
+#include <Eigen/Dense>  // required by "matrix * scalar"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Declare supported cli switches ===========
+static TCLAP::CmdLine cmd("mola_navstate_benchmarks");
+
+static TCLAP::ValueArg<double> argDuration(
+    "d", "duration",
+    "Length [s] of the synthetic fusion schedule (default: 30)", false, 30.0,
+    "seconds", cmd);
+
+static TCLAP::ValueArg<std::string> argSchedule(
+    "s", "schedule",
+    "Replay a captured schedule file instead of the synthetic one (one "
+    "'<t> <pose|odom|imu>' event per line)",
+    false, "", "file.txt", cmd);
+
+static TCLAP::ValueArg<std::string> argJson(
+    "o", "json", "Write the results as JSON to this file", false, "",
+    "results.json", cmd);
+
+namespace
+{
+enum class EventKind : uint8_t
+{
+    POSE,
+    ODOM,
+    IMU
+};
+
+struct Event
+{
+    double    t = 0;
+    EventKind kind;
+};
+
+/** Synthetic schedule with typical field rates: lidar-odometry poses at
+ * 10 Hz, wheels odometry at 50 Hz, IMU at 200 Hz. */
+std::vector<Event> synthetic_schedule(const double duration)
+{
+    std::vector<Event> evs;
+    for (double t = 0; t < duration; t += 1.0 / 10)
+        evs.push_back({t, EventKind::POSE});
+    for (double t = 0; t < duration; t += 1.0 / 50)
+        evs.push_back({t, EventKind::ODOM});
+    for (double t = 0; t < duration; t += 1.0 / 200)
+        evs.push_back({t, EventKind::IMU});
+
+    std::sort(
+        evs.begin(), evs.end(),
+        [](const Event& a, const Event& b) { return a.t < b.t; });
+    return evs;
+}
+
+std::vector<Event> load_schedule(const std::string& fileName)
+{
+    std::ifstream f(fileName);
+    if (!f.is_open())
+        THROW_EXCEPTION_FMT("Cannot open schedule: '%s'", fileName.c_str());
+
+    std::vector<Event> evs;
+    std::string        line;
+    while (std::getline(f, line))
+    {
+        std::istringstream ss(line);
+        double             t;
+        std::string        kind;
+        if (!(ss >> t >> kind) || kind[0] == '#') continue;
+
+        if (kind == "pose") evs.push_back({t, EventKind::POSE});
+        else if (kind == "odom") evs.push_back({t, EventKind::ODOM});
+        else if (kind == "imu") evs.push_back({t, EventKind::IMU});
+        else
+            THROW_EXCEPTION_FMT("Unknown event kind: '%s'", kind.c_str());
+    }
+    ASSERT_(!evs.empty());
+    ASSERT_(std::is_sorted(
+        evs.begin(), evs.end(),
+        [](const Event& a, const Event& b) { return a.t < b.t; }));
+    return evs;
+}
+
+/** Ground-truth circular trajectory used to synthesize the payloads. */
+mrpt::poses::CPose3D pose_at(const double t)
+{
+    const double w = 0.2 /*rad/s*/, v = 2.0 /*m/s*/, R = v / w;
+    return mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        R * std::sin(w * t), R * (1 - std::cos(w * t)), 0, w * t, 0, 0);
+}
+
+struct LatencyStats
+{
+    size_t count = 0;
+    double p50 = 0, p90 = 0, p99 = 0, max = 0;  //!< [us]
+};
+
+LatencyStats percentiles(std::vector<double>& latenciesUs)
+{
+    LatencyStats s;
+    s.count = latenciesUs.size();
+    if (!s.count) return s;
+
+    std::sort(latenciesUs.begin(), latenciesUs.end());
+    const auto at = [&](const double p)
+    { return latenciesUs[static_cast<size_t>(p * (s.count - 1))]; };
+    s.p50 = at(0.50);
+    s.p90 = at(0.90);
+    s.p99 = at(0.99);
+    s.max = latenciesUs.back();
+    return s;
+}
+
+struct BenchResult
+{
+    std::string  filter;
+    bool         concurrentQueries = false;
+    bool         imuSupported      = true;
+    size_t       fuseCalls         = 0;
+    LatencyStats fuse, query;
+};
+
+/** Replays the schedule at full speed on one thread, measuring per-call
+ * fuse_*() latency. estimated_navstate() queries run from a second thread
+ * at maximum rate when the filter allows concurrent access, or interleaved
+ * after each fuse event otherwise; both modes record per-call latency. */
+BenchResult run_benchmark(
+    const std::string& name, mola::NavStateFilter& nav,
+    const std::vector<Event>& evs, const bool concurrentQueries)
+{
+    const std::string frameId = "odom";
+
+    const auto covI2cm = mrpt::math::CMatrixDouble66(
+        mrpt::math::CMatrixDouble66::Identity() * 0.02);
+
+    BenchResult r;
+    r.filter            = name;
+    r.concurrentQueries = concurrentQueries;
+
+    std::vector<double> fuseLatUs, queryLatUs;
+    fuseLatUs.reserve(evs.size());
+    queryLatUs.reserve(1000000);
+
+    // Timestamp of the newest fused observation, for the query side:
+    std::atomic<double> lastT{-1.0};
+    std::atomic_bool    done{false};
+
+    const auto doQuery = [&](std::vector<double>& lats)
+    {
+        const double t = lastT.load(std::memory_order_relaxed);
+        if (t < 0) return;
+
+        // a controller-like query: slightly ahead of the newest data:
+        mrpt::system::CTicTac tictac;
+        tictac.Tic();
+        (void)nav.estimated_navstate(
+            mrpt::Clock::fromDouble(t + 0.01), frameId);
+        lats.push_back(tictac.Tac() * 1e6);
+    };
+
+    std::thread queryThread;
+    if (concurrentQueries)
+    {
+        queryThread = std::thread(
+            [&]()
+            {
+                while (!done)
+                {
+                    doQuery(queryLatUs);
+                    if (lastT.load(std::memory_order_relaxed) < 0)
+                        std::this_thread::yield();  // replay not started yet
+                }
+            });
+    }
+
+    mrpt::system::CTicTac tictac;
+    for (const auto& ev : evs)
+    {
+        const auto ts = mrpt::Clock::fromDouble(ev.t);
+        switch (ev.kind)
+        {
+            case EventKind::POSE:
+            {
+                mrpt::poses::CPose3DPDFGaussian pdf{pose_at(ev.t), covI2cm};
+                tictac.Tic();
+                nav.fuse_pose(ts, pdf, frameId);
+                fuseLatUs.push_back(tictac.Tac() * 1e6);
+                break;
+            }
+            case EventKind::ODOM:
+            {
+                mrpt::obs::CObservationOdometry odom;
+                odom.timestamp = ts;
+                const auto p   = pose_at(ev.t);
+                odom.odometry  = {p.x(), p.y(), p.yaw()};
+                tictac.Tic();
+                nav.fuse_odometry(odom, frameId);
+                fuseLatUs.push_back(tictac.Tac() * 1e6);
+                break;
+            }
+            case EventKind::IMU:
+            {
+                if (!r.imuSupported) break;
+                mrpt::obs::CObservationIMU imu;
+                imu.timestamp = ts;
+                imu.set(mrpt::obs::IMU_WZ, 0.2);
+                imu.set(mrpt::obs::IMU_X_ACC, 0.0);
+                try
+                {
+                    tictac.Tic();
+                    nav.fuse_imu(imu);
+                    fuseLatUs.push_back(tictac.Tac() * 1e6);
+                }
+                catch (const std::exception&)
+                {
+                    // filter without IMU support (e.g. NavStateFG): skip
+                    // the rest of the IMU events, keep the benchmark fair:
+                    r.imuSupported = false;
+                }
+                break;
+            }
+        };
+        lastT.store(ev.t, std::memory_order_relaxed);
+
+        if (!concurrentQueries) doQuery(queryLatUs);
+    }
+
+    done = true;
+    if (queryThread.joinable()) queryThread.join();
+
+    r.fuseCalls = fuseLatUs.size();
+    r.fuse      = percentiles(fuseLatUs);
+    r.query     = percentiles(queryLatUs);
+    return r;
+}
+
+void print_result(const BenchResult& r)
+{
+    std::printf(
+        "%-14s (%s queries)%s:\n",
+        r.filter.c_str(), r.concurrentQueries ? "concurrent" : "interleaved",
+        r.imuSupported ? "" : " [imu events skipped]");
+    std::printf(
+        "  fuse : %9zu calls, p50=%8.1f us p90=%8.1f us p99=%8.1f us "
+        "max=%8.1f us\n",
+        r.fuse.count, r.fuse.p50, r.fuse.p90, r.fuse.p99, r.fuse.max);
+    std::printf(
+        "  query: %9zu calls, p50=%8.1f us p90=%8.1f us p99=%8.1f us "
+        "max=%8.1f us\n",
+        r.query.count, r.query.p50, r.query.p90, r.query.p99, r.query.max);
+}
+
+void write_json(
+    const std::string& fileName, const std::string& scheduleName,
+    const std::vector<BenchResult>& results)
+{
+    std::ofstream f(fileName, std::ios::trunc);
+    if (!f.is_open())
+        THROW_EXCEPTION_FMT("Cannot write to: '%s'", fileName.c_str());
+
+    const auto stats = [](const LatencyStats& s)
+    {
+        char buf[256];
+        std::snprintf(
+            buf, sizeof(buf),
+            "{\"count\": %zu, \"p50_us\": %.1f, \"p90_us\": %.1f, "
+            "\"p99_us\": %.1f, \"max_us\": %.1f}",
+            s.count, s.p50, s.p90, s.p99, s.max);
+        return std::string(buf);
+    };
+
+    f << "{\n  \"schedule\": \"" << scheduleName << "\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const auto& r = results[i];
+        f << "    {\n"
+          << "      \"filter\": \"" << r.filter << "\",\n"
+          << "      \"concurrent_queries\": "
+          << (r.concurrentQueries ? "true" : "false") << ",\n"
+          << "      \"imu_supported\": " << (r.imuSupported ? "true" : "false")
+          << ",\n"
+          << "      \"fuse_latency\": " << stats(r.fuse) << ",\n"
+          << "      \"query_latency\": " << stats(r.query) << "\n"
+          << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    f << "  ]\n}\n";
+}
+
+const char* navStateFGParams =
+    R"###(# Config for NavStateFGParams
+sliding_window_length: 5.0 # [s]
+max_time_to_use_velocity_model: 2.0  # [s]
+time_between_frames_to_warning: 2.0  # [s]
+sigma_random_walk_acceleration_linear: 1.0 # [m/s²]
+sigma_random_walk_acceleration_angular: 1.0 # [rad/s²]
+sigma_integrator_position: 0.10 # [m]
+sigma_integrator_orientation: 0.10 # [rad]
+robust_param: 0
+max_rmse: 2
+)###";
+
+#if defined(HAVE_MOLA_NAVSTATE_FUSE)
+const char* navStateFuseParams =
+    R"###(# Config for NavStateFuseParams
+max_time_to_use_velocity_model: 2.0  # [s]
+)###";
+#endif
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        // Parse arguments:
+        if (!cmd.parse(argc, argv)) return 1;  // should exit.
+
+        const bool captured = !argSchedule.getValue().empty();
+
+        const auto evs = captured ? load_schedule(argSchedule.getValue())
+                                  : synthetic_schedule(argDuration.getValue());
+
+        std::printf(
+            "Replaying %s schedule: %zu fuse events over %.1f s.\n",
+            captured ? "captured" : "synthetic", evs.size(), evs.back().t);
+
+        std::vector<BenchResult> results;
+
+        {
+            mola::NavStateFG nav;
+            nav.initialize(mrpt::containers::yaml::FromText(navStateFGParams));
+            // NavStateFG is thread-safe: query concurrently, as BridgeROS2
+            // TF lookups and controllers do in the field:
+            results.push_back(run_benchmark(
+                "NavStateFG", nav, evs, true /*concurrent queries*/));
+            print_result(results.back());
+        }
+
+#if defined(HAVE_MOLA_NAVSTATE_FUSE)
+        {
+            mola::NavStateFuse nav;
+            nav.initialize(
+                mrpt::containers::yaml::FromText(navStateFuseParams));
+            // NavStateFuse has no internal locking; interleave the queries:
+            results.push_back(run_benchmark(
+                "NavStateFuse", nav, evs, false /*interleaved queries*/));
+            print_result(results.back());
+        }
+#endif
+
+        if (!argJson.getValue().empty())
+        {
+            write_json(
+                argJson.getValue(), captured ? argSchedule.getValue()
+                                             : "synthetic",
+                results);
+            std::printf(
+                "Results written to: %s\n", argJson.getValue().c_str());
+        }
+
+        return 0;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << "Exit due to exception:\n"
+                  << mrpt::exception_to_str(e) << std::endl;
+        return 1;
+    }
+}
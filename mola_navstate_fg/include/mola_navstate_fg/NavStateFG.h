@@ -28,6 +28,7 @@
 // this package:
 #include <mola_kernel/interfaces/NavStateFilter.h>
 #include <mola_navstate_fg/NavStateFGParams.h>
+#include <mola_navstate_fg/SlidingWindowBuffer.h>
 
 // MOLA:
 #include <mola_imu_preintegration/RotationIntegrator.h>
@@ -43,8 +44,14 @@
 #include <mrpt/system/COutputLogger.h>
 
 // std:
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <thread>
 
 namespace mola
 {
@@ -109,6 +116,27 @@ class NavStateFG : public mola::NavStateFilter
     /** Resets the estimator state to an initial state */
     void reset() override;
 
+    /** Opaque interned handle for a frame name, as returned by
+     * frame_handle(): resolving the name once per source and then feeding
+     * the FrameHandle fuse_*() overloads keeps std::string hashing and
+     * comparisons entirely out of the per-observation fusion path.
+     * Handles remain valid until reset(). */
+    class FrameHandle
+    {
+       public:
+        FrameHandle() = default;
+
+       private:
+        friend class NavStateFG;
+        explicit FrameHandle(uint8_t id) : id_(id) {}
+        uint8_t id_ = 0;
+    };
+
+    /** Returns the interned handle for a frame name, registering the frame
+     * if it was still unknown. Call it once per odometry/localization
+     * source, outside the per-observation path. */
+    FrameHandle frame_handle(const std::string& frame_name);
+
     /** Integrates new SE(3) pose estimation of the vehicle wrt frame_id
      */
     void fuse_pose(
@@ -116,6 +144,13 @@ class NavStateFG : public mola::NavStateFilter
         const mrpt::poses::CPose3DPDFGaussian& pose,
         const std::string&                     frame_id) override;
 
+    /** \overload with a pre-resolved frame handle (see frame_handle()); the
+     * std::string overload is a thin wrapper over this one. */
+    void fuse_pose(
+        const mrpt::Clock::time_point&         timestamp,
+        const mrpt::poses::CPose3DPDFGaussian& pose,
+        const FrameHandle&                     frame);
+
     /** Integrates new wheels-based odometry observations into the estimator.
      *  This is a convenience method that internally ends up calling
      *  fuse_pose(), but computing the uncertainty of odometry increments
@@ -125,6 +160,11 @@ class NavStateFG : public mola::NavStateFilter
         const mrpt::obs::CObservationOdometry& odom,
         const std::string& odomName = "odom_wheels") override;
 
+    /** \overload with a pre-resolved frame handle (see frame_handle()). */
+    void fuse_odometry(
+        const mrpt::obs::CObservationOdometry& odom,
+        const FrameHandle&                     frame);
+
     /** Integrates new IMU observations into the estimator */
     void fuse_imu(const mrpt::obs::CObservationIMU& imu) override;
 
@@ -138,6 +178,11 @@ class NavStateFG : public mola::NavStateFilter
      * observations in the time window. A std::nullopt is returned if there is
      * no valid observations yet, or if requested a timestamp out of the model
      * validity time window (e.g. too far in the future to be trustful).
+     *
+     * With params_.run_background_optimizer enabled, queries in the first
+     * (global) frame are answered wait-free from the latest background
+     * solution (see estimated_navstate_wait_free()) instead of solving on
+     * the caller's thread.
      */
     std::optional<NavState> estimated_navstate(
         const mrpt::Clock::time_point& timestamp,
@@ -146,6 +191,18 @@ class NavStateFG : public mola::NavStateFilter
     /// Returns a list of known frame_ids:
     auto known_frame_ids() -> std::set<std::string>;
 
+    /** Never-blocking read of the most recent published solutions, intended
+     * for high-rate callers (e.g. TF lookups through BridgeROS2) running
+     * concurrently with the fusion thread: the result is extrapolated from
+     * the temporally-nearest snapshot with the constant-velocity model,
+     * without touching the observation window or the solver. A std::nullopt
+     * is returned if nothing has been published yet (snapshots are published
+     * by estimated_navstate() calls on the fusion side), or if the requested
+     * timestamp is too far from the newest snapshot. Results are given in
+     * the first (global) frame of reference. */
+    std::optional<NavState> estimated_navstate_wait_free(
+        const mrpt::Clock::time_point& timestamp) const;
+
     /** @} */
 
    private:
@@ -218,23 +275,141 @@ class NavStateFG : public mola::NavStateFilter
         /// Returns the existing ID, or creates a new ID, for a frame:
         frameid_t frame_id(const std::string& frame_name);
 
-        /// The sliding window of observation data:
-        std::map<mrpt::Clock::time_point, PointData> data;
+        /// The sliding window of observation data, time-ordered over a
+        /// preallocated circular buffer: sliding is O(1) and the
+        /// steady-state fusion path does not allocate:
+        SlidingWindowBuffer<PointData> data;
 
         auto last_pose_of_frame_id(const std::string& frame_id)
             -> std::optional<std::pair<mrpt::Clock::time_point, PoseData>>;
+
+        /// \overload by numeric frame id (hot path: no string lookup)
+        auto last_pose_of_frame_id(const frameid_t frame_id)
+            -> std::optional<std::pair<mrpt::Clock::time_point, PoseData>>;
+
+        /** Cached prior summarizing all states that already left the
+         * sliding window (see params_.marginalize_dropped_states): pose and
+         * twist estimates in the first (global) frame, with their
+         * information matrices, folded incrementally each time
+         * delete_too_old_entries() pops an entry. It is attached as unary
+         * priors on the oldest in-window KF on every solve, so shrinking
+         * the window does not throw information away. */
+        struct MarginalPrior
+        {
+            mrpt::Clock::time_point time;
+
+            mrpt::poses::CPose3D        pose;
+            mrpt::math::CMatrixDouble66 poseInf;  //!< information (cov^-1)
+
+            mrpt::math::TTwist3D        twist;
+            mrpt::math::CMatrixDouble66 twistInf;
+        };
+
+        std::optional<MarginalPrior> marginal;
     };
 
     State state_;
 
+    /** Guards state_ against the background optimizer thread (see
+     * params_.run_background_optimizer); uncontended otherwise. Recursive
+     * because public entry points call each other (fuse_pose() ends up in
+     * fuse_twist()). */
+    std::recursive_mutex state_mtx_;
+
+    /// Seqlock-protected ring with the latest published solutions: a single
+    /// writer (the fusion/solver thread) versus any number of concurrent
+    /// readers, which never block (they just retry the rare torn read).
+    struct SnapshotRing
+    {
+        constexpr static std::size_t LENGTH = 8;
+
+        struct Entry
+        {
+            mrpt::Clock::time_point time{};
+            NavState                state;
+        };
+
+        std::array<Entry, LENGTH> entries;
+        std::size_t               nextWrite = 0;
+
+        /// Seqlock generation: odd while the writer is mutating entries.
+        std::atomic<uint32_t> seq{0};
+
+        /// To be called from the (single) fusion thread only:
+        void publish(const mrpt::Clock::time_point& t, const NavState& s);
+
+        /// \see publish()
+        void clear();
+    };
+
+    SnapshotRing snapshots_;
+
     std::optional<NavState> build_and_optimize_fg(
         const mrpt::Clock::time_point queryTimestamp,
         const std::string&            frame_id);
 
+    /// Incremental (iSAM2) counterpart of build_and_optimize_fg(): feeds
+    /// window entries not yet known to the incremental solver, then answers
+    /// the query with a constant-velocity extrapolation from the nearest
+    /// optimized state. See params_.use_incremental_solver.
+    std::optional<NavState> incremental_update_and_query(
+        const mrpt::Clock::time_point queryTimestamp,
+        const std::string&            frame_id);
+
     /// Implementation of Eqs (1),(4) in the MOLA RSS2019 paper.
     void addFactor(const mola::FactorConstVelKinematics& f);
 
+    /// Appends the unary prior factors (pose & twist observations) of one
+    /// data entry to the impl factor graph, for FG variables keyed by kfId:
+    void add_priors_for(const PointData& d, std::uint64_t kfId);
+
     void delete_too_old_entries();
+
+    /// \name Sliding-window marginalization
+    /// (params_.marginalize_dropped_states)
+    /// @{
+
+    /// Propagates state_.marginal forward to time t with the
+    /// constant-velocity model, inflating its information with the same
+    /// random-walk process noise the in-window factors use. No-op if t is
+    /// not ahead of the cached prior.
+    void predict_marginal_to(const mrpt::Clock::time_point& t);
+
+    /// Folds one window-exiting data entry into state_.marginal: an
+    /// information-form predict/update step, i.e. the Schur complement of
+    /// the dropped state computed incrementally (cross pose-twist
+    /// correlations are approximated as diagonal process noise).
+    void fold_into_marginal_prior(
+        const mrpt::Clock::time_point& time, const PointData& d);
+
+    /// Attaches state_.marginal (if any) as unary priors on the oldest
+    /// in-window KF (kfId 0) of the graph being built:
+    void add_marginal_prior_factors(
+        const mrpt::Clock::time_point& windowFrontTime);
+
+    /// @}
+
+    /// \name Background optimizer (params_.run_background_optimizer)
+    /// @{
+
+    /// Continuously re-optimizes the window as observations arrive and
+    /// publishes each solution into snapshots_ for the wait-free query side.
+    std::thread             bgThread_;
+    std::atomic_bool        bgStop_{false};
+    std::mutex              bgCvMtx_;
+    std::condition_variable bgCv_;
+    bool                    bgPending_ = false;  //!< Guarded by bgCvMtx_
+
+    void start_background_optimizer();
+    void stop_background_optimizer();
+
+    /// Called by fuse_*() to wake up the optimizer thread (no-op if the
+    /// background optimizer is not running):
+    void notify_background_optimizer();
+
+    void background_optimizer_loop();
+
+    /// @}
 };
 
 }  // namespace mola
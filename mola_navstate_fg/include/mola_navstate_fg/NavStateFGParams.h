@@ -66,6 +66,36 @@ class NavStateFGParams
     double robust_param = 0.0;  // 0: no robust
     double max_rmse     = 2.0;
 
+    /** If enabled, states dropped from the sliding window are not simply
+     * discarded: their information is folded into a cached prior (a Schur
+     * complement computed incrementally, in information form) that is
+     * re-attached to the oldest in-window state on every solve. This keeps
+     * the accuracy of a long window with a much shorter (hence cheaper)
+     * one, e.g. 0.5 s instead of 3 s. */
+    bool marginalize_dropped_states = true;
+
+    /** If enabled, the sliding-window graph is optimized incrementally with
+     * iSAM2 as observations arrive, and estimated_navstate() becomes a cheap
+     * constant-velocity extrapolation from the nearest optimized state,
+     * instead of a full Levenberg-Marquardt solve per query. Recommended for
+     * high query rates (e.g. TF lookups at ~100 Hz). */
+    bool use_incremental_solver = false;
+
+    /// Relinearization threshold for iSAM2 (use_incremental_solver=true)
+    double isam2_relinearize_threshold = 0.1;
+
+    /** If enabled, a dedicated thread keeps re-optimizing the window as
+     * observations arrive, and estimated_navstate() becomes a wait-free
+     * constant-velocity extrapolation of the latest published solution (see
+     * estimated_navstate_wait_free()), so concurrent high-rate callers
+     * (e.g. TF publishing plus a 100 Hz controller) never pay the solve
+     * cost on their own threads. */
+    bool run_background_optimizer = false;
+
+    /// Minimum period between background solves, to bound CPU usage with
+    /// very high sensor rates (run_background_optimizer=true; 0=none)
+    double background_optimizer_min_period = 0.0;  // [s]
+
     mrpt::math::TTwist3D initial_twist;
     double               initial_twist_sigma_lin = 20.0;  // [m/s]
     double               initial_twist_sigma_ang = 3.0;  // [rad/s]
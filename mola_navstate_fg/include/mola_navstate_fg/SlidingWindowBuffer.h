@@ -0,0 +1,166 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   SlidingWindowBuffer.h
+ * @brief  Preallocated circular buffer of time-keyed entries
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/core/exceptions.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace mola
+{
+/** Time-ordered sliding window of DATA entries over a preallocated circular
+ * buffer, a drop-in for the `std::map<time_point, DATA>` windows of the
+ * fusion filters: sliding the window is an O(1) pop_front() instead of a
+ * tree erase (no node frees, no rebalancing), in-order insertion is
+ * amortized O(1), and timestamps are binary-searchable. Out-of-order
+ * insertions (rare in practice) shift the newer entries one slot, which is
+ * still allocation-free. Capacity only grows (geometrically) when the
+ * window outgrows it, so the steady-state fusion path never allocates.
+ *
+ * DATA must be cheap to move; entries are addressed by logical index 0
+ * (oldest) to size()-1 (newest).
+ */
+template <class DATA>
+class SlidingWindowBuffer
+{
+   public:
+    using time_point = mrpt::Clock::time_point;
+
+    struct Entry
+    {
+        time_point time{};
+        DATA       data{};
+    };
+
+    SlidingWindowBuffer() : buf_(INITIAL_CAPACITY) {}
+
+    bool        empty() const { return count_ == 0; }
+    std::size_t size() const { return count_; }
+
+    Entry&       at(std::size_t i) { return buf_[phys(i)]; }
+    const Entry& at(std::size_t i) const { return buf_[phys(i)]; }
+
+    Entry&       front() { return at(0); }
+    const Entry& front() const { return at(0); }
+    Entry&       back() { return at(count_ - 1); }
+    const Entry& back() const { return at(count_ - 1); }
+
+    /** Logical index of the first entry with time >= t, or size() if none
+     * (binary search). */
+    std::size_t lower_bound(const time_point& t) const
+    {
+        std::size_t lo = 0, hi = count_;
+        while (lo < hi)
+        {
+            const std::size_t mid = (lo + hi) / 2;
+            if (at(mid).time < t)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    /** Inserts a new entry iff no entry exists at exactly time t (the
+     * semantics of std::map::insert()). Returns false if t already existed.
+     */
+    bool insert(const time_point& t, const DATA& d)
+    {
+        const std::size_t i = lower_bound(t);
+        if (i < count_ && at(i).time == t) return false;
+        insert_at(i, t, d);
+        return true;
+    }
+
+    /** Returns the entry data at exactly time t, creating it if absent (the
+     * semantics of std::map::operator[]()). */
+    DATA& obtain(const time_point& t)
+    {
+        const std::size_t i = lower_bound(t);
+        if (i == count_ || at(i).time != t) insert_at(i, t, DATA());
+        return at(i).data;
+    }
+
+    /** Removes the entry at exactly time t, if it exists. */
+    void erase_time(const time_point& t)
+    {
+        const std::size_t i = lower_bound(t);
+        if (i == count_ || at(i).time != t) return;
+        for (std::size_t k = i; k + 1 < count_; k++)
+            at(k) = std::move(at(k + 1));
+        at(--count_) = Entry();
+    }
+
+    /// O(1): the window-slide operation.
+    void pop_front()
+    {
+        ASSERT_(count_ > 0);
+        buf_[head_] = Entry();  // reset, so old optionals/etc. do not linger
+        head_       = (head_ + 1) % buf_.size();
+        count_--;
+    }
+
+    void clear()
+    {
+        for (auto& e : buf_) e = Entry();
+        head_  = 0;
+        count_ = 0;
+    }
+
+   private:
+    constexpr static std::size_t INITIAL_CAPACITY = 64;
+
+    std::vector<Entry> buf_;  //!< Circular storage; capacity = buf_.size()
+    std::size_t        head_ = 0, count_ = 0;
+
+    std::size_t phys(std::size_t i) const { return (head_ + i) % buf_.size(); }
+
+    void insert_at(const std::size_t i, const time_point& t, const DATA& d)
+    {
+        if (count_ == buf_.size()) grow();
+
+        // Make room by shifting [i, count_) one slot towards the back; a
+        // no-op for in-order arrivals (i == count_):
+        for (std::size_t k = count_; k > i; k--) at(k) = std::move(at(k - 1));
+
+        at(i).time = t;
+        at(i).data = d;
+        count_++;
+    }
+
+    void grow()
+    {
+        std::vector<Entry> bigger(buf_.size() * 2);
+        for (std::size_t i = 0; i < count_; i++)
+            bigger[i] = std::move(buf_[phys(i)]);
+        buf_  = std::move(bigger);
+        head_ = 0;
+    }
+};
+
+}  // namespace mola
@@ -28,33 +28,33 @@
 
 #include <gtsam/geometry/Point3.h>
 #include <gtsam/geometry/Rot3.h>
-#include <gtsam/nonlinear/ExpressionFactor.h>
-#include <gtsam/nonlinear/expressions.h>
-#include <gtsam/slam/expressions.h>
+#include <gtsam/nonlinear/NonlinearFactor.h>
 
 namespace mola
 {
 /**
- * Factor for angular velocity integration model, equivalent to expressions:
+ * Factor for angular velocity integration model:
  *
- *   gtsam::Expression<gtsam::Point3> deltaWi = dt * bWi;
- *   gtsam::Expression<gtsam::Rot3> expmap_(&gtsam::Rot3::Expmap, deltaWi);
+ *   e = Logmap( (Ri · Expmap(dt·bWi))⁻¹ · Rj )
  *
- *   gtsam::between( gtsam::compose(Ri, expmap_), Rj ) = Rot_Identity
+ * i.e. the SO(3) local-coordinates mismatch between Rj and the prediction
+ * of integrating the body-frame angular velocity bWi over dt from Ri.
  *
+ * Implemented as a NoiseModelFactorN with closed-form Jacobians instead of
+ * an expression factor: these factors dominate the evaluation count of the
+ * sliding-window solves, and the hand-derived derivatives avoid the
+ * per-linearization expression-tree traversal.
+ *
+ * (See the unit test test-factor-jacobians, which checks the Jacobians
+ * below against numerical differentiation.)
  */
 class FactorAngularVelocityIntegration
-    : public gtsam::ExpressionFactorN<
-          gtsam::Rot3 /*return type*/, gtsam::Rot3 /* Ri */,
-          gtsam::Point3 /* bWi */, gtsam::Rot3 /* Rj */
-          >
+    : public gtsam::NoiseModelFactorN<gtsam::Rot3, gtsam::Point3, gtsam::Rot3>
 {
    private:
     using This = FactorAngularVelocityIntegration;
-    using Base = gtsam::ExpressionFactorN<
-        gtsam::Rot3 /*return type*/, gtsam::Rot3 /* Ri */,
-        gtsam::Point3 /* bWi */, gtsam::Rot3 /* Rj */
-        >;
+    using Base =
+        gtsam::NoiseModelFactorN<gtsam::Rot3, gtsam::Point3, gtsam::Rot3>;
 
     double dt_ = .0;
 
@@ -66,9 +66,8 @@ class FactorAngularVelocityIntegration
     FactorAngularVelocityIntegration(
         gtsam::Key kRi, gtsam::Key kbWi, gtsam::Key kRj, const double dt,
         const gtsam::SharedNoiseModel& model)
-        : Base({kRi, kbWi, kRj}, model, gtsam::Rot3()), dt_(dt)
+        : Base(model, kRi, kbWi, kRj), dt_(dt)
     {
-        this->initialize(This::expression({kRi, kbWi, kRj}));
     }
 
     /// @return a deep copy of this factor
@@ -78,17 +77,31 @@ class FactorAngularVelocityIntegration
             gtsam::NonlinearFactor::shared_ptr(new This(*this)));
     }
 
-    // Return measurement expression
-    gtsam::Expression<gtsam::Rot3> expression(
-        const std::array<gtsam::Key, NARY_EXPRESSION_SIZE>& keys) const override
+    gtsam::Vector evaluateError(
+        const gtsam::Rot3& Ri, const gtsam::Point3& bWi, const gtsam::Rot3& Rj,
+        gtsam::OptionalMatrixType H_Ri, gtsam::OptionalMatrixType H_bWi,
+        gtsam::OptionalMatrixType H_Rj) const override
     {
-        gtsam::Rot3_                     Ri(keys[0]);
-        gtsam::Point3_                   bWi(keys[1]);
-        gtsam::Rot3_                     Rj(keys[2]);
-        gtsam::Expression<gtsam::Point3> deltaWi = dt_ * bWi;
-        gtsam::Expression<gtsam::Rot3>   expmap_(&gtsam::Rot3::Expmap, deltaWi);
+        const gtsam::Vector3 v = dt_ * bWi;
+        const gtsam::Rot3    D = gtsam::Rot3::Expmap(v);
+
+        // E = (Ri·D)⁻¹ · Rj
+        const gtsam::Rot3 E = (Ri * D).between(Rj);
+
+        gtsam::Matrix3       Hlog;
+        const gtsam::Vector3 e = gtsam::Rot3::Logmap(E, Hlog);
+
+        // Right-perturbation Jacobians, chained through Dlog = Jr⁻¹(e):
+        //  Rj·Expmap(δ)      => E·Expmap(δ)
+        //  Ri·Expmap(δ)      => E·Expmap(-(Ri⁻¹·Rj)ᵀ·δ)
+        //  bWi+δ             => E·Expmap(-Eᵀ·Jr(v)·dt·δ)
+        if (H_Rj) *H_Rj = Hlog;
+        if (H_Ri) *H_Ri = -Hlog * (Rj.matrix().transpose() * Ri.matrix());
+        if (H_bWi)
+            *H_bWi = -Hlog * E.matrix().transpose() *
+                     gtsam::Rot3::ExpmapDerivative(v) * dt_;
 
-        return gtsam::between(gtsam::compose(Ri, expmap_), Rj);
+        return e;
     }
 
     /** implement functions needed for Testable */
@@ -102,7 +115,6 @@ class FactorAngularVelocityIntegration
                   << keyFormatter(Factor::keys_[0]) << ","
                   << keyFormatter(Factor::keys_[1]) << ","
                   << keyFormatter(Factor::keys_[2]) << ")\n";
-        gtsam::traits<gtsam::Rot3>::Print(measured_, "  measured: ");
         gtsam::traits<double>::Print(dt_, "  dt: ");
         this->noiseModel_->print("  noise model: ");
     }
@@ -122,10 +134,6 @@ class FactorAngularVelocityIntegration
     template <class ARCHIVE>
     void serialize(ARCHIVE& ar, const unsigned int /*version*/)
     {
-        // **IMPORTANT** We need to deserialize parameters before the base
-        // class, since it calls expression() and we need all parameters ready
-        // at that point.
-        ar& BOOST_SERIALIZATION_NVP(measured_);
         ar& BOOST_SERIALIZATION_NVP(dt_);
         ar& boost::serialization::make_nvp(
             "FactorAngularVelocityIntegration",
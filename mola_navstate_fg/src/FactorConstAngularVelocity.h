@@ -18,7 +18,7 @@
  * MOLA. If not, see <https://www.gnu.org/licenses/>.
  * ------------------------------------------------------------------------- */
 /**
- * @file   FactorAngularVelocityIntegration.h
+ * @file   FactorConstAngularVelocity.h
  * @brief  GTSAM factor
  * @author Jose Luis Blanco Claraco
  * @date   Jun 13, 2024
@@ -26,29 +26,34 @@
 
 #pragma once
 
+#include <gtsam/base/Matrix.h>
 #include <gtsam/geometry/Point3.h>
 #include <gtsam/geometry/Rot3.h>
-#include <gtsam/nonlinear/ExpressionFactor.h>
-#include <gtsam/nonlinear/expressions.h>
-#include <gtsam/slam/expressions.h>
+#include <gtsam/nonlinear/NonlinearFactor.h>
 
 namespace mola
 {
 /**
- * Factor for constant angular velocity model, equivalent to expression:
+ * Factor for constant body-frame angular velocity, with error:
  *
- *   gtsam::rotate(Ri, bWi) - gtsam::rotate(Rj, bWj) = errZero
+ *   e = Ri·bWi − Rj·bWj
  *
+ * i.e. both body-frame velocity vectors, rotated into the global frame,
+ * should coincide. (NavStateFG also reuses this factor for linear
+ * velocities, which follow the same model.)
+ *
+ * Implemented as a NoiseModelFactorN with closed-form Jacobians instead of
+ * an expression factor; see FactorAngularVelocityIntegration for the
+ * rationale, and test-factor-jacobians for the numeric cross-check.
  */
 class FactorConstAngularVelocity
-    : public gtsam::ExpressionFactorN<
-          gtsam::Point3 /*return type*/, gtsam::Rot3, gtsam::Point3,
-          gtsam::Rot3, gtsam::Point3>
+    : public gtsam::NoiseModelFactorN<
+          gtsam::Rot3, gtsam::Point3, gtsam::Rot3, gtsam::Point3>
 {
    private:
     using This = FactorConstAngularVelocity;
-    using Base = gtsam::ExpressionFactorN<
-        gtsam::Point3, gtsam::Rot3, gtsam::Point3, gtsam::Rot3, gtsam::Point3>;
+    using Base = gtsam::NoiseModelFactorN<
+        gtsam::Rot3, gtsam::Point3, gtsam::Rot3, gtsam::Point3>;
 
    public:
     /// default constructor
@@ -58,9 +63,8 @@ class FactorConstAngularVelocity
     FactorConstAngularVelocity(
         gtsam::Key kRi, gtsam::Key kWi, gtsam::Key kRj, gtsam::Key kWj,
         const gtsam::SharedNoiseModel& model)
-        : Base({kRi, kWi, kRj, kWj}, model, {0, 0, 0})
+        : Base(model, kRi, kWi, kRj, kWj)
     {
-        this->initialize(This::expression({kRi, kWi, kRj, kWj}));
     }
 
     /// @return a deep copy of this factor
@@ -70,15 +74,19 @@ class FactorConstAngularVelocity
             gtsam::NonlinearFactor::shared_ptr(new This(*this)));
     }
 
-    // Return measurement expression
-    gtsam::Expression<gtsam::Point3> expression(
-        const std::array<gtsam::Key, NARY_EXPRESSION_SIZE>& keys) const override
+    gtsam::Vector evaluateError(
+        const gtsam::Rot3& Ri, const gtsam::Point3& bWi, const gtsam::Rot3& Rj,
+        const gtsam::Point3& bWj, gtsam::OptionalMatrixType H_Ri,
+        gtsam::OptionalMatrixType H_bWi, gtsam::OptionalMatrixType H_Rj,
+        gtsam::OptionalMatrixType H_bWj) const override
     {
-        gtsam::Expression<gtsam::Rot3>   Ri_(keys[0]);
-        gtsam::Expression<gtsam::Point3> bWi_(keys[1]);
-        gtsam::Expression<gtsam::Rot3>   Rj_(keys[2]);
-        gtsam::Expression<gtsam::Point3> bWj_(keys[3]);
-        return {gtsam::rotate(Ri_, bWi_) - gtsam::rotate(Rj_, bWj_)};
+        // d(R·w)/dR = -R·[w]x (right perturbation), d(R·w)/dw = R:
+        if (H_Ri) *H_Ri = -Ri.matrix() * gtsam::skewSymmetric(bWi);
+        if (H_bWi) *H_bWi = Ri.matrix();
+        if (H_Rj) *H_Rj = Rj.matrix() * gtsam::skewSymmetric(bWj);
+        if (H_bWj) *H_bWj = -Rj.matrix();
+
+        return Ri.rotate(bWi) - Rj.rotate(bWj);
     }
 
     /** implement functions needed for Testable */
@@ -93,7 +101,6 @@ class FactorConstAngularVelocity
                   << keyFormatter(Factor::keys_[1]) << ","
                   << keyFormatter(Factor::keys_[2]) << ","
                   << keyFormatter(Factor::keys_[3]) << ")\n";
-        gtsam::traits<gtsam::Point3>::Print(measured_, "  measured: ");
         this->noiseModel_->print("  noise model: ");
     }
 
@@ -105,21 +112,12 @@ class FactorConstAngularVelocity
         return e != nullptr && Base::equals(*e, tol);
     }
 
-    /** implement functions needed to derive from Factor */
-
-    /** number of variables attached to this factor */
-    // std::size_t size() const;
-
    private:
     /** Serialization function */
     friend class boost::serialization::access;
     template <class ARCHIVE>
     void serialize(ARCHIVE& ar, const unsigned int /*version*/)
     {
-        // **IMPORTANT** We need to deserialize parameters before the base
-        // class, since it calls expression() and we need all parameters ready
-        // at that point.
-        ar& BOOST_SERIALIZATION_NVP(measured_);
         ar& boost::serialization::make_nvp(
             "FactorConstAngularVelocity",
             boost::serialization::base_object<Base>(*this));
@@ -54,6 +54,10 @@ class FactorTrapezoidalIntegrator
 
     double dt_ = .0;
 
+    /// Trapezoidal-rule coefficient (0.5*dt), derived once at construction
+    /// instead of inside every expression-tree build:
+    double halfDt_ = .0;
+
    public:
     /// default constructor
     FactorTrapezoidalIntegrator()           = default;
@@ -64,7 +68,8 @@ class FactorTrapezoidalIntegrator
         gtsam::Key kPj, gtsam::Key kVj, gtsam::Key kRj,  //
         const double dt, const gtsam::SharedNoiseModel& model)
         : Base({kPi, kVi, kRi, kPj, kVj, kRj}, model, /* error=0 */ {0, 0, 0}),
-          dt_(dt)
+          dt_(dt),
+          halfDt_(0.5 * dt)
     {
         this->initialize(This::expression({kPi, kVi, kRi, kPj, kVj, kRj}));
     }
@@ -90,7 +95,7 @@ class FactorTrapezoidalIntegrator
 
         return {
             Pi_ +
-            0.5 * dt_ * (gtsam::rotate(Ri_, bVi_) + gtsam::rotate(Rj_, bVj_)) -
+            halfDt_ * (gtsam::rotate(Ri_, bVi_) + gtsam::rotate(Rj_, bVj_)) -
             Pj_};
     }
 
@@ -133,6 +138,7 @@ class FactorTrapezoidalIntegrator
         // at that point.
         ar& BOOST_SERIALIZATION_NVP(measured_);
         ar& BOOST_SERIALIZATION_NVP(dt_);
+        halfDt_ = 0.5 * dt_;
         ar& boost::serialization::make_nvp(
             "FactorTrapezoidalIntegrator",
             boost::serialization::base_object<Base>(*this));
@@ -27,7 +27,10 @@
 // MOLA & MRPT:
 #include <mola_navstate_fg/NavStateFG.h>
 #include <mrpt/core/get_env.h>
+#include <mrpt/core/lock_helper.h>
+#include <mrpt/system/thread_name.h>
 #include <mrpt/math/gtsam_wrappers.h>
+#include <mrpt/poses/Lie/SE.h>
 #include <mrpt/poses/Lie/SO.h>
 #include <mrpt/poses/gtsam_wrappers.h>
 
@@ -37,6 +40,7 @@
 #include <gtsam/nonlinear/ExpressionFactor.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/nonlinear/LevenbergMarquardtParams.h>
+#include <gtsam/nonlinear/ISAM2.h>
 #include <gtsam/nonlinear/Marginals.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Symbol.h>
@@ -50,6 +54,10 @@
 #include "FactorConstAngularVelocity.h"
 #include "FactorTrapezoidalIntegrator.h"
 
+// std:
+#include <chrono>
+#include <memory>
+
 const bool NAVSTATE_PRINT_FG = mrpt::get_env<bool>("NAVSTATE_PRINT_FG", false);
 const bool NAVSTATE_PRINT_FG_ERRORS =
     mrpt::get_env<bool>("NAVSTATE_PRINT_FG_ERRORS", false);
@@ -71,6 +79,34 @@ struct NavStateFG::GtsamImpl
 
     gtsam::NonlinearFactorGraph fg;
     gtsam::Values               values;
+
+    // Incremental mode only (see params_.use_incremental_solver):
+    std::unique_ptr<gtsam::ISAM2> isam2;
+
+    /// Stable FG keys assigned to each fed timestamp. Unlike the
+    /// window-relative indices of the batch path, iSAM2 requires keys that
+    /// do not shift as the sliding window advances:
+    std::map<mrpt::Clock::time_point, std::uint64_t> timeToKey;
+    std::uint64_t                                    nextKfId = 0;
+
+    /// Shared cache of 3-dim isotropic noise models, keyed by sigma.
+    /// Consecutive window rebuilds recreate factors with identical dt (and
+    /// hence sigma) for all but the newest entry pair, so sharing these
+    /// saves one heap allocation per factor per rebuild:
+    std::map<double, gtsam::SharedNoiseModel> isoNoise3Cache;
+
+    gtsam::SharedNoiseModel isoNoise3(double sigma)
+    {
+        if (auto it = isoNoise3Cache.find(sigma); it != isoNoise3Cache.end())
+            return it->second;
+
+        // bound the memory of very long runs:
+        if (isoNoise3Cache.size() > 4096) isoNoise3Cache.clear();
+
+        auto m = gtsam::noiseModel::Isotropic::Sigma(3, sigma);
+        isoNoise3Cache.emplace(sigma, m);
+        return m;
+    }
 };
 
 // -------- NavStateFG::State -------
@@ -95,13 +131,19 @@ NavStateFG::frameid_t NavStateFG::State::frame_id(const std::string& frame_name)
 std::optional<std::pair<mrpt::Clock::time_point, NavStateFG::PoseData>>
     NavStateFG::State::last_pose_of_frame_id(const std::string& frameId)
 {
-    const auto frId = frame_id(frameId);
-    for (auto it = data.rbegin(); it != data.rend(); ++it)
+    return last_pose_of_frame_id(frame_id(frameId));
+}
+
+std::optional<std::pair<mrpt::Clock::time_point, NavStateFG::PoseData>>
+    NavStateFG::State::last_pose_of_frame_id(const frameid_t frId)
+{
+    for (size_t i = data.size(); i-- > 0;)
     {
-        if (!it->second.pose) continue;
-        const auto& p = *it->second.pose;
+        const auto& e = data.at(i);
+        if (!e.data.pose) continue;
+        const auto& p = *e.data.pose;
         if (p.frameId != frId) continue;
-        return std::make_pair(it->first, p);
+        return std::make_pair(e.time, p);
     }
     return {};
 }
@@ -112,7 +154,7 @@ NavStateFG::NavStateFG()
     this->mrpt::system::COutputLogger::setLoggerName("NavStateFG");
 }
 
-NavStateFG::~NavStateFG() = default;
+NavStateFG::~NavStateFG() { stop_background_optimizer(); }
 
 void NavStateFG::initialize(const mrpt::containers::yaml& cfg)
 {
@@ -120,28 +162,44 @@ void NavStateFG::initialize(const mrpt::containers::yaml& cfg)
 
     // Load params:
     params_.loadFrom(cfg);
+
+    if (params_.run_background_optimizer) start_background_optimizer();
 }
 
 void NavStateFG::reset()
 {
     // reset:
+    auto lck = mrpt::lockHelper(state_mtx_);
+
     state_ = State();
+    snapshots_.clear();
+}
+
+NavStateFG::FrameHandle NavStateFG::frame_handle(const std::string& frame_name)
+{
+    ASSERT_(!frame_name.empty());
+
+    auto lck = mrpt::lockHelper(state_mtx_);
+    return FrameHandle(state_.frame_id(frame_name));
 }
 
 void NavStateFG::fuse_odometry(
     const mrpt::obs::CObservationOdometry& odom, const std::string& odomName)
 {
-    using namespace std::string_literals;
+    ASSERT_(!odomName.empty());
+    fuse_odometry(odom, frame_handle(odomName));
+}
 
+void NavStateFG::fuse_odometry(
+    const mrpt::obs::CObservationOdometry& odom, const FrameHandle& frame)
+{
     THROW_EXCEPTION("finish implementation!");
 
-    ASSERT_(!odomName.empty());
-
     OdomData d;
-    d.frameId = state_.frame_id(odomName);
+    d.frameId = frame.id_;
     d.pose    = mrpt::poses::CPose3D(odom.odometry);
 
-    state_.data.insert({odom.timestamp, d});
+    state_.data.insert(odom.timestamp, d);
 
     delete_too_old_entries();
 }
@@ -158,18 +216,30 @@ void NavStateFG::fuse_pose(
     const mrpt::Clock::time_point&         timestamp,
     const mrpt::poses::CPose3DPDFGaussian& pose, const std::string& frame_id)
 {
+    // Thin wrapper: all the work happens in the FrameHandle overload, so
+    // callers that intern their frame once never touch std::string here:
+    fuse_pose(timestamp, pose, frame_handle(frame_id));
+}
+
+void NavStateFG::fuse_pose(
+    const mrpt::Clock::time_point&         timestamp,
+    const mrpt::poses::CPose3DPDFGaussian& pose, const FrameHandle& frame)
+{
+    auto lck = mrpt::lockHelper(state_mtx_);
+
     // find last KF of this frame_id before adding the new one:
-    const auto lastKF = state_.last_pose_of_frame_id(frame_id);
+    const auto lastKF = state_.last_pose_of_frame_id(frame.id_);
 
     // numerical sanity:
     for (int i = 0; i < 6; i++) ASSERT_GT_(pose.cov(i, i), .0);
 
     PoseData d;
-    d.frameId = state_.frame_id(frame_id);
+    d.frameId = frame.id_;
     d.pose    = pose;
 
-    state_.data.insert({timestamp, d});
+    state_.data.insert(timestamp, d);
     delete_too_old_entries();
+    notify_background_optimizer();
 
     // Estimate twist:
     // If we add an additional direct observation of twist, the result is
@@ -220,23 +290,49 @@ void NavStateFG::fuse_twist(
     const mrpt::Clock::time_point& timestamp, const mrpt::math::TTwist3D& twist,
     const mrpt::math::CMatrixDouble66& twistCov)
 {
+    auto lck = mrpt::lockHelper(state_mtx_);
+
     TwistData d;
     d.twist    = twist;
     d.twistCov = twistCov;
 
-    state_.data.insert({timestamp, d});
+    state_.data.insert(timestamp, d);
 
     delete_too_old_entries();
+    notify_background_optimizer();
 }
 
 std::optional<NavState> NavStateFG::estimated_navstate(
     const mrpt::Clock::time_point& timestamp, const std::string& frame_id)
 {
+    // Query side of the background optimizer: answer from the latest
+    // published solution, without ever running the solver on the caller's
+    // thread. Wait-free results are in the first (global) frame, so other
+    // frames (and the warm-up before the first solution) fall through to a
+    // synchronous solve below:
+    if (bgThread_.joinable())
+    {
+        if (auto ret = estimated_navstate_wait_free(timestamp); ret)
+        {
+            auto lck = mrpt::lockHelper(state_mtx_);
+            if (state_.known_frames.hasKey(frame_id) &&
+                state_.known_frames.direct(frame_id) == 0)
+                return ret;
+        }
+    }
+
+    auto lck = mrpt::lockHelper(state_mtx_);
+
+    if (params_.use_incremental_solver)
+        return incremental_update_and_query(timestamp, frame_id);
+
     return build_and_optimize_fg(timestamp, frame_id);
 }
 
 std::set<std::string> NavStateFG::known_frame_ids()
 {
+    auto lck = mrpt::lockHelper(state_mtx_);
+
     std::set<std::string> ret;
     for (const auto& [name, id] : state_.known_frames.getDirectMap())
         ret.insert(name);
@@ -244,6 +340,83 @@ std::set<std::string> NavStateFG::known_frame_ids()
     return ret;
 }
 
+// -------- NavStateFG::SnapshotRing -------
+void NavStateFG::SnapshotRing::publish(
+    const mrpt::Clock::time_point& t, const NavState& s)
+{
+    seq.fetch_add(1, std::memory_order_acq_rel);  // odd: write in course
+
+    entries[nextWrite].time  = t;
+    entries[nextWrite].state = s;
+    nextWrite                = (nextWrite + 1) % LENGTH;
+
+    seq.fetch_add(1, std::memory_order_release);  // even again
+}
+
+void NavStateFG::SnapshotRing::clear()
+{
+    seq.fetch_add(1, std::memory_order_acq_rel);
+
+    for (auto& e : entries) e = Entry();
+    nextWrite = 0;
+
+    seq.fetch_add(1, std::memory_order_release);
+}
+
+std::optional<NavState> NavStateFG::estimated_navstate_wait_free(
+    const mrpt::Clock::time_point& timestamp) const
+{
+    std::array<SnapshotRing::Entry, SnapshotRing::LENGTH> copy;
+
+    // Seqlock read: retry on the (rare) overlap with the writer. Readers
+    // never block the fusion thread, nor each other:
+    for (;;)
+    {
+        const auto s0 = snapshots_.seq.load(std::memory_order_acquire);
+        if (s0 & 1) continue;  // writer in course
+
+        copy = snapshots_.entries;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (snapshots_.seq.load(std::memory_order_relaxed) == s0) break;
+    }
+
+    // Pick the temporally-nearest published entry:
+    const SnapshotRing::Entry* best      = nullptr;
+    double                     bestAbsDt = 0;
+    for (const auto& e : copy)
+    {
+        if (e.time == mrpt::Clock::time_point()) continue;  // unused slot
+
+        const double absDt =
+            std::abs(mrpt::system::timeDifference(e.time, timestamp));
+        if (!best || absDt < bestAbsDt)
+        {
+            best      = &e;
+            bestAbsDt = absDt;
+        }
+    }
+    if (!best || bestAbsDt > params_.max_time_to_use_velocity_model)
+        return {};
+
+    const double dt = mrpt::system::timeDifference(best->time, timestamp);
+
+    NavState out = best->state;
+
+    // Constant-velocity extrapolation with the body-frame twist:
+    mrpt::math::CVectorFixedDouble<6> delta;
+    delta[0] = out.twist.vx * dt;
+    delta[1] = out.twist.vy * dt;
+    delta[2] = out.twist.vz * dt;
+    delta[3] = out.twist.wx * dt;
+    delta[4] = out.twist.wy * dt;
+    delta[5] = out.twist.wz * dt;
+
+    out.pose.mean = out.pose.mean + mrpt::poses::Lie::SE<3>::exp(delta);
+
+    return out;
+}
+
 std::optional<NavState> NavStateFG::build_and_optimize_fg(
     const mrpt::Clock::time_point queryTimestamp, const std::string& frame_id)
 {
@@ -256,9 +429,9 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
     if (state_.data.empty() || state_.known_frames.empty()) return {};
     {
         const double tq_2_tfirst = mrpt::system::timeDifference(
-            queryTimestamp, state_.data.begin()->first);
+            queryTimestamp, state_.data.front().time);
         const double tlast_2_tq = mrpt::system::timeDifference(
-            state_.data.rbegin()->first, queryTimestamp);
+            state_.data.back().time, queryTimestamp);
         if (tq_2_tfirst > params_.max_time_to_use_velocity_model ||
             tlast_2_tq > params_.max_time_to_use_velocity_model)
         {
@@ -282,18 +455,18 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
 
     // Build the sequence of time points:
     // FG variable indices will use the indices in this vector:
-    auto& dQuery = state_.data[queryTimestamp];
-    dQuery.query = QueryPointData();
+    state_.data.obtain(queryTimestamp).query = QueryPointData();
 
-    using map_it_t = std::map<mrpt::Clock::time_point, PointData>::value_type;
+    using window_entry_t = SlidingWindowBuffer<PointData>::Entry;
 
-    std::vector<const map_it_t*> entries;
-    std::optional<size_t>        query_KF_id;
-    for (const auto& it : state_.data)
+    std::vector<const window_entry_t*> entries;
+    std::optional<size_t>              query_KF_id;
+    for (size_t i = 0; i < state_.data.size(); i++)
     {
-        if (it.first == queryTimestamp) query_KF_id = entries.size();
+        const auto& e = state_.data.at(i);
+        if (e.time == queryTimestamp) query_KF_id = entries.size();
 
-        entries.push_back(&it);
+        entries.push_back(&e);
     }
     ASSERT_(query_KF_id.has_value());
 
@@ -306,7 +479,7 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
         f.from_kf_   = i - 1;
         f.to_kf_     = i;
         f.deltaTime_ = mrpt::system::timeDifference(
-            entries[i - 1]->first, entries[i]->first);
+            entries[i - 1]->time, entries[i]->time);
 
         addFactor(f);
     }
@@ -334,113 +507,24 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
     const auto& tw = params_.initial_twist;
     fg.addPrior(
         V(0), gtsam::Vector3(tw.vx, tw.vy, tw.vz),
-        gtsam::noiseModel::Isotropic::Sigma(
-            3, params_.initial_twist_sigma_lin));
+        state_.impl->isoNoise3(params_.initial_twist_sigma_lin));
 
     fg.addPrior(
         W(0), gtsam::Vector3(tw.wx, tw.wy, tw.wz),
-        gtsam::noiseModel::Isotropic::Sigma(
-            3, params_.initial_twist_sigma_ang));
+        state_.impl->isoNoise3(params_.initial_twist_sigma_ang));
+
+    // Cached prior from marginalized (window-exited) states, attached to the
+    // oldest in-window KF so a short window keeps long-window accuracy:
+    add_marginal_prior_factors(entries.front()->time);
 
     // Process pose observations:
     // ------------------------------------------
     for (size_t kfId = 0; kfId < entries.size(); kfId++)
     {
-        // const auto  tim = entries.at(kfId)->first;
-        const auto& d = entries.at(kfId)->second;
-
-        // ---------------------------------
-        // Data point of type: Pose
-        // ---------------------------------
-        if (d.pose.has_value())
-        {
-            if (d.pose->frameId == 0)
-            {
-                // Pose observations in the first frame are just priors:
-                // (see paper!)
-
-                gtsam::Pose3   p;
-                gtsam::Matrix6 pCov;
-                mrpt::gtsam_wrappers::to_gtsam_se3_cov6(d.pose->pose, p, pCov);
-
-                {
-                    auto noisePos = gtsam::noiseModel::Gaussian::Covariance(
-                        pCov.block<3, 3>(3, 3));
-
-                    gtsam::noiseModel::Base::shared_ptr robNoisePos;
-                    if (params_.robust_param > 0)
-                        robNoisePos = gtsam::noiseModel::Robust::Create(
-                            gtsam::noiseModel::mEstimator::GemanMcClure::Create(
-                                params_.robust_param),
-                            noisePos);
-                    else
-                        robNoisePos = noisePos;
-
-                    fg.addPrior(P(kfId), p.translation(), robNoisePos);
-                }
-
-                {
-                    auto noiseRot = gtsam::noiseModel::Gaussian::Covariance(
-                        pCov.block<3, 3>(0, 0));
-
-                    gtsam::noiseModel::Base::shared_ptr robNoiseRot;
-                    if (params_.robust_param > 0)
-                        robNoiseRot = gtsam::noiseModel::Robust::Create(
-                            gtsam::noiseModel::mEstimator::GemanMcClure::Create(
-                                params_.robust_param),
-                            noiseRot);
-                    else
-                        robNoiseRot = noiseRot;
-
-                    fg.addPrior(R(kfId), p.rotation(), robNoiseRot);
-                }
-            }
-            else
-            {
-                // Pose observations in subsequent frames are more complex:
-                // (see paper!)
-                THROW_EXCEPTION("todo");
-            }
-        }
-
-        // ---------------------------------
-        // Data point of type: Twist
-        // ---------------------------------
-        if (d.twist.has_value())
-        {
-            const auto&          pd   = d.twist.value();
-            const gtsam::Vector3 v    = {pd.twist.vx, pd.twist.vy, pd.twist.vz};
-            const gtsam::Vector3 w    = {pd.twist.wx, pd.twist.wy, pd.twist.wz};
-            gtsam::Matrix3       vCov = pd.twistCov.asEigen().block<3, 3>(0, 0);
-            gtsam::Matrix3       wCov = pd.twistCov.asEigen().block<3, 3>(3, 3);
-
-            {
-                auto noiseV = gtsam::noiseModel::Gaussian::Covariance(vCov);
-                gtsam::noiseModel::Base::shared_ptr robNoiseV;
-                if (params_.robust_param > 0)
-                    robNoiseV = gtsam::noiseModel::Robust::Create(
-                        gtsam::noiseModel::mEstimator::GemanMcClure::Create(
-                            params_.robust_param),
-                        noiseV);
-                else
-                    robNoiseV = noiseV;
+        // const auto  tim = entries.at(kfId)->time;
+        const auto& d = entries.at(kfId)->data;
 
-                fg.addPrior(V(kfId), v, robNoiseV);
-            }
-            {
-                auto noiseW = gtsam::noiseModel::Gaussian::Covariance(wCov);
-                gtsam::noiseModel::Base::shared_ptr robNoiseW;
-                if (params_.robust_param > 0)
-                    robNoiseW = gtsam::noiseModel::Robust::Create(
-                        gtsam::noiseModel::mEstimator::GemanMcClure::Create(
-                            params_.robust_param),
-                        noiseW);
-                else
-                    robNoiseW = noiseW;
-
-                fg.addPrior(W(kfId), w, robNoiseW);
-            }
-        }
+        add_priors_for(d, kfId);
 
     }  // end for each kfId
 
@@ -475,10 +559,12 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
         std::cout << "\n query_KF_id: " << *query_KF_id << std::endl;
 
         MRPT_LOG_INFO_STREAM("state_.data: ");
-        for (const auto& [k, v] : state_.data)
+        for (size_t i = 0; i < state_.data.size(); i++)
         {
+            const auto& e = state_.data.at(i);
             MRPT_LOG_INFO_FMT(
-                "t=%f: %s", mrpt::Clock::toDouble(k), v.asString().c_str());
+                "t=%f: %s", mrpt::Clock::toDouble(e.time),
+                e.data.asString().c_str());
         }
     }
 
@@ -537,8 +623,9 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
     out.twist_inv_cov = tw_cov_inv;
 
     // delete temporary entry:
+    auto& dQuery = state_.data.obtain(queryTimestamp);
     dQuery.query.reset();
-    if (dQuery.empty()) state_.data.erase(queryTimestamp);
+    if (dQuery.empty()) state_.data.erase_time(queryTimestamp);
 
     // Honor requested frame_id:
     // ----------------------------------
@@ -557,6 +644,9 @@ std::optional<NavState> NavStateFG::build_and_optimize_fg(
         THROW_EXCEPTION("TODO");
     }
 
+    // Publish for wait-free readers (see estimated_navstate_wait_free()):
+    snapshots_.publish(queryTimestamp, out);
+
     return out;
 }
 
@@ -614,22 +704,20 @@ void NavStateFG::addFactor(const mola::FactorConstVelKinematics& f)
     // Modify to use velocity in local frame: reuse FactorConstAngularVelocity
     // here too:
     state_.impl->fg.emplace_shared<FactorConstAngularVelocity>(
-        kRi, kbVi, kRj, kbVj,
-        gtsam::noiseModel::Isotropic::Sigma(3, std_linvel * dt));
+        kRi, kbVi, kRj, kbVj, state_.impl->isoNoise3(std_linvel * dt));
 
     // \omega is in the body frame, we need a special factor to rotate it:
     // See line 4 of eq (4) in the MOLA RSS2019 paper.
     state_.impl->fg.emplace_shared<FactorConstAngularVelocity>(
-        kRi, kbWi, kRj, kbWj,
-        gtsam::noiseModel::Isotropic::Sigma(3, std_angvel * dt));
+        kRi, kbWi, kRj, kbWj, state_.impl->isoNoise3(std_angvel * dt));
 
     // 2) Add kinematics / numerical integration factor
     // ---------------------------------------------------
-    auto noise_kinematicsPosition = gtsam::noiseModel::Isotropic::Sigma(
-        3, params_.sigma_integrator_position);
+    auto noise_kinematicsPosition =
+        state_.impl->isoNoise3(params_.sigma_integrator_position);
 
-    auto noise_kinematicsOrientation = gtsam::noiseModel::Isotropic::Sigma(
-        3, params_.sigma_integrator_orientation);
+    auto noise_kinematicsOrientation =
+        state_.impl->isoNoise3(params_.sigma_integrator_orientation);
 
     // Impl. line 2 of eq (1) in the MOLA RSS2019 paper
     state_.impl->fg.emplace_shared<FactorTrapezoidalIntegrator>(
@@ -640,23 +728,602 @@ void NavStateFG::addFactor(const mola::FactorConstVelKinematics& f)
         kRi, kbWi, kRj, dt, noise_kinematicsOrientation);
 }
 
+void NavStateFG::add_priors_for(const PointData& d, std::uint64_t kfId)
+{
+    auto& fg = state_.impl->fg;
+
+    // ---------------------------------
+    // Data point of type: Pose
+    // ---------------------------------
+    if (d.pose.has_value())
+    {
+        if (d.pose->frameId == 0)
+        {
+            // Pose observations in the first frame are just priors:
+            // (see paper!)
+
+            gtsam::Pose3   p;
+            gtsam::Matrix6 pCov;
+            mrpt::gtsam_wrappers::to_gtsam_se3_cov6(d.pose->pose, p, pCov);
+
+            {
+                auto noisePos = gtsam::noiseModel::Gaussian::Covariance(
+                    pCov.block<3, 3>(3, 3));
+
+                gtsam::noiseModel::Base::shared_ptr robNoisePos;
+                if (params_.robust_param > 0)
+                    robNoisePos = gtsam::noiseModel::Robust::Create(
+                        gtsam::noiseModel::mEstimator::GemanMcClure::Create(
+                            params_.robust_param),
+                        noisePos);
+                else
+                    robNoisePos = noisePos;
+
+                fg.addPrior(P(kfId), p.translation(), robNoisePos);
+            }
+
+            {
+                auto noiseRot = gtsam::noiseModel::Gaussian::Covariance(
+                    pCov.block<3, 3>(0, 0));
+
+                gtsam::noiseModel::Base::shared_ptr robNoiseRot;
+                if (params_.robust_param > 0)
+                    robNoiseRot = gtsam::noiseModel::Robust::Create(
+                        gtsam::noiseModel::mEstimator::GemanMcClure::Create(
+                            params_.robust_param),
+                        noiseRot);
+                else
+                    robNoiseRot = noiseRot;
+
+                fg.addPrior(R(kfId), p.rotation(), robNoiseRot);
+            }
+        }
+        else
+        {
+            // Pose observations in subsequent frames are more complex:
+            // (see paper!)
+            THROW_EXCEPTION("todo");
+        }
+    }
+
+    // ---------------------------------
+    // Data point of type: Twist
+    // ---------------------------------
+    if (d.twist.has_value())
+    {
+        const auto&          pd   = d.twist.value();
+        const gtsam::Vector3 v    = {pd.twist.vx, pd.twist.vy, pd.twist.vz};
+        const gtsam::Vector3 w    = {pd.twist.wx, pd.twist.wy, pd.twist.wz};
+        gtsam::Matrix3       vCov = pd.twistCov.asEigen().block<3, 3>(0, 0);
+        gtsam::Matrix3       wCov = pd.twistCov.asEigen().block<3, 3>(3, 3);
+
+        {
+            auto noiseV = gtsam::noiseModel::Gaussian::Covariance(vCov);
+            gtsam::noiseModel::Base::shared_ptr robNoiseV;
+            if (params_.robust_param > 0)
+                robNoiseV = gtsam::noiseModel::Robust::Create(
+                    gtsam::noiseModel::mEstimator::GemanMcClure::Create(
+                        params_.robust_param),
+                    noiseV);
+            else
+                robNoiseV = noiseV;
+
+            fg.addPrior(V(kfId), v, robNoiseV);
+        }
+        {
+            auto noiseW = gtsam::noiseModel::Gaussian::Covariance(wCov);
+            gtsam::noiseModel::Base::shared_ptr robNoiseW;
+            if (params_.robust_param > 0)
+                robNoiseW = gtsam::noiseModel::Robust::Create(
+                    gtsam::noiseModel::mEstimator::GemanMcClure::Create(
+                        params_.robust_param),
+                    noiseW);
+            else
+                robNoiseW = noiseW;
+
+            fg.addPrior(W(kfId), w, robNoiseW);
+        }
+    }
+}
+
+std::optional<NavState> NavStateFG::incremental_update_and_query(
+    const mrpt::Clock::time_point queryTimestamp, const std::string& frame_id)
+{
+    using namespace std::string_literals;
+
+    delete_too_old_entries();
+
+    // Same validity checks as the batch path:
+    if (state_.data.empty() || state_.known_frames.empty()) return {};
+    {
+        const double tq_2_tfirst = mrpt::system::timeDifference(
+            queryTimestamp, state_.data.front().time);
+        const double tlast_2_tq = mrpt::system::timeDifference(
+            state_.data.back().time, queryTimestamp);
+        if (tq_2_tfirst > params_.max_time_to_use_velocity_model ||
+            tlast_2_tq > params_.max_time_to_use_velocity_model)
+        {
+            MRPT_LOG_DEBUG_STREAM(
+                "[incremental_update_and_query] Skipping due to need to "
+                "extrapolate too much: tq_2_tfirst="
+                << tq_2_tfirst << " tlast_2_tq=" << tlast_2_tq);
+
+            return {};
+        }
+    }
+
+    auto& impl = *state_.impl;
+
+    // The solver state is discarded if: (a) it does not exist yet, (b) most
+    // fed entries already slid out of the window (cheap amortized substitute
+    // for exact variable marginalization), or (c) an observation arrived
+    // out-of-order, which would break the const-velocity factor chain:
+    bool rebuild = !impl.isam2;
+
+    if (!rebuild)
+    {
+        const auto  windowStart = state_.data.front().time;
+        std::size_t nStale      = 0;
+        for (const auto& kv : impl.timeToKey)
+            if (kv.first < windowStart) nStale++;
+
+        if (2 * nStale > impl.timeToKey.size()) rebuild = true;
+
+        const auto lastFedTime = impl.timeToKey.empty()
+                                     ? windowStart
+                                     : impl.timeToKey.rbegin()->first;
+        for (size_t i = 0; i < state_.data.size(); i++)
+        {
+            const auto& t = state_.data.at(i).time;
+            if (t >= lastFedTime) break;
+            if (impl.timeToKey.count(t) == 0)
+            {
+                rebuild = true;
+                break;
+            }
+        }
+    }
+
+    if (rebuild)
+    {
+        gtsam::ISAM2Params isamParams;
+        isamParams.relinearizeThreshold = params_.isam2_relinearize_threshold;
+        isamParams.relinearizeSkip      = 1;
+
+        impl.isam2 = std::make_unique<gtsam::ISAM2>(isamParams);
+        impl.timeToKey.clear();
+    }
+
+    // Feed entries not yet known to the solver, reusing impl.fg/values as
+    // the scratch "new factors" graph:
+    auto& fg     = impl.fg;
+    auto& values = impl.values;
+    fg.resize(0);
+    values.clear();
+
+    std::optional<mrpt::Clock::time_point> prevTime;
+    std::optional<std::uint64_t>           prevKey;
+    if (!impl.timeToKey.empty())
+    {
+        prevTime = impl.timeToKey.rbegin()->first;
+        prevKey  = impl.timeToKey.rbegin()->second;
+    }
+
+    // Initial guesses are propagated from the last optimized state:
+    gtsam::Point3 lastP = gtsam::Z_3x1;
+    gtsam::Rot3   lastR = gtsam::Rot3::Identity();
+    gtsam::Point3 lastV = gtsam::Z_3x1;
+    gtsam::Point3 lastW = gtsam::Z_3x1;
+    if (prevKey)
+    {
+        lastP = impl.isam2->calculateEstimate<gtsam::Point3>(P(*prevKey));
+        lastR = impl.isam2->calculateEstimate<gtsam::Rot3>(R(*prevKey));
+        lastV = impl.isam2->calculateEstimate<gtsam::Point3>(V(*prevKey));
+        lastW = impl.isam2->calculateEstimate<gtsam::Point3>(W(*prevKey));
+    }
+
+    for (size_t i = 0; i < state_.data.size(); i++)
+    {
+        const auto& t = state_.data.at(i).time;
+        const auto& d = state_.data.at(i).data;
+
+        if (impl.timeToKey.count(t) != 0) continue;  // already fed
+
+        const auto key    = impl.nextKfId++;
+        impl.timeToKey[t] = key;
+
+        if (d.pose.has_value() && d.pose->frameId == 0)
+        {
+            gtsam::Pose3   gp;
+            gtsam::Matrix6 pCov;
+            mrpt::gtsam_wrappers::to_gtsam_se3_cov6(d.pose->pose, gp, pCov);
+            lastP = gp.translation();
+            lastR = gp.rotation();
+        }
+
+        values.insert<gtsam::Point3>(P(key), lastP);
+        values.insert<gtsam::Rot3>(R(key), lastR);
+        values.insert<gtsam::Point3>(V(key), lastV);
+        values.insert<gtsam::Point3>(W(key), lastW);
+
+        if (prevKey)
+        {
+            mola::FactorConstVelKinematics f;
+            f.from_kf_   = *prevKey;
+            f.to_kf_     = key;
+            f.deltaTime_ = mrpt::system::timeDifference(*prevTime, t);
+
+            addFactor(f);
+        }
+        else
+        {
+            // Unary prior for initial twist (cf. the batch path):
+            const auto& tw = params_.initial_twist;
+            fg.addPrior(
+                V(key), gtsam::Vector3(tw.vx, tw.vy, tw.vz),
+                impl.isoNoise3(params_.initial_twist_sigma_lin));
+
+            fg.addPrior(
+                W(key), gtsam::Vector3(tw.wx, tw.wy, tw.wz),
+                impl.isoNoise3(params_.initial_twist_sigma_ang));
+        }
+
+        add_priors_for(d, key);
+
+        prevTime = t;
+        prevKey  = key;
+    }
+
+    if (!fg.empty() || !values.empty())
+    {
+        impl.isam2->update(fg, values);
+
+        fg.resize(0);
+        values.clear();
+    }
+
+    ASSERT_(!impl.timeToKey.empty());
+
+    // Answer the query from the temporally-nearest optimized state,
+    // extrapolated with the constant-velocity model (body-frame twist):
+    auto itRef = impl.timeToKey.lower_bound(queryTimestamp);
+    if (itRef == impl.timeToKey.end()) { --itRef; }
+    else if (itRef != impl.timeToKey.begin())
+    {
+        const auto itPrev = std::prev(itRef);
+        if (std::abs(
+                mrpt::system::timeDifference(itPrev->first, queryTimestamp)) <
+            std::abs(mrpt::system::timeDifference(itRef->first, queryTimestamp)))
+            itRef = itPrev;
+    }
+
+    const auto   tRef = itRef->first;
+    const auto   kRef = itRef->second;
+    const double dt   = mrpt::system::timeDifference(tRef, queryTimestamp);
+
+    const auto refP = impl.isam2->calculateEstimate<gtsam::Point3>(P(kRef));
+    const auto refR = impl.isam2->calculateEstimate<gtsam::Rot3>(R(kRef));
+    const auto refV = impl.isam2->calculateEstimate<gtsam::Point3>(V(kRef));
+    const auto refW = impl.isam2->calculateEstimate<gtsam::Point3>(W(kRef));
+
+    NavState out;
+
+    const auto refPose = mrpt::poses::CPose3D(
+        mrpt::gtsam_wrappers::toTPose3D(gtsam::Pose3(refR, refP)));
+
+    // SE(3) increment spanned by the body-frame twist over dt:
+    mrpt::math::CVectorFixedDouble<6> delta;
+    for (int i = 0; i < 3; i++)
+    {
+        delta[i]     = refV[i] * dt;
+        delta[3 + i] = refW[i] * dt;
+    }
+    out.pose.mean = refPose + mrpt::poses::Lie::SE<3>::exp(delta);
+
+    out.twist.vx = refV.x();
+    out.twist.vy = refV.y();
+    out.twist.vz = refV.z();
+    out.twist.wx = refW.x();
+    out.twist.wy = refW.y();
+    out.twist.wz = refW.z();
+
+    // Marginals come almost for free from the iSAM2 Bayes tree:
+    gtsam::Matrix6 cov_inv = gtsam::Matrix6::Zero();
+    cov_inv.block<3, 3>(0, 0) =
+        impl.isam2->marginalCovariance(P(kRef)).inverse();
+    cov_inv.block<3, 3>(3, 3) =
+        impl.isam2->marginalCovariance(R(kRef)).inverse();
+    out.pose.cov_inv = cov_inv;
+
+    gtsam::Matrix6 tw_cov_inv = gtsam::Matrix6::Zero();
+    tw_cov_inv.block<3, 3>(0, 0) =
+        impl.isam2->marginalCovariance(V(kRef)).inverse();
+    tw_cov_inv.block<3, 3>(3, 3) =
+        impl.isam2->marginalCovariance(W(kRef)).inverse();
+    out.twist_inv_cov = tw_cov_inv;
+
+    // Honor requested frame_id:
+    // ----------------------------------
+    ASSERTMSG_(
+        state_.known_frames.hasKey(frame_id),
+        "Requested results in unknown frame_id: '"s + frame_id + "'"s);
+
+    if (state_.known_frames.direct(frame_id) != 0)
+    {
+        // Results in frames != 0 need the F(i) transform (see batch path):
+        THROW_EXCEPTION("TODO");
+    }
+
+    // Publish for wait-free readers: the solution *at* tRef rather than the
+    // extrapolated one, so readers always extrapolate from fresh data:
+    {
+        NavState refState  = out;
+        refState.pose.mean = refPose;
+        snapshots_.publish(tRef, refState);
+    }
+
+    return out;
+}
+
 void NavStateFG::delete_too_old_entries()
 {
     if (state_.data.empty()) return;
 
-    const double newestTime =
-        mrpt::Clock::toDouble(state_.data.rbegin()->first);
-    const double minTime = newestTime - params_.sliding_window_length;
+    const double newestTime = mrpt::Clock::toDouble(state_.data.back().time);
+    const double minTime    = newestTime - params_.sliding_window_length;
+
+    // Entries are kept in time order, so the window slide is just O(1)
+    // pops off the front (no tree rebalancing, no node frees):
+    while (!state_.data.empty() &&
+           mrpt::Clock::toDouble(state_.data.front().time) < minTime)
+    {
+        // Do not throw the information away: fold it into the cached
+        // marginal prior, so short windows do not drift (see docs of
+        // params_.marginalize_dropped_states):
+        if (params_.marginalize_dropped_states)
+        {
+            const auto& e = state_.data.front();
+            fold_into_marginal_prior(e.time, e.data);
+        }
+
+        state_.data.pop_front();
+    }
+}
 
-    for (auto it = state_.data.begin(); it != state_.data.end();)
+void NavStateFG::predict_marginal_to(const mrpt::Clock::time_point& t)
+{
+    auto& m = *state_.marginal;
+
+    const double dt = mrpt::system::timeDifference(m.time, t);
+    if (dt <= 0) return;
+
+    // Mean: constant-velocity motion with the marginal twist estimate:
+    mrpt::math::CVectorFixedDouble<6> delta;
+    delta[0] = m.twist.vx * dt;
+    delta[1] = m.twist.vy * dt;
+    delta[2] = m.twist.vz * dt;
+    delta[3] = m.twist.wx * dt;
+    delta[4] = m.twist.wy * dt;
+    delta[5] = m.twist.wz * dt;
+
+    m.pose = m.pose + mrpt::poses::Lie::SE<3>::exp(delta);
+
+    // Information: deflate with the same random-walk process noise the
+    // in-window constant-velocity factors use (see addFactor()). Done in
+    // covariance form; cross pose-twist terms are approximated as diagonal
+    // noise, which keeps the fold O(6³) per dropped state:
+    const auto inflate = [](mrpt::math::CMatrixDouble66& inf, const double s1,
+                            const double s2)
     {
-        const double t = mrpt::Clock::toDouble(it->first);
-        if (t < minTime)
+        if (inf.asEigen().trace() <= 0) return;  // no information yet
+
+        Eigen::Matrix<double, 6, 6> C = inf.asEigen().inverse();
+        for (int i = 0; i < 3; i++)
         {
-            // remove it:
-            it = state_.data.erase(it);
+            C(i, i) += mrpt::square(s1);
+            C(3 + i, 3 + i) += mrpt::square(s2);
         }
-        else { ++it; }
+        inf.asEigen() = C.inverse();
+    };
+
+    inflate(
+        m.poseInf,  //
+        params_.sigma_integrator_position,
+        params_.sigma_integrator_orientation);
+    inflate(
+        m.twistInf,  //
+        params_.sigma_random_walk_acceleration_linear * dt,
+        params_.sigma_random_walk_acceleration_angular * dt);
+
+    m.time = t;
+}
+
+void NavStateFG::fold_into_marginal_prior(
+    const mrpt::Clock::time_point& time, const PointData& d)
+{
+    // Pose observations in frames != 0 would need the (unsolved) F(i)
+    // frame alignment to be folded into global coordinates; those are
+    // discarded, exactly as before:
+    const bool usablePose  = d.pose.has_value() && d.pose->frameId == 0;
+    const bool usableTwist = d.twist.has_value();
+    if (!usablePose && !usableTwist) return;
+
+    if (!state_.marginal)
+    {
+        // Seed the prior with the first usable dropped pose:
+        if (!usablePose) return;
+
+        auto& m = state_.marginal.emplace();
+        m.time  = time;
+        m.pose  = d.pose->pose.mean;
+        m.poseInf.asEigen() = d.pose->pose.cov.asEigen().inverse();
+        if (usableTwist)
+        {
+            m.twist = d.twist->twist;
+            m.twistInf.asEigen() = d.twist->twistCov.asEigen().inverse();
+        }
+        else { m.twistInf.setZero(); }
+        return;
+    }
+
+    // 1) Predict: move the cached prior forward to this entry's time:
+    predict_marginal_to(time);
+    auto& m = *state_.marginal;
+
+    // 2) Update: information-weighted fusion of the dropped observations.
+    // For the pose, one Gauss-Newton step in the tangent space of the
+    // prediction; this is the incremental Schur complement of the dropped
+    // state for our (linearized) unary priors:
+    if (usablePose)
+    {
+        const auto& obs = d.pose->pose;
+
+        const Eigen::Matrix<double, 6, 6> Iobs = obs.cov.asEigen().inverse();
+        const auto err = mrpt::poses::Lie::SE<3>::log(obs.mean - m.pose);
+
+        const Eigen::Matrix<double, 6, 6> Isum =
+            m.poseInf.asEigen() + Iobs;
+        mrpt::math::CVectorFixedDouble<6> dv;
+        dv.asEigen() = Isum.ldlt().solve(Iobs * err.asEigen());
+
+        m.pose              = m.pose + mrpt::poses::Lie::SE<3>::exp(dv);
+        m.poseInf.asEigen() = Isum;
+    }
+
+    if (usableTwist)
+    {
+        const Eigen::Matrix<double, 6, 6> Iobs =
+            d.twist->twistCov.asEigen().inverse();
+
+        Eigen::Matrix<double, 6, 1> xPrior, xObs;
+        for (int i = 0; i < 6; i++)
+        {
+            xPrior[i] = m.twist[i];
+            xObs[i]   = d.twist->twist[i];
+        }
+
+        const Eigen::Matrix<double, 6, 6> Isum =
+            m.twistInf.asEigen() + Iobs;
+        const Eigen::Matrix<double, 6, 1> xNew =
+            Isum.ldlt().solve(m.twistInf.asEigen() * xPrior + Iobs * xObs);
+
+        for (int i = 0; i < 6; i++) m.twist[i] = xNew[i];
+        m.twistInf.asEigen() = Isum;
+    }
+}
+
+void NavStateFG::add_marginal_prior_factors(
+    const mrpt::Clock::time_point& windowFrontTime)
+{
+    if (!state_.marginal) return;
+
+    // Bring the cached prior up to the time of KF 0 before attaching it:
+    predict_marginal_to(windowFrontTime);
+    const auto& m = *state_.marginal;
+
+    auto& fg = state_.impl->fg;
+
+    // Pose prior. Note the gtsam cov ordering from to_gtsam_se3_cov6():
+    // rotation block at (0,0), translation at (3,3):
+    mrpt::poses::CPose3DPDFGaussian posePdf;
+    posePdf.mean          = m.pose;
+    posePdf.cov.asEigen() = m.poseInf.asEigen().inverse();
+
+    gtsam::Pose3   p;
+    gtsam::Matrix6 pCov;
+    mrpt::gtsam_wrappers::to_gtsam_se3_cov6(posePdf, p, pCov);
+
+    fg.addPrior(
+        P(0), p.translation(),
+        gtsam::noiseModel::Gaussian::Covariance(pCov.block<3, 3>(3, 3)));
+    fg.addPrior(
+        R(0), p.rotation(),
+        gtsam::noiseModel::Gaussian::Covariance(pCov.block<3, 3>(0, 0)));
+
+    // Twist prior (only once some twist information has been folded):
+    if (m.twistInf.asEigen().trace() > 0)
+    {
+        const Eigen::Matrix<double, 6, 6> twCov =
+            m.twistInf.asEigen().inverse();
+
+        fg.addPrior(
+            V(0), gtsam::Vector3(m.twist.vx, m.twist.vy, m.twist.vz),
+            gtsam::noiseModel::Gaussian::Covariance(twCov.block<3, 3>(0, 0)));
+        fg.addPrior(
+            W(0), gtsam::Vector3(m.twist.wx, m.twist.wy, m.twist.wz),
+            gtsam::noiseModel::Gaussian::Covariance(twCov.block<3, 3>(3, 3)));
+    }
+}
+
+// -------- Background optimizer -------
+void NavStateFG::start_background_optimizer()
+{
+    if (bgThread_.joinable()) return;  // already running
+
+    bgStop_   = false;
+    bgThread_ = std::thread(&NavStateFG::background_optimizer_loop, this);
+    mrpt::system::thread_name("navstate_fg_opt", bgThread_);
+}
+
+void NavStateFG::stop_background_optimizer()
+{
+    bgStop_ = true;
+    bgCv_.notify_all();
+    if (bgThread_.joinable()) bgThread_.join();
+}
+
+void NavStateFG::notify_background_optimizer()
+{
+    if (!bgThread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lck(bgCvMtx_);
+        bgPending_ = true;
+    }
+    bgCv_.notify_one();
+}
+
+void NavStateFG::background_optimizer_loop()
+{
+    using namespace std::chrono_literals;
+
+    while (!bgStop_)
+    {
+        {
+            std::unique_lock<std::mutex> lck(bgCvMtx_);
+            bgCv_.wait_for(
+                lck, 100ms, [this]() { return bgPending_ || bgStop_.load(); });
+            if (bgStop_) break;
+            if (!bgPending_) continue;
+            bgPending_ = false;
+        }
+
+        try
+        {
+            auto lck = mrpt::lockHelper(state_mtx_);
+            if (state_.data.empty() || state_.known_frames.empty()) continue;
+
+            // Solve at the newest observation time, in the first (global)
+            // frame. The solver publishes each solution into snapshots_,
+            // where estimated_navstate() / estimated_navstate_wait_free()
+            // read it without blocking on this thread:
+            const auto t      = state_.data.back().time;
+            const auto frame0 = state_.known_frames.inverse(0);
+
+            if (params_.use_incremental_solver)
+                incremental_update_and_query(t, frame0);
+            else
+                build_and_optimize_fg(t, frame0);
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM(
+                "[background_optimizer] " << mrpt::exception_to_str(e));
+        }
+
+        // Optional rate bound, e.g. for very high IMU rates:
+        if (params_.background_optimizer_min_period > 0 && !bgStop_)
+            std::this_thread::sleep_for(std::chrono::duration<double>(
+                params_.background_optimizer_min_period));
     }
 }
 
@@ -45,6 +45,14 @@ void NavStateFGParams::loadFrom(const mrpt::containers::yaml& cfg)
     MCP_LOAD_OPT(cfg, max_rmse);
     MCP_LOAD_OPT(cfg, robust_param);
 
+    MCP_LOAD_OPT(cfg, marginalize_dropped_states);
+
+    MCP_LOAD_OPT(cfg, use_incremental_solver);
+    MCP_LOAD_OPT(cfg, isam2_relinearize_threshold);
+
+    MCP_LOAD_OPT(cfg, run_background_optimizer);
+    MCP_LOAD_OPT(cfg, background_optimizer_min_period);
+
     if (cfg.has("initial_twist"))
     {
         ASSERT_(
@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-factor-jacobians.cpp
+ * @brief  Check the closed-form factor Jacobians against numerical ones
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <gtsam/base/numericalDerivative.h>
+#include <gtsam/nonlinear/Symbol.h>
+#include <mrpt/core/exceptions.h>
+
+#include <iostream>
+
+#include "../src/FactorAngularVelocityIntegration.h"
+#include "../src/FactorConstAngularVelocity.h"
+
+namespace
+{
+
+constexpr double JACOBIAN_TOL = 1e-6;
+
+// A few hand-picked linearization points, including the identity and
+// clearly non-trivial rotations/velocities:
+const std::vector<gtsam::Rot3> testRotations = {
+    gtsam::Rot3::Identity(),
+    gtsam::Rot3::RzRyRx(0.2, -0.1, 0.5),
+    gtsam::Rot3::RzRyRx(-1.2, 0.8, -0.3),
+    gtsam::Rot3::RzRyRx(2.9, -1.4, 1.7),
+};
+
+const std::vector<gtsam::Point3> testVelocities = {
+    {0.0, 0.0, 0.0},
+    {0.1, -0.2, 0.3},
+    {-1.5, 0.7, 2.0},
+};
+
+void test_angular_velocity_integration_jacobians()
+{
+    using gtsam::symbol_shorthand::R;
+    using gtsam::symbol_shorthand::W;
+
+    const auto noise = gtsam::noiseModel::Isotropic::Sigma(3, 0.1);
+
+    for (const double dt : {0.01, 0.25})
+    {
+        const mola::FactorAngularVelocityIntegration f(
+            R(0), W(0), R(1), dt, noise);
+
+        const auto err = [&f](
+                             const gtsam::Rot3& Ri, const gtsam::Point3& bWi,
+                             const gtsam::Rot3& Rj) -> gtsam::Vector
+        { return f.evaluateError(Ri, bWi, Rj); };
+
+        for (const auto& Ri : testRotations)
+            for (const auto& bWi : testVelocities)
+                for (const auto& Rj : testRotations)
+                {
+                    gtsam::Matrix H1, H2, H3;
+                    f.evaluateError(Ri, bWi, Rj, &H1, &H2, &H3);
+
+                    const gtsam::Matrix H1n =
+                        gtsam::numericalDerivative31<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3>(err, Ri, bWi, Rj);
+                    const gtsam::Matrix H2n =
+                        gtsam::numericalDerivative32<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3>(err, Ri, bWi, Rj);
+                    const gtsam::Matrix H3n =
+                        gtsam::numericalDerivative33<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3>(err, Ri, bWi, Rj);
+
+                    ASSERT_LT_(
+                        (H1 - H1n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                    ASSERT_LT_(
+                        (H2 - H2n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                    ASSERT_LT_(
+                        (H3 - H3n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                }
+    }
+}
+
+void test_const_angular_velocity_jacobians()
+{
+    using gtsam::symbol_shorthand::R;
+    using gtsam::symbol_shorthand::W;
+
+    const auto noise = gtsam::noiseModel::Isotropic::Sigma(3, 0.1);
+
+    const mola::FactorConstAngularVelocity f(R(0), W(0), R(1), W(1), noise);
+
+    const auto err = [&f](
+                         const gtsam::Rot3& Ri, const gtsam::Point3& bWi,
+                         const gtsam::Rot3& Rj,
+                         const gtsam::Point3& bWj) -> gtsam::Vector
+    { return f.evaluateError(Ri, bWi, Rj, bWj); };
+
+    for (const auto& Ri : testRotations)
+        for (const auto& bWi : testVelocities)
+            for (const auto& Rj : testRotations)
+                for (const auto& bWj : testVelocities)
+                {
+                    gtsam::Matrix H1, H2, H3, H4;
+                    f.evaluateError(Ri, bWi, Rj, bWj, &H1, &H2, &H3, &H4);
+
+                    const gtsam::Matrix H1n =
+                        gtsam::numericalDerivative41<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3, gtsam::Point3>(err, Ri, bWi, Rj, bWj);
+                    const gtsam::Matrix H2n =
+                        gtsam::numericalDerivative42<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3, gtsam::Point3>(err, Ri, bWi, Rj, bWj);
+                    const gtsam::Matrix H3n =
+                        gtsam::numericalDerivative43<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3, gtsam::Point3>(err, Ri, bWi, Rj, bWj);
+                    const gtsam::Matrix H4n =
+                        gtsam::numericalDerivative44<
+                            gtsam::Vector, gtsam::Rot3, gtsam::Point3,
+                            gtsam::Rot3, gtsam::Point3>(err, Ri, bWi, Rj, bWj);
+
+                    ASSERT_LT_(
+                        (H1 - H1n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                    ASSERT_LT_(
+                        (H2 - H2n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                    ASSERT_LT_(
+                        (H3 - H3n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                    ASSERT_LT_(
+                        (H4 - H4n).lpNorm<Eigen::Infinity>(), JACOBIAN_TOL);
+                }
+}
+
+}  // namespace
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_angular_velocity_integration_jacobians();
+        test_const_angular_velocity_jacobians();
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+}
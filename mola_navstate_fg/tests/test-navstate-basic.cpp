@@ -31,9 +31,11 @@
 #include <mrpt/system/os.h>
 
 #include <Eigen/Dense>  // required by "matrix * scalar"
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <map>
+#include <thread>
 
 using namespace std::string_literals;
 
@@ -165,6 +167,30 @@ void test_one_pose_extrapolate()
         nav.params_.initial_twist_sigma_lin);
 }
 
+// --------------------------------------
+void test_frame_handle()
+{
+    const auto& _ = Data::Instance();
+
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(navStateParams));
+
+    const auto t0 = mrpt::Clock::fromDouble(.0);
+
+    // The interned-handle overload must behave exactly like the string one:
+    const auto hOdom = nav.frame_handle("odom");
+    nav.fuse_pose(t0, _.pdf0, hOdom);
+
+    ASSERT_EQUAL_(nav.known_frame_ids().count("odom"), 1UL);
+
+    const auto ret = nav.estimated_navstate(t0, "odom");
+    ASSERT_(ret.has_value());
+
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret->pose.mean - _.pdf0.mean).norm(), 0.0,
+        1e-4);
+}
+
 // --------------------------------------
 void test_2_poses()
 {
@@ -203,6 +229,116 @@ void test_2_poses()
         1e-2);
 }
 
+// --------------------------------------
+void test_2_poses_incremental()
+{
+    const auto& _ = Data::Instance();
+
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(
+        navStateParams + "use_incremental_solver: true\n"s));
+
+    const auto t0 = mrpt::Clock::fromDouble(0.0);
+    const auto t1 = mrpt::Clock::fromDouble(0.5);
+
+    const auto t2 = mrpt::Clock::fromDouble(0.6);
+    const auto t3 = mrpt::Clock::fromDouble(0.25);
+
+    nav.fuse_pose(t0, _.pdf0, "odom");
+    nav.fuse_pose(t1, _.pdf1, "odom");
+
+    const auto ret2 = nav.estimated_navstate(t2, "odom");
+    ASSERT_(ret2.has_value());
+
+    const auto ret3 = nav.estimated_navstate(t3, "odom");
+    ASSERT_(ret3.has_value());
+
+    const auto expected2 = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        0.6, 0.0, 0.0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret2->pose.mean - expected2).norm(), 0.0,
+        1e-2);
+
+    const auto expected3 = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        0.25, 0.0, 0.0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret3->pose.mean - expected3).norm(), 0.0,
+        1e-2);
+}
+
+// --------------------------------------
+void test_wait_free_snapshot()
+{
+    const auto& _ = Data::Instance();
+
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(navStateParams));
+
+    const auto t0 = mrpt::Clock::fromDouble(0.0);
+    const auto t1 = mrpt::Clock::fromDouble(0.5);
+    const auto t2 = mrpt::Clock::fromDouble(0.6);
+
+    // nothing published yet:
+    ASSERT_(!nav.estimated_navstate_wait_free(t1).has_value());
+
+    nav.fuse_pose(t0, _.pdf0, "odom");
+    nav.fuse_pose(t1, _.pdf1, "odom");
+
+    // a query on the fusion side publishes a snapshot:
+    const auto ret = nav.estimated_navstate(t1, "odom");
+    ASSERT_(ret.has_value());
+
+    const auto retWF = nav.estimated_navstate_wait_free(t2);
+    ASSERT_(retWF.has_value());
+
+    const auto expected2 = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        0.6, 0.0, 0.0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(retWF->pose.mean - expected2).norm(), 0.0,
+        1e-2);
+}
+
+// --------------------------------------
+void test_background_optimizer()
+{
+    const auto& _ = Data::Instance();
+
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(
+        navStateParams + "run_background_optimizer: true\n"s));
+
+    const auto t0 = mrpt::Clock::fromDouble(0.0);
+    const auto t1 = mrpt::Clock::fromDouble(0.5);
+    const auto t2 = mrpt::Clock::fromDouble(0.6);
+
+    nav.fuse_pose(t0, _.pdf0, "odom");
+    nav.fuse_pose(t1, _.pdf1, "odom");
+
+    // The background thread must eventually publish a solution; until then
+    // queries fall back to a synchronous solve, so either way a valid
+    // estimate must come out:
+    const auto ret = nav.estimated_navstate(t2, "odom");
+    ASSERT_(ret.has_value());
+
+    const auto expected2 = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        0.6, 0.0, 0.0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret->pose.mean - expected2).norm(), 0.0,
+        1e-2);
+
+    // Wait for the wait-free side to be served by the background thread:
+    std::optional<mola::NavState> retWF;
+    for (int i = 0; i < 100 && !retWF; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        retWF = nav.estimated_navstate_wait_free(t2);
+    }
+    ASSERT_(retWF.has_value());
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(retWF->pose.mean - expected2).norm(), 0.0,
+        1e-2);
+}
+
 // --------------------------------------
 void test_2_poses_too_late()
 {
@@ -316,6 +452,85 @@ void test_noisy_straight()
     ASSERT_NEAR_(ret->twist.wz, .0, 0.01);
 }
 
+// --------------------------------------
+void test_long_run_window_slide()
+{
+    const auto& _ = Data::Instance();
+
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(navStateParams));
+
+    // 20 s of data at 10 Hz with a 5 s window: most entries slide out, and
+    // one observation arrives out-of-order on purpose:
+    const double vx = 2.0, T = 0.1;
+    const size_t nSteps = 200;
+
+    for (size_t i = 0; i < nSteps; i++)
+    {
+        // swap the order of steps 50 and 51:
+        size_t k = i;
+        if (i == 50) k = 51;
+        if (i == 51) k = 50;
+
+        const double tt = T * k;
+        const auto   p  = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+            vx * tt, 0, 0, .0_deg, .0_deg, .0_deg);
+
+        nav.fuse_pose(
+            mrpt::Clock::fromDouble(tt),
+            mrpt::poses::CPose3DPDFGaussian{p, _.I6_2cm}, "odom");
+    }
+
+    const double tt_q = T * nSteps;
+    const auto   ret = nav.estimated_navstate(mrpt::Clock::fromDouble(tt_q), "odom");
+    ASSERT_(ret.has_value());
+
+    const auto expected = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        vx * tt_q, 0, 0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret->pose.mean - expected).norm(), 0.0,
+        1e-1);
+    ASSERT_NEAR_(ret->twist.vx, vx, 0.1);
+}
+
+// --------------------------------------
+void test_marginalized_short_window()
+{
+    const auto& _ = Data::Instance();
+
+    // A deliberately tiny window: without marginalization of the dropped
+    // states this would have almost no history to anchor the solution:
+    mola::NavStateFG nav;
+    nav.initialize(mrpt::containers::yaml::FromText(
+        navStateParams + "sliding_window_length: 0.5\n"s));
+
+    const double vx = 2.0, T = 0.1;
+    const size_t nSteps = 100;
+
+    for (size_t i = 0; i < nSteps; i++)
+    {
+        const double tt = T * i;
+        const auto   p  = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+            vx * tt, 0, 0, .0_deg, .0_deg, .0_deg);
+
+        nav.fuse_pose(
+            mrpt::Clock::fromDouble(tt),
+            mrpt::poses::CPose3DPDFGaussian{p, _.I6_2cm}, "odom");
+    }
+
+    const double tt_q = T * nSteps;
+    const auto   ret =
+        nav.estimated_navstate(mrpt::Clock::fromDouble(tt_q), "odom");
+    ASSERT_(ret.has_value());
+
+    const auto expected = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
+        vx * tt_q, 0, 0, .0_deg, .0_deg, .0_deg);
+    ASSERT_NEAR_(
+        mrpt::poses::Lie::SE<3>::log(ret->pose.mean - expected).norm(), 0.0,
+        1e-1);
+    ASSERT_NEAR_(ret->twist.vx, vx, 0.1);
+}
+
 }  // namespace
 
 int main(int argc, char** argv)
@@ -324,10 +539,16 @@ int main(int argc, char** argv)
         {"test_init_state", test_init_state},
         {"test_one_pose", test_one_pose},
         {"test_one_pose_extrap", test_one_pose_extrapolate},
+        {"test_frame_handle", test_frame_handle},
         {"test_2_poses", test_2_poses},
+        {"test_2_poses_incremental", test_2_poses_incremental},
+        {"test_background_optimizer", test_background_optimizer},
         {"test_2_poses_too_late", test_2_poses_too_late},
         {"test_3_poses", test_3_poses},
         {"test_noisy_straight", test_noisy_straight},
+        {"test_long_run_window_slide", test_long_run_window_slide},
+        {"test_marginalized_short_window", test_marginalized_short_window},
+        {"test_wait_free_snapshot", test_wait_free_snapshot},
     };
 
     int runOnlyIdx = -1;
@@ -33,6 +33,7 @@
 #include <mrpt/obs/CObservationOdometry.h>
 #include <mrpt/poses/CPose3DPDFGaussian.h>
 
+#include <cstdint>
 #include <optional>
 
 namespace mola
@@ -131,9 +132,24 @@ class NavStateFuse : public mola::NavStateFilter
         std::optional<mrpt::poses::CPose3DPDFGaussian> last_pose;
         std::optional<mrpt::math::TTwist3D>            last_twist;
         bool pose_already_updated_with_odom = false;
+
+        /// Incremented by every fuse_*() call; lets estimated_navstate()
+        /// detect that its memoized answer is still valid (see QueryCache):
+        uint32_t version = 0;
+    };
+
+    /// Memoized last query: at high query rates (e.g. a 50 Hz wheel-odometry
+    /// consumer polling between fusion updates) repeated queries against an
+    /// unchanged state skip the extrapolation and 6x6 inversion entirely:
+    struct QueryCache
+    {
+        std::optional<mrpt::Clock::time_point> timestamp;
+        uint32_t                               stateVersion = 0;
+        NavState                               result;
     };
 
-    State state_;
+    State      state_;
+    QueryCache queryCache_;
 };
 
 }  // namespace mola
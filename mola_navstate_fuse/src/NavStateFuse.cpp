@@ -41,7 +41,8 @@ void NavStateFuse::initialize(const mrpt::containers::yaml& cfg)
 void NavStateFuse::reset()
 {
     // reset:
-    state_ = State();
+    state_     = State();
+    queryCache_ = QueryCache();
 }
 
 void NavStateFuse::fuse_odometry(
@@ -62,6 +63,7 @@ void NavStateFuse::fuse_odometry(
     }
     // copy:
     state_.last_odom_obs = odom;
+    state_.version++;
 }
 
 void NavStateFuse::fuse_imu(const mrpt::obs::CObservationIMU& imu)
@@ -109,6 +111,7 @@ void NavStateFuse::fuse_pose(
     state_.last_pose                      = pose;
     state_.last_pose_obs_tim              = timestamp;
     state_.pose_already_updated_with_odom = false;
+    state_.version++;
 }
 
 void NavStateFuse::fuse_twist(
@@ -117,6 +120,7 @@ void NavStateFuse::fuse_twist(
     [[maybe_unused]] const mrpt::math::CMatrixDouble66& twistCov)
 {
     state_.last_twist = twist;
+    state_.version++;
 }
 
 std::optional<NavState> NavStateFuse::estimated_navstate(
@@ -125,6 +129,13 @@ std::optional<NavState> NavStateFuse::estimated_navstate(
 {
     if (!state_.last_pose_obs_tim) return {};  // None
 
+    // Answer repeated queries against an unchanged state from the memoized
+    // result (cheap enough to keep this path deterministic and
+    // allocation-free for high-rate callers):
+    if (queryCache_.timestamp == timestamp &&
+        queryCache_.stateVersion == state_.version)
+        return queryCache_.result;
+
     const double dt =
         mrpt::system::timeDifference(*state_.last_pose_obs_tim, timestamp);
 
@@ -148,7 +159,7 @@ std::optional<NavState> NavStateFuse::estimated_navstate(
         const auto& tw = state_.last_twist.value();
 
         // For the velocity model, we don't have any known "bias":
-        const mola::RotationIntegrationParams rotParams = {};
+        static const mola::RotationIntegrationParams rotParams = {};
 
         const auto rot33 =
             mola::incremental_rotation({tw.wx, tw.wy, tw.wz}, rotParams, dt);
@@ -160,7 +171,9 @@ std::optional<NavState> NavStateFuse::estimated_navstate(
     // pose mean:
     ret.pose.mean = state_.last_pose->mean + poseExtrapolation;
 
-    // pose cov:
+    // pose cov: the 6x6 inversion is the most expensive part of this
+    // method, and most consumers (e.g. a controller) use the mean only, so
+    // defer it until first access (see NavState::pose_inv_cov()):
     auto cov = state_.last_pose->cov;
 
     double varXYZ =
@@ -171,12 +184,17 @@ std::optional<NavState> NavStateFuse::estimated_navstate(
     for (int i = 0; i < 3; i++) cov(i, i) += varXYZ;
     for (int i = 3; i < 6; i++) cov(i, i) += varRot;
 
-    ret.pose.cov_inv = cov.inverse_LLt();
+    ret.deferred_pose_inv_cov = [cov]() { return cov.inverse_LLt(); };
 
     // twist:
     ret.twist = state_.last_twist.value();
 
     // TODO(jlbc): twist covariance
 
+    // memoize (see QueryCache):
+    queryCache_.timestamp    = timestamp;
+    queryCache_.stateVersion = state_.version;
+    queryCache_.result       = ret;
+
     return ret;
 }
@@ -0,0 +1,125 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ColumnarTrajectory.h
+ * @brief  Cache-friendly columnar (SoA) timestamped SE(3) trajectory
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mrpt/core/Clock.h>
+#include <mrpt/math/TPose3D.h>
+#include <mrpt/poses/CPose3D.h>
+#include <mrpt/poses/CPose3DInterpolator.h>
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+namespace mola
+{
+/** A timestamped SE(3) trajectory stored in columnar (structure-of-arrays)
+ *  form: parallel arrays `t[]`, `x[] y[] z[]` and the orientation as a unit
+ *  quaternion `qw[] qx[] qy[] qz[]`, always sorted by ascending timestamp.
+ *
+ *  Time-nearest lookups are a binary search over the contiguous `t[]`
+ *  column (the whole array fits in a few cache lines per probe), and
+ *  pose_at_time() interpolates between the two bracketing samples with
+ *  linear translation + normalized quaternion blending, so tools that today
+ *  linearly scan a node-based mrpt::poses::CPose3DInterpolator (metrics
+ *  evaluation, relocalization) get O(log n) queries over linear memory.
+ *
+ *  Conversions are provided from/to the trajectory_t
+ *  (mrpt::poses::CPose3DInterpolator) exchange type used by dataset
+ *  sources, and poses() extracts the pose column to e.g. bulk-load a
+ *  SearchablePoseList for spatial queries.
+ *
+ * \ingroup mola_pose_list_grp
+ */
+class ColumnarTrajectory
+{
+   public:
+    ColumnarTrajectory() = default;
+
+    /** Bulk-load conversion from the standard trajectory exchange type. */
+    explicit ColumnarTrajectory(const mrpt::poses::CPose3DInterpolator& p);
+
+    bool   empty() const { return t_.empty(); }
+    size_t size() const { return t_.size(); }
+    void   clear();
+    void   reserve(const size_t n);
+
+    /** Inserts one timestamped pose. Appending in ascending time order is
+     *  O(1); out-of-order timestamps are placed via binary search (O(n)
+     *  shift). A repeated timestamp overwrites the existing sample. */
+    void insert(const mrpt::Clock::time_point& t, const mrpt::math::TPose3D& p);
+
+    /// \overload with the timestamp as double seconds (UNIX epoch)
+    void insert(const double t, const mrpt::math::TPose3D& p);
+
+    /** @name Read-only access to the raw columns
+     * @{ */
+    /// Timestamps as double seconds (UNIX epoch), ascending:
+    const std::vector<double>& t() const { return t_; }
+    const std::vector<double>& x() const { return x_; }
+    const std::vector<double>& y() const { return y_; }
+    const std::vector<double>& z() const { return z_; }
+    const std::vector<double>& qw() const { return qw_; }
+    const std::vector<double>& qx() const { return qx_; }
+    const std::vector<double>& qy() const { return qy_; }
+    const std::vector<double>& qz() const { return qz_; }
+    /** @} */
+
+    /** The i-th sample as (timestamp, pose). */
+    std::pair<double, mrpt::math::TPose3D> at(const size_t i) const;
+
+    /** Index of the time-closest sample, or nullopt if empty. O(log n). */
+    std::optional<size_t> closest_index(const double t) const;
+
+    /** Pose interpolated at the query time between the two bracketing
+     *  samples (linear translation, normalized quaternion blend); nullopt
+     *  if the trajectory is empty or `t` falls outside [t.front(),
+     *  t.back()]. O(log n). */
+    std::optional<mrpt::math::TPose3D> pose_at_time(const double t) const;
+
+    /// \overload
+    std::optional<mrpt::math::TPose3D> pose_at_time(
+        const mrpt::Clock::time_point& t) const
+    {
+        return pose_at_time(mrpt::Clock::toDouble(t));
+    }
+
+    /** Conversion back to the standard trajectory exchange type. */
+    mrpt::poses::CPose3DInterpolator asInterpolator() const;
+
+    /** The pose column as a plain vector, e.g. to feed the bulk-load
+     *  constructor of SearchablePoseList for spatial queries. */
+    std::vector<mrpt::poses::CPose3D> poses() const;
+
+   private:
+    std::vector<double> t_;
+    std::vector<double> x_, y_, z_;
+    std::vector<double> qw_, qx_, qy_, qz_;
+
+    /// Writes the given pose into the columns at index `i`:
+    void internal_write(const size_t i, const mrpt::math::TPose3D& p);
+};
+}  // namespace mola
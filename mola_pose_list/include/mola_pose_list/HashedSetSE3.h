@@ -26,6 +26,7 @@
 #pragma once
 
 #include <mola_pose_list/index_se3_t.h>
+#include <mrpt/core/exceptions.h>
 #include <mrpt/core/round.h>
 #include <mrpt/math/TPose3D.h>
 
@@ -100,16 +101,41 @@ class HashedSetSE3
 
     using pose_vector_t = std::vector<mrpt::math::TPose3D>;
 
+    /** SoA (structure-of-arrays) float mirror of the poses stored in a
+     *  voxel, kept in sync by VoxelData::insertPose(), so per-pose distance
+     *  filters can run vectorized over 8 candidates per iteration
+     *  (see findClosePoses()).
+     */
+    struct PosesSoA
+    {
+        std::vector<float> x, y, z, yaw, pitch, roll;
+
+        size_t size() const { return x.size(); }
+    };
+
     struct VoxelData
     {
        public:
         VoxelData() = default;
 
-        auto poses() const { return poses_; }
-        void insertPose(const mrpt::math::TPose3D& p) { poses_.push_back(p); }
+        const pose_vector_t& poses() const { return poses_; }
+        const PosesSoA&      posesSoA() const { return posesSoA_; }
+
+        void insertPose(const mrpt::math::TPose3D& p)
+        {
+            poses_.push_back(p);
+
+            posesSoA_.x.push_back(static_cast<float>(p.x));
+            posesSoA_.y.push_back(static_cast<float>(p.y));
+            posesSoA_.z.push_back(static_cast<float>(p.z));
+            posesSoA_.yaw.push_back(static_cast<float>(p.yaw));
+            posesSoA_.pitch.push_back(static_cast<float>(p.pitch));
+            posesSoA_.roll.push_back(static_cast<float>(p.roll));
+        }
 
        private:
         pose_vector_t poses_;
+        PosesSoA      posesSoA_;
     };
 
     using grids_map_t = std::unordered_map<
@@ -176,6 +202,35 @@ class HashedSetSE3
     /** Insert one pose into the lattice */
     void insertPose(const mrpt::math::TPose3D& pt);
 
+    /** Compile-time-resolution variant of insertPose(): `Q` is a
+     * mola::fixed_se3_quantizer_t whose cell sizes must match the ones this
+     * set was constructed with (checked in debug builds), so quantization
+     * folds into constexpr constant multiplications. Pays off when
+     * populating dense relocalization lattices (see the
+     * test-index-se3-quantizer benchmark). */
+    template <class Q>
+    void insertPoseFixed(const mrpt::math::TPose3D& pt)
+    {
+        ASSERTDEB_EQUAL_(Q::XYZ_SIZE, voxel_xyz_size_);
+        ASSERTDEB_EQUAL_(Q::ROT_SIZE, voxel_yaw_size_);
+        ASSERTDEB_EQUAL_(Q::ROT_SIZE, voxel_pitch_size_);
+        ASSERTDEB_EQUAL_(Q::ROT_SIZE, voxel_roll_size_);
+
+        voxelByGlobalIdxs(Q::quantize(pt), true)->insertPose(pt);
+    }
+
+    /** Returns all stored poses within the given translation [m] and
+     *  rotation [rad] distances of the query pose. Rotation distance is the
+     *  Euclidean norm of the wrapped (yaw, pitch, roll) differences.
+     *
+     *  Whole voxels are culled first by their lattice coordinates; the
+     *  surviving candidates are checked over the SoA float storage, 8 poses
+     *  per iteration where AVX2 is available (scalar fallback otherwise).
+     */
+    pose_vector_t findClosePoses(
+        const mrpt::math::TPose3D& query, double maxTransDist,
+        double maxRotDist) const;
+
     const grids_map_t& voxels() const { return voxels_; }
 
     void visitAllPoses(
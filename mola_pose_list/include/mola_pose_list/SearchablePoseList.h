@@ -28,11 +28,18 @@
 #include <mrpt/maps/CSimplePointsMap.h>
 #include <mrpt/poses/CPose3D.h>
 
+#include <vector>
+
 namespace mola
 {
 /** Data structure to search for nearby SE(3) poses.
  *
- *  It uses a KD-tree for the search.
+ *  It uses a KD-tree for the search. Insertions go first into a small
+ *  pending buffer which queries scan linearly, so appending poses does not
+ *  invalidate the KD-tree; the buffer is merged into the tree (one rebuild)
+ *  only when it grows past ~sqrt(n) entries, keeping both insertions and
+ *  queries cheap in amortized terms even for large (e.g. 50k+ keyframes)
+ *  trajectories with interleaved insert/query patterns.
  *
  * \ingroup mola_pose_list_grp
  */
@@ -46,6 +53,14 @@ class SearchablePoseList
     {
     }
 
+    /** Bulk-load constructor: indexes a whole trajectory (e.g. deserialized
+     *  from disk) at once, with a single KD-tree build at the end instead
+     *  of per-pose incremental work.
+     */
+    explicit SearchablePoseList(
+        const std::vector<mrpt::poses::CPose3D>& poses,
+        bool measure_from_last_kf_only = false);
+
     bool empty() const
     {
         if (from_last_only_)  //
@@ -64,8 +79,17 @@ class SearchablePoseList
         }
         else
         {
-            kf_points_.insertPoint(p.translation());
             kf_poses_.push_back(p);
+            pending_points_.push_back(p.translation().cast<float>());
+
+            // Merge into the KD-tree map only once the pending buffer
+            // reaches ~sqrt(n), so trees are rebuilt once per O(sqrt(n))
+            // insertions instead of on every single one:
+            if (pending_points_.size() >= MIN_PENDING_FLUSH &&
+                mrpt::square(pending_points_.size()) >= kf_poses_.size())
+            {
+                internal_flush_pending();
+            }
         }
     }
 
@@ -77,6 +101,9 @@ class SearchablePoseList
         const mrpt::poses::CPose3D& p, const double maxTranslation);
 
    private:
+    /// Buffers smaller than this are never worth a KD-tree rebuild:
+    constexpr static size_t MIN_PENDING_FLUSH = 32;
+
     // if from_last_only_==true
     mrpt::poses::CPose3D last_kf_ = mrpt::poses::CPose3D::Identity();
 
@@ -84,6 +111,13 @@ class SearchablePoseList
     std::deque<mrpt::poses::CPose3D> kf_poses_;
     mrpt::maps::CSimplePointsMap     kf_points_;
 
+    /// Points of the most recent poses, not yet merged into kf_points_.
+    /// They correspond to the last entries of kf_poses_:
+    std::vector<mrpt::math::TPoint3Df> pending_points_;
+
     bool from_last_only_ = false;
+
+    /// Moves pending_points_ into kf_points_ (triggers one KD-tree build):
+    void internal_flush_pending();
 };
 }  // namespace mola
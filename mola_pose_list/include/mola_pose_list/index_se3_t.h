@@ -69,6 +69,58 @@ std::ostream& operator<<(std::ostream& o, const index_se3_t<cell_coord_t>& idx)
     return o;
 }
 
+/** Compile-time quantizer for SE(3) lattices: cell sizes are template
+ * parameters, given as integer millimeters (translation) and millidegrees
+ * (rotation), so the reciprocal factors below are constexpr and fold into
+ * plain constant multiplications — no runtime members are loaded in the
+ * inner quantization of each insert. For use with HashedSetSE3 when the
+ * lattice resolution is known at build time (see
+ * HashedSetSE3::insertPoseFixed()).
+ *
+ * The defaults match the HashedSetSE3 runtime defaults: 1 m / 10 deg.
+ */
+template <
+    uint32_t XYZ_MILLIMETERS = 1000, uint32_t ROT_MILLIDEGREES = 10000,
+    typename cell_coord_t = int32_t>
+struct fixed_se3_quantizer_t
+{
+    static_assert(
+        XYZ_MILLIMETERS > 0 && ROT_MILLIDEGREES > 0,
+        "Cell sizes must be non-zero");
+
+    /** Cell sizes [m] and [rad] */
+    static constexpr double XYZ_SIZE = 1e-3 * XYZ_MILLIMETERS;
+    static constexpr double ROT_SIZE =
+        (3.14159265358979323846 / 180e3) * ROT_MILLIDEGREES;
+
+    static constexpr double XYZ_SIZE_INV = 1.0 / XYZ_SIZE;
+    static constexpr double ROT_SIZE_INV = 1.0 / ROT_SIZE;
+
+    /** POSE is any type with x,y,z,yaw,pitch,roll fields (e.g.
+     * mrpt::math::TPose3D; templated to keep this header dependency-free) */
+    template <typename POSE>
+    static constexpr index_se3_t<cell_coord_t> quantize(const POSE& p) noexcept
+    {
+        return index_se3_t<cell_coord_t>(
+            static_cast<cell_coord_t>(p.x * XYZ_SIZE_INV),
+            static_cast<cell_coord_t>(p.y * XYZ_SIZE_INV),
+            static_cast<cell_coord_t>(p.z * XYZ_SIZE_INV),
+            static_cast<cell_coord_t>(p.yaw * ROT_SIZE_INV),
+            static_cast<cell_coord_t>(p.pitch * ROT_SIZE_INV),
+            static_cast<cell_coord_t>(p.roll * ROT_SIZE_INV));
+    }
+
+    /** Returns the pose of the cell "bottom" corner */
+    template <typename POSE>
+    static constexpr POSE dequantize(
+        const index_se3_t<cell_coord_t>& idx) noexcept
+    {
+        return POSE{
+            idx.cx * XYZ_SIZE,   idx.cy * XYZ_SIZE,     idx.cz * XYZ_SIZE,
+            idx.cyaw * ROT_SIZE, idx.cpitch * ROT_SIZE, idx.croll * ROT_SIZE};
+    }
+};
+
 /** This implements a hash for index_se3_t
  *
  */
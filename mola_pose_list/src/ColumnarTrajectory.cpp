@@ -0,0 +1,219 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ColumnarTrajectory.cpp
+ * @brief  Cache-friendly columnar (SoA) timestamped SE(3) trajectory
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_pose_list/ColumnarTrajectory.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/CQuaternion.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace mola;
+
+ColumnarTrajectory::ColumnarTrajectory(
+    const mrpt::poses::CPose3DInterpolator& p)
+{
+    reserve(p.size());
+    // CPose3DInterpolator iterates in ascending time order, so these are
+    // plain appends:
+    for (const auto& [tim, pose] : p)
+        insert(mrpt::Clock::toDouble(tim), pose);
+}
+
+void ColumnarTrajectory::clear()
+{
+    t_.clear();
+    x_.clear();
+    y_.clear();
+    z_.clear();
+    qw_.clear();
+    qx_.clear();
+    qy_.clear();
+    qz_.clear();
+}
+
+void ColumnarTrajectory::reserve(const size_t n)
+{
+    t_.reserve(n);
+    x_.reserve(n);
+    y_.reserve(n);
+    z_.reserve(n);
+    qw_.reserve(n);
+    qx_.reserve(n);
+    qy_.reserve(n);
+    qz_.reserve(n);
+}
+
+void ColumnarTrajectory::internal_write(
+    const size_t i, const mrpt::math::TPose3D& p)
+{
+    mrpt::math::CQuaternionDouble q;
+    p.getAsQuaternion(q);
+
+    x_[i]  = p.x;
+    y_[i]  = p.y;
+    z_[i]  = p.z;
+    qw_[i] = q.r();
+    qx_[i] = q.x();
+    qy_[i] = q.y();
+    qz_[i] = q.z();
+}
+
+void ColumnarTrajectory::insert(
+    const mrpt::Clock::time_point& t, const mrpt::math::TPose3D& p)
+{
+    insert(mrpt::Clock::toDouble(t), p);
+}
+
+void ColumnarTrajectory::insert(const double t, const mrpt::math::TPose3D& p)
+{
+    // Common case: in-order append.
+    if (t_.empty() || t > t_.back())
+    {
+        t_.push_back(t);
+        x_.push_back(0);
+        y_.push_back(0);
+        z_.push_back(0);
+        qw_.push_back(1);
+        qx_.push_back(0);
+        qy_.push_back(0);
+        qz_.push_back(0);
+        internal_write(t_.size() - 1, p);
+        return;
+    }
+
+    const auto   itT = std::lower_bound(t_.begin(), t_.end(), t);
+    const size_t i   = static_cast<size_t>(itT - t_.begin());
+
+    if (i < t_.size() && t_[i] == t)
+    {
+        // Repeated timestamp: overwrite.
+        internal_write(i, p);
+        return;
+    }
+
+    // Out-of-order: shift all columns to make room at `i`:
+    t_.insert(itT, t);
+    x_.insert(x_.begin() + i, 0);
+    y_.insert(y_.begin() + i, 0);
+    z_.insert(z_.begin() + i, 0);
+    qw_.insert(qw_.begin() + i, 1);
+    qx_.insert(qx_.begin() + i, 0);
+    qy_.insert(qy_.begin() + i, 0);
+    qz_.insert(qz_.begin() + i, 0);
+    internal_write(i, p);
+}
+
+std::pair<double, mrpt::math::TPose3D> ColumnarTrajectory::at(
+    const size_t i) const
+{
+    ASSERT_LT_(i, t_.size());
+
+    const auto q = mrpt::math::CQuaternionDouble(qw_[i], qx_[i], qy_[i], qz_[i]);
+    return {t_[i], mrpt::poses::CPose3D(q, x_[i], y_[i], z_[i]).asTPose()};
+}
+
+std::optional<size_t> ColumnarTrajectory::closest_index(const double t) const
+{
+    if (t_.empty()) return {};
+
+    const auto   itT = std::lower_bound(t_.begin(), t_.end(), t);
+    const size_t i   = static_cast<size_t>(itT - t_.begin());
+
+    if (i == 0) return {0};
+    if (i == t_.size()) return {t_.size() - 1};
+
+    // Pick the closer of the two bracketing samples:
+    return (t - t_[i - 1] <= t_[i] - t) ? std::optional<size_t>{i - 1}
+                                        : std::optional<size_t>{i};
+}
+
+std::optional<mrpt::math::TPose3D> ColumnarTrajectory::pose_at_time(
+    const double t) const
+{
+    if (t_.empty() || t < t_.front() || t > t_.back()) return {};
+
+    const auto   itT = std::lower_bound(t_.begin(), t_.end(), t);
+    const size_t i   = static_cast<size_t>(itT - t_.begin());
+
+    if (i < t_.size() && t_[i] == t) return at(i).second;  // exact hit
+
+    // Here, 0 < i < size() and t_[i-1] < t < t_[i]:
+    const size_t i0 = i - 1, i1 = i;
+    const double u  = (t - t_[i0]) / (t_[i1] - t_[i0]);
+
+    // Linear translation + normalized quaternion blend (nlerp), taking the
+    // shorter arc. Plain branch-free arithmetic over the columns, which the
+    // compiler can keep in registers / vectorize:
+    const double s =
+        (qw_[i0] * qw_[i1] + qx_[i0] * qx_[i1] + qy_[i0] * qy_[i1] +
+         qz_[i0] * qz_[i1]) < 0
+            ? -1.0
+            : 1.0;
+    const double u0 = 1.0 - u, u1 = s * u;
+
+    double rw = u0 * qw_[i0] + u1 * qw_[i1];
+    double rx = u0 * qx_[i0] + u1 * qx_[i1];
+    double ry = u0 * qy_[i0] + u1 * qy_[i1];
+    double rz = u0 * qz_[i0] + u1 * qz_[i1];
+
+    const double norm = std::sqrt(rw * rw + rx * rx + ry * ry + rz * rz);
+    ASSERT_GT_(norm, 1e-10);
+    rw /= norm;
+    rx /= norm;
+    ry /= norm;
+    rz /= norm;
+
+    const auto q = mrpt::math::CQuaternionDouble(rw, rx, ry, rz);
+    return mrpt::poses::CPose3D(
+               q, u0 * x_[i0] + u * x_[i1], u0 * y_[i0] + u * y_[i1],
+               u0 * z_[i0] + u * z_[i1])
+        .asTPose();
+}
+
+mrpt::poses::CPose3DInterpolator ColumnarTrajectory::asInterpolator() const
+{
+    mrpt::poses::CPose3DInterpolator ret;
+    for (size_t i = 0; i < t_.size(); i++)
+    {
+        const auto [tim, pose] = at(i);
+        ret.insert(mrpt::Clock::fromDouble(tim), pose);
+    }
+    return ret;
+}
+
+std::vector<mrpt::poses::CPose3D> ColumnarTrajectory::poses() const
+{
+    std::vector<mrpt::poses::CPose3D> ret;
+    ret.reserve(t_.size());
+    for (size_t i = 0; i < t_.size(); i++)
+    {
+        const auto q = mrpt::math::CQuaternionDouble(
+            qw_[i], qx_[i], qy_[i], qz_[i]);
+        ret.emplace_back(q, x_[i], y_[i], z_[i]);
+    }
+    return ret;
+}
@@ -26,10 +26,103 @@
  */
 
 #include <mola_pose_list/HashedSetSE3.h>
+#include <mrpt/math/wrap2pi.h>
 #include <mrpt/system/os.h>
 
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
 using namespace mola;
 
+namespace
+{
+/** Writes the squared translation and rotation distances of the n poses in
+ *  `soa` against the query into outTrans2[0..n-1] / outRot2[0..n-1].
+ *  Angular differences are wrapped to [-pi,pi]. AVX2 processes 8 candidate
+ *  poses per iteration. */
+void se3_sqr_distances(
+    const HashedSetSE3::PosesSoA& soa, const mrpt::math::TPose3D& q,
+    float* outTrans2, float* outRot2)
+{
+    const size_t n = soa.size();
+
+    const auto qx = static_cast<float>(q.x);
+    const auto qy = static_cast<float>(q.y);
+    const auto qz = static_cast<float>(q.z);
+
+    const auto qyaw   = static_cast<float>(q.yaw);
+    const auto qpitch = static_cast<float>(q.pitch);
+    const auto qroll  = static_cast<float>(q.roll);
+
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    const __m256 vqx = _mm256_set1_ps(qx);
+    const __m256 vqy = _mm256_set1_ps(qy);
+    const __m256 vqz = _mm256_set1_ps(qz);
+
+    const __m256 vqyaw   = _mm256_set1_ps(qyaw);
+    const __m256 vqpitch = _mm256_set1_ps(qpitch);
+    const __m256 vqroll  = _mm256_set1_ps(qroll);
+
+    const __m256 twoPi = _mm256_set1_ps(static_cast<float>(2.0 * M_PI));
+    const __m256 invTwoPi =
+        _mm256_set1_ps(static_cast<float>(1.0 / (2.0 * M_PI)));
+
+    // wrapToPi(d)^2, with wrapToPi(d) = d - 2*pi*round(d/(2*pi)):
+    const auto wrappedSqr = [twoPi, invTwoPi](const __m256 d)
+    {
+        const __m256 w = _mm256_sub_ps(
+            d, _mm256_mul_ps(
+                   twoPi, _mm256_round_ps(
+                              _mm256_mul_ps(d, invTwoPi),
+                              _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+        return _mm256_mul_ps(w, w);
+    };
+
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&soa.x[i]), vqx);
+        const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&soa.y[i]), vqy);
+        const __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(&soa.z[i]), vqz);
+
+        const __m256 t2 = _mm256_add_ps(
+            _mm256_mul_ps(dx, dx),
+            _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+
+        const __m256 r2 = _mm256_add_ps(
+            wrappedSqr(_mm256_sub_ps(_mm256_loadu_ps(&soa.yaw[i]), vqyaw)),
+            _mm256_add_ps(
+                wrappedSqr(
+                    _mm256_sub_ps(_mm256_loadu_ps(&soa.pitch[i]), vqpitch)),
+                wrappedSqr(
+                    _mm256_sub_ps(_mm256_loadu_ps(&soa.roll[i]), vqroll))));
+
+        _mm256_storeu_ps(outTrans2 + i, t2);
+        _mm256_storeu_ps(outRot2 + i, r2);
+    }
+#endif
+
+    // remainder (and scalar fallback):
+    for (; i < n; i++)
+    {
+        const float dx = soa.x[i] - qx;
+        const float dy = soa.y[i] - qy;
+        const float dz = soa.z[i] - qz;
+
+        const float dyaw   = mrpt::math::wrapToPi(soa.yaw[i] - qyaw);
+        const float dpitch = mrpt::math::wrapToPi(soa.pitch[i] - qpitch);
+        const float droll  = mrpt::math::wrapToPi(soa.roll[i] - qroll);
+
+        outTrans2[i] = dx * dx + dy * dy + dz * dz;
+        outRot2[i]   = dyaw * dyaw + dpitch * dpitch + droll * droll;
+    }
+}
+}  // namespace
+
 // VoxelData
 
 // Ctor:
@@ -94,6 +187,47 @@ void HashedSetSE3::insertPose(const mrpt::math::TPose3D& p)
     v.insertPose(p);
 }
 
+HashedSetSE3::pose_vector_t HashedSetSE3::findClosePoses(
+    const mrpt::math::TPose3D& query, double maxTransDist,
+    double maxRotDist) const
+{
+    pose_vector_t out;
+
+    const auto maxT2 = static_cast<float>(mrpt::square(maxTransDist));
+    const auto maxR2 = static_cast<float>(mrpt::square(maxRotDist));
+
+    // reused across voxels to avoid per-voxel allocations:
+    std::vector<float> trans2, rot2;
+
+    // loose margin for the voxel-level cull: the voxel "bottom" corner may
+    // be up to one voxel away from any pose stored inside it:
+    const double trCull = maxTransDist + voxel_xyz_size_;
+
+    for (const auto& [idx, v] : voxels_)
+    {
+        const auto corner = globalIdxToCoord(idx);
+        if (std::abs(corner.x - query.x) > trCull ||
+            std::abs(corner.y - query.y) > trCull ||
+            std::abs(corner.z - query.z) > trCull)
+            continue;
+
+        const auto&  soa = v.posesSoA();
+        const size_t n   = soa.size();
+        if (!n) continue;
+
+        trans2.resize(n);
+        rot2.resize(n);
+        se3_sqr_distances(soa, query, trans2.data(), rot2.data());
+
+        const auto& poses = v.poses();
+        for (size_t i = 0; i < n; i++)
+            if (trans2[i] <= maxT2 && rot2[i] <= maxR2)
+                out.push_back(poses[i]);
+    }
+
+    return out;
+}
+
 void HashedSetSE3::visitAllPoses(
     const std::function<void(const mrpt::math::TPose3D&)>& f) const
 {
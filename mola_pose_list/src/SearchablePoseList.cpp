@@ -29,6 +29,33 @@
 
 using namespace mola;
 
+SearchablePoseList::SearchablePoseList(
+    const std::vector<mrpt::poses::CPose3D>& poses,
+    bool                                     measure_from_last_kf_only)
+    : from_last_only_(measure_from_last_kf_only)
+{
+    if (from_last_only_)
+    {
+        if (!poses.empty()) last_kf_ = poses.back();
+        return;
+    }
+
+    kf_points_.reserve(poses.size());
+    for (const auto& p : poses)
+    {
+        kf_poses_.push_back(p);
+        kf_points_.insertPoint(p.translation());
+    }
+}
+
+void SearchablePoseList::internal_flush_pending()
+{
+    for (const auto& pt : pending_points_)
+        kf_points_.insertPoint(pt.x, pt.y, pt.z);
+
+    pending_points_.clear();
+}
+
 std::tuple<bool /*isFirst*/, mrpt::poses::CPose3D /*distanceToClosest*/>
     SearchablePoseList::check(const mrpt::poses::CPose3D& p) const
 {
@@ -42,15 +69,32 @@ std::tuple<bool /*isFirst*/, mrpt::poses::CPose3D /*distanceToClosest*/>
     }
     else
     {
-        ASSERT_EQUAL_(kf_poses_.size(), kf_points_.size());
+        ASSERT_EQUAL_(
+            kf_poses_.size(), kf_points_.size() + pending_points_.size());
+
+        const auto query = p.translation().cast<float>();
 
         std::vector<mrpt::math::TPoint3Df> closest;
         std::vector<float>                 closestSqrDist;
         std::vector<uint64_t>              closestID;
 
-        kf_points_.nn_multiple_search(
-            p.translation().cast<float>(), 20, closest, closestSqrDist,
-            closestID);
+        if (!kf_points_.empty())
+        {
+            kf_points_.nn_multiple_search(
+                query, 20, closest, closestSqrDist, closestID);
+        }
+
+        // Also consider the poses still in the pending buffer: it is kept
+        // small (~sqrt(n)), so a linear scan is cheaper than the KD-tree
+        // rebuild that indexing them on each insertion would cost:
+        for (size_t i = 0; i < pending_points_.size(); i++)
+        {
+            closest.push_back(pending_points_[i]);
+            closestSqrDist.push_back(
+                static_cast<float>((pending_points_[i] - query).sqrNorm()));
+            closestID.push_back(kf_points_.size() + i);
+        }
+
         ASSERT_(!closest.empty());  // empty()==false from check above
 
         // Check for both, rotation and translation.
@@ -85,6 +129,9 @@ void SearchablePoseList::removeAllFartherThan(
 {
     if (from_last_only_) return;  // not applicable
 
+    // simplest: index everything first, then filter below:
+    internal_flush_pending();
+
     std::deque<mrpt::poses::CPose3D> new_kf_poses;
     mrpt::maps::CSimplePointsMap     new_kf_points;
 
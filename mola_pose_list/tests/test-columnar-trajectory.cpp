@@ -0,0 +1,138 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-columnar-trajectory.cpp
+ * @brief  Unit tests for ColumnarTrajectory
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_pose_list/ColumnarTrajectory.h>
+#include <mola_pose_list/SearchablePoseList.h>
+
+#include <cmath>
+#include <iostream>
+
+// 10 Hz trajectory, moving at 1 m/s along +x while turning in yaw:
+static mola::ColumnarTrajectory example_trajectory()
+{
+    mola::ColumnarTrajectory ct;
+    for (int i = 0; i < 1000; i++)
+    {
+        const double t = 0.1 * i;
+        ct.insert(
+            t, mrpt::math::TPose3D(t, .0, .0, 1e-3 * i /*yaw*/, .0, .0));
+    }
+    return ct;
+}
+
+static void test_insert_and_search()
+{
+    auto ct = example_trajectory();
+    ASSERT_EQUAL_(ct.size(), 1000U);
+
+    // timestamps column must be sorted, even after an out-of-order insert:
+    ct.insert(0.05, mrpt::math::TPose3D(0.5, .0, .0, .0, .0, .0));
+    ASSERT_EQUAL_(ct.size(), 1001U);
+    for (size_t i = 1; i < ct.size(); i++) ASSERT_LT_(ct.t()[i - 1], ct.t()[i]);
+
+    // repeated timestamp => overwrite, not duplicate:
+    ct.insert(0.05, mrpt::math::TPose3D(0.6, .0, .0, .0, .0, .0));
+    ASSERT_EQUAL_(ct.size(), 1001U);
+
+    // closest-in-time searches:
+    {
+        const auto idx = ct.closest_index(10.001);
+        ASSERT_(idx.has_value());
+        ASSERT_NEAR_(ct.t()[*idx], 10.0, 1e-6);
+    }
+    // queries beyond both ends clamp to the first/last samples:
+    ASSERT_EQUAL_(*ct.closest_index(-1.0), 0U);
+    ASSERT_EQUAL_(*ct.closest_index(1e6), ct.size() - 1);
+}
+
+static void test_interpolation()
+{
+    const auto ct = example_trajectory();
+
+    // Exact hit:
+    {
+        const auto p = ct.pose_at_time(10.0);
+        ASSERT_(p.has_value());
+        ASSERT_NEAR_(p->x, 10.0, 1e-9);
+    }
+    // Midway between two samples: both the translation and the yaw must be
+    // the average of the neighbors:
+    {
+        const auto p = ct.pose_at_time(10.05);
+        ASSERT_(p.has_value());
+        ASSERT_NEAR_(p->x, 10.05, 1e-6);
+        ASSERT_NEAR_(p->yaw, 1e-3 * 100.5, 1e-6);
+    }
+    // Out of range:
+    ASSERT_(!ct.pose_at_time(-0.1).has_value());
+    ASSERT_(!ct.pose_at_time(100.0).has_value());
+}
+
+static void test_conversions()
+{
+    const auto ct = example_trajectory();
+
+    // Round trip through the standard exchange type:
+    const auto traj = ct.asInterpolator();
+    ASSERT_EQUAL_(traj.size(), ct.size());
+
+    const mola::ColumnarTrajectory ct2(traj);
+    ASSERT_EQUAL_(ct2.size(), ct.size());
+    for (size_t i = 0; i < ct.size(); i += 97)
+    {
+        const auto [t1, p1] = ct.at(i);
+        const auto [t2, p2] = ct2.at(i);
+        ASSERT_NEAR_(t1, t2, 1e-6);
+        ASSERT_NEAR_(p1.x, p2.x, 1e-9);
+        ASSERT_NEAR_(p1.yaw, p2.yaw, 1e-9);
+    }
+
+    // Pose column extraction feeds the spatial index:
+    mola::SearchablePoseList l(ct.poses());
+    ASSERT_EQUAL_(l.size(), ct.size());
+    const auto [isFirst, d] =
+        l.check(mrpt::poses::CPose3D::FromTranslation(10.01, .0, .0));
+    ASSERT_(!isFirst);
+    ASSERT_LT_(d.translation().norm(), 0.1);
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_insert_and_search();
+        test_interpolation();
+        test_conversions();
+
+        std::cout << "Test successful." << std::endl;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,96 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-hashed-set-se3.cpp
+ * @brief  Unit tests for mola_pose_list
+ * @author Jose Luis Blanco Claraco
+ * @date   Apr 16, 2024
+ */
+
+#include <mola_pose_list/HashedSetSE3.h>
+#include <mrpt/math/wrap2pi.h>
+
+#include <cmath>
+#include <iostream>
+
+static void test_find_close_poses()
+{
+    mola::HashedSetSE3 s;
+
+    // a cloud of poses over a small SE(3) region:
+    for (int ix = 0; ix < 20; ix++)
+        for (int iy = 0; iy < 10; iy++)
+            for (int iyaw = 0; iyaw < 8; iyaw++)
+            {
+                s.insertPose(
+                    {0.3 * ix, 0.4 * iy, .0, mrpt::DEG2RAD(45.0 * iyaw) - M_PI,
+                     .0, .0});
+            }
+
+    const auto   query        = mrpt::math::TPose3D(2.0, 1.5, .0, .0, .0, .0);
+    const double maxTransDist = 0.75;
+    const double maxRotDist   = mrpt::DEG2RAD(50.0);
+
+    const auto found = s.findClosePoses(query, maxTransDist, maxRotDist);
+
+    // brute-force reference:
+    size_t nExpected = 0;
+    s.visitAllPoses(
+        [&](const mrpt::math::TPose3D& p)
+        {
+            const double t2 = mrpt::square(p.x - query.x) +
+                              mrpt::square(p.y - query.y) +
+                              mrpt::square(p.z - query.z);
+            const double r2 =
+                mrpt::square(mrpt::math::wrapToPi(p.yaw - query.yaw)) +
+                mrpt::square(mrpt::math::wrapToPi(p.pitch - query.pitch)) +
+                mrpt::square(mrpt::math::wrapToPi(p.roll - query.roll));
+
+            if (t2 <= mrpt::square(maxTransDist) &&
+                r2 <= mrpt::square(maxRotDist))
+                nExpected++;
+        });
+
+    ASSERT_GT_(nExpected, 0U);
+    ASSERT_EQUAL_(found.size(), nExpected);
+
+    for (const auto& p : found)
+    {
+        ASSERT_LT_(
+            std::hypot(p.x - query.x, p.y - query.y, p.z - query.z),
+            maxTransDist + 1e-5);
+    }
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_find_close_poses();
+
+        std::cout << "Test successful." << std::endl;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,119 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+
+/**
+ * @file   test-index-se3-quantizer.cpp
+ * @brief  Unit test + micro-benchmark of fixed_se3_quantizer_t
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_pose_list/HashedSetSE3.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/random/RandomGenerators.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+// Matches the HashedSetSE3 runtime defaults: 1 m / 10 deg cells
+using quantizer_t = mola::fixed_se3_quantizer_t<1000, 10000>;
+
+static std::vector<mrpt::math::TPose3D> random_poses(size_t n)
+{
+    auto& rng = mrpt::random::getRandomGenerator();
+    rng.randomize(42);
+
+    std::vector<mrpt::math::TPose3D> poses;
+    poses.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        poses.emplace_back(
+            rng.drawUniform(-50.0, 50.0), rng.drawUniform(-50.0, 50.0),
+            rng.drawUniform(-5.0, 5.0), rng.drawUniform(-M_PI, M_PI),
+            rng.drawUniform(-0.5 * M_PI, 0.5 * M_PI),
+            rng.drawUniform(-M_PI, M_PI));
+    }
+    return poses;
+}
+
+static void test_quantizer_matches_runtime()
+{
+    const mola::HashedSetSE3 s;  // default resolutions
+
+    for (const auto& p : random_poses(10000))
+    {
+        const auto idxRuntime = s.coordToGlobalIdx(p);
+        const auto idxFixed   = quantizer_t::quantize(p);
+        ASSERT_EQUAL_(idxRuntime, idxFixed);
+    }
+
+    // dequantize() must be the inverse on cell corners:
+    const auto idx = quantizer_t::quantize(
+        mrpt::math::TPose3D(10.0, -3.0, 1.0, 0.5, -0.2, 0.1));
+    const auto corner = quantizer_t::dequantize<mrpt::math::TPose3D>(idx);
+    ASSERT_EQUAL_(quantizer_t::quantize(corner), idx);
+}
+
+static void benchmark_insert()
+{
+    const auto poses = random_poses(200000);
+
+    // Runtime-resolution insert path:
+    double tRuntime = 0;
+    {
+        mola::HashedSetSE3 s;
+        const double       t0 = mrpt::Clock::nowDouble();
+        for (const auto& p : poses) s.insertPose(p);
+        tRuntime = mrpt::Clock::nowDouble() - t0;
+        ASSERT_(!s.empty());
+    }
+
+    // Compile-time-resolution insert path:
+    double tFixed = 0;
+    {
+        mola::HashedSetSE3 s;
+        const double       t0 = mrpt::Clock::nowDouble();
+        for (const auto& p : poses) s.insertPoseFixed<quantizer_t>(p);
+        tFixed = mrpt::Clock::nowDouble() - t0;
+        ASSERT_(!s.empty());
+    }
+
+    std::cout << "insertPose()      runtime quantizer: "
+              << 1e9 * tRuntime / poses.size() << " ns/pose\n"
+              << "insertPoseFixed() constexpr quantizer: "
+              << 1e9 * tFixed / poses.size() << " ns/pose\n";
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+{
+    try
+    {
+        test_quantizer_matches_runtime();
+        benchmark_insert();
+
+        std::cout << "Test successful." << std::endl;
+    }
+    catch (std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
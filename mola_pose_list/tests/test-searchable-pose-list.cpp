@@ -29,17 +29,68 @@
 #include <mrpt/poses/Lie/SE.h>
 
 #include <iostream>
+#include <vector>
 
-static void test1()
+static std::vector<mrpt::poses::CPose3D> example_trajectory()
 {
-    // write me!
+    std::vector<mrpt::poses::CPose3D> poses;
+    for (int i = 0; i < 1000; i++)
+        poses.push_back(
+            mrpt::poses::CPose3D::FromTranslation(0.1 * i, 0.05 * i, .0));
+    return poses;
+}
+
+static void test_incremental_inserts()
+{
+    mola::SearchablePoseList l(false /*measure_from_last_kf_only*/);
+    ASSERT_(l.empty());
+
+    // interleave insertions and queries, as the loop-closure candidate
+    // search does:
+    for (const auto& p : example_trajectory())
+    {
+        l.insert(p);
+        const auto [isFirst, d] = l.check(p);
+        ASSERT_(!isFirst);
+        ASSERT_LT_(d.translation().norm(), 1e-6);  // itself
+    }
+    ASSERT_EQUAL_(l.size(), 1000U);
+
+    // query near pose #100 = (10.0, 5.0, 0):
+    const auto q = mrpt::poses::CPose3D::FromTranslation(10.02, 5.01, .0);
+    const auto [isFirst, d] = l.check(q);
+    ASSERT_(!isFirst);
+    ASSERT_LT_(d.translation().norm(), 0.1);
+}
+
+static void test_bulk_load()
+{
+    const auto poses = example_trajectory();
+
+    mola::SearchablePoseList l(poses);
+    ASSERT_EQUAL_(l.size(), poses.size());
+
+    const auto q = mrpt::poses::CPose3D::FromTranslation(10.02, 5.01, .0);
+    const auto [isFirst, d] = l.check(q);
+    ASSERT_(!isFirst);
+    ASSERT_LT_(d.translation().norm(), 0.1);
+
+    // drop the far-away part of the trajectory:
+    l.removeAllFartherThan(q, 1.0);
+    ASSERT_GT_(l.size(), 0U);
+    ASSERT_LT_(l.size(), poses.size());
+
+    const auto [isFirst2, d2] = l.check(q);
+    ASSERT_(!isFirst2);
+    ASSERT_LT_(d2.translation().norm(), 0.1);
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
 {
     try
     {
-        test1();
+        test_incremental_inserts();
+        test_bulk_load();
 
         std::cout << "Test successful." << std::endl;
     }
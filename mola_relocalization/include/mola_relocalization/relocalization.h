@@ -29,14 +29,112 @@
 #include <mp2p_icp/ICP.h>
 #include <mp2p_icp/Parameters.h>
 #include <mp2p_icp/metricmap.h>
+#include <mrpt/containers/CDynamicGrid.h>
+#include <mrpt/maps/CSimplePointsMap.h>
+#include <mrpt/math/TPoint2D.h>
+#include <mrpt/math/TPoint3D.h>
 #include <mrpt/math/TPose2D.h>
+#include <mrpt/math/TPose3D.h>
 #include <mrpt/obs/CSensoryFrame.h>
 #include <mrpt/poses/CPosePDFGrid.h>
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
 #include <map>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace mola
 {
+/** A geo-index of a reference metric map, pre-partitioned into square XY
+ *  tiles with cheap content descriptors (point count, centroid, Z extent).
+ *
+ *  When a rough position prior is available (a GNSS fix, the last known
+ *  pose, a user click on a map...), selectTiles() picks the few tiles
+ *  within the prior uncertainty radius, and the resulting Selection can be
+ *  attached to RelocalizationLikelihood_SE2::Input or
+ *  RelocalizationICP_SE2::Input to restrict the search to those tiles
+ *  only, instead of sweeping the full map extent.
+ *
+ *  Build it once per reference map and reuse it across relocalization
+ *  attempts; building only depends on the map, not on any prior.
+ *
+ * \ingroup mola_relocalization_grp
+ */
+class SubmapTileIndex
+{
+   public:
+    SubmapTileIndex() = default;
+
+    /** One non-empty square tile of the partition */
+    struct Tile
+    {
+        int32_t cx = 0, cy = 0;  //!< Tile lattice coordinates
+
+        /** Content descriptors of the points falling in this tile: */
+        mrpt::math::TPoint3D centroid;
+        uint64_t             point_count = 0;
+        float                z_min = 0, z_max = 0;
+    };
+
+    /** A tile subset, as returned by selectTiles() from a position prior.
+     *  Attach it to a relocalization Input to shrink the search volume. */
+    struct Selection
+    {
+        std::shared_ptr<const SubmapTileIndex> index;
+
+        /// Indices into index->tiles()
+        std::vector<size_t> tile_indices;
+    };
+
+    /** Partitions all the point-cloud layers of the given map into square
+     *  XY tiles of the given size [m]; empty tiles are not stored. */
+    void build(const mp2p_icp::metric_map_t& refMap, double tile_size = 50.0);
+
+    bool                     empty() const { return tiles_.empty(); }
+    double                   tileSize() const { return tileSize_; }
+    const std::vector<Tile>& tiles() const { return tiles_; }
+
+    /** Returns the indices (into tiles()) of all tiles overlapping the
+     *  disk of radius prior_radius [m] around the prior position, e.g. a
+     *  GNSS fix converted into map coordinates. */
+    std::vector<size_t> selectTiles(
+        const mrpt::math::TPoint2D& prior_position, double prior_radius) const;
+
+    /** XY bounding box (outer tile corners) of the given tile subset */
+    void boundingBox(
+        const std::vector<size_t>& tile_indices,
+        mrpt::math::TPoint2D&      corner_min,
+        mrpt::math::TPoint2D&      corner_max) const;
+
+    /** Returns a copy of refMap where each point-cloud layer keeps only
+     *  the points falling inside the given tiles; filtered layers keep
+     *  their original dynamic class, and non-point layers are shared
+     *  untouched. Used by RelocalizationICP_SE2 so ICP only matches
+     *  against the selected submap. */
+    mp2p_icp::metric_map_t extractSubmap(
+        const mp2p_icp::metric_map_t& refMap,
+        const std::vector<size_t>&    tile_indices) const;
+
+   private:
+    double            tileSize_    = 50.0;
+    double            tileSizeInv_ = 1.0 / 50.0;
+    std::vector<Tile> tiles_;
+
+    /// Tile lattice coordinates -> index into tiles_
+    std::map<std::pair<int32_t, int32_t>, size_t> tileByCoords_;
+
+    std::pair<int32_t, int32_t> tileCoordsOf(double x, double y) const
+    {
+        return {
+            static_cast<int32_t>(std::floor(x * tileSizeInv_)),
+            static_cast<int32_t>(std::floor(y * tileSizeInv_))};
+    }
+};
+
 /** Takes a global metric map, an observation, and a SE(2) ROI, and evaluates
  * the likelihood of the observation in a regular SE(2) lattice.
  *
@@ -56,6 +154,54 @@ namespace mola
  */
 struct RelocalizationLikelihood_SE2
 {
+    /** A rasterized log-likelihood field over the XY extent of a reference
+     *  map: each cell caches the Gaussian log-likelihood of observing a
+     *  point there, from a one-time distance transform against the
+     *  point-cloud layers of the map.
+     *
+     *  Build it once per reference map and reuse it across all candidate
+     *  poses and across successive relocalization attempts: per-pose
+     *  scoring then becomes plain table lookups, instead of re-evaluating
+     *  the map likelihood model for every candidate.
+     */
+    class LikelihoodField
+    {
+       public:
+        LikelihoodField() = default;
+
+        /** Builds the field from all point-cloud layers of the given map.
+         * \param resolution Cell size of the rasterized field [m].
+         * \param sigma_dist Sigma of the per-point Gaussian model [m].
+         * \param max_corr_distance Distances are saturated at this value,
+         *        which also defines the log-likelihood of empty areas [m].
+         */
+        void build(
+            const mp2p_icp::metric_map_t& refMap, double resolution = 0.20,
+            double sigma_dist = 0.20, double max_corr_distance = 1.5);
+
+        bool empty() const { return !built_; }
+
+        /** Sum of per-point log-likelihoods of the given points, as seen
+         *  from the given SE(2) pose (points Z coordinates are ignored).
+         *
+         *  Per-point terms are all <=0, so the running sum is a
+         *  monotonically-decreasing upper bound on the final score: if a
+         *  pruning bound is given, candidates whose partial sum falls
+         *  below it are abandoned early (checked once per block of 64
+         *  points), returning the truncated partial sum.
+         */
+        double evaluate(
+            const mrpt::maps::CSimplePointsMap& pts,
+            const mrpt::math::TPose2D& pose,
+            double                     prune_log_lik_bound =
+                std::numeric_limits<double>::lowest()) const;
+
+       private:
+        mrpt::containers::CDynamicGrid<float> grid_;
+        double                                minLogLik_ = .0;
+        bool                                  built_     = false;
+    };
+
     struct Input
     {
         mp2p_icp::metric_map_t   reference_map;
@@ -64,6 +210,51 @@ struct RelocalizationLikelihood_SE2
         double                   resolution_xy  = 0.5;
         double                   resolution_phi = mrpt::DEG2RAD(30.0);
 
+        /** If provided (see LikelihoodField::build()), candidate poses are
+         * scored against this precomputed field instead of invoking the
+         * observation likelihood model of the raw reference map layers for
+         * each pose, which re-touches the same map cells thousands of
+         * times. The field can (and should) be shared across successive
+         * relocalization attempts on the same reference map.
+         */
+        std::shared_ptr<const LikelihoodField> likelihood_field;
+
+        /** Number of coarse-to-fine refinement levels. With the default of
+         * 1, the whole lattice is evaluated exhaustively at
+         * resolution_xy/resolution_phi (the classic behavior). With L>1
+         * levels, a first pass evaluates a lattice 2^(L-1) times coarser,
+         * keeps only the best multires_keep_fraction of its cells,
+         * subdivides those and re-evaluates, halving the step per level
+         * until reaching the target resolution. This cuts the number of
+         * evaluated poses by roughly two orders of magnitude for the same
+         * final precision. Cells pruned along the way are assigned the
+         * worst evaluated log-likelihood, i.e. negligible probability
+         * after normalization.
+         */
+        uint32_t multires_levels = 1;
+
+        /// Fraction (0,1] of the best-scoring cells kept after each
+        /// multi-resolution pass. \sa multires_levels
+        double multires_keep_fraction = 0.05;
+
+        /** When scoring against likelihood_field, candidates whose
+         * partial log-likelihood sum falls this many nats below the best
+         * candidate seen so far are abandoned early (see
+         * LikelihoodField::evaluate()): their probability after
+         * normalization is negligible either way. Set to 0 to disable
+         * early exit.
+         */
+        double prune_bound_margin = 25.0;
+
+        /** If provided (see SubmapTileIndex::selectTiles()), the search
+         * lattice is clipped to the XY bounding box of the selected
+         * tiles: with a rough position prior this shrinks the candidate
+         * volume by orders of magnitude vs. sweeping the whole
+         * corner_min/corner_max area. The selection must overlap that
+         * area.
+         */
+        std::optional<SubmapTileIndex::Selection> prior_tiles;
+
         Input() = default;
     };
 
@@ -74,6 +265,11 @@ struct RelocalizationLikelihood_SE2
         double                    max_log_likelihood = 0;
         double                    min_log_likelihood = 0;
 
+        /// Number of candidate poses actually evaluated; with
+        /// Input::multires_levels>1 this is much smaller than the
+        /// number of cells of likelihood_grid.
+        uint64_t evaluated_poses = 0;
+
         Output() = default;
     };
 
@@ -100,6 +296,12 @@ struct RelocalizationICP_SE2
         size_t              total_cells  = 0;
         mrpt::math::TPose3D cell_init_guess;
         double              obtained_icp_quality = .0;
+
+        /** Best ICP quality obtained over all cells evaluated so far, so
+         *  callers can monitor the best-so-far hypothesis while the search
+         *  is still running. \sa Input::icp_early_exit_quality
+         */
+        double best_quality_so_far = .0;
     };
 
     struct Input
@@ -114,6 +316,26 @@ struct RelocalizationICP_SE2
         mp2p_icp::Parameters            icp_parameters;
         double                          icp_minimum_quality = 0.50;
 
+        /** If provided, enables a coarse-to-fine search: a first pass
+         * scores every lattice cell running ICP with these (cheaper, e.g.
+         * fewer iterations or more decimation) parameters, and only the
+         * cells whose coarse quality is at least
+         * `prune_coarse_quality_fraction` times the best coarse quality
+         * are refined with the full `icp_parameters`. The rest of the
+         * lattice is pruned without ever running the expensive fine ICP.
+         */
+        std::optional<mp2p_icp::Parameters> coarse_icp_parameters;
+
+        /** Pruning bound for the coarse pass, in [0,1].
+         *  \sa coarse_icp_parameters */
+        double prune_coarse_quality_fraction = 0.75;
+
+        /** If provided, the search stops as soon as any hypothesis reaches
+         * this ICP quality, skipping all remaining cells. Useful when any
+         * one good relocalization hypothesis is enough.
+         */
+        std::optional<double> icp_early_exit_quality;
+
         struct InputLattice
         {
             mrpt::math::TPose2D corner_min, corner_max;
@@ -131,6 +353,114 @@ struct RelocalizationICP_SE2
         };
         OutputLattice output_lattice;
 
+        /** If provided (see SubmapTileIndex::selectTiles()), the initial
+         * guess lattice is clipped to the XY bounding box of the selected
+         * tiles, and every ICP run matches against the reduced submap of
+         * those tiles instead of the full reference_map. The selection
+         * must overlap the initial_guess_lattice area.
+         */
+        std::optional<SubmapTileIndex::Selection> prior_tiles;
+
+        std::function<void(const ProgressFeedback&)> on_progress_callback;
+
+        Input() = default;
+    };
+
+    struct Output
+    {
+        mola::HashedSetSE3 found_poses;
+        double             time_cost = .0;  //!< [s]
+
+        Output() = default;
+    };
+
+    static Output run(const Input& in);
+};
+
+/** Full SE(3) relocalization: takes a global and a local metric map plus a
+ *  set of SE(3) candidate base poses (e.g. the output lattice of
+ *  RelocalizationICP_SE2, GNSS fixes, last known poses...), expands each
+ *  candidate with a coarse yaw/pitch/roll lattice, and matches the local
+ *  map in the global map by running ICP from the surviving hypotheses.
+ *
+ *  Since the rotational expansion multiplies the number of hypotheses, an
+ *  optional (enabled by default) coarse scoring pass ranks every candidate
+ *  first by the nearest-neighbor distances of a decimated subset of the
+ *  local-map points against the reference map layers, in parallel threads.
+ *  Scores are monotonically-growing sums of saturated squared distances,
+ *  so candidates whose partial sum already exceeds the admission bound
+ *  (a factor over the best complete score so far) are abandoned early,
+ *  branch-and-bound style, and the expensive ICP runs only on the
+ *  best-scoring fraction of the lattice.
+ *
+ *  Useful for aerial vehicles and any other platform where the flat-world
+ *  assumption behind the SE(2) engines above does not hold.
+ *
+ * \ingroup mola_relocalization_grp
+ */
+struct RelocalizationICP_SE3
+{
+    /// Same feedback structure as the SE(2) engine:
+    using ProgressFeedback = RelocalizationICP_SE2::ProgressFeedback;
+
+    struct Input
+    {
+        mp2p_icp::metric_map_t reference_map;
+        mp2p_icp::metric_map_t local_map;
+
+        /** Candidate base poses. Each stored pose is expanded with the
+         *  rotation_lattice offsets below to form the hypothesis set. */
+        mola::HashedSetSE3 candidates;
+
+        /** If provided more than one, several ICP runs will be triggered in
+         * parallel threads.
+         */
+        std::vector<mp2p_icp::ICP::Ptr> icp_pipeline;
+        mp2p_icp::Parameters            icp_parameters;
+        double                          icp_minimum_quality = 0.50;
+
+        /** If provided, the search stops as soon as any hypothesis reaches
+         * this ICP quality, skipping all remaining cells. Useful when any
+         * one good relocalization hypothesis is enough.
+         */
+        std::optional<double> icp_early_exit_quality;
+
+        /** Yaw/pitch/roll offsets applied around each candidate pose:
+         *  each angle sweeps [-extent, +extent] in steps of `step`
+         *  (a zero extent leaves that angle untouched). Defaults cover
+         *  the moderate attitude uncertainty of a hovering drone. */
+        struct RotationLattice
+        {
+            double yaw_extent   = mrpt::DEG2RAD(.0);
+            double yaw_step     = mrpt::DEG2RAD(10.0);
+            double pitch_extent = mrpt::DEG2RAD(30.0);
+            double pitch_step   = mrpt::DEG2RAD(10.0);
+            double roll_extent  = mrpt::DEG2RAD(30.0);
+            double roll_step    = mrpt::DEG2RAD(10.0);
+        };
+        RotationLattice rotation_lattice;
+
+        /** Number of decimated local-map points used by the coarse NN
+         *  scoring pass. Set to 0 to disable the pass and run ICP on every
+         *  hypothesis (the exhaustive behavior). */
+        size_t coarse_scoring_points = 500;
+
+        /** NN distances are saturated at this value [m] while scoring, so
+         *  partial overlaps are not dominated by far outliers. */
+        double coarse_max_corr_distance = 2.0;
+
+        /** Admission bound of the branch-and-bound pass: hypotheses are
+         *  refined with ICP only while their coarse score is below
+         *  `prune_score_factor` times the best score seen so far
+         *  (scores grow monotonically with each point, lower is better). */
+        double prune_score_factor = 1.25;
+
+        /** If provided (see SubmapTileIndex::selectTiles()), every ICP run
+         * matches against the reduced submap of the selected tiles instead
+         * of the full reference_map, and so does the coarse scoring pass.
+         */
+        std::optional<SubmapTileIndex::Selection> prior_tiles;
+
         std::function<void(const ProgressFeedback&)> on_progress_callback;
 
         Input() = default;
@@ -141,6 +471,13 @@ struct RelocalizationICP_SE2
         mola::HashedSetSE3 found_poses;
         double             time_cost = .0;  //!< [s]
 
+        /// Total number of hypotheses (candidates x rotation lattice):
+        uint64_t num_hypotheses = 0;
+
+        /// Number of hypotheses that survived the coarse pass and went
+        /// through the full ICP pipeline:
+        uint64_t num_icp_runs = 0;
+
         Output() = default;
     };
 
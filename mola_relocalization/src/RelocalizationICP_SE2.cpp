@@ -27,8 +27,14 @@
 #include <mola_relocalization/relocalization.h>
 #include <mrpt/core/Clock.h>
 #include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/version.h>
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <optional>
+
 // METHOD: ICP
 mola::RelocalizationICP_SE2::Output mola::RelocalizationICP_SE2::run(
     const Input& in)
@@ -40,11 +46,41 @@ mola::RelocalizationICP_SE2::Output mola::RelocalizationICP_SE2::run(
 
     const auto& igl = in.initial_guess_lattice;  // shortcut
 
+    // With a tile prior (e.g. a rough GNSS fix), clip the initial guess
+    // lattice to the bounding box of the selected submap tiles, and match
+    // against the reduced submap only:
+    auto cornerMin = igl.corner_min, cornerMax = igl.corner_max;
+
+    std::optional<mp2p_icp::metric_map_t> tileSubmap;
+    if (in.prior_tiles)
+    {
+        const auto& sel = *in.prior_tiles;
+        ASSERT_(sel.index);
+        ASSERT_(!sel.tile_indices.empty());
+
+        mrpt::math::TPoint2D bbMin, bbMax;
+        sel.index->boundingBox(sel.tile_indices, bbMin, bbMax);
+
+        mrpt::keep_max(cornerMin.x, bbMin.x);
+        mrpt::keep_max(cornerMin.y, bbMin.y);
+        mrpt::keep_min(cornerMax.x, bbMax.x);
+        mrpt::keep_min(cornerMax.y, bbMax.y);
+
+        ASSERTMSG_(
+            cornerMin.x < cornerMax.x && cornerMin.y < cornerMax.y,
+            "prior_tiles selection does not overlap the initial guess "
+            "lattice");
+
+        tileSubmap =
+            sel.index->extractSubmap(in.reference_map, sel.tile_indices);
+    }
+    const auto& referenceMap =
+        tileSubmap ? *tileSubmap : in.reference_map;
+
     // Build the grid for all the initial guesses poses:
     const auto grid = mrpt::poses::CPosePDFGrid(
-        igl.corner_min.x, igl.corner_max.x, igl.corner_min.y, igl.corner_max.y,
-        igl.resolution_xy, igl.resolution_phi, igl.corner_min.phi,
-        igl.corner_max.phi);
+        cornerMin.x, cornerMax.x, cornerMin.y, cornerMax.y, igl.resolution_xy,
+        igl.resolution_phi, cornerMin.phi, cornerMax.phi);
 
     const size_t nX   = grid.getSizeX();
     const size_t nY   = grid.getSizeY();
@@ -56,71 +92,149 @@ mola::RelocalizationICP_SE2::Output mola::RelocalizationICP_SE2::run(
 
     ASSERT_(!in.icp_pipeline.empty());
 
+    // Flatten the lattice into a plain list of initial guesses, so the
+    // coarse and fine passes below can run over arbitrary subsets of it:
+    std::vector<mrpt::math::TPose3D> cellPoses;
+    cellPoses.reserve(nCells);
+    for (size_t iX = 0; iX < nX; iX++)
+    {
+        const double x = grid.idx2x(iX);
+        for (size_t iY = 0; iY < nY; iY++)
+        {
+            const double y = grid.idx2y(iY);
+            for (size_t iPhi = 0; iPhi < nPhi; iPhi++)
+            {
+                const double phi = grid.idx2phi(iPhi);
+                cellPoses.emplace_back(x, y, 0, phi, 0, 0);
+            }
+        }
+    }
+
     const size_t nPipelines = in.icp_pipeline.size();
 
     mrpt::WorkerThreadsPool pool(
         nPipelines, mrpt::WorkerThreadsPool::POLICY_FIFO,
         "RelocalizationICP_SE2"  // threads name
     );
-    std::vector<std::mutex>        pipelineMtx(nPipelines);
-    std::mutex                     resultMtx;
-    std::vector<std::future<void>> futs;
+    std::vector<std::mutex> pipelineMtx(nPipelines);
+    std::mutex              resultMtx;
+
+    // Best-so-far ICP quality over all evaluated cells (all threads):
+    std::atomic<double> bestQuality{.0};
+    std::atomic<bool>   earlyExit{false};
 
-    // evaluate over the grid:
-    for (size_t iX = 0, iGlobal = 0; iX < nX; iX++)
+    const auto updateBestQuality = [&bestQuality](double q)
     {
-        const double x = grid.idx2x(iX);
-        for (size_t iY = 0; iY < nY; iY++)
+        double prev = bestQuality.load();
+        while (q > prev && !bestQuality.compare_exchange_weak(prev, q)) {}
+    };
+
+    // Runs ICP in parallel over the given subset of lattice cells.
+    // If `coarseQualities` is provided, this is the coarse scoring pass:
+    // qualities are recorded per cell and no pose is accepted yet.
+    const auto runPass =
+        [&](const std::vector<size_t>&  cellIndices,
+            const mp2p_icp::Parameters& icpParams,
+            std::vector<double>*        coarseQualities)
+    {
+        std::atomic<size_t>            cellsDone{0};
+        std::vector<std::future<void>> futs;
+        futs.reserve(cellIndices.size());
+
+        for (size_t i = 0; i < cellIndices.size(); i++)
         {
-            const double y = grid.idx2y(iY);
-            for (size_t iPhi = 0; iPhi < nPhi; iPhi++, iGlobal++)
-            {
-                const double phi = grid.idx2phi(iPhi);
+            const size_t cellIdx = cellIndices[i];
 
-                const auto initGuessPose =
-                    mrpt::math::TPose3D(x, y, 0, phi, 0, 0);
+            auto f = pool.enqueue(
+                [i, cellIdx, &cellIndices, &cellPoses, &icpParams,
+                 &coarseQualities, &cellsDone, nPipelines, &in, &referenceMap,
+                 &resultMtx, &result, &pipelineMtx, &bestQuality, &earlyExit,
+                 &updateBestQuality]()
+                {
+                    if (earlyExit) return;
 
-                auto f = pool.enqueue(
-                    [initGuessPose, iGlobal, nCells, nPipelines, &in,
-                     &resultMtx, &result, &pipelineMtx]()
-                    {
-                        size_t threadIdx = iGlobal % nPipelines;
+                    const size_t threadIdx = i % nPipelines;
 
-                        auto lck1 = mrpt::lockHelper(pipelineMtx.at(threadIdx));
+                    auto lck1 = mrpt::lockHelper(pipelineMtx.at(threadIdx));
 
-                        mp2p_icp::Results icpResult;
+                    const auto& initGuessPose = cellPoses.at(cellIdx);
 
-                        in.icp_pipeline.at(threadIdx)->align(
-                            in.local_map, in.reference_map, initGuessPose,
-                            in.icp_parameters, icpResult);
+                    mp2p_icp::Results icpResult;
 
-                        // report progress to the user, if enabled:
-                        if (in.on_progress_callback)
-                        {
-                            ProgressFeedback p;
-                            p.cell_init_guess      = initGuessPose;
-                            p.current_cell         = iGlobal;
-                            p.total_cells          = nCells;
-                            p.obtained_icp_quality = icpResult.quality;
+                    in.icp_pipeline.at(threadIdx)->align(
+                        in.local_map, referenceMap, initGuessPose, icpParams,
+                        icpResult);
 
-                            in.on_progress_callback(p);
-                        }
+                    if (coarseQualities)
+                        (*coarseQualities)[cellIdx] = icpResult.quality;
+                    else
+                        updateBestQuality(icpResult.quality);
 
-                        if (icpResult.quality < in.icp_minimum_quality) return;
+                    // report progress to the user, if enabled:
+                    if (in.on_progress_callback)
+                    {
+                        ProgressFeedback p;
+                        p.cell_init_guess      = initGuessPose;
+                        p.current_cell         = cellsDone++;
+                        p.total_cells          = cellIndices.size();
+                        p.obtained_icp_quality = icpResult.quality;
+                        p.best_quality_so_far  = bestQuality.load();
 
-                        // accept result:
-                        auto lck2 = mrpt::lockHelper(resultMtx);
-                        result.found_poses.insertPose(
-                            icpResult.optimal_tf.mean.asTPose());
-                    });
+                        in.on_progress_callback(p);
+                    }
 
-                futs.emplace_back(std::move(f));
-            }
+                    // only the fine pass accepts hypotheses:
+                    if (coarseQualities) return;
+
+                    if (in.icp_early_exit_quality.has_value() &&
+                        icpResult.quality >= *in.icp_early_exit_quality)
+                        earlyExit = true;
+
+                    if (icpResult.quality < in.icp_minimum_quality) return;
+
+                    // accept result:
+                    auto lck2 = mrpt::lockHelper(resultMtx);
+                    result.found_poses.insertPose(
+                        icpResult.optimal_tf.mean.asTPose());
+                });
+
+            futs.emplace_back(std::move(f));
         }
+
+        // wait for all of them to end:
+        for (auto& f : futs) f.get();
+    };
+
+    // Decide which cells deserve the full (expensive) ICP run:
+    std::vector<size_t> fineCells;
+
+    if (in.coarse_icp_parameters.has_value())
+    {
+        // Coarse-to-fine: score every cell with the cheap ICP settings
+        // first, then prune all the branches whose score falls below the
+        // given fraction of the best coarse score:
+        std::vector<size_t> allCells(nCells);
+        std::iota(allCells.begin(), allCells.end(), 0U);
+
+        std::vector<double> coarseQuality(nCells, .0);
+        runPass(allCells, *in.coarse_icp_parameters, &coarseQuality);
+
+        const double bestCoarse =
+            *std::max_element(coarseQuality.begin(), coarseQuality.end());
+
+        const double bound = bestCoarse * in.prune_coarse_quality_fraction;
+
+        for (size_t i = 0; i < nCells; i++)
+            if (coarseQuality[i] >= bound) fineCells.push_back(i);
+    }
+    else
+    {
+        // classic exhaustive search over the whole lattice:
+        fineCells.resize(nCells);
+        std::iota(fineCells.begin(), fineCells.end(), 0U);
     }
 
-    // wait for all of them to end:
-    for (auto& f : futs) f.get();
+    runPass(fineCells, in.icp_parameters, nullptr);
 
     result.time_cost = mrpt::Clock::nowDouble() - t0;
 
@@ -0,0 +1,334 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   RelocalizationICP_SE3.cpp
+ * @brief  Algorithms for localization starting with large uncertainty.
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_relocalization/relocalization.h>
+#include <mrpt/core/Clock.h>
+#include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/core/lock_helper.h>
+#include <mrpt/maps/CPointsMap.h>
+#include <mrpt/maps/NearestNeighborsCapable.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <optional>
+#include <thread>
+
+namespace
+{
+/** Angular offsets [-extent, +extent] in steps of `step`; a zero extent
+ *  leaves the angle untouched. */
+std::vector<double> lattice_offsets(double extent, double step)
+{
+    std::vector<double> out;
+    if (extent <= 0)
+    {
+        out.push_back(.0);
+        return out;
+    }
+    ASSERT_GT_(step, .0);
+    for (double a = -extent; a <= extent + 1e-9; a += step) out.push_back(a);
+    return out;
+}
+}  // namespace
+
+// METHOD: ICP, full SE(3)
+mola::RelocalizationICP_SE3::Output mola::RelocalizationICP_SE3::run(
+    const Input& in)
+{
+    mola::RelocalizationICP_SE3::Output result;
+    const double                        t0 = mrpt::Clock::nowDouble();
+
+    ASSERT_(!in.reference_map.layers.empty());
+    ASSERT_(!in.local_map.layers.empty());
+    ASSERT_(!in.candidates.empty());
+    ASSERT_(!in.icp_pipeline.empty());
+
+    // With a tile prior, match against the reduced submap only:
+    std::optional<mp2p_icp::metric_map_t> tileSubmap;
+    if (in.prior_tiles)
+    {
+        const auto& sel = *in.prior_tiles;
+        ASSERT_(sel.index);
+        ASSERT_(!sel.tile_indices.empty());
+
+        tileSubmap =
+            sel.index->extractSubmap(in.reference_map, sel.tile_indices);
+    }
+    const auto& referenceMap = tileSubmap ? *tileSubmap : in.reference_map;
+
+    // 1) Expand each candidate base pose with the rotation lattice:
+    const auto yaws =
+        lattice_offsets(in.rotation_lattice.yaw_extent,  //
+                        in.rotation_lattice.yaw_step);
+    const auto pitches =
+        lattice_offsets(in.rotation_lattice.pitch_extent,  //
+                        in.rotation_lattice.pitch_step);
+    const auto rolls =
+        lattice_offsets(in.rotation_lattice.roll_extent,  //
+                        in.rotation_lattice.roll_step);
+
+    std::vector<mrpt::math::TPose3D> hypotheses;
+    in.candidates.visitAllPoses(
+        [&](const mrpt::math::TPose3D& base)
+        {
+            for (const double dYaw : yaws)
+                for (const double dPitch : pitches)
+                    for (const double dRoll : rolls)
+                        hypotheses.emplace_back(
+                            base.x, base.y, base.z, base.yaw + dYaw,
+                            base.pitch + dPitch, base.roll + dRoll);
+        });
+
+    result.num_hypotheses = hypotheses.size();
+
+    // 2) Coarse scoring pass (optional): rank every hypothesis by the NN
+    // distances of a decimated subset of the local-map points against the
+    // reference map, and keep only the best-scoring fraction for ICP.
+    std::vector<size_t> icpHypotheses;
+
+    if (in.coarse_scoring_points > 0 && hypotheses.size() > 1)
+    {
+        // 2.a) Decimated local-map points, over all point layers:
+        std::vector<mrpt::math::TPoint3Df> localPts;
+        {
+            size_t nTotalPts = 0;
+            for (const auto& [name, map] : in.local_map.layers)
+                if (auto pts =
+                        std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(map);
+                    pts)
+                    nTotalPts += pts->size();
+            ASSERTMSG_(
+                nTotalPts > 0,
+                "Coarse scoring requires at least one non-empty point-cloud "
+                "layer in local_map");
+
+            const size_t decim =
+                std::max<size_t>(1, nTotalPts / in.coarse_scoring_points);
+
+            for (const auto& [name, map] : in.local_map.layers)
+            {
+                auto pts =
+                    std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(map);
+                if (!pts) continue;
+
+                const auto& xs = pts->getPointsBufferRef_x();
+                const auto& ys = pts->getPointsBufferRef_y();
+                const auto& zs = pts->getPointsBufferRef_z();
+                for (size_t i = 0; i < xs.size(); i += decim)
+                    localPts.emplace_back(xs[i], ys[i], zs[i]);
+            }
+        }
+
+        // 2.b) NN-capable reference layers:
+        std::vector<const mrpt::maps::NearestNeighborsCapable*> nnLayers;
+        for (const auto& [name, map] : referenceMap.layers)
+            if (auto nn =
+                    dynamic_cast<const mrpt::maps::NearestNeighborsCapable*>(
+                        map.get());
+                nn)
+            {
+                nn->nn_prepare_for_3d_queries();
+                nnLayers.push_back(nn);
+            }
+        ASSERTMSG_(
+            !nnLayers.empty(),
+            "Coarse scoring requires at least one reference map layer "
+            "implementing NearestNeighborsCapable");
+
+        // 2.c) Score all hypotheses in parallel. Scores are sums of
+        // saturated squared NN distances (lower is better), growing
+        // monotonically with each point: once the partial sum of a
+        // hypothesis exceeds the admission bound (a factor over the best
+        // complete score so far), it can never be admitted, so it is
+        // abandoned early, branch-and-bound style.
+        const float maxSqrDist = mrpt::square(
+            static_cast<float>(in.coarse_max_corr_distance));
+
+        constexpr float  PRUNED = std::numeric_limits<float>::infinity();
+        constexpr size_t PRUNE_CHECK_BLOCK = 64;
+
+        std::vector<float>  scores(hypotheses.size(), PRUNED);
+        std::atomic<float>  bestScore{PRUNED};
+        const float         pruneFactor =
+            static_cast<float>(in.prune_score_factor);
+
+        const auto scoreOne = [&](const size_t hypIdx)
+        {
+            const auto pose = mrpt::poses::CPose3D(hypotheses[hypIdx]);
+
+            float sum = .0f;
+            for (size_t i = 0; i < localPts.size(); i++)
+            {
+                if ((i % PRUNE_CHECK_BLOCK) == 0)
+                {
+                    const float best = bestScore.load();
+                    if (std::isfinite(best) && sum > best * pruneFactor)
+                        return;  // hopeless: leave it as PRUNED
+                }
+
+                const auto& lp = localPts[i];
+                double      gx, gy, gz;
+                pose.composePoint(lp.x, lp.y, lp.z, gx, gy, gz);
+                const auto g = mrpt::math::TPoint3Df(
+                    static_cast<float>(gx), static_cast<float>(gy),
+                    static_cast<float>(gz));
+
+                float bestSqr = maxSqrDist;
+                for (const auto* nn : nnLayers)
+                {
+                    mrpt::math::TPoint3Df nnPt;
+                    float                 sqrDist = 0;
+                    uint64_t              nnId    = 0;
+                    if (nn->nn_single_search(g, nnPt, sqrDist, nnId))
+                        mrpt::keep_min(bestSqr, sqrDist);
+                }
+                sum += bestSqr;
+            }
+
+            scores[hypIdx] = sum;
+
+            float prev = bestScore.load();
+            while ((!std::isfinite(prev) || sum < prev) &&
+                   !bestScore.compare_exchange_weak(prev, sum))
+            {
+            }
+        };
+
+        const size_t nScoringThreads = std::max<size_t>(
+            1, std::thread::hardware_concurrency());
+
+        mrpt::WorkerThreadsPool scoringPool(
+            nScoringThreads, mrpt::WorkerThreadsPool::POLICY_FIFO,
+            "RelocICP_SE3_score");
+
+        std::vector<std::future<void>> futs;
+        futs.reserve(hypotheses.size());
+        for (size_t h = 0; h < hypotheses.size(); h++)
+            futs.emplace_back(scoringPool.enqueue([h, &scoreOne]()
+                                                  { scoreOne(h); }));
+        for (auto& f : futs) f.get();
+
+        // 2.d) Admit the survivors:
+        const float bound = bestScore.load() * pruneFactor;
+        for (size_t h = 0; h < hypotheses.size(); h++)
+            if (scores[h] <= bound) icpHypotheses.push_back(h);
+    }
+    else
+    {
+        // exhaustive: run ICP on every hypothesis
+        icpHypotheses.resize(hypotheses.size());
+        for (size_t h = 0; h < hypotheses.size(); h++) icpHypotheses[h] = h;
+    }
+
+    result.num_icp_runs = icpHypotheses.size();
+
+    // 3) Full ICP on the surviving hypotheses, in parallel pipelines
+    // (same scheme as RelocalizationICP_SE2):
+    const size_t nPipelines = in.icp_pipeline.size();
+
+    mrpt::WorkerThreadsPool pool(
+        nPipelines, mrpt::WorkerThreadsPool::POLICY_FIFO,
+        "RelocalizationICP_SE3"  // threads name
+    );
+    std::vector<std::mutex> pipelineMtx(nPipelines);
+    std::mutex              resultMtx;
+
+    std::atomic<double> bestQuality{.0};
+    std::atomic<bool>   earlyExit{false};
+    std::atomic<size_t> cellsDone{0};
+
+    const auto updateBestQuality = [&bestQuality](double q)
+    {
+        double prev = bestQuality.load();
+        while (q > prev && !bestQuality.compare_exchange_weak(prev, q)) {}
+    };
+
+    std::vector<std::future<void>> futs;
+    futs.reserve(icpHypotheses.size());
+
+    for (size_t i = 0; i < icpHypotheses.size(); i++)
+    {
+        const size_t hypIdx = icpHypotheses[i];
+
+        auto f = pool.enqueue(
+            [i, hypIdx, &hypotheses, &icpHypotheses, &in, &referenceMap,
+             &resultMtx, &result, &pipelineMtx, &bestQuality, &earlyExit,
+             &cellsDone, nPipelines, &updateBestQuality]()
+            {
+                if (earlyExit) return;
+
+                const size_t threadIdx = i % nPipelines;
+
+                auto lck1 = mrpt::lockHelper(pipelineMtx.at(threadIdx));
+
+                const auto& initGuessPose = hypotheses.at(hypIdx);
+
+                mp2p_icp::Results icpResult;
+
+                in.icp_pipeline.at(threadIdx)->align(
+                    in.local_map, referenceMap, initGuessPose,
+                    in.icp_parameters, icpResult);
+
+                updateBestQuality(icpResult.quality);
+
+                // report progress to the user, if enabled:
+                if (in.on_progress_callback)
+                {
+                    ProgressFeedback p;
+                    p.cell_init_guess      = initGuessPose;
+                    p.current_cell         = cellsDone++;
+                    p.total_cells          = icpHypotheses.size();
+                    p.obtained_icp_quality = icpResult.quality;
+                    p.best_quality_so_far  = bestQuality.load();
+
+                    in.on_progress_callback(p);
+                }
+
+                if (in.icp_early_exit_quality.has_value() &&
+                    icpResult.quality >= *in.icp_early_exit_quality)
+                    earlyExit = true;
+
+                if (icpResult.quality < in.icp_minimum_quality) return;
+
+                // accept result:
+                auto lck2 = mrpt::lockHelper(resultMtx);
+                result.found_poses.insertPose(
+                    icpResult.optimal_tf.mean.asTPose());
+            });
+
+        futs.emplace_back(std::move(f));
+    }
+
+    // wait for all of them to end:
+    for (auto& f : futs) f.get();
+
+    result.time_cost = mrpt::Clock::nowDouble() - t0;
+
+    return result;
+}
@@ -27,14 +27,120 @@
 #include <mola_relocalization/relocalization.h>
 #include <mrpt/core/Clock.h>
 #include <mrpt/core/WorkerThreadsPool.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/version.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <optional>
+#include <thread>
+#include <vector>
 
 /** \defgroup mola_relocalization_grp mola-relocalization
  * Algorithms for localization starting with large uncertainty.
  */
 
+// -------- LikelihoodField --------
+void mola::RelocalizationLikelihood_SE2::LikelihoodField::build(
+    const mp2p_icp::metric_map_t& refMap, double resolution, double sigma_dist,
+    double max_corr_distance)
+{
+    ASSERT_GT_(resolution, .0);
+    ASSERT_GT_(sigma_dist, .0);
+    ASSERT_GT_(max_corr_distance, .0);
+
+    // Gather all point-cloud layers into one KD-tree-searchable map:
+    mrpt::maps::CSimplePointsMap refPts;
+    for (const auto& [layerName, map] : refMap.layers)
+    {
+        ASSERT_(map);
+        if (auto pts = std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(map);
+            pts)
+        {
+            refPts.insertAnotherMap(pts.get(), mrpt::poses::CPose3D());
+        }
+    }
+    ASSERT_(!refPts.empty());
+
+    const auto bb = refPts.boundingBox();
+
+    grid_.setSize(
+        bb.min.x - max_corr_distance, bb.max.x + max_corr_distance,
+        bb.min.y - max_corr_distance, bb.max.y + max_corr_distance,
+        resolution);
+
+    // Distance transform: one nearest-neighbor query per cell, once, so
+    // scoring candidate poses later on does not need the KD-tree at all:
+    const double maxSqrDist = mrpt::square(max_corr_distance);
+    const double k          = -0.5 / mrpt::square(sigma_dist);
+
+    minLogLik_ = k * maxSqrDist;
+
+    for (size_t iy = 0; iy < grid_.getSizeY(); iy++)
+    {
+        const float cy = static_cast<float>(grid_.idx2y(iy));
+        for (size_t ix = 0; ix < grid_.getSizeX(); ix++)
+        {
+            const float cx = static_cast<float>(grid_.idx2x(ix));
+
+            float nnX = 0, nnY = 0, nnSqrDist = 0;
+            refPts.kdTreeClosestPoint2D(cx, cy, nnX, nnY, nnSqrDist);
+
+            const double sqrDist =
+                std::min<double>(nnSqrDist, maxSqrDist);
+
+            float* cell = grid_.cellByIndex(ix, iy);
+            ASSERT_(cell);
+            *cell = static_cast<float>(k * sqrDist);
+        }
+    }
+
+    built_ = true;
+}
+
+double mola::RelocalizationLikelihood_SE2::LikelihoodField::evaluate(
+    const mrpt::maps::CSimplePointsMap& pts,
+    const mrpt::math::TPose2D& pose, double prune_log_lik_bound) const
+{
+    ASSERT_(built_);
+
+    const auto& xs = pts.getPointsBufferRef_x();
+    const auto& ys = pts.getPointsBufferRef_y();
+
+    const size_t N = xs.size();
+
+    const double c = std::cos(pose.phi), s = std::sin(pose.phi);
+
+    // Points are processed in fixed-size blocks so the hot accumulation
+    // loop stays free of the early-exit branch (and is vectorizable);
+    // the bound is only checked once per block:
+    constexpr size_t BLOCK = 64;
+
+    double sum = 0;
+    for (size_t i0 = 0; i0 < N; i0 += BLOCK)
+    {
+        const size_t iEnd = std::min(N, i0 + BLOCK);
+
+        double blockSum = 0;
+        for (size_t i = i0; i < iEnd; i++)
+        {
+            const double gx = pose.x + c * xs[i] - s * ys[i];
+            const double gy = pose.y + s * xs[i] + c * ys[i];
+
+            const float* cell = grid_.cellByPos(gx, gy);
+            blockSum += cell ? *cell : minLogLik_;
+        }
+        sum += blockSum;
+
+        // all remaining terms are <=0, so once below the bound this
+        // candidate cannot recover:
+        if (sum < prune_log_lik_bound) break;
+    }
+    return sum;
+}
+
 // METHOD: likelihood
 mola::RelocalizationLikelihood_SE2::Output
     mola::RelocalizationLikelihood_SE2::run(const Input& in)
@@ -44,11 +150,35 @@ mola::RelocalizationLikelihood_SE2::Output
     const double t0 = mrpt::Clock::nowDouble();
 
     ASSERT_(!in.reference_map.layers.empty());
+    ASSERT_GE_(in.multires_levels, 1U);
+    ASSERT_GT_(in.multires_keep_fraction, .0);
+    ASSERT_LE_(in.multires_keep_fraction, 1.0);
+
+    // With a tile prior (e.g. a rough GNSS fix), clip the search lattice
+    // to the bounding box of the selected submap tiles:
+    auto cornerMin = in.corner_min, cornerMax = in.corner_max;
+    if (in.prior_tiles)
+    {
+        const auto& sel = *in.prior_tiles;
+        ASSERT_(sel.index);
+        ASSERT_(!sel.tile_indices.empty());
+
+        mrpt::math::TPoint2D bbMin, bbMax;
+        sel.index->boundingBox(sel.tile_indices, bbMin, bbMax);
+
+        mrpt::keep_max(cornerMin.x, bbMin.x);
+        mrpt::keep_max(cornerMin.y, bbMin.y);
+        mrpt::keep_min(cornerMax.x, bbMax.x);
+        mrpt::keep_min(cornerMax.y, bbMax.y);
+
+        ASSERTMSG_(
+            cornerMin.x < cornerMax.x && cornerMin.y < cornerMax.y,
+            "prior_tiles selection does not overlap the search area");
+    }
 
     result.likelihood_grid = mrpt::poses::CPosePDFGrid(
-        in.corner_min.x, in.corner_max.x, in.corner_min.y, in.corner_max.y,
-        in.resolution_xy, in.resolution_phi, in.corner_min.phi,
-        in.corner_max.phi);
+        cornerMin.x, cornerMax.x, cornerMin.y, cornerMax.y, in.resolution_xy,
+        in.resolution_phi, cornerMin.phi, cornerMax.phi);
 
     auto& grid = result.likelihood_grid;
 
@@ -59,37 +189,184 @@ mola::RelocalizationLikelihood_SE2::Output
     const size_t nCells = nX * nY * nPhi;
     ASSERT_(nCells > 0);
 
-    // evaluate over the grid:
-    std::optional<double> minW, maxW;
+    // If the caller provided a precomputed likelihood field, flatten the
+    // observations into a point cloud once; per-pose scoring then becomes
+    // one table lookup per point:
+    const bool useField =
+        in.likelihood_field && !in.likelihood_field->empty();
 
-    for (size_t iX = 0, iGlobal = 0; iX < nX; iX++)
+    mrpt::maps::CSimplePointsMap queryPts;
+    if (useField)
     {
-        const double x = grid.idx2x(iX);
-        for (size_t iY = 0; iY < nY; iY++)
+        in.observations.insertObservationsInto(&queryPts);
+        ASSERT_(!queryPts.empty());
+    }
+
+    // Best candidate log-likelihood seen so far (all threads), used as the
+    // pruning bound for early-exit scoring against the field:
+    std::atomic<double> bestSeen{std::numeric_limits<double>::lowest()};
+
+    // Scores one candidate pose against the field or the raw map layers:
+    const auto scorePose = [&](double x, double y, double phi) -> double
+    {
+        if (useField)
         {
-            const double y = grid.idx2y(iY);
-            for (size_t iPhi = 0; iPhi < nPhi; iPhi++, iGlobal++)
+            double bound = std::numeric_limits<double>::lowest();
+            if (in.prune_bound_margin > 0)
+                bound = bestSeen.load() - in.prune_bound_margin;
+
+            const double logLik =
+                in.likelihood_field->evaluate(queryPts, {x, y, phi}, bound);
+
+            double prev = bestSeen.load();
+            while (logLik > prev &&
+                   !bestSeen.compare_exchange_weak(prev, logLik))
             {
-                const double phi = grid.idx2phi(iPhi);
+            }
+            return logLik;
+        }
+
+        const auto pose =
+            mrpt::poses::CPose3D::FromXYZYawPitchRoll(x, y, 0, phi, 0, 0);
+
+        double logLik = 0;
+        for (const auto& [layerName, map] : in.reference_map.layers)
+        {
+            ASSERT_(map);
+            logLik =
+                map->computeObservationsLikelihood(in.observations, pose);
+        }
+        return logLik;
+    };
+
+    // A candidate is a cell of the final (target-resolution) lattice,
+    // addressed by its grid indices:
+    struct Candidate
+    {
+        size_t iX = 0, iY = 0, iPhi = 0;
+        double logLik = 0;
+    };
+
+    // Stride, in final-lattice cells, of the first (coarsest) pass:
+    const size_t levels = in.multires_levels;
+    size_t       stride = size_t(1) << (levels - 1);
+
+    std::vector<Candidate> cands;
+    for (size_t iX = 0; iX < nX; iX += stride)
+        for (size_t iY = 0; iY < nY; iY += stride)
+            for (size_t iPhi = 0; iPhi < nPhi; iPhi += stride)
+                cands.push_back({iX, iY, iPhi, 0});
 
-                const auto pose = mrpt::poses::CPose3D::FromXYZYawPitchRoll(
-                    x, y, 0, phi, 0, 0);
+    const size_t nThreads =
+        std::max<size_t>(1, std::thread::hardware_concurrency());
 
-                for (const auto& [layerName, map] : in.reference_map.layers)
+    mrpt::WorkerThreadsPool pool(
+        nThreads, mrpt::WorkerThreadsPool::POLICY_FIFO,
+        "RelocLikelihood_SE2"  // threads name
+    );
+
+    // Scores all candidates in parallel, chunked over the thread pool:
+    const auto evaluateAll = [&](std::vector<Candidate>& cs)
+    {
+        result.evaluated_poses += cs.size();
+
+        // mrpt maps build their KD-trees and likelihood caches lazily on
+        // first use, which is not thread-safe: warm them up with one
+        // serial evaluation before fanning out.
+        size_t firstIdx = 0;
+        if (!useField && !cs.empty())
+        {
+            auto& c  = cs.front();
+            c.logLik = scorePose(
+                grid.idx2x(c.iX), grid.idx2y(c.iY), grid.idx2phi(c.iPhi));
+            firstIdx = 1;
+        }
+
+        const size_t chunkSize =
+            std::max<size_t>(16, cs.size() / (8 * nThreads));
+
+        std::vector<std::future<void>> futs;
+        for (size_t i = firstIdx; i < cs.size(); i += chunkSize)
+        {
+            const size_t iEnd = std::min(cs.size(), i + chunkSize);
+
+            futs.emplace_back(pool.enqueue(
+                [&cs, &grid, &scorePose, i, iEnd]()
                 {
-                    ASSERT_(map);
-                    const double logLik = map->computeObservationsLikelihood(
-                        in.observations, pose);
+                    for (size_t k = i; k < iEnd; k++)
+                    {
+                        auto& c  = cs[k];
+                        c.logLik = scorePose(
+                            grid.idx2x(c.iX), grid.idx2y(c.iY),
+                            grid.idx2phi(c.iPhi));
+                    }
+                }));
+        }
+        for (auto& f : futs) f.get();
+    };
 
-                    double* cell = grid.getByIndex(iX, iY, iPhi);
-                    ASSERT_(cell);
-                    *cell = logLik;
+    // Coarse-to-fine refinement; a single level is the classic exhaustive
+    // evaluation of the whole lattice:
+    for (;;)
+    {
+        evaluateAll(cands);
+        if (stride == 1) break;
 
-                    if (!minW || logLik < *minW) minW = logLik;
-                    if (!maxW || logLik > *maxW) maxW = logLik;
-                }
-            }
+        // keep the best fraction of this pass...
+        const size_t nKeep = std::max<size_t>(
+            1, static_cast<size_t>(
+                   std::ceil(in.multires_keep_fraction * cands.size())));
+        if (nKeep < cands.size())
+        {
+            std::nth_element(
+                cands.begin(), cands.begin() + nKeep - 1, cands.end(),
+                [](const Candidate& a, const Candidate& b)
+                { return a.logLik > b.logLik; });
+            cands.resize(nKeep);
         }
+
+        // ...and subdivide only those for the next, finer pass:
+        const size_t h = stride / 2;
+
+        std::vector<Candidate> next;
+        next.reserve(cands.size() * 8);
+        for (const auto& c : cands)
+            for (size_t dx : {size_t(0), h})
+                for (size_t dy : {size_t(0), h})
+                    for (size_t dPhi : {size_t(0), h})
+                    {
+                        const size_t iX = c.iX + dx, iY = c.iY + dy,
+                                     iPhi = c.iPhi + dPhi;
+                        if (iX >= nX || iY >= nY || iPhi >= nPhi) continue;
+                        next.push_back({iX, iY, iPhi, 0});
+                    }
+
+        cands  = std::move(next);
+        stride = h;
+    }
+
+    std::optional<double> minW, maxW;
+    for (const auto& c : cands)
+    {
+        if (!minW || c.logLik < *minW) minW = c.logLik;
+        if (!maxW || c.logLik > *maxW) maxW = c.logLik;
+    }
+
+    // Cells pruned by the multi-resolution search keep the worst evaluated
+    // log-likelihood, i.e. negligible probability after normalization:
+    if (cands.size() < nCells)
+    {
+        for (size_t iX = 0; iX < nX; iX++)
+            for (size_t iY = 0; iY < nY; iY++)
+                for (size_t iPhi = 0; iPhi < nPhi; iPhi++)
+                    *grid.getByIndex(iX, iY, iPhi) = *minW;
+    }
+
+    for (const auto& c : cands)
+    {
+        double* cell = grid.getByIndex(c.iX, c.iY, c.iPhi);
+        ASSERT_(cell);
+        *cell = c.logLik;
     }
 
     // normalizeWeights and convert log-lik ==> likelihood
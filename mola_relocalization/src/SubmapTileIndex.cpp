@@ -0,0 +1,181 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ *
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * Licensed under the GNU GPL v3 for non-commercial applications.
+ *
+ * This file is part of MOLA.
+ * MOLA is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * MOLA is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+ * A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * MOLA. If not, see <https://www.gnu.org/licenses/>.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   SubmapTileIndex.cpp
+ * @brief  Geo-indexed submap tiles for prior-guided relocalization.
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_relocalization/relocalization.h>
+#include <mrpt/core/bits_math.h>
+#include <mrpt/maps/CPointsMap.h>
+
+#include <algorithm>
+#include <limits>
+#include <set>
+
+void mola::SubmapTileIndex::build(
+    const mp2p_icp::metric_map_t& refMap, double tile_size)
+{
+    ASSERT_GT_(tile_size, .0);
+
+    tileSize_    = tile_size;
+    tileSizeInv_ = 1.0 / tile_size;
+    tiles_.clear();
+    tileByCoords_.clear();
+
+    struct Accum
+    {
+        double   sx = 0, sy = 0, sz = 0;
+        uint64_t n    = 0;
+        float    zMin = std::numeric_limits<float>::max();
+        float    zMax = -std::numeric_limits<float>::max();
+    };
+    std::map<std::pair<int32_t, int32_t>, Accum> acc;
+
+    for (const auto& [layerName, map] : refMap.layers)
+    {
+        ASSERT_(map);
+        auto pts = std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(map);
+        if (!pts) continue;
+
+        const auto& xs = pts->getPointsBufferRef_x();
+        const auto& ys = pts->getPointsBufferRef_y();
+        const auto& zs = pts->getPointsBufferRef_z();
+
+        for (size_t i = 0; i < xs.size(); i++)
+        {
+            auto& a = acc[tileCoordsOf(xs[i], ys[i])];
+            a.sx += xs[i];
+            a.sy += ys[i];
+            a.sz += zs[i];
+            a.n++;
+            mrpt::keep_min(a.zMin, zs[i]);
+            mrpt::keep_max(a.zMax, zs[i]);
+        }
+    }
+    ASSERTMSG_(
+        !acc.empty(), "No point-cloud layers found in the reference map");
+
+    tiles_.reserve(acc.size());
+    for (const auto& [coords, a] : acc)
+    {
+        auto& t = tiles_.emplace_back();
+
+        t.cx          = coords.first;
+        t.cy          = coords.second;
+        t.point_count = a.n;
+        t.centroid    = {a.sx / a.n, a.sy / a.n, a.sz / a.n};
+        t.z_min       = a.zMin;
+        t.z_max       = a.zMax;
+
+        tileByCoords_[coords] = tiles_.size() - 1;
+    }
+}
+
+std::vector<size_t> mola::SubmapTileIndex::selectTiles(
+    const mrpt::math::TPoint2D& prior_position, double prior_radius) const
+{
+    ASSERT_GT_(prior_radius, .0);
+
+    std::vector<size_t> sel;
+    for (size_t i = 0; i < tiles_.size(); i++)
+    {
+        const auto& t = tiles_[i];
+
+        // distance from the prior to the closest point of the tile square:
+        const double nx = std::clamp(
+            prior_position.x, t.cx * tileSize_, (t.cx + 1) * tileSize_);
+        const double ny = std::clamp(
+            prior_position.y, t.cy * tileSize_, (t.cy + 1) * tileSize_);
+
+        if (mrpt::square(prior_position.x - nx) +
+                mrpt::square(prior_position.y - ny) <=
+            mrpt::square(prior_radius))
+            sel.push_back(i);
+    }
+    return sel;
+}
+
+void mola::SubmapTileIndex::boundingBox(
+    const std::vector<size_t>& tile_indices, mrpt::math::TPoint2D& corner_min,
+    mrpt::math::TPoint2D& corner_max) const
+{
+    ASSERT_(!tile_indices.empty());
+
+    corner_min = {
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    corner_max = {
+        -std::numeric_limits<double>::max(),
+        -std::numeric_limits<double>::max()};
+
+    for (const size_t idx : tile_indices)
+    {
+        const auto& t = tiles_.at(idx);
+
+        mrpt::keep_min(corner_min.x, t.cx * tileSize_);
+        mrpt::keep_min(corner_min.y, t.cy * tileSize_);
+        mrpt::keep_max(corner_max.x, (t.cx + 1) * tileSize_);
+        mrpt::keep_max(corner_max.y, (t.cy + 1) * tileSize_);
+    }
+}
+
+mp2p_icp::metric_map_t mola::SubmapTileIndex::extractSubmap(
+    const mp2p_icp::metric_map_t& refMap,
+    const std::vector<size_t>&    tile_indices) const
+{
+    ASSERT_(!tile_indices.empty());
+
+    std::set<std::pair<int32_t, int32_t>> selected;
+    for (const size_t idx : tile_indices)
+    {
+        const auto& t = tiles_.at(idx);
+        selected.insert({t.cx, t.cy});
+    }
+
+    // shallow copy: layers are shared_ptr's; only point layers are replaced
+    mp2p_icp::metric_map_t out = refMap;
+
+    for (auto& [layerName, map] : out.layers)
+    {
+        auto pts = std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(map);
+        if (!pts) continue;
+
+        // same dynamic class as the source layer, so ICP matchers behave
+        // identically on the submap:
+        auto filtered = std::dynamic_pointer_cast<mrpt::maps::CPointsMap>(
+            pts->GetRuntimeClass()->createObject());
+        ASSERT_(filtered);
+
+        const auto& xs = pts->getPointsBufferRef_x();
+        const auto& ys = pts->getPointsBufferRef_y();
+        const auto& zs = pts->getPointsBufferRef_z();
+
+        for (size_t i = 0; i < xs.size(); i++)
+        {
+            if (selected.count(tileCoordsOf(xs[i], ys[i])) == 0) continue;
+            filtered->insertPoint(xs[i], ys[i], zs[i]);
+        }
+
+        map = filtered;
+    }
+    return out;
+}
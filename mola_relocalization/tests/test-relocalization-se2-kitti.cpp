@@ -129,6 +129,60 @@ static void test1()
     ASSERT_NEAR_(best.phi, 0.0, 0.1);
 
     std::cout << "best pose: " << best << std::endl;
+
+    // Re-run with a precomputed likelihood field: it must find the same
+    // area, but much faster (scoring is just table lookups):
+    auto field =
+        std::make_shared<mola::RelocalizationLikelihood_SE2::LikelihoodField>();
+    field->build(
+        refMap, 0.10 /*resolution*/, likOpts.sigma_dist,
+        likOpts.max_corr_distance);
+
+    in.likelihood_field = field;
+
+    const auto outField = mola::RelocalizationLikelihood_SE2::run(in);
+
+    std::cout << "time_cost (field): " << outField.time_cost << std::endl;
+
+    const auto bestPosesField =
+        mola::find_best_poses_se2(outField.likelihood_grid, 0.90);
+
+    ASSERT_(!bestPosesField.empty());
+
+    const auto& bestField = bestPosesField.rbegin()->second;
+    ASSERT_NEAR_(bestField.x, 1.5, 0.3);
+    ASSERT_NEAR_(bestField.y, 0.0, 0.3);
+    ASSERT_NEAR_(bestField.phi, 0.0, 0.15);
+
+    std::cout << "best pose (field): " << bestField << std::endl;
+
+    // Re-run in multi-resolution mode: the coarse-to-fine search must find
+    // the same area while evaluating only a fraction of the lattice:
+    in.multires_levels        = 3;
+    in.multires_keep_fraction = 0.10;
+
+    const auto outMR = mola::RelocalizationLikelihood_SE2::run(in);
+
+    const auto& g = outMR.likelihood_grid;
+    const size_t nCells =
+        g.getSizeX() * g.getSizeY() * g.getSizePhi();
+
+    std::cout << "time_cost (multires): " << outMR.time_cost << std::endl;
+    std::cout << "evaluated poses (multires): " << outMR.evaluated_poses
+              << " / " << nCells << std::endl;
+
+    ASSERT_LT_(outMR.evaluated_poses, nCells);
+
+    const auto bestPosesMR = mola::find_best_poses_se2(g, 0.90);
+
+    ASSERT_(!bestPosesMR.empty());
+
+    const auto& bestMR = bestPosesMR.rbegin()->second;
+    ASSERT_NEAR_(bestMR.x, 1.5, 0.3);
+    ASSERT_NEAR_(bestMR.y, 0.0, 0.3);
+    ASSERT_NEAR_(bestMR.phi, 0.0, 0.15);
+
+    std::cout << "best pose (multires): " << bestMR << std::endl;
 }
 
 int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
@@ -0,0 +1,66 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ShmObservationSink.h
+ * @brief  Publishes subscribed observations into a shared-memory ring
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mola_kernel/interfaces/FrontEndBase.h>
+#include <mola_shm_transport/ShmObservationRing.h>
+
+#include <cstdint>
+
+namespace mola
+{
+/** Writer side of the shared-memory observation transport: subscribes to
+ * one or more raw data sources in this process (via the standard
+ * `raw_data_source` front-end parameter) and republishes every observation
+ * into a named shm ring, where a ShmObservationSource in another MOLA
+ * process picks them up.
+ *
+ * Example YAML:
+ * \code
+ * - type: mola::ShmObservationSink
+ *   name: shm_out
+ *   raw_data_source: 'kitti'
+ *   params:
+ *     shm_segment_name: '/mola_obs'
+ *     # slot_count: 16
+ *     # slot_size_MiB: 32.0
+ * \endcode
+ *
+ * \sa ShmObservationSource, ShmObservationRing
+ * \ingroup mola_shm_transport_grp */
+class ShmObservationSink : public FrontEndBase
+{
+    DEFINE_MRPT_OBJECT(ShmObservationSink, mola)
+
+   public:
+    ShmObservationSink()           = default;
+    ~ShmObservationSink() override = default;
+
+    // Virtual interface of any RawDataConsumer
+    void onNewObservation(const CObservation::Ptr& o) override;
+
+    void spinOnce() override;
+
+   protected:
+    // See docs in base class
+    void initialize_frontend(const Yaml& cfg) override;
+
+   private:
+    std::string  shm_segment_name_;
+    unsigned int slot_count_    = 16;
+    double       slot_size_MiB_ = 32.0;
+
+    ShmObservationRing ring_;
+    uint64_t           dropped_too_large_ = 0;
+};
+
+}  // namespace mola
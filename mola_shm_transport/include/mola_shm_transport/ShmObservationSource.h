@@ -0,0 +1,64 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ShmObservationSource.h
+ * @brief  RawDataSource reading observations from a shared-memory ring
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+#pragma once
+
+#include <mola_kernel/interfaces/RawDataSourceBase.h>
+#include <mola_shm_transport/ShmObservationRing.h>
+
+#include <cstdint>
+
+namespace mola
+{
+/** Reader side of the shared-memory observation transport: attaches to the
+ * shm ring written by a ShmObservationSink in another MOLA process and
+ * republishes its observations to the front-ends of this one, as any other
+ * RawDataSourceBase. If the writer process is not up yet, attaching is
+ * retried on every spin.
+ *
+ * Example YAML:
+ * \code
+ * - type: mola::ShmObservationSource
+ *   name: shm_in
+ *   execution_rate: 50 # Hz
+ *   params:
+ *     shm_segment_name: '/mola_obs'
+ *     # read_timeout: 0.050 # [s]
+ * \endcode
+ *
+ * \sa ShmObservationSink, ShmObservationRing
+ * \ingroup mola_shm_transport_grp */
+class ShmObservationSource : public RawDataSourceBase
+{
+    DEFINE_MRPT_OBJECT(ShmObservationSource, mola)
+
+   public:
+    ShmObservationSource()           = default;
+    ~ShmObservationSource() override = default;
+
+    void spinOnce() override;
+
+   protected:
+    // See docs in base class
+    void initialize_rds(const Yaml& cfg) override;
+
+   private:
+    std::string shm_segment_name_;
+    double      read_timeout_ = 0.05;  //!< [s] per-read wait inside spinOnce
+
+    /// Safety bound on observations drained per spinOnce() call:
+    unsigned int max_per_spin_ = 1000;
+
+    ShmObservationRing ring_;
+    uint64_t           last_reported_lost_ = 0;
+};
+
+}  // namespace mola
@@ -0,0 +1,364 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ShmObservationRing.cpp
+ * @brief  Shared-memory ring of serialized observations (POSIX shm)
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_shm_transport/ShmObservationRing.h>
+#include <mrpt/core/exceptions.h>
+#include <mrpt/io/CMemoryStream.h>
+#include <mrpt/serialization/CArchive.h>
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MOLA_HAS_POSIX_SHM 1
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <ctime>
+#endif
+
+using namespace mola;
+
+namespace
+{
+constexpr uint32_t SHM_MAGIC   = 0x4d4f4c53;  // 'MOLS'
+constexpr uint32_t SHM_VERSION = 1;
+
+// Per-slot header, followed by the serialized payload:
+// [0..7]: sequence tag (serial+1 of the write held, 0 = being written)
+// [8..11]: payload size [bytes]
+// [12..15]: (padding)
+constexpr size_t SLOT_HDR_BYTES = 16;
+
+size_t round_up_64(const size_t n) { return (n + 63) & ~size_t(63); }
+}  // namespace
+
+struct ShmObservationRing::Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t slot_count;
+    uint64_t slot_size;
+
+#if defined(MOLA_HAS_POSIX_SHM)
+    /// Process-shared; only used to park/wake idle readers (futex-backed on
+    /// Linux). The data path itself is lock-free:
+    pthread_mutex_t mtx;
+    pthread_cond_t  cv;
+#endif
+
+    /// Total number of completed writes:
+    std::atomic<uint64_t> write_count;
+};
+
+static_assert(
+    std::atomic<uint64_t>::is_always_lock_free,
+    "shm ring requires lock-free 64-bit atomics");
+
+uint8_t* ShmObservationRing::slot_ptr(const size_t idx) const
+{
+    const size_t stride = round_up_64(SLOT_HDR_BYTES + hdr_->slot_size);
+    return reinterpret_cast<uint8_t*>(hdr_) + round_up_64(sizeof(Header)) +
+           idx * stride;
+}
+
+#if defined(MOLA_HAS_POSIX_SHM)
+
+void ShmObservationRing::create(
+    const std::string& name, const size_t slot_count, const size_t slot_size)
+{
+    MRPT_START
+    ASSERT_(!is_open());
+    ASSERT_GT_(slot_count, 1U);
+    ASSERT_GT_(slot_size, 0U);
+
+    // Remove any stale segment from a crashed former run:
+    shm_unlink(name.c_str());
+
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        THROW_EXCEPTION_FMT(
+            "shm_open('%s') failed: %s", name.c_str(), strerror(errno));
+
+    const size_t stride = round_up_64(SLOT_HDR_BYTES + slot_size);
+    const size_t total  = round_up_64(sizeof(Header)) + slot_count * stride;
+
+    if (0 != ftruncate(fd, static_cast<off_t>(total)))
+    {
+        ::close(fd);
+        shm_unlink(name.c_str());
+        THROW_EXCEPTION_FMT(
+            "ftruncate(%lu) on shm segment '%s' failed: %s",
+            static_cast<unsigned long>(total), name.c_str(), strerror(errno));
+    }
+
+    void* mem = mmap(
+        nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 /*offset*/);
+    ::close(fd);  // the mapping keeps the segment alive
+    if (mem == MAP_FAILED)
+        THROW_EXCEPTION_FMT(
+            "mmap() of shm segment '%s' failed: %s", name.c_str(),
+            strerror(errno));
+
+    hdr_        = new (mem) Header();
+    mapped_len_ = total;
+    is_creator_ = true;
+    name_       = name;
+
+    hdr_->version    = SHM_VERSION;
+    hdr_->slot_count = slot_count;
+    hdr_->slot_size  = slot_size;
+    hdr_->write_count.store(0);
+
+    pthread_mutexattr_t ma;
+    pthread_mutexattr_init(&ma);
+    pthread_mutexattr_setpshared(&ma, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&hdr_->mtx, &ma);
+    pthread_mutexattr_destroy(&ma);
+
+    pthread_condattr_t ca;
+    pthread_condattr_init(&ca);
+    pthread_condattr_setpshared(&ca, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&hdr_->cv, &ca);
+    pthread_condattr_destroy(&ca);
+
+    // Mark all slots empty:
+    for (size_t i = 0; i < slot_count; i++)
+        reinterpret_cast<std::atomic<uint64_t>*>(slot_ptr(i))->store(0);
+
+    // Publish the magic *last*: open() in a reader process takes it as "the
+    // segment is fully initialized", so it must not become visible before
+    // the process-shared mutex/condvar above are usable:
+    std::atomic_thread_fence(std::memory_order_release);
+    hdr_->magic = SHM_MAGIC;
+
+    MRPT_END
+}
+
+void ShmObservationRing::open(const std::string& name)
+{
+    MRPT_START
+    ASSERT_(!is_open());
+
+    const int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0)
+        THROW_EXCEPTION_FMT(
+            "shm_open('%s') failed: %s (is the writer process running?)",
+            name.c_str(), strerror(errno));
+
+    struct stat st;
+    if (0 != fstat(fd, &st))
+    {
+        ::close(fd);
+        THROW_EXCEPTION_FMT("fstat() failed: %s", strerror(errno));
+    }
+    const auto total = static_cast<size_t>(st.st_size);
+    ASSERT_GT_(total, sizeof(Header));
+
+    void* mem =
+        mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED)
+        THROW_EXCEPTION_FMT(
+            "mmap() of shm segment '%s' failed: %s", name.c_str(),
+            strerror(errno));
+
+    hdr_        = reinterpret_cast<Header*>(mem);
+    mapped_len_ = total;
+    is_creator_ = false;
+    name_       = name;
+
+    if (hdr_->magic != SHM_MAGIC || hdr_->version != SHM_VERSION)
+    {
+        munmap(mem, total);
+        hdr_ = nullptr;
+        THROW_EXCEPTION_FMT(
+            "shm segment '%s' has an incompatible magic/version",
+            name.c_str());
+    }
+
+    // Start consuming at the current head, not the (stale) backlog:
+    reader_next_ = hdr_->write_count.load(std::memory_order_acquire);
+
+    MRPT_END
+}
+
+void ShmObservationRing::close()
+{
+    if (!hdr_) return;
+    munmap(hdr_, mapped_len_);
+    if (is_creator_) shm_unlink(name_.c_str());
+    hdr_        = nullptr;
+    mapped_len_ = 0;
+    is_creator_ = false;
+}
+
+bool ShmObservationRing::write(const mrpt::obs::CObservation::Ptr& obs)
+{
+    MRPT_START
+    ASSERT_(is_open());
+    ASSERT_(is_creator_);
+    ASSERT_(obs);
+
+    // One serialization into a local buffer, one memcpy into the ring:
+    mrpt::io::CMemoryStream buf;
+    auto                    arch = mrpt::serialization::archiveFrom(buf);
+    arch << obs;
+    const auto n = static_cast<size_t>(buf.getTotalBytesCount());
+    if (n > hdr_->slot_size) return false;  // would not fit
+
+    const uint64_t k    = hdr_->write_count.load(std::memory_order_relaxed);
+    uint8_t*       s    = slot_ptr(k % hdr_->slot_count);
+    auto* seq = reinterpret_cast<std::atomic<uint64_t>*>(s);
+
+    // seqlock-style publication: invalidate, copy, tag with the serial:
+    seq->store(0, std::memory_order_release);
+    *reinterpret_cast<uint32_t*>(s + 8) = static_cast<uint32_t>(n);
+    std::memcpy(s + SLOT_HDR_BYTES, buf.getRawBufferData(), n);
+    seq->store(k + 1, std::memory_order_release);
+
+    hdr_->write_count.store(k + 1, std::memory_order_release);
+
+    // Wake up parked readers (no-op cost if nobody waits):
+    pthread_mutex_lock(&hdr_->mtx);
+    pthread_mutex_unlock(&hdr_->mtx);
+    pthread_cond_broadcast(&hdr_->cv);
+
+    return true;
+    MRPT_END
+}
+
+mrpt::obs::CObservation::Ptr ShmObservationRing::read(const double timeout)
+{
+    MRPT_START
+    ASSERT_(is_open());
+
+    // 1) Wait (futex-parked) until there is something unread:
+    uint64_t wc = hdr_->write_count.load(std::memory_order_acquire);
+    if (wc <= reader_next_)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += static_cast<time_t>(timeout);
+        ts.tv_nsec +=
+            static_cast<long>((timeout - static_cast<time_t>(timeout)) * 1e9);
+        if (ts.tv_nsec >= 1000000000L)
+        {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000L;
+        }
+
+        pthread_mutex_lock(&hdr_->mtx);
+        for (;;)
+        {
+            wc = hdr_->write_count.load(std::memory_order_acquire);
+            if (wc > reader_next_) break;
+            if (ETIMEDOUT == pthread_cond_timedwait(&hdr_->cv, &hdr_->mtx, &ts))
+            {
+                pthread_mutex_unlock(&hdr_->mtx);
+                return {};
+            }
+        }
+        pthread_mutex_unlock(&hdr_->mtx);
+    }
+
+    // 2) Grab the next valid slot, skipping ahead if the writer lapped us:
+    for (int attempts = 0; attempts < 100; attempts++)
+    {
+        if (wc > reader_next_ + hdr_->slot_count)
+        {
+            const uint64_t newNext = wc - hdr_->slot_count;
+            reader_lost_ += newNext - reader_next_;
+            reader_next_ = newNext;
+        }
+
+        const uint64_t k   = reader_next_;
+        const uint8_t* s   = slot_ptr(k % hdr_->slot_count);
+        const auto*    seq = reinterpret_cast<const std::atomic<uint64_t>*>(s);
+
+        if (seq->load(std::memory_order_acquire) != k + 1)
+        {
+            // Recycled (or mid-write) under us: refresh the head & retry.
+            wc = hdr_->write_count.load(std::memory_order_acquire);
+            reader_lost_++;
+            reader_next_++;
+            continue;
+        }
+
+        const auto n = *reinterpret_cast<const uint32_t*>(s + 8);
+        if (n > hdr_->slot_size)
+        {
+            // The size field can be torn if the writer is overwriting this
+            // very slot between our two seq checks; that is the same
+            // situation the re-check below handles, not an error, so skip
+            // the slot instead of throwing:
+            wc = hdr_->write_count.load(std::memory_order_acquire);
+            reader_lost_++;
+            reader_next_++;
+            continue;
+        }
+        scratch_.assign(s + SLOT_HDR_BYTES, s + SLOT_HDR_BYTES + n);
+
+        // Validate that the slot was not overwritten during the copy:
+        if (seq->load(std::memory_order_acquire) != k + 1)
+        {
+            wc = hdr_->write_count.load(std::memory_order_acquire);
+            reader_lost_++;
+            reader_next_++;
+            continue;
+        }
+        reader_next_ = k + 1;
+
+        // 3) Deserialize from the private copy:
+        mrpt::io::CMemoryStream buf;
+        buf.assignMemoryBlock(scratch_.data(), n);
+        buf.Seek(0);
+        auto arch = mrpt::serialization::archiveFrom(buf);
+
+        mrpt::serialization::CSerializable::Ptr o;
+        arch >> o;
+        auto obs = std::dynamic_pointer_cast<mrpt::obs::CObservation>(o);
+        ASSERT_(obs);
+        return obs;
+    }
+    return {};  // pathological contention; let the caller spin again
+
+    MRPT_END
+}
+
+#else  // !MOLA_HAS_POSIX_SHM
+
+void ShmObservationRing::create(const std::string&, const size_t, const size_t)
+{
+    THROW_EXCEPTION(
+        "ShmObservationRing is only available on POSIX platforms.");
+}
+void ShmObservationRing::open(const std::string&)
+{
+    THROW_EXCEPTION(
+        "ShmObservationRing is only available on POSIX platforms.");
+}
+void ShmObservationRing::close() {}
+bool ShmObservationRing::write(const mrpt::obs::CObservation::Ptr&)
+{
+    return false;
+}
+mrpt::obs::CObservation::Ptr ShmObservationRing::read(const double)
+{
+    return {};
+}
+
+#endif
@@ -0,0 +1,79 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ShmObservationSink.cpp
+ * @brief  Publishes subscribed observations into a shared-memory ring
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+/** \defgroup mola_shm_transport_grp mola_shm_transport_grp.
+ * Shared-memory observation transport between separate MOLA processes.
+ */
+
+#include <mola_shm_transport/ShmObservationSink.h>
+#include <mola_yaml/yaml_helpers.h>
+#include <mrpt/core/initializer.h>
+
+using namespace mola;
+
+// arguments: class_name, parent_class, class namespace
+IMPLEMENTS_MRPT_OBJECT(ShmObservationSink, FrontEndBase, mola)
+
+MRPT_INITIALIZER(do_register_ShmObservationSink)
+{
+    MOLA_REGISTER_MODULE(ShmObservationSink);
+}
+
+void ShmObservationSink::initialize_frontend(const Yaml& c)
+{
+    MRPT_START
+    ProfilerEntry tle(profiler_, "initialize");
+
+    ENSURE_YAML_ENTRY_EXISTS(c, "params");
+    auto cfg = c["params"];
+    MRPT_LOG_DEBUG_STREAM("Initializing with these params:\n" << cfg);
+
+    YAML_LOAD_MEMBER_REQ(shm_segment_name, std::string);
+    YAML_LOAD_MEMBER_OPT(slot_count, unsigned int);
+    YAML_LOAD_MEMBER_OPT(slot_size_MiB, double);
+
+    ASSERT_GT_(slot_size_MiB_, .0);
+
+    ring_.create(
+        shm_segment_name_, slot_count_,
+        static_cast<size_t>(slot_size_MiB_ * 1024 * 1024));
+
+    MRPT_LOG_INFO_STREAM(
+        "Created shm segment '" << shm_segment_name_ << "' (" << slot_count_
+                                << " slots x " << slot_size_MiB_ << " MiB)");
+    MRPT_END
+}
+
+void ShmObservationSink::onNewObservation(const CObservation::Ptr& o)
+{
+    MRPT_START
+    ProfilerEntry tle(profiler_, "onNewObservation");
+
+    if (!ring_.is_open()) return;
+
+    if (!ring_.write(o))
+    {
+        dropped_too_large_++;
+        MRPT_LOG_THROTTLE_WARN_FMT(
+            5.0,
+            "Dropped %lu observation(s) larger than the shm slot size "
+            "(latest: '%s'). Consider increasing `slot_size_MiB`.",
+            static_cast<unsigned long>(dropped_too_large_),
+            o->sensorLabel.c_str());
+    }
+    MRPT_END
+}
+
+void ShmObservationSink::spinOnce()
+{
+    // All work happens in onNewObservation(); nothing to do here.
+}
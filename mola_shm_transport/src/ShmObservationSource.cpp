@@ -0,0 +1,100 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   ShmObservationSource.cpp
+ * @brief  RawDataSource reading observations from a shared-memory ring
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 31, 2026
+ */
+
+#include <mola_shm_transport/ShmObservationSource.h>
+#include <mola_yaml/yaml_helpers.h>
+#include <mrpt/core/initializer.h>
+
+using namespace mola;
+
+// arguments: class_name, parent_class, class namespace
+IMPLEMENTS_MRPT_OBJECT(ShmObservationSource, RawDataSourceBase, mola)
+
+MRPT_INITIALIZER(do_register_ShmObservationSource)
+{
+    MOLA_REGISTER_MODULE(ShmObservationSource);
+}
+
+void ShmObservationSource::initialize_rds(const Yaml& c)
+{
+    MRPT_START
+    ProfilerEntry tle(profiler_, "initialize");
+
+    ENSURE_YAML_ENTRY_EXISTS(c, "params");
+    auto cfg = c["params"];
+    MRPT_LOG_DEBUG_STREAM("Initializing with these params:\n" << cfg);
+
+    YAML_LOAD_MEMBER_REQ(shm_segment_name, std::string);
+    YAML_LOAD_MEMBER_OPT(read_timeout, double);
+    YAML_LOAD_MEMBER_OPT(max_per_spin, unsigned int);
+
+    ASSERT_GT_(read_timeout_, .0);
+    ASSERT_GT_(max_per_spin_, 0U);
+
+    // The writer process may not be up yet; keep retrying in spinOnce():
+    try
+    {
+        ring_.open(shm_segment_name_);
+    }
+    catch (const std::exception& e)
+    {
+        MRPT_LOG_INFO_STREAM(
+            "shm segment not available yet, will retry: " << e.what());
+    }
+
+    MRPT_END
+}
+
+void ShmObservationSource::spinOnce()
+{
+    MRPT_START
+    ProfilerEntry tleg(profiler_, "spinOnce");
+
+    if (!ring_.is_open())
+    {
+        try
+        {
+            ring_.open(shm_segment_name_);
+            MRPT_LOG_INFO_STREAM(
+                "Attached to shm segment '" << shm_segment_name_ << "'");
+        }
+        catch (const std::exception&)
+        {
+            MRPT_LOG_THROTTLE_INFO_STREAM(
+                5.0, "Waiting for shm segment '"
+                         << shm_segment_name_
+                         << "' (is the writer process running?)");
+            return;
+        }
+    }
+
+    // Drain whatever the writer published, bounded per spin:
+    for (unsigned int i = 0; i < max_per_spin_; i++)
+    {
+        auto o = ring_.read(read_timeout_);
+        if (!o) break;
+        this->sendObservationsToFrontEnds(o);
+    }
+
+    if (const auto lost = ring_.reader_lost_count();
+        lost != last_reported_lost_)
+    {
+        MRPT_LOG_THROTTLE_WARN_FMT(
+            5.0,
+            "Lost %lu observation(s) so far: this process cannot keep up "
+            "with the writer. Consider a larger `slot_count` on the sink.",
+            static_cast<unsigned long>(lost));
+        last_reported_lost_ = lost;
+    }
+
+    MRPT_END
+}
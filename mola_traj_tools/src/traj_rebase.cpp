@@ -6,9 +6,11 @@
 
 #include <mrpt/core/exceptions.h>
 #include <mrpt/poses/CPose3D.h>
-#include <mrpt/poses/CPose3DInterpolator.h>
 
 #include <iostream>
+#include <optional>
+
+#include "traj_stream.h"
 
 int main(int argc, char** argv)
 {
@@ -27,25 +29,23 @@ int main(int argc, char** argv)
         const std::string sOut = argv[2];
         const std::string sTF  = argv[3];
 
-        mrpt::poses::CPose3DInterpolator pIn;
-        pIn.loadFromTextFile_TUM(sIn);
-
-        std::cout << "Loaded: " << pIn.size() << " poses.\n";
-        ASSERT_(!pIn.empty());
-
-        auto in0 = pIn.begin()->second;
-
-        // Apply tf:
         const auto newStartPose = mrpt::poses::CPose3D::FromString(sTF);
         std::cout << "newStartPose: " << newStartPose << "\n";
 
-        auto tf = newStartPose - mrpt::poses::CPose3D(in0);
+        // Apply tf, streaming in bounded-memory chunks (see traj_stream.h):
+        std::optional<mrpt::poses::CPose3D> tf;
+
+        const auto op = [&](std::vector<mola::traj_tools::TrajRow>& rows)
+        {
+            if (!tf) tf = newStartPose - rows.front().pose;
+            for (auto& r : rows) r.pose = *tf + r.pose;
+        };
 
-        for (auto& [t, pose] : pIn)  //
-            pose = (tf + mrpt::poses::CPose3D(pose)).asTPose();
+        const auto n = mola::traj_tools::transform_traj_stream(
+            sIn, mola::traj_tools::TrajFormat::TUM, sOut, op);
 
-        // save:
-        pIn.saveToTextFile_TUM(sOut);
+        std::cout << "Processed: " << n << " poses.\n";
+        ASSERT_(n > 0);
 
         return 0;
     }
@@ -0,0 +1,225 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/CQuaternion.h>
+#include <mrpt/poses/CPose3D.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <optional>
+#include <vector>
+
+#include "traj_stream.h"
+
+namespace
+{
+using mola::traj_tools::TrajRow;
+
+/** One input pose flattened into plain scalars (translation + quaternion),
+ * so the interpolation loops below run over flat arrays instead of
+ * repeatedly converting CPose3D rotation matrices. */
+struct FlatPose
+{
+    double t  = 0;
+    double x = 0, y = 0, z = 0;
+    double qx = 0, qy = 0, qz = 0, qw = 1;
+};
+
+FlatPose flatten(const TrajRow& r)
+{
+    FlatPose f;
+
+    const char* p   = r.timestamp.data();
+    const auto  res = std::from_chars(p, p + r.timestamp.size(), f.t);
+    if (res.ec != std::errc())
+        THROW_EXCEPTION_FMT("Bad timestamp: '%s'", r.timestamp.c_str());
+
+    f.x = r.pose.x();
+    f.y = r.pose.y();
+    f.z = r.pose.z();
+
+    mrpt::math::CQuaternionDouble q;
+    r.pose.getAsQuaternion(q);
+    f.qx = q.x();
+    f.qy = q.y();
+    f.qz = q.z();
+    f.qw = q.r();
+    return f;
+}
+
+void emit_row(
+    std::vector<TrajRow>& out, const double t, const double x, const double y,
+    const double z, const double qx, const double qy, const double qz,
+    const double qw)
+{
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.9f", t);
+
+    auto& r     = out.emplace_back();
+    r.timestamp = buf;
+    r.pose      = mrpt::poses::CPose3D(
+             mrpt::math::CQuaternionDouble(qw, qx, qy, qz), x, y, z);
+}
+}  // namespace
+
+int main(int argc, char** argv)
+{
+    try
+    {
+        if (argc != 4)
+        {
+            std::cerr << "Usage: " << argv[0]
+                      << " INPUT.tum OUTPUT.tum RATE_HZ" << std::endl;
+            return 1;
+        }
+
+        const std::string sIn  = argv[1];
+        const std::string sOut = argv[2];
+        const double      rate = std::stod(argv[3]);
+        ASSERT_GT_(rate, 0);
+
+        const double dt = 1.0 / rate;
+
+        // Resampling state carried across chunks (see traj_stream.h): the
+        // last input pose, so segments spanning a chunk boundary keep both
+        // endpoints, and the next output sample time:
+        std::optional<FlatPose> prevPose;
+        std::optional<double>   nextT;
+        size_t                  nOut = 0;
+
+        const auto op = [&](std::vector<TrajRow>& rows)
+        {
+            // Flatten this block of poses once; the timestamps go into a
+            // separate array, which is what the binary searches below scan:
+            std::vector<FlatPose> fp;
+            fp.reserve(rows.size() + 1);
+            if (prevPose) fp.push_back(*prevPose);
+            for (const auto& r : rows) fp.push_back(flatten(r));
+            prevPose = fp.back();
+
+            std::vector<double> ts(fp.size());
+            for (size_t i = 0; i < fp.size(); i++)
+            {
+                ts[i] = fp[i].t;
+                if (i > 0 && ts[i] < ts[i - 1])
+                    THROW_EXCEPTION_FMT(
+                        "Input timestamps are not sorted near t=%.9f", ts[i]);
+            }
+
+            if (!nextT) nextT = ts.front();  // first output sample
+
+            std::vector<TrajRow> out;
+            out.reserve(
+                static_cast<size_t>((ts.back() - *nextT) / dt + 2.0));
+
+            for (;;)
+            {
+                const double t = *nextT;
+                if (t > ts.back() + 1e-9) break;  // rest: next chunk
+
+                // Binary-search the input segment containing t:
+                const size_t i1 =
+                    std::upper_bound(ts.begin(), ts.end(), t) - ts.begin();
+
+                if (i1 == ts.size())
+                {
+                    // Lands (within eps) on the very last input pose:
+                    const auto& a = fp.back();
+                    emit_row(out, t, a.x, a.y, a.z, a.qx, a.qy, a.qz, a.qw);
+                    *nextT = t + dt;
+                    continue;
+                }
+                const auto& a = fp[i1 > 0 ? i1 - 1 : 0];
+                const auto& b = fp[i1];
+
+                // All the output samples falling inside [t, ts[i1]) are
+                // interpolated as one batch over this segment, so the
+                // per-segment quaternion setup (sign fix, angle) is hoisted
+                // out of the inner loop and the LERP arithmetic runs over
+                // plain scalars the compiler can vectorize:
+                const double t0 = a.t, t1 = ts[i1];
+                const size_t n  = std::max<size_t>(
+                     1, static_cast<size_t>(std::ceil((t1 - t) / dt - 1e-9)));
+
+                // Shortest-path: flip one endpoint if the dot is negative:
+                double bqx = b.qx, bqy = b.qy, bqz = b.qz, bqw = b.qw;
+                double dot = a.qx * bqx + a.qy * bqy + a.qz * bqz + a.qw * bqw;
+                if (dot < 0)
+                {
+                    bqx = -bqx;
+                    bqy = -bqy;
+                    bqz = -bqz;
+                    bqw = -bqw;
+                    dot = -dot;
+                }
+                // Consecutive poses are close in any real trajectory, so the
+                // normalized-LERP fast path dominates; full SLERP only for
+                // large angular steps, where NLERP would distort velocity:
+                const bool nlerp = dot > 0.9995;
+                double     theta = 0, invSinTheta = 0;
+                if (!nlerp)
+                {
+                    theta       = std::acos(std::min(1.0, dot));
+                    invSinTheta = 1.0 / std::sin(theta);
+                }
+
+                const double invSeg = 1.0 / (t1 > t0 ? t1 - t0 : 1.0);
+
+                for (size_t j = 0; j < n; j++)
+                {
+                    const double tj = t + static_cast<double>(j) * dt;
+                    const double u  = (tj - t0) * invSeg;
+
+                    double w0, w1;
+                    if (nlerp)
+                    {
+                        w0 = 1.0 - u;
+                        w1 = u;
+                    }
+                    else
+                    {
+                        w0 = std::sin((1.0 - u) * theta) * invSinTheta;
+                        w1 = std::sin(u * theta) * invSinTheta;
+                    }
+
+                    const double qx = w0 * a.qx + w1 * bqx;
+                    const double qy = w0 * a.qy + w1 * bqy;
+                    const double qz = w0 * a.qz + w1 * bqz;
+                    const double qw = w0 * a.qw + w1 * bqw;
+                    const double qn =
+                        1.0 / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+
+                    emit_row(
+                        out, tj, a.x + u * (b.x - a.x), a.y + u * (b.y - a.y),
+                        a.z + u * (b.z - a.z), qx * qn, qy * qn, qz * qn,
+                        qw * qn);
+                }
+                *nextT = t + static_cast<double>(n) * dt;
+            }
+
+            nOut += out.size();
+            rows = std::move(out);  // replaces the chunk contents on output
+        };
+
+        const auto n = mola::traj_tools::transform_traj_stream(
+            sIn, mola::traj_tools::TrajFormat::TUM, sOut, op);
+
+        std::cout << "Processed: " << n << " input poses => " << nOut
+                  << " resampled poses at " << rate << " Hz.\n";
+        ASSERT_(n > 0);
+
+        return 0;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "Exception: " << e.what() << std::endl;
+        return 1;
+    }
+}
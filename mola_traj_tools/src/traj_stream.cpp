@@ -0,0 +1,176 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   traj_stream.cpp
+ * @brief  Shared streaming core for the traj_* CLI tools
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 12, 2024
+ */
+
+#include "traj_stream.h"
+
+#include <mrpt/core/exceptions.h>
+#include <mrpt/math/CQuaternion.h>
+
+#include <charconv>
+#include <cstdio>
+#include <cstring>  // memchr()
+#include <fstream>
+
+using namespace mola::traj_tools;
+
+namespace
+{
+/** Skips blanks, then parses one number advancing `p`. */
+bool parse_double(const char*& p, const char* end, double& v)
+{
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    const auto res = std::from_chars(p, end, v);
+    if (res.ec != std::errc()) return false;
+    p = res.ptr;
+    return true;
+}
+
+/** Parses one text line [p,end) into `r`. Returns false for blank or
+ * comment lines; throws on malformed ones. */
+bool parse_row(const char* p, const char* end, TrajFormat fmt, TrajRow& r)
+{
+    while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    if (p == end || *p == '#' || *p == '%') return false;
+
+    const char* t0 = p;
+    while (p != end && *p != ' ' && *p != '\t' && *p != '\r') p++;
+    r.timestamp.assign(t0, p);
+
+    double    v[7];
+    const int numFields = (fmt == TrajFormat::TUM) ? 7 : 6;
+    for (int i = 0; i < numFields; i++)
+        if (!parse_double(p, end, v[i]))
+            THROW_EXCEPTION_FMT("Cannot parse field #%i", i + 2);
+
+    if (fmt == TrajFormat::TUM)
+    {
+        // t x y z qx qy qz qw
+        r.pose = mrpt::poses::CPose3D(
+            mrpt::math::CQuaternionDouble(v[6], v[3], v[4], v[5]), v[0], v[1],
+            v[2]);
+    }
+    else
+    {
+        // t x y z yaw pitch roll
+        r.pose = mrpt::poses::CPose3D(v[0], v[1], v[2], v[3], v[4], v[5]);
+    }
+    return true;
+}
+
+/** Appends `r` as one TUM text line to `out`. */
+void print_row(std::string& out, const TrajRow& r)
+{
+    mrpt::math::CQuaternionDouble q;
+    r.pose.getAsQuaternion(q);
+
+    char      buf[256];
+    const int len = std::snprintf(
+        buf, sizeof(buf), " %.6f %.6f %.6f %.9f %.9f %.9f %.9f\n", r.pose.x(),
+        r.pose.y(), r.pose.z(), q.x(), q.y(), q.z(), q.r());
+
+    out += r.timestamp;
+    out.append(buf, len);
+}
+}  // namespace
+
+size_t mola::traj_tools::transform_traj_stream(
+    const std::string& in_file, TrajFormat in_format,
+    const std::string& out_file, const chunk_op_t& op, size_t chunk_size)
+{
+    MRPT_START
+    ASSERT_(chunk_size > 0);
+
+    std::ifstream fi(in_file, std::ios::binary);
+    if (!fi.is_open())
+        THROW_EXCEPTION_FMT("Cannot open input file: '%s'", in_file.c_str());
+
+    std::ofstream fo(out_file, std::ios::binary | std::ios::trunc);
+    if (!fo.is_open())
+        THROW_EXCEPTION_FMT("Cannot open output file: '%s'", out_file.c_str());
+
+    constexpr size_t READ_BLOCK = 1 << 20;  // [bytes]
+    std::string      block(READ_BLOCK, '\0');
+    std::string      pending;  // partial last line of the previous block
+
+    std::vector<TrajRow> rows;
+    rows.reserve(chunk_size);
+    std::string outBuf;
+
+    size_t totalRows = 0, lineNo = 0;
+
+    const auto flushChunk = [&]()
+    {
+        if (rows.empty()) return;
+        if (op) op(rows);
+        outBuf.clear();
+        for (const auto& r : rows) print_row(outBuf, r);
+        fo.write(outBuf.data(), outBuf.size());
+        totalRows += rows.size();
+        rows.clear();
+    };
+
+    const auto processLine = [&](const char* p, const char* end)
+    {
+        lineNo++;
+        TrajRow r;
+        try
+        {
+            if (!parse_row(p, end, in_format, r)) return;
+        }
+        catch (const std::exception& e)
+        {
+            THROW_EXCEPTION_FMT(
+                "Malformed line #%lu of '%s': %s",
+                static_cast<unsigned long>(lineNo), in_file.c_str(), e.what());
+        }
+        rows.emplace_back(std::move(r));
+        if (rows.size() >= chunk_size) flushChunk();
+    };
+
+    for (;;)
+    {
+        fi.read(block.data(), READ_BLOCK);
+        const size_t got = fi.gcount();
+        if (got == 0) break;
+
+        const char* p   = block.data();
+        const char* end = p + got;
+        while (p != end)
+        {
+            const auto* nl =
+                static_cast<const char*>(std::memchr(p, '\n', end - p));
+            if (nl == nullptr)
+            {
+                pending.append(p, end);
+                break;
+            }
+            if (!pending.empty())
+            {
+                pending.append(p, nl);
+                processLine(pending.data(), pending.data() + pending.size());
+                pending.clear();
+            }
+            else
+                processLine(p, nl);
+
+            p = nl + 1;
+        }
+    }
+    // last line, if the file does not end in a newline:
+    if (!pending.empty())
+        processLine(pending.data(), pending.data() + pending.size());
+
+    flushChunk();
+
+    return totalRows;
+    MRPT_END
+}
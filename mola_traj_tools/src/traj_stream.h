@@ -0,0 +1,57 @@
+/* -------------------------------------------------------------------------
+ *   A Modular Optimization framework for Localization and mApping  (MOLA)
+ * Copyright (C) 2018-2024 Jose Luis Blanco, University of Almeria
+ * See LICENSE for license information.
+ * ------------------------------------------------------------------------- */
+/**
+ * @file   traj_stream.h
+ * @brief  Shared streaming core for the traj_* CLI tools
+ * @author Jose Luis Blanco Claraco
+ * @date   Aug 12, 2024
+ */
+#pragma once
+
+#include <mrpt/poses/CPose3D.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mola::traj_tools
+{
+/** Input trajectory text formats understood by transform_traj_stream(). */
+enum class TrajFormat : uint8_t
+{
+    TUM,  //!< "t x y z qx qy qz qw"
+    YPR   //!< "t x y z yaw pitch roll" [rad]
+};
+
+/** One parsed trajectory row. The timestamp is kept verbatim as text, so
+ * rewritten files preserve the original timestamp precision. */
+struct TrajRow
+{
+    std::string          timestamp;
+    mrpt::poses::CPose3D pose;
+};
+
+/** Operation applied in-place to each chunk of poses; always invoked with a
+ * non-empty vector, in file order. */
+using chunk_op_t = std::function<void(std::vector<TrajRow>&)>;
+
+/** Streams a trajectory text file from `in_file` to `out_file` (TUM format),
+ * applying `op` (if provided) to successive chunks of up to `chunk_size`
+ * poses. The file is read in fixed-size blocks and parsed with
+ * std::from_chars, so memory usage is bounded by the chunk size regardless
+ * of the trajectory length. Comment ('#'/'%') and blank lines are skipped,
+ * as with mrpt::poses::CPose3DInterpolator text-file loading.
+ *
+ * \return The number of poses processed.
+ * \exception std::exception On I/O errors or malformed input lines.
+ */
+size_t transform_traj_stream(
+    const std::string& in_file, TrajFormat in_format,
+    const std::string& out_file, const chunk_op_t& op = {},
+    size_t chunk_size = 100000);
+
+}  // namespace mola::traj_tools
@@ -6,10 +6,11 @@
 
 #include <mrpt/core/exceptions.h>
 #include <mrpt/poses/CPose3D.h>
-#include <mrpt/poses/CPose3DInterpolator.h>
 
 #include <iostream>
 
+#include "traj_stream.h"
+
 int main(int argc, char** argv)
 {
     try
@@ -27,21 +28,20 @@ int main(int argc, char** argv)
         const std::string sOut = argv[2];
         const std::string sTF  = argv[3];
 
-        mrpt::poses::CPose3DInterpolator pIn;
-        pIn.loadFromTextFile_TUM(sIn);
-
-        std::cout << "Loaded: " << pIn.size() << " poses.\n";
-        ASSERT_(!pIn.empty());
-
-        // Apply tf:
         const auto tf = mrpt::poses::CPose3D::FromString(sTF);
         std::cout << "tf: " << tf << "\n";
 
-        for (auto& [t, pose] : pIn)  //
-            pose = (mrpt::poses::CPose3D(pose) + tf).asTPose();
+        // Apply tf, streaming in bounded-memory chunks (see traj_stream.h):
+        const auto op = [&](std::vector<mola::traj_tools::TrajRow>& rows)
+        {
+            for (auto& r : rows) r.pose = r.pose + tf;
+        };
+
+        const auto n = mola::traj_tools::transform_traj_stream(
+            sIn, mola::traj_tools::TrajFormat::TUM, sOut, op);
 
-        // save:
-        pIn.saveToTextFile_TUM(sOut);
+        std::cout << "Processed: " << n << " poses.\n";
+        ASSERT_(n > 0);
 
         return 0;
     }
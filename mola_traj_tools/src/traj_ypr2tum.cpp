@@ -5,10 +5,11 @@
  * ------------------------------------------------------------------------- */
 
 #include <mrpt/core/exceptions.h>
-#include <mrpt/poses/CPose3DInterpolator.h>
 
 #include <iostream>
 
+#include "traj_stream.h"
+
 int main(int argc, char** argv)
 {
     try
@@ -23,9 +24,11 @@ int main(int argc, char** argv)
         const std::string sIn  = argv[1];
         const std::string sOut = argv[2];
 
-        mrpt::poses::CPose3DInterpolator p;
-        p.loadFromTextFile(sIn);
-        p.saveToTextFile_TUM(sOut);
+        // Convert, streaming in bounded-memory chunks (see traj_stream.h):
+        const auto n = mola::traj_tools::transform_traj_stream(
+            sIn, mola::traj_tools::TrajFormat::YPR, sOut);
+
+        std::cout << "Processed: " << n << " poses.\n";
 
         return 0;
     }
@@ -27,14 +27,30 @@
 
 #include <mola_kernel/interfaces/Dataset_UI.h>
 #include <mola_kernel/interfaces/ExecutableBase.h>
+#include <mola_kernel/interfaces/MapSourceBase.h>
 #include <mola_kernel/interfaces/VizInterface.h>
+#include <mrpt/core/WorkerThreadsPool.h>
 #include <mrpt/gui/CDisplayWindowGUI.h>
+#include <mrpt/img/CImage.h>
+#include <mrpt/math/TPoint3D.h>
+#include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CPointCloudColoured.h>
 
+#include <array>
+#include <deque>
 #include <future>
 #include <memory>
+#include <optional>
 #include <shared_mutex>
+#include <tuple>
 #include <vector>
 
+// frwd decls:
+namespace mrpt::opengl
+{
+class CFBORender;
+}
+
 namespace mola
 {
 /** MOLA GUI and visualization API
@@ -74,15 +90,26 @@ class MolaViz : public ExecutableBase, public VizInterface
      *
      * Depending on the object class RTTI, the corresponding handler is called.
      *
-     * \return false if no handler is found for the given object.
-     *
-     * \sa
+     * This call only marks the subwindow as "dirty" with the given object
+     * (last writer wins); the GUI thread runs the handlers for dirty
+     * subwindows at the next frame boundary and skips clean ones, so a
+     * sensor faster than the render rate costs one handler run per frame,
+     * not one per observation. The returned future is therefore always
+     * immediately ready (kept for API compatibility); it cannot report
+     * anymore whether a handler exists for the object class, which is
+     * instead logged by the GUI thread.
      */
     std::future<bool> subwindow_update_visualization(
         const mrpt::rtti::CObject::Ptr& obj, const std::string& subWindowTitle,
         const std::string& parentWindow = DEFAULT_WINDOW_NAME) override;
 
     /** Update (or adds if not found) a 3D object in the main 3D view area.
+     *
+     * This call never blocks nor waits for the GUI: the update is stored in
+     * a pending buffer that the render thread swaps out and applies at the
+     * next frame boundary, coalescing repeated updates to the same objName
+     * (last writer wins). The returned future is therefore always
+     * immediately ready; it is kept for API compatibility.
      */
     std::future<bool> update_3d_object(
         const std::string&                                  objName,
@@ -109,6 +136,20 @@ class MolaViz : public ExecutableBase, public VizInterface
     std::future<void> enqueue_custom_nanogui_code(
         const std::function<void(void)>& userCode) override;
 
+    /** Renders the current contents of a window scene into an RGB image of
+     * the given size, via an offscreen EGL framebuffer
+     * (mrpt::opengl::CFBORender), so it works without any display server.
+     * Pending update_3d_object() and live-map updates are folded into the
+     * scene before rendering.
+     *
+     * Only available in offscreen mode (see the `offscreen` parameter).
+     * All calls should come from the same thread: the underlying EGL
+     * context gets bound to the first calling thread.
+     */
+    mrpt::img::CImage render_to_image(
+        unsigned int width, unsigned int height,
+        const std::string& parentWindow = DEFAULT_WINDOW_NAME);
+
     /** @} */
 
     /** @name mola-viz GUI update handlers registry
@@ -131,6 +172,54 @@ class MolaViz : public ExecutableBase, public VizInterface
     unsigned int max_console_lines_        = 5;
     bool         show_rgbd_as_point_cloud_ = false;  // too CPU demanding!
 
+    /** Level-of-detail (LOD) rendering of large point clouds sent via
+     * update_3d_object(): clouds above `lod_min_point_count` points get two
+     * extra voxel-decimated render proxies, and each frame only the level
+     * matching the current camera distance is drawn, so GUI frame time stays
+     * bounded regardless of map size. */
+    bool         lod_point_clouds_      = true;
+    unsigned int lod_min_point_count_   = 500000;
+    double       lod_mid_voxel_size_    = 0.50;  //!< [m]
+    double       lod_coarse_voxel_size_ = 2.00;  //!< [m]
+    /// Camera distances [m] up to which the full / mid-resolution levels
+    /// are used; farther away, the coarse level is drawn:
+    double lod_full_max_distance_ = 75.0;
+    double lod_mid_max_distance_  = 250.0;
+
+    /** Live metric-map rendering: when enabled, MolaViz subscribes to every
+     * module implementing MapSourceBase and keeps one scene object per
+     * published map layer, split into per-block renderable chunks of
+     * `map_render_block_size` metres. Incremental (dirty-region) MapUpdates
+     * then rebuild only the chunks intersecting the changed region, so a
+     * small patch of a large map re-uploads a few chunks to the GPU instead
+     * of the whole layer. */
+    bool   subscribe_to_map_updates_ = true;
+    double map_render_block_size_    = 4.0;  //!< [m]
+
+    /** Headless operation: when enabled, no GUI window nor render thread is
+     * created at all, so no display server is required and nothing throttles
+     * the pipeline to the monitor refresh rate (vsync). The update_*() APIs
+     * keep working against an in-memory scene per window, and frames are
+     * produced on demand with render_to_image(). nanogui-bound features
+     * (subwindows, the dataset playback UI, enqueue_custom_nanogui_code())
+     * are inert in this mode. */
+    bool offscreen_ = false;
+
+    /** Per-frame wall-clock budget [ms] for Background-priority GUI
+     * tasks (subwindow creation, enqueue_custom_nanogui_code()); tasks
+     * not fitting in it are carried over to the next frame, keeping the
+     * render loop responsive under update bursts. <=0 disables the
+     * budget (run everything every frame). \sa GuiTaskPriority */
+    double gui_task_budget_ms_ = 10.0;
+
+    /** Worker threads preparing scene updates off the render thread:
+     * LOD proxy decimation and per-block map chunk building run there in
+     * parallel (one job per pending update, so updates aimed at different
+     * windows no longer serialize), and the GUI thread is left with the
+     * cheap scene pointer surgery plus the GL draw itself, which nanogui
+     * requires on its own thread. 0 = prepare inline as before. */
+    unsigned int render_prep_threads_ = 2;
+
     /** @} */
 
     void markWindowForReLayout(const window_name_t& name)
@@ -158,11 +247,122 @@ class MolaViz : public ExecutableBase, public VizInterface
     std::thread guiThread_;
     void        gui_thread();
 
+    /** Priority of a task sent to the GUI thread: RenderCritical tasks
+     * (camera moves, console overlays; all cheap and bounded) always run
+     * before the next frame is drawn; Background tasks (subwindow
+     * creation, custom nanogui code; arbitrarily heavy) share the
+     * per-frame time budget `gui_task_budget_ms_` and are carried over to
+     * the next frame when it runs out, so an update burst cannot stall
+     * rendering. \sa run_gui_tasks_budgeted() */
+    enum class GuiTaskPriority : uint8_t
+    {
+        RenderCritical = 0,
+        Background,
+    };
+    constexpr static size_t GUI_TASK_PRIORITIES = 2;
+
     using task_queue_t = std::vector<std::function<void()>>;
-    task_queue_t            guiThreadPendingTasks_;
+    std::array<task_queue_t, GUI_TASK_PRIORITIES> guiThreadPendingTasks_;
     std::set<window_name_t> guiThreadMustReLayoutTheseWindows_;
     std::mutex              guiThreadPendingTasksMtx_;
 
+    /** Queues one task for the GUI thread, optionally marking a window
+     * for re-layout in the same critical section. */
+    void enqueue_gui_task(
+        GuiTaskPriority prio, const std::function<void()>& fn,
+        const std::optional<window_name_t>& relayoutWin = std::nullopt);
+
+    /** Runs queued GUI tasks: all RenderCritical ones, then Background
+     * ones until the budget is spent; the rest is carried over (in FIFO
+     * order, ahead of newer tasks). GUI thread only, once per frame. */
+    void run_gui_tasks_budgeted();
+
+    /** Starvation counters (GUI thread only): frames that ended with the
+     * budget exhausted and tasks still queued, and total carried-over
+     * tasks. Reported via the profiler and a throttled warning. */
+    uint64_t guiBudgetOverrunFrames_ = 0;
+    uint64_t guiTasksCarriedOver_    = 0;
+
+    /** Back buffer of coalesced update_3d_object() calls, keyed by
+     * (parentWindow, viewportName, objName) so repeated updates of the same
+     * object keep only the most recent one. The GUI thread swaps the whole
+     * map out at each frame boundary and applies it; producers only ever
+     * pay for a map insertion, so rendering load cannot back-pressure them.
+     */
+    using obj_update_key_t =
+        std::tuple<window_name_t, std::string, std::string>;
+    std::map<obj_update_key_t, std::shared_ptr<mrpt::opengl::CSetOfObjects>>
+               pending3DObjectUpdates_;
+    std::mutex pending3DObjectUpdatesMtx_;
+
+    /// Runs on the GUI thread, once per render frame:
+    void gui_apply_pending_3d_object_updates(
+        std::set<window_name_t>& winsToReLayout);
+
+    /** Back buffer of coalesced subwindow_update_visualization() calls,
+     * keyed by (parentWindow, subWindowTitle): each entry is one "dirty"
+     * subwindow with its most recent object. The GUI thread swaps the map
+     * out at each frame boundary and runs the class handlers only for the
+     * subwindows found in it; clean subwindows cost nothing. */
+    using subwin_update_key_t = std::pair<window_name_t, subwindow_name_t>;
+    std::map<subwin_update_key_t, mrpt::rtti::CObject::Ptr>
+               pendingSubWinUpdates_;
+    std::mutex pendingSubWinUpdatesMtx_;
+
+    /// Runs on the GUI thread, once per render frame:
+    void gui_apply_pending_subwindow_updates();
+
+    /** Back buffer of output_console_message() lines, per window. Each
+     * ring is bounded to max_console_lines_: older pending lines would
+     * scroll straight off anyway, so under a message burst producers only
+     * ever pay for a deque push plus a pop, and the widget is redrawn at
+     * most once per window and frame regardless of the message rate. */
+    std::map<window_name_t, std::deque<std::string>> pendingConsoleMsgs_;
+    std::mutex pendingConsoleMsgsMtx_;
+    uint64_t   consoleLinesDropped_ = 0;  //!< Scrolled off while pending
+
+    /** Appends the pending console lines and redraws the overlay, once
+     * per dirty window. Runs once per frame on the GUI thread, or under
+     * offscreenMtx_ in offscreen mode. */
+    void gui_flush_pending_console_messages();
+
+    /** One large point cloud with its voxel-decimated render proxies, all
+     * living in the same scene container. GUI thread access only. */
+    struct LodCloudEntry
+    {
+        window_name_t                                    window;
+        std::weak_ptr<mrpt::opengl::CPointCloudColoured> full, mid, coarse;
+        mrpt::math::TPoint3D                             center;
+        double radius = 0;  //!< [m] bounding-sphere radius, for culling
+    };
+    std::vector<LodCloudEntry> lodClouds_;
+
+    /** Last camera pose per window (azimuth, elevation, zoom, pointing
+     * x/y/z), so the per-cloud LOD & culling pass can be skipped on frames
+     * where the camera did not move and no cloud changed. */
+    std::map<window_name_t, std::array<double, 6>> lodLastCamera_;
+    bool lodDirty_ = false;  //!< Set when lodClouds_ gains entries
+
+    /** CPU-side products of the LOD proxy builder for one large cloud:
+     * the decimated levels, not yet inserted anywhere. Safe to build on a
+     * prep worker; insertion and lodClouds_ registration stay on the GUI
+     * thread. */
+    struct PreparedLod
+    {
+        mrpt::opengl::CPointCloudColoured::Ptr full, mid, coarse;
+        mrpt::math::TPoint3D                   center;
+        double radius = 0;  //!< [m] bounding-sphere radius, for culling
+    };
+
+    /// Scans a container for large point clouds and builds their
+    /// decimated render proxies (pure CPU work, any thread):
+    std::vector<PreparedLod> build_lod_proxies(
+        const mrpt::opengl::CSetOfObjects& glContainer);
+
+    /// Shows, per tracked cloud, only the LOD level matching the current
+    /// camera distance (GUI thread only, once per render frame):
+    void gui_update_lod_visibility();
+
     double lastTimeCheckForNewModules_ = 0;
     double lastTimeUpdateDatasetUIs_   = 0;
     struct DataPerDatasetUI
@@ -180,6 +380,64 @@ class MolaViz : public ExecutableBase, public VizInterface
 
     void dataset_ui_check_new_modules();
     void dataset_ui_update();
+
+    /** Module instance names of MapSourceBase sources already subscribed
+     * to (see subscribe_to_map_updates_). */
+    std::set<std::string> mapSourcesSeen_;
+    void                  map_updates_check_new_modules();
+
+    /** FIFO of MapUpdates pending application at the next frame boundary.
+     * Unlike pending3DObjectUpdates_, incremental deltas are
+     * order-sensitive, so they are queued instead of coalesced; a full-map
+     * update supersedes anything still queued for the same layer.
+     * Fed from the MapSourceBase worker thread (see onNewMapUpdate()). */
+    std::deque<MapSourceBase::MapUpdate> pendingMapUpdates_;
+    std::mutex                           pendingMapUpdatesMtx_;
+    void onNewMapUpdate(const MapSourceBase::MapUpdate& mu);
+
+    /** One published map layer, as a scene container holding per-block
+     * chunk objects keyed by packed block index. GUI thread access only. */
+    struct MapRenderLayer
+    {
+        std::weak_ptr<mrpt::opengl::CSetOfObjects> root;
+        std::map<uint64_t, std::shared_ptr<mrpt::opengl::CSetOfObjects>>
+                 chunks;
+        uint64_t last_seq = 0;  //!< update_seq of the last applied patch
+    };
+    std::map<std::string, MapRenderLayer> mapLayers_;
+
+    /// Runs on the GUI thread, once per render frame:
+    void gui_apply_pending_map_updates(std::set<window_name_t>& winsToReLayout);
+
+    /** @name Offscreen (headless) mode state. See offscreen_.
+     * @{ */
+
+    /** One in-memory scene per window name, playing the role of the
+     * nanogui windows' background_scene. Protected by offscreenMtx_. */
+    std::map<window_name_t, mrpt::opengl::COpenGLScene::Ptr> offscreenScenes_;
+    std::mutex                                               offscreenMtx_;
+
+    /// Returns (creating it on first use) the scene of the given window.
+    /// offscreenMtx_ must be held by the caller.
+    mrpt::opengl::COpenGLScene::Ptr& offscreen_scene(const window_name_t& name);
+
+    /// Folds the pending 3D-object and map update buffers into the
+    /// offscreen scenes (the offscreen stand-in for one GUI frame
+    /// boundary). offscreenMtx_ must be held by the caller.
+    void offscreen_apply_pending_updates();
+
+    /** Lazily-created EGL framebuffer renderer, reused across
+     * render_to_image() calls of the same size. */
+    std::unique_ptr<mrpt::opengl::CFBORender> offscreenFBO_;
+    unsigned int offscreenFBOWidth_ = 0, offscreenFBOHeight_ = 0;
+
+    /** @} */
+
+    /** Workers preparing scene updates (LOD decimation, map chunk
+     *  building) in parallel with the GUI thread. See
+     *  render_prep_threads_. Declared last so its destructor joins
+     *  them before the buffers their tasks use are destroyed. */
+    std::unique_ptr<mrpt::WorkerThreadsPool> renderPrepPool_;
 };
 
 }  // namespace mola
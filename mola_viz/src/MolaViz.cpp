@@ -31,6 +31,7 @@
 #include <mola_viz/MolaViz.h>
 #include <mola_yaml/yaml_helpers.h>
 #include <mrpt/containers/yaml.h>
+#include <mrpt/core/bits_math.h>
 #include <mrpt/core/initializer.h>
 #include <mrpt/core/lock_helper.h>
 #include <mrpt/maps/CColouredPointsMap.h>
@@ -43,14 +44,20 @@
 #include <mrpt/obs/CObservationPointCloud.h>
 #include <mrpt/obs/CObservationRotatingScan.h>
 #include <mrpt/obs/CObservationVelodyneScan.h>
+#include <mrpt/opengl/CFBORender.h>
 #include <mrpt/opengl/CGridPlaneXY.h>
 #include <mrpt/opengl/COpenGLScene.h>
+#include <mrpt/opengl/CPointCloud.h>
 #include <mrpt/opengl/CPointCloudColoured.h>
 #include <mrpt/opengl/stock_objects.h>
 #include <mrpt/system/thread_name.h>
 #include <mrpt/version.h>
 
+#include <algorithm>
 #include <array>
+#include <chrono>
+#include <cmath>
+#include <unordered_set>
 
 #include "mola_icon_64x64.h"
 
@@ -230,8 +237,26 @@ void gui_handler_images(
     const int imgW = imgToShow.getWidth(), imgH = imgToShow.getHeight();
     const int imgChannels = imgToShow.channelCount();
 
+    // Downscale to the canvas size before handing the image to the GL
+    // viewport: uploading e.g. a 1080p frame as a texture for a <=512 px
+    // view costs driver time linear in the texel count, every update. The
+    // scaled buffer is pooled per subwindow (handlers run on the GUI thread
+    // only) and is re-allocated only when the geometry changes:
+    const int cw = glControl->fixedSize().x(), ch = glControl->fixedSize().y();
+    if (cw > 0 && ch > 0 && imgW >= 2 * cw)
+    {
+        thread_local std::map<nanogui::Window*, mrpt::img::CImage> scaledPool;
+
+        auto& scaled = scaledPool[w];
+        imgToShow.scaleImage(
+            scaled, static_cast<unsigned int>(cw),
+            static_cast<unsigned int>(ch), mrpt::img::IMG_INTERP_NN);
+        imgToShow = scaled.makeShallowCopy();
+    }
+
     auto lck = mrpt::lockHelper(glControl->scene_mtx);
-    glControl->scene->getViewport()->setImageView(imgToShow);
+    // Move into the viewport to skip one more deep copy of the pixel data:
+    glControl->scene->getViewport()->setImageView(std::move(imgToShow));
 
     gui_handler_show_common_sensor_info(
         *std::dynamic_pointer_cast<mrpt::obs::CObservation>(o), w,
@@ -522,8 +547,13 @@ MolaViz::~MolaViz()
     instance_ = nullptr;
     instanceMtx_.unlock();
 
-    nanogui::leave();
-    if (guiThread_.joinable()) guiThread_.join();
+    // (in offscreen mode nanogui was never initialized and there is no
+    // thread to join)
+    if (guiThread_.joinable())
+    {
+        nanogui::leave();
+        guiThread_.join();
+    }
 }
 
 bool     MolaViz::IsRunning() { return Instance() != nullptr; }
@@ -547,12 +577,43 @@ void MolaViz::initialize(const Yaml& c)
     YAML_LOAD_MEMBER_OPT(console_text_font_size, double);
     YAML_LOAD_MEMBER_OPT(show_rgbd_as_point_cloud, bool);
 
+    YAML_LOAD_MEMBER_OPT(lod_point_clouds, bool);
+    YAML_LOAD_MEMBER_OPT(lod_min_point_count, unsigned int);
+    YAML_LOAD_MEMBER_OPT(lod_mid_voxel_size, double);
+    YAML_LOAD_MEMBER_OPT(lod_coarse_voxel_size, double);
+    YAML_LOAD_MEMBER_OPT(lod_full_max_distance, double);
+    YAML_LOAD_MEMBER_OPT(lod_mid_max_distance, double);
+
+    YAML_LOAD_MEMBER_OPT(subscribe_to_map_updates, bool);
+    YAML_LOAD_MEMBER_OPT(map_render_block_size, double);
+
+    YAML_LOAD_MEMBER_OPT(offscreen, bool);
+
+    YAML_LOAD_MEMBER_OPT(gui_task_budget_ms, double);
+
+    YAML_LOAD_MEMBER_OPT(render_prep_threads, unsigned int);
+    if (render_prep_threads_ > 0)
+    {
+        renderPrepPool_ = std::make_unique<mrpt::WorkerThreadsPool>(
+            render_prep_threads_, mrpt::WorkerThreadsPool::POLICY_FIFO,
+            "VizRenderPrep");
+    }
+
     // Mark as initialized and up:
     instanceMtx_.lock();
     instance_ = this;
     instanceMtx_.unlock();
 
-    guiThread_ = std::thread(&MolaViz::gui_thread, this);
+    if (!offscreen_)
+    {
+        guiThread_ = std::thread(&MolaViz::gui_thread, this);
+    }
+    else
+    {
+        MRPT_LOG_INFO(
+            "Offscreen mode: no GUI thread nor display needed; use "
+            "render_to_image() to grab frames.");
+    }
 
     MRPT_END
 }
@@ -567,14 +628,25 @@ void MolaViz::spinOnce()
     const double tNow = mrpt::Clock::nowDouble();
     if (tNow - lastTimeCheckForNewModules_ > PERIOD_CHECK_NEW_MODS)
     {
-        dataset_ui_check_new_modules();
+        if (!offscreen_) dataset_ui_check_new_modules();
+        if (subscribe_to_map_updates_) map_updates_check_new_modules();
         lastTimeCheckForNewModules_ = tNow;
     }
-    if (tNow - lastTimeUpdateDatasetUIs_ > PERIOD_UPDATE_DATASET_UI)
+    if (!offscreen_ &&
+        tNow - lastTimeUpdateDatasetUIs_ > PERIOD_UPDATE_DATASET_UI)
     {
         dataset_ui_update();
         lastTimeUpdateDatasetUIs_ = tNow;
     }
+
+    if (offscreen_)
+    {
+        // There is no GUI thread draining the pending-update buffers, so
+        // fold them into the offscreen scenes here, keeping memory bounded
+        // even if render_to_image() is called rarely (or never):
+        auto lck = mrpt::lockHelper(offscreenMtx_);
+        offscreen_apply_pending_updates();
+    }
 }
 
 void MolaViz::dataset_ui_check_new_modules()
@@ -623,7 +695,20 @@ void MolaViz::dataset_ui_check_new_modules()
             [e](float pos)
             {
                 auto mod = e.module.lock();
-                if (mod) mod->datasetUI_teleport(static_cast<size_t>(pos));
+                if (!mod) return;
+                // Dragging in progress: ask the source for cheap metadata
+                // previews only, instead of a full decode per slider event:
+                mod->datasetUI_preview_scrub(true);
+                mod->datasetUI_teleport(static_cast<size_t>(pos));
+            });
+        e.slider->setFinalCallback(
+            [e](float pos)
+            {
+                auto mod = e.module.lock();
+                if (!mod) return;
+                // Slider settled: full decode at the final position.
+                mod->datasetUI_preview_scrub(false);
+                mod->datasetUI_teleport(static_cast<size_t>(pos));
             });
 
         e.ui->add<nanogui::Label>("Playback rate:");
@@ -681,6 +766,45 @@ void MolaViz::dataset_ui_update()
     }
 }
 
+void MolaViz::map_updates_check_new_modules()
+{
+    auto mapSources = findService<MapSourceBase>();
+
+    for (auto& module : mapSources)
+    {
+        auto ms = std::dynamic_pointer_cast<MapSourceBase>(module);
+        ASSERT_(ms);
+
+        const auto modName = module->getModuleInstanceName();
+        if (mapSourcesSeen_.count(modName) != 0) continue;
+        mapSourcesSeen_.insert(modName);
+
+        MRPT_LOG_INFO_STREAM(
+            "Subscribing to map updates from module '" << modName << "'");
+
+        ms->subscribeToMapUpdates([this](const auto& mu)
+                                  { onNewMapUpdate(mu); });
+    }
+}
+
+void MolaViz::onNewMapUpdate(const MapSourceBase::MapUpdate& mu)
+{
+    auto lck = mrpt::lockHelper(pendingMapUpdatesMtx_);
+
+    if (!mu.dirty_region)
+    {
+        // Full-map update: supersedes anything still queued for this layer.
+        pendingMapUpdates_.erase(
+            std::remove_if(
+                pendingMapUpdates_.begin(), pendingMapUpdates_.end(),
+                [&mu](const auto& e) {
+                    return e.method == mu.method && e.map_name == mu.map_name;
+                }),
+            pendingMapUpdates_.end());
+    }
+    pendingMapUpdates_.push_back(mu);
+}
+
 mrpt::gui::CDisplayWindowGUI::Ptr MolaViz::create_and_add_window(
     const window_name_t& name)
 {
@@ -741,32 +865,34 @@ void MolaViz::gui_thread()
         {
             ProfilerEntry pe(profiler_, "loopCallback lambda");
 
-            // Get a copy of the tasks:
-            task_queue_t tasks;
-            auto         lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-            tasks            = std::move(guiThreadPendingTasks_);
-            guiThreadPendingTasks_ = task_queue_t();
-            auto winsToReLayout    = guiThreadMustReLayoutTheseWindows_;
+            // Run the queued tasks: render-critical ones always, the
+            // rest under the per-frame time budget (unfinished tasks
+            // carry over to the next frame):
+            run_gui_tasks_budgeted();
+
+            auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
+            auto winsToReLayout = guiThreadMustReLayoutTheseWindows_;
             guiThreadMustReLayoutTheseWindows_.clear();
             lck.unlock();
 
-            // Run them:
-            auto& hc          = HandlersContainer::Instance();
-            auto  lckHandlers = mrpt::lockHelper(hc.guiHandlersMtx_);
-            for (auto& t : tasks)
-            {
-                try
-                {
-                    t();
-                }
-                catch (const std::exception& e)
-                {
-                    MRPT_LOG_ERROR_STREAM(
-                        "Exception in task sent to GUI thread:\n"
-                        << e.what());
-                }
-            }
-            lckHandlers.unlock();
+            // Run the GUI handlers of subwindows marked dirty since the
+            // last frame (at most once per subwindow and frame):
+            gui_apply_pending_subwindow_updates();
+
+            // Redraw the console overlays of windows with new lines (one
+            // widget update per window, whatever the message rate):
+            gui_flush_pending_console_messages();
+
+            // Apply the coalesced 3D object updates (at most one per object
+            // and frame, last writer wins):
+            gui_apply_pending_3d_object_updates(winsToReLayout);
+
+            // Apply queued live-map updates (incremental deltas touch only
+            // the chunks under their dirty region):
+            gui_apply_pending_map_updates(winsToReLayout);
+
+            // Pick the LOD level of large point clouds for this frame:
+            gui_update_lod_visibility();
 
             for (const auto& winName : winsToReLayout)
                 windows_.at(winName).win->performLayout();
@@ -786,81 +912,261 @@ void MolaViz::gui_thread()
     MRPT_LOG_DEBUG("gui_thread() quitted.");
 }
 
+void MolaViz::enqueue_gui_task(
+    const GuiTaskPriority prio, const std::function<void()>& fn,
+    const std::optional<window_name_t>& relayoutWin)
+{
+    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
+    guiThreadPendingTasks_[static_cast<size_t>(prio)].emplace_back(fn);
+    if (relayoutWin) guiThreadMustReLayoutTheseWindows_.insert(*relayoutWin);
+}
+
+void MolaViz::run_gui_tasks_budgeted()
+{
+    using clock = std::chrono::steady_clock;
+
+    const auto   tStart  = clock::now();
+    const double budgetS = gui_task_budget_ms_ * 1e-3;
+
+    // Swap all the queues out, so producers enqueueing new tasks never
+    // wait on task execution:
+    std::array<task_queue_t, GUI_TASK_PRIORITIES> tasks;
+    {
+        auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
+        for (size_t i = 0; i < tasks.size(); i++)
+        {
+            tasks[i] = std::move(guiThreadPendingTasks_[i]);
+            guiThreadPendingTasks_[i] = task_queue_t();
+        }
+    }
+
+    const auto runOne = [this](const std::function<void()>& t)
+    {
+        try
+        {
+            t();
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM(
+                "Exception in task sent to GUI thread:\n"
+                << e.what());
+        }
+    };
+
+    // Render-critical tasks (camera moves, console overlays) are cheap
+    // and bounded: run them all, so the upcoming frame is consistent:
+    for (const auto& t :
+         tasks[static_cast<size_t>(GuiTaskPriority::RenderCritical)])
+        runOne(t);
+
+    // Background tasks (subwindow creation, custom nanogui code) may be
+    // arbitrarily heavy: run them only until the budget is exhausted:
+    auto&  bg = tasks[static_cast<size_t>(GuiTaskPriority::Background)];
+    size_t nRun = 0;
+    while (nRun < bg.size() &&
+           (budgetS <= 0 ||
+            std::chrono::duration<double>(clock::now() - tStart).count() <
+                budgetS))
+    {
+        runOne(bg[nRun++]);
+    }
+
+    if (nRun >= bg.size()) return;
+
+    // Budget spent: carry the rest over, ahead of anything enqueued
+    // meanwhile so FIFO order (and futures order) is preserved:
+    const auto nLeft = bg.size() - nRun;
+    guiBudgetOverrunFrames_++;
+    guiTasksCarriedOver_ += nLeft;
+    profiler_.registerUserMeasure(
+        "gui_tasks.carried_over", static_cast<double>(nLeft));
+
+    {
+        auto  lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
+        auto& q =
+            guiThreadPendingTasks_[static_cast<size_t>(
+                GuiTaskPriority::Background)];
+        q.insert(
+            q.begin(), std::make_move_iterator(bg.begin() + nRun),
+            std::make_move_iterator(bg.end()));
+    }
+
+    MRPT_LOG_THROTTLE_WARN_STREAM(
+        5.0, "GUI task budget ("
+                 << gui_task_budget_ms_ << " ms) exhausted: " << nLeft
+                 << " task(s) deferred to the next frame ("
+                 << guiBudgetOverrunFrames_ << " overrun frames, "
+                 << guiTasksCarriedOver_ << " deferrals in total).");
+}
+
+mrpt::opengl::COpenGLScene::Ptr& MolaViz::offscreen_scene(
+    const window_name_t& name)
+{
+    auto& scene = offscreenScenes_[name];
+    if (scene) return scene;
+
+    MRPT_LOG_DEBUG_FMT("Creating offscreen scene `%s`", name.c_str());
+
+    scene = mrpt::opengl::COpenGLScene::Create();
+    scene->insert(mrpt::opengl::CGridPlaneXY::Create());
+
+    // Same initial camera than create_and_add_window():
+    auto& cam = scene->getViewport()->getCamera();
+    cam.setPointingAt(8.0f, .0f, .0f);
+    cam.setAzimuthDegrees(110.0f);
+    cam.setElevationDegrees(15.0f);
+    cam.setZoomDistance(20.0f);
+
+    return scene;
+}
+
+void MolaViz::offscreen_apply_pending_updates()
+{
+    // Same back buffers and apply functions than one GUI-thread frame
+    // boundary, except that nothing nanogui-related exists: no subwindow
+    // handlers, no custom user code, and no layouts to recompute.
+    // Camera updates are applied in-place by their entry points in
+    // offscreen mode, so guiThreadPendingTasks_ stays empty.
+    std::set<window_name_t> unusedReLayout;
+    gui_apply_pending_3d_object_updates(unusedReLayout);
+    gui_apply_pending_map_updates(unusedReLayout);
+    gui_flush_pending_console_messages();
+}
+
+mrpt::img::CImage MolaViz::render_to_image(
+    unsigned int width, unsigned int height, const std::string& parentWindow)
+{
+    MRPT_START
+    ASSERTMSG_(
+        offscreen_,
+        "render_to_image() is only available with the `offscreen: true` "
+        "parameter");
+    ASSERT_(width > 0 && height > 0);
+
+    ProfilerEntry pe(profiler_, "render_to_image");
+
+    auto lck = mrpt::lockHelper(offscreenMtx_);
+
+    // Bring the scene up to date first:
+    offscreen_apply_pending_updates();
+
+    auto& scene = offscreen_scene(parentWindow);
+
+    // Lazily (re)create the EGL framebuffer; geometry is uploaded to the
+    // GPU at this point, on this thread:
+    if (!offscreenFBO_ || offscreenFBOWidth_ != width ||
+        offscreenFBOHeight_ != height)
+    {
+        offscreenFBO_ =
+            std::make_unique<mrpt::opengl::CFBORender>(width, height);
+        offscreenFBOWidth_  = width;
+        offscreenFBOHeight_ = height;
+    }
+
+    mrpt::img::CImage img;
+    offscreenFBO_->render_RGB(*scene, img);
+    return img;
+
+    MRPT_END
+}
+
 std::future<bool> MolaViz::subwindow_update_visualization(
     const mrpt::rtti::CObject::Ptr& obj, const std::string& subWindowTitle,
     const std::string& parentWindow)
 {
-    using return_type = bool;
+    if (offscreen_)
+    {
+        // Subwindows are nanogui-bound and do not exist in offscreen mode;
+        // drop the update so the dirty buffer cannot grow without a GUI
+        // thread to drain it:
+        std::promise<bool> done;
+        done.set_value(true);
+        return done.get_future();
+    }
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        [this, obj, subWindowTitle, parentWindow]()
+    // Damage tracking: just mark the subwindow as dirty by overwriting its
+    // back-buffer entry (last writer wins). The GUI thread runs the class
+    // handlers for dirty subwindows only, once per frame boundary (see
+    // gui_apply_pending_subwindow_updates()), so this call returns at once
+    // and clean subwindows cost nothing.
+    {
+        auto lck = mrpt::lockHelper(pendingSubWinUpdatesMtx_);
+        pendingSubWinUpdates_[{parentWindow, subWindowTitle}] = obj;
+    }
+
+    // The future is kept for API compatibility, but it is already satisfied:
+    std::promise<bool> done;
+    done.set_value(true);
+    return done.get_future();
+}
+
+void MolaViz::gui_apply_pending_subwindow_updates()
+{
+    // Frame-boundary swap, as in gui_apply_pending_3d_object_updates():
+    decltype(pendingSubWinUpdates_) updates;
+    {
+        auto lck = mrpt::lockHelper(pendingSubWinUpdatesMtx_);
+        updates.swap(pendingSubWinUpdates_);
+    }
+    if (updates.empty()) return;
+
+    auto& hc          = HandlersContainer::Instance();
+    auto  lckHandlers = mrpt::lockHelper(hc.guiHandlersMtx_);
+
+    for (const auto& [key, obj] : updates)
+    {
+        const auto& [parentWindow, subWindowTitle] = key;
+        try
         {
-            try
-            {
-                const char* objClassName = obj->GetRuntimeClass()->className;
+            const char* objClassName = obj->GetRuntimeClass()->className;
 
-                MRPT_LOG_DEBUG_STREAM(
-                    "subwindow_update_visualization() title='"
-                    << subWindowTitle << "' obj of class: '" << objClassName
-                    << "'");
-
-                // Get subwindow:
-                ASSERTMSG_(
-                    subWindows_.count(parentWindow),
-                    mrpt::format(
-                        "parentWindow not found: '%s'", parentWindow.c_str()));
-                auto topWin = subWindows_.at(parentWindow);
-
-                ASSERTMSG_(
-                    topWin.count(subWindowTitle),
-                    mrpt::format(
-                        "subWindow not found: '%s'", subWindowTitle.c_str()));
-
-                auto subWin = topWin.at(subWindowTitle);
-                ASSERT_(subWin != nullptr);
-
-                // Get object GUI handler:
-                // (Note: guiHandlersMtx_ is already locked by main render
-                // thread calling me)
-                auto& hc = HandlersContainer::Instance();
-
-                bool any = false;
-                for (auto [it, rangeEnd] =
-                         hc.guiHandlers_.equal_range(objClassName);
-                     it != rangeEnd; ++it)
-                {
-                    // Update GUI with object:
-                    it->second(obj, subWin, parentWindow, this);
-                    any = true;
-                }
-                if (any)
-                {  // done
-                    return true;
-                }
-                else
-                {
-                    // No handler for this class:
-                    MRPT_LOG_DEBUG_STREAM(
-                        "subwindow_update_visualization() No known handler for "
-                        "obj of "
-                        "class: '"
-                        << objClassName << "'");
+            MRPT_LOG_DEBUG_STREAM(
+                "gui_apply_pending_subwindow_updates() title='"
+                << subWindowTitle << "' obj of class: '" << objClassName
+                << "'");
 
-                    return false;
-                }
+            // Get subwindow:
+            ASSERTMSG_(
+                subWindows_.count(parentWindow),
+                mrpt::format(
+                    "parentWindow not found: '%s'", parentWindow.c_str()));
+            auto topWin = subWindows_.at(parentWindow);
+
+            ASSERTMSG_(
+                topWin.count(subWindowTitle),
+                mrpt::format(
+                    "subWindow not found: '%s'", subWindowTitle.c_str()));
+
+            auto subWin = topWin.at(subWindowTitle);
+            ASSERT_(subWin != nullptr);
+
+            // Run the object GUI handler(s):
+            bool any = false;
+            for (auto [it, rangeEnd] =
+                     hc.guiHandlers_.equal_range(objClassName);
+                 it != rangeEnd; ++it)
+            {
+                // Update GUI with object:
+                it->second(obj, subWin, parentWindow, this);
+                any = true;
             }
-            catch (const std::exception& e)
+            if (!any)
             {
-                MRPT_LOG_ERROR_STREAM(
-                    "subwindow_update_visualization(): exception:\n"
-                    << e.what());
-                return false;
+                // No handler for this class:
+                MRPT_LOG_DEBUG_STREAM(
+                    "gui_apply_pending_subwindow_updates() No known handler "
+                    "for obj of class: '"
+                    << objClassName << "'");
             }
-        });
-
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    return task->get_future();
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM(
+                "gui_apply_pending_subwindow_updates(): exception:\n"
+                << e.what());
+        }
+    }
 }
 
 std::future<nanogui::Window*> MolaViz::create_subwindow(
@@ -868,6 +1174,17 @@ std::future<nanogui::Window*> MolaViz::create_subwindow(
 {
     using return_type = nanogui::Window*;
 
+    if (offscreen_)
+    {
+        MRPT_LOG_WARN_STREAM(
+            "create_subwindow('"
+            << subWindowTitle
+            << "') ignored: subwindows are not available in offscreen mode.");
+        std::promise<return_type> done;
+        done.set_value(nullptr);
+        return done.get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         [this, subWindowTitle, parentWindow]()
         {
@@ -928,9 +1245,8 @@ std::future<nanogui::Window*> MolaViz::create_subwindow(
             return subw;
         });
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    guiThreadMustReLayoutTheseWindows_.insert(parentWindow);
+    enqueue_gui_task(
+        GuiTaskPriority::Background, [=]() { (*task)(); }, parentWindow);
     return task->get_future();
 }
 
@@ -939,27 +1255,69 @@ std::future<bool> MolaViz::update_3d_object(
     const std::shared_ptr<mrpt::opengl::CSetOfObjects>& obj,
     const std::string& viewportName, const std::string& parentWindow)
 {
-    using return_type = bool;
+    MRPT_LOG_DEBUG_STREAM("update_3d_object() objName='" << objName << "'");
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        [this, objName, obj, viewportName, parentWindow]()
-        {
-            MRPT_LOG_DEBUG_STREAM(
-                "update_3d_object() objName='" << objName << "'");
+    // Last-writer-wins: just overwrite the back-buffer entry for this
+    // object. The GUI thread swaps the whole buffer out at the next frame
+    // boundary (see gui_apply_pending_3d_object_updates()), so this call
+    // returns immediately no matter how slow rendering is, and a slow GUI
+    // can never apply back-pressure to the SLAM pipeline.
+    {
+        auto lck = mrpt::lockHelper(pending3DObjectUpdatesMtx_);
+        pending3DObjectUpdates_[{parentWindow, viewportName, objName}] = obj;
+    }
 
-            ASSERT_(windows_.count(parentWindow));
-            auto topWin = windows_.at(parentWindow).win;
-            ASSERT_(topWin);
+    // The future is kept for API compatibility, but it is already satisfied:
+    std::promise<bool> done;
+    done.set_value(true);
+    return done.get_future();
+}
 
-            // No need to acquire the mutex, since this task will be run
-            // in the proper moment in the proper thread:
-            ASSERT_(topWin->background_scene);
+void MolaViz::gui_apply_pending_3d_object_updates(
+    std::set<window_name_t>& winsToReLayout)
+{
+    // Frame-boundary swap: take ownership of the whole back buffer, so
+    // producers keep writing into a fresh (empty) one without ever waiting
+    // for the render thread:
+    decltype(pending3DObjectUpdates_) updates;
+    {
+        auto lck = mrpt::lockHelper(pending3DObjectUpdatesMtx_);
+        updates.swap(pending3DObjectUpdates_);
+    }
+
+    // Phase 1: build the decimated LOD proxies of all pending updates in
+    // parallel on the prep pool. Each job reads only its own (frozen) back
+    // buffer entry, so updates aimed at different windows no longer
+    // serialize; this thread keeps for itself just the scene pointer
+    // surgery and the GL draw, which nanogui requires on its own thread.
+    const bool wantLod = !offscreen_ && lod_point_clouds_;
+    std::map<obj_update_key_t, std::future<std::vector<PreparedLod>>> prepared;
+    if (renderPrepPool_ && wantLod)
+    {
+        for (const auto& [key, obj] : updates)
+            prepared[key] = renderPrepPool_->enqueue(
+                [this, o = obj]() { return build_lod_proxies(*o); });
+    }
+
+    for (const auto& [key, obj] : updates)
+    {
+        const auto& [parentWindow, viewportName, objName] = key;
+        try
+        {
+            mrpt::opengl::COpenGLScene::Ptr scene;
+            if (offscreen_) { scene = offscreen_scene(parentWindow); }
+            else
+            {
+                ASSERT_(windows_.count(parentWindow));
+                auto topWin = windows_.at(parentWindow).win;
+                ASSERT_(topWin);
+                scene = topWin->background_scene;
+            }
+            ASSERT_(scene);
 
             mrpt::opengl::CSetOfObjects::Ptr glContainer;
 
-            if (auto o =
-                    topWin->background_scene->getByName(objName, viewportName);
-                o)
+            if (auto o = scene->getByName(objName, viewportName); o)
             {
                 glContainer =
                     std::dynamic_pointer_cast<mrpt::opengl::CSetOfObjects>(o);
@@ -968,7 +1326,7 @@ std::future<bool> MolaViz::update_3d_object(
             else
             {
                 glContainer = mrpt::opengl::CSetOfObjects::Create();
-                topWin->background_scene->insert(glContainer, viewportName);
+                scene->insert(glContainer, viewportName);
             }
 
             // Move user contents and container properties (pose, scale,
@@ -978,13 +1336,467 @@ std::future<bool> MolaViz::update_3d_object(
             // (except the name! which we need to re-use in the next call)
             glContainer->setName(objName);
 
-            return true;
-        });
+            // Attach the decimated render proxies for large point clouds
+            // (GUI only: without a live camera the LOD pass never runs to
+            // pick a level, so offscreen frames always draw full detail):
+            if (wantLod)
+            {
+                std::vector<PreparedLod> lods;
+                if (auto it = prepared.find(key); it != prepared.end())
+                    lods = it->second.get();
+                else
+                    lods = build_lod_proxies(*glContainer);
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    guiThreadMustReLayoutTheseWindows_.insert(parentWindow);
-    return task->get_future();
+                for (const auto& p : lods)
+                {
+                    // The "operator=" above copies the child shared_ptrs,
+                    // so proxies built from the producer's snapshot refer
+                    // to the very clouds now inside glContainer:
+                    glContainer->insert(p.mid);
+                    glContainer->insert(p.coarse);
+
+                    auto& e   = lodClouds_.emplace_back();
+                    e.window  = parentWindow;
+                    e.full    = p.full;
+                    e.mid     = p.mid;
+                    e.coarse  = p.coarse;
+                    e.center  = p.center;
+                    e.radius  = p.radius;
+                    lodDirty_ = true;
+                }
+            }
+
+            if (!offscreen_) winsToReLayout.insert(parentWindow);
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM(
+                "Exception in update_3d_object() for objName='" << objName
+                                                                << "':\n"
+                                                                << e.what());
+        }
+    }
+}
+
+namespace
+{
+/// Chunk key packing: same 21-bits-per-axis scheme as the voxel keys in
+/// build_decimated_cloud():
+uint64_t map_block_key(const int64_t ix, const int64_t iy, const int64_t iz)
+{
+    return (static_cast<uint64_t>(ix + (1 << 20)) & 0x1fffff) |
+           ((static_cast<uint64_t>(iy + (1 << 20)) & 0x1fffff) << 21) |
+           ((static_cast<uint64_t>(iz + (1 << 20)) & 0x1fffff) << 42);
+}
+
+/// Reserved chunk key for geometry that cannot be partitioned per block
+/// (non-point-cloud visualizations); refreshed by full-map updates only:
+constexpr uint64_t MAP_CHUNK_NON_POINTS = ~static_cast<uint64_t>(0);
+
+bool map_block_intersects(
+    const uint64_t key, const float blockSize,
+    const mrpt::math::TBoundingBoxf& region)
+{
+    if (key == MAP_CHUNK_NON_POINTS) return false;
+    const auto ix = static_cast<int64_t>(key & 0x1fffff) - (1 << 20);
+    const auto iy = static_cast<int64_t>((key >> 21) & 0x1fffff) - (1 << 20);
+    const auto iz = static_cast<int64_t>((key >> 42) & 0x1fffff) - (1 << 20);
+
+    const float x0 = ix * blockSize, y0 = iy * blockSize, z0 = iz * blockSize;
+    return region.max.x >= x0 && region.min.x <= x0 + blockSize &&
+           region.max.y >= y0 && region.min.y <= y0 + blockSize &&
+           region.max.z >= z0 && region.min.z <= z0 + blockSize;
+}
+
+/** Splits the visualization of a map into per-block renderable chunks:
+ * point clouds are partitioned by the block each point falls in, any other
+ * geometry goes into the reserved MAP_CHUNK_NON_POINTS entry. */
+void map_build_chunks(
+    const mrpt::maps::CMetricMap& m, const float blockSize,
+    std::map<uint64_t, std::shared_ptr<mrpt::opengl::CSetOfObjects>>& out)
+{
+    auto glAll = mrpt::opengl::CSetOfObjects::Create();
+    m.getVisualizationInto(*glAll);
+
+    const float inv = 1.0f / blockSize;
+
+    const auto chunkFor = [&out](const uint64_t key)
+    {
+        auto& c = out[key];
+        if (!c) c = mrpt::opengl::CSetOfObjects::Create();
+        return c;
+    };
+
+    const auto keyOf = [inv](const float x, const float y, const float z)
+    {
+        return map_block_key(
+            static_cast<int64_t>(std::floor(x * inv)),
+            static_cast<int64_t>(std::floor(y * inv)),
+            static_cast<int64_t>(std::floor(z * inv)));
+    };
+
+    for (const auto& o : *glAll)
+    {
+        if (auto pc =
+                std::dynamic_pointer_cast<mrpt::opengl::CPointCloudColoured>(o);
+            pc)
+        {
+            std::map<uint64_t, mrpt::opengl::CPointCloudColoured::Ptr> pbs;
+            for (size_t i = 0; i < pc->size(); i++)
+            {
+                const auto& pt = pc->getPoint(i);
+                auto&       bc = pbs[keyOf(pt.x, pt.y, pt.z)];
+                if (!bc)
+                {
+                    bc = mrpt::opengl::CPointCloudColoured::Create();
+                    bc->setPose(pc->getPose());
+                    bc->setPointSize(pc->getPointSize());
+                }
+                bc->insertPoint(pt);
+            }
+            for (auto& [key, bc] : pbs) chunkFor(key)->insert(bc);
+        }
+        else if (auto ps =
+                     std::dynamic_pointer_cast<mrpt::opengl::CPointCloud>(o);
+                 ps)
+        {
+            const auto &xs = ps->getArrayX(), &ys = ps->getArrayY(),
+                       &zs = ps->getArrayZ();
+            std::map<uint64_t, mrpt::opengl::CPointCloud::Ptr> pbs;
+            for (size_t i = 0; i < xs.size(); i++)
+            {
+                auto& bc = pbs[keyOf(xs[i], ys[i], zs[i])];
+                if (!bc)
+                {
+                    bc = mrpt::opengl::CPointCloud::Create();
+                    bc->setPose(ps->getPose());
+                    bc->setPointSize(ps->getPointSize());
+                    bc->setColor(ps->getColor());
+                }
+                bc->insertPoint(xs[i], ys[i], zs[i]);
+            }
+            for (auto& [key, bc] : pbs) chunkFor(key)->insert(bc);
+        }
+        else
+        {
+            chunkFor(MAP_CHUNK_NON_POINTS)->insert(o);
+        }
+    }
+}
+}  // namespace
+
+void MolaViz::gui_apply_pending_map_updates(
+    std::set<window_name_t>& winsToReLayout)
+{
+    // Frame-boundary swap, as in gui_apply_pending_3d_object_updates():
+    decltype(pendingMapUpdates_) updates;
+    {
+        auto lck = mrpt::lockHelper(pendingMapUpdatesMtx_);
+        updates.swap(pendingMapUpdates_);
+    }
+    if (updates.empty()) return;
+
+    const auto blockSize = static_cast<float>(map_render_block_size_);
+
+    // Phase 1: build the chunk geometry of every pending update in
+    // parallel on the prep pool (pure CPU work over the frozen map
+    // snapshots); the scene surgery below stays on this thread:
+    using chunks_t =
+        std::map<uint64_t, std::shared_ptr<mrpt::opengl::CSetOfObjects>>;
+    std::vector<std::future<chunks_t>> prepared(updates.size());
+    if (renderPrepPool_)
+    {
+        for (size_t i = 0; i < updates.size(); i++)
+        {
+            if (!updates[i].map) continue;
+            prepared[i] =
+                renderPrepPool_->enqueue([m = updates[i].map, blockSize]() {
+                    chunks_t out;
+                    map_build_chunks(*m, blockSize, out);
+                    return out;
+                });
+        }
+    }
+
+    for (size_t i = 0; i < updates.size(); i++)
+    {
+        const auto& mu = updates[i];
+        const auto label = mu.method + "/" + mu.map_name;
+        try
+        {
+            if (!mu.map) continue;
+
+            mrpt::opengl::COpenGLScene::Ptr scene;
+            if (offscreen_) { scene = offscreen_scene(DEFAULT_WINDOW_NAME); }
+            else
+            {
+                ASSERT_(windows_.count(DEFAULT_WINDOW_NAME));
+                auto topWin = windows_.at(DEFAULT_WINDOW_NAME).win;
+                ASSERT_(topWin);
+                scene = topWin->background_scene;
+            }
+            ASSERT_(scene);
+
+            auto& layer = mapLayers_[label];
+            auto  root  = layer.root.lock();
+            if (!root)
+            {
+                root = mrpt::opengl::CSetOfObjects::Create();
+                root->setName("map/" + label);
+                scene->insert(root);
+                layer.root = root;
+                layer.chunks.clear();
+            }
+
+            if (!mu.dirty_region)
+            {
+                // Full update: rebuild every chunk of the layer.
+                ProfilerEntry pe(profiler_, "gui.map_update_full");
+
+                root->clear();
+                layer.chunks.clear();
+                if (prepared[i].valid()) layer.chunks = prepared[i].get();
+                else
+                    map_build_chunks(*mu.map, blockSize, layer.chunks);
+                for (auto& [key, c] : layer.chunks) root->insert(c);
+            }
+            else
+            {
+                // Incremental patch: only the chunks under the dirty
+                // region are rebuilt and re-uploaded to the GPU.
+                ProfilerEntry pe(profiler_, "gui.map_update_delta");
+
+                // The per-subscriber queue in MapSourceBase is bounded
+                // (drop-oldest), so patches can be missed: stale chunks
+                // outside this region then persist until the next full
+                // update repairs them.
+                if (layer.last_seq != 0 && mu.update_seq != layer.last_seq + 1)
+                    MRPT_LOG_DEBUG_STREAM(
+                        "Missed map patch(es) for layer '"
+                        << label << "': seq jumped " << layer.last_seq
+                        << " -> " << mu.update_seq);
+
+                // Drop the chunks covered by the changed region:
+                for (auto it = layer.chunks.begin();
+                     it != layer.chunks.end();)
+                {
+                    if (map_block_intersects(
+                            it->first, blockSize, *mu.dirty_region))
+                    {
+                        root->removeObject(it->second);
+                        it = layer.chunks.erase(it);
+                    }
+                    else
+                        ++it;
+                }
+
+                // ...and rebuild them from the patch contents only:
+                decltype(layer.chunks) patchChunks;
+                if (prepared[i].valid()) patchChunks = prepared[i].get();
+                else
+                    map_build_chunks(*mu.map, blockSize, patchChunks);
+                for (auto& [key, c] : patchChunks)
+                {
+                    // Non-point geometry cannot be patched per block;
+                    // it is refreshed by full updates only:
+                    if (key == MAP_CHUNK_NON_POINTS) continue;
+
+                    auto& slot = layer.chunks[key];
+                    if (slot) root->removeObject(slot);
+                    slot = c;
+                    root->insert(c);
+                }
+            }
+            layer.last_seq = mu.update_seq;
+
+            if (!offscreen_) winsToReLayout.insert(DEFAULT_WINDOW_NAME);
+        }
+        catch (const std::exception& e)
+        {
+            MRPT_LOG_ERROR_STREAM(
+                "Exception applying map update for layer '" << label << "':\n"
+                                                            << e.what());
+        }
+    }
+}
+
+namespace
+{
+/** Voxel decimation: keeps the first point found within each voxel of the
+ * given size. Cheap (one hash insertion per point) and good enough for a
+ * render proxy. */
+mrpt::opengl::CPointCloudColoured::Ptr build_decimated_cloud(
+    const mrpt::opengl::CPointCloudColoured& pc, const float voxelSize)
+{
+    auto out = mrpt::opengl::CPointCloudColoured::Create();
+    out->setPose(pc.getPose());
+    out->setPointSize(pc.getPointSize());
+
+    const float inv = 1.0f / voxelSize;
+
+    std::unordered_set<uint64_t> usedVoxels;
+    usedVoxels.reserve(pc.size() / 8);
+
+    for (size_t i = 0; i < pc.size(); i++)
+    {
+        const auto& pt = pc.getPoint(i);
+
+        // 21 bits per axis, offset to keep indices positive:
+        const auto ix =
+            static_cast<uint64_t>(static_cast<int64_t>(pt.x * inv) + (1 << 20));
+        const auto iy =
+            static_cast<uint64_t>(static_cast<int64_t>(pt.y * inv) + (1 << 20));
+        const auto iz =
+            static_cast<uint64_t>(static_cast<int64_t>(pt.z * inv) + (1 << 20));
+
+        const uint64_t key = (ix & 0x1fffff) | ((iy & 0x1fffff) << 21) |
+                             ((iz & 0x1fffff) << 42);
+
+        if (!usedVoxels.insert(key).second) continue;  // voxel already taken
+
+        out->insertPoint(pt);
+    }
+    return out;
+}
+}  // namespace
+
+std::vector<MolaViz::PreparedLod> MolaViz::build_lod_proxies(
+    const mrpt::opengl::CSetOfObjects& glContainer)
+{
+    std::vector<PreparedLod> lods;
+    for (const auto& o : glContainer)
+    {
+        auto pc =
+            std::dynamic_pointer_cast<mrpt::opengl::CPointCloudColoured>(o);
+        if (!pc || pc->size() < lod_min_point_count_) continue;
+
+        ProfilerEntry pe(profiler_, "gui.build_lod_proxies");
+
+        auto& p = lods.emplace_back();
+        p.full  = pc;
+
+        // The coarse level is decimated from the mid one, which is much
+        // cheaper than going over the full cloud twice:
+        p.mid    = build_decimated_cloud(*pc, lod_mid_voxel_size_);
+        p.coarse = build_decimated_cloud(*p.mid, lod_coarse_voxel_size_);
+
+        // Hidden until gui_update_lod_visibility() picks a level:
+        p.mid->setVisibility(false);
+        p.coarse->setVisibility(false);
+
+        // (coarse heuristic: map containers are placed at the origin)
+        const auto bb = pc->getBoundingBox();
+        p.center      = (bb.min + bb.max) * 0.5;
+        p.radius      = (bb.max - bb.min).norm() * 0.5;
+
+        MRPT_LOG_DEBUG_STREAM(
+            "LOD proxies for cloud with " << pc->size() << " points: mid="
+                                          << p.mid->size()
+                                          << " coarse=" << p.coarse->size());
+    }
+    return lods;
+}
+
+void MolaViz::gui_update_lod_visibility()
+{
+    if (lodClouds_.empty()) return;
+
+    // Drop entries whose scene objects were replaced by a newer map update
+    // (the container "operator=" in update_3d_object() destroys them):
+    lodClouds_.erase(
+        std::remove_if(
+            lodClouds_.begin(), lodClouds_.end(),
+            [](const LodCloudEntry& e)
+            {
+                return e.full.expired() || e.mid.expired() ||
+                       e.coarse.expired();
+            }),
+        lodClouds_.end());
+
+    // Damage tracking: skip all per-cloud work for windows where neither
+    // the camera moved since the last frame nor any tracked cloud changed,
+    // so an idle GUI pays nothing here:
+    std::set<window_name_t> activeWins;
+    for (const auto& [name, wd] : windows_)
+    {
+        const auto& cam = wd.win->camera();
+
+        const std::array<double, 6> camState = {
+            cam.getAzimuthDegrees(),  cam.getElevationDegrees(),
+            cam.getZoomDistance(),    cam.getCameraPointingX(),
+            cam.getCameraPointingY(), cam.getCameraPointingZ()};
+
+        auto& last = lodLastCamera_[name];
+        if (lodDirty_ || last != camState)
+        {
+            activeWins.insert(name);
+            last = camState;
+        }
+    }
+    lodDirty_ = false;
+    if (activeWins.empty()) return;
+
+    for (const auto& e : lodClouds_)
+    {
+        if (activeWins.count(e.window) == 0) continue;
+
+        const auto itWin = windows_.find(e.window);
+        if (itWin == windows_.end()) continue;
+
+        // Orbit-camera eye point, from the camera parameters:
+        const auto&  cam = itWin->second.win->camera();
+        const double az  = mrpt::DEG2RAD(cam.getAzimuthDegrees());
+        const double el  = mrpt::DEG2RAD(cam.getElevationDegrees());
+        const double d   = cam.getZoomDistance();
+
+        const auto target = mrpt::math::TPoint3D(
+            cam.getCameraPointingX(), cam.getCameraPointingY(),
+            cam.getCameraPointingZ());
+
+        const auto eye = target + mrpt::math::TPoint3D(
+                                      d * std::cos(az) * std::cos(el),
+                                      d * std::sin(az) * std::cos(el),
+                                      d * std::sin(el));
+
+        const auto   toObj = e.center - eye;
+        const double dist  = toObj.norm();
+
+        // Cull clouds whose whole bounding sphere falls outside a generous
+        // view cone around the camera axis (the orbit camera looks at the
+        // pointing point), so off-screen clouds are never submitted to
+        // mrpt::opengl at all:
+        if (d > 0 && dist > 1e-3)
+        {
+            const auto   viewDir = target - eye;  // norm == d
+            const double cosAng =
+                (viewDir.x * toObj.x + viewDir.y * toObj.y +
+                 viewDir.z * toObj.z) /
+                (d * dist);
+
+            const double ang = std::acos(std::clamp(cosAng, -1.0, 1.0));
+            const double halfApex =
+                std::asin(std::clamp(e.radius / dist, 0.0, 1.0));
+
+            // Half-angle well above any perspective FOV used by the GUI:
+            constexpr double CULL_HALF_FOV = mrpt::DEG2RAD(75.0);
+
+            if (ang - halfApex > CULL_HALF_FOV)
+            {
+                e.full.lock()->setVisibility(false);
+                e.mid.lock()->setVisibility(false);
+                e.coarse.lock()->setVisibility(false);
+                continue;
+            }
+        }
+
+        const int level = dist < lod_full_max_distance_ ? 0
+                          : dist < lod_mid_max_distance_ ? 1
+                                                         : 2;
+
+        e.full.lock()->setVisibility(level == 0);
+        e.mid.lock()->setVisibility(level == 1);
+        e.coarse.lock()->setVisibility(level == 2);
+    }
 }
 
 std::future<bool> MolaViz::update_viewport_look_at(
@@ -993,6 +1805,21 @@ std::future<bool> MolaViz::update_viewport_look_at(
 {
     using return_type = bool;
 
+    if (offscreen_)
+    {
+        // No GUI thread to delegate to: apply onto the offscreen scene
+        // camera right here:
+        auto lck = mrpt::lockHelper(offscreenMtx_);
+        offscreen_scene(parentWindow)
+            ->getViewport()
+            ->getCamera()
+            .setPointingAt(lookAt.x, lookAt.y, lookAt.z);
+
+        std::promise<return_type> done;
+        done.set_value(true);
+        return done.get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         [this, lookAt, viewportName, parentWindow]()
         {
@@ -1011,9 +1838,8 @@ std::future<bool> MolaViz::update_viewport_look_at(
             return true;
         });
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    guiThreadMustReLayoutTheseWindows_.insert(parentWindow);
+    enqueue_gui_task(
+        GuiTaskPriority::RenderCritical, [=]() { (*task)(); }, parentWindow);
     return task->get_future();
 }
 
@@ -1023,6 +1849,23 @@ std::future<bool> MolaViz::update_viewport_camera_azimuth(
 {
     using return_type = bool;
 
+    if (offscreen_)
+    {
+        auto lck = mrpt::lockHelper(offscreenMtx_);
+        auto& cam =
+            offscreen_scene(parentWindow)->getViewport()->getCamera();
+
+        if (absolute_falseForRelative)
+            cam.setAzimuthDegrees(mrpt::RAD2DEG(azimuth));
+        else
+            cam.setAzimuthDegrees(
+                mrpt::RAD2DEG(azimuth) + cam.getAzimuthDegrees());
+
+        std::promise<return_type> done;
+        done.set_value(true);
+        return done.get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         [this, azimuth, absolute_falseForRelative, viewportName, parentWindow]()
         {
@@ -1048,67 +1891,113 @@ std::future<bool> MolaViz::update_viewport_camera_azimuth(
             return true;
         });
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    guiThreadMustReLayoutTheseWindows_.insert(parentWindow);
+    enqueue_gui_task(
+        GuiTaskPriority::RenderCritical, [=]() { (*task)(); }, parentWindow);
     return task->get_future();
 }
 
 std::future<bool> MolaViz::output_console_message(
     const std::string& msg, const std::string& parentWindow)
 {
-    using return_type = bool;
-
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        [this, msg, parentWindow]()
+    {
+        auto lck = mrpt::lockHelper(pendingConsoleMsgsMtx_);
+
+        auto& q = pendingConsoleMsgs_[parentWindow];
+        q.push_back(msg);
+        // Only the newest max_console_lines_ can ever show up; anything
+        // older would scroll straight off, so drop it here and keep the
+        // per-frame flush cost bounded regardless of the message rate:
+        while (q.size() > max_console_lines_)
         {
-            MRPT_LOG_DEBUG_STREAM("output_console_message() msg=" << msg);
+            q.pop_front();
+            consoleLinesDropped_++;
+        }
+    }
 
-            ASSERT_(windows_.count(parentWindow));
-            auto& winData = windows_.at(parentWindow);
+    // Fire-and-forget: the append is unconditional and the actual widget
+    // redraw is batched at the next frame boundary (or the next
+    // render_to_image() in offscreen mode), so resolve the future right
+    // away instead of queuing one GUI-thread task per line:
+    std::promise<bool> done;
+    done.set_value(true);
+    return done.get_future();
+}
 
-            // Append msg:
-            winData.console_messages.push_back(msg);
-            // remove older ones:
-            while (winData.console_messages.size() > max_console_lines_)
-                winData.console_messages.erase(
-                    winData.console_messages.begin());
+void MolaViz::gui_flush_pending_console_messages()
+{
+    // Swap the whole back buffer out, so producers never wait on the
+    // redraw below:
+    std::map<window_name_t, std::deque<std::string>> pend;
+    uint64_t                                         dropped = 0;
+    {
+        auto lck = mrpt::lockHelper(pendingConsoleMsgsMtx_);
+        pend    = std::move(pendingConsoleMsgs_);
+        dropped = consoleLinesDropped_;
 
-            mrpt::gui::CDisplayWindowGUI::Ptr topWin = winData.win;
-            ASSERT_(topWin);
+        pendingConsoleMsgs_.clear();
+        consoleLinesDropped_ = 0;
+    }
+    if (pend.empty()) return;
 
-            // No need to acquire the mutex, since this task will be run
-            // in the proper moment in the proper thread:
-            ASSERT_(topWin->background_scene);
+    if (dropped)
+        MRPT_LOG_THROTTLE_DEBUG_STREAM(
+            5.0, "Console overlay: " << dropped
+                                     << " line(s) scrolled off before being "
+                                        "drawn (message rate > frame rate).");
+
+    for (auto& [winName, lines] : pend)
+    {
+        if (!offscreen_ && !windows_.count(winName))
+        {
+            MRPT_LOG_WARN_STREAM(
+                "output_console_message() for unknown window '" << winName
+                                                                << "'");
+            continue;
+        }
+        auto& winData = windows_[winName];
 
-            const double              LINE_HEIGHT  = console_text_font_size_;
-            const double              LINE_SPACING = 3.0;
-            mrpt::opengl::TFontParams fp;
-            fp.vfont_scale = LINE_HEIGHT;
+        for (auto& l : lines)
+            winData.console_messages.emplace_back(std::move(l));
+        while (winData.console_messages.size() > max_console_lines_)
+            winData.console_messages.erase(winData.console_messages.begin());
 
-            for (size_t i = 0; i < winData.console_messages.size(); i++)
-            {
-                const size_t invIdx = (winData.console_messages.size() - 1 - i);
+        // One widget update per window and frame:
+        mrpt::opengl::COpenGLViewport::Ptr glVp;
+        if (offscreen_)
+        {
+            // Overlay onto the offscreen scene viewport, so the lines
+            // show up in render_to_image() shots too (the windows_ entry
+            // just holds the message list; its `win` stays empty).
+            glVp = offscreen_scene(winName)->getViewport();
+        }
+        else
+        {
+            ASSERT_(winData.win);
+            ASSERT_(winData.win->background_scene);
+            glVp = winData.win->background_scene->getViewport();
+        }
 
-                fp.color.A = 1.0f;
-                if (invIdx > 1 && invIdx + 3 >= max_console_lines_)
-                {
-                    fp.color.A =
-                        1.0 - (invIdx - (max_console_lines_ * 1.0 - 3.5)) / 3.5;
-                }
+        const double              LINE_HEIGHT  = console_text_font_size_;
+        const double              LINE_SPACING = 3.0;
+        mrpt::opengl::TFontParams fp;
+        fp.vfont_scale = LINE_HEIGHT;
 
-                topWin->background_scene->getViewport()->addTextMessage(
-                    3.0, LINE_SPACING + (LINE_SPACING + LINE_HEIGHT) * invIdx,
-                    winData.console_messages.at(i), i, fp);
-            }
+        for (size_t i = 0; i < winData.console_messages.size(); i++)
+        {
+            const size_t invIdx = (winData.console_messages.size() - 1 - i);
 
-            return true;
-        });
+            fp.color.A = 1.0f;
+            if (invIdx > 1 && invIdx + 3 >= max_console_lines_)
+            {
+                fp.color.A =
+                    1.0 - (invIdx - (max_console_lines_ * 1.0 - 3.5)) / 3.5;
+            }
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
-    guiThreadMustReLayoutTheseWindows_.insert(parentWindow);
-    return task->get_future();
+            glVp->addTextMessage(
+                3.0, LINE_SPACING + (LINE_SPACING + LINE_HEIGHT) * invIdx,
+                winData.console_messages.at(i), i, fp);
+        }
+    }
 }
 
 std::future<void> MolaViz::enqueue_custom_nanogui_code(
@@ -1116,11 +2005,21 @@ std::future<void> MolaViz::enqueue_custom_nanogui_code(
 {
     using return_type = void;
 
+    if (offscreen_)
+    {
+        // nanogui is not even initialized in this mode; running the user
+        // code would crash it:
+        MRPT_LOG_DEBUG(
+            "enqueue_custom_nanogui_code() ignored in offscreen mode.");
+        std::promise<return_type> done;
+        done.set_value();
+        return done.get_future();
+    }
+
     auto task = std::make_shared<std::packaged_task<return_type()>>(
         [=]() { userCode(); });
 
-    auto lck = mrpt::lockHelper(guiThreadPendingTasksMtx_);
-    guiThreadPendingTasks_.emplace_back([=]() { (*task)(); });
+    enqueue_gui_task(GuiTaskPriority::Background, [=]() { (*task)(); });
     return task->get_future();
 }
 
@@ -14,8 +14,12 @@
 #include <mola_yaml/macro_helpers.h>
 #include <mrpt/containers/yaml.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace mola
 {
@@ -50,6 +54,14 @@ struct YAMLParseOptions
  * This is equivalent to calling mrpt::containers::yaml::FromFile(), setting the
  * relative path in YAMLParseOptions, calling parseYaml(), and reparsing as a
  * mrpt::containers::yaml class again. \sa parseYaml
+ *
+ * If the environment variable `MOLA_YAML_CACHE` is set to a directory, the
+ * fully-expanded tree is cached there after the first parse, together with
+ * fingerprints (mtime+size) of every `$include{}`d file and the values of
+ * all expanded `${...}` environment variables; later calls load the cached
+ * expansion directly while those fingerprints match, skipping the whole
+ * include/substitution machinery. Files using `$(cmd)` runs are never
+ * cached, since command outputs cannot be validated without re-running them.
  */
 [[nodiscard]] mrpt::containers::yaml load_yaml_file(
     const std::string&      fileName,
@@ -59,6 +71,179 @@ struct YAMLParseOptions
  */
 [[nodiscard]] std::string yaml_to_string(const mrpt::containers::yaml& cfg);
 
+/** Compile-time 64-bit FNV-1a hash of a NUL-terminated string. */
+constexpr uint64_t yaml_key_hash(const char* s)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+    while (*s)
+    {
+        h ^= static_cast<uint8_t>(*s++);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+/** A configuration key whose hash is computed at compile time (see
+ * MOLA_YAML_KEY and the YAML_LOAD_* macros below), so repeated parameter
+ * reads through YamlView resolve via its hash-indexed table instead of
+ * re-hashing/comparing the key string on every call.
+ *
+ * It implicitly converts to std::string, so it can also be handed to the
+ * plain mrpt::containers::yaml API, which then behaves exactly as before.
+ */
+struct YamlKey
+{
+    const char* name;
+    uint64_t    hash;
+
+    constexpr explicit YamlKey(const char* s) : name(s), hash(yaml_key_hash(s))
+    {
+    }
+
+    operator std::string() const { return name; }
+};
+
+/** Forces the key hash to be evaluated at compile time, even in debug
+ * builds. For use with string literals: `MOLA_YAML_KEY("max_rate")`. */
+#define MOLA_YAML_KEY(_str)                              \
+    ([]() -> const ::mola::YamlKey& {                    \
+        static constexpr ::mola::YamlKey _molaKey{_str}; \
+        return _molaKey;                                 \
+    }())
+
+/** A lightweight, non-owning view of a node inside a parsed YAML document.
+ *
+ * mrpt::containers::yaml already hands out cheap internal proxies for
+ * `operator[]` on an existing document, but wrapping a bare `node_t` into a
+ * new `yaml` object (the natural thing to do while iterating a sequence of
+ * module blocks) deep copies the whole subtree. This view just references
+ * the original document instead, converting only the keys actually read;
+ * call materialize() in the few places where an owning copy is required.
+ *
+ * The referenced document must outlive the view.
+ */
+class YamlView
+{
+   public:
+    using node_t = mrpt::containers::yaml::node_t;
+
+    explicit YamlView(const node_t& n) : node_(&n) {}
+    explicit YamlView(const mrpt::containers::yaml& doc) : node_(&doc.node())
+    {
+    }
+
+    bool isNullNode() const { return node_->isNullNode(); }
+    bool isScalar() const { return node_->isScalar(); }
+    bool isSequence() const { return node_->isSequence(); }
+    bool isMap() const { return node_->isMap(); }
+
+    bool has(const std::string& key) const
+    {
+        return node_->isMap() && node_->asMap().count(node_t(key)) != 0;
+    }
+
+    YamlView operator[](const std::string& key) const
+    {
+        ASSERTMSG_(
+            has(key), mrpt::format(
+                          "Missing YAML required entry: `%s`", key.c_str()));
+        return YamlView(node_->asMap().at(node_t(key)));
+    }
+
+    template <typename T>
+    [[nodiscard]] T as() const
+    {
+        return node_->as<T>();
+    }
+
+    template <typename T>
+    [[nodiscard]] T getOrDefault(
+        const std::string& key, const T& defaultValue) const
+    {
+        if (!has(key)) return defaultValue;
+        return node_->asMap().at(node_t(key)).template as<T>();
+    }
+
+    /** @name Hashed-key lookups (see YamlKey / MOLA_YAML_KEY)
+     *
+     * These resolve via a per-view table of (hash, child) pairs, built
+     * lazily on the first hashed lookup and binary-searched afterwards, so
+     * re-reading parameters (e.g. from spinOnce) costs neither a key
+     * string construction nor a std::map traversal per call.
+     * @{ */
+
+    bool has(const YamlKey& key) const { return findByKey(key) != nullptr; }
+
+    YamlView operator[](const YamlKey& key) const
+    {
+        const node_t* n = findByKey(key);
+        ASSERTMSG_(
+            n,
+            mrpt::format("Missing YAML required entry: `%s`", key.name));
+        return YamlView(*n);
+    }
+
+    template <typename T>
+    [[nodiscard]] T getOrDefault(
+        const YamlKey& key, const T& defaultValue) const
+    {
+        const node_t* n = findByKey(key);
+        if (!n) return defaultValue;
+        return n->template as<T>();
+    }
+
+    /** @} */
+
+    /** Access to the underlying parsed node */
+    const node_t& node() const { return *node_; }
+
+    /** Deep copy into an owning document: the only operation that copies. */
+    [[nodiscard]] mrpt::containers::yaml materialize() const
+    {
+        return mrpt::containers::yaml(*node_);
+    }
+
+   private:
+    const node_t* node_;
+
+    struct IndexEntry
+    {
+        uint64_t      hash;
+        std::string   name;  //!< to disambiguate hash collisions
+        const node_t* value;
+    };
+    /** Sorted by hash; built once per view on the first hashed lookup. */
+    mutable std::vector<IndexEntry> keyIndex_;
+
+    const node_t* findByKey(const YamlKey& key) const
+    {
+        if (!node_->isMap()) return nullptr;
+
+        if (keyIndex_.empty() && !node_->asMap().empty())
+        {
+            for (const auto& [k, v] : node_->asMap())
+            {
+                if (!k.isScalar()) continue;
+                auto s = k.as<std::string>();
+                keyIndex_.push_back(
+                    {yaml_key_hash(s.c_str()), std::move(s), &v});
+            }
+            std::sort(
+                keyIndex_.begin(), keyIndex_.end(),
+                [](const IndexEntry& a, const IndexEntry& b)
+                { return a.hash < b.hash; });
+        }
+
+        auto it = std::lower_bound(
+            keyIndex_.begin(), keyIndex_.end(), key.hash,
+            [](const IndexEntry& e, uint64_t h) { return e.hash < h; });
+        for (; it != keyIndex_.end() && it->hash == key.hash; ++it)
+            if (0 == std::strcmp(it->name.c_str(), key.name))
+                return it->value;
+        return nullptr;
+    }
+};
+
 #define ENSURE_YAML_ENTRY_EXISTS(_c, _name) \
     ASSERTMSG_(                             \
         _c.has(_name),                      \
@@ -66,22 +251,27 @@ struct YAMLParseOptions
             "Missing YAML required entry: `%s`", std::string(_name).c_str()))
 
 /** Loads (optional) variable named "_varname" from the YAML config named `cfg`
- * into the variable `_param_str._varname` */
+ * into the variable `_param_str._varname`.
+ *
+ * The key hash is computed at compile time (MOLA_YAML_KEY): with a YamlView
+ * `cfg` the lookup is a hash-table hit; with a plain mrpt::containers::yaml
+ * it falls back to the string-keyed API. */
 #define YAML_LOAD_OPT3(_param_str, _varname, _type) \
-    _param_str._varname =                           \
-        cfg.getOrDefault<_type>(#_varname, _param_str._varname)
+    _param_str._varname = cfg.getOrDefault<_type>(  \
+        MOLA_YAML_KEY(#_varname), _param_str._varname)
 
 #define YAML_LOAD_OPT2(_varname, _type) \
-    _varname = cfg.getOrDefault<_type>(#_varname, _varname)
+    _varname = cfg.getOrDefault<_type>(MOLA_YAML_KEY(#_varname), _varname)
 
-#define YAML_LOAD_OPT_DEG2(_varname, _type) \
-    _varname = mrpt::DEG2RAD(               \
-        cfg.getOrDefault<_type>(#_varname, mrpt::RAD2DEG(_varname)))
+#define YAML_LOAD_OPT_DEG2(_varname, _type)                 \
+    _varname = mrpt::DEG2RAD(cfg.getOrDefault<_type>(       \
+        MOLA_YAML_KEY(#_varname), mrpt::RAD2DEG(_varname)))
 
 /** Use `YAML_LOAD_MEMBER_OPT(foo,double);` to load YAML var `foo` into `foo_`
  */
 #define YAML_LOAD_MEMBER_OPT(_varname, _type) \
-    _varname##_ = cfg.getOrDefault<_type>(#_varname, _varname##_)
+    _varname##_ =                             \
+        cfg.getOrDefault<_type>(MOLA_YAML_KEY(#_varname), _varname##_)
 
 /** Loads (required) variable named "_varname" from the YAML config named `cfg`
  * into the variable `_param_str._varname` */
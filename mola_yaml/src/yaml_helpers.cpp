@@ -19,7 +19,13 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
 
 #if STD_FS_IS_EXPERIMENTAL
 #include <experimental/filesystem>
@@ -37,6 +43,183 @@ namespace fs = std::filesystem;
 
 using mrpt::containers::yaml;
 
+// ---------------------------------------------------------------------------
+// Compiled-config cache (see load_yaml_file() docs and `MOLA_YAML_CACHE`):
+// ---------------------------------------------------------------------------
+namespace
+{
+/** Everything the expansion of a YAML file depended upon, collected while
+ * parsing so a cached copy can be validated on later runs. */
+struct ParseTrace
+{
+    /// (absolute path, modification time, size) of each file read:
+    std::vector<std::tuple<std::string, int64_t, uint64_t>> files;
+
+    /// Environment variables expanded, with their values at parse time:
+    std::map<std::string, std::string> envVars;
+
+    /// `$(cmd)` outputs cannot be validated without re-running the command,
+    /// so their presence makes the expansion uncacheable:
+    bool hadCmdRuns = false;
+};
+
+// Set by load_yaml_file() while parsing; the expansion helpers below report
+// their dependencies through it:
+thread_local ParseTrace* activeParseTrace = nullptr;
+
+constexpr const char* CACHE_MAGIC      = "% MOLA-YAML-CACHE 1";
+constexpr const char* CACHE_HEADER_END = "% ---";
+constexpr const char* UNSET_ENV_MARK   = "\x01unset";
+
+void traceIncludedFile(const std::string& path)
+{
+    if (!activeParseTrace) return;
+
+    activeParseTrace->files.emplace_back(
+        path, static_cast<int64_t>(mrpt::system::getFileModificationTime(path)),
+        mrpt::system::getFileSize(path));
+}
+
+std::string yamlCacheDir()
+{
+    const char* d = ::getenv("MOLA_YAML_CACHE");
+    return d != nullptr ? std::string(d) : std::string();
+}
+
+std::string cacheFileFor(
+    const std::string& absSourceFile, const std::string& cacheDir,
+    const mola::YAMLParseOptions& opts)
+{
+    // Different parse options lead to different expansions:
+    const auto key = absSourceFile + mrpt::format(
+                                         "|%i%i%i", opts.doIncludes ? 1 : 0,
+                                         opts.doCmdRuns ? 1 : 0,
+                                         opts.doEnvVars ? 1 : 0);
+
+    const auto h = std::hash<std::string>()(key);
+    return (fs::path(cacheDir) /
+            mrpt::format("%016zx.molayml", static_cast<size_t>(h)))
+        .string();
+}
+
+std::optional<yaml> tryLoadFromCache(
+    const std::string& absSourceFile, const mola::YAMLParseOptions& opts)
+{
+    const auto cacheDir = yamlCacheDir();
+    if (cacheDir.empty()) return {};
+
+    try
+    {
+        std::ifstream f(cacheFileFor(absSourceFile, cacheDir, opts));
+        if (!f.is_open()) return {};
+
+        std::string line;
+        if (!std::getline(f, line) || line != CACHE_MAGIC) return {};
+        if (!std::getline(f, line) || line != "% source " + absSourceFile)
+            return {};  // hash collision with another source file
+
+        // Validate all recorded fingerprints:
+        while (std::getline(f, line) && line != CACHE_HEADER_END)
+        {
+            std::istringstream ss(line);
+            std::string        tag;
+            ss >> tag /* "%" */ >> tag;
+
+            if (tag == "file")
+            {
+                int64_t  mtime = 0;
+                uint64_t size  = 0;
+                ss >> mtime >> size;
+                std::string path;
+                std::getline(ss, path);
+                path = path.substr(1);  // skip leading separator blank
+
+                if (!mrpt::system::fileExists(path) ||
+                    static_cast<int64_t>(
+                        mrpt::system::getFileModificationTime(path)) != mtime ||
+                    mrpt::system::getFileSize(path) != size)
+                    return {};  // stale
+            }
+            else if (tag == "env")
+            {
+                std::string rest;
+                std::getline(ss, rest);
+                rest             = rest.substr(1);
+                const auto eqPos = rest.find('=');
+                if (eqPos == std::string::npos) return {};
+                const auto name  = rest.substr(0, eqPos);
+                const auto value = rest.substr(eqPos + 1);
+
+                const char* v = ::getenv(name.c_str());
+                if ((v != nullptr ? std::string(v)
+                                  : std::string(UNSET_ENV_MARK)) != value)
+                    return {};  // env var changed
+            }
+            else
+                return {};  // unknown tag: treat as corrupted
+        }
+        if (line != CACHE_HEADER_END) return {};
+
+        // All fingerprints match: load the already-expanded tree:
+        std::stringstream body;
+        body << f.rdbuf();
+
+        if (getenv("VERBOSE"))
+            std::cout << "[mola::load_yaml_file] Using cached expansion of `"
+                      << absSourceFile << "`\n";
+
+        return yaml::FromText(body.str());
+    }
+    catch (const std::exception&)
+    {
+        return {};  // the cache is best-effort only
+    }
+}
+
+void saveToCache(
+    const std::string& absSourceFile, const std::string& expandedText,
+    const ParseTrace& trace, const mola::YAMLParseOptions& opts)
+{
+    const auto cacheDir = yamlCacheDir();
+    if (cacheDir.empty() || trace.hadCmdRuns) return;
+
+    // The line-oriented header cannot hold values with newlines:
+    for (const auto& [name, value] : trace.envVars)
+        if (value.find('\n') != std::string::npos) return;
+
+    try
+    {
+        if (!mrpt::system::directoryExists(cacheDir))
+            mrpt::system::createDirectory(cacheDir);
+
+        const auto cacheFile = cacheFileFor(absSourceFile, cacheDir, opts);
+
+        // Write to a temporary and rename, so concurrent launches never see
+        // a half-written cache entry:
+        const auto tmpFile = cacheFile + "~";
+        {
+            std::ofstream f(tmpFile, std::ios::trunc);
+            if (!f.is_open()) return;
+
+            f << CACHE_MAGIC << "\n";
+            f << "% source " << absSourceFile << "\n";
+            for (const auto& [path, mtime, size] : trace.files)
+                f << "% file " << mtime << " " << size << " " << path << "\n";
+            for (const auto& [name, value] : trace.envVars)
+                f << "% env " << name << "=" << value << "\n";
+            f << CACHE_HEADER_END << "\n";
+            f << expandedText;
+        }
+        std::error_code ec;
+        fs::rename(tmpFile, cacheFile, ec);
+    }
+    catch (const std::exception&)
+    {
+        // best-effort only: never let the cache break a launch
+    }
+}
+}  // namespace
+
 static std::string::size_type findClosing(
     size_t pos, const std::string& s, const char searchEndChar,
     const char otherStartChar)
@@ -108,6 +291,14 @@ static std::string parseEnvVars(
 
     std::string varvalue;
     const char* v = ::getenv(varname.c_str());
+
+    // Report to the compiled-config cache, so a changed variable
+    // invalidates it. ${CURRENT_YAML_FILE_PATH} is derived from the file
+    // location itself, so it needs no fingerprint (unless overridden):
+    if (activeParseTrace && (v != nullptr || varname != "CURRENT_YAML_FILE_PATH"))
+        activeParseTrace->envVars[varname] =
+            v != nullptr ? std::string(v) : std::string(UNSET_ENV_MARK);
+
     if (v != nullptr)
         varvalue = std::string(v);
     else
@@ -153,6 +344,10 @@ static std::string parseCmdRuns(
 
     const auto cmd = post.substr(0, post_end);
 
+    // Command outputs cannot be fingerprinted: disable the cache for this
+    // file (see compiled-config cache above):
+    if (activeParseTrace) activeParseTrace->hadCmdRuns = true;
+
     // Launch command and get console output:
     std::string cmdOut;
 
@@ -222,6 +417,8 @@ static void recursiveParseNodeForIncludes(
             std::cout << "[recursiveParseNodeForIncludes] Including yaml from `"
                       << expr << "`\n";
 
+        traceIncludedFile(expr);
+
         auto filData = yaml::FromFile(expr);
 
         // Handle possible recursive expressions & replace contents:
@@ -290,12 +487,39 @@ mrpt::containers::yaml mola::load_yaml_file(
     const std::string& fileName, const YAMLParseOptions& opts)
 {
     MRPT_START
+    ASSERT_FILE_EXISTS_(fileName);
+    const auto absFile = fs::absolute(fs::path(fileName)).string();
+
+    // Compiled-config cache: reuse the fully-expanded tree from a former
+    // launch, if all its fingerprints still match:
+    if (auto cached = tryLoadFromCache(absFile, opts); cached) return *cached;
+
     const auto rawYaml = mrpt::containers::yaml::FromFile(fileName);
 
     auto optsMod             = opts;
     optsMod.includesBasePath = mrpt::system::extractFileDirectory(fileName);
 
-    return mrpt::containers::yaml::FromText(
-        parse_yaml(yaml_to_string(rawYaml), optsMod));
+    // Expand, collecting all dependencies (includes, env vars) so the
+    // result can be cached:
+    ParseTrace trace;
+    auto*      formerTrace = activeParseTrace;
+    activeParseTrace       = &trace;
+    traceIncludedFile(absFile);
+
+    std::string expanded;
+    try
+    {
+        expanded = parse_yaml(yaml_to_string(rawYaml), optsMod);
+    }
+    catch (...)
+    {
+        activeParseTrace = formerTrace;
+        throw;
+    }
+    activeParseTrace = formerTrace;
+
+    saveToCache(absFile, expanded, trace, opts);
+
+    return mrpt::containers::yaml::FromText(expanded);
     MRPT_END
 }
@@ -13,7 +13,9 @@
  */
 
 #include <mola_yaml/yaml_helpers.h>
+#include <mrpt/system/filesystem.h>
 
+#include <cstdlib>
 #include <iostream>
 
 using namespace std::string_literals;
@@ -97,6 +99,63 @@ static void test_parseIncludes()
     }
 }
 
+static void test_yamlView()
+{
+    const auto y = mrpt::containers::yaml::FromText(txt1);
+
+    // Views over sequence entries, without copying them:
+    const auto v = mola::YamlView(y);
+    ASSERT_(v.isMap());
+    ASSERT_(v.has("d"));
+    ASSERT_(!v.has("nope"));
+    ASSERT_EQUAL_(v["a"].as<double>(), 1.0);
+    ASSERT_EQUAL_(v["d"]["va"].as<std::string>(), "z");
+    ASSERT_EQUAL_(v.getOrDefault<std::string>("b", "none"), "foo");
+    ASSERT_EQUAL_(v.getOrDefault<int>("nope", 42), 42);
+
+    // materialize() must give an equivalent owning document:
+    const auto owned = v["d"].materialize();
+    ASSERT_EQUAL_(owned["va"].as<std::string>(), "z");
+
+    // Compile-time hashed keys must behave like their string twins:
+    static_assert(
+        mola::yaml_key_hash("a") != mola::yaml_key_hash("b"),
+        "FNV-1a must separate these keys");
+
+    ASSERT_(v.has(MOLA_YAML_KEY("d")));
+    ASSERT_(!v.has(MOLA_YAML_KEY("nope")));
+    ASSERT_EQUAL_(v[MOLA_YAML_KEY("a")].as<double>(), 1.0);
+    ASSERT_EQUAL_(
+        v.getOrDefault<std::string>(MOLA_YAML_KEY("b"), "none"), "foo");
+    ASSERT_EQUAL_(v.getOrDefault<int>(MOLA_YAML_KEY("nope"), 42), 42);
+
+    // ...and also work against a plain mrpt yaml (string fallback):
+    ASSERT_EQUAL_(
+        y.getOrDefault<std::string>(MOLA_YAML_KEY("b"), "none"), "foo");
+}
+
+static void test_configCache()
+{
+#if !defined(_WIN32)
+    // Point the compiled-config cache to a fresh temporary directory:
+    const auto cacheDir = mrpt::system::getTempFileName() + "_yaml_cache"s;
+    ::setenv("MOLA_YAML_CACHE", cacheDir.c_str(), 1 /*overwrite*/);
+
+    const auto file = MOLA_MODULE_SOURCE_DIR + "/test_include3.yaml"s;
+
+    // First call parses and fills the cache; the second one must load from
+    // it, and both must yield the same tree:
+    const auto y1 = mola::load_yaml_file(file);
+    const auto y2 = mola::load_yaml_file(file);
+
+    ASSERT_EQUAL_(mola::yaml_to_string(y1), mola::yaml_to_string(y2));
+    ASSERT_EQUAL_(y2["map3"]["config2"]["c"].as<int>(), 30);
+    ASSERT_EQUAL_(y2["map1"]["p3"].as<bool>(), true);
+
+    ::unsetenv("MOLA_YAML_CACHE");
+#endif
+}
+
 MRPT_TODO("Possible bug: #$include{} shouldn't be parsed")
 MRPT_TODO("bug: #${var} shouldn't be parsed")
 
@@ -107,6 +166,8 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
         test_yaml2string();
         test_parseSimple();
         test_parseIncludes();
+        test_yamlView();
+        test_configCache();
         // test_parseEnvSimple();
 
         std::cout << "Test successful." << std::endl;